@@ -0,0 +1,239 @@
+#  Phusion Passenger - https://www.phusionpassenger.com/
+#  Copyright (c) 2017 Phusion Holding B.V.
+#
+#  "Passenger", "Phusion Passenger" and "Union Station" are registered
+#  trademarks of Phusion Holding B.V.
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy
+#  of this software and associated documentation files (the "Software"), to deal
+#  in the Software without restriction, including without limitation the rights
+#  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+#  copies of the Software, and to permit persons to whom the Software is
+#  furnished to do so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in
+#  all copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+#  THE SOFTWARE.
+
+### C++ components microbenchmarks ###
+
+# Each benchmark is a standalone executable. Benchmarks are always compiled
+# with optimizations, regardless of the OPTIMIZE option, because unoptimized
+# numbers are meaningless.
+TEST_CXX_BENCHMARKS = {
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/BusynessIndexBenchmark" =>
+    "test/cxx/Benchmarks/BusynessIndexBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/ProcessMetricsCollectorBenchmark" =>
+    "test/cxx/Benchmarks/ProcessMetricsCollectorBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/FileBufferedChannelBenchmark" =>
+    "test/cxx/Benchmarks/FileBufferedChannelBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/HasherBenchmark" =>
+    "test/cxx/Benchmarks/HasherBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/HeaderTableLookupBenchmark" =>
+    "test/cxx/Benchmarks/HeaderTableLookupBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/HttpHeaderParserBenchmark" =>
+    "test/cxx/Benchmarks/HttpHeaderParserBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/SmartSpawnerBenchmark" =>
+    "test/cxx/Benchmarks/SmartSpawnerBenchmark.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/benchmarks/UstRouterTransactionBenchmark" =>
+    "test/cxx/Benchmarks/UstRouterTransactionBenchmark.cpp"
+}
+
+# The load generator used by `rake benchmark:core`. It is not a benchmark by
+# itself, so it is not run by `rake benchmark:cxx`.
+CORE_LOAD_GENERATOR = "#{TEST_OUTPUT_DIR}cxx/benchmarks/CoreLoadGenerator"
+
+def test_cxx_benchmark_flags
+  @test_cxx_benchmark_flags ||= ["-O2", "-DNDEBUG"] + basic_test_cxx_flags
+end
+
+TEST_CXX_BENCHMARKS.merge(
+  CORE_LOAD_GENERATOR => "test/cxx/Benchmarks/CoreLoadGenerator.cpp"
+).each_pair do |target, source|
+  object = "#{target}.o"
+  define_cxx_object_compilation_task(
+    object,
+    source,
+    :include_paths => test_cxx_include_paths,
+    :flags => test_cxx_benchmark_flags
+  )
+
+  dependencies = [
+    object,
+    LIBEV_TARGET,
+    LIBUV_TARGET,
+    TEST_BOOST_OXT_LIBRARY,
+    TEST_COMMON_LIBRARY.link_objects
+  ].flatten.compact
+  file(target => dependencies) do
+    create_cxx_executable(target, object, :flags => test_cxx_ldflags)
+  end
+end
+
+desc "Run microbenchmarks for the C++ components (select with BENCHMARKS=name;name)"
+task 'benchmark:cxx' => TEST_CXX_BENCHMARKS.keys do
+  names = ENV['BENCHMARKS'].to_s.split(";")
+  TEST_CXX_BENCHMARKS.each_key do |target|
+    if names.empty? || names.include?(File.basename(target))
+      sh File.expand_path(target)
+    end
+  end
+end
+
+
+### Core end-to-end benchmarks ###
+
+# Runs a real Passenger core in benchmark mode (see `--benchmark` in
+# src/agent/Core/OptionParser.h) and puts load on it with CoreLoadGenerator.
+# Every combination of the following is measured:
+#
+#  * Benchmark point (POINTS): where the core stops processing the request
+#    and responds by itself. "none" means a full round trip through the app.
+#  * App (APPS): the test/stub/benchmark app, speaking either the "session"
+#    protocol or HTTP. The after_accept and before_checkout points don't
+#    involve the app, so they are only run with the first app.
+#  * Number of core threads (CORE_THREADS). Default: 1 and the number of CPUs.
+#  * Keep-alive (KEEPALIVE=yes/no/both). Default: both.
+#
+# Further options: CONNECTIONS (default 16), DURATION and WARMUP (in
+# seconds; default 5 and 2). The results are written as JSON to OUTPUT
+# (default: #{OUTPUT_DIR}core_benchmark.json).
+CORE_BENCHMARK_POINTS = %w(after_accept before_checkout after_checkout response_begin none)
+CORE_BENCHMARK_APP_INDEPENDENT_POINTS = %w(after_accept before_checkout)
+CORE_BENCHMARK_APPS = {
+  'session' => {},
+  'http' => { '_PASSENGER_FORCE_HTTP_SESSION' => 'true' }
+}
+
+def core_benchmark_list_option(name, default_value)
+  string_option(name, default_value.join(',')).split(',').map { |x| x.strip }
+end
+
+def find_free_tcp_port
+  server = TCPServer.new('127.0.0.1', 0)
+  server.addr[1]
+ensure
+  server.close if server
+end
+
+def wait_for_tcp_port(port, pid, timeout)
+  deadline = Time.now + timeout
+  while Time.now < deadline
+    if Process.waitpid(pid, Process::WNOHANG)
+      return false
+    end
+    begin
+      TCPSocket.new('127.0.0.1', port).close
+      return true
+    rescue SystemCallError
+      sleep 0.1
+    end
+  end
+  false
+end
+
+def run_core_benchmark(config, log_file)
+  port = find_free_tcp_port
+  command = [
+    File.expand_path(AGENT_TARGET), 'core',
+    '--passenger-root', File.expand_path('.'),
+    '--listen', "tcp://127.0.0.1:#{port}",
+    '--threads', config['core_threads'].to_s,
+    '--disable-security-update-check',
+    '--log-level', '2'
+  ]
+  if config['benchmark_point'] != 'none'
+    command.concat(['--benchmark', config['benchmark_point']])
+  end
+  if Process.euid == 0
+    # Apps are not allowed to run as root by default.
+    command.concat(['--default-user', Etc.getpwuid(Process.euid).name,
+      '--default-group', Etc.getgrgid(Process.egid).name])
+  end
+  command << File.expand_path('test/stub/benchmark')
+
+  pid = Process.spawn(CORE_BENCHMARK_APPS[config['app']], *command,
+    [:out, :err] => [log_file, 'a'])
+  begin
+    if !wait_for_tcp_port(port, pid, 30)
+      return { 'error' => "the core did not start; see #{log_file}" }
+    end
+    output = `#{File.expand_path(CORE_LOAD_GENERATOR)} \
+      --connect tcp://127.0.0.1:#{port} \
+      --connections #{string_option('CONNECTIONS', '16')} \
+      --warmup #{string_option('WARMUP', '2')} \
+      --duration #{string_option('DURATION', '5')} \
+      #{config['keepalive'] ? '' : '--no-keepalive'}`
+    result = JSON.parse(output) rescue { 'error' => "invalid load generator output: #{output}" }
+    if !$?.success? && !result['error']
+      result['error'] = result['last_error'] || 'no request succeeded'
+    end
+    result
+  ensure
+    Process.kill('TERM', pid) rescue nil
+    Process.wait(pid) rescue nil
+  end
+end
+
+desc "Run end-to-end benchmarks for the core (see build/cxx_benchmarks.rb for options)"
+task 'benchmark:core' => [AGENT_TARGET, CORE_LOAD_GENERATOR] do
+  require 'json'
+  require 'socket'
+  require 'etc'
+
+  points = core_benchmark_list_option('POINTS', CORE_BENCHMARK_POINTS)
+  apps = core_benchmark_list_option('APPS', CORE_BENCHMARK_APPS.keys)
+  threads = core_benchmark_list_option('CORE_THREADS', [1, Etc.nprocessors].uniq)
+  keepalive_modes = case string_option('KEEPALIVE', 'both')
+    when 'both' then [true, false]
+    else [boolean_option('KEEPALIVE')]
+  end
+  output_file = string_option('OUTPUT', "#{OUTPUT_DIR}core_benchmark.json")
+  log_file = "#{OUTPUT_DIR}core_benchmark.log"
+  File.open(log_file, 'w').close
+
+  results = []
+  points.each do |point|
+    (CORE_BENCHMARK_APP_INDEPENDENT_POINTS.include?(point) ? apps.first(1) : apps).each do |app|
+      threads.each do |nthreads|
+        keepalive_modes.each do |keepalive|
+          config = {
+            'benchmark_point' => point,
+            'app' => app,
+            'core_threads' => nthreads.to_i,
+            'keepalive' => keepalive
+          }
+          result = config.merge(run_core_benchmark(config, log_file))
+          results << result
+
+          description = "#{point} app=#{app} threads=#{nthreads} keepalive=#{keepalive}"
+          if result['error']
+            puts "#{description}: ERROR: #{result['error']}"
+          else
+            puts format("%s: %.0f req/s, p50=%dus p99=%dus p999=%dus, %d errors",
+              description, result['throughput_rps'],
+              result['latency_usec']['p50'], result['latency_usec']['p99'],
+              result['latency_usec']['p999'], result['errors'])
+          end
+        end
+      end
+    end
+  end
+
+  File.open(output_file, 'w') do |f|
+    f.puts(JSON.pretty_generate(
+      'passenger_version' => PhusionPassenger::VERSION_STRING,
+      'time' => Time.now.utc.strftime('%Y-%m-%dT%H:%M:%SZ'),
+      'hostname' => Socket.gethostname,
+      'cpus' => Etc.nprocessors,
+      'results' => results))
+  end
+  puts "Results written to #{output_file}"
+end
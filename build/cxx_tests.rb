@@ -37,6 +37,12 @@
     "test/cxx/Core/ApplicationPool/ProcessTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/ApplicationPool/PoolTest.o" =>
     "test/cxx/Core/ApplicationPool/PoolTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/ApplicationPool/BusynessIndexTest.o" =>
+    "test/cxx/Core/ApplicationPool/BusynessIndexTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/ApplicationPool/AutoscalerTest.o" =>
+    "test/cxx/Core/ApplicationPool/AutoscalerTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/ApplicationPool/IdleConnectionStackTest.o" =>
+    "test/cxx/Core/ApplicationPool/IdleConnectionStackTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/SpawningKit/DirectSpawnerTest.o" =>
     "test/cxx/Core/SpawningKit/DirectSpawnerTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/SpawningKit/SmartSpawnerTest.o" =>
@@ -46,13 +52,25 @@
     "test/cxx/Core/UnionStationTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/ResponseCacheTest.o" =>
     "test/cxx/Core/ResponseCacheTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/ResponseCacheStoreTest.o" =>
+    "test/cxx/Core/ResponseCacheStoreTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/ConfigProfileStoreTest.o" =>
+    "test/cxx/Core/ConfigProfileStoreTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/SecurityUpdateCheckerTest.o" =>
       "test/cxx/Core/SecurityUpdateCheckerTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Core/ControllerTest.o" =>
     "test/cxx/Core/ControllerTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Core/MetricsTest.o" =>
+    "test/cxx/Core/MetricsTest.cpp",
 
   "#{TEST_OUTPUT_DIR}cxx/UstRouter/TransactionTest.o" =>
     "test/cxx/UstRouter/TransactionTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/UstRouter/SpoolTest.o" =>
+    "test/cxx/UstRouter/SpoolTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/UstRouter/RemoteSenderTest.o" =>
+    "test/cxx/UstRouter/RemoteSenderTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/UstRouter/FileSinkTest.o" =>
+    "test/cxx/UstRouter/FileSinkTest.cpp",
 
   "#{TEST_OUTPUT_DIR}cxx/ServerKit/ChannelTest.o" =>
     "test/cxx/ServerKit/ChannelTest.cpp",
@@ -60,6 +78,8 @@
     "test/cxx/ServerKit/FileBufferedChannelTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/ServerKit/HeaderTableTest.o" =>
     "test/cxx/ServerKit/HeaderTableTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/ServerKit/HttpHeaderScanningTest.o" =>
+    "test/cxx/ServerKit/HttpHeaderScanningTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/ServerKit/ServerTest.o" =>
     "test/cxx/ServerKit/ServerTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/ServerKit/HttpServerTest.o" =>
@@ -115,8 +135,12 @@
     "test/cxx/DateParsingTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/UtilsTest.o" =>
     "test/cxx/UtilsTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Utils/HasherTest.o" =>
+    "test/cxx/Utils/HasherTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/Utils/StrIntUtilsTest.o" =>
     "test/cxx/Utils/StrIntUtilsTest.cpp",
+  "#{TEST_OUTPUT_DIR}cxx/Utils/LatencyHistogramTest.o" =>
+    "test/cxx/Utils/LatencyHistogramTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/IOUtilsTest.o" =>
     "test/cxx/IOUtilsTest.cpp",
   "#{TEST_OUTPUT_DIR}cxx/TemplateTest.o" =>
@@ -4,24 +4,31 @@
   ["src/cxx_supportlib/Constants.h"],
  "src/agent/Core/ApiServer.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -63,6 +70,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -73,6 +81,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -84,6 +93,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -100,6 +110,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -142,6 +153,9 @@
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
    "src/cxx_supportlib/oxt/macros.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ApplicationPool/Autoscaler.h"=>
+  ["src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/oxt/macros.hpp"],
  "src/agent/Core/ApplicationPool/BasicGroupInfo.h"=>
   ["src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Options.h",
@@ -262,6 +276,8 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ApplicationPool/BusynessIndex.h"=>
+  [],
  "src/agent/Core/ApplicationPool/Common.h"=>
   ["src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/SpawningKit/Config.h",
@@ -403,10 +419,13 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -426,6 +445,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -450,6 +470,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -481,11 +502,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/InitializationAndShutdown.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -505,6 +529,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -529,6 +554,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -560,11 +586,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/InternalUtils.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -584,6 +613,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -594,6 +624,7 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/LveLoggingDecorator.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/MessageReadersWriters.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
@@ -608,6 +639,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -639,11 +671,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/LifetimeAndBasics.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -663,6 +698,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -687,6 +723,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -718,11 +755,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/Miscellaneous.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -742,6 +782,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -766,6 +807,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -797,11 +839,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/OutOfBandWork.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -821,6 +866,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -831,7 +877,6 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/LveLoggingDecorator.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
-   "src/cxx_supportlib/MessageReadersWriters.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
@@ -846,6 +891,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -877,11 +923,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/ProcessListManagement.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -901,6 +950,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -925,6 +975,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -956,11 +1007,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/SessionManagement.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -980,6 +1034,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1004,6 +1059,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1035,11 +1091,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/SpawningAndRestarting.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -1059,6 +1118,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1083,6 +1143,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1114,11 +1175,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/StateInspection.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -1138,6 +1202,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1162,6 +1227,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1193,11 +1259,14 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Group/Verification.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -1217,6 +1286,7 @@
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1241,6 +1311,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1270,10 +1341,20 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ApplicationPool/IdleConnectionStack.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Implementation.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
@@ -1288,6 +1369,7 @@
    "src/agent/Core/ApplicationPool/Group/SpawningAndRestarting.cpp",
    "src/agent/Core/ApplicationPool/Group/StateInspection.cpp",
    "src/agent/Core/ApplicationPool/Group/Verification.cpp",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Pool/AnalyticsCollection.cpp",
@@ -1297,10 +1379,12 @@
    "src/agent/Core/ApplicationPool/Pool/InitializationAndShutdown.cpp",
    "src/agent/Core/ApplicationPool/Pool/Miscellaneous.cpp",
    "src/agent/Core/ApplicationPool/Pool/ProcessUtils.cpp",
+   "src/agent/Core/ApplicationPool/Pool/RequestPathLocking.cpp",
    "src/agent/Core/ApplicationPool/Pool/StateInspection.cpp",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1317,6 +1401,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1343,6 +1428,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1415,15 +1501,19 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1440,6 +1530,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1465,6 +1556,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1499,16 +1591,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/AnalyticsCollection.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1525,6 +1621,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1550,6 +1647,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1584,16 +1682,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/GarbageCollection.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1610,6 +1712,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1635,6 +1738,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1669,16 +1773,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/GeneralUtils.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1695,6 +1803,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1720,6 +1829,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1754,16 +1864,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/GroupUtils.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1780,6 +1894,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1805,6 +1920,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1839,16 +1955,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/InitializationAndShutdown.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1865,6 +1985,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1890,6 +2011,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -1924,16 +2046,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/Miscellaneous.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -1950,6 +2076,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -1975,6 +2102,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2009,16 +2137,111 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/ProcessUtils.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
+   "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
+   "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
+   "src/agent/Core/ApplicationPool/Common.h",
+   "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
+   "src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/ApplicationPool/Pool.h",
+   "src/agent/Core/ApplicationPool/Process.h",
+   "src/agent/Core/ApplicationPool/Session.h",
+   "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
+   "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/SpawningKit/DirectSpawner.h",
+   "src/agent/Core/SpawningKit/DummySpawner.h",
+   "src/agent/Core/SpawningKit/Factory.h",
+   "src/agent/Core/SpawningKit/Options.h",
+   "src/agent/Core/SpawningKit/PipeWatcher.h",
+   "src/agent/Core/SpawningKit/Result.h",
+   "src/agent/Core/SpawningKit/SmartSpawner.h",
+   "src/agent/Core/SpawningKit/Spawner.h",
+   "src/agent/Core/SpawningKit/UserSwitchingRules.h",
+   "src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/StopwatchLog.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/AppTypes.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Hooks.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/LveLoggingDecorator.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/AnsiColorConstants.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/ClassUtils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/Lock.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/MessagePassing.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/SpeedMeter.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
+   "src/cxx_supportlib/Utils/SystemMetricsCollector.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Timer.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../macros.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/spin_lock.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ApplicationPool/Pool/RequestPathLocking.cpp"=>
+  ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -2035,6 +2258,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -2060,6 +2284,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2094,16 +2319,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Pool/StateInspection.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -2120,6 +2349,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -2145,6 +2375,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2183,6 +2414,7 @@
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
@@ -2258,6 +2490,7 @@
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Socket.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
@@ -2322,45 +2555,130 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ApplicationPool/Socket.h"=>
   ["src/agent/Core/ApplicationPool/Common.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
+   "src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/cxx_supportlib/AppTypes.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ApplicationPool/StateSnapshot.h"=>
+  ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
+   "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
+   "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
+   "src/agent/Core/ApplicationPool/Common.h",
+   "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/ApplicationPool/Process.h",
+   "src/agent/Core/ApplicationPool/Session.h",
+   "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/SpawningKit/DirectSpawner.h",
+   "src/agent/Core/SpawningKit/DummySpawner.h",
+   "src/agent/Core/SpawningKit/Factory.h",
+   "src/agent/Core/SpawningKit/Options.h",
+   "src/agent/Core/SpawningKit/PipeWatcher.h",
+   "src/agent/Core/SpawningKit/Result.h",
+   "src/agent/Core/SpawningKit/SmartSpawner.h",
+   "src/agent/Core/SpawningKit/Spawner.h",
+   "src/agent/Core/SpawningKit/UserSwitchingRules.h",
    "src/agent/Core/UnionStation/Connection.h",
    "src/agent/Core/UnionStation/Context.h",
    "src/agent/Core/UnionStation/Transaction.h",
+   "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Hooks.h",
    "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/LveLoggingDecorator.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
    "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/ClassUtils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/HashMap.h",
    "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
    "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Timer.h",
    "src/cxx_supportlib/Utils/VariantMap.h",
    "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../macros.hpp",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
    "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/spin_lock.hpp",
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
@@ -2383,25 +2701,52 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ConfigProfileStore.h"=>
+  ["src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -2442,6 +2787,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -2452,6 +2798,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -2463,6 +2810,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -2479,6 +2827,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2522,6 +2871,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/Context.h",
@@ -2529,10 +2879,12 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
    "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
@@ -2558,24 +2910,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/BufferBody.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -2616,6 +2975,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -2626,6 +2986,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -2637,6 +2998,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -2653,6 +3015,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2688,24 +3051,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/CheckoutSession.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -2746,6 +3116,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -2756,6 +3127,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -2767,6 +3139,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -2783,6 +3156,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2818,16 +3192,21 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/Client.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Config.h",
    "src/agent/Core/Controller/Request.h",
@@ -2870,6 +3249,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -2879,6 +3259,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -2890,6 +3271,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -2905,6 +3287,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -2956,6 +3339,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -2964,6 +3348,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -2975,6 +3360,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -2984,6 +3370,7 @@
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -3003,24 +3390,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/ForwardResponse.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3061,6 +3455,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3071,6 +3466,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3082,6 +3478,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3098,6 +3495,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3133,24 +3531,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/Hooks.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3191,6 +3596,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3201,6 +3607,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3212,6 +3619,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3228,6 +3636,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3263,17 +3672,22 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/Implementation.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/BufferBody.cpp",
@@ -3285,12 +3699,14 @@
    "src/agent/Core/Controller/InitRequest.cpp",
    "src/agent/Core/Controller/InitializationAndShutdown.cpp",
    "src/agent/Core/Controller/InternalUtils.cpp",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Miscellaneous.cpp",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/SendRequest.cpp",
    "src/agent/Core/Controller/StateInspection.cpp",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3331,6 +3747,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3341,6 +3758,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3352,6 +3770,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3368,6 +3787,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3403,24 +3823,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/InitRequest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3461,6 +3888,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3471,6 +3899,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3482,6 +3911,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3498,6 +3928,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3533,24 +3964,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/InitializationAndShutdown.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3591,6 +4029,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3601,6 +4040,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3612,6 +4052,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3628,6 +4069,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3663,24 +4105,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/InternalUtils.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3721,6 +4170,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3731,6 +4181,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3742,6 +4193,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3758,6 +4210,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3791,26 +4244,21 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
- "src/agent/Core/Controller/Miscellaneous.cpp"=>
+ "src/agent/Core/Controller/Metrics.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
-   "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
-   "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
-   "src/agent/Core/Controller.h",
-   "src/agent/Core/Controller/AppResponse.h",
-   "src/agent/Core/Controller/Client.h",
-   "src/agent/Core/Controller/Config.h",
-   "src/agent/Core/Controller/Request.h",
-   "src/agent/Core/Controller/TurboCaching.h",
-   "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -3824,54 +4272,154 @@
    "src/agent/Core/SpawningKit/UserSwitchingRules.h",
    "src/agent/Core/UnionStation/Connection.h",
    "src/agent/Core/UnionStation/Context.h",
-   "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
    "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
-   "src/cxx_supportlib/ConfigKit/Common.h",
-   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
-   "src/cxx_supportlib/ConfigKit/Schema.h",
-   "src/cxx_supportlib/ConfigKit/Store.h",
-   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
-   "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Hooks.h",
-   "src/cxx_supportlib/Integrations/LibevJsonUtils.h",
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/LveLoggingDecorator.h",
-   "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
-   "src/cxx_supportlib/MessageReadersWriters.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
-   "src/cxx_supportlib/SafeLibev.h",
-   "src/cxx_supportlib/ServerKit/Channel.h",
-   "src/cxx_supportlib/ServerKit/Client.h",
-   "src/cxx_supportlib/ServerKit/ClientRef.h",
-   "src/cxx_supportlib/ServerKit/Context.h",
-   "src/cxx_supportlib/ServerKit/CookieUtils.h",
-   "src/cxx_supportlib/ServerKit/Errors.h",
-   "src/cxx_supportlib/ServerKit/FdSinkChannel.h",
-   "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
-   "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
-   "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
-   "src/cxx_supportlib/ServerKit/HeaderTable.h",
-   "src/cxx_supportlib/ServerKit/Hooks.h",
-   "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
-   "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
-   "src/cxx_supportlib/ServerKit/HttpClient.h",
-   "src/cxx_supportlib/ServerKit/HttpHeaderParser.h",
-   "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
-   "src/cxx_supportlib/ServerKit/HttpRequest.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/ClassUtils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/Lock.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Timer.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../macros.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/spin_lock.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/Controller/Miscellaneous.cpp"=>
+  ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
+   "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
+   "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
+   "src/agent/Core/ApplicationPool/Common.h",
+   "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/ErrorRenderer.h",
+   "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
+   "src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/ApplicationPool/Pool.h",
+   "src/agent/Core/ApplicationPool/Process.h",
+   "src/agent/Core/ApplicationPool/Session.h",
+   "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
+   "src/agent/Core/Controller.h",
+   "src/agent/Core/Controller/AppResponse.h",
+   "src/agent/Core/Controller/Client.h",
+   "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
+   "src/agent/Core/Controller/Request.h",
+   "src/agent/Core/Controller/TurboCaching.h",
+   "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
+   "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
+   "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/SpawningKit/DirectSpawner.h",
+   "src/agent/Core/SpawningKit/DummySpawner.h",
+   "src/agent/Core/SpawningKit/Factory.h",
+   "src/agent/Core/SpawningKit/Options.h",
+   "src/agent/Core/SpawningKit/PipeWatcher.h",
+   "src/agent/Core/SpawningKit/Result.h",
+   "src/agent/Core/SpawningKit/SmartSpawner.h",
+   "src/agent/Core/SpawningKit/Spawner.h",
+   "src/agent/Core/SpawningKit/UserSwitchingRules.h",
+   "src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/StopwatchLog.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/AppTypes.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Store.h",
+   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/LString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Hooks.h",
+   "src/cxx_supportlib/Integrations/LibevJsonUtils.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/LveLoggingDecorator.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/MessageReadersWriters.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
+   "src/cxx_supportlib/ServerKit/Channel.h",
+   "src/cxx_supportlib/ServerKit/Client.h",
+   "src/cxx_supportlib/ServerKit/ClientRef.h",
+   "src/cxx_supportlib/ServerKit/Context.h",
+   "src/cxx_supportlib/ServerKit/CookieUtils.h",
+   "src/cxx_supportlib/ServerKit/Errors.h",
+   "src/cxx_supportlib/ServerKit/FdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
+   "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
+   "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
+   "src/cxx_supportlib/ServerKit/HeaderTable.h",
+   "src/cxx_supportlib/ServerKit/Hooks.h",
+   "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
+   "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
+   "src/cxx_supportlib/ServerKit/HttpClient.h",
+   "src/cxx_supportlib/ServerKit/HttpHeaderParser.h",
+   "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
+   "src/cxx_supportlib/ServerKit/HttpRequest.h",
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -3888,6 +4436,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -3923,16 +4472,21 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/Request.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Config.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
@@ -3974,6 +4528,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -3983,6 +4538,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -3994,6 +4550,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -4009,6 +4566,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -4043,24 +4601,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/SendRequest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -4101,6 +4666,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -4111,6 +4677,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -4122,6 +4689,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -4138,6 +4706,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -4173,24 +4742,31 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/StateInspection.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -4231,6 +4807,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -4241,6 +4818,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -4252,6 +4830,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -4268,6 +4847,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -4303,6 +4883,7 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/Controller/TurboCaching.h"=>
   ["src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
    "src/cxx_supportlib/DataStructures/LString.h",
@@ -4341,25 +4922,32 @@
  "src/agent/Core/CoreMain.cpp"=>
   ["src/agent/Core/ApiServer.h",
    "src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/OptionParser.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SecurityUpdateChecker.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
@@ -4408,6 +4996,7 @@
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
    "src/cxx_supportlib/ServerKit/AcceptLoadBalancer.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -4418,6 +5007,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -4429,6 +5019,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -4446,6 +5037,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -4508,20 +5100,68 @@
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/ResponseCache.h"=>
-  ["src/cxx_supportlib/DataStructures/HashedStaticString.h",
+  ["src/agent/Core/ResponseCacheStore.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
    "src/cxx_supportlib/DataStructures/LString.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/ServerKit/CookieUtils.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/DateParsing.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/Core/ResponseCacheStore.h"=>
+  ["src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
    "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
-   "src/cxx_supportlib/oxt/macros.hpp"],
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Core/SecurityUpdateChecker.h"=>
   ["src/cxx_supportlib/Crypto.h",
    "src/cxx_supportlib/Exceptions.h",
@@ -5075,16 +5715,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/Shared/ApiServerUtils.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -5123,6 +5767,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5131,9 +5776,11 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -5148,6 +5795,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -5294,16 +5942,20 @@
   ["src/cxx_supportlib/Constants.h"],
  "src/agent/UstRouter/ApiServer.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -5327,6 +5979,8 @@
    "src/agent/UstRouter/LogSink.h",
    "src/agent/UstRouter/RemoteSender.h",
    "src/agent/UstRouter/RemoteSink.h",
+   "src/agent/UstRouter/Shard.h",
+   "src/agent/UstRouter/Spool.h",
    "src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
@@ -5352,6 +6006,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5360,6 +6015,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -5371,12 +6027,12 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/UnionStationFilterSupport.h",
    "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/AnsiColorConstants.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/BufferedIO.h",
    "src/cxx_supportlib/Utils/CachedFileStat.hpp",
    "src/cxx_supportlib/Utils/ClassUtils.h",
@@ -5389,6 +6045,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -5433,7 +6090,6 @@
    "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
@@ -5442,6 +6098,7 @@
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/MessageReadersWriters.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5450,6 +6107,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/Server.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
@@ -5460,6 +6118,7 @@
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -5483,6 +6142,8 @@
    "src/agent/UstRouter/LogSink.h",
    "src/agent/UstRouter/RemoteSender.h",
    "src/agent/UstRouter/RemoteSink.h",
+   "src/agent/UstRouter/Shard.h",
+   "src/agent/UstRouter/Spool.h",
    "src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/ConfigKit/Common.h",
@@ -5493,7 +6154,6 @@
    "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
@@ -5502,6 +6162,7 @@
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/MessageReadersWriters.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5510,13 +6171,13 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/Server.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/UnionStationFilterSupport.h",
    "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/Curl.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/HashMap.h",
@@ -5524,6 +6185,7 @@
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ReleaseableScopedPointer.h",
@@ -5545,9 +6207,11 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/UstRouter/FileSink.h"=>
   ["src/agent/UstRouter/LogSink.h",
+   "src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
@@ -5622,12 +6286,13 @@
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/UstRouter/RemoteSender.h"=>
-  ["src/cxx_supportlib/Exceptions.h",
+  ["src/agent/UstRouter/Spool.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/Curl.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
@@ -5653,12 +6318,13 @@
  "src/agent/UstRouter/RemoteSink.h"=>
   ["src/agent/UstRouter/LogSink.h",
    "src/agent/UstRouter/RemoteSender.h",
+   "src/agent/UstRouter/Spool.h",
+   "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/Curl.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
@@ -5681,18 +6347,87 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
- "src/agent/UstRouter/Transaction.h"=>
-  ["src/cxx_supportlib/DataStructures/LString.h",
+ "src/agent/UstRouter/Shard.h"=>
+  ["src/agent/UstRouter/LogSink.h",
+   "src/agent/UstRouter/RemoteSender.h",
+   "src/agent/UstRouter/Spool.h",
+   "src/agent/UstRouter/Transaction.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Store.h",
+   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/UnionStationFilterSupport.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/Curl.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
    "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ReleaseableScopedPointer.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/UstRouter/Spool.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/agent/UstRouter/Transaction.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -5712,16 +6447,20 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/agent/UstRouter/UstRouterMain.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -5748,6 +6487,8 @@
    "src/agent/UstRouter/OptionParser.h",
    "src/agent/UstRouter/RemoteSender.h",
    "src/agent/UstRouter/RemoteSink.h",
+   "src/agent/UstRouter/Shard.h",
+   "src/agent/UstRouter/Spool.h",
    "src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
@@ -5775,6 +6516,8 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/AcceptLoadBalancer.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5783,6 +6526,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -5794,12 +6538,12 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/UnionStationFilterSupport.h",
    "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/AnsiColorConstants.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/BufferedIO.h",
    "src/cxx_supportlib/Utils/CachedFileStat.hpp",
    "src/cxx_supportlib/Utils/ClassUtils.h",
@@ -5812,6 +6556,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -5850,16 +6595,20 @@
   [],
  "src/agent/Watchdog/ApiServer.h"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -5900,6 +6649,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -5908,6 +6658,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -5919,6 +6670,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -5934,6 +6686,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -5974,16 +6727,20 @@
   [],
  "src/agent/Watchdog/WatchdogMain.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/OptionParser.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
@@ -6034,6 +6791,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -6042,6 +6800,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -6053,6 +6812,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -6068,6 +6828,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -6725,6 +7486,7 @@
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
@@ -6733,10 +7495,25 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
- "src/cxx_supportlib/ServerKit/Channel.h"=>
-  ["src/cxx_supportlib/Constants.h",
-   "src/cxx_supportlib/Exceptions.h",
-   "src/cxx_supportlib/FileDescriptor.h",
+ "src/cxx_supportlib/ServerKit/BufferFilePool.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/cxx_supportlib/ServerKit/Channel.h"=>
+  ["src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/SafeLibev.h",
@@ -6770,12 +7547,14 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Context.h",
    "src/cxx_supportlib/ServerKit/Errors.h",
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
@@ -6911,9 +7690,11 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Context.h",
    "src/cxx_supportlib/ServerKit/Errors.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
@@ -6944,10 +7725,12 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Context.h",
    "src/cxx_supportlib/ServerKit/Errors.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
@@ -6971,11 +7754,20 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/cxx_supportlib/ServerKit/FileIoRing.h"=>
+  ["src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp"],
  "src/cxx_supportlib/ServerKit/HeaderTable.h"=>
   ["src/cxx_supportlib/DataStructures/HashedStaticString.h",
    "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
@@ -7001,6 +7793,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/Context.h",
@@ -7008,11 +7801,13 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
    "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
    "src/cxx_supportlib/ServerKit/HttpRequest.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
@@ -7046,6 +7841,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/Context.h",
@@ -7053,11 +7849,13 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
    "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
    "src/cxx_supportlib/ServerKit/HttpRequest.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
@@ -7092,6 +7890,8 @@
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/macros.hpp"],
+ "src/cxx_supportlib/ServerKit/HttpHeaderScanning.h"=>
+  [],
  "src/cxx_supportlib/ServerKit/HttpRequest.h"=>
   ["src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
@@ -7102,6 +7902,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/Context.h",
@@ -7109,10 +7910,12 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParserState.h",
    "src/cxx_supportlib/ServerKit/HttpHeaderParserState.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
@@ -7157,6 +7960,7 @@
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -7165,6 +7969,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -7175,6 +7980,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequest.h",
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -7184,6 +7990,7 @@
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -7203,8 +8010,16 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/cxx_supportlib/ServerKit/Implementation.cpp"=>
   ["src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/LString.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/macros.hpp"],
  "src/cxx_supportlib/ServerKit/Server.h"=>
   ["src/cxx_supportlib/Algorithms/MovingAverage.h",
@@ -7222,6 +8037,7 @@
    "src/cxx_supportlib/Logging.h",
    "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -7230,6 +8046,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
@@ -7239,6 +8056,7 @@
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -7256,8 +8074,21 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "src/cxx_supportlib/ServerKit/WellKnownHeaders.h"=>
+  ["src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/LString.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp"],
  "src/cxx_supportlib/ServerKit/http_parser.cpp"=>
-  ["src/cxx_supportlib/ServerKit/http_parser.h"],
+  ["src/cxx_supportlib/ServerKit/HttpHeaderScanning.h",
+   "src/cxx_supportlib/ServerKit/http_parser.h"],
  "src/cxx_supportlib/ServerKit/http_parser.h"=>
   [],
  "src/cxx_supportlib/StaticString.h"=>
@@ -7467,6 +8298,31 @@
   ["src/cxx_supportlib/Utils/LargeFiles.h"],
  "src/cxx_supportlib/Utils/LargeFiles.h"=>
   [],
+ "src/cxx_supportlib/Utils/LatencyHistogram.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
  "src/cxx_supportlib/Utils/Lock.h"=>
   [],
  "src/cxx_supportlib/Utils/MemZeroGuard.h"=>
@@ -7988,25 +8844,33 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h",
    "test/cxx/TestSupport.h"],
- "test/cxx/BufferedIOTest.cpp"=>
-  ["src/cxx_supportlib/BackgroundEventLoop.h",
-   "src/cxx_supportlib/Constants.h",
+ "test/cxx/Benchmarks/BenchmarkSupport.h"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "test/cxx/Benchmarks/BusynessIndexBenchmark.cpp"=>
+  ["src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/CoreLoadGenerator.cpp"=>
+  ["src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
-   "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/RandomGenerator.h",
-   "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
-   "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/BufferedIO.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
-   "src/cxx_supportlib/Utils/IniFile.h",
-   "src/cxx_supportlib/Utils/LargeFiles.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
-   "src/cxx_supportlib/Utils/Timer.h",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
@@ -8014,56 +8878,104 @@
    "src/cxx_supportlib/oxt/macros.hpp",
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
-   "src/cxx_supportlib/oxt/tracable_exception.hpp",
-   "test/cxx/../tut/tut.h",
-   "test/cxx/TestSupport.h"],
- "test/cxx/CachedFileStatTest.cpp"=>
-  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp"],
+ "test/cxx/Benchmarks/FileBufferedChannelBenchmark.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.cpp",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
-   "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/RandomGenerator.h",
-   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
+   "src/cxx_supportlib/ServerKit/Channel.h",
+   "src/cxx_supportlib/ServerKit/Context.h",
+   "src/cxx_supportlib/ServerKit/Errors.h",
+   "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
+   "src/cxx_supportlib/ServerKit/Hooks.h",
+   "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
-   "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
    "src/cxx_supportlib/Utils/FastStringStream.h",
-   "src/cxx_supportlib/Utils/HashMap.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
-   "src/cxx_supportlib/Utils/IniFile.h",
-   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
-   "src/cxx_supportlib/Utils/StringMap.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/initialize.hpp",
    "src/cxx_supportlib/oxt/macros.hpp",
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
-   "test/cxx/../tut/tut.h",
-   "test/cxx/TestSupport.h"],
- "test/cxx/ConfigKit/ErrorTest.cpp"=>
-  ["src/cxx_supportlib/BackgroundEventLoop.h",
-   "src/cxx_supportlib/ConfigKit/Common.h",
-   "src/cxx_supportlib/Constants.h",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/HasherBenchmark.cpp"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/HeaderTableLookupBenchmark.cpp"=>
+  ["src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/ServerKit/HeaderTable.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/HttpHeaderParserBenchmark.cpp"=>
+  ["src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/ServerKit/HttpHeaderScanning.h",
+   "src/cxx_supportlib/ServerKit/http_parser.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/ProcessMetricsCollectorBenchmark.cpp"=>
+  ["src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
-   "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/RandomGenerator.h",
-   "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
-   "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
@@ -8073,31 +8985,49 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
-   "test/cxx/../tut/tut.h",
-   "test/cxx/TestSupport.h"],
- "test/cxx/ConfigKit/SchemaTest.cpp"=>
-  ["src/cxx_supportlib/BackgroundEventLoop.h",
-   "src/cxx_supportlib/ConfigKit/Common.h",
-   "src/cxx_supportlib/ConfigKit/Schema.h",
-   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/SmartSpawnerBenchmark.cpp"=>
+  ["src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
+   "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/SpawningKit/Options.h",
+   "src/agent/Core/SpawningKit/PipeWatcher.h",
+   "src/agent/Core/SpawningKit/Result.h",
+   "src/agent/Core/SpawningKit/SmartSpawner.h",
+   "src/agent/Core/SpawningKit/Spawner.h",
+   "src/agent/Core/SpawningKit/UserSwitchingRules.h",
+   "src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
-   "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/LveLoggingDecorator.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
    "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
    "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Timer.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
    "src/cxx_supportlib/oxt/backtrace.hpp",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
@@ -8105,36 +9035,28 @@
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/initialize.hpp",
    "src/cxx_supportlib/oxt/macros.hpp",
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
-   "test/cxx/../tut/tut.h",
-   "test/cxx/TestSupport.h"],
- "test/cxx/ConfigKit/StoreTest.cpp"=>
-  ["src/cxx_supportlib/BackgroundEventLoop.h",
-   "src/cxx_supportlib/ConfigKit/Common.h",
-   "src/cxx_supportlib/ConfigKit/Schema.h",
-   "src/cxx_supportlib/ConfigKit/Store.h",
-   "src/cxx_supportlib/ConfigKit/Utils.h",
-   "src/cxx_supportlib/Constants.h",
-   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/Benchmarks/UstRouterTransactionBenchmark.cpp"=>
+  ["src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
-   "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/RandomGenerator.h",
-   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/StaticString.h",
-   "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
-   "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
-   "src/cxx_supportlib/Utils/IniFile.h",
-   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
    "src/cxx_supportlib/oxt/backtrace.hpp",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
@@ -8146,19 +9068,10 @@
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
-   "test/cxx/../tut/tut.h",
-   "test/cxx/TestSupport.h"],
- "test/cxx/ConfigKit/SubSchemaTest.cpp"=>
+   "test/cxx/Benchmarks/BenchmarkSupport.h"],
+ "test/cxx/BufferedIOTest.cpp"=>
   ["src/cxx_supportlib/BackgroundEventLoop.h",
-   "src/cxx_supportlib/ConfigKit/Common.h",
-   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
-   "src/cxx_supportlib/ConfigKit/Schema.h",
-   "src/cxx_supportlib/ConfigKit/Store.h",
-   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
-   "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
-   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/InstanceDirectory.h",
@@ -8167,17 +9080,15 @@
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
-   "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
-   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/Utils/Timer.h",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
-   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
-   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
@@ -8187,10 +9098,145 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h",
    "test/cxx/TestSupport.h"],
- "test/cxx/ConfigKit/TranslationTest.cpp"=>
+ "test/cxx/CachedFileStatTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/ConfigKit/ErrorTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/ConfigKit/SchemaTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/ConfigKit/StoreTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Store.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/ConfigKit/SubSchemaTest.cpp"=>
   ["src/cxx_supportlib/BackgroundEventLoop.h",
    "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Store.h",
    "src/cxx_supportlib/ConfigKit/TableTranslator.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
@@ -8209,6 +9255,126 @@
    "src/cxx_supportlib/Utils/LargeFiles.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/ConfigKit/TranslationTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Core/ApplicationPool/AutoscalerTest.cpp"=>
+  ["src/agent/Core/ApplicationPool/Autoscaler.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Core/ApplicationPool/BusynessIndexTest.cpp"=>
+  ["src/agent/Core/ApplicationPool/BusynessIndex.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Core/ApplicationPool/IdleConnectionStackTest.cpp"=>
+  ["src/agent/Core/ApplicationPool/IdleConnectionStack.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
@@ -8225,6 +9391,7 @@
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -8301,16 +9468,20 @@
    "test/cxx/TestSupport.h"],
  "test/cxx/Core/ApplicationPool/PoolTest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -8327,6 +9498,7 @@
    "src/agent/Core/UnionStation/StopwatchLog.h",
    "src/agent/Core/UnionStation/Transaction.h",
    "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/AppTypes.h",
    "src/cxx_supportlib/BackgroundEventLoop.h",
    "src/cxx_supportlib/Constants.h",
@@ -8355,6 +9527,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -8395,6 +9568,7 @@
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
@@ -8469,27 +9643,64 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h",
    "test/cxx/TestSupport.h"],
+ "test/cxx/Core/ConfigProfileStoreTest.cpp"=>
+  ["src/agent/Core/ConfigProfileStore.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
  "test/cxx/Core/ControllerTest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
    "src/agent/Core/ApplicationPool/TestSession.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -8532,6 +9743,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -8542,6 +9754,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -8553,6 +9766,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -8569,6 +9783,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -8604,26 +9819,123 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h",
    "test/cxx/TestSupport.h"],
+ "test/cxx/Core/MetricsTest.cpp"=>
+  ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
+   "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
+   "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
+   "src/agent/Core/ApplicationPool/Common.h",
+   "src/agent/Core/ApplicationPool/Context.h",
+   "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
+   "src/agent/Core/ApplicationPool/Options.h",
+   "src/agent/Core/ApplicationPool/Process.h",
+   "src/agent/Core/ApplicationPool/Session.h",
+   "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/Controller/Metrics.h",
+   "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
+   "src/agent/Core/SpawningKit/Config.h",
+   "src/agent/Core/SpawningKit/DirectSpawner.h",
+   "src/agent/Core/SpawningKit/DummySpawner.h",
+   "src/agent/Core/SpawningKit/Factory.h",
+   "src/agent/Core/SpawningKit/Options.h",
+   "src/agent/Core/SpawningKit/PipeWatcher.h",
+   "src/agent/Core/SpawningKit/Result.h",
+   "src/agent/Core/SpawningKit/SmartSpawner.h",
+   "src/agent/Core/SpawningKit/Spawner.h",
+   "src/agent/Core/SpawningKit/UserSwitchingRules.h",
+   "src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/agent/Shared/ApplicationPoolApiKey.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/AppTypes.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/Hooks.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/LveLoggingDecorator.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/ClassUtils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/Lock.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Timer.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../macros.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/spin_lock.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
  "test/cxx/Core/RequestHandlerTest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/ErrorRenderer.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Client.h",
    "src/agent/Core/Controller/Config.h",
+   "src/agent/Core/Controller/Metrics.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/Controller/TurboCaching.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -8666,6 +9978,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -8676,6 +9989,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -8687,52 +10001,92 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/AnsiColorConstants.h",
-   "src/cxx_supportlib/Utils/BufferedIO.h",
-   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
-   "src/cxx_supportlib/Utils/ClassUtils.h",
-   "src/cxx_supportlib/Utils/DateParsing.h",
+   "src/cxx_supportlib/Utils/AnsiColorConstants.h",
+   "src/cxx_supportlib/Utils/BufferedIO.h",
+   "src/cxx_supportlib/Utils/CachedFileStat.hpp",
+   "src/cxx_supportlib/Utils/ClassUtils.h",
+   "src/cxx_supportlib/Utils/DateParsing.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/HttpConstants.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/Lock.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/MessagePassing.h",
+   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/SpeedMeter.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/StringScanning.h",
+   "src/cxx_supportlib/Utils/SystemMetricsCollector.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/Template.h",
+   "src/cxx_supportlib/Utils/Timer.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../macros.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
+   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/spin_lock.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Core/ResponseCacheStoreTest.cpp"=>
+  ["src/agent/Core/ResponseCacheStore.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
-   "src/cxx_supportlib/Utils/HashMap.h",
    "src/cxx_supportlib/Utils/Hasher.h",
-   "src/cxx_supportlib/Utils/HttpConstants.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
-   "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
-   "src/cxx_supportlib/Utils/MessagePassing.h",
-   "src/cxx_supportlib/Utils/ProcessMetricsCollector.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
-   "src/cxx_supportlib/Utils/SpeedMeter.h",
    "src/cxx_supportlib/Utils/StrIntUtils.h",
-   "src/cxx_supportlib/Utils/StringMap.h",
-   "src/cxx_supportlib/Utils/StringScanning.h",
-   "src/cxx_supportlib/Utils/SystemMetricsCollector.h",
    "src/cxx_supportlib/Utils/SystemTime.h",
-   "src/cxx_supportlib/Utils/Template.h",
-   "src/cxx_supportlib/Utils/Timer.h",
    "src/cxx_supportlib/Utils/VariantMap.h",
    "src/cxx_supportlib/oxt/backtrace.hpp",
-   "src/cxx_supportlib/oxt/detail/../macros.hpp",
    "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
    "src/cxx_supportlib/oxt/detail/context.hpp",
-   "src/cxx_supportlib/oxt/detail/spin_lock_darwin.hpp",
-   "src/cxx_supportlib/oxt/detail/spin_lock_gcc_x86.hpp",
-   "src/cxx_supportlib/oxt/detail/spin_lock_portable.hpp",
-   "src/cxx_supportlib/oxt/detail/spin_lock_pthreads.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
    "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
-   "src/cxx_supportlib/oxt/dynamic_thread_group.hpp",
    "src/cxx_supportlib/oxt/macros.hpp",
-   "src/cxx_supportlib/oxt/spin_lock.hpp",
    "src/cxx_supportlib/oxt/system_calls.hpp",
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
@@ -8740,20 +10094,26 @@
    "test/cxx/TestSupport.h"],
  "test/cxx/Core/ResponseCacheTest.cpp"=>
   ["src/agent/Core/ApplicationPool/AbstractSession.h",
+   "src/agent/Core/ApplicationPool/Autoscaler.h",
    "src/agent/Core/ApplicationPool/BasicGroupInfo.h",
    "src/agent/Core/ApplicationPool/BasicProcessInfo.h",
+   "src/agent/Core/ApplicationPool/BusynessIndex.h",
    "src/agent/Core/ApplicationPool/Common.h",
    "src/agent/Core/ApplicationPool/Context.h",
    "src/agent/Core/ApplicationPool/Group.h",
+   "src/agent/Core/ApplicationPool/IdleConnectionStack.h",
    "src/agent/Core/ApplicationPool/Options.h",
    "src/agent/Core/ApplicationPool/Pool.h",
    "src/agent/Core/ApplicationPool/Process.h",
    "src/agent/Core/ApplicationPool/Session.h",
    "src/agent/Core/ApplicationPool/Socket.h",
+   "src/agent/Core/ApplicationPool/StateSnapshot.h",
+   "src/agent/Core/ConfigProfileStore.h",
    "src/agent/Core/Controller/AppResponse.h",
    "src/agent/Core/Controller/Config.h",
    "src/agent/Core/Controller/Request.h",
    "src/agent/Core/ResponseCache.h",
+   "src/agent/Core/ResponseCacheStore.h",
    "src/agent/Core/SpawningKit/BackgroundIOCapturer.h",
    "src/agent/Core/SpawningKit/Config.h",
    "src/agent/Core/SpawningKit/DirectSpawner.h",
@@ -8795,6 +10155,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -8805,6 +10166,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -8816,6 +10178,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -8832,6 +10195,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/Lock.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
@@ -9026,6 +10390,8 @@
    "src/agent/UstRouter/LogSink.h",
    "src/agent/UstRouter/RemoteSender.h",
    "src/agent/UstRouter/RemoteSink.h",
+   "src/agent/UstRouter/Shard.h",
+   "src/agent/UstRouter/Spool.h",
    "src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/BackgroundEventLoop.h",
@@ -9037,7 +10403,6 @@
    "src/cxx_supportlib/ConfigKit/Utils.h",
    "src/cxx_supportlib/Constants.h",
    "src/cxx_supportlib/DataStructures/HashedStaticString.h",
-   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/DataStructures/StringKeyTable.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
@@ -9050,6 +10415,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -9058,13 +10424,13 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/Server.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/UnionStationFilterSupport.h",
    "src/cxx_supportlib/Utils.h",
-   "src/cxx_supportlib/Utils/BlockingQueue.h",
    "src/cxx_supportlib/Utils/Curl.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/HashMap.h",
@@ -9073,6 +10439,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ReleaseableScopedPointer.h",
@@ -9604,10 +10971,12 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Context.h",
    "src/cxx_supportlib/ServerKit/Errors.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
@@ -9650,6 +11019,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
@@ -9672,6 +11042,35 @@
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h",
    "test/cxx/TestSupport.h"],
+ "test/cxx/ServerKit/HttpHeaderScanningTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/ServerKit/HttpHeaderScanning.h",
+   "src/cxx_supportlib/ServerKit/http_parser.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
  "test/cxx/ServerKit/HttpServerTest.cpp"=>
   ["src/cxx_supportlib/Algorithms/MovingAverage.h",
    "src/cxx_supportlib/BackgroundEventLoop.h",
@@ -9695,6 +11094,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -9703,6 +11103,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/HeaderTable.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/HttpChunkedBodyParser.h",
@@ -9714,6 +11115,7 @@
    "src/cxx_supportlib/ServerKit/HttpRequestRef.h",
    "src/cxx_supportlib/ServerKit/HttpServer.h",
    "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/WellKnownHeaders.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
@@ -9725,6 +11127,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -9764,6 +11167,7 @@
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
    "src/cxx_supportlib/ServerKit/Channel.h",
    "src/cxx_supportlib/ServerKit/Client.h",
    "src/cxx_supportlib/ServerKit/ClientRef.h",
@@ -9772,6 +11176,7 @@
    "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
    "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
    "src/cxx_supportlib/ServerKit/Hooks.h",
    "src/cxx_supportlib/ServerKit/Server.h",
    "src/cxx_supportlib/ServerKit/http_parser.h",
@@ -9783,6 +11188,7 @@
    "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
@@ -9973,27 +11379,242 @@
    "src/cxx_supportlib/oxt/thread.hpp",
    "src/cxx_supportlib/oxt/tracable_exception.hpp",
    "test/cxx/../tut/tut.h"],
+ "test/cxx/UstRouter/FileSinkTest.cpp"=>
+  ["src/agent/Core/UnionStation/Connection.h",
+   "src/agent/Core/UnionStation/Context.h",
+   "src/agent/Core/UnionStation/Transaction.h",
+   "src/agent/UstRouter/Client.h",
+   "src/agent/UstRouter/Controller.h",
+   "src/agent/UstRouter/FileSink.h",
+   "src/agent/UstRouter/LogSink.h",
+   "src/agent/UstRouter/RemoteSender.h",
+   "src/agent/UstRouter/RemoteSink.h",
+   "src/agent/UstRouter/Shard.h",
+   "src/agent/UstRouter/Spool.h",
+   "src/agent/UstRouter/Transaction.h",
+   "src/cxx_supportlib/Algorithms/MovingAverage.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/ConfigKit/Common.h",
+   "src/cxx_supportlib/ConfigKit/ConfigKit.h",
+   "src/cxx_supportlib/ConfigKit/Schema.h",
+   "src/cxx_supportlib/ConfigKit/Store.h",
+   "src/cxx_supportlib/ConfigKit/TableTranslator.h",
+   "src/cxx_supportlib/ConfigKit/Utils.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/DataStructures/HashedStaticString.h",
+   "src/cxx_supportlib/DataStructures/StringKeyTable.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/MemoryKit/mbuf.h",
+   "src/cxx_supportlib/MemoryKit/palloc.h",
+   "src/cxx_supportlib/MessageReadersWriters.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/SafeLibev.h",
+   "src/cxx_supportlib/ServerKit/BufferFilePool.h",
+   "src/cxx_supportlib/ServerKit/Channel.h",
+   "src/cxx_supportlib/ServerKit/Client.h",
+   "src/cxx_supportlib/ServerKit/ClientRef.h",
+   "src/cxx_supportlib/ServerKit/Context.h",
+   "src/cxx_supportlib/ServerKit/Errors.h",
+   "src/cxx_supportlib/ServerKit/FdSourceChannel.h",
+   "src/cxx_supportlib/ServerKit/FileBufferedChannel.h",
+   "src/cxx_supportlib/ServerKit/FileBufferedFdSinkChannel.h",
+   "src/cxx_supportlib/ServerKit/FileIoRing.h",
+   "src/cxx_supportlib/ServerKit/Hooks.h",
+   "src/cxx_supportlib/ServerKit/Server.h",
+   "src/cxx_supportlib/ServerKit/http_parser.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/UnionStationFilterSupport.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/Curl.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/HashMap.h",
+   "src/cxx_supportlib/Utils/Hasher.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ReleaseableScopedPointer.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/StringMap.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/UstRouter/RemoteSenderTest.cpp"=>
+  ["src/agent/UstRouter/RemoteSender.h",
+   "src/agent/UstRouter/Spool.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/Curl.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/UstRouter/SpoolTest.cpp"=>
+  ["src/agent/UstRouter/Spool.h",
+   "src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
  "test/cxx/UstRouter/TransactionTest.cpp"=>
   ["src/agent/UstRouter/Transaction.h",
    "src/cxx_supportlib/BackgroundEventLoop.h",
    "src/cxx_supportlib/Constants.h",
-   "src/cxx_supportlib/DataStructures/LString.h",
    "src/cxx_supportlib/Exceptions.h",
    "src/cxx_supportlib/FileDescriptor.h",
    "src/cxx_supportlib/InstanceDirectory.h",
    "src/cxx_supportlib/Logging.h",
-   "src/cxx_supportlib/MemoryKit/mbuf.h",
    "src/cxx_supportlib/MemoryKit/palloc.h",
    "src/cxx_supportlib/RandomGenerator.h",
    "src/cxx_supportlib/ResourceLocator.h",
    "src/cxx_supportlib/StaticString.h",
    "src/cxx_supportlib/Utils.h",
    "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/JsonUtils.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/MemZeroGuard.h",
+   "src/cxx_supportlib/Utils/MessageIO.h",
+   "src/cxx_supportlib/Utils/ScopeGuard.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/Utils/VariantMap.h",
+   "src/cxx_supportlib/oxt/backtrace.hpp",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/backtrace_enabled.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Utils/HasherTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
    "src/cxx_supportlib/Utils/Hasher.h",
    "src/cxx_supportlib/Utils/IOUtils.h",
    "src/cxx_supportlib/Utils/IniFile.h",
+   "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/StrIntUtils.h",
+   "src/cxx_supportlib/Utils/SystemTime.h",
+   "src/cxx_supportlib/oxt/detail/../spin_lock.hpp",
+   "src/cxx_supportlib/oxt/detail/context.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_disabled.hpp",
+   "src/cxx_supportlib/oxt/detail/tracable_exception_enabled.hpp",
+   "src/cxx_supportlib/oxt/macros.hpp",
+   "src/cxx_supportlib/oxt/system_calls.hpp",
+   "src/cxx_supportlib/oxt/thread.hpp",
+   "src/cxx_supportlib/oxt/tracable_exception.hpp",
+   "test/cxx/../tut/tut.h",
+   "test/cxx/TestSupport.h"],
+ "test/cxx/Utils/LatencyHistogramTest.cpp"=>
+  ["src/cxx_supportlib/BackgroundEventLoop.h",
+   "src/cxx_supportlib/Constants.h",
+   "src/cxx_supportlib/Exceptions.h",
+   "src/cxx_supportlib/FileDescriptor.h",
+   "src/cxx_supportlib/InstanceDirectory.h",
+   "src/cxx_supportlib/Logging.h",
+   "src/cxx_supportlib/RandomGenerator.h",
+   "src/cxx_supportlib/ResourceLocator.h",
+   "src/cxx_supportlib/StaticString.h",
+   "src/cxx_supportlib/Utils.h",
+   "src/cxx_supportlib/Utils/FastStringStream.h",
+   "src/cxx_supportlib/Utils/IOUtils.h",
+   "src/cxx_supportlib/Utils/IniFile.h",
    "src/cxx_supportlib/Utils/JsonUtils.h",
    "src/cxx_supportlib/Utils/LargeFiles.h",
+   "src/cxx_supportlib/Utils/LatencyHistogram.h",
    "src/cxx_supportlib/Utils/MemZeroGuard.h",
    "src/cxx_supportlib/Utils/MessageIO.h",
    "src/cxx_supportlib/Utils/ScopeGuard.h",
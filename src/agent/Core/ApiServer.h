@@ -30,6 +30,9 @@
 #include <oxt/thread.hpp>
 #include <sstream>
 #include <string>
+#include <vector>
+#include <map>
+#include <set>
 #include <cstring>
 #include <sys/types.h>
 
@@ -63,6 +66,7 @@ public:
 	Authorization authorization;
 	unsigned int controllerStatesGathered;
 	vector<Json::Value> controllerStates;
+	MetricsSnapshot metrics;
 
 	DEFINE_SERVER_KIT_BASE_HTTP_REQUEST_FOOTER(Passenger::Core::ApiServer::Request);
 };
@@ -101,10 +105,18 @@ private:
 			processServerStatus(client, req);
 		} else if (regex_match(path, serverConnectionPath)) {
 			processServerConnectionOperation(client, req);
+		} else if (path == P_STATIC_STRING("/turbocache.json")) {
+			processTurboCacheStatus(client, req);
 		} else if (path == P_STATIC_STRING("/pool.xml")) {
 			processPoolStatusXml(client, req);
 		} else if (path == P_STATIC_STRING("/pool.txt")) {
 			processPoolStatusTxt(client, req);
+		} else if (path == P_STATIC_STRING("/pool.json")) {
+			processPoolStatusJson(client, req);
+		} else if (path == P_STATIC_STRING("/metrics")) {
+			processMetrics(client, req);
+		} else if (path == P_STATIC_STRING("/request_latency.json")) {
+			processRequestLatency(client, req);
 		} else if (path == P_STATIC_STRING("/pool/restart_app_group.json")) {
 			processPoolRestartAppGroup(client, req);
 		} else if (path == P_STATIC_STRING("/pool/detach_process.json")) {
@@ -230,6 +242,155 @@ private:
 		}
 	}
 
+	void gatherControllerMetrics(Client *client, Request *req,
+		Controller *controller, bool latencyAsJson)
+	{
+		boost::shared_ptr<MetricsSnapshot> metrics = boost::make_shared<MetricsSnapshot>();
+		controller->collectMetrics(*metrics);
+		getContext()->libev->runLater(boost::bind(&ApiServer::controllerMetricsGathered,
+			this, client, req, metrics, latencyAsJson));
+	}
+
+	void controllerMetricsGathered(Client *client, Request *req,
+		boost::shared_ptr<MetricsSnapshot> metrics, bool latencyAsJson)
+	{
+		if (req->ended()) {
+			unrefRequest(req, __FILE__, __LINE__);
+			return;
+		}
+
+		req->controllerStatesGathered++;
+		req->metrics.merge(*metrics);
+
+		if (req->controllerStatesGathered == controllers.size()) {
+			HeaderTable headers;
+			ApplicationPool2::PoolSnapshotPtr poolSnapshot = appPool->getSnapshot();
+			if (!isAdministrator(req->authorization)) {
+				poolSnapshot = filterMetricsByAuthorization(req->authorization,
+					poolSnapshot, req->metrics);
+			}
+			if (latencyAsJson) {
+				headers.insert(req->pool, "Content-Type", "application/json");
+				writeSimpleResponse(client, 200, &headers,
+					psg_pstrdup(req->pool,
+						req->metrics.inspectRequestLatencyAsJson().toStyledString()));
+			} else {
+				headers.insert(req->pool, "Content-Type", "text/plain; version=0.0.4");
+				writeSimpleResponse(client, 200, &headers,
+					psg_pstrdup(req->pool, req->metrics.toPrometheusText(poolSnapshot.get())));
+			}
+			if (!req->ended()) {
+				Request *req2 = req;
+				endRequest(&client, &req2);
+			}
+		}
+
+		unrefRequest(req, __FILE__, __LINE__);
+	}
+
+	static bool isAdministrator(const Authorization &auth) {
+		return auth.uid == 0 || auth.uid == geteuid() || auth.apiKey.isSuper();
+	}
+
+	/**
+	 * Removes the groups that `auth` may not read from both the pool snapshot
+	 * and the metrics snapshot, the same way Pool::inspect() and Pool::toXml()
+	 * only show groups that pass Group::authorizeByUid() or
+	 * Group::authorizeByApiKey(). Request metrics of groups that are no longer
+	 * in the pool are removed too, because their owner can't be determined.
+	 */
+	static ApplicationPool2::PoolSnapshotPtr filterMetricsByAuthorization(
+		const Authorization &auth, const ApplicationPool2::PoolSnapshotPtr &poolSnapshot,
+		MetricsSnapshot &metrics)
+	{
+		boost::shared_ptr<ApplicationPool2::PoolSnapshot> result =
+			boost::make_shared<ApplicationPool2::PoolSnapshot>(*poolSnapshot);
+		vector<ApplicationPool2::GroupSnapshot> groups;
+		set<string> groupNames;
+
+		vector<ApplicationPool2::GroupSnapshot>::const_iterator it, end = result->groups.end();
+		for (it = result->groups.begin(); it != end; it++) {
+			if (it->authorizeByUid(auth.uid) || it->authorizeByApiKey(auth.apiKey)) {
+				groups.push_back(*it);
+				groupNames.insert(it->name);
+			}
+		}
+		result->groups.swap(groups);
+
+		map<string, GroupRequestMetrics>::iterator m_it = metrics.groups.begin();
+		while (m_it != metrics.groups.end()) {
+			if (groupNames.find(m_it->first) == groupNames.end()) {
+				metrics.groups.erase(m_it++);
+			} else {
+				m_it++;
+			}
+		}
+
+		return result;
+	}
+
+	/**
+	 * Responds with request, turbocache, buffer and spawn metrics in the
+	 * Prometheus text exposition format. Each Controller's metrics are
+	 * collected on its own thread, then merged here. Callers that aren't
+	 * administrators only see the groups they are authorized for.
+	 */
+	void processMetrics(Client *client, Request *req) {
+		Authorization auth(authorize(this, client, req));
+		if (auth.canReadPool) {
+			req->authorization = auth;
+			for (unsigned int i = 0; i < controllers.size(); i++) {
+				refRequest(req, __FILE__, __LINE__);
+				controllers[i]->getContext()->libev->runLater(boost::bind(
+					&ApiServer::gatherControllerMetrics, this,
+					client, req, controllers[i], false));
+			}
+		} else {
+			apiServerRespondWith401(this, client, req);
+		}
+	}
+
+	/**
+	 * Responds with the per-group request latency breakdown (see
+	 * GroupRequestMetrics) as JSON. Unlike /metrics, which only has
+	 * power-of-two buckets, this has the full histogram precision.
+	 */
+	void processRequestLatency(Client *client, Request *req) {
+		Authorization auth(authorize(this, client, req));
+		if (auth.canReadPool) {
+			req->authorization = auth;
+			for (unsigned int i = 0; i < controllers.size(); i++) {
+				refRequest(req, __FILE__, __LINE__);
+				controllers[i]->getContext()->libev->runLater(boost::bind(
+					&ApiServer::gatherControllerMetrics, this,
+					client, req, controllers[i], true));
+			}
+		} else {
+			apiServerRespondWith401(this, client, req);
+		}
+	}
+
+	void processTurboCacheStatus(Client *client, Request *req) {
+		if (authorizeStateInspectionOperation(this, client, req)) {
+			HeaderTable headers;
+			headers.insert(req->pool, "Content-Type", "application/json");
+
+			Json::Value doc;
+			if (turboCacheStore != NULL) {
+				doc = turboCacheStore->inspectStateAsJson();
+			} else {
+				doc["capacity"] = Json::Value::null;
+			}
+			writeSimpleResponse(client, 200, &headers,
+				psg_pstrdup(req->pool, doc.toStyledString()));
+			if (!req->ended()) {
+				endRequest(&client, &req);
+			}
+		} else {
+			apiServerRespondWith401(this, client, req);
+		}
+	}
+
 	void processPoolStatusXml(Client *client, Request *req) {
 		Authorization auth(authorize(this, client, req));
 		if (auth.canReadPool) {
@@ -294,6 +455,38 @@ private:
 		}
 	}
 
+	void processPoolStatusJson(Client *client, Request *req) {
+		Authorization auth(authorize(this, client, req));
+		if (auth.canReadPool) {
+			ApplicationPool2::Pool::ToJsonOptions options(
+				parseQueryString(req->getQueryString()));
+			options.uid = auth.uid;
+			options.apiKey = auth.apiKey;
+
+			HeaderTable headers;
+			headers.insert(req->pool, "Content-Type", "application/json");
+			writeSimpleResponse(client, 200, &headers,
+				psg_pstrdup(req->pool, appPool->toJson(options)));
+			if (!req->ended()) {
+				endRequest(&client, &req);
+			}
+		} else {
+			HeaderTable headers;
+			headers.insert(req->pool, "Cache-Control", "no-cache, no-store, must-revalidate");
+			headers.insert(req->pool, "WWW-Authenticate", "Basic realm=\"api\"");
+			if (clientOnUnixDomainSocket(client) && appPool->getGroupCount() == 0) {
+				// Allow admin tools that connected through the Unix domain socket
+				// to know that this authorization error is caused by the fact
+				// that the pool is empty.
+				headers.insert(req->pool, "Pool-Empty", "true");
+			}
+			writeSimpleResponse(client, 401, &headers, "Unauthorized");
+			if (!req->ended()) {
+				endRequest(&client, &req);
+			}
+		}
+	}
+
 	void processPoolRestartAppGroup(Client *client, Request *req) {
 		Authorization auth(authorize(this, client, req));
 		if (!auth.canModifyPool) {
@@ -325,6 +518,8 @@ private:
 				options.method = RM_BLOCKING;
 			} else if (restartMethodString == "rolling") {
 				options.method = RM_ROLLING;
+			} else if (restartMethodString == "blue_green") {
+				options.method = RM_BLUE_GREEN;
 			} else {
 				endAsBadRequest(&client, &req, "Unsupported restart method");
 				return;
@@ -639,6 +834,7 @@ protected:
 		}
 		req->authorization = Authorization();
 		req->controllerStates.clear();
+		req->metrics = MetricsSnapshot();
 		ParentClass::deinitializeRequest(client, req);
 	}
 
@@ -646,6 +842,7 @@ public:
 	vector<Controller *> controllers;
 	ApiAccountDatabase *apiAccountDatabase;
 	ApplicationPool2::PoolPtr appPool;
+	ResponseCacheStorePtr turboCacheStore;
 	string instanceDir;
 	string fdPassingPassword;
 	EventFd *exitEvent;
@@ -0,0 +1,253 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_APPLICATION_POOL2_AUTOSCALER_H_
+#define _PASSENGER_APPLICATION_POOL2_AUTOSCALER_H_
+
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <cmath>
+#include <Algorithms/MovingAverage.h>
+
+namespace Passenger {
+namespace ApplicationPool2 {
+
+using namespace std;
+
+
+/**
+ * Decides how many processes a group should have, based on trends in its
+ * request arrival rate, its load (the number of requests being handled at
+ * the same time) and the time that requests spend in the queue.
+ *
+ * The Group records every request arrival and queue time, and the pool's
+ * garbage collector calls `sample()` every `SAMPLE_INTERVAL`. The arrival
+ * rate, the load and the queue time are tracked with moving averages that
+ * have a half-life of 10 seconds. Like in Holt's linear trend method, the
+ * rate at which the average arrival rate changes is tracked too. If traffic
+ * is ramping up then the arrival rate is extrapolated `LOOKAHEAD` into the
+ * future, so that processes are spawned before the traffic arrives instead
+ * of after requests start queuing.
+ *
+ * A process is retired only after the load has been low enough to be
+ * handled by fewer processes for at least `RETIRE_DELAY`, both according
+ * to the short-term average and according to the sustained (long-term,
+ * with a half-life of 2 minutes) average.
+ *
+ * Only meaningful for processes with a limited concurrency: processes with
+ * unlimited concurrency don't have a capacity to compare the load with.
+ *
+ * Not thread-safe.
+ */
+class Autoscaler {
+public:
+	/** How often the pool samples the group, in microseconds. */
+	static const unsigned long long SAMPLE_INTERVAL = 1000000;
+	/** How far ahead traffic ramps are extrapolated, in microseconds. */
+	static const unsigned long long LOOKAHEAD = 30000000;
+	/** How long the load must stay low before a process is retired, in microseconds. */
+	static const unsigned long long RETIRE_DELAY = 60000000;
+	/** The utilization of the processes' capacity to aim for, in percent. */
+	static const unsigned int TARGET_UTILIZATION = 75;
+	/** If requests spend longer than this (in microseconds) in the queue on
+	 * average, then the group needs another process regardless of the load. */
+	static const unsigned long long MAX_QUEUE_TIME = 10000;
+
+private:
+	// Half-life of 10 seconds.
+	typedef DiscExpMovingAverage<500, 10000000, 10000000> ShortTermAverage;
+	// Half-life of 2 minutes.
+	typedef DiscExpMovingAverage<500, 120000000, 120000000> LongTermAverage;
+
+	ShortTermAverage shortTermRate;
+	/** How quickly `shortTermRate` changes, in requests per second per second. */
+	ShortTermAverage rateTrend;
+	ShortTermAverage shortTermLoad;
+	LongTermAverage longTermLoad;
+	ShortTermAverage queueTime;
+
+	/** Since the last sample. */
+	boost::uint64_t arrivals;
+	boost::uint64_t totalQueueTime;
+	unsigned long long lastSampleTime;
+	/** When the load first dropped low enough to be handled by fewer
+	 * processes, or 0 if it currently isn't. */
+	unsigned long long underutilizedSince;
+
+	double prevRate;
+	double predictedRate;
+	double predictedLoad;
+	unsigned int desiredProcesses;
+	bool retire;
+
+	/**
+	 * An exponential moving average lags behind a linearly changing value
+	 * by its mean age, which is the half-life divided by ln(2).
+	 */
+	static double shortTermLag() {
+		return 10 / log(2.0);
+	}
+
+	static unsigned int processesNeededFor(double load, unsigned int processConcurrency) {
+		double capacity = processConcurrency * TARGET_UTILIZATION / 100.0;
+		return (unsigned int) ceil(load / capacity - 0.001);
+	}
+
+public:
+	Autoscaler()
+		: arrivals(0),
+		  totalQueueTime(0),
+		  lastSampleTime(0),
+		  underutilizedSince(0),
+		  prevRate(0),
+		  predictedRate(0),
+		  predictedLoad(0),
+		  desiredProcesses(0),
+		  retire(false)
+		{ }
+
+	void recordArrival() {
+		arrivals++;
+	}
+
+	void recordQueueTime(unsigned long long usec) {
+		totalQueueTime += usec;
+	}
+
+	/**
+	 * Updates the averages with the arrivals and queue times recorded since
+	 * the last sample, and with the current state of the group, and then
+	 * recomputes `getDesiredProcesses()` and `shouldRetireProcess()`.
+	 * Does nothing if less than half of `SAMPLE_INTERVAL` has passed since
+	 * the last sample.
+	 *
+	 * @param now The current time, in microseconds.
+	 * @param load The number of sessions currently open on the group's processes.
+	 * @param processCount The number of processes in the group.
+	 * @param processConcurrency The number of requests a single process can
+	 *                           handle concurrently. Must not be 0.
+	 */
+	void sample(unsigned long long now, unsigned int load, unsigned int processCount,
+		unsigned int processConcurrency)
+	{
+		if (lastSampleTime == 0) {
+			// We need an interval to calculate the arrival rate over.
+			lastSampleTime = now;
+			arrivals = 0;
+			totalQueueTime = 0;
+			return;
+		} else if (now < lastSampleTime + SAMPLE_INTERVAL / 2) {
+			// The garbage collector may run more often than the sample
+			// interval. Rates over very short intervals are mostly noise,
+			// so keep accumulating until the next sample.
+			return;
+		}
+
+		double interval = (now - lastSampleTime) / 1000000.0;
+		double rate = arrivals / interval;
+		bool hadRate = shortTermRate.available();
+		shortTermRate.update(rate, now);
+		double currentRate = shortTermRate.average();
+		if (hadRate) {
+			rateTrend.update((currentRate - prevRate) / interval, now);
+		}
+		prevRate = currentRate;
+		shortTermLoad.update(load, now);
+		longTermLoad.update(load, now);
+		queueTime.update(arrivals == 0 ? 0 : (double) totalQueueTime / arrivals, now);
+		arrivals = 0;
+		totalQueueTime = 0;
+		lastSampleTime = now;
+
+		// Extrapolate from the short-term average, which lags behind the
+		// current rate. Declining traffic is not extrapolated: retiring
+		// processes is left to the sustained load.
+		double trend = rateTrend.available() ? rateTrend.average() : 0;
+		predictedRate = currentRate
+			+ std::max(trend, 0.0) * (shortTermLag() + LOOKAHEAD / 1000000.0);
+		predictedLoad = shortTermLoad.average();
+		if (currentRate > 0) {
+			predictedLoad = predictedLoad * predictedRate / currentRate;
+		}
+
+		desiredProcesses = processesNeededFor(predictedLoad, processConcurrency);
+		if (queueTime.average() > MAX_QUEUE_TIME) {
+			desiredProcesses = std::max(desiredProcesses, processCount + 1);
+		}
+
+		// Retire processes only if both the short-term and the sustained
+		// load can be handled by fewer processes.
+		unsigned int sustainedProcesses = processesNeededFor(
+			std::max(shortTermLoad.average(), longTermLoad.average()),
+			processConcurrency);
+		if (std::max(sustainedProcesses, desiredProcesses) < processCount) {
+			if (underutilizedSince == 0) {
+				underutilizedSince = now;
+			}
+		} else {
+			underutilizedSince = 0;
+		}
+		retire = underutilizedSince != 0 && now - underutilizedSince >= RETIRE_DELAY;
+	}
+
+	/**
+	 * The number of processes that the group should have in order to
+	 * handle the predicted load at `TARGET_UTILIZATION`.
+	 */
+	unsigned int getDesiredProcesses() const {
+		return desiredProcesses;
+	}
+
+	/** Whether the load has been low enough for long enough to retire a process. */
+	bool shouldRetireProcess() const {
+		return retire;
+	}
+
+	/** The arrival rate in requests per second, averaged over the short term. */
+	double getRequestRate() const {
+		return shortTermRate.available() ? shortTermRate.average() : 0;
+	}
+
+	/** The arrival rate that is expected `LOOKAHEAD` from now. */
+	double getPredictedRequestRate() const {
+		return predictedRate;
+	}
+
+	/** The number of concurrent requests that is expected `LOOKAHEAD` from now. */
+	double getPredictedLoad() const {
+		return predictedLoad;
+	}
+
+	/** The average queue time in microseconds, averaged over the short term. */
+	double getQueueTime() const {
+		return queueTime.available() ? queueTime.average() : 0;
+	}
+};
+
+
+} // namespace ApplicationPool2
+} // namespace Passenger
+
+#endif /* _PASSENGER_APPLICATION_POOL2_AUTOSCALER_H_ */
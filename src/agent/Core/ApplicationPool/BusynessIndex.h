@@ -0,0 +1,183 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_APPLICATION_POOL2_BUSYNESS_INDEX_H_
+#define _PASSENGER_APPLICATION_POOL2_BUSYNESS_INDEX_H_
+
+#include <boost/container/vector.hpp>
+#include <cassert>
+
+namespace Passenger {
+namespace ApplicationPool2 {
+
+
+/**
+ * Keeps track of the busyness levels of a list of processes, indexed by
+ * their position in that list, and allows finding the least busy process
+ * in O(1) time.
+ *
+ * Internally this is an indexed binary min-heap: `heap` contains process
+ * indices ordered by busyness, and `positions` maps each process index
+ * back to its position in `heap`, so that the busyness of any process can
+ * be changed in O(log n) time.
+ *
+ * Ties are broken in favor of the lowest process index. This makes
+ * `lowest()` return exactly the same process as a linear scan for the
+ * first process with the lowest busyness would.
+ *
+ * Not thread-safe.
+ */
+class BusynessIndex {
+private:
+	boost::container::vector<int> levels;
+	boost::container::vector<unsigned int> heap;
+	boost::container::vector<unsigned int> positions;
+
+	bool less(unsigned int a, unsigned int b) const {
+		return levels[a] < levels[b] || (levels[a] == levels[b] && a < b);
+	}
+
+	void place(unsigned int pos, unsigned int index) {
+		heap[pos] = index;
+		positions[index] = pos;
+	}
+
+	void siftUp(unsigned int pos) {
+		unsigned int index = heap[pos];
+		while (pos > 0) {
+			unsigned int parent = (pos - 1) / 2;
+			if (!less(index, heap[parent])) {
+				break;
+			}
+			place(pos, heap[parent]);
+			pos = parent;
+		}
+		place(pos, index);
+	}
+
+	void siftDown(unsigned int pos) {
+		unsigned int index = heap[pos];
+		unsigned int size = heap.size();
+		while (true) {
+			unsigned int child = 2 * pos + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && less(heap[child + 1], heap[child])) {
+				child++;
+			}
+			if (!less(heap[child], index)) {
+				break;
+			}
+			place(pos, heap[child]);
+			pos = child;
+		}
+		place(pos, index);
+	}
+
+public:
+	unsigned int size() const {
+		return levels.size();
+	}
+
+	bool empty() const {
+		return levels.empty();
+	}
+
+	void clear() {
+		levels.clear();
+		heap.clear();
+		positions.clear();
+	}
+
+	void shrink_to_fit() {
+		levels.shrink_to_fit();
+		heap.shrink_to_fit();
+		positions.shrink_to_fit();
+	}
+
+	/**
+	 * Adds a process with the given busyness. Its index is the old `size()`.
+	 */
+	void push_back(int busyness) {
+		unsigned int index = levels.size();
+		levels.push_back(busyness);
+		positions.push_back(index);
+		heap.push_back(index);
+		siftUp(index);
+	}
+
+	/**
+	 * Changes the busyness of the process with the given index.
+	 */
+	void update(unsigned int index, int busyness) {
+		assert(index < levels.size());
+		int old = levels[index];
+		levels[index] = busyness;
+		if (busyness < old) {
+			siftUp(positions[index]);
+		} else if (busyness > old) {
+			siftDown(positions[index]);
+		}
+	}
+
+	int operator[](unsigned int index) const {
+		return levels[index];
+	}
+
+	/**
+	 * Returns the index of the least busy process. Must not be called
+	 * when empty.
+	 */
+	unsigned int lowest() const {
+		assert(!empty());
+		return heap[0];
+	}
+
+	/**
+	 * Checks whether the internal data structures are consistent.
+	 * Takes O(n) time; meant for self-checks and unit tests.
+	 */
+	bool verify() const {
+		if (heap.size() != levels.size() || positions.size() != levels.size()) {
+			return false;
+		}
+		for (unsigned int pos = 0; pos < heap.size(); pos++) {
+			if (positions[heap[pos]] != pos) {
+				return false;
+			}
+			if (pos > 0 && less(heap[pos], heap[(pos - 1) / 2])) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+
+} // namespace ApplicationPool2
+} // namespace Passenger
+
+#endif /* _PASSENGER_APPLICATION_POOL2_BUSYNESS_INDEX_H_ */
@@ -37,6 +37,7 @@
 #include <MemoryKit/palloc.h>
 #include <DataStructures/StringKeyTable.h>
 #include <Utils/VariantMap.h>
+#include <Utils/SystemTime.h>
 #include <Core/ApplicationPool/Options.h>
 #include <Core/SpawningKit/Config.h>
 #include <Core/UnionStation/Context.h>
@@ -154,12 +155,16 @@ enum DisableResult {
 enum RestartMethod {
 	// Whether a rolling restart is performed, is determined by whether rolling restart
 	// was enabled in the web server configuration (i.e. whether group->options.rollingRestart
-	// is already true).
+	// is already true). Likewise for blue/green restarts and options.blueGreenRestart.
 	RM_DEFAULT,
 	// Perform a blocking restart. group->options.rollingRestart will not be changed.
 	RM_BLOCKING,
 	// Perform a rolling restart. group->options.rollingRestart will not be changed.
-	RM_ROLLING
+	RM_ROLLING,
+	// Perform a blue/green restart: spawn replacements with the new spawner and
+	// only retire old processes once their replacements are routable.
+	// group->options.blueGreenRestart will not be changed.
+	RM_BLUE_GREEN
 };
 
 typedef boost::shared_ptr<Pool> PoolPtr;
@@ -188,10 +193,13 @@ struct GetCallback {
 struct GetWaiter {
 	Options options;
 	GetCallback callback;
+	/** When this waiter was put on a Group's wait list, or 0 if unknown. */
+	MonotonicTimeUsec enqueueTime;
 
 	GetWaiter(const Options &o, const GetCallback &cb)
 		: options(o),
-		  callback(cb)
+		  callback(cb),
+		  enqueueTime(0)
 	{
 		options.persist(o);
 	}
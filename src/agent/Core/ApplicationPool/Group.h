@@ -48,9 +48,12 @@
 #include <MemoryKit/palloc.h>
 #include <Hooks.h>
 #include <Utils.h>
+#include <Utils/LatencyHistogram.h>
 #include <Core/ApplicationPool/Common.h>
 #include <Core/ApplicationPool/Context.h>
 #include <Core/ApplicationPool/BasicGroupInfo.h>
+#include <Core/ApplicationPool/BusynessIndex.h>
+#include <Core/ApplicationPool/Autoscaler.h>
 #include <Core/ApplicationPool/Process.h>
 #include <Core/ApplicationPool/Options.h>
 #include <Core/SpawningKit/Factory.h>
@@ -74,11 +77,6 @@ class Group: public boost::enable_shared_from_this<Group> {
 public:
 	friend class Pool;
 
-	struct GetAction {
-		GetCallback callback;
-		SessionPtr session;
-	};
-
 	struct DisableWaiter {
 		ProcessPtr process;
 		DisableCallback callback;
@@ -134,7 +132,9 @@ public:
 	 */
 	unsigned int restartsInitiated;
 	/**
-	 * The number of processes that are being spawned right now.
+	 * The number of processes that are being spawned right now. Up to
+	 * `options.spawnConcurrency` processes may be spawned at the same time,
+	 * each by its own spawner thread.
 	 *
 	 * Invariant:
 	 *     if processesBeingSpawned > 0: m_spawning
@@ -154,9 +154,9 @@ public:
 	 */
 	boost::atomic<boost::uint8_t> lifeStatus;
 	/**
-	 * Whether the spawner thread is currently working. Note that even
-	 * if it's working, it doesn't necessarily mean that processes are
-	 * being spawned (i.e. that processesBeingSpawned > 0). After the
+	 * Whether any spawner threads are currently working. Note that even
+	 * if they're working, it doesn't necessarily mean that processes are
+	 * being spawned (i.e. that processesBeingSpawned > 0). After a
 	 * thread is done spawning a process, it will attempt to attach
 	 * the newly-spawned process to the group. During that time it's not
 	 * technically spawning anything.
@@ -173,11 +173,85 @@ public:
 	 *    if m_restarting: processesBeingSpawned == 0
 	 */
 	bool m_restarting: 1;
+	/** Whether a blue/green restart is in progress (i.e. whether blueGreenRestart()
+	 * is at work). The old processes stay attached and keep serving requests
+	 * while the restarter thread spawns their replacements, one at a time, with
+	 * the new spawner. An old process is only detached in the same critical
+	 * section in which its replacement is attached, so the number of routable
+	 * processes stays the same. The restarter thread counts as one process being
+	 * spawned. If the group needs more processes in the mean time, regular
+	 * spawner threads add them with `blueGreenSpawner`.
+	 *
+	 * Invariant:
+	 *    if m_blueGreenRestarting: m_spawning && !m_restarting
+	 */
+	bool m_blueGreenRestarting: 1;
 	bool alwaysRestartFileExists: 1;
 
-	/** Contains the spawn loop thread and the restarter thread. */
+	/** Contains the spawn loop threads and the restarter thread. */
 	dynamic_thread_group interruptableThreads;
 
+	/**
+	 * Spawning statistics, for state inspection only. A spawn burst is the
+	 * period during which `m_spawning` is true.
+	 */
+	boost::uint64_t totalProcessesSpawned;
+	MonotonicTimeUsec spawnBurstStartTime;
+	unsigned int spawnBurstProcessesSpawned;
+	MonotonicTimeUsec lastSpawnBurstDuration;
+	unsigned int lastSpawnBurstProcessesSpawned;
+	/** When `getWaitlist` last became non-empty, or 0 if it's empty. */
+	MonotonicTimeUsec getWaitlistNonEmptySince;
+	/** How long it took for `getWaitlist` to become empty again, last time. */
+	MonotonicTimeUsec lastGetWaitlistDrainTime;
+	/**
+	 * How long individual spawns took, successful or not. Updated by the
+	 * spawn threads without holding the pool lock.
+	 */
+	LatencyHistogram spawnDurations;
+
+	/**
+	 * Restart statistics, for state inspection only. They show how much a
+	 * restart affected request latency. A restart lasts from the moment it is
+	 * initiated until the group has regained its capacity: for blocking
+	 * restarts that is when the first spawn burst after the restart is done.
+	 * `restartStats` describes the restart in progress, if `startTime != 0`.
+	 */
+	struct RestartStats {
+		MonotonicTimeUsec startTime;
+		MonotonicTimeUsec duration;
+		unsigned int processesReplaced;
+		/** The largest size that `getWaitlist` reached during the restart. */
+		unsigned int maxGetWaitlistSize;
+		/** The longest time that `getWaitlist` stayed non-empty during the restart. */
+		MonotonicTimeUsec maxGetWaitlistDrainTime;
+		bool blueGreen;
+		/** False if the restart failed or was superseded by another restart. */
+		bool completed;
+
+		RestartStats()
+			: startTime(0),
+			  duration(0),
+			  processesReplaced(0),
+			  maxGetWaitlistSize(0),
+			  maxGetWaitlistDrainTime(0),
+			  blueGreen(false),
+			  completed(false)
+			{ }
+	};
+	RestartStats restartStats;
+	RestartStats lastRestartStats;
+
+	/**
+	 * Only used if `options.autoscale` is set. The autoscaler is sampled by
+	 * the pool's garbage collector, which sets `autoscalerMinProcesses` to
+	 * the number of processes that the autoscaler expects to be needed.
+	 * This raises the lower process limit, so that the normal spawning
+	 * logic spawns processes ahead of the traffic.
+	 */
+	Autoscaler autoscaler;
+	unsigned int autoscalerMinProcesses;
+
 	string restartFile;
 	string alwaysRestartFile;
 	ProcessPtr nullProcess;
@@ -207,6 +281,8 @@ public:
 	static void _onSessionClose(Session *session);
 	OXT_FORCE_INLINE void onSessionInitiateFailure(Process *process, Session *session);
 	OXT_FORCE_INLINE void onSessionClose(Process *process, Session *session);
+	void processSessionClose(Process *process, Socket *socket,
+		boost::container::vector<Callback> &postLockActions);
 
 	/****** Spawning and restarting ******/
 
@@ -214,9 +290,23 @@ public:
 		unsigned int restartsInitiated);
 	void spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner, const Options &options,
 		unsigned int restartsInitiated);
+	void startSpawnThread();
+	unsigned int getSpawnConcurrency() const;
+	unsigned int processesBeingSpawnedForCapacity() const;
+	bool shouldSpawnConcurrently() const;
+	void spawnConcurrently();
+	void startSpawnBurst();
+	void finishSpawnBurst();
 	void finalizeRestart(GroupPtr self, Options oldOptions, Options newOptions,
 		RestartMethod method, SpawningKit::FactoryPtr spawningKitFactory,
 		unsigned int restartsInitiated, boost::container::vector<Callback> postLockActions);
+	void blueGreenRestart(GroupPtr self, SpawningKit::SpawnerPtr newSpawner,
+		Options newOptions, unsigned int restartsInitiated,
+		vector<ProcessPtr> oldProcesses);
+	ProcessPtr findProcessToRetire(const vector<ProcessPtr> &oldProcesses) const;
+	void warmUpProcess(const ProcessPtr &process, const Options &options);
+	void startRestartStats(bool blueGreen);
+	void finishRestartStats(bool completed);
 
 	/****** Process list management ******/
 
@@ -259,6 +349,8 @@ public:
 	void runAttachHooks(const ProcessPtr process) const;
 	void runDetachHooks(const ProcessPtr process) const;
 	void setupAttachOrDetachHook(const ProcessPtr process, HookScriptOptions &options) const;
+	void sendSessionProtocolRequest(int fd, const StaticString *params,
+		unsigned int nparams, unsigned long long *timeout);
 
 	unsigned int generateStickySessionId();
 	ProcessPtr createProcessObject(const Json::Value &json);
@@ -269,7 +361,6 @@ public:
 	Group *findOtherGroupWaitingForCapacity() const;
 	bool pushGetWaiter(const Options &newOptions, const GetCallback &callback,
 		boost::container::vector<Callback> &postLockActions);
-	template<typename Lock> void assignSessionsToGetWaitersQuickly(Lock &lock);
 	void assignSessionsToGetWaiters(boost::container::vector<Callback> &postLockActions);
 	bool testOverflowRequestQueue() const;
 	void callAbortLongRunningConnectionsCallback(const ProcessPtr &process);
@@ -360,11 +451,18 @@ public:
 	ProcessList detachedProcesses;
 
 	/**
-	 * A cache of the processes' busyness. It's in a compact structure
-	 * so that `findProcessWithLowestBusyness()` can work very quickly
-	 * when there are a large number of processes.
+	 * A cache of the enabled processes' busyness, indexed by their position
+	 * in `enabledProcesses`. It's a min-heap so that
+	 * `findEnabledProcessWithLowestBusyness()` takes constant time, and
+	 * updating a process's busyness takes logarithmic time, even when
+	 * there are a large number of processes.
+	 *
+	 * Invariant:
+	 *    enabledProcessBusynessLevels.size() == enabledCount
+	 *    for all 0 <= i < enabledCount:
+	 *       enabledProcessBusynessLevels[i] == enabledProcesses[i]->busyness()
 	 */
-	boost::container::vector<int> enabledProcessBusynessLevels;
+	BusynessIndex enabledProcessBusynessLevels;
 
 	/**
 	 * get() requests for this group that cannot be immediately satisfied are
@@ -413,6 +511,14 @@ public:
 	 *    (lifeStatus == ALIVE) == (spawner != NULL)
 	 */
 	SpawningKit::SpawnerPtr spawner;
+	/**
+	 * The spawner and options of the new generation, while a blue/green
+	 * restart is in progress. Spawner threads that are started during the
+	 * restart use these, so that the group only grows with new processes.
+	 * Only set while `m_blueGreenRestarting`.
+	 */
+	SpawningKit::SpawnerPtr blueGreenSpawner;
+	Options blueGreenOptions;
 
 
 	/****** Initialization and shutdown ******/
@@ -446,6 +552,7 @@ public:
 
 	void restart(const Options &options, RestartMethod method = RM_DEFAULT);
 	bool restarting() const;
+	bool blueGreenRestarting() const;
 	bool needsRestart(const Options &options);
 
 	SpawnResult spawn();
@@ -458,6 +565,8 @@ public:
 
 	AttachResult attach(const ProcessPtr &process,
 		boost::container::vector<Callback> &postLockActions);
+	void attachWithoutCapacityChecks(const ProcessPtr &process,
+		boost::container::vector<Callback> &postLockActions);
 	void detach(const ProcessPtr &process,
 		boost::container::vector<Callback> &postLockActions);
 	void detachAll(boost::container::vector<Callback> &postLockActions);
@@ -477,8 +586,6 @@ public:
 	bool isWaitingForCapacity() const;
 	bool garbageCollectable(unsigned long long now = 0) const;
 
-	void inspectXml(std::ostream &stream, bool includeSecrets = true) const;
-
 	/****** Out-of-band work ******/
 
 	void requestOOBW(const ProcessPtr &process);
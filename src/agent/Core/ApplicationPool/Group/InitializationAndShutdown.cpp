@@ -114,6 +114,15 @@ Group::Group(Pool *_pool, const Options &_options)
 	processesBeingSpawned = 0;
 	m_spawning     = false;
 	m_restarting   = false;
+	m_blueGreenRestarting = false;
+	autoscalerMinProcesses = 0;
+	totalProcessesSpawned = 0;
+	spawnBurstStartTime = 0;
+	spawnBurstProcessesSpawned = 0;
+	lastSpawnBurstDuration = 0;
+	lastSpawnBurstProcessesSpawned = 0;
+	getWaitlistNonEmptySince = 0;
+	lastGetWaitlistDrainTime = 0;
 	lifeStatus.store(ALIVE, boost::memory_order_relaxed);
 	lastRestartFileMtime = 0;
 	lastRestartFileCheckTime = 0;
@@ -181,6 +190,7 @@ Group::shutdown(const Callback &callback,
 	interruptableThreads.interrupt_all();
 	postLockActions.push_back(boost::bind(doCleanupSpawner, spawner));
 	spawner.reset();
+	blueGreenSpawner.reset();
 	selfPointer = shared_from_this();
 	assert(disableWaitlist.empty());
 	lifeStatus.store(SHUTTING_DOWN, boost::memory_order_seq_cst);
@@ -24,6 +24,7 @@
  *  THE SOFTWARE.
  */
 #include <Core/ApplicationPool/Group.h>
+#include <MessageReadersWriters.h>
 
 /*************************************************************************
  *
@@ -86,6 +87,12 @@ void
 Group::mergeOptions(const Options &other) {
 	options.maxRequests      = other.maxRequests;
 	options.minProcesses     = other.minProcesses;
+	options.autoscale        = other.autoscale;
+	if (!options.autoscale) {
+		autoscalerMinProcesses = 0;
+	}
+	options.spawnConcurrency = other.spawnConcurrency;
+	options.blueGreenRestart = other.blueGreenRestart;
 	options.statThrottleRate = other.statThrottleRate;
 	options.maxPreloaderIdleTime = other.maxPreloaderIdleTime;
 }
@@ -129,6 +136,36 @@ Group::setupAttachOrDetachHook(const ProcessPtr process, HookScriptOptions &opti
 	options.environment.push_back(make_pair("PASSENGER_APP_ROOT", this->options.appRoot));
 }
 
+/**
+ * Sends a request to an application process using the "session" protocol, in
+ * the same format as Core::Controller does. `params` contains alternating CGI
+ * parameter names and values, each including its terminating NUL byte. The
+ * connect password is appended automatically.
+ */
+void
+Group::sendSessionProtocolRequest(int fd, const StaticString *params,
+	unsigned int nparams, unsigned long long *timeout)
+{
+	char sizeField[sizeof(boost::uint32_t)];
+	SmallVector<StaticString, 24> data;
+
+	data.push_back(StaticString(sizeField, sizeof(boost::uint32_t)));
+	for (unsigned int i = 0; i < nparams; i++) {
+		data.push_back(params[i]);
+	}
+	data.push_back(P_STATIC_STRING_WITH_NULL("PASSENGER_CONNECT_PASSWORD"));
+	data.push_back(getApiKey().toStaticString());
+	data.push_back(StaticString("", 1));
+
+	boost::uint32_t dataSize = 0;
+	for (unsigned int i = 1; i < data.size(); i++) {
+		dataSize += (boost::uint32_t) data[i].size();
+	}
+	Uint32Message::generate(sizeField, dataSize);
+
+	gatheredWrite(fd, &data[0], data.size(), timeout);
+}
+
 unsigned int
 Group::generateStickySessionId() {
 	unsigned int result;
@@ -222,9 +259,18 @@ Group::pushGetWaiter(const Options &newOptions, const GetCallback &callback,
 		&& (newOptions.maxRequestQueueSize == 0
 		    || getWaitlist.size() < newOptions.maxRequestQueueSize)))
 	{
+		MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+		if (getWaitlist.empty()) {
+			getWaitlistNonEmptySince = now;
+		}
 		getWaitlist.push_back(GetWaiter(
 			newOptions.copyAndPersist().detachFromUnionStationTransaction(),
 			callback));
+		getWaitlist.back().enqueueTime = now;
+		if (restartStats.startTime != 0) {
+			restartStats.maxGetWaitlistSize = std::max<unsigned int>(
+				restartStats.maxGetWaitlistSize, getWaitlist.size());
+		}
 		return true;
 	} else {
 		postLockActions.push_back(boost::bind(GetCallback::call,
@@ -240,55 +286,23 @@ Group::pushGetWaiter(const Options &newOptions, const GetCallback &callback,
 	}
 }
 
-template<typename Lock>
-void
-Group::assignSessionsToGetWaitersQuickly(Lock &lock) {
-	if (getWaitlist.empty()) {
-		verifyInvariants();
-		lock.unlock();
-		return;
-	}
-
-	SmallVector<GetAction, 8> actions;
-	unsigned int i = 0;
-	bool done = false;
-
-	actions.reserve(getWaitlist.size());
-
-	while (!done && i < getWaitlist.size()) {
-		const GetWaiter &waiter = getWaitlist[i];
-		RouteResult result = route(waiter.options);
-		if (result.process != NULL) {
-			GetAction action;
-			action.callback = waiter.callback;
-			action.session  = newSession(result.process);
-			getWaitlist.erase(getWaitlist.begin() + i);
-			actions.push_back(action);
-		} else {
-			done = result.finished;
-			if (!result.finished) {
-				i++;
-			}
-		}
-	}
-
-	verifyInvariants();
-	lock.unlock();
-	SmallVector<GetAction, 50>::const_iterator it, end = actions.end();
-	for (it = actions.begin(); it != end; it++) {
-		it->callback(it->session, ExceptionPtr());
-	}
-}
-
 void
 Group::assignSessionsToGetWaiters(boost::container::vector<Callback> &postLockActions) {
 	unsigned int i = 0;
 	bool done = false;
+	bool hadWaiters = !getWaitlist.empty();
+	MonotonicTimeUsec now = 0;
 
 	while (!done && i < getWaitlist.size()) {
 		const GetWaiter &waiter = getWaitlist[i];
 		RouteResult result = route(waiter.options);
 		if (result.process != NULL) {
+			if (options.autoscale && waiter.enqueueTime != 0) {
+				if (now == 0) {
+					now = SystemTime::getMonotonicUsec();
+				}
+				autoscaler.recordQueueTime(now - waiter.enqueueTime);
+			}
 			postLockActions.push_back(boost::bind(
 				GetCallback::call,
 				waiter.callback,
@@ -302,6 +316,15 @@ Group::assignSessionsToGetWaiters(boost::container::vector<Callback> &postLockAc
 			}
 		}
 	}
+
+	if (hadWaiters && getWaitlist.empty() && getWaitlistNonEmptySince != 0) {
+		lastGetWaitlistDrainTime = SystemTime::getMonotonicUsec() - getWaitlistNonEmptySince;
+		getWaitlistNonEmptySince = 0;
+		if (restartStats.startTime != 0) {
+			restartStats.maxGetWaitlistDrainTime = std::max(
+				restartStats.maxGetWaitlistDrainTime, lastGetWaitlistDrainTime);
+		}
+	}
 }
 
 bool
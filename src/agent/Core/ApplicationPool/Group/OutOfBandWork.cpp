@@ -24,7 +24,6 @@
  *  THE SOFTWARE.
  */
 #include <Core/ApplicationPool/Group.h>
-#include <MessageReadersWriters.h>
 
 /*************************************************************************
  *
@@ -89,6 +88,7 @@ Group::lockAndMaybeInitiateOobw(const ProcessPtr &process, DisableResult result,
 	// Standard resource management boilerplate stuff...
 	Pool *pool = getPool();
 	boost::unique_lock<boost::mutex> lock(pool->syncher);
+	pool->stateChanged();
 	if (OXT_UNLIKELY(!process->isAlive() || !isAlive())) {
 		return;
 	}
@@ -190,6 +190,7 @@ Group::spawnThreadOOBWRequest(GroupPtr self, ProcessPtr process) {
 	{
 		// Standard resource management boilerplate stuff...
 		boost::unique_lock<boost::mutex> lock(pool->syncher);
+		pool->stateChanged();
 		if (OXT_UNLIKELY(!process->isAlive()
 			|| process->enabled == Process::DETACHED
 			|| !isAlive()))
@@ -225,26 +226,12 @@ Group::spawnThreadOOBWRequest(GroupPtr self, ProcessPtr process) {
 		connection.fail = true;
 		ScopeGuard guard(boost::bind(&Socket::checkinConnection, socket, connection));
 
-		// This is copied from Core::Controller when it is sending data using the
-		// "session" protocol.
-		char sizeField[sizeof(boost::uint32_t)];
-		SmallVector<StaticString, 10> data;
-
-		data.push_back(StaticString(sizeField, sizeof(boost::uint32_t)));
-		data.push_back(P_STATIC_STRING_WITH_NULL("REQUEST_METHOD"));
-		data.push_back(P_STATIC_STRING_WITH_NULL("OOBW"));
-
-		data.push_back(P_STATIC_STRING_WITH_NULL("PASSENGER_CONNECT_PASSWORD"));
-		data.push_back(getApiKey().toStaticString());
-		data.push_back(StaticString("", 1));
-
-		boost::uint32_t dataSize = 0;
-		for (unsigned int i = 1; i < data.size(); i++) {
-			dataSize += (boost::uint32_t) data[i].size();
-		}
-		Uint32Message::generate(sizeField, dataSize);
-
-		gatheredWrite(connection.fd, &data[0], data.size(), &timeout);
+		StaticString params[] = {
+			P_STATIC_STRING_WITH_NULL("REQUEST_METHOD"),
+			P_STATIC_STRING_WITH_NULL("OOBW")
+		};
+		sendSessionProtocolRequest(connection.fd, params,
+			sizeof(params) / sizeof(StaticString), &timeout);
 
 		// We do not care what the actual response is ... just wait for it.
 		UPDATE_TRACE_POINT();
@@ -261,6 +248,7 @@ Group::spawnThreadOOBWRequest(GroupPtr self, ProcessPtr process) {
 		// Standard resource management boilerplate stuff...
 		Pool *pool = getPool();
 		boost::unique_lock<boost::mutex> lock(pool->syncher);
+		pool->stateChanged();
 		if (OXT_UNLIKELY(!process->isAlive() || !isAlive())) {
 			return;
 		}
@@ -59,25 +59,11 @@ Group::findProcessWithStickySessionId(unsigned int id) const {
 
 Process *
 Group::findProcessWithStickySessionIdOrLowestBusyness(unsigned int id) const {
-	int leastBusyProcessIndex = -1;
-	int lowestBusyness = 0;
-	unsigned int i, size = enabledProcessBusynessLevels.size();
-	const int *enabledProcessBusynessLevels = &this->enabledProcessBusynessLevels[0];
-
-	for (i = 0; i < size; i++) {
-		Process *process = enabledProcesses[i].get();
-		if (process->getStickySessionId() == id) {
-			return process;
-		} else if (leastBusyProcessIndex == -1 || enabledProcessBusynessLevels[i] < lowestBusyness) {
-			leastBusyProcessIndex = i;
-			lowestBusyness = enabledProcessBusynessLevels[i];
-		}
-	}
-
-	if (leastBusyProcessIndex == -1) {
-		return NULL;
+	Process *process = findProcessWithStickySessionId(id);
+	if (process != NULL) {
+		return process;
 	} else {
-		return enabledProcesses[leastBusyProcessIndex].get();
+		return findEnabledProcessWithLowestBusyness();
 	}
 }
 
@@ -103,26 +89,16 @@ Group::findProcessWithLowestBusyness(const ProcessList &processes) const {
 }
 
 /**
- * Cache-optimized version of findProcessWithLowestBusyness() for the common case.
+ * Fast version of findProcessWithLowestBusyness() for the common case.
+ * Runs in constant time thanks to `enabledProcessBusynessLevels`.
  */
 Process *
 Group::findEnabledProcessWithLowestBusyness() const {
 	if (enabledProcesses.empty()) {
 		return NULL;
+	} else {
+		return enabledProcesses[enabledProcessBusynessLevels.lowest()].get();
 	}
-
-	int leastBusyProcessIndex = -1;
-	int lowestBusyness = 0;
-	unsigned int i, size = enabledProcessBusynessLevels.size();
-	const int *enabledProcessBusynessLevels = &this->enabledProcessBusynessLevels[0];
-
-	for (i = 0; i < size; i++) {
-		if (leastBusyProcessIndex == -1 || enabledProcessBusynessLevels[i] < lowestBusyness) {
-			leastBusyProcessIndex = i;
-			lowestBusyness = enabledProcessBusynessLevels[i];
-		}
-	}
-	return enabledProcesses[leastBusyProcessIndex].get();
 }
 
 /**
@@ -133,6 +109,7 @@ Group::findEnabledProcessWithLowestBusyness() const {
  */
 void
 Group::addProcessToList(const ProcessPtr &process, ProcessList &destination) {
+	getPool()->stateChanged();
 	destination.push_back(process);
 	process->setIndex(destination.size() - 1);
 	if (&destination == &enabledProcesses) {
@@ -173,6 +150,7 @@ void
 Group::removeProcessFromList(const ProcessPtr &process, ProcessList &source) {
 	ProcessPtr p = process; // Keep an extra reference count just in case.
 
+	getPool()->stateChanged();
 	source.erase(source.begin() + process->getIndex());
 	process->setIndex(-1);
 
@@ -210,7 +188,7 @@ Group::removeProcessFromList(const ProcessPtr &process, ProcessList &source) {
 	// Rebuild enabledProcessBusynessLevels
 	if (&source == &enabledProcesses) {
 		enabledProcessBusynessLevels.clear();
-		for (it = source.begin(); it != end; it++, i++) {
+		for (it = source.begin(); it != end; it++) {
 			const ProcessPtr &process = *it;
 			enabledProcessBusynessLevels.push_back(process->busyness());
 		}
@@ -328,6 +306,7 @@ Group::detachedProcessesCheckerMain(GroupPtr self) {
 							" has 0 active sessions now. Triggering shutdown.");
 						process->triggerShutdown();
 						assert(process->getLifeStatus() == Process::SHUTDOWN_TRIGGERED);
+						pool->stateChanged();
 					}
 					break;
 				case Process::SHUTDOWN_TRIGGERED:
@@ -417,6 +396,24 @@ Group::attach(const ProcessPtr &process,
 		return AR_ANOTHER_GROUP_IS_WAITING_FOR_CAPACITY;
 	}
 
+	attachWithoutCapacityChecks(process, postLockActions);
+	return AR_OK;
+}
+
+/**
+ * Attaches the given process to this Group without checking the group and pool
+ * capacity limits. Only use this if the caller has already made room for the
+ * process, e.g. by detaching the process that it replaces.
+ */
+void
+Group::attachWithoutCapacityChecks(const ProcessPtr &process,
+	boost::container::vector<Callback> &postLockActions)
+{
+	TRACE_POINT();
+	assert(process->getGroup() == NULL || process->getGroup() == this);
+	assert(process->isAlive());
+	assert(isAlive());
+
 	process->initializeStickySessionId(generateStickySessionId());
 	if (options.forceMaxConcurrentRequestsPerProcess != -1) {
 		process->forceMaxConcurrency(options.forceMaxConcurrentRequestsPerProcess);
@@ -457,8 +454,6 @@ Group::attach(const ProcessPtr &process,
 	wakeUpGarbageCollector();
 
 	postLockActions.push_back(boost::bind(&Group::runAttachHooks, this, process));
-
-	return AR_OK;
 }
 
 /**
@@ -94,7 +94,7 @@ Group::newSession(Process *process, unsigned long long now) {
 	session->onInitiateFailure = _onSessionInitiateFailure;
 	session->onClose   = _onSessionClose;
 	if (process->enabled == Process::ENABLED) {
-		enabledProcessBusynessLevels[process->getIndex()] = process->busyness();
+		enabledProcessBusynessLevels.update(process->getIndex(), process->busyness());
 		if (!wasTotallyBusy && process->isTotallyBusy()) {
 			nEnabledProcessesTotallyBusy++;
 		}
@@ -123,7 +123,7 @@ Group::onSessionInitiateFailure(Process *process, Session *session) {
 	TRACE_POINT();
 	// Standard resource management boilerplate stuff...
 	Pool *pool = getPool();
-	boost::unique_lock<boost::mutex> lock(pool->syncher);
+	Pool::RequestPathLock lock(pool);
 	assert(process->isAlive());
 	assert(isAlive() || getLifeStatus() == SHUTTING_DOWN);
 
@@ -134,16 +134,42 @@ Group::onSessionInitiateFailure(Process *process, Session *session) {
 		P_DEBUG("Process was already detached");
 	}
 	pool->fullVerifyInvariants();
-	lock.unlock();
+	lock.unlock(actions);
 	runAllActions(actions);
 }
 
 OXT_FORCE_INLINE void
 Group::onSessionClose(Process *process, Session *session) {
 	TRACE_POINT();
-	// Standard resource management boilerplate stuff...
 	Pool *pool = getPool();
-	boost::unique_lock<boost::mutex> lock(pool->syncher);
+	Socket *socket = session->getSocket();
+	Pool::RequestPathLock lock(pool, false);
+
+	if (!lock.lockOrDeferSessionClose(process, socket)) {
+		// Another thread holds the pool lock on behalf of a request
+		// and will process this session close before releasing it.
+		return;
+	}
+
+	UPDATE_TRACE_POINT();
+	boost::container::vector<Callback> actions;
+	processSessionClose(process, socket, actions);
+	lock.unlock(actions);
+	runAllActions(actions);
+}
+
+/*
+ * Updates the statistics and process lists after a session on `process` has
+ * been closed. Must be called with the pool lock held, either directly from
+ * onSessionClose() or by the RequestPathLock that the session close was
+ * handed over to.
+ */
+void
+Group::processSessionClose(Process *process, Socket *socket,
+	boost::container::vector<Callback> &postLockActions)
+{
+	TRACE_POINT();
+	Pool *pool = getPool();
 	assert(process->isAlive());
 	assert(isAlive() || getLifeStatus() == SHUTTING_DOWN);
 
@@ -153,13 +179,13 @@ Group::onSessionClose(Process *process, Session *session) {
 
 	/* Update statistics. */
 	bool wasTotallyBusy = process->isTotallyBusy();
-	process->sessionClosed(session);
+	process->sessionClosed(socket);
 	assert(process->getLifeStatus() == Process::ALIVE);
 	assert(process->enabled == Process::ENABLED
 		|| process->enabled == Process::DISABLING
 		|| process->enabled == Process::DETACHED);
 	if (process->enabled == Process::ENABLED) {
-		enabledProcessBusynessLevels[process->getIndex()] = process->busyness();
+		enabledProcessBusynessLevels.update(process->getIndex(), process->busyness());
 		if (wasTotallyBusy) {
 			assert(nEnabledProcessesTotallyBusy >= 1);
 			nEnabledProcessesTotallyBusy--;
@@ -194,7 +220,6 @@ Group::onSessionClose(Process *process, Session *session) {
 
 	if (shouldDetach || shouldDisable) {
 		UPDATE_TRACE_POINT();
-		boost::container::vector<Callback> actions;
 
 		if (shouldDetach) {
 			if (detachingBecauseCapacityNeeded) {
@@ -214,18 +239,16 @@ Group::onSessionClose(Process *process, Session *session) {
 					" has reached its maximum number of requests (" <<
 					options.maxRequests << "); detaching it");
 			}
-			pool->detachProcessUnlocked(process->shared_from_this(), actions);
+			pool->detachProcessUnlocked(process->shared_from_this(), postLockActions);
 		} else {
 			ProcessPtr processPtr = process->shared_from_this();
 			removeProcessFromList(processPtr, disablingProcesses);
 			addProcessToList(processPtr, disabledProcesses);
-			removeFromDisableWaitlist(processPtr, DR_SUCCESS, actions);
+			removeFromDisableWaitlist(processPtr, DR_SUCCESS, postLockActions);
 			maybeInitiateOobw(process);
 		}
 
 		pool->fullVerifyInvariants();
-		lock.unlock();
-		runAllActions(actions);
 
 	} else {
 		UPDATE_TRACE_POINT();
@@ -238,9 +261,9 @@ Group::onSessionClose(Process *process, Session *session) {
 			 * become available then call them now.
 			 */
 			UPDATE_TRACE_POINT();
-			// Already calls verifyInvariants().
-			assignSessionsToGetWaitersQuickly(lock);
+			assignSessionsToGetWaiters(postLockActions);
 		}
+		verifyInvariants();
 	}
 }
 
@@ -288,6 +311,10 @@ Group::get(const Options &newOptions, const GetCallback &callback,
 		return nullProcess->createSessionObject((Socket *) NULL);
 	}
 
+	if (options.autoscale) {
+		autoscaler.recordArrival();
+	}
+
 	if (OXT_UNLIKELY(enabledCount == 0)) {
 		/* We don't have any processes yet, but they're on the way.
 		 *
@@ -91,6 +91,7 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 
 		ProcessPtr process;
 		ExceptionPtr exception;
+		MonotonicTimeUsec spawnBeginTime = SystemTime::getMonotonicUsec();
 		try {
 			UPDATE_TRACE_POINT();
 			boost::this_thread::restore_interruption ri(di);
@@ -109,10 +110,12 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 			// Let other (unexpected) exceptions crash the program so
 			// gdb can generate a backtrace.
 		}
+		spawnDurations.record(SystemTime::getMonotonicUsec() - spawnBeginTime);
 
 		UPDATE_TRACE_POINT();
 		ScopeGuard guard(boost::bind(Process::forceTriggerShutdownAndCleanup, process));
 		boost::unique_lock<boost::mutex> lock(pool->syncher);
+		pool->stateChanged();
 
 		if (!isAlive()) {
 			if (process != NULL) {
@@ -145,7 +148,6 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 		assert(processesBeingSpawned > 0);
 
 		processesBeingSpawned--;
-		assert(processesBeingSpawned == 0);
 
 		UPDATE_TRACE_POINT();
 		boost::container::vector<Callback> actions;
@@ -153,6 +155,8 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 			AttachResult result = attach(process, actions);
 			if (result == AR_OK) {
 				guard.clear();
+				totalProcessesSpawned++;
+				spawnBurstProcessesSpawned++;
 				if (getWaitlist.empty()) {
 					pool->assignSessionsToGetWaiters(actions);
 				} else {
@@ -174,6 +178,7 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 				enableAllDisablingProcesses(actions);
 			}
 			Pool::assignExceptionToGetWaiters(getWaitlist, exception, actions);
+			getWaitlistNonEmptySince = 0;
 			pool->assignSessionsToGetWaiters(actions);
 			done = true;
 		}
@@ -182,12 +187,17 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 			|| (processLowerLimitsSatisfied() && getWaitlist.empty())
 			|| processUpperLimitsReached()
 			|| pool->atFullCapacityUnlocked();
-		m_spawning = !done;
 		if (done) {
 			P_DEBUG("Spawn loop done");
 		} else {
 			processesBeingSpawned++;
 			P_DEBUG("Continue spawning");
+			spawnConcurrently();
+		}
+		// Other spawner threads may still be at work.
+		m_spawning = processesBeingSpawned > 0;
+		if (!m_spawning) {
+			finishSpawnBurst();
 		}
 
 		UPDATE_TRACE_POINT();
@@ -203,6 +213,110 @@ Group::spawnThreadRealMain(const SpawningKit::SpawnerPtr &spawner,
 	}
 }
 
+void
+Group::startSpawnThread() {
+	if (m_blueGreenRestarting) {
+		// Don't add processes of the generation that is being replaced.
+		interruptableThreads.create_thread(
+			boost::bind(&Group::spawnThreadMain,
+				this, shared_from_this(), blueGreenSpawner,
+				blueGreenOptions, restartsInitiated),
+			"Group process spawner: " + info.name,
+			POOL_HELPER_THREAD_STACK_SIZE);
+	} else {
+		interruptableThreads.create_thread(
+			boost::bind(&Group::spawnThreadMain,
+				this, shared_from_this(), spawner,
+				options.copyAndPersist().clearPerRequestFields(),
+				restartsInitiated),
+			"Group process spawner: " + info.name,
+			POOL_HELPER_THREAD_STACK_SIZE);
+	}
+	m_spawning = true;
+	processesBeingSpawned++;
+}
+
+unsigned int
+Group::getSpawnConcurrency() const {
+	return std::max(options.spawnConcurrency, 1u);
+}
+
+/**
+ * The number of processes that are being spawned in order to add capacity.
+ * The process that a blue/green restarter thread is spawning doesn't count,
+ * because it replaces an old process.
+ */
+unsigned int
+Group::processesBeingSpawnedForCapacity() const {
+	if (m_blueGreenRestarting) {
+		assert(processesBeingSpawned > 0);
+		return processesBeingSpawned - 1;
+	} else {
+		return processesBeingSpawned;
+	}
+}
+
+/**
+ * Whether another spawner thread should be started, in addition to the
+ * ones that are already at work. This is the case when the group needs
+ * more processes than are already being spawned, in order to satisfy the
+ * lower process limits or to serve the get waiters. This also applies
+ * during a blue/green restart, so that the group can grow under load
+ * before all old processes have been replaced.
+ */
+bool
+Group::shouldSpawnConcurrently() const {
+	return m_spawning
+		&& processesBeingSpawnedForCapacity() < getSpawnConcurrency()
+		&& (!processLowerLimitsSatisfied()
+			|| getWaitlist.size() > processesBeingSpawnedForCapacity())
+		&& !processUpperLimitsReached()
+		&& !poolAtFullCapacity()
+		&& getPool()->processesBeingSpawnedUnlocked() < getPool()->maxConcurrentSpawns;
+}
+
+void
+Group::spawnConcurrently() {
+	while (shouldSpawnConcurrently()) {
+		P_DEBUG("Spawning another process for group " << info.name <<
+			" concurrently (" << processesBeingSpawned << " already in progress)");
+		startSpawnThread();
+	}
+}
+
+void
+Group::startSpawnBurst() {
+	spawnBurstStartTime = SystemTime::getMonotonicUsec();
+	spawnBurstProcessesSpawned = 0;
+}
+
+void
+Group::finishSpawnBurst() {
+	lastSpawnBurstDuration = SystemTime::getMonotonicUsec() - spawnBurstStartTime;
+	lastSpawnBurstProcessesSpawned = spawnBurstProcessesSpawned;
+	if (restartStats.startTime != 0 && !m_restarting && !m_blueGreenRestarting) {
+		// This was the spawn burst that followed a blocking restart.
+		finishRestartStats(true);
+	}
+}
+
+void
+Group::startRestartStats(bool blueGreen) {
+	restartStats = RestartStats();
+	restartStats.startTime = SystemTime::getMonotonicUsec();
+	restartStats.maxGetWaitlistSize = getWaitlist.size();
+	restartStats.blueGreen = blueGreen;
+}
+
+void
+Group::finishRestartStats(bool completed) {
+	assert(restartStats.startTime != 0);
+	restartStats.duration = SystemTime::getMonotonicUsec() - restartStats.startTime;
+	restartStats.completed = completed;
+	lastRestartStats = restartStats;
+	restartStats = RestartStats();
+}
+
 // The 'self' parameter is for keeping the current Group object alive while this thread is running.
 void
 Group::finalizeRestart(GroupPtr self,
@@ -239,6 +353,7 @@ Group::finalizeRestart(GroupPtr self,
 	}
 
 	ScopedLock l(pool->syncher);
+	pool->stateChanged();
 	if (!isAlive()) {
 		P_DEBUG("Group " << getName() << " is shutting down, so aborting restart");
 		return;
@@ -276,6 +391,9 @@ Group::finalizeRestart(GroupPtr self,
 				"for shutdown. Will try again later.");
 		}
 	}
+	if (!m_spawning && restartStats.startTime != 0) {
+		finishRestartStats(true);
+	}
 	verifyInvariants();
 
 	l.unlock();
@@ -287,6 +405,265 @@ Group::finalizeRestart(GroupPtr self,
 	}
 }
 
+// The 'self' parameter is for keeping the current Group object alive while this thread is running.
+void
+Group::blueGreenRestart(GroupPtr self, SpawningKit::SpawnerPtr newSpawner,
+	Options newOptions, unsigned int restartsInitiated,
+	vector<ProcessPtr> oldProcesses)
+{
+	TRACE_POINT();
+	boost::this_thread::disable_interruption di;
+	boost::this_thread::disable_syscall_interruption dsi;
+
+	Pool *pool = getPool();
+
+	bool done = false;
+	while (!done) {
+		ProcessPtr process;
+		ExceptionPtr exception;
+		MonotonicTimeUsec spawnBeginTime = 0;
+		try {
+			UPDATE_TRACE_POINT();
+			boost::this_thread::restore_interruption ri(di);
+			boost::this_thread::restore_syscall_interruption rsi(dsi);
+			spawnBeginTime = SystemTime::getMonotonicUsec();
+			process = createProcessObject(newSpawner->spawn(newOptions));
+			spawnDurations.record(SystemTime::getMonotonicUsec() - spawnBeginTime);
+			if (!newOptions.restartWarmupPath.empty()) {
+				warmUpProcess(process, newOptions);
+			}
+		} catch (const thread_interrupted &) {
+			break;
+		} catch (const tracable_exception &e) {
+			if (spawnBeginTime != 0 && process == NULL) {
+				spawnDurations.record(SystemTime::getMonotonicUsec() - spawnBeginTime);
+			}
+			exception = copyException(e);
+		}
+
+		UPDATE_TRACE_POINT();
+		ScopeGuard guard(boost::bind(Process::forceTriggerShutdownAndCleanup, process));
+		boost::container::vector<Callback> actions;
+		SpawningKit::SpawnerPtr spawnerToDestroy;
+		boost::unique_lock<boost::mutex> lock(pool->syncher);
+		pool->stateChanged();
+
+		if (!isAlive()) {
+			P_DEBUG("Group " << getName() << " is shutting down, so aborting blue/green restart");
+			break;
+		} else if (restartsInitiated != this->restartsInitiated) {
+			P_DEBUG("Blue/green restart of group " << getName() <<
+				" aborted because a new restart was initiated concurrently");
+			break;
+		}
+
+		verifyInvariants();
+		assert(m_blueGreenRestarting);
+		assert(processesBeingSpawned > 0);
+
+		processesBeingSpawned--;
+
+		UPDATE_TRACE_POINT();
+		bool completed;
+		if (process != NULL) {
+			ProcessPtr oldProcess = findProcessToRetire(oldProcesses);
+			bool attached = true;
+			if (oldProcess != NULL) {
+				// The old process makes room for its replacement, so the
+				// capacity used by this group doesn't change.
+				P_DEBUG("Replacing process " << oldProcess->inspect() <<
+					" by " << process->inspect());
+				detach(oldProcess, actions);
+				attachWithoutCapacityChecks(process, actions);
+				restartStats.processesReplaced++;
+			} else if (attach(process, actions) != AR_OK) {
+				// The old processes went away by themselves in the mean time.
+				P_DEBUG("Unable to attach spawned process " << process->inspect());
+				attached = false;
+			}
+			if (attached) {
+				guard.clear();
+				totalProcessesSpawned++;
+				spawnBurstProcessesSpawned++;
+			}
+			completed = true;
+			done = findProcessToRetire(oldProcesses) == NULL;
+		} else {
+			P_ERROR("Blue/green restart of group " << getName() << " aborted "
+				"because a new process could not be spawned. The processes that "
+				"have not been replaced yet keep serving requests");
+			if (enabledCount == 0) {
+				enableAllDisablingProcesses(actions);
+			}
+			completed = false;
+			done = true;
+		}
+
+		// Bring the restart state up to date before assigning sessions to
+		// get waiters, because that may cause spawn() to be called.
+		if (done) {
+			if (completed) {
+				resetOptions(newOptions);
+				spawnerToDestroy = spawner;
+				spawner = newSpawner;
+			} else {
+				spawnerToDestroy = newSpawner;
+				// Stop the spawner threads that add processes of the new
+				// generation, which would otherwise be mixed with the old one.
+				this->restartsInitiated++;
+				processesBeingSpawned = 0;
+			}
+			newSpawner.reset();
+			blueGreenSpawner.reset();
+			m_blueGreenRestarting = false;
+			m_spawning = processesBeingSpawned > 0;
+			finishRestartStats(completed);
+			if (!m_spawning) {
+				finishSpawnBurst();
+			}
+		} else {
+			processesBeingSpawned++;
+		}
+
+		if (process != NULL) {
+			if (getWaitlist.empty()) {
+				pool->assignSessionsToGetWaiters(actions);
+			} else {
+				assignSessionsToGetWaiters(actions);
+			}
+		} else {
+			if (enabledCount == 0) {
+				Pool::assignExceptionToGetWaiters(getWaitlist, exception, actions);
+				getWaitlistNonEmptySince = 0;
+			}
+			pool->assignSessionsToGetWaiters(actions);
+		}
+
+		if (done) {
+			if (shouldSpawn()) {
+				spawn();
+			}
+			P_DEBUG("Blue/green restart of group " << getName() << " done");
+		} else {
+			P_DEBUG("Continue blue/green restart of group " << getName());
+		}
+
+		UPDATE_TRACE_POINT();
+		pool->fullVerifyInvariants();
+		lock.unlock();
+		UPDATE_TRACE_POINT();
+		spawnerToDestroy.reset();
+		runAllActions(actions);
+	}
+}
+
+/**
+ * Returns the next process from the old generation that a blue/green restart
+ * should replace, or NULL if all of them have been replaced or have gone away.
+ * Prefers disabled processes, then the least busy ones, so that as few
+ * requests as possible are still in flight on the retired processes.
+ */
+ProcessPtr
+Group::findProcessToRetire(const vector<ProcessPtr> &oldProcesses) const {
+	ProcessPtr result;
+	vector<ProcessPtr>::const_iterator it, end = oldProcesses.end();
+
+	for (it = oldProcesses.begin(); it != end; it++) {
+		const ProcessPtr &process = *it;
+		if (!process->isAlive()
+		 || process->getGroup() != this
+		 || process->enabled == Process::DETACHED)
+		{
+			continue;
+		}
+		if (process->enabled == Process::DISABLED) {
+			return process;
+		} else if (result == NULL || process->busyness() < result->busyness()) {
+			result = process;
+		}
+	}
+	return result;
+}
+
+/**
+ * Sends a GET request for `options.restartWarmupPath` to a freshly spawned
+ * process, before it is attached, and waits until the process starts
+ * responding. A process that fails the warm-up request is still used: the
+ * request only serves to load code and fill caches, and the spawner already
+ * checked that the process is healthy.
+ *
+ * The request is sent in whichever protocol the process's session socket
+ * speaks: "session" or plain HTTP ("http_session").
+ */
+void
+Group::warmUpProcess(const ProcessPtr &process, const Options &options) {
+	TRACE_POINT();
+	const StaticString &path = options.restartWarmupPath;
+	Socket *socket = process->findSessionSocketWithLowestBusyness();
+	if (socket == NULL) {
+		return;
+	}
+
+	P_DEBUG("Sending warm-up request for " << path << " to process " << process->inspect());
+	unsigned long long timeout = options.startTimeout * 1000ull;
+	try {
+		// The connection is marked as fail in order to ensure it is closed
+		// after this request, so that we don't need to read the whole response.
+		Connection connection = socket->checkoutConnection();
+		connection.fail = true;
+		ScopeGuard guard(boost::bind(&Socket::checkinConnection, socket, connection));
+
+		if (socket->protocol == "http_session") {
+			string request = "GET " + path + " HTTP/1.1\r\n"
+				"Host: localhost\r\n"
+				"Connection: close\r\n"
+				"\r\n";
+			writeExact(connection.fd, request, &timeout);
+		} else {
+			const char *pos = (const char *) memchr(path.data(), '?', path.size());
+			string pathInfo = (pos == NULL)
+				? path.toString()
+				: string(path.data(), pos - path.data());
+			string queryString = (pos == NULL)
+				? string()
+				: string(pos + 1, path.data() + path.size() - pos - 1);
+			StaticString params[] = {
+				P_STATIC_STRING_WITH_NULL("REQUEST_METHOD"),
+				P_STATIC_STRING_WITH_NULL("GET"),
+				P_STATIC_STRING_WITH_NULL("REQUEST_URI"),
+				path,
+				StaticString("", 1),
+				P_STATIC_STRING_WITH_NULL("PATH_INFO"),
+				StaticString(pathInfo.c_str(), pathInfo.size() + 1),
+				P_STATIC_STRING_WITH_NULL("QUERY_STRING"),
+				StaticString(queryString.c_str(), queryString.size() + 1),
+				P_STATIC_STRING_WITH_NULL("SCRIPT_NAME"),
+				StaticString("", 1),
+				P_STATIC_STRING_WITH_NULL("SERVER_NAME"),
+				P_STATIC_STRING_WITH_NULL("localhost"),
+				P_STATIC_STRING_WITH_NULL("SERVER_PORT"),
+				P_STATIC_STRING_WITH_NULL("80"),
+				P_STATIC_STRING_WITH_NULL("SERVER_PROTOCOL"),
+				P_STATIC_STRING_WITH_NULL("HTTP/1.1"),
+				P_STATIC_STRING_WITH_NULL("HTTP_HOST"),
+				P_STATIC_STRING_WITH_NULL("localhost")
+			};
+			sendSessionProtocolRequest(connection.fd, params,
+				sizeof(params) / sizeof(StaticString), &timeout);
+		}
+
+		// We do not care what the actual response is ... just wait for it.
+		UPDATE_TRACE_POINT();
+		waitUntilReadable(connection.fd, &timeout);
+	} catch (const SystemException &e) {
+		P_WARN("Warm-up request to process " << process->inspect() <<
+			" failed: " << e.what());
+	} catch (const TimeoutException &e) {
+		P_WARN("Warm-up request to process " << process->inspect() <<
+			" timed out: " << e.what());
+	}
+}
+
 
 /****************************
  *
@@ -298,18 +675,65 @@ Group::finalizeRestart(GroupPtr self,
 void
 Group::restart(const Options &options, RestartMethod method) {
 	boost::container::vector<Callback> actions;
+	// A blue/green restart needs old processes that can keep serving requests.
+	bool blueGreen = (method == RM_BLUE_GREEN
+		|| (method == RM_DEFAULT && options.blueGreenRestart))
+		&& getProcessCount() > 0;
 
 	assert(isAlive());
-	P_DEBUG("Restarting group " << getName());
+	P_DEBUG("Restarting group " << getName() << (blueGreen ? " (blue/green)" : ""));
 
 	// If there is currently a restarter thread or a spawner thread active,
 	// the following tells them to abort their current work as soon as possible.
 	restartsInitiated++;
 
+	if (restartStats.startTime != 0) {
+		// The restart that is in progress is superseded by this one.
+		finishRestartStats(false);
+	}
+	if (m_spawning) {
+		finishSpawnBurst();
+	}
 	processesBeingSpawned = 0;
 	m_spawning   = false;
-	m_restarting = true;
+	m_blueGreenRestarting = false;
+	blueGreenSpawner.reset();
 	uuid         = generateUuid(pool);
+	startRestartStats(blueGreen);
+
+	if (blueGreen) {
+		vector<ProcessPtr> oldProcesses;
+		oldProcesses.reserve(getProcessCount());
+		oldProcesses.insert(oldProcesses.end(), enabledProcesses.begin(),
+			enabledProcesses.end());
+		oldProcesses.insert(oldProcesses.end(), disablingProcesses.begin(),
+			disablingProcesses.end());
+		oldProcesses.insert(oldProcesses.end(), disabledProcesses.begin(),
+			disabledProcesses.end());
+
+		resetOptions(options, &blueGreenOptions);
+		blueGreenSpawner = getContext()->getSpawningKitFactory()->create(
+			blueGreenOptions);
+
+		// The restarter thread reserves capacity for one replacement
+		// process at a time.
+		m_restarting = false;
+		m_blueGreenRestarting = true;
+		m_spawning = true;
+		processesBeingSpawned = 1;
+		startSpawnBurst();
+		getPool()->interruptableThreads.create_thread(
+			boost::bind(&Group::blueGreenRestart, this, shared_from_this(),
+				blueGreenSpawner, blueGreenOptions,
+				restartsInitiated, oldProcesses),
+			"Group blue/green restarter: " + getName(),
+			POOL_HELPER_THREAD_STACK_SIZE
+		);
+		return;
+	}
+
+	m_restarting = true;
+	restartStats.processesReplaced = getProcessCount();
 	detachAll(actions);
 	getPool()->interruptableThreads.create_thread(
 		boost::bind(&Group::finalizeRestart, this, shared_from_this(),
@@ -327,9 +751,14 @@ Group::restarting() const {
 	return m_restarting;
 }
 
+bool
+Group::blueGreenRestarting() const {
+	return m_blueGreenRestarting;
+}
+
 bool
 Group::needsRestart(const Options &options) {
-	if (m_restarting) {
+	if (m_restarting || m_blueGreenRestarting) {
 		return false;
 	} else {
 		time_t now;
@@ -416,7 +845,10 @@ Group::needsRestart(const Options &options) {
 SpawnResult
 Group::spawn() {
 	assert(isAlive());
-	if (m_spawning) {
+	// A blue/green restarter thread only replaces processes, so if it's the
+	// only one at work, a spawner thread must be started to add capacity.
+	if (m_spawning && !(m_blueGreenRestarting && processesBeingSpawnedForCapacity() == 0)) {
+		spawnConcurrently();
 		return SR_IN_PROGRESS;
 	} else if (restarting()) {
 		return SR_ERR_RESTARTING;
@@ -426,15 +858,11 @@ Group::spawn() {
 		return SR_ERR_POOL_AT_FULL_CAPACITY;
 	} else {
 		P_DEBUG("Requested spawning of new process for group " << info.name);
-		interruptableThreads.create_thread(
-			boost::bind(&Group::spawnThreadMain,
-				this, shared_from_this(), spawner,
-				options.copyAndPersist().clearPerRequestFields(),
-				restartsInitiated),
-			"Group process spawner: " + info.name,
-			POOL_HELPER_THREAD_STACK_SIZE);
-		m_spawning = true;
-		processesBeingSpawned++;
+		if (!m_spawning) {
+			startSpawnBurst();
+		}
+		startSpawnThread();
+		spawnConcurrently();
 		return SR_OK;
 	}
 }
@@ -52,12 +52,14 @@ Group::getProcessCount() const {
 
 /**
  * Returns whether the lower bound of the group-specific process limits
- * have been satisfied. Note that even if the result is false, the pool limits
+ * have been satisfied. The lower bound is raised by the autoscaler when
+ * it expects more traffic. Note that even if the result is false, the pool limits
  * may not allow spawning, so you should check `pool->atFullCapacity()` too.
  */
 bool
 Group::processLowerLimitsSatisfied() const {
-	return capacityUsed() >= options.minProcesses;
+	return capacityUsed() >= std::max<unsigned int>(options.minProcesses,
+		autoscalerMinProcesses);
 }
 
 /**
@@ -115,84 +117,6 @@ Group::garbageCollectable(unsigned long long now) const {
 	return false;
 }
 
-void
-Group::inspectXml(std::ostream &stream, bool includeSecrets) const {
-	ProcessList::const_iterator it;
-
-	stream << "<name>" << escapeForXml(info.name) << "</name>";
-	stream << "<component_name>" << escapeForXml(info.name) << "</component_name>";
-	stream << "<app_root>" << escapeForXml(options.appRoot) << "</app_root>";
-	stream << "<app_type>" << escapeForXml(options.appType) << "</app_type>";
-	stream << "<environment>" << escapeForXml(options.environment) << "</environment>";
-	stream << "<uuid>" << toString(uuid) << "</uuid>";
-	stream << "<enabled_process_count>" << enabledCount << "</enabled_process_count>";
-	stream << "<disabling_process_count>" << disablingCount << "</disabling_process_count>";
-	stream << "<disabled_process_count>" << disabledCount << "</disabled_process_count>";
-	stream << "<capacity_used>" << capacityUsed() << "</capacity_used>";
-	stream << "<get_wait_list_size>" << getWaitlist.size() << "</get_wait_list_size>";
-	stream << "<disable_wait_list_size>" << disableWaitlist.size() << "</disable_wait_list_size>";
-	stream << "<processes_being_spawned>" << processesBeingSpawned << "</processes_being_spawned>";
-	if (m_spawning) {
-		stream << "<spawning/>";
-	}
-	if (restarting()) {
-		stream << "<restarting/>";
-	}
-	if (includeSecrets) {
-		stream << "<secret>" << escapeForXml(getApiKey().toStaticString()) << "</secret>";
-		stream << "<api_key>" << escapeForXml(getApiKey().toStaticString()) << "</api_key>";
-	}
-	LifeStatus lifeStatus = (LifeStatus) this->lifeStatus.load(boost::memory_order_relaxed);
-	switch (lifeStatus) {
-	case ALIVE:
-		stream << "<life_status>ALIVE</life_status>";
-		break;
-	case SHUTTING_DOWN:
-		stream << "<life_status>SHUTTING_DOWN</life_status>";
-		break;
-	case SHUT_DOWN:
-		stream << "<life_status>SHUT_DOWN</life_status>";
-		break;
-	default:
-		P_BUG("Unknown 'lifeStatus' state " << lifeStatus);
-	}
-
-	SpawningKit::UserSwitchingInfo usInfo(SpawningKit::prepareUserSwitching(options));
-	stream << "<user>" << escapeForXml(usInfo.username) << "</user>";
-	stream << "<uid>" << usInfo.uid << "</uid>";
-	stream << "<group>" << escapeForXml(usInfo.groupname) << "</group>";
-	stream << "<gid>" << usInfo.gid << "</gid>";
-
-	stream << "<options>";
-	options.toXml(stream, getResourceLocator());
-	stream << "</options>";
-
-	stream << "<processes>";
-
-	for (it = enabledProcesses.begin(); it != enabledProcesses.end(); it++) {
-		stream << "<process>";
-		(*it)->inspectXml(stream, includeSecrets);
-		stream << "</process>";
-	}
-	for (it = disablingProcesses.begin(); it != disablingProcesses.end(); it++) {
-		stream << "<process>";
-		(*it)->inspectXml(stream, includeSecrets);
-		stream << "</process>";
-	}
-	for (it = disabledProcesses.begin(); it != disabledProcesses.end(); it++) {
-		stream << "<process>";
-		(*it)->inspectXml(stream, includeSecrets);
-		stream << "</process>";
-	}
-	for (it = detachedProcesses.begin(); it != detachedProcesses.end(); it++) {
-		stream << "<process>";
-		(*it)->inspectXml(stream, includeSecrets);
-		stream << "</process>";
-	}
-
-	stream << "</processes>";
-}
-
 
 } // namespace ApplicationPool2
 } // namespace Passenger
@@ -93,6 +93,7 @@ Group::verifyInvariants() const {
 	assert((int) enabledProcesses.size() == enabledCount);
 	assert((int) disablingProcesses.size() == disablingCount);
 	assert((int) disabledProcesses.size() == disabledCount);
+	assert((int) enabledProcessBusynessLevels.size() == enabledCount);
 	assert(nEnabledProcessesTotallyBusy <= enabledCount);
 	#endif
 }
@@ -108,10 +109,12 @@ Group::verifyExpensiveInvariants() const {
 
 	ProcessList::const_iterator it, end;
 
+	assert(enabledProcessBusynessLevels.verify());
 	end = enabledProcesses.end();
 	for (it = enabledProcesses.begin(); it != end; it++) {
 		const ProcessPtr &process = *it;
 		assert(process->enabled == Process::ENABLED);
+		assert(enabledProcessBusynessLevels[process->getIndex()] == process->busyness());
 		assert(process->isAlive());
 		assert(process->oobwStatus == Process::OOBW_NOT_ACTIVE
 			|| process->oobwStatus == Process::OOBW_REQUESTED);
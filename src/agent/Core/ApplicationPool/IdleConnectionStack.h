@@ -0,0 +1,188 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_APPLICATION_POOL2_IDLE_CONNECTION_STACK_H_
+#define _PASSENGER_APPLICATION_POOL2_IDLE_CONNECTION_STACK_H_
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_array.hpp>
+#include <vector>
+#include <Utils/SystemTime.h>
+
+namespace Passenger {
+namespace ApplicationPool2 {
+
+
+/**
+ * A bounded, lock-free LIFO stack of idle items (in practice: application
+ * connections), each tagged with the time at which it became idle.
+ *
+ * All storage is preallocated: there is an array of `capacity` nodes, and
+ * every node is either on the idle stack or on the free stack. Both stacks
+ * are Treiber stacks whose heads consist of a node index plus a tag that is
+ * incremented on every update, which protects against the ABA problem.
+ * Because nodes are never deallocated while the IdleConnectionStack exists,
+ * no further memory reclamation scheme is necessary.
+ *
+ * `push()` and `pop()` are thread-safe and never block. The copy constructor
+ * and the assignment operator are not thread-safe.
+ */
+template<typename T>
+class IdleConnectionStack {
+private:
+	static const boost::uint32_t NIL = 0xFFFFFFFF;
+
+	struct Node {
+		T item;
+		MonotonicTimeUsec idleSince;
+		boost::atomic<boost::uint32_t> next;
+	};
+
+	boost::scoped_array<Node> nodes;
+	boost::uint32_t capacity;
+	boost::atomic<boost::uint64_t> idleHead;
+	boost::atomic<boost::uint64_t> freeHead;
+
+	static boost::uint64_t makeHead(boost::uint64_t oldHead, boost::uint32_t index) {
+		boost::uint64_t tag = (oldHead >> 32) + 1;
+		return (tag << 32) | index;
+	}
+
+	static boost::uint32_t headIndex(boost::uint64_t head) {
+		return (boost::uint32_t) head;
+	}
+
+	void pushNode(boost::atomic<boost::uint64_t> &head, boost::uint32_t index) {
+		boost::uint64_t oldHead = head.load(boost::memory_order_relaxed);
+		do {
+			nodes[index].next.store(headIndex(oldHead), boost::memory_order_relaxed);
+		} while (!head.compare_exchange_weak(oldHead, makeHead(oldHead, index),
+			boost::memory_order_release, boost::memory_order_relaxed));
+	}
+
+	boost::uint32_t popNode(boost::atomic<boost::uint64_t> &head) {
+		boost::uint64_t oldHead = head.load(boost::memory_order_acquire);
+		while (true) {
+			boost::uint32_t index = headIndex(oldHead);
+			if (index == NIL) {
+				return NIL;
+			}
+			// `next` may be stale if another thread popped this node in
+			// the meantime, but then the tag has changed and the CAS fails.
+			boost::uint32_t next = nodes[index].next.load(boost::memory_order_relaxed);
+			if (head.compare_exchange_weak(oldHead, makeHead(oldHead, next),
+				boost::memory_order_acquire, boost::memory_order_acquire))
+			{
+				return index;
+			}
+		}
+	}
+
+	void initialize(boost::uint32_t _capacity) {
+		capacity = _capacity;
+		nodes.reset(capacity > 0 ? new Node[capacity] : NULL);
+		idleHead.store(NIL, boost::memory_order_relaxed);
+		freeHead.store(NIL, boost::memory_order_relaxed);
+		for (boost::uint32_t i = capacity; i > 0; i--) {
+			pushNode(freeHead, i - 1);
+		}
+	}
+
+	void copyFrom(const IdleConnectionStack &other) {
+		initialize(other.capacity);
+		// Push in reverse order so that the stack order is preserved.
+		std::vector<boost::uint32_t> indices;
+		boost::uint32_t index = headIndex(other.idleHead.load(boost::memory_order_acquire));
+		while (index != NIL) {
+			indices.push_back(index);
+			index = other.nodes[index].next.load(boost::memory_order_relaxed);
+		}
+		while (!indices.empty()) {
+			const Node &node = other.nodes[indices.back()];
+			push(node.item, node.idleSince);
+			indices.pop_back();
+		}
+	}
+
+public:
+	explicit IdleConnectionStack(unsigned int capacity = 0) {
+		initialize(capacity);
+	}
+
+	IdleConnectionStack(const IdleConnectionStack &other) {
+		copyFrom(other);
+	}
+
+	IdleConnectionStack &operator=(const IdleConnectionStack &other) {
+		if (this != &other) {
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	unsigned int getCapacity() const {
+		return capacity;
+	}
+
+	/**
+	 * Pushes an item onto the stack. Returns false if the stack is full,
+	 * in which case the caller retains ownership of the item.
+	 */
+	bool push(const T &item, MonotonicTimeUsec now) {
+		boost::uint32_t index = popNode(freeHead);
+		if (index == NIL) {
+			return false;
+		}
+		nodes[index].item = item;
+		nodes[index].idleSince = now;
+		pushNode(idleHead, index);
+		return true;
+	}
+
+	/**
+	 * Pops the most recently pushed item. Returns false if the stack is empty.
+	 */
+	bool pop(T &item, MonotonicTimeUsec &idleSince) {
+		boost::uint32_t index = popNode(idleHead);
+		if (index == NIL) {
+			return false;
+		}
+		item = nodes[index].item;
+		idleSince = nodes[index].idleSince;
+		pushNode(freeHead, index);
+		return true;
+	}
+
+	bool empty() const {
+		return headIndex(idleHead.load(boost::memory_order_relaxed)) == NIL;
+	}
+};
+
+
+} // namespace ApplicationPool2
+} // namespace Passenger
+
+#endif /* _PASSENGER_APPLICATION_POOL2_IDLE_CONNECTION_STACK_H_ */
@@ -117,6 +117,7 @@ private:
 		result.push_back(&options.hostName);
 		result.push_back(&options.uri);
 		result.push_back(&options.unionStationKey);
+		result.push_back(&options.restartWarmupPath);
 
 		return result;
 	}
@@ -349,6 +350,21 @@ public:
 	 */
 	unsigned int maxProcesses;
 
+	/**
+	 * The maximum number of processes for the current group that may be
+	 * spawned at the same time. The pool-wide limit, `Pool::maxConcurrentSpawns`,
+	 * also applies. A value of 0 is treated as 1.
+	 */
+	unsigned int spawnConcurrency;
+
+	/**
+	 * Whether the number of processes for the current group should be managed
+	 * by the autoscaler, which spawns processes ahead of traffic ramps and
+	 * retires them based on sustained utilization instead of `Pool::maxIdleTime`.
+	 * `minProcesses` and `maxProcesses` still apply. See `Autoscaler`.
+	 */
+	bool autoscale;
+
 	/** The number of seconds that preloader processes may stay alive idling. */
 	long maxPreloaderIdleTime;
 
@@ -370,6 +386,23 @@ public:
 	 */
 	bool abortWebsocketsOnProcessShutdown;
 
+	/**
+	 * Whether Group::restart() should perform a blue/green restart by default,
+	 * i.e. spawn the new processes before retiring the old ones, so that the
+	 * group's capacity doesn't drop during the restart. See `RM_BLUE_GREEN`.
+	 * If the group needs more processes while the restart is in progress,
+	 * they are spawned from the new version of the application.
+	 */
+	bool blueGreenRestart;
+
+	/**
+	 * During a blue/green restart, a GET request for this path is sent to
+	 * every new process before it is made routable. An empty string means
+	 * that no warm-up request is sent. Processes that are spawned during the
+	 * restart because the group needs more capacity are not warmed up.
+	 */
+	StaticString restartWarmupPath;
+
 	/**
 	 * The Union Station key to use in case analytics logging is enabled.
 	 * It is used by Pool::collectAnalytics() and other administrative
@@ -492,10 +525,13 @@ public:
 
 		  minProcesses(1),
 		  maxProcesses(0),
+		  spawnConcurrency(1),
+		  autoscale(false),
 		  maxPreloaderIdleTime(-1),
 		  maxOutOfBandWorkInstances(1),
 		  maxRequestQueueSize(100),
 		  abortWebsocketsOnProcessShutdown(true),
+		  blueGreenRestart(false),
 
 		  stickySessionId(0),
 		  statThrottleRate(DEFAULT_STAT_THROTTLE_RATE),
@@ -631,8 +667,12 @@ public:
 		if (fields & PER_GROUP_POOL_OPTIONS) {
 			appendKeyValue3(vec, "min_processes",       minProcesses);
 			appendKeyValue3(vec, "max_processes",       maxProcesses);
+			appendKeyValue3(vec, "spawn_concurrency",   spawnConcurrency);
+			appendKeyValue4(vec, "autoscale",           autoscale);
 			appendKeyValue2(vec, "max_preloader_idle_time", maxPreloaderIdleTime);
 			appendKeyValue3(vec, "max_out_of_band_work_instances", maxOutOfBandWorkInstances);
+			appendKeyValue4(vec, "blue_green_restart", blueGreenRestart);
+			appendKeyValue (vec, "restart_warmup_path", restartWarmupPath);
 		}
 		if ((fields & SPAWN_OPTIONS) || (fields & PER_GROUP_POOL_OPTIONS)) {
 			appendKeyValue (vec, "union_station_key",   unionStationKey);
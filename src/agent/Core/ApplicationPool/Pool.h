@@ -38,6 +38,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/function.hpp>
 #include <boost/foreach.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/pool/object_pool.hpp>
 // We use boost::container::vector instead of std::vector, because the
 // former does not allocate memory in its default constructor. This is
@@ -54,6 +56,7 @@
 #include <Utils/Lock.h>
 #include <Utils/AnsiColorConstants.h>
 #include <Utils/SystemTime.h>
+#include <Utils/LatencyHistogram.h>
 #include <Utils/MessagePassing.h>
 #include <Utils/VariantMap.h>
 #include <Utils/ProcessMetricsCollector.h>
@@ -65,6 +68,7 @@
 #include <Core/ApplicationPool/Group.h>
 #include <Core/ApplicationPool/Session.h>
 #include <Core/ApplicationPool/Options.h>
+#include <Core/ApplicationPool/StateSnapshot.h>
 #include <Core/SpawningKit/Factory.h>
 #include <Shared/ApplicationPoolApiKey.h>
 
@@ -151,6 +155,27 @@ public:
 		}
 	};
 
+	struct ToJsonOptions: public AuthenticationOptions {
+		bool secrets;
+		/** If non-empty, only the group with this name is included. */
+		string groupName;
+
+		ToJsonOptions()
+			: secrets(true)
+			{ }
+
+		ToJsonOptions(const VariantMap &options)
+			: secrets(options.getBool("secrets", false, false)),
+			  groupName(options.get("group", false))
+			{ }
+
+		static ToJsonOptions makeAuthorized() {
+			ToJsonOptions options;
+			options.apiKey = ApiKey::makeSuper();
+			return options;
+		}
+	};
+
 
 // Actually private, but marked public so that unit tests can access the fields.
 public:
@@ -161,6 +186,13 @@ public:
 	mutable boost::mutex syncher;
 	unsigned int max;
 	unsigned long long maxIdleTime;
+	/**
+	 * The maximum number of processes that may be spawned at the same time,
+	 * over all groups. This only limits the extra spawns that a group performs
+	 * in parallel when its `spawnConcurrency` option is larger than 1: a
+	 * group that needs a process can always spawn at least one.
+	 */
+	unsigned int maxConcurrentSpawns;
 	bool selfchecking;
 
 	Context context;
@@ -227,6 +259,83 @@ public:
 
 	const VariantMap *agentsOptions;
 
+	/**
+	 * Incremented by every critical section that may change the state shown
+	 * by the state inspection functions, while it holds `syncher`. This
+	 * allows getSnapshot() to tell, without locking `syncher`, whether the
+	 * last published snapshot is still current.
+	 */
+	boost::atomic<boost::uint64_t> stateVersion;
+	/** The last published snapshot. Protected by `snapshotSyncher`, not by `syncher`. */
+	mutable boost::mutex snapshotSyncher;
+	mutable PoolSnapshotPtr lastSnapshot;
+
+
+	/****** Request path locking ******/
+
+	/**
+	 * A session close whose processing has been handed over to the thread
+	 * that currently holds `syncher`. See RequestPathLock.
+	 */
+	struct DeferredSessionClose {
+		ProcessPtr process;
+		Socket *socket;
+
+		DeferredSessionClose(Process *_process, Socket *_socket)
+			: process(_process),
+			  socket(_socket)
+			{ }
+	};
+
+	/**
+	 * Locks `syncher` on behalf of the code paths that are run for every
+	 * request, namely asyncGet() and session closing, and records how long
+	 * the lock was waited for and held.
+	 *
+	 * While a RequestPathLock holds `syncher`, session closes on other threads
+	 * do not block on `syncher`. Instead, they hand themselves over to the lock
+	 * holder through `deferredSessionCloses` and return immediately. The lock
+	 * holder processes them right before it releases the lock. So under
+	 * contention, a burst of session closes is handled in a single critical
+	 * section instead of every core thread queuing up on `syncher`.
+	 *
+	 * Invariant:
+	 *    if !acceptingDeferredSessionCloses:
+	 *       deferredSessionCloses is empty
+	 */
+	class RequestPathLock {
+	private:
+		Pool *pool;
+		boost::unique_lock<boost::mutex> l;
+		MonotonicTimeUsec lockedAt;
+
+		void onLocked(MonotonicTimeUsec waitStartedAt);
+
+	public:
+		RequestPathLock(Pool *pool, bool lockNow = true);
+		~RequestPathLock();
+
+		void lock();
+		bool lockOrDeferSessionClose(Process *process, Socket *socket);
+		void unlock(boost::container::vector<Callback> &postLockActions);
+
+		bool owns_lock() const {
+			return l.owns_lock();
+		}
+	};
+
+	LatencyHistogram syncherWaitTimes;
+	LatencyHistogram syncherHoldTimes;
+
+	// Protected by deferredSessionClosesSyncher, not by syncher.
+	mutable boost::mutex deferredSessionClosesSyncher;
+	bool acceptingDeferredSessionCloses;
+	vector<DeferredSessionClose> deferredSessionCloses;
+	boost::uint64_t totalDeferredSessionCloses;
+
+	void processDeferredSessionCloses(boost::container::vector<Callback> &postLockActions);
+	void inspectLockStatistics(const InspectOptions &options, stringstream &result) const;
+
 // Actually private, but marked public so that unit tests can access the fields.
 public:
 	/****** Debugging support *******/
@@ -307,6 +416,8 @@ public:
 		const GroupPtr &group, const ProcessPtr &process, ProcessList &output);
 	void garbageCollectProcessesInGroup(GarbageCollectorState &state,
 		const GroupPtr &group);
+	void reapIdleConnectionsInGroup(GarbageCollectorState &state, const GroupPtr &group);
+	void autoscaleGroup(GarbageCollectorState &state, const GroupPtr &group);
 	void maybeCleanPreloader(GarbageCollectorState &state, const GroupPtr &group);
 	unsigned long long realGarbageCollect();
 	void wakeupGarbageCollector();
@@ -383,8 +494,14 @@ public:
 
 	unsigned int capacityUsedUnlocked() const;
 	bool atFullCapacityUnlocked() const;
+	unsigned int processesBeingSpawnedUnlocked() const;
 	void inspectProcessList(const InspectOptions &options, stringstream &result,
-		const Group *group, const ProcessList &processes) const;
+		const GroupSnapshot &group) const;
+	boost::shared_ptr<PoolSnapshot> takeSnapshotUnlocked() const;
+
+	void stateChanged() {
+		stateVersion.fetch_add(1, boost::memory_order_relaxed);
+	}
 
 public:
 	typedef void (*AbortLongRunningConnectionsCallback)(const ProcessPtr &process);
@@ -445,6 +562,10 @@ public:
 		bool lock = true) const;
 	string toXml(const ToXmlOptions &options = ToXmlOptions::makeAuthorized(),
 		bool lock = true) const;
+	string toJson(const ToJsonOptions &options = ToJsonOptions::makeAuthorized(),
+		bool lock = true) const;
+	PoolSnapshotPtr getSnapshot(bool lock = true) const;
+	boost::uint64_t getStateVersion() const;
 
 
 	/****** Miscellaneous ******/
@@ -453,6 +574,7 @@ public:
 	SessionPtr get(const Options &options, Ticket *ticket);
 	void setMax(unsigned int max);
 	void setMaxIdleTime(unsigned long long value);
+	void setMaxConcurrentSpawns(unsigned int value);
 	void enableSelfChecking(bool enabled);
 	bool isSpawning(bool lock = true) const;
 	bool authorizeByApiKey(const ApiKey &key, bool lock = true) const;
@@ -114,9 +114,11 @@ Pool::prepareUnionStationProcessStateLogs(vector<UnionStationLogEntry> &logEntri
 		logEntries.push_back(UnionStationLogEntry());
 		UnionStationLogEntry &entry = logEntries.back();
 		stringstream stream;
+		GroupSnapshot snapshot(*group);
 
+		snapshot.resolveUserSwitching();
 		stream << "Group: <group>";
-		group->inspectXml(stream, false);
+		snapshot.inspectXml(stream, false);
 		stream << "</group>";
 
 		entry.groupName = group->options.getAppGroupName();
@@ -202,6 +204,7 @@ Pool::realCollectAnalytics() {
 		vector<ProcessPtr> processesToDetach;
 		boost::container::vector<Callback> actions;
 		ScopedLock l(syncher);
+		stateChanged();
 		GroupMap::ConstIterator g_it(groups);
 
 		UPDATE_TRACE_POINT();
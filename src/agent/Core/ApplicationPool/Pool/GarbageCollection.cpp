@@ -123,6 +123,88 @@ Pool::garbageCollectProcessesInGroup(GarbageCollectorState &state,
 	}
 }
 
+void
+Pool::reapIdleConnectionsInGroup(GarbageCollectorState &state, const GroupPtr &group) {
+	ProcessList::const_iterator it, end = group->enabledProcesses.end();
+	bool hasIdleConnections = false;
+
+	for (it = group->enabledProcesses.begin(); it != end; it++) {
+		if ((*it)->reapIdleConnections() > 0) {
+			hasIdleConnections = true;
+		}
+	}
+	if (hasIdleConnections) {
+		maybeUpdateNextGcRuntime(state,
+			state.now + APP_CONNECTION_IDLE_TIMEOUT * 1000000ull);
+	}
+}
+
+/*
+ * Samples the group's autoscaler and applies its decisions: the lower process
+ * limit is raised to the number of processes it expects to be needed, and
+ * when the load has been low for long enough, the least recently used idle
+ * process is retired. At most one process is retired per sample, so that the
+ * group scales down gradually.
+ */
+void
+Pool::autoscaleGroup(GarbageCollectorState &state, const GroupPtr &group) {
+	ProcessList::const_iterator it, end;
+	unsigned int load = 0;
+
+	maybeUpdateNextGcRuntime(state, state.now + Autoscaler::SAMPLE_INTERVAL);
+	if (group->enabledProcesses.empty() || group->enabledProcesses[0]->getConcurrency() == 0) {
+		// Without a per-process capacity the load cannot be translated
+		// into a number of processes, so fall back to the idle timer.
+		group->autoscalerMinProcesses = 0;
+		if (maxIdleTime > 0) {
+			garbageCollectProcessesInGroup(state, group);
+		}
+		return;
+	}
+
+	for (it = group->enabledProcesses.begin(), end = group->enabledProcesses.end(); it != end; it++) {
+		load += (*it)->sessions;
+	}
+	for (it = group->disablingProcesses.begin(), end = group->disablingProcesses.end(); it != end; it++) {
+		load += (*it)->sessions;
+	}
+	group->autoscaler.sample(state.now, load, group->getProcessCount(),
+		group->enabledProcesses[0]->getConcurrency());
+
+	unsigned int desired = group->autoscaler.getDesiredProcesses();
+	if (group->options.maxProcesses != 0) {
+		desired = std::min(desired, group->options.maxProcesses);
+	}
+	if (desired != group->autoscalerMinProcesses) {
+		P_DEBUG("Autoscaler: group " << group->getName() << " needs " << desired <<
+			" processes (predicted " << group->autoscaler.getPredictedRequestRate() <<
+			" requests/sec)");
+		group->autoscalerMinProcesses = desired;
+	}
+	if (!group->processLowerLimitsSatisfied() && group->allowSpawn()) {
+		group->spawn();
+	}
+
+	if (group->autoscaler.shouldRetireProcess()
+	 && (unsigned int) group->getProcessCount() > std::max(group->options.minProcesses, desired))
+	{
+		ProcessPtr oldest;
+		for (it = group->enabledProcesses.begin(), end = group->enabledProcesses.end(); it != end; it++) {
+			const ProcessPtr &process = *it;
+			if (process->sessions == 0
+			 && (oldest == NULL || process->lastUsed < oldest->lastUsed))
+			{
+				oldest = process;
+			}
+		}
+		if (oldest != NULL) {
+			P_DEBUG("Autoscaler: retiring underutilized process: " << oldest->inspect() <<
+				", group=" << group->getName());
+			group->detach(oldest, state.actions);
+		}
+	}
+}
+
 void
 Pool::maybeCleanPreloader(GarbageCollectorState &state, const GroupPtr &group) {
 	if (group->spawner->cleanable() && group->options.getMaxPreloaderIdleTime() != 0) {
@@ -142,6 +224,7 @@ unsigned long long
 Pool::realGarbageCollect() {
 	TRACE_POINT();
 	ScopedLock lock(syncher);
+	stateChanged();
 	GroupMap::ConstIterator g_it(groups);
 	GarbageCollectorState state;
 	state.now = SystemTime::getUsec();
@@ -154,11 +237,17 @@ Pool::realGarbageCollect() {
 	while (*g_it != NULL) {
 		const GroupPtr group = g_it.getValue();
 
-		if (maxIdleTime > 0) {
+		if (group->options.autoscale) {
+			// ...let the autoscaler decide how many processes are needed.
+			autoscaleGroup(state, group);
+		} else if (maxIdleTime > 0) {
 			// ...detach processes that have been idle for more than maxIdleTime.
 			garbageCollectProcessesInGroup(state, group);
 		}
 
+		// ...close application connections that have been idle for too long.
+		reapIdleConnectionsInGroup(state, group);
+
 		group->verifyInvariants();
 
 		// ...cleanup the spawner if it's been idle for more than preloaderIdleTime.
@@ -146,6 +146,7 @@ Pool::findOrCreateGroup(const Options &options) {
 	Ticket ticket;
 	{
 		LockGuard l(syncher);
+		stateChanged();
 		GroupPtr *group;
 		if (!groups.lookup(options.getAppGroupName(), &group)) {
 			// Forcefully create Group, don't care whether resource limits
@@ -174,6 +175,7 @@ bool
 Pool::detachGroupByName(const HashedStaticString &name) {
 	TRACE_POINT();
 	ScopedLock l(syncher);
+	stateChanged();
 	GroupPtr group = groups.lookupCopy(name);
 
 	if (OXT_LIKELY(group != NULL)) {
@@ -217,6 +219,7 @@ Pool::detachGroupByName(const HashedStaticString &name) {
 bool
 Pool::detachGroupByApiKey(const StaticString &value) {
 	ScopedLock l(syncher);
+	stateChanged();
 	GroupPtr group = findGroupByApiKey(value, false);
 	if (group != NULL) {
 		string name = group->getName();
@@ -231,6 +234,7 @@ Pool::detachGroupByApiKey(const StaticString &value) {
 bool
 Pool::restartGroupByName(const StaticString &name, const RestartOptions &options) {
 	ScopedLock l(syncher);
+	stateChanged();
 	GroupMap::ConstIterator g_it(groups);
 	while (*g_it != NULL) {
 		const GroupPtr &group = g_it.getValue();
@@ -254,6 +258,7 @@ Pool::restartGroupByName(const StaticString &name, const RestartOptions &options
 unsigned int
 Pool::restartGroupsByAppRoot(const StaticString &appRoot, const RestartOptions &options) {
 	ScopedLock l(syncher);
+	stateChanged();
 	GroupMap::ConstIterator g_it(groups);
 	unsigned int result = 0;
 
@@ -56,9 +56,14 @@ Pool::Pool(const SpawningKit::FactoryPtr &spawningKitFactory,
 	lifeStatus   = ALIVE;
 	max          = 6;
 	maxIdleTime  = 60 * 1000000;
+	maxConcurrentSpawns = DEFAULT_MAX_CONCURRENT_SPAWNS;
 	selfchecking = true;
 	palloc       = psg_create_pool(PSG_DEFAULT_POOL_SIZE);
 
+	acceptingDeferredSessionCloses = false;
+	totalDeferredSessionCloses = 0;
+	stateVersion.store(0, boost::memory_order_relaxed);
+
 	// The following code only serve to instantiate certain inline methods
 	// so that they can be invoked from gdb.
 	(void) GroupPtr().get();
@@ -99,6 +104,7 @@ Pool::prepareForShutdown() {
 	TRACE_POINT();
 	ScopedLock lock(syncher);
 	assert(lifeStatus == ALIVE);
+	stateChanged();
 	lifeStatus = PREPARED_FOR_SHUTDOWN;
 	if (abortLongRunningConnectionsCallback != NULL) {
 		vector<ProcessPtr> processes = getProcesses(false);
@@ -42,7 +42,7 @@ using namespace boost;
 // should never call the callback while holding the lock.
 void
 Pool::asyncGet(const Options &options, const GetCallback &callback, bool lockNow, UnionStation::StopwatchLog **stopwatchLog) {
-	DynamicScopedLock lock(syncher, lockNow);
+	RequestPathLock lock(this, lockNow);
 
 	assert(lifeStatus == ALIVE || lifeStatus == PREPARED_FOR_SHUTDOWN);
 	verifyInvariants();
@@ -86,7 +86,7 @@ Pool::asyncGet(const Options &options, const GetCallback &callback, bool lockNow
 		verifyInvariants();
 		P_TRACE(2, "asyncGet() finished");
 		if (lockNow) {
-			lock.unlock();
+			lock.unlock(actions);
 		}
 		if (session != NULL) {
 			callback(session, ExceptionPtr());
@@ -149,11 +149,11 @@ Pool::asyncGet(const Options &options, const GetCallback &callback, bool lockNow
 		P_TRACE(2, "asyncGet() finished");
 	}
 
+	if (lock.owns_lock()) {
+		lock.unlock(actions);
+	}
 	if (!actions.empty()) {
 		if (lockNow) {
-			if (lock.owns_lock()) {
-				lock.unlock();
-			}
 			runAllActions(actions);
 		} else {
 			// This state is not allowed. If we reach
@@ -194,6 +194,7 @@ Pool::get(const Options &options, Ticket *ticket) {
 void
 Pool::setMax(unsigned int max) {
 	ScopedLock l(syncher);
+	stateChanged();
 	assert(max > 0);
 	fullVerifyInvariants();
 	bool bigger = max > this->max;
@@ -227,6 +228,13 @@ Pool::setMaxIdleTime(unsigned long long value) {
 	wakeupGarbageCollector();
 }
 
+void
+Pool::setMaxConcurrentSpawns(unsigned int value) {
+	LockGuard l(syncher);
+	stateChanged();
+	maxConcurrentSpawns = value;
+}
+
 void
 Pool::enableSelfChecking(bool enabled) {
 	LockGuard l(syncher);
@@ -245,6 +245,7 @@ Pool::findProcessByPid(pid_t pid, bool lock) const {
 bool
 Pool::detachProcess(const ProcessPtr &process) {
 	ScopedLock l(syncher);
+	stateChanged();
 	boost::container::vector<Callback> actions;
 	bool result = detachProcessUnlocked(process, actions);
 	fullVerifyInvariants();
@@ -256,6 +257,7 @@ Pool::detachProcess(const ProcessPtr &process) {
 bool
 Pool::detachProcess(pid_t pid, const AuthenticationOptions &options) {
 	ScopedLock l(syncher);
+	stateChanged();
 	ProcessPtr process = findProcessByPid(pid, false);
 	if (process != NULL) {
 		const Group *group = process->getGroup();
@@ -279,6 +281,7 @@ Pool::detachProcess(pid_t pid, const AuthenticationOptions &options) {
 bool
 Pool::detachProcess(const string &gupid, const AuthenticationOptions &options) {
 	ScopedLock l(syncher);
+	stateChanged();
 	ProcessPtr process = findProcessByGupid(gupid, false);
 	if (process != NULL) {
 		const Group *group = process->getGroup();
@@ -302,6 +305,7 @@ Pool::detachProcess(const string &gupid, const AuthenticationOptions &options) {
 DisableResult
 Pool::disableProcess(const StaticString &gupid) {
 	ScopedLock l(syncher);
+	stateChanged();
 	ProcessPtr process = findProcessByGupid(gupid, false);
 	if (process != NULL) {
 		Group *group = process->getGroup();
@@ -0,0 +1,188 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#include <Core/ApplicationPool/Pool.h>
+
+/*************************************************************************
+ *
+ * Request path locking functions for ApplicationPool2::Pool
+ *
+ *************************************************************************/
+
+namespace Passenger {
+namespace ApplicationPool2 {
+
+using namespace std;
+using namespace boost;
+
+
+/****************************
+ *
+ * Private methods
+ *
+ ****************************/
+
+
+Pool::RequestPathLock::RequestPathLock(Pool *_pool, bool lockNow)
+	: pool(_pool),
+	  l(_pool->syncher, boost::defer_lock),
+	  lockedAt(0)
+{
+	if (lockNow) {
+		lock();
+	}
+}
+
+Pool::RequestPathLock::~RequestPathLock() {
+	if (l.owns_lock()) {
+		boost::container::vector<Callback> actions;
+		unlock(actions);
+		runAllActions(actions);
+	}
+}
+
+void
+Pool::RequestPathLock::onLocked(MonotonicTimeUsec waitStartedAt) {
+	lockedAt = SystemTime::getMonotonicUsec();
+	if (waitStartedAt == 0 || lockedAt < waitStartedAt) {
+		pool->syncherWaitTimes.record(0);
+	} else {
+		pool->syncherWaitTimes.record(lockedAt - waitStartedAt);
+	}
+	// Every request path critical section checks out or closes sessions.
+	pool->stateChanged();
+
+	LockGuard l2(pool->deferredSessionClosesSyncher);
+	assert(!pool->acceptingDeferredSessionCloses);
+	assert(pool->deferredSessionCloses.empty());
+	pool->acceptingDeferredSessionCloses = true;
+}
+
+void
+Pool::RequestPathLock::lock() {
+	if (l.try_lock()) {
+		onLocked(0);
+	} else {
+		MonotonicTimeUsec waitStartedAt = SystemTime::getMonotonicUsec();
+		l.lock();
+		onLocked(waitStartedAt);
+	}
+}
+
+/**
+ * Locks `syncher` in order to process a session close. But if the lock is
+ * currently held by another RequestPathLock, then the session close is handed
+ * over to that lock holder instead and false is returned.
+ */
+bool
+Pool::RequestPathLock::lockOrDeferSessionClose(Process *process, Socket *socket) {
+	if (l.try_lock()) {
+		onLocked(0);
+		return true;
+	}
+
+	{
+		LockGuard l2(pool->deferredSessionClosesSyncher);
+		if (pool->acceptingDeferredSessionCloses) {
+			pool->deferredSessionCloses.push_back(DeferredSessionClose(process, socket));
+			pool->totalDeferredSessionCloses++;
+			return false;
+		}
+	}
+
+	// The lock is held by some other code path, e.g. the garbage
+	// collector, which won't process our session close. So wait.
+	MonotonicTimeUsec waitStartedAt = SystemTime::getMonotonicUsec();
+	l.lock();
+	onLocked(waitStartedAt);
+	return true;
+}
+
+/**
+ * Processes all session closes that were handed over to us, then unlocks
+ * `syncher`. Any callbacks that should be run outside the lock are added to
+ * `postLockActions`.
+ */
+void
+Pool::RequestPathLock::unlock(boost::container::vector<Callback> &postLockActions) {
+	pool->processDeferredSessionCloses(postLockActions);
+
+	MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+	if (now > lockedAt) {
+		pool->syncherHoldTimes.record(now - lockedAt);
+	} else {
+		pool->syncherHoldTimes.record(0);
+	}
+	l.unlock();
+}
+
+void
+Pool::processDeferredSessionCloses(boost::container::vector<Callback> &postLockActions) {
+	vector<DeferredSessionClose> closes;
+
+	while (true) {
+		{
+			LockGuard l(deferredSessionClosesSyncher);
+			if (deferredSessionCloses.empty()) {
+				// From now on, session closes will wait for `syncher`
+				// instead of relying on us to process them.
+				acceptingDeferredSessionCloses = false;
+				return;
+			}
+			closes.swap(deferredSessionCloses);
+		}
+
+		vector<DeferredSessionClose>::const_iterator it, end = closes.end();
+		for (it = closes.begin(); it != end; it++) {
+			Process *process = it->process.get();
+			process->getGroup()->processSessionClose(process, it->socket,
+				postLockActions);
+		}
+		closes.clear();
+	}
+}
+
+void
+Pool::inspectLockStatistics(const InspectOptions &options, stringstream &result) const {
+	boost::uint64_t deferred;
+	{
+		LockGuard l(deferredSessionClosesSyncher);
+		deferred = totalDeferredSessionCloses;
+	}
+
+	result << "Lock wait time : " << syncherWaitTimes.inspect() << endl;
+	if (options.verbose) {
+		result << syncherWaitTimes.inspectBuckets("    ");
+	}
+	result << "Lock hold time : " << syncherHoldTimes.inspect() << endl;
+	if (options.verbose) {
+		result << syncherHoldTimes.inspectBuckets("    ");
+	}
+	result << "Session closes handed over to lock holder : " << deferred << endl;
+}
+
+
+} // namespace ApplicationPool2
+} // namespace Passenger
@@ -68,21 +68,32 @@ Pool::atFullCapacityUnlocked() const {
 	return capacityUsedUnlocked() >= max;
 }
 
+unsigned int
+Pool::processesBeingSpawnedUnlocked() const {
+	GroupMap::ConstIterator g_it(groups);
+	unsigned int result = 0;
+	while (*g_it != NULL) {
+		result += g_it.getValue()->processesBeingSpawned;
+		g_it.next();
+	}
+	return result;
+}
+
 void
 Pool::inspectProcessList(const InspectOptions &options, stringstream &result,
-	const Group *group, const ProcessList &processes) const
+	const GroupSnapshot &group) const
 {
-	ProcessList::const_iterator p_it;
-	for (p_it = processes.begin(); p_it != processes.end(); p_it++) {
-		const ProcessPtr &process = *p_it;
+	vector<ProcessSnapshot>::const_iterator p_it;
+	for (p_it = group.processes.begin(); p_it != group.processes.end(); p_it++) {
+		const ProcessSnapshot &process = *p_it;
 		char buf[128];
 		char cpubuf[10];
 		char membuf[10];
 
-		 if (process->metrics.isValid()) {
-			snprintf(cpubuf, sizeof(cpubuf), "%d%%", (int) process->metrics.cpu);
+		 if (process.metrics.isValid()) {
+			snprintf(cpubuf, sizeof(cpubuf), "%d%%", (int) process.metrics.cpu);
 			snprintf(membuf, sizeof(membuf), "%ldM",
-				(unsigned long) (process->metrics.realMemory() / 1024));
+				(unsigned long) (process.metrics.realMemory() / 1024));
 		} else {
 			snprintf(cpubuf, sizeof(cpubuf), "0%%");
 			snprintf(membuf, sizeof(membuf), "0M");
@@ -90,31 +101,62 @@ Pool::inspectProcessList(const InspectOptions &options, stringstream &result,
 		snprintf(buf, sizeof(buf),
 			"  * PID: %-5lu   Sessions: %-2u      Processed: %-5u   Uptime: %s\n"
 			"    CPU: %-5s   Memory  : %-5s   Last used: %s ago",
-			(unsigned long) process->getPid(),
-			process->sessions,
-			process->processed,
-			process->uptime().c_str(),
+			(unsigned long) process.pid,
+			process.sessions,
+			process.processed,
+			process.uptime().c_str(),
 			cpubuf,
 			membuf,
-			distanceOfTimeInWords(process->lastUsed / 1000000).c_str());
+			distanceOfTimeInWords(process.lastUsed / 1000000).c_str());
 		result << buf << endl;
 
-		if (process->enabled == Process::DISABLING) {
+		if (process.enabled == Process::DISABLING) {
 			result << "    Disabling..." << endl;
-		} else if (process->enabled == Process::DISABLED) {
+		} else if (process.enabled == Process::DISABLED) {
 			result << "    DISABLED" << endl;
-		} else if (process->enabled == Process::DETACHED) {
+		} else if (process.enabled == Process::DETACHED) {
 			result << "    Shutting down..." << endl;
 		}
 
-		const Socket *socket;
-		if (options.verbose && (socket = process->getSockets().findSocketWithName("http")) != NULL) {
+		const ProcessSnapshot::SocketInfo *socket;
+		if (options.verbose && (socket = process.findSocketWithName("http")) != NULL) {
 			result << "    URL     : http://" << replaceString(socket->address, "tcp://", "") << endl;
-			result << "    Password: " << group->getApiKey().toStaticString() << endl;
+			result << "    Password: " << group.apiKey.toStaticString() << endl;
 		}
 	}
 }
 
+/**
+ * Copies the current state into a new snapshot. `syncher` must be held,
+ * unless the caller is prepared to deal with an inconsistent state (e.g.
+ * in a crash handler). The snapshot's user switching information is
+ * resolved by the caller, after `syncher` has been released.
+ */
+boost::shared_ptr<PoolSnapshot>
+Pool::takeSnapshotUnlocked() const {
+	boost::shared_ptr<PoolSnapshot> snapshot = boost::make_shared<PoolSnapshot>();
+	vector<GetWaiter>::const_iterator w_it, w_end = getWaitlist.end();
+
+	snapshot->version = stateVersion.load(boost::memory_order_relaxed);
+	snapshot->max = max;
+	snapshot->maxConcurrentSpawns = maxConcurrentSpawns;
+	snapshot->processCount = getProcessCount(false);
+	snapshot->capacityUsed = capacityUsedUnlocked();
+	snapshot->getWaitlist.reserve(getWaitlist.size());
+	for (w_it = getWaitlist.begin(); w_it != w_end; w_it++) {
+		snapshot->getWaitlist.push_back(w_it->options.getAppGroupName().toString());
+	}
+
+	snapshot->groups.reserve(groups.size());
+	GroupMap::ConstIterator g_it(groups);
+	while (*g_it != NULL) {
+		snapshot->groups.push_back(GroupSnapshot(*g_it.getValue()));
+		g_it.next();
+	}
+
+	return snapshot;
+}
+
 
 /****************************
  *
@@ -123,81 +165,163 @@ Pool::inspectProcessList(const InspectOptions &options, stringstream &result,
  ****************************/
 
 
+/**
+ * Returns a snapshot of the pool state. The last published snapshot is
+ * reused as long as the state version hasn't changed, so repeatedly
+ * inspecting an unchanged pool does not lock `syncher` at all. Otherwise,
+ * `syncher` is only held while copying the state; everything that is
+ * expensive (user database lookups, formatting) happens outside it.
+ *
+ * If `lock` is false then `syncher` is neither locked nor is the published
+ * snapshot used. This is meant for callers that already hold `syncher`.
+ */
+PoolSnapshotPtr
+Pool::getSnapshot(bool lock) const {
+	if (!lock) {
+		boost::shared_ptr<PoolSnapshot> snapshot = takeSnapshotUnlocked();
+		snapshot->resolveUserSwitching();
+		return snapshot;
+	}
+
+	boost::uint64_t version = stateVersion.load(boost::memory_order_relaxed);
+	{
+		LockGuard l(snapshotSyncher);
+		if (lastSnapshot != NULL && lastSnapshot->version == version) {
+			return lastSnapshot;
+		}
+	}
+
+	boost::shared_ptr<PoolSnapshot> snapshot;
+	{
+		LockGuard l(syncher);
+		snapshot = takeSnapshotUnlocked();
+	}
+	snapshot->resolveUserSwitching();
+
+	LockGuard l(snapshotSyncher);
+	if (lastSnapshot == NULL || lastSnapshot->version < snapshot->version) {
+		lastSnapshot = snapshot;
+	}
+	return snapshot;
+}
+
+boost::uint64_t
+Pool::getStateVersion() const {
+	return stateVersion.load(boost::memory_order_relaxed);
+}
+
 string
 Pool::inspect(const InspectOptions &options, bool lock) const {
-	DynamicScopedLock l(syncher, lock);
+	PoolSnapshotPtr snapshot = getSnapshot(lock);
 	stringstream result;
 	const char *headerColor = maybeColorize(options, ANSI_COLOR_YELLOW ANSI_COLOR_BLUE_BG ANSI_COLOR_BOLD);
 	const char *resetColor  = maybeColorize(options, ANSI_COLOR_RESET);
 
-	if (!authorizeByUid(options.uid, false)
-	 && !authorizeByApiKey(options.apiKey, false))
+	if (!snapshot->authorizeByUid(options.uid)
+	 && !snapshot->authorizeByApiKey(options.apiKey))
 	{
 		throw SecurityException("Operation unauthorized");
 	}
 
 	result << headerColor << "----------- General information -----------" << resetColor << endl;
-	result << "Max pool size : " << max << endl;
-	result << "App groups    : " << groups.size() << endl;
-	result << "Processes     : " << getProcessCount(false) << endl;
-	result << "Requests in top-level queue : " << getWaitlist.size() << endl;
+	result << "Max pool size : " << snapshot->max << endl;
+	result << "App groups    : " << snapshot->groups.size() << endl;
+	result << "Processes     : " << snapshot->processCount << endl;
+	result << "Requests in top-level queue : " << snapshot->getWaitlist.size() << endl;
 	if (options.verbose) {
 		unsigned int i = 0;
-		foreach (const GetWaiter &waiter, getWaitlist) {
-			result << "  " << i << ": " << waiter.options.getAppGroupName() << endl;
+		foreach (const string &appGroupName, snapshot->getWaitlist) {
+			result << "  " << i << ": " << appGroupName << endl;
 			i++;
 		}
 	}
 	result << endl;
 
 	result << headerColor << "----------- Application groups -----------" << resetColor << endl;
-	GroupMap::ConstIterator g_it(groups);
-	while (*g_it != NULL) {
-		const GroupPtr &group = g_it.getValue();
-		if (!group->authorizeByUid(options.uid)
-		 && !group->authorizeByApiKey(options.apiKey))
+	foreach (const GroupSnapshot &group, snapshot->groups) {
+		if (!group.authorizeByUid(options.uid)
+		 && !group.authorizeByApiKey(options.apiKey))
 		{
-			g_it.next();
 			continue;
 		}
 
-		ProcessList::const_iterator p_it;
-
-		result << group->getName() << ":" << endl;
-		result << "  App root: " << group->options.appRoot << endl;
-		if (group->restarting()) {
+		result << group.name << ":" << endl;
+		result << "  App root: " << group.options.appRoot << endl;
+		if (group.restarting) {
 			result << "  (restarting...)" << endl;
+		} else if (group.blueGreenRestarting) {
+			result << "  (blue/green restarting...)" << endl;
 		}
-		if (group->spawning()) {
-			if (group->processesBeingSpawned == 0) {
+		if (group.spawning) {
+			if (group.processesBeingSpawned == 0) {
 				result << "  (spawning...)" << endl;
 			} else {
-				result << "  (spawning " << group->processesBeingSpawned << " new " <<
-					maybePluralize(group->processesBeingSpawned, "process", "processes") <<
+				result << "  (spawning " << group.processesBeingSpawned << " new " <<
+					maybePluralize(group.processesBeingSpawned, "process", "processes") <<
 					"...)" << endl;
 			}
 		}
-		result << "  Requests in queue: " << group->getWaitlist.size() << endl;
-		inspectProcessList(options, result, group.get(), group->enabledProcesses);
-		inspectProcessList(options, result, group.get(), group->disablingProcesses);
-		inspectProcessList(options, result, group.get(), group->disabledProcesses);
-		inspectProcessList(options, result, group.get(), group->detachedProcesses);
+		result << "  Requests in queue: " << group.getWaitlistSize << endl;
+		if (group.lastSpawnBurstProcessesSpawned > 0) {
+			char buf[128];
+			double duration = group.lastSpawnBurstDuration / 1000000.0;
+			snprintf(buf, sizeof(buf), "%u %s in %.1fs (%.2f/sec, concurrency %u)",
+				group.lastSpawnBurstProcessesSpawned,
+				maybePluralize(group.lastSpawnBurstProcessesSpawned,
+					"process", "processes"),
+				duration,
+				(duration > 0) ? group.lastSpawnBurstProcessesSpawned / duration : 0.0,
+				group.spawnConcurrency);
+			result << "  Last spawn burst: " << buf << endl;
+		}
+		if (group.lastGetWaitlistDrainTime > 0) {
+			char buf[32];
+			snprintf(buf, sizeof(buf), "%.1fs",
+				group.lastGetWaitlistDrainTime / 1000000.0);
+			result << "  Last queue drain time: " << buf << endl;
+		}
+		if (group.lastRestartStats.startTime != 0) {
+			const Group::RestartStats &stats = group.lastRestartStats;
+			char buf[192];
+			snprintf(buf, sizeof(buf), "%s, %u %s replaced in %.1fs%s; "
+				"max %u %s in queue, max queue drain time %.1fs",
+				stats.blueGreen ? "blue/green" : "blocking",
+				stats.processesReplaced,
+				maybePluralize(stats.processesReplaced, "process", "processes"),
+				stats.duration / 1000000.0,
+				stats.completed ? "" : " (aborted)",
+				stats.maxGetWaitlistSize,
+				maybePluralize(stats.maxGetWaitlistSize, "request", "requests"),
+				stats.maxGetWaitlistDrainTime / 1000000.0);
+			result << "  Last restart: " << buf << endl;
+		}
+		if (group.options.autoscale) {
+			char buf[160];
+			snprintf(buf, sizeof(buf), "%.1f requests/sec (predicted %.1f), "
+				"average queue time %.1fms, %u %s needed",
+				group.requestRate,
+				group.predictedRequestRate,
+				group.queueTime / 1000.0,
+				group.autoscalerMinProcesses,
+				maybePluralize(group.autoscalerMinProcesses, "process", "processes"));
+			result << "  Autoscaler: " << buf << endl;
+		}
+		inspectProcessList(options, result, group);
 		result << endl;
-
-		g_it.next();
 	}
+
+	result << headerColor << "----------- Lock statistics -----------" << resetColor << endl;
+	inspectLockStatistics(options, result);
 	return result.str();
 }
 
 string
 Pool::toXml(const ToXmlOptions &options, bool lock) const {
-	DynamicScopedLock l(syncher, lock);
+	PoolSnapshotPtr snapshot = getSnapshot(lock);
 	stringstream result;
-	GroupMap::ConstIterator g_it(groups);
-	ProcessList::const_iterator p_it;
 
-	if (!authorizeByUid(options.uid, false)
-	 && !authorizeByApiKey(options.apiKey, false))
+	if (!snapshot->authorizeByUid(options.uid)
+	 && !snapshot->authorizeByApiKey(options.apiKey))
 	{
 		throw SecurityException("Operation unauthorized");
 	}
@@ -206,51 +330,45 @@ Pool::toXml(const ToXmlOptions &options, bool lock) const {
 	result << "<info version=\"3\">";
 
 	result << "<passenger_version>" << PASSENGER_VERSION << "</passenger_version>";
-	result << "<group_count>" << groups.size() << "</group_count>";
-	result << "<process_count>" << getProcessCount(false) << "</process_count>";
-	result << "<max>" << max << "</max>";
-	result << "<capacity_used>" << capacityUsedUnlocked() << "</capacity_used>";
-	result << "<get_wait_list_size>" << getWaitlist.size() << "</get_wait_list_size>";
+	result << "<group_count>" << snapshot->groups.size() << "</group_count>";
+	result << "<process_count>" << snapshot->processCount << "</process_count>";
+	result << "<max>" << snapshot->max << "</max>";
+	result << "<max_concurrent_spawns>" << snapshot->maxConcurrentSpawns << "</max_concurrent_spawns>";
+	result << "<capacity_used>" << snapshot->capacityUsed << "</capacity_used>";
+	result << "<get_wait_list_size>" << snapshot->getWaitlist.size() << "</get_wait_list_size>";
 
 	if (options.secrets) {
-		vector<GetWaiter>::const_iterator w_it, w_end = getWaitlist.end();
-
 		result << "<get_wait_list>";
-		for (w_it = getWaitlist.begin(); w_it != w_end; w_it++) {
-			const GetWaiter &waiter = *w_it;
+		foreach (const string &appGroupName, snapshot->getWaitlist) {
 			result << "<item>";
-			result << "<app_group_name>" << escapeForXml(waiter.options.getAppGroupName()) << "</app_group_name>";
+			result << "<app_group_name>" << escapeForXml(appGroupName) << "</app_group_name>";
 			result << "</item>";
 		}
 		result << "</get_wait_list>";
 	}
 
 	result << "<supergroups>";
-	while (*g_it != NULL) {
-		const GroupPtr &group = g_it.getValue();
-		if (!group->authorizeByUid(options.uid)
-		 && !group->authorizeByApiKey(options.apiKey))
+	foreach (const GroupSnapshot &group, snapshot->groups) {
+		if (!group.authorizeByUid(options.uid)
+		 && !group.authorizeByApiKey(options.apiKey))
 		{
-			g_it.next();
 			continue;
 		}
 
 		result << "<supergroup>";
-		result << "<name>" << escapeForXml(group->getName()) << "</name>";
+		result << "<name>" << escapeForXml(group.name) << "</name>";
 		result << "<state>READY</state>";
 		result << "<get_wait_list_size>0</get_wait_list_size>";
-		result << "<capacity_used>" << group->capacityUsed() << "</capacity_used>";
+		result << "<capacity_used>" << group.capacityUsed << "</capacity_used>";
 		if (options.secrets) {
-			result << "<secret>" << escapeForXml(group->getApiKey().toStaticString()) << "</secret>";
+			result << "<secret>" << escapeForXml(group.apiKey.toStaticString()) << "</secret>";
 		}
 
 		result << "<group default=\"true\">";
-		group->inspectXml(result, options.secrets);
+		group.inspectXml(result, options.secrets);
 		result << "</group>";
 
 		result << "</supergroup>";
-
-		g_it.next();
 	}
 	result << "</supergroups>";
 
@@ -258,6 +376,53 @@ Pool::toXml(const ToXmlOptions &options, bool lock) const {
 	return result.str();
 }
 
+/**
+ * Like toXml(), but returns JSON. Unlike the XML format, the JSON format
+ * can be limited to a single group through `options.groupName`.
+ */
+string
+Pool::toJson(const ToJsonOptions &options, bool lock) const {
+	PoolSnapshotPtr snapshot = getSnapshot(lock);
+	Json::Value doc;
+
+	if (!snapshot->authorizeByUid(options.uid)
+	 && !snapshot->authorizeByApiKey(options.apiKey))
+	{
+		throw SecurityException("Operation unauthorized");
+	}
+
+	doc["passenger_version"] = PASSENGER_VERSION;
+	doc["state_version"] = (Json::UInt64) snapshot->version;
+	doc["group_count"] = (Json::UInt) snapshot->groups.size();
+	doc["process_count"] = snapshot->processCount;
+	doc["max"] = snapshot->max;
+	doc["max_concurrent_spawns"] = snapshot->maxConcurrentSpawns;
+	doc["capacity_used"] = snapshot->capacityUsed;
+	doc["get_wait_list_size"] = (Json::UInt) snapshot->getWaitlist.size();
+
+	if (options.secrets) {
+		Json::Value waitlistDoc(Json::arrayValue);
+		foreach (const string &appGroupName, snapshot->getWaitlist) {
+			waitlistDoc.append(appGroupName);
+		}
+		doc["get_wait_list"] = waitlistDoc;
+	}
+
+	Json::Value groupsDoc(Json::objectValue);
+	foreach (const GroupSnapshot &group, snapshot->groups) {
+		if ((!options.groupName.empty() && group.name != options.groupName)
+		 || (!group.authorizeByUid(options.uid)
+		  && !group.authorizeByApiKey(options.apiKey)))
+		{
+			continue;
+		}
+		groupsDoc[group.name] = group.inspectStateAsJson(options.secrets);
+	}
+	doc["groups"] = groupsDoc;
+
+	return doc.toStyledString();
+}
+
 
 unsigned int
 Pool::capacityUsed() const {
@@ -589,6 +589,21 @@ public:
 		lifeStatus = DEAD;
 	}
 
+	/**
+	 * Closes application connections that have been idle for too long.
+	 * Returns the number of idle connections that remain.
+	 */
+	unsigned int reapIdleConnections() {
+		unsigned int result = 0;
+		if (!dummy) {
+			SocketList::iterator it, end = sockets.end();
+			for (it = sockets.begin(); it != end; it++) {
+				result += it->reapIdleConnections();
+			}
+		}
+		return result;
+	}
+
 
 	/****** Basic information queries ******/
 
@@ -629,6 +644,18 @@ public:
 		return spawnerCreationTime;
 	}
 
+	unsigned long long getSpawnStartTime() const {
+		return spawnStartTime;
+	}
+
+	unsigned long long getSpawnEndTime() const {
+		return spawnEndTime;
+	}
+
+	StaticString getCodeRevision() const {
+		return codeRevision;
+	}
+
 	bool isDummy() const {
 		return dummy;
 	}
@@ -719,6 +746,14 @@ public:
 		}
 	}
 
+	/**
+	 * The maximum number of concurrent sessions for this process,
+	 * or 0 if unlimited.
+	 */
+	int getConcurrency() const {
+		return concurrency;
+	}
+
 	/**
 	 * Whether we've reached the maximum number of concurrent sessions for this
 	 * process.
@@ -795,8 +830,10 @@ public:
 	}
 
 	void sessionClosed(Session *session) {
-		Socket *socket = session->getSocket();
+		sessionClosed(session->getSocket());
+	}
 
+	void sessionClosed(Socket *socket) {
 		assert(socket->sessions > 0);
 		assert(sessions > 0);
 
@@ -819,83 +856,6 @@ public:
 		result << "(pid=" << getPid() << ", group=" << getGroupName() << ")";
 		return result.str();
 	}
-
-	template<typename Stream>
-	void inspectXml(Stream &stream, bool includeSockets = true) const {
-		stream << "<pid>" << getPid() << "</pid>";
-		stream << "<sticky_session_id>" << getStickySessionId() << "</sticky_session_id>";
-		stream << "<gupid>" << getGupid() << "</gupid>";
-		stream << "<concurrency>" << concurrency << "</concurrency>";
-		stream << "<sessions>" << sessions << "</sessions>";
-		stream << "<busyness>" << busyness() << "</busyness>";
-		stream << "<processed>" << processed << "</processed>";
-		stream << "<spawner_creation_time>" << spawnerCreationTime << "</spawner_creation_time>";
-		stream << "<spawn_start_time>" << spawnStartTime << "</spawn_start_time>";
-		stream << "<spawn_end_time>" << spawnEndTime << "</spawn_end_time>";
-		stream << "<last_used>" << lastUsed << "</last_used>";
-		stream << "<last_used_desc>" << distanceOfTimeInWords(lastUsed / 1000000).c_str() << " ago</last_used_desc>";
-		stream << "<uptime>" << uptime() << "</uptime>";
-		if (!codeRevision.empty()) {
-			stream << "<code_revision>" << escapeForXml(codeRevision) << "</code_revision>";
-		}
-		switch (lifeStatus) {
-		case ALIVE:
-			stream << "<life_status>ALIVE</life_status>";
-			break;
-		case SHUTDOWN_TRIGGERED:
-			stream << "<life_status>SHUTDOWN_TRIGGERED</life_status>";
-			break;
-		case DEAD:
-			stream << "<life_status>DEAD</life_status>";
-			break;
-		default:
-			P_BUG("Unknown 'lifeStatus' state " << (int) lifeStatus);
-		}
-		switch (enabled) {
-		case ENABLED:
-			stream << "<enabled>ENABLED</enabled>";
-			break;
-		case DISABLING:
-			stream << "<enabled>DISABLING</enabled>";
-			break;
-		case DISABLED:
-			stream << "<enabled>DISABLED</enabled>";
-			break;
-		case DETACHED:
-			stream << "<enabled>DETACHED</enabled>";
-			break;
-		default:
-			P_BUG("Unknown 'enabled' state " << (int) enabled);
-		}
-		if (metrics.isValid()) {
-			stream << "<has_metrics>true</has_metrics>";
-			stream << "<cpu>" << (int) metrics.cpu << "</cpu>";
-			stream << "<rss>" << metrics.rss << "</rss>";
-			stream << "<pss>" << metrics.pss << "</pss>";
-			stream << "<private_dirty>" << metrics.privateDirty << "</private_dirty>";
-			stream << "<swap>" << metrics.swap << "</swap>";
-			stream << "<real_memory>" << metrics.realMemory() << "</real_memory>";
-			stream << "<vmsize>" << metrics.vmsize << "</vmsize>";
-			stream << "<process_group_id>" << metrics.processGroupId << "</process_group_id>";
-			stream << "<command>" << escapeForXml(metrics.command) << "</command>";
-		}
-		if (includeSockets) {
-			SocketList::const_iterator it;
-
-			stream << "<sockets>";
-			for (it = sockets.begin(); it != sockets.end(); it++) {
-				const Socket &socket = *it;
-				stream << "<socket>";
-				stream << "<name>" << escapeForXml(socket.name) << "</name>";
-				stream << "<address>" << escapeForXml(socket.address) << "</address>";
-				stream << "<protocol>" << escapeForXml(socket.protocol) << "</protocol>";
-				stream << "<concurrency>" << socket.concurrency << "</concurrency>";
-				stream << "<sessions>" << socket.sessions << "</sessions>";
-				stream << "</socket>";
-			}
-			stream << "</sockets>";
-		}
-	}
 };
 
 
@@ -28,7 +28,7 @@
 
 #include <vector>
 #include <oxt/macros.hpp>
-#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 #include <climits>
@@ -37,8 +37,11 @@
 #include <Logging.h>
 #include <StaticString.h>
 #include <MemoryKit/palloc.h>
+#include <Constants.h>
 #include <Utils/IOUtils.h>
+#include <Utils/SystemTime.h>
 #include <Core/ApplicationPool/Common.h>
+#include <Core/ApplicationPool/IdleConnectionStack.h>
 
 namespace Passenger {
 namespace ApplicationPool2 {
@@ -74,15 +77,33 @@ struct Connection {
 /**
  * Not thread-safe except for the connection pooling methods, so only use
  * within the ApplicationPool lock.
+ *
+ * The connection pooling methods are lock-free: idle keepalive connections
+ * are kept in an IdleConnectionStack, so request handling threads never
+ * contend on a mutex when checking out or checking in a connection. At most
+ * `concurrency` connections are kept idle. Idle connections are closed once
+ * they have been idle for more than APP_CONNECTION_IDLE_TIMEOUT seconds,
+ * either upon checkout or by `reapIdleConnections()`.
  */
 class Socket {
 private:
-	boost::mutex connectionPoolLock;
-	vector<Connection> idleConnections;
+	IdleConnectionStack<Connection> idleConnections;
+
+	static MonotonicTimeUsec now() {
+		return SystemTime::getMonotonicUsecWithGranularity<SystemTime::GRAN_10MSEC>();
+	}
 
-	OXT_FORCE_INLINE
-	int connectionPoolLimit() const {
-		return concurrency;
+	static bool idleTimeoutExpired(MonotonicTimeUsec idleSince, MonotonicTimeUsec now) {
+		return now >= idleSince + APP_CONNECTION_IDLE_TIMEOUT * 1000000ull;
+	}
+
+	void closeIdleConnection(Connection &connection) {
+		totalConnections.fetch_sub(1, boost::memory_order_relaxed);
+		try {
+			connection.close();
+		} catch (const SystemException &e) {
+			P_ERROR("Cannot close a connection with socket " << address << ": " << e.what());
+		}
 	}
 
 	Connection connect() const {
@@ -105,20 +126,24 @@ public:
 	int concurrency;
 
 	// Private. In public section as alignment optimization.
-	int totalConnections;
-	int totalIdleConnections;
+	boost::atomic<int> totalConnections;
+	boost::atomic<int> totalIdleConnections;
 
 	/** Invariant: sessions >= 0 */
 	int sessions;
 
 	Socket()
 		: pid(-1),
-		  concurrency(0)
+		  concurrency(0),
+		  totalConnections(0),
+		  totalIdleConnections(0),
+		  sessions(0)
 		{ }
 
 	Socket(pid_t _pid, const StaticString &_name, const StaticString &_address,
 		const StaticString &_protocol, int _concurrency)
-		: name(_name),
+		: idleConnections(std::max(_concurrency, 0)),
+		  name(_name),
 		  address(_address),
 		  protocol(_protocol),
 		  pid(_pid),
@@ -135,14 +160,16 @@ public:
 		  protocol(other.protocol),
 		  pid(other.pid),
 		  concurrency(other.concurrency),
-		  totalConnections(other.totalConnections),
-		  totalIdleConnections(other.totalIdleConnections),
+		  totalConnections(other.totalConnections.load(boost::memory_order_relaxed)),
+		  totalIdleConnections(other.totalIdleConnections.load(boost::memory_order_relaxed)),
 		  sessions(other.sessions)
 		{ }
 
 	Socket &operator=(const Socket &other) {
-		totalConnections = other.totalConnections;
-		totalIdleConnections = other.totalIdleConnections;
+		totalConnections.store(other.totalConnections.load(boost::memory_order_relaxed),
+			boost::memory_order_relaxed);
+		totalIdleConnections.store(other.totalIdleConnections.load(boost::memory_order_relaxed),
+			boost::memory_order_relaxed);
 		idleConnections = other.idleConnections;
 		name = other.name;
 		address = other.address;
@@ -160,62 +187,109 @@ public:
 	 * Failure to do so will result in a resource leak.
 	 */
 	Connection checkoutConnection() {
-		boost::unique_lock<boost::mutex> l(connectionPoolLock);
-
-		if (!idleConnections.empty()) {
+		Connection connection;
+		MonotonicTimeUsec idleSince;
+
+		while (idleConnections.pop(connection, idleSince)) {
+			int idle = totalIdleConnections.fetch_sub(1, boost::memory_order_relaxed) - 1;
+			if (OXT_UNLIKELY(idleTimeoutExpired(idleSince, now()))) {
+				P_TRACE(3, "Socket " << address << ": closing connection that has been "
+					"idle for too long");
+				closeIdleConnection(connection);
+				continue;
+			}
 			P_TRACE(3, "Socket " << address << ": checking out connection from connection pool (" <<
-				idleConnections.size() << " -> " << (idleConnections.size() - 1) <<
-				" items). Current total number of connections: " << totalConnections);
-			Connection connection = idleConnections.back();
-			idleConnections.pop_back();
-			totalIdleConnections--;
-			return connection;
-		} else {
-			Connection connection = connect();
-			totalConnections++;
-			P_TRACE(3, "Socket " << address << ": there are now " <<
-				totalConnections << " total connections");
-			l.unlock();
+				(idle + 1) << " -> " << idle << " items). Current total number of connections: " <<
+				totalConnections.load(boost::memory_order_relaxed));
 			return connection;
 		}
+
+		connection = connect();
+		int total = totalConnections.fetch_add(1, boost::memory_order_relaxed) + 1;
+		P_TRACE(3, "Socket " << address << ": there are now " <<
+			total << " total connections");
+		return connection;
 	}
 
 	void checkinConnection(Connection &connection) {
-		boost::unique_lock<boost::mutex> l(connectionPoolLock);
-
-		if (connection.fail || !connection.wantKeepAlive || totalIdleConnections >= connectionPoolLimit()) {
-			totalConnections--;
-			assert(totalConnections >= 0);
+		if (connection.fail || !connection.wantKeepAlive
+		 || !idleConnections.push(connection, now()))
+		{
+			int total = totalConnections.fetch_sub(1, boost::memory_order_relaxed) - 1;
+			assert(total >= 0);
 			P_TRACE(3, "Socket " << address << ": connection not checked back into "
-				"connection pool. There are now " << totalConnections <<
+				"connection pool. There are now " << total <<
 				" connections in total");
-			l.unlock();
 			connection.close();
 		} else {
+			int idle = totalIdleConnections.fetch_add(1, boost::memory_order_relaxed);
 			P_TRACE(3, "Socket " << address << ": checking in connection into connection pool (" <<
-				totalIdleConnections << " -> " << (totalIdleConnections + 1) <<
-				" items). Current total number of connections: " << totalConnections);
-			totalIdleConnections++;
-			idleConnections.push_back(connection);
+				idle << " -> " << (idle + 1) << " items). Current total number of connections: " <<
+				totalConnections.load(boost::memory_order_relaxed));
 		}
 	}
 
+	/**
+	 * Closes all idle connections that have been idle for longer than
+	 * APP_CONNECTION_IDLE_TIMEOUT. Returns the number of connections that
+	 * remain idle. Connections that are concurrently checked out or checked
+	 * in are left alone.
+	 */
+	unsigned int reapIdleConnections() {
+		SmallVector<Connection, 8> survivors;
+		SmallVector<MonotonicTimeUsec, 8> survivorIdleSince;
+		MonotonicTimeUsec currentTime = now();
+		Connection connection;
+		MonotonicTimeUsec idleSince;
+
+		while (idleConnections.pop(connection, idleSince)) {
+			totalIdleConnections.fetch_sub(1, boost::memory_order_relaxed);
+			if (idleTimeoutExpired(idleSince, currentTime)) {
+				P_TRACE(3, "Socket " << address << ": closing connection that has been "
+					"idle for too long");
+				closeIdleConnection(connection);
+			} else {
+				survivors.push_back(connection);
+				survivorIdleSince.push_back(idleSince);
+			}
+		}
+
+		// Push back in reverse order so that the most recently used
+		// connection is checked out first again.
+		unsigned int result = 0;
+		while (!survivors.empty()) {
+			if (idleConnections.push(survivors.back(), survivorIdleSince.back())) {
+				totalIdleConnections.fetch_add(1, boost::memory_order_relaxed);
+				result++;
+			} else {
+				closeIdleConnection(survivors.back());
+			}
+			survivors.pop_back();
+			survivorIdleSince.pop_back();
+		}
+		return result;
+	}
+
 	void closeAllConnections() {
-		boost::unique_lock<boost::mutex> l(connectionPoolLock);
 		assert(sessions == 0);
 		assert(totalConnections == totalIdleConnections);
-		vector<Connection>::iterator it, end = idleConnections.end();
+		Connection connection;
+		MonotonicTimeUsec idleSince;
 
-		for (it = idleConnections.begin(); it != end; it++) {
-			try {
-				it->close();
-			} catch (const SystemException &e) {
-				P_ERROR("Cannot close a connection with socket " << address << ": " << e.what());
-			}
+		while (idleConnections.pop(connection, idleSince)) {
+			totalIdleConnections.fetch_sub(1, boost::memory_order_relaxed);
+			closeIdleConnection(connection);
 		}
-		idleConnections.clear();
-		totalConnections = 0;
-		totalIdleConnections = 0;
+		assert(totalConnections == 0);
+		assert(totalIdleConnections == 0);
+	}
+
+	int getTotalConnections() const {
+		return totalConnections.load(boost::memory_order_relaxed);
+	}
+
+	int getTotalIdleConnections() const {
+		return totalIdleConnections.load(boost::memory_order_relaxed);
 	}
 
 
@@ -0,0 +1,610 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_APPLICATION_POOL2_STATE_SNAPSHOT_H_
+#define _PASSENGER_APPLICATION_POOL2_STATE_SNAPSHOT_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <string>
+#include <vector>
+#include <jsoncpp/json.h>
+#include <Utils/StrIntUtils.h>
+#include <Utils/SystemTime.h>
+#include <Utils/LatencyHistogram.h>
+#include <Utils/ProcessMetricsCollector.h>
+#include <Core/ApplicationPool/Process.h>
+#include <Core/ApplicationPool/Group.h>
+#include <Core/SpawningKit/UserSwitchingRules.h>
+
+namespace Passenger {
+namespace ApplicationPool2 {
+
+using namespace std;
+
+
+/**
+ * A copy of the state of a Process, as shown by the pool inspection functions.
+ * Unlike Process, it does not reference any memory owned by the pool, so it
+ * can be formatted without holding the pool lock.
+ */
+struct ProcessSnapshot {
+	struct SocketInfo {
+		string name;
+		string address;
+		string protocol;
+		int concurrency;
+		int sessions;
+	};
+
+	pid_t pid;
+	unsigned int stickySessionId;
+	string gupid;
+	int concurrency;
+	int sessions;
+	int busyness;
+	unsigned int processed;
+	unsigned long long spawnerCreationTime;
+	unsigned long long spawnStartTime;
+	unsigned long long spawnEndTime;
+	unsigned long long lastUsed;
+	string codeRevision;
+	Process::LifeStatus lifeStatus;
+	Process::EnabledStatus enabled;
+	ProcessMetrics metrics;
+	vector<SocketInfo> sockets;
+
+	ProcessSnapshot(const Process &process)
+		: pid(process.getPid()),
+		  stickySessionId(process.getStickySessionId()),
+		  gupid(process.getGupid().data(), process.getGupid().size()),
+		  concurrency(process.getConcurrency()),
+		  sessions(process.sessions),
+		  busyness(process.busyness()),
+		  processed(process.processed),
+		  spawnerCreationTime(process.getSpawnerCreationTime()),
+		  spawnStartTime(process.getSpawnStartTime()),
+		  spawnEndTime(process.getSpawnEndTime()),
+		  lastUsed(process.lastUsed),
+		  codeRevision(process.getCodeRevision().data(), process.getCodeRevision().size()),
+		  lifeStatus(process.lifeStatus),
+		  enabled(process.enabled),
+		  metrics(process.metrics)
+	{
+		SocketList::const_iterator it, end = process.getSockets().end();
+		for (it = process.getSockets().begin(); it != end; it++) {
+			SocketInfo info;
+			info.name = it->name.toString();
+			info.address = it->address.toString();
+			info.protocol = it->protocol.toString();
+			info.concurrency = it->concurrency;
+			info.sessions = it->sessions;
+			sockets.push_back(info);
+		}
+	}
+
+	const SocketInfo *findSocketWithName(const StaticString &name) const {
+		vector<SocketInfo>::const_iterator it, end = sockets.end();
+		for (it = sockets.begin(); it != end; it++) {
+			if (it->name == name) {
+				return &(*it);
+			}
+		}
+		return NULL;
+	}
+
+	string uptime() const {
+		return distanceOfTimeInWords(spawnEndTime / 1000000);
+	}
+
+	const char *getLifeStatusString() const {
+		switch (lifeStatus) {
+		case Process::ALIVE:
+			return "ALIVE";
+		case Process::SHUTDOWN_TRIGGERED:
+			return "SHUTDOWN_TRIGGERED";
+		case Process::DEAD:
+			return "DEAD";
+		default:
+			P_BUG("Unknown 'lifeStatus' state " << (int) lifeStatus);
+			return NULL; // Never reached
+		}
+	}
+
+	const char *getEnabledString() const {
+		switch (enabled) {
+		case Process::ENABLED:
+			return "ENABLED";
+		case Process::DISABLING:
+			return "DISABLING";
+		case Process::DISABLED:
+			return "DISABLED";
+		case Process::DETACHED:
+			return "DETACHED";
+		default:
+			P_BUG("Unknown 'enabled' state " << (int) enabled);
+			return NULL; // Never reached
+		}
+	}
+
+	template<typename Stream>
+	void inspectXml(Stream &stream, bool includeSockets = true) const {
+		stream << "<pid>" << pid << "</pid>";
+		stream << "<sticky_session_id>" << stickySessionId << "</sticky_session_id>";
+		stream << "<gupid>" << gupid << "</gupid>";
+		stream << "<concurrency>" << concurrency << "</concurrency>";
+		stream << "<sessions>" << sessions << "</sessions>";
+		stream << "<busyness>" << busyness << "</busyness>";
+		stream << "<processed>" << processed << "</processed>";
+		stream << "<spawner_creation_time>" << spawnerCreationTime << "</spawner_creation_time>";
+		stream << "<spawn_start_time>" << spawnStartTime << "</spawn_start_time>";
+		stream << "<spawn_end_time>" << spawnEndTime << "</spawn_end_time>";
+		stream << "<last_used>" << lastUsed << "</last_used>";
+		stream << "<last_used_desc>" << distanceOfTimeInWords(lastUsed / 1000000).c_str() << " ago</last_used_desc>";
+		stream << "<uptime>" << uptime() << "</uptime>";
+		if (!codeRevision.empty()) {
+			stream << "<code_revision>" << escapeForXml(codeRevision) << "</code_revision>";
+		}
+		stream << "<life_status>" << getLifeStatusString() << "</life_status>";
+		stream << "<enabled>" << getEnabledString() << "</enabled>";
+		if (metrics.isValid()) {
+			stream << "<has_metrics>true</has_metrics>";
+			stream << "<cpu>" << (int) metrics.cpu << "</cpu>";
+			stream << "<rss>" << metrics.rss << "</rss>";
+			stream << "<pss>" << metrics.pss << "</pss>";
+			stream << "<private_dirty>" << metrics.privateDirty << "</private_dirty>";
+			stream << "<swap>" << metrics.swap << "</swap>";
+			stream << "<real_memory>" << metrics.realMemory() << "</real_memory>";
+			stream << "<vmsize>" << metrics.vmsize << "</vmsize>";
+			stream << "<process_group_id>" << metrics.processGroupId << "</process_group_id>";
+			stream << "<command>" << escapeForXml(metrics.command) << "</command>";
+		}
+		if (includeSockets) {
+			vector<SocketInfo>::const_iterator it;
+
+			stream << "<sockets>";
+			for (it = sockets.begin(); it != sockets.end(); it++) {
+				const SocketInfo &socket = *it;
+				stream << "<socket>";
+				stream << "<name>" << escapeForXml(socket.name) << "</name>";
+				stream << "<address>" << escapeForXml(socket.address) << "</address>";
+				stream << "<protocol>" << escapeForXml(socket.protocol) << "</protocol>";
+				stream << "<concurrency>" << socket.concurrency << "</concurrency>";
+				stream << "<sessions>" << socket.sessions << "</sessions>";
+				stream << "</socket>";
+			}
+			stream << "</sockets>";
+		}
+	}
+
+	Json::Value inspectStateAsJson(bool includeSockets = true) const {
+		Json::Value doc;
+		doc["pid"] = (Json::Int) pid;
+		doc["sticky_session_id"] = stickySessionId;
+		doc["gupid"] = gupid;
+		doc["concurrency"] = concurrency;
+		doc["sessions"] = sessions;
+		doc["busyness"] = busyness;
+		doc["processed"] = processed;
+		doc["spawner_creation_time"] = (Json::UInt64) spawnerCreationTime;
+		doc["spawn_start_time"] = (Json::UInt64) spawnStartTime;
+		doc["spawn_end_time"] = (Json::UInt64) spawnEndTime;
+		doc["last_used"] = (Json::UInt64) lastUsed;
+		doc["last_used_desc"] = distanceOfTimeInWords(lastUsed / 1000000) + " ago";
+		doc["uptime"] = uptime();
+		if (!codeRevision.empty()) {
+			doc["code_revision"] = codeRevision;
+		}
+		doc["life_status"] = getLifeStatusString();
+		doc["enabled"] = getEnabledString();
+		if (metrics.isValid()) {
+			doc["cpu"] = (int) metrics.cpu;
+			doc["rss"] = (Json::Int64) metrics.rss;
+			doc["pss"] = (Json::Int64) metrics.pss;
+			doc["private_dirty"] = (Json::Int64) metrics.privateDirty;
+			doc["swap"] = (Json::Int64) metrics.swap;
+			doc["real_memory"] = (Json::Int64) metrics.realMemory();
+			doc["vmsize"] = (Json::Int64) metrics.vmsize;
+			doc["process_group_id"] = (Json::Int) metrics.processGroupId;
+			doc["command"] = metrics.command;
+		}
+		if (includeSockets) {
+			Json::Value socketsDoc(Json::arrayValue);
+			vector<SocketInfo>::const_iterator it;
+			for (it = sockets.begin(); it != sockets.end(); it++) {
+				Json::Value socketDoc;
+				socketDoc["name"] = it->name;
+				socketDoc["address"] = it->address;
+				socketDoc["protocol"] = it->protocol;
+				socketDoc["concurrency"] = it->concurrency;
+				socketDoc["sessions"] = it->sessions;
+				socketsDoc.append(socketDoc);
+			}
+			doc["sockets"] = socketsDoc;
+		}
+		return doc;
+	}
+};
+
+/**
+ * A copy of the state of a Group and all its processes, as shown by the
+ * pool inspection functions. See ProcessSnapshot.
+ *
+ * The user switching information is not filled in by the constructor,
+ * because looking it up may query the user database. Call
+ * `resolveUserSwitching()` after the pool lock has been released.
+ */
+struct GroupSnapshot {
+	string name;
+	string uuid;
+	ApiKey apiKey;
+	/** A persisted copy of the group's options. */
+	Options options;
+	const ResourceLocator *resourceLocator;
+
+	int enabledCount;
+	int disablingCount;
+	int disabledCount;
+	unsigned int capacityUsed;
+	unsigned int getWaitlistSize;
+	unsigned int disableWaitlistSize;
+	unsigned int processesBeingSpawned;
+	unsigned int spawnConcurrency;
+	boost::uint64_t totalProcessesSpawned;
+	unsigned int lastSpawnBurstProcessesSpawned;
+	MonotonicTimeUsec lastSpawnBurstDuration;
+	MonotonicTimeUsec lastGetWaitlistDrainTime;
+	LocalLatencyHistogram spawnDurations;
+	bool spawning;
+	bool restarting;
+	bool blueGreenRestarting;
+	Group::RestartStats lastRestartStats;
+	Group::LifeStatus lifeStatus;
+
+	double requestRate;
+	double predictedRequestRate;
+	double predictedLoad;
+	double queueTime;
+	unsigned int autoscalerMinProcesses;
+
+	bool userSwitchingResolved;
+	string username;
+	string groupname;
+	uid_t uid;
+	gid_t gid;
+
+	/** Enabled processes first, then disabling, disabled and detached ones. */
+	vector<ProcessSnapshot> processes;
+
+	GroupSnapshot(const Group &group)
+		: name(group.info.name),
+		  uuid(group.uuid),
+		  apiKey(group.getApiKey()),
+		  options(group.options.copyAndPersist()),
+		  resourceLocator(&group.getResourceLocator()),
+		  enabledCount(group.enabledCount),
+		  disablingCount(group.disablingCount),
+		  disabledCount(group.disabledCount),
+		  capacityUsed(group.capacityUsed()),
+		  getWaitlistSize(group.getWaitlist.size()),
+		  disableWaitlistSize(group.disableWaitlist.size()),
+		  processesBeingSpawned(group.processesBeingSpawned),
+		  spawnConcurrency(group.getSpawnConcurrency()),
+		  totalProcessesSpawned(group.totalProcessesSpawned),
+		  lastSpawnBurstProcessesSpawned(group.lastSpawnBurstProcessesSpawned),
+		  lastSpawnBurstDuration(group.lastSpawnBurstDuration),
+		  lastGetWaitlistDrainTime(group.lastGetWaitlistDrainTime),
+		  spawning(group.spawning()),
+		  restarting(group.restarting()),
+		  blueGreenRestarting(group.blueGreenRestarting()),
+		  lastRestartStats(group.lastRestartStats),
+		  lifeStatus((Group::LifeStatus) group.lifeStatus.load(boost::memory_order_relaxed)),
+		  requestRate(group.autoscaler.getRequestRate()),
+		  predictedRequestRate(group.autoscaler.getPredictedRequestRate()),
+		  predictedLoad(group.autoscaler.getPredictedLoad()),
+		  queueTime(group.autoscaler.getQueueTime()),
+		  autoscalerMinProcesses(group.autoscalerMinProcesses),
+		  userSwitchingResolved(false),
+		  uid((uid_t) -1),
+		  gid((gid_t) -1)
+	{
+		spawnDurations.merge(group.spawnDurations);
+		processes.reserve(group.getProcessCount() + group.detachedProcesses.size());
+		addProcesses(group.enabledProcesses);
+		addProcesses(group.disablingProcesses);
+		addProcesses(group.disabledProcesses);
+		addProcesses(group.detachedProcesses);
+	}
+
+	void addProcesses(const ProcessList &list) {
+		ProcessList::const_iterator it, end = list.end();
+		for (it = list.begin(); it != end; it++) {
+			processes.push_back(ProcessSnapshot(**it));
+		}
+	}
+
+	void resolveUserSwitching() {
+		if (!userSwitchingResolved) {
+			SpawningKit::UserSwitchingInfo usInfo(SpawningKit::prepareUserSwitching(options));
+			username = usInfo.username;
+			groupname = usInfo.groupname;
+			uid = usInfo.uid;
+			gid = usInfo.gid;
+			userSwitchingResolved = true;
+		}
+	}
+
+	/** Equivalent to `Group::authorizeByUid()`. */
+	bool authorizeByUid(uid_t uid) const {
+		assert(userSwitchingResolved);
+		return uid == 0 || this->uid == uid;
+	}
+
+	/** Equivalent to `Group::authorizeByApiKey()`. */
+	bool authorizeByApiKey(const ApiKey &key) const {
+		return key.isSuper() || key == apiKey;
+	}
+
+	const char *getLifeStatusString() const {
+		switch (lifeStatus) {
+		case Group::ALIVE:
+			return "ALIVE";
+		case Group::SHUTTING_DOWN:
+			return "SHUTTING_DOWN";
+		case Group::SHUT_DOWN:
+			return "SHUT_DOWN";
+		default:
+			P_BUG("Unknown 'lifeStatus' state " << (int) lifeStatus);
+			return NULL; // Never reached
+		}
+	}
+
+	template<typename Stream>
+	void inspectXml(Stream &stream, bool includeSecrets) const {
+		vector<ProcessSnapshot>::const_iterator it;
+
+		assert(userSwitchingResolved);
+		stream << "<name>" << escapeForXml(name) << "</name>";
+		stream << "<component_name>" << escapeForXml(name) << "</component_name>";
+		stream << "<app_root>" << escapeForXml(options.appRoot) << "</app_root>";
+		stream << "<app_type>" << escapeForXml(options.appType) << "</app_type>";
+		stream << "<environment>" << escapeForXml(options.environment) << "</environment>";
+		stream << "<uuid>" << uuid << "</uuid>";
+		stream << "<enabled_process_count>" << enabledCount << "</enabled_process_count>";
+		stream << "<disabling_process_count>" << disablingCount << "</disabling_process_count>";
+		stream << "<disabled_process_count>" << disabledCount << "</disabled_process_count>";
+		stream << "<capacity_used>" << capacityUsed << "</capacity_used>";
+		stream << "<get_wait_list_size>" << getWaitlistSize << "</get_wait_list_size>";
+		stream << "<disable_wait_list_size>" << disableWaitlistSize << "</disable_wait_list_size>";
+		stream << "<processes_being_spawned>" << processesBeingSpawned << "</processes_being_spawned>";
+		if (spawning) {
+			stream << "<spawning/>";
+		}
+		if (restarting) {
+			stream << "<restarting/>";
+		}
+		if (blueGreenRestarting) {
+			stream << "<blue_green_restarting/>";
+		}
+		stream << "<spawn_concurrency>" << spawnConcurrency << "</spawn_concurrency>";
+		stream << "<processes_spawned>" << totalProcessesSpawned << "</processes_spawned>";
+		stream << "<last_spawn_burst_processes_spawned>" << lastSpawnBurstProcessesSpawned
+			<< "</last_spawn_burst_processes_spawned>";
+		stream << "<last_spawn_burst_duration>" << lastSpawnBurstDuration
+			<< "</last_spawn_burst_duration>";
+		stream << "<last_get_wait_list_drain_time>" << lastGetWaitlistDrainTime
+			<< "</last_get_wait_list_drain_time>";
+		if (lastRestartStats.startTime != 0) {
+			stream << "<last_restart>";
+			stream << "<method>" << (lastRestartStats.blueGreen ? "blue_green" : "blocking")
+				<< "</method>";
+			stream << "<completed>" << (lastRestartStats.completed ? "true" : "false")
+				<< "</completed>";
+			stream << "<duration>" << lastRestartStats.duration << "</duration>";
+			stream << "<processes_replaced>" << lastRestartStats.processesReplaced
+				<< "</processes_replaced>";
+			stream << "<max_get_wait_list_size>" << lastRestartStats.maxGetWaitlistSize
+				<< "</max_get_wait_list_size>";
+			stream << "<max_get_wait_list_drain_time>" << lastRestartStats.maxGetWaitlistDrainTime
+				<< "</max_get_wait_list_drain_time>";
+			stream << "</last_restart>";
+		}
+		if (options.autoscale) {
+			stream << "<autoscaler>";
+			stream << "<request_rate>" << requestRate << "</request_rate>";
+			stream << "<predicted_request_rate>" << predictedRequestRate
+				<< "</predicted_request_rate>";
+			stream << "<predicted_load>" << predictedLoad << "</predicted_load>";
+			stream << "<queue_time>" << (unsigned long long) queueTime
+				<< "</queue_time>";
+			stream << "<desired_processes>" << autoscalerMinProcesses << "</desired_processes>";
+			stream << "</autoscaler>";
+		}
+		if (includeSecrets) {
+			stream << "<secret>" << escapeForXml(apiKey.toStaticString()) << "</secret>";
+			stream << "<api_key>" << escapeForXml(apiKey.toStaticString()) << "</api_key>";
+		}
+		stream << "<life_status>" << getLifeStatusString() << "</life_status>";
+
+		stream << "<user>" << escapeForXml(username) << "</user>";
+		stream << "<uid>" << uid << "</uid>";
+		stream << "<group>" << escapeForXml(groupname) << "</group>";
+		stream << "<gid>" << gid << "</gid>";
+
+		stream << "<options>";
+		options.toXml(stream, *resourceLocator);
+		stream << "</options>";
+
+		stream << "<processes>";
+		for (it = processes.begin(); it != processes.end(); it++) {
+			stream << "<process>";
+			it->inspectXml(stream, includeSecrets);
+			stream << "</process>";
+		}
+		stream << "</processes>";
+	}
+
+	Json::Value inspectStateAsJson(bool includeSecrets) const {
+		Json::Value doc;
+		vector<ProcessSnapshot>::const_iterator it;
+
+		assert(userSwitchingResolved);
+		doc["name"] = name;
+		doc["app_root"] = options.appRoot.toString();
+		doc["app_type"] = options.appType.toString();
+		doc["environment"] = options.environment.toString();
+		doc["uuid"] = uuid;
+		doc["enabled_process_count"] = enabledCount;
+		doc["disabling_process_count"] = disablingCount;
+		doc["disabled_process_count"] = disabledCount;
+		doc["capacity_used"] = capacityUsed;
+		doc["get_wait_list_size"] = getWaitlistSize;
+		doc["disable_wait_list_size"] = disableWaitlistSize;
+		doc["processes_being_spawned"] = processesBeingSpawned;
+		doc["spawning"] = spawning;
+		doc["restarting"] = restarting;
+		doc["blue_green_restarting"] = blueGreenRestarting;
+		doc["spawn_concurrency"] = spawnConcurrency;
+		doc["processes_spawned"] = (Json::UInt64) totalProcessesSpawned;
+		doc["last_spawn_burst_processes_spawned"] = lastSpawnBurstProcessesSpawned;
+		doc["last_spawn_burst_duration"] = (Json::UInt64) lastSpawnBurstDuration;
+		doc["last_get_wait_list_drain_time"] = (Json::UInt64) lastGetWaitlistDrainTime;
+		if (lastRestartStats.startTime != 0) {
+			Json::Value restartDoc;
+			restartDoc["method"] = lastRestartStats.blueGreen ? "blue_green" : "blocking";
+			restartDoc["completed"] = lastRestartStats.completed;
+			restartDoc["duration"] = (Json::UInt64) lastRestartStats.duration;
+			restartDoc["processes_replaced"] = lastRestartStats.processesReplaced;
+			restartDoc["max_get_wait_list_size"] = lastRestartStats.maxGetWaitlistSize;
+			restartDoc["max_get_wait_list_drain_time"] =
+				(Json::UInt64) lastRestartStats.maxGetWaitlistDrainTime;
+			doc["last_restart"] = restartDoc;
+		}
+		if (options.autoscale) {
+			Json::Value autoscalerDoc;
+			autoscalerDoc["request_rate"] = requestRate;
+			autoscalerDoc["predicted_request_rate"] = predictedRequestRate;
+			autoscalerDoc["predicted_load"] = predictedLoad;
+			autoscalerDoc["queue_time"] = (Json::UInt64) queueTime;
+			autoscalerDoc["desired_processes"] = autoscalerMinProcesses;
+			doc["autoscaler"] = autoscalerDoc;
+		}
+		if (includeSecrets) {
+			doc["api_key"] = apiKey.toStaticString().toString();
+		}
+		doc["life_status"] = getLifeStatusString();
+		doc["user"] = username;
+		doc["uid"] = (Json::Int) uid;
+		doc["group"] = groupname;
+		doc["gid"] = (Json::Int) gid;
+
+		Json::Value processesDoc(Json::arrayValue);
+		for (it = processes.begin(); it != processes.end(); it++) {
+			processesDoc.append(it->inspectStateAsJson(includeSecrets));
+		}
+		doc["processes"] = processesDoc;
+		return doc;
+	}
+};
+
+/**
+ * A copy of the state of the entire Pool, published by `Pool::getSnapshot()`.
+ * Snapshots are immutable once published, so any number of threads may
+ * format them concurrently.
+ */
+struct PoolSnapshot {
+	/** The value of the pool's state version at the time this snapshot was taken. */
+	boost::uint64_t version;
+	unsigned int max;
+	unsigned int maxConcurrentSpawns;
+	unsigned int processCount;
+	unsigned int capacityUsed;
+	/** The app group names of the requests in the pool's top-level getWaitlist. */
+	vector<string> getWaitlist;
+	vector<GroupSnapshot> groups;
+
+	PoolSnapshot()
+		: version(0),
+		  max(0),
+		  maxConcurrentSpawns(0),
+		  processCount(0),
+		  capacityUsed(0)
+		{ }
+
+	void resolveUserSwitching() {
+		vector<GroupSnapshot>::iterator it, end = groups.end();
+		for (it = groups.begin(); it != end; it++) {
+			it->resolveUserSwitching();
+		}
+	}
+
+	const GroupSnapshot *findGroup(const StaticString &name) const {
+		vector<GroupSnapshot>::const_iterator it, end = groups.end();
+		for (it = groups.begin(); it != end; it++) {
+			if (it->name == name) {
+				return &(*it);
+			}
+		}
+		return NULL;
+	}
+
+	/** Equivalent to `Pool::authorizeByUid()`. */
+	bool authorizeByUid(uid_t uid) const {
+		if (uid == 0 || uid == geteuid()) {
+			return true;
+		}
+
+		vector<GroupSnapshot>::const_iterator it, end = groups.end();
+		for (it = groups.begin(); it != end; it++) {
+			if (it->authorizeByUid(uid)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Equivalent to `Pool::authorizeByApiKey()`. */
+	bool authorizeByApiKey(const ApiKey &key) const {
+		if (key.isSuper()) {
+			return true;
+		}
+
+		vector<GroupSnapshot>::const_iterator it, end = groups.end();
+		for (it = groups.begin(); it != end; it++) {
+			if (it->apiKey == key) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+typedef boost::shared_ptr<const PoolSnapshot> PoolSnapshotPtr;
+
+
+} // namespace ApplicationPool2
+} // namespace Passenger
+
+#endif /* _PASSENGER_APPLICATION_POOL2_STATE_SNAPSHOT_H_ */
@@ -0,0 +1,521 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_CONFIG_PROFILE_STORE_H_
+#define _PASSENGER_CONFIG_PROFILE_STORE_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <oxt/thread.hpp>
+#include <jsoncpp/json.h>
+#include <DataStructures/HashedStaticString.h>
+#include <StaticString.h>
+#include <Constants.h>
+#include <Exceptions.h>
+#include <Logging.h>
+#include <Utils.h>
+#include <Utils/IOUtils.h>
+
+namespace Passenger {
+
+using namespace std;
+
+
+/**
+ * Web server configuration profiles, shared by all Core controller threads.
+ *
+ * The Nginx module sends a few dozen `!~PASSENGER_*` secure headers with every
+ * request, although they only change when the web server configuration changes.
+ * With config profiles, the web server registers a location's headers once by
+ * sending them together with `!~PASSENGER_REGISTER_CONFIG_PROFILE: <id>`.
+ * Subsequent requests only carry `!~PASSENGER_CONFIG_PROFILE: <id>`, and the
+ * Controller inserts the registered headers back into the request's secure
+ * header table.
+ *
+ * Profile IDs are chosen by the web server, which derives them from the
+ * profile contents. Registering an existing ID replaces the old profile.
+ * The store keeps at most `maxProfiles` profiles in memory and forgets the
+ * least recently used one when it is full.
+ *
+ * The web server only sends the compact form after the Core has acknowledged
+ * the registration, and it can't resend a request, so a reference to an
+ * unknown ID fails the request. To prevent that from happening after the
+ * Core was restarted or after a profile was forgotten, the store also writes
+ * profiles to `dir` (a directory in the instance directory, which outlives
+ * Core restarts), and loads IDs from there that aren't in memory.
+ *
+ * `lookup()` and `registerProfile()` only access memory, so that they can be
+ * called from event loops. Saving and loading is done by a background thread:
+ * if `lookup()` returns NULL, call `loadAsync()`.
+ *
+ * Profiles are immutable and reference counted, so a request may keep using
+ * a profile after it has been replaced or forgotten.
+ *
+ * This class is thread-safe.
+ */
+class ConfigProfileStore {
+public:
+	static const unsigned int DEFAULT_MAX_PROFILES = DEFAULT_MAX_CONFIG_PROFILES;
+	static const unsigned int MAX_ID_SIZE = 64;
+
+	struct Header {
+		HashedStaticString key;
+		StaticString val;
+	};
+
+	class Profile {
+	private:
+		string id;
+		string storage;
+		vector<Header> headers;
+
+	public:
+		Profile(const StaticString &_id,
+			const vector< pair<StaticString, StaticString> > &_headers)
+			: id(_id.data(), _id.size())
+		{
+			vector< pair<StaticString, StaticString> >::const_iterator it;
+			size_t size = 0;
+
+			for (it = _headers.begin(); it != _headers.end(); it++) {
+				size += it->first.size() + it->second.size();
+			}
+			// Header pointers refer into `storage`, so it must never reallocate.
+			storage.reserve(size);
+			headers.reserve(_headers.size());
+
+			for (it = _headers.begin(); it != _headers.end(); it++) {
+				Header header;
+				const char *key = storage.data() + storage.size();
+				storage.append(it->first.data(), it->first.size());
+				const char *val = storage.data() + storage.size();
+				storage.append(it->second.data(), it->second.size());
+				header.key = HashedStaticString(key, it->first.size());
+				header.val = StaticString(val, it->second.size());
+				headers.push_back(header);
+			}
+		}
+
+		const string &getId() const {
+			return id;
+		}
+
+		const vector<Header> &getHeaders() const {
+			return headers;
+		}
+	};
+
+	typedef boost::shared_ptr<const Profile> ProfilePtr;
+	typedef boost::function<void (const ProfilePtr &profile)> LoadCallback;
+
+private:
+	/**
+	 * A profile to save, or (if `profile` is NULL) an ID to load
+	 * and the callback to invoke afterwards.
+	 */
+	struct Job {
+		ProfilePtr profile;
+		string id;
+		LoadCallback callback;
+	};
+
+	/** Most recently used first. */
+	typedef list<ProfilePtr> LruList;
+	typedef map<string, LruList::iterator> ProfileMap;
+
+	mutable boost::mutex syncher;
+	LruList lru;
+	ProfileMap profiles;
+	const unsigned int maxProfiles;
+	string dir;
+
+	/** Only used if `dir` is not empty. Protected by `syncher`. */
+	oxt::thread *thr;
+	boost::condition_variable cond;
+	list<Job> jobs;
+	bool quit;
+
+	boost::atomic<boost::uint64_t> registrations;
+	boost::atomic<boost::uint64_t> loads;
+	boost::atomic<boost::uint64_t> misses;
+
+	/**
+	 * Inserts or replaces a profile and marks it as the most recently used.
+	 *
+	 * @pre syncher is locked
+	 */
+	void storeUnlocked(const ProfilePtr &profile) {
+		ProfileMap::iterator it = profiles.find(profile->getId());
+		if (it != profiles.end()) {
+			*it->second = profile;
+			lru.splice(lru.begin(), lru, it->second);
+		} else {
+			lru.push_front(profile);
+			profiles.insert(make_pair(profile->getId(), lru.begin()));
+			if (profiles.size() > maxProfiles) {
+				profiles.erase(lru.back()->getId());
+				lru.pop_back();
+			}
+		}
+	}
+
+	/**
+	 * IDs are used as filenames, so they must not contain anything that
+	 * has a special meaning in paths.
+	 */
+	static bool isPersistableId(const StaticString &id) {
+		if (id.empty() || id.size() > MAX_ID_SIZE) {
+			return false;
+		}
+		for (string::size_type i = 0; i < id.size(); i++) {
+			char ch = id[i];
+			if (!(ch >= 'a' && ch <= 'z')
+			 && !(ch >= 'A' && ch <= 'Z')
+			 && !(ch >= '0' && ch <= '9')
+			 && ch != '_' && ch != '-')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Profiles are saved as a sequence of NUL-terminated keys and values.
+	 * Header names and values can't contain NUL characters.
+	 */
+	void save(const Profile &profile) {
+		if (dir.empty() || !isPersistableId(profile.getId())) {
+			return;
+		}
+
+		const vector<Header> &headers = profile.getHeaders();
+		vector<Header>::const_iterator it;
+		string path = dir + "/" + profile.getId();
+		string tmpPath = path + ".tmp";
+		string contents;
+
+		for (it = headers.begin(); it != headers.end(); it++) {
+			contents.append(it->key.data(), it->key.size());
+			contents.append(1, '\0');
+			contents.append(it->val.data(), it->val.size());
+			contents.append(1, '\0');
+		}
+
+		try {
+			createFile(tmpPath, contents, S_IRUSR | S_IWUSR);
+		} catch (const FileSystemException &e) {
+			P_WARN("Cannot save config profile: " << e.what());
+			return;
+		}
+		if (rename(tmpPath.c_str(), path.c_str()) == -1) {
+			int e = errno;
+			P_WARN("Cannot save config profile to " << path << ": "
+				<< strerror(e) << " (errno=" << e << ")");
+			unlink(tmpPath.c_str());
+		}
+	}
+
+	ProfilePtr load(const StaticString &id) {
+		if (dir.empty() || !isPersistableId(id)) {
+			return ProfilePtr();
+		}
+
+		string path = dir + "/" + id;
+		string contents;
+		vector< pair<StaticString, StaticString> > headers;
+		string::size_type pos = 0;
+
+		if (getFileType(path) != FT_REGULAR) {
+			return ProfilePtr();
+		}
+		try {
+			contents = readAll(path);
+		} catch (const SystemException &e) {
+			P_WARN("Cannot load config profile: " << e.what());
+			return ProfilePtr();
+		}
+
+		while (pos < contents.size()) {
+			string::size_type keyEnd = contents.find('\0', pos);
+			string::size_type valEnd = (keyEnd == string::npos)
+				? string::npos
+				: contents.find('\0', keyEnd + 1);
+			if (valEnd == string::npos) {
+				P_WARN("Config profile file " << path << " is corrupt; ignoring it");
+				return ProfilePtr();
+			}
+			headers.push_back(make_pair(
+				StaticString(contents.data() + pos, keyEnd - pos),
+				StaticString(contents.data() + keyEnd + 1, valEnd - keyEnd - 1)));
+			pos = valEnd + 1;
+		}
+
+		return boost::make_shared<Profile>(id, headers);
+	}
+
+	void threadMain() {
+		boost::unique_lock<boost::mutex> l(syncher);
+
+		while (true) {
+			while (jobs.empty() && !quit) {
+				cond.wait(l);
+			}
+			if (jobs.empty()) {
+				return;
+			}
+
+			Job job = jobs.front();
+			jobs.pop_front();
+			if (job.profile != NULL) {
+				l.unlock();
+				save(*job.profile);
+				l.lock();
+				continue;
+			}
+
+			// Another request may have loaded or registered the
+			// profile while this job was queued.
+			ProfileMap::iterator it = profiles.find(job.id);
+			ProfilePtr profile;
+			if (it != profiles.end()) {
+				profile = *it->second;
+			} else {
+				l.unlock();
+				profile = load(job.id);
+				l.lock();
+				if (profile != NULL) {
+					// If the profile was registered in the mean time, the
+					// last one to store it wins, which is fine because IDs
+					// are derived from the profile contents.
+					storeUnlocked(profile);
+					loads.fetch_add(1, boost::memory_order_relaxed);
+				} else {
+					misses.fetch_add(1, boost::memory_order_relaxed);
+				}
+			}
+
+			l.unlock();
+			job.callback(profile);
+			l.lock();
+		}
+	}
+
+public:
+	/**
+	 * If `_dir` is not empty, profiles are also saved to and loaded from that
+	 * directory. It is created if it doesn't exist.
+	 */
+	ConfigProfileStore(unsigned int _maxProfiles = DEFAULT_MAX_PROFILES,
+		const string &_dir = string())
+		: maxProfiles(std::max(_maxProfiles, 1u)),
+		  dir(_dir),
+		  thr(NULL),
+		  quit(false),
+		  registrations(0),
+		  loads(0),
+		  misses(0)
+	{
+		if (!dir.empty() && mkdir(dir.c_str(), S_IRWXU) == -1 && errno != EEXIST) {
+			int e = errno;
+			P_WARN("Cannot create config profile directory " << dir << ": "
+				<< strerror(e) << " (errno=" << e << "); config profiles"
+				" will not survive a restart of the Core");
+			dir.clear();
+		}
+		if (!dir.empty()) {
+			thr = new oxt::thread(
+				boost::bind(&ConfigProfileStore::threadMain, this),
+				"Config profile store",
+				1024 * 128);
+		}
+	}
+
+	/**
+	 * Waits until all registered profiles have been saved.
+	 */
+	~ConfigProfileStore() {
+		if (thr == NULL) {
+			return;
+		}
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			list<Job>::iterator it = jobs.begin();
+			while (it != jobs.end()) {
+				if (it->profile == NULL) {
+					it = jobs.erase(it);
+				} else {
+					it++;
+				}
+			}
+			quit = true;
+			cond.notify_one();
+		}
+		thr->join();
+		delete thr;
+	}
+
+	/**
+	 * Whether the given secure header describes the request or its connection
+	 * rather than the web server configuration. Such headers are sent with
+	 * every request, so they are never stored in a profile.
+	 *
+	 * This must list every secure header that the Nginx module emits outside
+	 * of the cached location options (see `construct_request_buffer()` in
+	 * ContentHandler.c). `!~PASSENGER_APP_GROUP_NAME` is derived from the
+	 * request's document root unless it is configured explicitly, so the
+	 * Nginx module sends it with every request in both cases.
+	 */
+	static bool isRequestSpecificHeader(const StaticString &key) {
+		static const StaticString requestSpecificHeaders[] = {
+			P_STATIC_STRING("!~"),
+			P_STATIC_STRING("!~FLAGS"),
+			P_STATIC_STRING("!~DOCUMENT_ROOT"),
+			P_STATIC_STRING("!~SCRIPT_NAME"),
+			P_STATIC_STRING("!~REMOTE_ADDR"),
+			P_STATIC_STRING("!~REMOTE_PORT"),
+			P_STATIC_STRING("!~REMOTE_USER"),
+			P_STATIC_STRING("!~PASSENGER_APP_GROUP_NAME"),
+			P_STATIC_STRING("!~PASSENGER_APP_TYPE"),
+			P_STATIC_STRING("!~UNION_STATION_FILTERS"),
+			P_STATIC_STRING("!~PASSENGER_CONFIG_PROFILE"),
+			P_STATIC_STRING("!~PASSENGER_REGISTER_CONFIG_PROFILE")
+		};
+		const unsigned int count = sizeof(requestSpecificHeaders)
+			/ sizeof(requestSpecificHeaders[0]);
+
+		for (unsigned int i = 0; i < count; i++) {
+			if (key == requestSpecificHeaders[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	ProfilePtr registerProfile(const StaticString &id,
+		const vector< pair<StaticString, StaticString> > &headers)
+	{
+		ProfilePtr profile = boost::make_shared<Profile>(id, headers);
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			storeUnlocked(profile);
+			if (thr != NULL && isPersistableId(id)) {
+				Job job;
+				job.profile = profile;
+				jobs.push_back(job);
+				cond.notify_one();
+			}
+		}
+		registrations.fetch_add(1, boost::memory_order_relaxed);
+		return profile;
+	}
+
+	/**
+	 * Returns the profile with the given ID, or NULL if it is not in memory.
+	 * Never touches the profile directory; see `loadAsync()`.
+	 */
+	ProfilePtr lookup(const StaticString &id) {
+		boost::lock_guard<boost::mutex> l(syncher);
+		ProfileMap::iterator it = profiles.find(string(id.data(), id.size()));
+		if (it != profiles.end()) {
+			lru.splice(lru.begin(), lru, it->second);
+			return *it->second;
+		} else {
+			return ProfilePtr();
+		}
+	}
+
+	/**
+	 * Loads the profile with the given ID from the profile directory in the
+	 * background, and calls `callback` with it (or with NULL if there is no
+	 * such profile) from the background thread. A loaded profile is also
+	 * stored in memory.
+	 *
+	 * Returns false without calling `callback` if the profile can't possibly
+	 * be on disk, because there is no profile directory or because the ID is
+	 * not a valid filename. Callbacks that haven't been called yet when the
+	 * store is destroyed are never called.
+	 */
+	bool loadAsync(const StaticString &id, const LoadCallback &callback) {
+		if (dir.empty() || !isPersistableId(id)) {
+			misses.fetch_add(1, boost::memory_order_relaxed);
+			return false;
+		}
+
+		Job job;
+		job.id.assign(id.data(), id.size());
+		job.callback = callback;
+		boost::lock_guard<boost::mutex> l(syncher);
+		jobs.push_back(job);
+		cond.notify_one();
+		return true;
+	}
+
+	unsigned int getMaxProfiles() const {
+		return maxProfiles;
+	}
+
+	unsigned int getProfileCount() const {
+		boost::lock_guard<boost::mutex> l(syncher);
+		return profiles.size();
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		doc["count"] = getProfileCount();
+		doc["max"] = maxProfiles;
+		if (dir.empty()) {
+			doc["dir"] = Json::Value(Json::nullValue);
+		} else {
+			doc["dir"] = dir;
+		}
+		doc["registrations"] = (Json::UInt64) registrations.load(boost::memory_order_relaxed);
+		doc["loads"] = (Json::UInt64) loads.load(boost::memory_order_relaxed);
+		doc["misses"] = (Json::UInt64) misses.load(boost::memory_order_relaxed);
+		return doc;
+	}
+};
+
+typedef boost::shared_ptr<ConfigProfileStore> ConfigProfileStorePtr;
+
+
+} // namespace Passenger
+
+#endif /* _PASSENGER_CONFIG_PROFILE_STORE_H_ */
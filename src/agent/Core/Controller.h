@@ -30,6 +30,10 @@
 
 //#define DEBUG_CC_EVENT_LOOP_BLOCKING
 
+#if defined(__linux__)
+	#define CC_HAVE_RESPONSE_SPLICING
+#endif
+
 #define CC_BENCHMARK_POINT(client, req, value) \
 	do { \
 		if (OXT_UNLIKELY(mainConfigCache.benchmarkMode == value)) { \
@@ -53,6 +57,7 @@
 
 #include <sys/types.h>
 #include <sys/uio.h>
+#include <fcntl.h>
 #include <utility>
 #include <typeinfo>
 #include <cstdio>
@@ -79,10 +84,12 @@
 #include <Utils/HttpConstants.h>
 #include <Utils/Timer.h>
 #include <Core/ApplicationPool/ErrorRenderer.h>
+#include <Core/ConfigProfileStore.h>
 #include <Core/Controller/Config.h>
 #include <Core/Controller/Client.h>
 #include <Core/Controller/AppResponse.h>
 #include <Core/Controller/TurboCaching.h>
+#include <Core/Controller/Metrics.h>
 #include <Core/UnionStation/Context.h>
 
 namespace Passenger {
@@ -117,6 +124,8 @@ private:
 	ControllerMainConfigCache mainConfigCache;
 	ControllerRequestConfigCachePtr requestConfigCache;
 	StringKeyTable< boost::shared_ptr<Options> > poolOptionsCache;
+	/** Thread-local cache in front of `configProfileStore`. */
+	StringKeyTable<ConfigProfileStore::ProfilePtr> configProfileCache;
 
 	HashedStaticString PASSENGER_APP_GROUP_NAME;
 	HashedStaticString PASSENGER_ENV_VARS;
@@ -130,12 +139,10 @@ private:
 	HashedStaticString REMOTE_PORT;
 	HashedStaticString REMOTE_USER;
 	HashedStaticString FLAGS;
-	HashedStaticString HTTP_COOKIE;
-	HashedStaticString HTTP_DATE;
-	HashedStaticString HTTP_HOST;
+	HashedStaticString PASSENGER_CONFIG_PROFILE;
+	HashedStaticString PASSENGER_REGISTER_CONFIG_PROFILE;
 	HashedStaticString HTTP_CONTENT_LENGTH;
 	HashedStaticString HTTP_CONTENT_TYPE;
-	HashedStaticString HTTP_EXPECT;
 	HashedStaticString HTTP_CONNECTION;
 	HashedStaticString HTTP_STATUS;
 	HashedStaticString HTTP_TRANSFER_ENCODING;
@@ -144,6 +151,15 @@ private:
 	friend class ResponseCache<Request>;
 	struct ev_check checkWatcher;
 	TurboCaching<Request> turboCaching;
+	ControllerMetrics metrics;
+
+	// Shared by all requests that forward their response body with splice().
+	// It is always empty when control returns to the event loop.
+	Pipe responseSplicingPipe;
+	bool responseSplicingSupported;
+	boost::uint64_t totalResponseBytesSpliced;
+	unsigned long totalResponsesSpliced;
+	unsigned long totalResponseSplicingFallbacks;
 
 	#ifdef DEBUG_CC_EVENT_LOOP_BLOCKING
 		struct ev_prepare prepareWatcher;
@@ -155,6 +171,18 @@ private:
 
 	struct RequestAnalysis;
 
+	bool resolveConfigProfile(Client *client, Request *req);
+	bool applyConfigProfile(Client *client, Request *req, const LString *id);
+	void configProfileLoaded(Client *client, Request *req,
+		const ConfigProfileStore::ProfilePtr &profile);
+	void onConfigProfileLoaded(Client *client, Request *req,
+		ConfigProfileStore::ProfilePtr profile);
+	void cacheConfigProfile(const ConfigProfileStore::ProfilePtr &profile);
+	void insertConfigProfileHeaders(Request *req);
+	void respondWithUnknownConfigProfile(Client *client, Request *req,
+		const LString *id);
+	void registerConfigProfile(Client *client, Request *req, const LString *id);
+	void initializeRequest(Client *client, Request *req);
 	void initializeFlags(Client *client, Request *req, RequestAnalysis &analysis);
 	bool respondFromTurboCache(Client *client, Request *req);
 	void initializePoolOptions(Client *client, Request *req, RequestAnalysis &analysis);
@@ -280,6 +308,14 @@ private:
 	void markResponsePartForTurboCaching(Client *client, Request *req,
 		const MemoryKit::mbuf &buffer);
 	void maybeThrottleAppSource(Client *client, Request *req);
+	bool maybeBeginSplicingAppResponse(Client *client, Request *req);
+	bool createResponseSplicingPipe();
+	static void _onAppSourceSpliceable(EV_P_ struct ev_io *io, int revents);
+	void spliceAppResponse(Client *client, Request *req);
+	bool forwardResponseSplicingPipe(Client *client, Request *req, size_t size);
+	void fallBackFromSplicingAppResponse(Client *client, Request *req, size_t size);
+	void discardResponseSplicingPipe(size_t size);
+	void endSplicingAppResponse(Client *client, Request *req);
 	static void _outputBuffersFlushed(FileBufferedChannel *_channel);
 	void outputBuffersFlushed(Client *client, Request *req);
 	static void _outputDataFlushed(FileBufferedChannel *_channel);
@@ -364,6 +400,10 @@ public:
 	ResourceLocator *resourceLocator;
 	PoolPtr appPool;
 	UnionStation::ContextPtr unionStationContext;
+	/** Optional. If set, the turbocache storage is shared with other controllers. */
+	ResponseCacheStorePtr turboCacheStore;
+	/** Optional. If set, web server config profiles are shared with other controllers. */
+	ConfigProfileStorePtr configProfileStore;
 
 
 	/****** Initialization and shutdown ******/
@@ -385,6 +425,7 @@ public:
 	virtual Json::Value inspectStateAsJson() const;
 	virtual Json::Value inspectClientStateAsJson(const Client *client) const;
 	virtual Json::Value inspectRequestStateAsJson(const Request *req) const;
+	void collectMetrics(MetricsSnapshot &snapshot) const;
 
 
 	/****** Miscellaneous *******/
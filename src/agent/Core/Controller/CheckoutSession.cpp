@@ -65,6 +65,7 @@ Controller::checkoutSession(Client *client, Request *req) {
 	callback.userData = req;
 
 	options.currentTime = SystemTime::getUsec();
+	req->checkoutStartedAt = SystemTime::getMonotonicUsec();
 
 	refRequest(req, __FILE__, __LINE__);
 	#ifdef DEBUG_CC_EVENT_LOOP_BLOCKING
@@ -136,10 +137,20 @@ Controller::sessionCheckedOutFromEventLoopThread(Client *client, Request *req,
 		}
 	#endif
 
+	GroupRequestMetrics *groupMetrics = metrics.lookupGroup(
+		req->options.getAppGroupName());
 	if (e == NULL) {
 		SKC_DEBUG(client, "Session checked out: pid=" << session->getPid() <<
 			", gupid=" << session->getGupid());
 		req->session = session;
+		req->sessionCheckedOutAt = SystemTime::getMonotonicUsec();
+		if (groupMetrics != NULL && req->sessionCheckoutTry == 0) {
+			groupMetrics->requests++;
+			groupMetrics->preCheckoutTime.record(
+				req->checkoutStartedAt - req->beganAt);
+			groupMetrics->queueTime.record(
+				req->sessionCheckedOutAt - req->checkoutStartedAt);
+		}
 		UPDATE_TRACE_POINT();
 		maybeSend100Continue(client, req);
 		UPDATE_TRACE_POINT();
@@ -147,6 +158,9 @@ Controller::sessionCheckedOutFromEventLoopThread(Client *client, Request *req,
 	} else {
 		UPDATE_TRACE_POINT();
 		req->endStopwatchLog(&req->stopwatchLogs.getFromPool, false);
+		if (groupMetrics != NULL) {
+			groupMetrics->checkoutErrors++;
+		}
 		reportSessionCheckoutError(client, req, e);
 	}
 }
@@ -157,7 +171,7 @@ Controller::maybeSend100Continue(Client *client, Request *req) {
 	if (httpVersion >= 1010 && req->hasBody() && !req->strip100ContinueHeader) {
 		// Apps with the "session" protocol don't respond with 100-Continue,
 		// so we do it for them.
-		const LString *value = req->headers.lookup(HTTP_EXPECT);
+		const LString *value = req->headers.lookup(ServerKit::WKH_EXPECT);
 		if (value != NULL
 		 && psg_lstr_cmp(value, P_STATIC_STRING("100-continue"))
 		 && req->session->getProtocol() == P_STATIC_STRING("session"))
@@ -84,6 +84,7 @@ private:
 		add("show_version_in_header", BOOL_TYPE, OPTIONAL, true);
 		add("data_buffer_dir", STRING_TYPE, OPTIONAL, getSystemTempDir());
 		add("response_buffer_high_watermark", UINT_TYPE, OPTIONAL, DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK);
+		add("response_splicing_threshold", UINT_TYPE, OPTIONAL, DEFAULT_RESPONSE_SPLICING_THRESHOLD);
 		add("sticky_sessions", BOOL_TYPE, OPTIONAL, false);
 		add("core_graceful_exit", BOOL_TYPE, OPTIONAL, true);
 		add("benchmark_mode", STRING_TYPE, OPTIONAL);
@@ -108,10 +109,14 @@ private:
 		add("meteor_app_settings", STRING_TYPE, OPTIONAL);
 		add("app_file_descriptor_ulimit", UINT_TYPE, OPTIONAL);
 		add("min_instances", UINT_TYPE, OPTIONAL, 1);
+		add("spawn_concurrency", UINT_TYPE, OPTIONAL, 1);
+		add("autoscale", BOOL_TYPE, OPTIONAL, false);
 		add("max_preloader_idle_time", UINT_TYPE, OPTIONAL, DEFAULT_MAX_PRELOADER_IDLE_TIME);
 		add("max_request_queue_size", UINT_TYPE, OPTIONAL, DEFAULT_MAX_REQUEST_QUEUE_SIZE);
 		add("force_max_concurrent_requests_per_process", INT_TYPE, OPTIONAL, -1);
 		add("abort_websockets_on_process_shutdown", BOOL_TYPE, OPTIONAL, true);
+		add("blue_green_restarts", BOOL_TYPE, OPTIONAL, false);
+		add("restart_warmup_path", STRING_TYPE, OPTIONAL);
 		add("load_shell_envvars", BOOL_TYPE, OPTIONAL, false);
 
 		// Single app mode options
@@ -235,6 +240,7 @@ public:
 	unsigned int threadNumber;
 	unsigned int statThrottleRate;
 	unsigned int responseBufferHighWatermark;
+	unsigned int responseSplicingThreshold;
 	StaticString integrationMode;
 	StaticString serverLogName;
 	ControllerBenchmarkMode benchmarkMode: 3;
@@ -251,6 +257,7 @@ public:
 		  threadNumber(0),
 		  statThrottleRate(0),
 		  responseBufferHighWatermark(0),
+		  responseSplicingThreshold(0),
 		  benchmarkMode(BM_UNKNOWN),
 		  userSwitching(false),
 		  stickySessions(false),
@@ -278,6 +285,7 @@ public:
 		userSwitching = config["user_switching"].asBool();
 		statThrottleRate = config["stat_throttle_rate"].asUInt();
 		responseBufferHighWatermark = config["response_buffer_high_watermark"].asUInt();
+		responseSplicingThreshold = config["response_splicing_threshold"].asUInt();
 		stickySessions = config["sticky_sessions"].asBool();
 		gracefulExit = config["core_graceful_exit"].asBool();
 		benchmarkMode = parseControllerBenchmarkMode(config["benchmark_mode"].asString());
@@ -309,14 +317,18 @@ public:
 	StaticString friendlyErrorPages;
 	StaticString spawnMethod;
 	StaticString meteorAppSettings;
+	StaticString restartWarmupPath;
 	unsigned int fileDescriptorUlimit;
 	unsigned int minInstances;
+	unsigned int spawnConcurrency;
+	bool autoscale;
 	unsigned int maxPreloaderIdleTime;
 	unsigned int maxRequestQueueSize;
 	int forceMaxConcurrentRequestsPerProcess;
 	bool singleAppMode: 1;
 	bool showVersionInHeader: 1;
 	bool abortWebsocketsOnProcessShutdown;
+	bool blueGreenRestarts;
 	bool loadShellEnvvars;
 
 	/*******************/
@@ -342,14 +354,18 @@ public:
 		  friendlyErrorPages(psg_pstrdup(pool, config["friendly_error_pages"].asString())),
 		  spawnMethod(psg_pstrdup(pool, config["spawn_method"].asString())),
 		  meteorAppSettings(psg_pstrdup(pool, config["meteor_app_settings"].asString())),
+		  restartWarmupPath(psg_pstrdup(pool, config["restart_warmup_path"].asString())),
 		  fileDescriptorUlimit(config["app_file_descriptor_ulimit"].asUInt()),
 		  minInstances(config["min_instances"].asUInt()),
+		  spawnConcurrency(config["spawn_concurrency"].asUInt()),
+		  autoscale(config["autoscale"].asBool()),
 		  maxPreloaderIdleTime(config["max_preloader_idle_time"].asUInt()),
 		  maxRequestQueueSize(config["max_request_queue_size"].asUInt()),
 		  forceMaxConcurrentRequestsPerProcess(config["force_max_concurrent_requests_per_process"].asInt()),
 		  singleAppMode(!config["multi_app"].asBool()),
 		  showVersionInHeader(config["show_version_in_header"].asBool()),
 		  abortWebsocketsOnProcessShutdown(config["abort_websockets_on_process_shutdown"].asBool()),
+		  blueGreenRestarts(config["blue_green_restarts"].asBool()),
 		  loadShellEnvvars(config["load_shell_envvars"].asBool())
 
 		  /*******************/
@@ -165,7 +165,7 @@ Controller::onAppSourceData(Client *client, Request *req, const MemoryKit::mbuf
 						SKC_TRACE(client, 2, "End of application response body reached");
 						handleAppResponseBodyEnd(client, req);
 						endRequest(&client, &req);
-					} else {
+					} else if (!maybeBeginSplicingAppResponse(client, req)) {
 						maybeThrottleAppSource(client, req);
 					}
 				}
@@ -289,7 +289,9 @@ Controller::onAppSourceData(Client *client, Request *req, const MemoryKit::mbuf
 					buffer.start, buffer.size())) << "\"");
 			resp->bodyAlreadyRead += buffer.size();
 			writeResponseAndMarkForTurboCaching(client, req, buffer);
-			maybeThrottleAppSource(client, req);
+			if (!maybeBeginSplicingAppResponse(client, req)) {
+				maybeThrottleAppSource(client, req);
+			}
 			return Channel::Result(buffer.size(), false);
 		} else if (errcode == 0 || errcode == ECONNRESET) {
 			// EOF
@@ -327,10 +329,20 @@ Controller::onAppResponseBegin(Client *client, Request *req) {
 			ev_now(getLoop()));
 	#endif
 
+	if (req->sessionCheckedOutAt != 0) {
+		GroupRequestMetrics *groupMetrics = metrics.lookupGroup(
+			req->options.getAppGroupName());
+		req->appResponseBeganAt = SystemTime::getMonotonicUsec();
+		if (groupMetrics != NULL) {
+			groupMetrics->responseTime.record(
+				req->appResponseBeganAt - req->sessionCheckedOutAt);
+		}
+	}
+
 	// Localize hash table operations for better CPU caching.
 	oobw = resp->secureHeaders.lookup(PASSENGER_REQUEST_OOB_WORK) != NULL;
-	resp->date = resp->headers.lookup(HTTP_DATE);
-	resp->setCookie = resp->headers.lookup(ServerKit::HTTP_SET_COOKIE);
+	resp->date = resp->headers.lookup(ServerKit::WKH_DATE);
+	resp->setCookie = resp->headers.lookup(ServerKit::WKH_SET_COOKIE);
 	if (resp->setCookie != NULL) {
 		// Move the Set-Cookie header from resp->headers to resp->setCookie;
 		// remove Set-Cookie from resp->headers without deallocating it.
@@ -357,8 +369,8 @@ Controller::onAppResponseBegin(Client *client, Request *req) {
 			req->wantKeepAlive = false;
 		}
 	}
-	if (resp->headers.lookup(ServerKit::HTTP_X_SENDFILE) != NULL
-	 || resp->headers.lookup(ServerKit::HTTP_X_ACCEL_REDIRECT) != NULL)
+	if (resp->headers.lookup(ServerKit::WKH_X_SENDFILE) != NULL
+	 || resp->headers.lookup(ServerKit::WKH_X_ACCEL_REDIRECT) != NULL)
 	{
 		// If X-Sendfile or X-Accel-Redirect is set, then HttpHeaderParser
 		// treats the app response as having no body, and removes the
@@ -767,6 +779,24 @@ Controller::constructHeaderBuffersForResponse(Request *req, struct iovec *buffer
 		PUSH_STATIC_BUFFER("\r\n");
 	}
 
+	if (req->registeredConfigProfile) {
+		// Tells the web server that it may refer to this config profile
+		// by ID from now on. The web server strips this header.
+		const string &configProfileId = req->configProfile->getId();
+
+		PUSH_STATIC_BUFFER("X-Passenger-Config-Profile: ");
+
+		if (buffers != NULL) {
+			BEGIN_PUSH_NEXT_BUFFER();
+			buffers[i].iov_base = (void *) configProfileId.data();
+			buffers[i].iov_len  = configProfileId.size();
+		}
+		dataSize += configProfileId.size();
+		INC_BUFFER_ITER(i);
+
+		PUSH_STATIC_BUFFER("\r\n");
+	}
+
 	if (req->showVersionInHeader) {
 		#ifdef PASSENGER_IS_ENTERPRISE
 			PUSH_STATIC_BUFFER("X-Powered-By: " PROGRAM_NAME " Enterprise " PASSENGER_VERSION "\r\n\r\n");
@@ -1078,8 +1108,316 @@ Controller::outputDataFlushed(Client *client, Request *req) {
 	}
 }
 
+/**
+ * Switches to forwarding the rest of the app response body with splice(),
+ * so that it moves from the app socket to the client socket through a pipe
+ * without being copied into userspace. This is only done for large response
+ * bodies that we don't have to process (dechunk or turbocache), and only
+ * while the client keeps up: as long as anything is buffered in
+ * `client->output`, the regular path is used.
+ *
+ * Returns whether splicing has begun, in which case `req->appSource` has
+ * been stopped.
+ */
+bool
+Controller::maybeBeginSplicingAppResponse(Client *client, Request *req) {
+	#ifdef CC_HAVE_RESPONSE_SPLICING
+		AppResponse *resp = &req->appResponse;
+		unsigned int threshold = mainConfigCache.responseSplicingThreshold;
+
+		if (threshold == 0
+		 || req->ended()
+		 || !req->cacheKey.empty()
+		 || client->output.getTotalBytesBuffered() > 0
+		 || OXT_UNLIKELY(mainConfigCache.benchmarkMode == BM_RESPONSE_BEGIN))
+		{
+			return false;
+		}
+
+		switch (resp->httpState) {
+		case AppResponse::PARSING_BODY_WITH_LENGTH:
+			if (resp->aux.bodyInfo.contentLength - resp->bodyAlreadyRead < threshold) {
+				return false;
+			}
+			break;
+		case AppResponse::PARSING_BODY_UNTIL_EOF:
+			// The total size is unknown, so only splice responses
+			// that have proven to be large.
+			if (resp->bodyAlreadyRead < threshold) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+		}
+
+		if (!createResponseSplicingPipe()) {
+			return false;
+		}
+
+		SKC_TRACE(client, 2, "Forwarding the rest of the application response body with splice()");
+		req->appSource.stop();
+		req->splicingAppResponse = true;
+		ev_io_set(&req->appSourceSpliceWatcher, req->appSource.getFd(), EV_READ);
+		ev_io_start(getLoop(), &req->appSourceSpliceWatcher);
+		totalResponsesSpliced++;
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+bool
+Controller::createResponseSplicingPipe() {
+	if (responseSplicingPipe.first != -1) {
+		return true;
+	} else if (!responseSplicingSupported) {
+		return false;
+	}
+
+	try {
+		Pipe p = createPipe(__FILE__, __LINE__);
+		P_LOG_FILE_DESCRIPTOR_PURPOSE(p.first, "Response splicing pipe (read end)");
+		P_LOG_FILE_DESCRIPTOR_PURPOSE(p.second, "Response splicing pipe (write end)");
+		setNonBlocking(p.first);
+		setNonBlocking(p.second);
+		responseSplicingPipe = p;
+		return true;
+	} catch (const SystemException &e) {
+		P_WARN("Cannot forward response bodies with splice(): " << e.what());
+		return false;
+	}
+}
+
+void
+Controller::_onAppSourceSpliceable(EV_P_ struct ev_io *io, int revents) {
+	Request *req = static_cast<Request *>(io->data);
+	Client *client = static_cast<Client *>(req->client);
+	Controller *self = static_cast<Controller *>(getServerFromClient(client));
+	RequestRef ref(req, __FILE__, __LINE__);
+
+	SKC_LOG_EVENT_FROM_STATIC(self, Controller, client, "onAppSourceSpliceable");
+	self->spliceAppResponse(client, req);
+}
+
+void
+Controller::spliceAppResponse(Client *client, Request *req) {
+	#ifdef CC_HAVE_RESPONSE_SPLICING
+		TRACE_POINT();
+		AppResponse *resp = &req->appResponse;
+		const size_t CHUNK_SIZE = 1024 * 64;
+		// Like FdSourceChannel's burstReadCount, this bounds the amount of
+		// time that a single response may occupy the event loop.
+		const unsigned int BURST_COUNT = 4;
+
+		assert(req->splicingAppResponse);
+
+		for (unsigned int i = 0; i < BURST_COUNT; i++) {
+			size_t size = CHUNK_SIZE;
+			ssize_t ret;
+
+			if (resp->httpState == AppResponse::PARSING_BODY_WITH_LENGTH) {
+				size = (size_t) std::min<boost::uint64_t>(size,
+					resp->aux.bodyInfo.contentLength - resp->bodyAlreadyRead);
+			}
+
+			do {
+				ret = splice(req->appSource.getFd(), NULL,
+					responseSplicingPipe.second, NULL, size,
+					SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			} while (OXT_UNLIKELY(ret == -1 && errno == EINTR));
+
+			if (ret > 0) {
+				// Data
+				UPDATE_TRACE_POINT();
+				resp->bodyAlreadyRead += ret;
+				SKC_TRACE(client, 3, "Spliced " << ret << " bytes of application data");
+				if (!forwardResponseSplicingPipe(client, req, ret)) {
+					return;
+				}
+				if (resp->httpState == AppResponse::PARSING_BODY_WITH_LENGTH
+				 && resp->bodyFullyRead())
+				{
+					SKC_TRACE(client, 2, "End of application response body reached");
+					endSplicingAppResponse(client, req);
+					handleAppResponseBodyEnd(client, req);
+					endRequest(&client, &req);
+					return;
+				}
+				if ((size_t) ret < size) {
+					// The next splice() will likely fail with EAGAIN.
+					return;
+				}
+			} else if (ret == 0 || errno == ECONNRESET) {
+				// EOF
+				UPDATE_TRACE_POINT();
+				endSplicingAppResponse(client, req);
+				if (resp->httpState == AppResponse::PARSING_BODY_WITH_LENGTH) {
+					SKC_WARN(client, "Application sent EOF before finishing response body: " <<
+						resp->bodyAlreadyRead << " bytes already read, " <<
+						resp->aux.bodyInfo.contentLength << " bytes expected");
+					endRequestWithAppSocketIncompleteResponse(&client, &req);
+				} else {
+					SKC_TRACE(client, 2, "Application sent EOF");
+					SKC_TRACE(client, 2, "Not keep-aliving application session connection");
+					resp->aux.bodyInfo.endReached = true;
+					req->session->close(true, false);
+					endRequest(&client, &req);
+				}
+				return;
+			} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return;
+			} else if (errno == EINVAL) {
+				// The kernel cannot splice from this kind of socket. Nothing
+				// has been transferred, so continue on the regular path.
+				UPDATE_TRACE_POINT();
+				P_INFO("Forwarding response bodies with splice() is not supported"
+					" on this system; disabling it");
+				responseSplicingSupported = false;
+				endSplicingAppResponse(client, req);
+				req->appSource.start();
+				return;
+			} else {
+				// Error
+				UPDATE_TRACE_POINT();
+				int e = errno;
+				endSplicingAppResponse(client, req);
+				endRequestWithAppSocketReadError(&client, &req, e);
+				return;
+			}
+		}
+	#endif
+}
+
+/**
+ * Moves `size` bytes, that have just been spliced into the pipe, to the
+ * client socket. Returns whether splicing can continue. If the client
+ * socket isn't writable then the remaining data is handed over to
+ * `client->output`, and forwarding continues on the regular path.
+ */
+bool
+Controller::forwardResponseSplicingPipe(Client *client, Request *req, size_t size) {
+	#ifdef CC_HAVE_RESPONSE_SPLICING
+		size_t written = 0;
+		ssize_t ret = 0;
+		int e = 0;
+
+		while (written < size) {
+			ret = splice(responseSplicingPipe.first, NULL, client->getFd(), NULL,
+				size - written, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			if (ret > 0) {
+				written += ret;
+			} else if (ret == -1 && errno == EINTR) {
+				continue;
+			} else {
+				e = errno;
+				break;
+			}
+		}
+
+		if (written > 0) {
+			req->responseBegun = true;
+			req->lastDataSendTime = ev_now(getLoop());
+			totalResponseBytesSpliced += written;
+		}
+		if (written == size) {
+			return true;
+		}
+
+		if (ret == -1 && e != EAGAIN && e != EWOULDBLOCK) {
+			discardResponseSplicingPipe(size - written);
+			endSplicingAppResponse(client, req);
+			disconnectWithClientSocketWriteError(&client, e);
+		} else {
+			fallBackFromSplicingAppResponse(client, req, size - written);
+		}
+		return false;
+	#else
+		return false;
+	#endif
+}
+
+void
+Controller::fallBackFromSplicingAppResponse(Client *client, Request *req, size_t size) {
+	TRACE_POINT();
+	AppResponse *resp = &req->appResponse;
+	MemoryKit::mbuf_pool &mbuf_pool = getContext()->mbuf_pool;
+
+	SKC_TRACE(client, 2, "Client is not keeping up with the application. Buffering "
+		"the rest of the response instead of splicing it");
+	totalResponseSplicingFallbacks++;
+	endSplicingAppResponse(client, req);
+
+	while (size > 0) {
+		MemoryKit::mbuf buffer(MemoryKit::mbuf_get(&mbuf_pool));
+		ssize_t ret;
+
+		do {
+			ret = ::read(responseSplicingPipe.first, buffer.start,
+				std::min<size_t>(size, buffer.size()));
+		} while (OXT_UNLIKELY(ret == -1 && errno == EINTR));
+		if (OXT_UNLIKELY(ret <= 0)) {
+			int e = errno;
+			P_BUG("Cannot read from the response splicing pipe: " <<
+				strerror(e) << " (errno=" << e << ")");
+		}
+
+		size -= ret;
+		writeResponse(client, MemoryKit::mbuf(buffer, 0, ret));
+		if (req->ended()) {
+			discardResponseSplicingPipe(size);
+			return;
+		}
+	}
+
+	UPDATE_TRACE_POINT();
+	if (resp->httpState == AppResponse::PARSING_BODY_WITH_LENGTH
+	 && resp->bodyFullyRead())
+	{
+		SKC_TRACE(client, 2, "End of application response body reached");
+		handleAppResponseBodyEnd(client, req);
+		endRequest(&client, &req);
+	} else {
+		req->appSource.start();
+		maybeThrottleAppSource(client, req);
+	}
+}
+
+void
+Controller::discardResponseSplicingPipe(size_t size) {
+	char buf[1024 * 16];
+	ssize_t ret;
+
+	while (size > 0) {
+		do {
+			ret = ::read(responseSplicingPipe.first, buf,
+				std::min<size_t>(size, sizeof(buf)));
+		} while (OXT_UNLIKELY(ret == -1 && errno == EINTR));
+		if (ret <= 0) {
+			break;
+		}
+		size -= ret;
+	}
+}
+
+void
+Controller::endSplicingAppResponse(Client *client, Request *req) {
+	if (req->splicingAppResponse) {
+		ev_io_stop(getLoop(), &req->appSourceSpliceWatcher);
+		req->splicingAppResponse = false;
+	}
+}
+
 void
 Controller::handleAppResponseBodyEnd(Client *client, Request *req) {
+	if (req->appResponseBeganAt != 0) {
+		GroupRequestMetrics *groupMetrics = metrics.lookupGroup(
+			req->options.getAppGroupName());
+		if (groupMetrics != NULL) {
+			groupMetrics->bodyTransferTime.record(
+				SystemTime::getMonotonicUsec() - req->appResponseBeganAt);
+		}
+	}
 	keepAliveAppConnection(client, req);
 	storeAppResponseInTurboCache(client, req);
 	finalizeUnionStationWithSuccess(client, req);
@@ -1128,17 +1466,19 @@ Controller::storeAppResponseInTurboCache(Client *client, Request *req) {
 			SKC_TRACE(client, 2, "Turbocache entries:\n" << turboCaching.responseCache.inspect());
 
 			gatherBuffers(entry.body->httpHeaderData,
-				ResponseCache<Request>::MAX_HEADER_SIZE,
+				entry.body->httpHeaderSize,
 				resp->headerCacheBuffers, resp->nHeaderCacheBuffers);
 
 			char *pos = entry.body->httpBodyData;
 			const char *end = entry.body->httpBodyData
-				+ ResponseCache<Request>::MAX_BODY_SIZE;
+				+ entry.body->httpBodySize;
 			const LString::Part *part = resp->bodyCacheBuffer.start;
 			while (part != NULL) {
 				pos = appendData(pos, end, part->data, part->size);
 				part = part->next;
 			}
+
+			turboCaching.responseCache.publish(entry);
 		} else {
 			SKC_DEBUG(client, "Could not store app response for turbocaching");
 		}
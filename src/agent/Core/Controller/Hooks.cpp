@@ -103,6 +103,8 @@ Controller::onRequestObjectCreated(Client *client, Request *req) {
 	req->appSource.setContext(getContext());
 	req->appSource.setHooks(&req->hooks);
 	req->appSource.setDataCallback(_onAppSourceData);
+	ev_io_init(&req->appSourceSpliceWatcher, _onAppSourceSpliceable, -1, EV_READ);
+	req->appSourceSpliceWatcher.data = req;
 
 	req->bodyBuffer.setContext(getContext());
 	req->bodyBuffer.setHooks(&req->hooks);
@@ -124,6 +126,10 @@ Controller::reinitializeRequest(Client *client, Request *req) {
 	// appSink and appSource are initialized in Controller::checkoutSession().
 
 	req->startedAt = 0;
+	req->beganAt = 0;
+	req->checkoutStartedAt = 0;
+	req->sessionCheckedOutAt = 0;
+	req->appResponseBeganAt = 0;
 	req->state = Request::ANALYZING_REQUEST;
 	req->dechunkResponse = false;
 	req->requestBodyBuffering = false;
@@ -134,6 +140,8 @@ Controller::reinitializeRequest(Client *client, Request *req) {
 	req->appResponseInitialized = false;
 	req->strip100ContinueHeader = false;
 	req->hasPragmaHeader = false;
+	req->splicingAppResponse = false;
+	req->registeredConfigProfile = false;
 	req->host = NULL;
 	req->configCache = requestConfigCache;
 	req->bodyBytesBuffered = 0;
@@ -156,6 +164,7 @@ void
 Controller::deinitializeRequest(Client *client, Request *req) {
 	req->session.reset();
 	req->configCache.reset();
+	req->configProfile.reset();
 
 	req->endStopwatchLog(&req->stopwatchLogs.getFromPool, false);
 	req->endStopwatchLog(&req->stopwatchLogs.bufferingRequestBody, false);
@@ -166,6 +175,7 @@ Controller::deinitializeRequest(Client *client, Request *req) {
 
 	req->appSink.setConsumedCallback(NULL);
 	req->appSink.deinitialize();
+	endSplicingAppResponse(client, req);
 	req->appSource.deinitialize();
 	req->bodyBuffer.clearBuffersFlushedCallback();
 	req->bodyBuffer.deinitialize();
@@ -53,6 +53,179 @@ struct Controller::RequestAnalysis {
 };
 
 
+/**
+ * Handles the web server config profile headers (see ConfigProfileStore).
+ * Returns false if the request has been ended, or if it is waiting for
+ * a profile to be loaded.
+ */
+bool
+Controller::resolveConfigProfile(Client *client, Request *req) {
+	const LString *id = req->secureHeaders.lookup(PASSENGER_CONFIG_PROFILE);
+	if (id != NULL && id->size > 0) {
+		return applyConfigProfile(client, req, id);
+	}
+
+	id = req->secureHeaders.lookup(PASSENGER_REGISTER_CONFIG_PROFILE);
+	if (id != NULL && id->size > 0) {
+		registerConfigProfile(client, req, id);
+	}
+	return true;
+}
+
+/**
+ * Inserts the secure headers of the referenced profile into the request.
+ * Profiles survive Core restarts and evictions from memory (see
+ * ConfigProfileStore). If the profile is not in memory then we load it
+ * in the background, and continue with `onConfigProfileLoaded()`.
+ */
+bool
+Controller::applyConfigProfile(Client *client, Request *req, const LString *id) {
+	ConfigProfileStore::ProfilePtr *cachedProfile;
+
+	id = psg_lstr_make_contiguous(id, req->pool);
+	HashedStaticString hId(id->start->data, id->size);
+
+	if (configProfileCache.lookup(hId, &cachedProfile)) {
+		req->configProfile = *cachedProfile;
+	} else {
+		req->configProfile = configProfileStore->lookup(hId);
+		if (req->configProfile == NULL) {
+			if (!configProfileStore->loadAsync(hId,
+				boost::bind(&Controller::configProfileLoaded, this,
+					client, req, _1)))
+			{
+				respondWithUnknownConfigProfile(client, req, id);
+				return false;
+			}
+			SKC_DEBUG(client, "Loading config profile \"" << cEscapeString(hId) << "\"");
+			req->bodyChannel.stop();
+			refRequest(req, __FILE__, __LINE__);
+			return false;
+		}
+		cacheConfigProfile(req->configProfile);
+	}
+
+	insertConfigProfileHeaders(req);
+	return true;
+}
+
+/**
+ * Called from the ConfigProfileStore thread.
+ */
+void
+Controller::configProfileLoaded(Client *client, Request *req,
+	const ConfigProfileStore::ProfilePtr &profile)
+{
+	getContext()->libev->runLater(boost::bind(
+		&Controller::onConfigProfileLoaded, this, client, req, profile));
+}
+
+void
+Controller::onConfigProfileLoaded(Client *client, Request *req,
+	ConfigProfileStore::ProfilePtr profile)
+{
+	SKC_LOG_EVENT(Controller, client, "onConfigProfileLoaded");
+
+	if (!req->ended()) {
+		if (profile == NULL) {
+			respondWithUnknownConfigProfile(client, req,
+				req->secureHeaders.lookup(PASSENGER_CONFIG_PROFILE));
+		} else {
+			req->configProfile = profile;
+			cacheConfigProfile(profile);
+			insertConfigProfileHeaders(req);
+			initializeRequest(client, req);
+		}
+	}
+	unrefRequest(req, __FILE__, __LINE__);
+}
+
+void
+Controller::cacheConfigProfile(const ConfigProfileStore::ProfilePtr &profile) {
+	if (configProfileCache.size() >= configProfileStore->getMaxProfiles()) {
+		configProfileCache.clear();
+	}
+	configProfileCache.insert(profile->getId(), profile);
+}
+
+/**
+ * Secure headers that the web server sent along with the request take
+ * precedence over the profile's.
+ */
+void
+Controller::insertConfigProfileHeaders(Request *req) {
+	const vector<ConfigProfileStore::Header> &profileHeaders =
+		req->configProfile->getHeaders();
+	vector<ConfigProfileStore::Header>::const_iterator it, end = profileHeaders.end();
+
+	for (it = profileHeaders.begin(); it != end; it++) {
+		if (req->secureHeaders.lookupCell(it->key) != NULL) {
+			continue;
+		}
+
+		// Secure header keys are not downcased, so `key` and `origKey`
+		// are the same. The data is owned by req->configProfile.
+		ServerKit::Header *header = (ServerKit::Header *)
+			psg_palloc(req->pool, sizeof(ServerKit::Header));
+		psg_lstr_init(&header->key);
+		psg_lstr_append(&header->key, req->pool, it->key.data(), it->key.size());
+		psg_lstr_init(&header->origKey);
+		psg_lstr_append(&header->origKey, req->pool, it->key.data(), it->key.size());
+		psg_lstr_init(&header->val);
+		psg_lstr_append(&header->val, req->pool, it->val.data(), it->val.size());
+		header->hash = it->key.hash();
+		req->secureHeaders.insert(&header, req->pool);
+	}
+}
+
+/**
+ * An unknown profile means that it could not be saved, or that the web
+ * server sent an ID that it never registered. In that case there is no
+ * way to handle the request, so we tell the web server with a 503 response,
+ * after which it falls back to registering the profile again.
+ */
+void
+Controller::respondWithUnknownConfigProfile(Client *client, Request *req,
+	const LString *id)
+{
+	id = psg_lstr_make_contiguous(id, req->pool);
+	SKC_NOTICE(client, "The web server referred to an unknown config profile (\""
+		<< cEscapeString(StaticString(id->start->data, id->size))
+		<< "\"). Asking it to register the profile again");
+	ServerKit::HeaderTable headers;
+	headers.insert(req->pool, "Cache-Control", "no-cache, no-store, must-revalidate");
+	headers.insert(req->pool, "X-Passenger-Config-Profile", "unknown");
+	writeSimpleResponse(client, 503, &headers,
+		"<h1>Service Unavailable</h1>");
+	endRequest(&client, &req);
+}
+
+void
+Controller::registerConfigProfile(Client *client, Request *req, const LString *id) {
+	vector< pair<StaticString, StaticString> > headers;
+	ServerKit::HeaderTable::Iterator it(req->secureHeaders);
+
+	while (*it != NULL) {
+		const LString *key = psg_lstr_make_contiguous(&it->header->key, req->pool);
+		StaticString skey(key->start->data, key->size);
+		if (!ConfigProfileStore::isRequestSpecificHeader(skey)) {
+			const LString *val = psg_lstr_make_contiguous(&it->header->val, req->pool);
+			headers.push_back(make_pair(skey,
+				StaticString(val->start->data, val->size)));
+		}
+		it.next();
+	}
+
+	id = psg_lstr_make_contiguous(id, req->pool);
+	req->configProfile = configProfileStore->registerProfile(
+		StaticString(id->start->data, id->size), headers);
+	req->registeredConfigProfile = true;
+	configProfileCache.insert(req->configProfile->getId(), req->configProfile);
+	SKC_DEBUG(client, "Registered config profile \"" <<
+		cEscapeString(req->configProfile->getId()) << "\" with " <<
+		headers.size() << " headers");
+}
+
 void
 Controller::initializeFlags(Client *client, Request *req, RequestAnalysis &analysis) {
 	if (analysis.flags != NULL) {
@@ -112,7 +285,9 @@ Controller::respondFromTurboCache(Client *client, Request *req) {
 	if (turboCaching.responseCache.requestAllowsFetching(req)) {
 		ResponseCache<Request>::Entry entry(turboCaching.responseCache.fetch(req,
 			ev_now(getLoop())));
+		metrics.turboCacheFetches++;
 		if (entry.valid()) {
+			metrics.turboCacheHits++;
 			SKC_TRACE(client, 2, "Turbocaching: cache hit (key \"" <<
 				cEscapeString(req->cacheKey) << "\")");
 			turboCaching.writeResponse(this, client, req, entry);
@@ -195,9 +370,13 @@ Controller::fillPoolOptionsFromConfigCaches(Options &options,
 	options.defaultUser = requestConfigCache->defaultUser;
 	options.defaultGroup = requestConfigCache->defaultGroup;
 	options.minProcesses = requestConfigCache->minInstances;
+	options.spawnConcurrency = requestConfigCache->spawnConcurrency;
+	options.autoscale = requestConfigCache->autoscale;
 	options.maxPreloaderIdleTime = requestConfigCache->maxPreloaderIdleTime;
 	options.maxRequestQueueSize = requestConfigCache->maxRequestQueueSize;
 	options.abortWebsocketsOnProcessShutdown = requestConfigCache->abortWebsocketsOnProcessShutdown;
+	options.blueGreenRestart = requestConfigCache->blueGreenRestarts;
+	options.restartWarmupPath = requestConfigCache->restartWarmupPath;
 	options.forceMaxConcurrentRequestsPerProcess = requestConfigCache->forceMaxConcurrentRequestsPerProcess;
 	options.spawnMethod = requestConfigCache->spawnMethod;
 	options.loadShellEnvvars = requestConfigCache->loadShellEnvvars;
@@ -360,12 +539,16 @@ Controller::createNewPoolOptions(Client *client, Request *req,
 	fillPoolOption(req, options.group, "!~PASSENGER_GROUP");
 	fillPoolOption(req, options.minProcesses, "!~PASSENGER_MIN_PROCESSES");
 	fillPoolOption(req, options.maxProcesses, "!~PASSENGER_MAX_PROCESSES");
+	fillPoolOption(req, options.spawnConcurrency, "!~PASSENGER_SPAWN_CONCURRENCY");
+	fillPoolOption(req, options.autoscale, "!~PASSENGER_AUTOSCALE");
 	fillPoolOption(req, options.spawnMethod, "!~PASSENGER_SPAWN_METHOD");
 	fillPoolOption(req, options.startCommand, "!~PASSENGER_START_COMMAND");
 	fillPoolOptionSecToMsec(req, options.startTimeout, "!~PASSENGER_START_TIMEOUT");
 	fillPoolOption(req, options.maxPreloaderIdleTime, "!~PASSENGER_MAX_PRELOADER_IDLE_TIME");
 	fillPoolOption(req, options.maxRequestQueueSize, "!~PASSENGER_MAX_REQUEST_QUEUE_SIZE");
 	fillPoolOption(req, options.abortWebsocketsOnProcessShutdown, "!~PASSENGER_ABORT_WEBSOCKETS_ON_PROCESS_SHUTDOWN");
+	fillPoolOption(req, options.blueGreenRestart, "!~PASSENGER_BLUE_GREEN_RESTART");
+	fillPoolOption(req, options.restartWarmupPath, "!~PASSENGER_RESTART_WARMUP_PATH");
 	fillPoolOption(req, options.forceMaxConcurrentRequestsPerProcess, "!~PASSENGER_FORCE_MAX_CONCURRENT_REQUESTS_PER_PROCESS");
 	fillPoolOption(req, options.restartDir, "!~PASSENGER_RESTART_DIR");
 	fillPoolOption(req, options.startupFile, "!~PASSENGER_STARTUP_FILE");
@@ -423,7 +606,7 @@ Controller::setStickySessionId(Client *client, Request *req) {
 		// TODO: This is not entirely correct. Clients MAY send multiple Cookie
 		// headers, although this is in practice extremely rare.
 		// http://stackoverflow.com/questions/16305814/are-multiple-cookie-headers-allowed-in-an-http-request
-		const LString *cookieHeader = req->headers.lookup(HTTP_COOKIE);
+		const LString *cookieHeader = req->headers.lookup(ServerKit::WKH_COOKIE);
 		if (cookieHeader != NULL && cookieHeader->size > 0) {
 			const LString *cookieName = getStickySessionCookieName(req);
 			vector< pair<StaticString, StaticString> > cookies;
@@ -452,20 +635,8 @@ Controller::getStickySessionCookieName(Request *req) {
 	}
 }
 
-
-/****************************
- *
- * Protected methods
- *
- ****************************/
-
-
 void
-Controller::onRequestBegin(Client *client, Request *req) {
-	ParentClass::onRequestBegin(client, req);
-
-	CC_BENCHMARK_POINT(client, req, BM_AFTER_ACCEPT);
-
+Controller::initializeRequest(Client *client, Request *req) {
 	{
 		// Perform hash table operations as close to header parsing as possible,
 		// and localize them as much as possible, for better CPU caching.
@@ -480,13 +651,14 @@ Controller::onRequestBegin(Client *client, Request *req) {
 			mainConfigCache.stickySessions);
 		req->showVersionInHeader = getBoolOption(req, PASSENGER_SHOW_VERSION_IN_HEADER,
 			req->configCache->showVersionInHeader);
-		req->host = req->headers.lookup(HTTP_HOST);
+		req->host = req->headers.lookup(ServerKit::WKH_HOST);
 
 		/***************/
 		/***************/
 
 		SKC_TRACE(client, 2, "Initiating request");
 		req->startedAt = ev_now(getLoop());
+		req->beganAt = SystemTime::getMonotonicUsec();
 		req->bodyChannel.stop();
 
 		initializeFlags(client, req, analysis);
@@ -513,5 +685,24 @@ Controller::onRequestBegin(Client *client, Request *req) {
 }
 
 
+/****************************
+ *
+ * Protected methods
+ *
+ ****************************/
+
+
+void
+Controller::onRequestBegin(Client *client, Request *req) {
+	ParentClass::onRequestBegin(client, req);
+
+	CC_BENCHMARK_POINT(client, req, BM_AFTER_ACCEPT);
+
+	if (resolveConfigProfile(client, req)) {
+		initializeRequest(client, req);
+	}
+}
+
+
 } // namespace Core
 } // namespace Passenger
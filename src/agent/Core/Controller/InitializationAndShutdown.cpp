@@ -52,6 +52,7 @@ Controller::Controller(ServerKit::Context *context, const ControllerSchema &sche
 	  mainConfigCache(config),
 	  requestConfigCache(new ControllerRequestConfigCache(config)),
 	  poolOptionsCache(4),
+	  configProfileCache(4),
 
 	  PASSENGER_APP_GROUP_NAME("!~PASSENGER_APP_GROUP_NAME"),
 	  PASSENGER_ENV_VARS("!~PASSENGER_ENV_VARS"),
@@ -65,17 +66,19 @@ Controller::Controller(ServerKit::Context *context, const ControllerSchema &sche
 	  REMOTE_PORT("!~REMOTE_PORT"),
 	  REMOTE_USER("!~REMOTE_USER"),
 	  FLAGS("!~FLAGS"),
-	  HTTP_COOKIE("cookie"),
-	  HTTP_DATE("date"),
-	  HTTP_HOST("host"),
+	  PASSENGER_CONFIG_PROFILE("!~PASSENGER_CONFIG_PROFILE"),
+	  PASSENGER_REGISTER_CONFIG_PROFILE("!~PASSENGER_REGISTER_CONFIG_PROFILE"),
 	  HTTP_CONTENT_LENGTH("content-length"),
 	  HTTP_CONTENT_TYPE("content-type"),
-	  HTTP_EXPECT("expect"),
 	  HTTP_CONNECTION("connection"),
 	  HTTP_STATUS("status"),
 	  HTTP_TRANSFER_ENCODING("transfer-encoding"),
 
 	  turboCaching(),
+	  responseSplicingSupported(true),
+	  totalResponseBytesSpliced(0),
+	  totalResponsesSpliced(0),
+	  totalResponseSplicingFallbacks(0),
 	  resourceLocator(NULL)
 	  /**************************/
 {
@@ -111,17 +114,30 @@ Controller::initialize() {
 	}
 
 	ParentClass::initialize();
+	if (turboCacheStore != NULL) {
+		turboCaching.responseCache.setStore(turboCacheStore);
+	}
 	turboCaching.initialize(config["turbocaching"].asBool());
+	if (configProfileStore == NULL) {
+		configProfileStore = boost::make_shared<ConfigProfileStore>();
+	}
 	getContext()->defaultFileBufferedChannelConfig.bufferDir =
 		config["data_buffer_dir"].asString();
 
 	if (requestConfigCache->singleAppMode) {
+		// Options only holds StaticStrings, so keep the strings alive
+		// until copyAndPersist() has copied them.
+		string appRoot = config["app_root"].asString();
+		string environment = config["environment"].asString();
+		string appType = config["app_type"].asString();
+		string startupFile = config["startup_file"].asString();
+
 		boost::shared_ptr<Options> options = boost::make_shared<Options>();
 		fillPoolOptionsFromConfigCaches(*options, requestConfigCache);
-		options->appRoot = config["app_root"].asString();
-		options->environment = config["environment"].asString();
-		options->appType = config["app_type"].asString();
-		options->startupFile = config["startup_file"].asString();
+		options->appRoot = appRoot;
+		options->environment = environment;
+		options->appType = appType;
+		options->startupFile = startupFile;
 		*options = options->copyAndPersist();
 		poolOptionsCache.insert(options->getAppGroupName(), options);
 	}
@@ -0,0 +1,400 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_CORE_CONTROLLER_METRICS_H_
+#define _PASSENGER_CORE_CONTROLLER_METRICS_H_
+
+#include <boost/cstdint.hpp>
+#include <oxt/macros.hpp>
+#include <string>
+#include <map>
+#include <vector>
+#include <sstream>
+#include <cstdio>
+#include <jsoncpp/json.h>
+#include <StaticString.h>
+#include <DataStructures/StringKeyTable.h>
+#include <Utils/LatencyHistogram.h>
+#include <Core/ApplicationPool/StateSnapshot.h>
+
+namespace Passenger {
+namespace Core {
+
+using namespace std;
+
+
+/**
+ * Request statistics of a single application group, as seen by one or more
+ * Controllers. Durations are in microseconds.
+ *
+ * The histograms break a request's latency down into the stages it goes
+ * through in the Controller, so that tail latency can be attributed to
+ * the Controller, the pool or the app.
+ */
+struct GroupRequestMetrics {
+	/** Number of requests for which a session was checked out. */
+	boost::uint64_t requests;
+	/** Number of requests for which session checkout failed. */
+	boost::uint64_t checkoutErrors;
+	/**
+	 * Time between receiving the request header and starting a session
+	 * checkout. Includes request body buffering.
+	 */
+	HdrLatencyHistogram preCheckoutTime;
+	/** Time between starting a session checkout and obtaining the session. */
+	HdrLatencyHistogram queueTime;
+	/**
+	 * Time between obtaining the session and the app's response header,
+	 * i.e. the app's time to first byte.
+	 */
+	HdrLatencyHistogram responseTime;
+	/** Time between the app's response header and the end of its response body. */
+	HdrLatencyHistogram bodyTransferTime;
+
+	GroupRequestMetrics()
+		: requests(0),
+		  checkoutErrors(0)
+		{ }
+
+	void merge(const GroupRequestMetrics &other) {
+		requests += other.requests;
+		checkoutErrors += other.checkoutErrors;
+		preCheckoutTime.merge(other.preCheckoutTime);
+		queueTime.merge(other.queueTime);
+		responseTime.merge(other.responseTime);
+		bodyTransferTime.merge(other.bodyTransferTime);
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		doc["requests"] = (Json::UInt64) requests;
+		doc["checkout_errors"] = (Json::UInt64) checkoutErrors;
+		doc["pre_checkout"] = preCheckoutTime.inspectStateAsJson();
+		doc["queue"] = queueTime.inspectStateAsJson();
+		doc["app_time_to_first_byte"] = responseTime.inspectStateAsJson();
+		doc["body_transfer"] = bodyTransferTime.inspectStateAsJson();
+		return doc;
+	}
+};
+
+/**
+ * A point-in-time copy of the metrics of one or more Controllers, which
+ * can be merged with copies from other Controllers and rendered in the
+ * Prometheus text exposition format.
+ */
+struct MetricsSnapshot {
+	map<string, GroupRequestMetrics> groups;
+	boost::uint64_t turboCacheFetches;
+	boost::uint64_t turboCacheHits;
+	boost::uint64_t mbufActiveBytes;
+	boost::uint64_t mbufSpareBytes;
+	boost::uint64_t fileBufferedChannelSpills;
+
+	MetricsSnapshot()
+		: turboCacheFetches(0),
+		  turboCacheHits(0),
+		  mbufActiveBytes(0),
+		  mbufSpareBytes(0),
+		  fileBufferedChannelSpills(0)
+		{ }
+
+	void merge(const MetricsSnapshot &other) {
+		map<string, GroupRequestMetrics>::const_iterator it, end = other.groups.end();
+		for (it = other.groups.begin(); it != end; it++) {
+			groups[it->first].merge(it->second);
+		}
+		turboCacheFetches += other.turboCacheFetches;
+		turboCacheHits += other.turboCacheHits;
+		mbufActiveBytes += other.mbufActiveBytes;
+		mbufSpareBytes += other.mbufSpareBytes;
+		fileBufferedChannelSpills += other.fileBufferedChannelSpills;
+	}
+
+	/**
+	 * Returns the per-group request latency breakdown as JSON, with full
+	 * histogram precision.
+	 */
+	Json::Value inspectRequestLatencyAsJson() const {
+		Json::Value doc;
+		Json::Value groupsDoc(Json::objectValue);
+		map<string, GroupRequestMetrics>::const_iterator it, end = groups.end();
+
+		for (it = groups.begin(); it != end; it++) {
+			groupsDoc[it->first] = it->second.inspectStateAsJson();
+		}
+		doc["groups"] = groupsDoc;
+		return doc;
+	}
+
+	/**
+	 * Renders these metrics, plus the process and spawn statistics from
+	 * `pool` (if not NULL), in the Prometheus text exposition format.
+	 */
+	string toPrometheusText(const ApplicationPool2::PoolSnapshot *pool) const {
+		stringstream stream;
+		map<string, GroupRequestMetrics>::const_iterator it, end = groups.end();
+
+		writeHeader(stream, "passenger_requests_total", "counter",
+			"Number of requests for which an application session was checked out.");
+		for (it = groups.begin(); it != end; it++) {
+			stream << "passenger_requests_total{group=\"" << escapeLabelValue(it->first)
+				<< "\"} " << it->second.requests << "\n";
+		}
+
+		writeHeader(stream, "passenger_session_checkout_errors_total", "counter",
+			"Number of requests for which checking out an application session failed.");
+		for (it = groups.begin(); it != end; it++) {
+			stream << "passenger_session_checkout_errors_total{group=\""
+				<< escapeLabelValue(it->first) << "\"} "
+				<< it->second.checkoutErrors << "\n";
+		}
+
+		writeHeader(stream, "passenger_request_pre_checkout_seconds", "histogram",
+			"Time between receiving a request header and starting to check out an application session.");
+		for (it = groups.begin(); it != end; it++) {
+			writeHistogram(stream, "passenger_request_pre_checkout_seconds",
+				escapeLabelValue(it->first), it->second.preCheckoutTime);
+		}
+
+		writeHeader(stream, "passenger_request_queue_seconds", "histogram",
+			"Time that requests spent waiting for an application session.");
+		for (it = groups.begin(); it != end; it++) {
+			writeHistogram(stream, "passenger_request_queue_seconds",
+				escapeLabelValue(it->first), it->second.queueTime);
+		}
+
+		writeHeader(stream, "passenger_app_response_seconds", "histogram",
+			"Time between obtaining an application session and receiving the response header.");
+		for (it = groups.begin(); it != end; it++) {
+			writeHistogram(stream, "passenger_app_response_seconds",
+				escapeLabelValue(it->first), it->second.responseTime);
+		}
+
+		writeHeader(stream, "passenger_app_response_body_seconds", "histogram",
+			"Time between receiving the response header and the end of the response body from the application.");
+		for (it = groups.begin(); it != end; it++) {
+			writeHistogram(stream, "passenger_app_response_body_seconds",
+				escapeLabelValue(it->first), it->second.bodyTransferTime);
+		}
+
+		writeHeader(stream, "passenger_turbocache_fetches_total", "counter",
+			"Number of turbocache lookups.");
+		stream << "passenger_turbocache_fetches_total " << turboCacheFetches << "\n";
+		writeHeader(stream, "passenger_turbocache_hits_total", "counter",
+			"Number of turbocache lookups that were answered from the cache.");
+		stream << "passenger_turbocache_hits_total " << turboCacheHits << "\n";
+		writeHeader(stream, "passenger_turbocache_hit_ratio", "gauge",
+			"Fraction of turbocache lookups that were answered from the cache.");
+		stream << "passenger_turbocache_hit_ratio " << formatDouble(
+			(turboCacheFetches == 0) ? 0 : turboCacheHits / (double) turboCacheFetches)
+			<< "\n";
+
+		writeHeader(stream, "passenger_mbuf_pool_bytes", "gauge",
+			"Memory held by the mbuf pools of all request handling threads.");
+		stream << "passenger_mbuf_pool_bytes{state=\"active\"} " << mbufActiveBytes << "\n";
+		stream << "passenger_mbuf_pool_bytes{state=\"spare\"} " << mbufSpareBytes << "\n";
+
+		writeHeader(stream, "passenger_file_buffered_channel_spills_total", "counter",
+			"Number of times a buffered channel overflowed its memory buffer to disk.");
+		stream << "passenger_file_buffered_channel_spills_total "
+			<< fileBufferedChannelSpills << "\n";
+
+		if (pool != NULL) {
+			writePoolMetrics(stream, *pool);
+		}
+
+		return stream.str();
+	}
+
+	static string escapeLabelValue(const StaticString &value) {
+		string result;
+		const char *pos = value.data();
+		const char *end = value.data() + value.size();
+
+		result.reserve(value.size());
+		while (pos < end) {
+			switch (*pos) {
+			case '\\':
+				result.append("\\\\", 2);
+				break;
+			case '"':
+				result.append("\\\"", 2);
+				break;
+			case '\n':
+				result.append("\\n", 2);
+				break;
+			default:
+				result.append(1, *pos);
+				break;
+			}
+			pos++;
+		}
+		return result;
+	}
+
+private:
+	static string formatDouble(double value) {
+		char buf[64];
+		int size = snprintf(buf, sizeof(buf), "%.6f", value);
+		return string(buf, size);
+	}
+
+	static string formatUsecAsSeconds(boost::uint64_t usec) {
+		char buf[64];
+		int size = snprintf(buf, sizeof(buf), "%llu.%06llu",
+			(unsigned long long) (usec / 1000000),
+			(unsigned long long) (usec % 1000000));
+		return string(buf, size);
+	}
+
+	static void writeHeader(stringstream &stream, const char *name,
+		const char *type, const char *help)
+	{
+		stream << "# HELP " << name << " " << help << "\n";
+		stream << "# TYPE " << name << " " << type << "\n";
+	}
+
+	static void writeHistogram(stringstream &stream, const char *name,
+		const string &group, const LocalLatencyHistogram &histogram)
+	{
+		boost::uint64_t cumulative = 0;
+
+		// The last bucket has no upper bound, so it's covered by "+Inf".
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS - 1; i++) {
+			cumulative += histogram.buckets[i];
+			stream << name << "_bucket{group=\"" << group << "\",le=\""
+				<< formatUsecAsSeconds(LatencyHistogram::bucketUpperBound(i))
+				<< "\"} " << cumulative << "\n";
+		}
+		cumulative += histogram.buckets[LatencyHistogram::BUCKETS - 1];
+		stream << name << "_bucket{group=\"" << group << "\",le=\"+Inf\"} "
+			<< cumulative << "\n";
+		stream << name << "_sum{group=\"" << group << "\"} "
+			<< formatUsecAsSeconds(histogram.sum) << "\n";
+		stream << name << "_count{group=\"" << group << "\"} "
+			<< cumulative << "\n";
+	}
+
+	static void writeHistogram(stringstream &stream, const char *name,
+		const string &group, const HdrLatencyHistogram &histogram)
+	{
+		LocalLatencyHistogram collapsed;
+		histogram.collapseInto(collapsed);
+		writeHistogram(stream, name, group, collapsed);
+	}
+
+	static void writePoolMetrics(stringstream &stream,
+		const ApplicationPool2::PoolSnapshot &pool)
+	{
+		vector<ApplicationPool2::GroupSnapshot>::const_iterator it,
+			end = pool.groups.end();
+
+		writeHeader(stream, "passenger_pool_max_processes", "gauge",
+			"Maximum number of processes in the application pool.");
+		stream << "passenger_pool_max_processes " << pool.max << "\n";
+		writeHeader(stream, "passenger_pool_capacity_used", "gauge",
+			"Number of processes in the application pool, including those being spawned.");
+		stream << "passenger_pool_capacity_used " << pool.capacityUsed << "\n";
+
+		writeHeader(stream, "passenger_group_processes", "gauge",
+			"Number of enabled, disabling and disabled processes per application group.");
+		for (it = pool.groups.begin(); it != end; it++) {
+			stream << "passenger_group_processes{group=\""
+				<< escapeLabelValue(it->name) << "\"} "
+				<< (it->enabledCount + it->disablingCount + it->disabledCount)
+				<< "\n";
+		}
+
+		writeHeader(stream, "passenger_group_get_waitlist_size", "gauge",
+			"Number of requests per application group waiting for a process to become available.");
+		for (it = pool.groups.begin(); it != end; it++) {
+			stream << "passenger_group_get_waitlist_size{group=\""
+				<< escapeLabelValue(it->name) << "\"} "
+				<< it->getWaitlistSize << "\n";
+		}
+
+		writeHeader(stream, "passenger_spawn_duration_seconds", "histogram",
+			"Time it took to spawn application processes, whether successful or not.");
+		for (it = pool.groups.begin(); it != end; it++) {
+			writeHistogram(stream, "passenger_spawn_duration_seconds",
+				escapeLabelValue(it->name), it->spawnDurations);
+		}
+	}
+};
+
+/**
+ * Metrics maintained by a single Controller. Only accessed from the
+ * Controller's event loop thread, so updating them requires no locks or
+ * atomic operations, and Controllers on different threads don't
+ * contend for the same cache lines.
+ */
+class ControllerMetrics {
+private:
+	StringKeyTable<GroupRequestMetrics> groups;
+
+public:
+	boost::uint64_t turboCacheFetches;
+	boost::uint64_t turboCacheHits;
+
+	ControllerMetrics()
+		: groups(4),
+		  turboCacheFetches(0),
+		  turboCacheHits(0)
+		{ }
+
+	/**
+	 * Returns the metrics of the given application group, creating them if
+	 * necessary. The result is only valid until the next call. Returns NULL
+	 * if the group name is too long to be tracked.
+	 */
+	GroupRequestMetrics *lookupGroup(const HashedStaticString &name) {
+		GroupRequestMetrics *result;
+
+		if (OXT_UNLIKELY(name.size() > StringKeyTable<GroupRequestMetrics>::MAX_KEY_LENGTH)) {
+			return NULL;
+		}
+		if (!groups.lookup(name, &result)) {
+			groups.insert(name, GroupRequestMetrics());
+			groups.lookup(name, &result);
+		}
+		return result;
+	}
+
+	void collect(MetricsSnapshot &snapshot) const {
+		StringKeyTable<GroupRequestMetrics>::ConstIterator it(groups);
+		while (*it != NULL) {
+			snapshot.groups[it.getKey().toString()].merge(it.getValue());
+			it.next();
+		}
+		snapshot.turboCacheFetches += turboCacheFetches;
+		snapshot.turboCacheHits += turboCacheHits;
+	}
+};
+
+
+} // namespace Core
+} // namespace Passenger
+
+#endif /* _PASSENGER_CORE_CONTROLLER_METRICS_H_ */
@@ -34,10 +34,12 @@
 #include <ServerKit/FdSinkChannel.h>
 #include <ServerKit/FdSourceChannel.h>
 #include <Logging.h>
+#include <Utils/SystemTime.h>
 #include <Core/ApplicationPool/Pool.h>
 #include <Core/UnionStation/Context.h>
 #include <Core/UnionStation/Transaction.h>
 #include <Core/UnionStation/StopwatchLog.h>
+#include <Core/ConfigProfileStore.h>
 #include <Core/Controller/Config.h>
 #include <Core/Controller/AppResponse.h>
 
@@ -68,6 +70,16 @@ public:
 	};
 
 	ev_tstamp startedAt;
+	/**
+	 * When the request header was received, when the session checkout
+	 * was started, when the session was checked out and when the app's
+	 * response header was received. For the latency breakdown metrics
+	 * in GroupRequestMetrics. 0 if the request hasn't reached that stage.
+	 */
+	MonotonicTimeUsec beganAt;
+	MonotonicTimeUsec checkoutStartedAt;
+	MonotonicTimeUsec sessionCheckedOutAt;
+	MonotonicTimeUsec appResponseBeganAt;
 
 	State state: 3;
 	bool dechunkResponse: 1;
@@ -82,6 +94,10 @@ public:
 	bool appResponseInitialized: 1;
 	bool strip100ContinueHeader: 1;
 	bool hasPragmaHeader: 1;
+	bool splicingAppResponse: 1;
+	// Whether this request registered `configProfile`, in which case the
+	// response tells the web server that it may start referring to it.
+	bool registeredConfigProfile: 1;
 
 	Options options;
 	AbstractSessionPtr session;
@@ -90,6 +106,9 @@ public:
 
 	ServerKit::FdSinkChannel appSink;
 	ServerKit::FdSourceChannel appSource;
+	// Used instead of `appSource` while the response body is forwarded
+	// with splice(). See Controller::maybeBeginSplicingAppResponse().
+	struct ev_io appSourceSpliceWatcher;
 	AppResponse appResponse;
 
 	ServerKit::FileBufferedChannel bodyBuffer;
@@ -112,6 +131,9 @@ public:
 	//
 	// This value is guaranteed to be contiguous.
 	LString *envvars;
+	// The web server config profile that this request refers to or registered.
+	// Keeps the profile data alive while `secureHeaders` points into it.
+	ConfigProfileStore::ProfilePtr configProfile;
 
 	#ifdef DEBUG_CC_EVENT_LOOP_BLOCKING
 		bool timedAppPoolGet;
@@ -336,9 +336,9 @@ Controller::determineHeaderSizeForSessionProtocol(Request *req,
 	state.remoteAddr  = req->secureHeaders.lookup(REMOTE_ADDR);
 	state.remotePort  = req->secureHeaders.lookup(REMOTE_PORT);
 	state.remoteUser  = req->secureHeaders.lookup(REMOTE_USER);
-	state.contentType   = req->headers.lookup(HTTP_CONTENT_TYPE);
+	state.contentType   = req->headers.lookup(ServerKit::WKH_CONTENT_TYPE);
 	if (req->hasBody()) {
-		state.contentLength = req->headers.lookup(HTTP_CONTENT_LENGTH);
+		state.contentLength = req->headers.lookup(ServerKit::WKH_CONTENT_LENGTH);
 	} else {
 		state.contentLength = NULL;
 	}
@@ -720,7 +720,7 @@ Controller::constructHeaderBuffersForHttpProtocol(Request *req, struct iovec *bu
 	if (!cache.cached) {
 		cache.methodStr  = http_method_str(req->method);
 		cache.remoteAddr = req->secureHeaders.lookup(REMOTE_ADDR);
-		cache.setCookie  = req->headers.lookup(ServerKit::HTTP_SET_COOKIE);
+		cache.setCookie  = req->headers.lookup(ServerKit::WKH_SET_COOKIE);
 		cache.cached     = true;
 	}
 
@@ -59,9 +59,40 @@ Controller::inspectStateAsJson() const {
 		subdoc["store_success_ratio"] = turboCaching.responseCache.getStoreSuccessRatio();
 		doc["turbocaching"] = subdoc;
 	}
+	if (configProfileStore != NULL && configProfileStore->getProfileCount() > 0) {
+		doc["config_profiles"] = configProfileStore->inspectStateAsJson();
+	}
+	#ifdef CC_HAVE_RESPONSE_SPLICING
+		if (mainConfigCache.responseSplicingThreshold > 0) {
+			Json::Value subdoc;
+			subdoc["supported"] = responseSplicingSupported;
+			subdoc["threshold"] = byteSizeToJson(mainConfigCache.responseSplicingThreshold);
+			subdoc["responses_spliced"] = (Json::UInt64) totalResponsesSpliced;
+			subdoc["bytes_spliced"] = byteSizeToJson(totalResponseBytesSpliced);
+			subdoc["fallbacks"] = (Json::UInt64) totalResponseSplicingFallbacks;
+			doc["response_splicing"] = subdoc;
+		}
+	#endif
 	return doc;
 }
 
+/**
+ * Adds this Controller's metrics to `snapshot`. Must be called from the
+ * event loop thread.
+ */
+void
+Controller::collectMetrics(MetricsSnapshot &snapshot) const {
+	const ServerKit::Context *context = getContext();
+	const struct MemoryKit::mbuf_pool &mbufPool = context->mbuf_pool;
+
+	metrics.collect(snapshot);
+	snapshot.mbufActiveBytes += (boost::uint64_t) mbufPool.nactive_mbuf_blockq
+		* mbufPool.mbuf_block_chunk_size;
+	snapshot.mbufSpareBytes += (boost::uint64_t) mbufPool.nfree_mbuf_blockq
+		* mbufPool.mbuf_block_chunk_size;
+	snapshot.fileBufferedChannelSpills += context->fileBufferedChannelSpills;
+}
+
 Json::Value
 Controller::inspectClientStateAsJson(const Client *client) const {
 	Json::Value doc = ParentClass::inspectClientStateAsJson(client);
@@ -88,6 +119,7 @@ Controller::inspectRequestStateAsJson(const Request *req) const {
 	flags["dechunk_response"] = req->dechunkResponse;
 	flags["request_body_buffering"] = req->requestBodyBuffering;
 	flags["https"] = req->https;
+	flags["splicing_app_response"] = req->splicingAppResponse;
 	doc["flags"] = flags;
 
 	if (req->requestBodyBuffering) {
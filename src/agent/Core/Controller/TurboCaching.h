@@ -48,7 +48,11 @@ using namespace std;
 template<typename Request>
 class TurboCaching {
 public:
-	/** The interval of the timer while we're in the ENABLED state. */
+	/**
+	 * The interval of the timer while we're in the ENABLED state. Upon
+	 * every timeout the statistics are evaluated and reset. Cache entries
+	 * are not cleared: they expire based on their freshness.
+	 */
 	static const unsigned int ENABLED_TIMEOUT = 2;
 	/** The interval of the timer while we're in the TEMPORARILY_DISABLED state. */
 	static const unsigned int TEMPORARY_DISABLE_TIMEOUT = 10;
@@ -105,8 +109,8 @@ private:
 		prep.entry = &entry;
 		prep.now   = (time_t) ev_now(server->getLoop());
 
-		if (prep.now >= entry.header->date) {
-			prep.age = prep.now - entry.header->date;
+		if (prep.now >= entry.body->date) {
+			prep.age = prep.now - entry.body->date;
 		} else {
 			prep.age = 0;
 		}
@@ -243,11 +247,9 @@ public:
 				state = TEMPORARILY_DISABLED;
 				nextTimeout = now + TEMPORARY_DISABLE_TIMEOUT;
 			} else {
-				P_DEBUG("Clearing turbocache");
 				nextTimeout = now + ENABLED_TIMEOUT;
 			}
 			responseCache.resetStatistics();
-			responseCache.clear();
 			break;
 		case TEMPORARILY_DISABLED:
 			P_INFO("Re-enabling turbocaching");
@@ -107,11 +107,15 @@ namespace Core {
 	struct ThreadWorkingObjects {
 		BackgroundEventLoop *bgloop;
 		ServerKit::Context *serverKitContext;
+		ServerKit::FileIoRing *fileIoRing;
+		ServerKit::BufferFilePool *bufferFilePool;
 		Controller *controller;
 
 		ThreadWorkingObjects()
 			: bgloop(NULL),
 			  serverKitContext(NULL),
+			  fileIoRing(NULL),
+			  bufferFilePool(NULL),
 			  controller(NULL)
 			{ }
 	};
@@ -131,6 +135,12 @@ namespace Core {
 
 	struct WorkingObjects {
 		int serverFds[SERVER_KIT_MAX_SERVER_ENDPOINTS];
+		/**
+		 * For addresses that are served with `--reuse-port`: one
+		 * SO_REUSEPORT server socket per core thread. The corresponding
+		 * `serverFds` entry is -1 in that case.
+		 */
+		vector<int> reusePortServerFds[SERVER_KIT_MAX_SERVER_ENDPOINTS];
 		int apiServerFds[SERVER_KIT_MAX_SERVER_ENDPOINTS];
 		string password;
 		ApiAccountDatabase apiAccountDatabase;
@@ -141,6 +151,8 @@ namespace Core {
 		SpawningKit::ConfigPtr spawningKitConfig;
 		SpawningKit::FactoryPtr spawningKitFactory;
 		PoolPtr appPool;
+		ResponseCacheStorePtr turboCacheStore;
+		ConfigProfileStorePtr configProfileStore;
 
 		ServerKit::AcceptLoadBalancer<Controller> loadBalancer;
 		ControllerSchema controllerSchema;
@@ -182,6 +194,8 @@ namespace Core {
 			vector<ThreadWorkingObjects>::iterator it, end = threadWorkingObjects.end();
 			for (it = threadWorkingObjects.begin(); it != end; it++) {
 				delete it->controller;
+				delete it->fileIoRing;
+				delete it->bufferFilePool;
 				delete it->serverKitContext;
 				delete it->bgloop;
 			}
@@ -383,6 +397,53 @@ makeFileWorldReadableAndWritable(const string &path) {
 	}
 #endif
 
+/**
+ * If `--reuse-port` is enabled and supported for the given address, creates
+ * one SO_REUSEPORT server socket per core thread for it, so that the kernel
+ * distributes clients over the threads instead of the AcceptLoadBalancer.
+ * Returns whether that succeeded.
+ */
+static bool
+createReusePortServers(unsigned int index, const string &address) {
+	TRACE_POINT();
+	WorkingObjects *wo = workingObjects;
+	unsigned int nthreads = agentsOptions->getInt("core_threads");
+
+	if (!agentsOptions->getBool("core_reuse_port") || nthreads == 1
+	 || getSocketAddressType(address) != SAT_TCP)
+	{
+		return false;
+	}
+	if (!reusePortLoadBalancingSupported()) {
+		P_WARN("--reuse-port is not supported on this platform; "
+			"using the accept load balancer for " << address);
+		return false;
+	}
+
+	vector<int> &fds = wo->reusePortServerFds[index];
+	try {
+		for (unsigned int i = 0; i < nthreads; i++) {
+			fds.push_back(createReusePortServer(address,
+				agentsOptions->getInt("socket_backlog"), __FILE__, __LINE__));
+			P_LOG_FILE_DESCRIPTOR_PURPOSE(fds.back(),
+				"Server address: " << address << " (thread " << (i + 1) << ")");
+		}
+	} catch (const SystemException &e) {
+		P_WARN("Cannot listen on " << address << " with SO_REUSEPORT: " <<
+			e.what() << ". Using the accept load balancer instead");
+		for (unsigned int i = 0; i < fds.size(); i++) {
+			close(fds[i]);
+			P_LOG_FILE_DESCRIPTOR_CLOSE(fds[i]);
+		}
+		fds.clear();
+		return false;
+	}
+
+	P_DEBUG("Listening on " << address << " with " << nthreads <<
+		" SO_REUSEPORT server sockets");
+	return true;
+}
+
 static void
 startListening() {
 	TRACE_POINT();
@@ -397,6 +458,12 @@ startListening() {
 	#endif
 
 	for (unsigned int i = 0; i < addresses.size(); i++) {
+		if (createReusePortServers(i, addresses[i])) {
+			#ifdef USE_SELINUX
+				resetSelinuxSocketContext();
+			#endif
+			continue;
+		}
 		wo->serverFds[i] = createServer(addresses[i], agentsOptions->getInt("socket_backlog"), true,
 			__FILE__, __LINE__);
 		#ifdef USE_SELINUX
@@ -664,9 +731,24 @@ initializeNonPrivilegedWorkingObjects() {
 	wo->appPool->initialize();
 	wo->appPool->setMax(options.getInt("max_pool_size"));
 	wo->appPool->setMaxIdleTime(options.getInt("pool_idle_time") * 1000000ULL);
+	wo->appPool->setMaxConcurrentSpawns(options.getInt("max_concurrent_spawns"));
 	wo->appPool->enableSelfChecking(options.getBool("selfchecks"));
 	wo->appPool->abortLongRunningConnectionsCallback = abortLongRunningConnections;
 
+	UPDATE_TRACE_POINT();
+	if (options.getBool("turbocaching")) {
+		wo->turboCacheStore = boost::make_shared<ResponseCacheStore>(
+			options.getULL("turbocache_max_size"),
+			options.getUint("turbocache_shards"),
+			ResponseCache<Core::Request>::MAX_ENTRY_SIZE);
+	}
+	{
+		string instanceDir = options.get("instance_dir", false);
+		wo->configProfileStore = boost::make_shared<ConfigProfileStore>(
+			options.getUint("max_config_profiles"),
+			instanceDir.empty() ? string() : instanceDir + "/config_profiles");
+	}
+
 	UPDATE_TRACE_POINT();
 	unsigned int nthreads = options.getInt("core_threads");
 	BackgroundEventLoop *firstLoop = NULL; // Avoid compiler warning
@@ -693,6 +775,28 @@ initializeNonPrivilegedWorkingObjects() {
 			options.get("data_buffer_dir");
 		two.serverKitContext->defaultFileBufferedChannelConfig.threshold =
 			options.getUint("file_buffer_threshold");
+		if (options.getBool("file_buffer_io_uring")) {
+			ServerKit::FileIoRing *ring = new ServerKit::FileIoRing(
+				two.bgloop->libev_loop);
+			if (ring->initialize()) {
+				two.fileIoRing = two.serverKitContext->fileIoRing = ring;
+			} else {
+				if (i == 0) {
+					P_INFO("Not using io_uring for data buffers: " <<
+						ring->getInitializationError());
+				}
+				delete ring;
+			}
+		}
+		two.bufferFilePool = new ServerKit::BufferFilePool(two.bgloop->libuv_loop,
+			options.get("data_buffer_dir"),
+			options.getUint("file_buffer_pool_size"));
+		if (two.bufferFilePool->fill() < two.bufferFilePool->capacity()) {
+			int e = errno;
+			P_WARN("Cannot pre-create buffer files in " << options.get("data_buffer_dir")
+				<< ": " << strerror(e) << " (errno=" << e << ")");
+		}
+		two.serverKitContext->bufferFilePool = two.bufferFilePool;
 
 		UPDATE_TRACE_POINT();
 		two.controller = new Core::Controller(two.serverKitContext,
@@ -702,6 +806,8 @@ initializeNonPrivilegedWorkingObjects() {
 		two.controller->resourceLocator = &wo->resourceLocator;
 		two.controller->appPool = wo->appPool;
 		two.controller->unionStationContext = wo->unionStationContext;
+		two.controller->turboCacheStore = wo->turboCacheStore;
+		two.controller->configProfileStore = wo->configProfileStore;
 		two.controller->shutdownFinishCallback = controllerShutdownFinished;
 		two.controller->initialize();
 		wo->shutdownCounter.fetch_add(1, boost::memory_order_relaxed);
@@ -741,6 +847,7 @@ initializeNonPrivilegedWorkingObjects() {
 		}
 		awo->apiServer->apiAccountDatabase = &wo->apiAccountDatabase;
 		awo->apiServer->appPool = wo->appPool;
+		awo->apiServer->turboCacheStore = wo->turboCacheStore;
 		awo->apiServer->instanceDir = options.get("instance_dir", false);
 		awo->apiServer->fdPassingPassword = options.get("watchdog_fd_passing_password", false);
 		awo->apiServer->exitEvent = &wo->exitEvent;
@@ -759,7 +866,12 @@ initializeNonPrivilegedWorkingObjects() {
 	 * This is especially noticeable on systems that heavily swap.
 	 */
 	for (unsigned int i = 0; i < addresses.size(); i++) {
-		if (nthreads == 1) {
+		if (!wo->reusePortServerFds[i].empty()) {
+			for (unsigned int j = 0; j < nthreads; j++) {
+				ThreadWorkingObjects *two = &wo->threadWorkingObjects[j];
+				two->controller->listen(wo->reusePortServerFds[i][j]);
+			}
+		} else if (nthreads == 1) {
 			ThreadWorkingObjects *two = &wo->threadWorkingObjects[0];
 			two->controller->listen(wo->serverFds[i]);
 		} else {
@@ -896,7 +1008,7 @@ mainLoop() {
 	if (wo->apiWorkingObjects.apiServer != NULL) {
 		wo->apiWorkingObjects.bgloop->start("API event loop", 0);
 	}
-	if (wo->threadWorkingObjects.size() > 1) {
+	if (wo->threadWorkingObjects.size() > 1 && wo->loadBalancer.getEndpointCount() > 0) {
 		wo->loadBalancer.start();
 	}
 	waitForExitEvent();
@@ -1058,6 +1170,9 @@ cleanup() {
 		if (wo->apiServerFds[i] != -1) {
 			close(wo->apiServerFds[i]);
 		}
+		for (unsigned int j = 0; j < wo->reusePortServerFds[i].size(); j++) {
+			close(wo->reusePortServerFds[i][j]);
+		}
 	}
 	deletePidFile();
 	delete workingObjects;
@@ -1179,6 +1294,7 @@ setAgentsOptionsDefaults() {
 	}
 	options.setDefaultStrSet("core_addresses", defaultAddress);
 	options.setDefaultInt("socket_backlog", DEFAULT_SOCKET_BACKLOG);
+	options.setDefaultBool("core_reuse_port", false);
 	options.setDefaultBool("multi_app", false);
 	options.setDefault("environment", DEFAULT_APP_ENV);
 	options.setDefault("spawn_method", DEFAULT_SPAWN_METHOD);
@@ -1190,6 +1306,9 @@ setAgentsOptionsDefaults() {
 	options.setDefaultInt("max_pool_size", DEFAULT_MAX_POOL_SIZE);
 	options.setDefaultInt("pool_idle_time", DEFAULT_POOL_IDLE_TIME);
 	options.setDefaultInt("min_instances", 1);
+	options.setDefaultInt("spawn_concurrency", 1);
+	options.setDefaultBool("autoscale", false);
+	options.setDefaultInt("max_concurrent_spawns", DEFAULT_MAX_CONCURRENT_SPAWNS);
 	options.setDefaultInt("max_preloader_idle_time", DEFAULT_MAX_PRELOADER_IDLE_TIME);
 	options.setDefaultUint("max_request_queue_size", DEFAULT_MAX_REQUEST_QUEUE_SIZE);
 	options.setDefaultUint("stat_throttle_rate", DEFAULT_STAT_THROTTLE_RATE);
@@ -1198,15 +1317,22 @@ setAgentsOptionsDefaults() {
 	options.setDefaultBool("sticky_sessions", false);
 	options.setDefault("sticky_sessions_cookie_name", DEFAULT_STICKY_SESSIONS_COOKIE_NAME);
 	options.setDefaultBool("turbocaching", true);
+	options.setDefaultULL("turbocache_max_size", DEFAULT_TURBOCACHE_MAX_SIZE);
+	options.setDefaultUint("turbocache_shards", DEFAULT_TURBOCACHE_SHARDS);
+	options.setDefaultUint("max_config_profiles", DEFAULT_MAX_CONFIG_PROFILES);
 	options.setDefault("data_buffer_dir", getSystemTempDir());
 	options.setDefaultUint("file_buffer_threshold", DEFAULT_FILE_BUFFERED_CHANNEL_THRESHOLD);
+	options.setDefaultBool("file_buffer_io_uring", true);
+	options.setDefaultUint("file_buffer_pool_size", DEFAULT_BUFFER_FILE_POOL_SIZE);
 	options.setDefaultInt("response_buffer_high_watermark", DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK);
+	options.setDefaultUint("response_splicing_threshold", DEFAULT_RESPONSE_SPLICING_THRESHOLD);
 	options.setDefaultBool("selfchecks", false);
 	options.setDefaultBool("core_graceful_exit", true);
 	options.setDefaultInt("core_threads", boost::thread::hardware_concurrency());
 	options.setDefaultBool("core_cpu_affine", false);
 	options.setDefault("friendly_error_pages", "auto");
 	options.setDefaultBool("rolling_restarts", false);
+	options.setDefaultBool("blue_green_restarts", false);
 	options.setDefaultBool("resist_deployment_errors", false);
 
 	string firstAddress = options.getStrSet("core_addresses")[0];
@@ -1326,10 +1452,26 @@ sanityCheckOptions() {
 		fprintf(stderr, "ERROR: you may only specify for --threads a number greater than or equal to 1.\n");
 		ok = false;
 	}
+	if (options.getUint("turbocache_shards") < 1) {
+		fprintf(stderr, "ERROR: you may only specify for --turbocache-shards a number greater than or equal to 1.\n");
+		ok = false;
+	}
+	if (options.getUint("max_config_profiles") < 1) {
+		fprintf(stderr, "ERROR: you may only specify for --max-config-profiles a number greater than or equal to 1.\n");
+		ok = false;
+	}
 	if (options.getInt("max_pool_size") < 1) {
 		fprintf(stderr, "ERROR: you may only specify for --max-pool-size a number greater than or equal to 1.\n");
 		ok = false;
 	}
+	if (options.getInt("spawn_concurrency") < 1) {
+		fprintf(stderr, "ERROR: you may only specify for --spawn-concurrency a number greater than or equal to 1.\n");
+		ok = false;
+	}
+	if (options.getInt("max_concurrent_spawns") < 1) {
+		fprintf(stderr, "ERROR: you may only specify for --max-concurrent-spawns a number greater than or equal to 1.\n");
+		ok = false;
+	}
 
 	if (!ok) {
 		exit(1);
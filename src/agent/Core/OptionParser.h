@@ -67,6 +67,10 @@ coreUsage() {
 	printf("                            are applicable\n");
 	printf("      --socket-backlog      Override size of the socket backlog.\n");
 	printf("                            Default: %d\n", DEFAULT_SOCKET_BACKLOG);
+	printf("      --reuse-port          Give each core thread its own SO_REUSEPORT socket\n");
+	printf("                            for TCP addresses, letting the kernel distribute\n");
+	printf("                            clients instead of a load balancer thread. Linux\n");
+	printf("                            only. Default: off\n");
 	printf("\n");
 	printf("Daemon options (optional):\n");
 	printf("      --pid-file PATH       Store the core's PID in the given file. The file\n");
@@ -129,6 +133,11 @@ coreUsage() {
 	printf("      --debugger            Enable Ruby debugger support (Enterprise only)\n");
 	printf("\n");
 	printf("      --rolling-restarts    Enable rolling restarts (Enterprise only)\n");
+	printf("      --blue-green-restarts Spawn new processes before shutting down old ones\n");
+	printf("                            when restarting an app\n");
+	printf("      --restart-warmup-path PATH\n");
+	printf("                            Path to send a warm-up request for to every new\n");
+	printf("                            process during blue/green restarts\n");
 	printf("      --resist-deployment-errors\n");
 	printf("                            Enable deployment error resistance (Enterprise only)\n");
 	printf("\n");
@@ -147,6 +156,15 @@ coreUsage() {
 	printf("                            process can handle the given number of concurrent\n");
 	printf("                            requests per process\n");
 	printf("      --min-instances N     Minimum number of application processes. Default: 1\n");
+	printf("      --spawn-concurrency N Maximum number of processes per application that\n");
+	printf("                            may be spawned at the same time. Default: 1\n");
+	printf("      --max-concurrent-spawns N\n");
+	printf("                            Maximum number of processes that may be spawned at\n");
+	printf("                            the same time, over all applications. Default: %d\n",
+		DEFAULT_MAX_CONCURRENT_SPAWNS);
+	printf("      --autoscale           Spawn processes ahead of traffic ramps and shut\n");
+	printf("                            them down based on sustained utilization instead\n");
+	printf("                            of --pool-idle-time\n");
 	printf("      --memory-limit MB     Restart application processes that go over the\n");
 	printf("                            given memory limit (Enterprise only)\n");
 	printf("\n");
@@ -166,6 +184,17 @@ coreUsage() {
 	printf("                            Vary the turbocache by the cookie of the given name\n");
 	printf("      --disable-turbocaching\n");
 	printf("                            Disable turbocaching\n");
+	printf("      --turbocache-max-size BYTES\n");
+	printf("                            Maximum amount of memory that the turbocache,\n");
+	printf("                            shared by all threads, may use. Default: %d\n",
+		DEFAULT_TURBOCACHE_MAX_SIZE);
+	printf("      --turbocache-shards NUMBER\n");
+	printf("                            Number of independently locked turbocache\n");
+	printf("                            partitions. Default: %d\n", DEFAULT_TURBOCACHE_SHARDS);
+	printf("      --max-config-profiles NUMBER\n");
+	printf("                            Maximum number of web server config profiles\n");
+	printf("                            kept in memory. Default: %d\n",
+		DEFAULT_MAX_CONFIG_PROFILES);
 	printf("      --no-abort-websockets-on-process-shutdown\n");
 	printf("                            Do not abort WebSocket connections on process\n");
 	printf("                            shutdown or restart\n");
@@ -183,6 +212,16 @@ coreUsage() {
 	printf("      --data-buffer-dir PATH\n");
 	printf("                            Directory to store data buffers in. Default:\n");
 	printf("                            %s\n", getSystemTempDir());
+	printf("      --buffer-file-pool-size NUMBER\n");
+	printf("                            Number of data buffer files that each thread keeps\n");
+	printf("                            open for reuse. 0 disables reuse. Default: %d\n",
+		DEFAULT_BUFFER_FILE_POOL_SIZE);
+	printf("      --no-io-uring         Do not use io_uring for reading and writing data\n");
+	printf("                            buffers, even if the kernel supports it\n");
+	printf("      --response-splicing-threshold BYTES\n");
+	printf("                            Forward application response bodies of at least\n");
+	printf("                            this size with splice() (Linux only). 0 disables.\n");
+	printf("                            Default: %d\n", DEFAULT_RESPONSE_SPLICING_THRESHOLD);
 	printf("      --no-graceful-exit    When exiting, exit immediately instead of waiting\n");
 	printf("                            for all connections to terminate\n");
 	printf("      --benchmark MODE      Enable benchmark mode. Available modes:\n");
@@ -267,6 +306,9 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--socket-backlog")) {
 		options.setInt("socket_backlog", atoi(argv[i + 1]));
 		i += 2;
+	} else if (p.isFlag(argv[i], '\0', "--reuse-port")) {
+		options.setBool("core_reuse_port", true);
+		i++;
 	} else if (p.isFlag(argv[i], '\0', "--no-user-switching")) {
 		options.setBool("user_switching", false);
 		i++;
@@ -278,7 +320,7 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 		i += 2;
 	} else if (p.isFlag(argv[i], '\0', "--disable-security-update-check")) {
 		options.setBool("disable_security_update_check", true);
-		i += 2;
+		i++;
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--security-update-check-proxy")) {
 		options.set("security_update_check_proxy", argv[i + 1]);
 		i += 2;
@@ -297,6 +339,15 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--min-instances")) {
 		options.setInt("min_instances", atoi(argv[i + 1]));
 		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--spawn-concurrency")) {
+		options.setInt("spawn_concurrency", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--max-concurrent-spawns")) {
+		options.setInt("max_concurrent_spawns", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isFlag(argv[i], '\0', "--autoscale")) {
+		options.setBool("autoscale", true);
+		i++;
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--memory-limit")) {
 		options.setInt("memory_limit", atoi(argv[i + 1]));
 		i += 2;
@@ -351,6 +402,15 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 	} else if (p.isFlag(argv[i], '\0', "--disable-turbocaching")) {
 		options.setBool("turbocaching", false);
 		i++;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--turbocache-max-size")) {
+		options.setULL("turbocache_max_size", stringToULL(argv[i + 1]));
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--turbocache-shards")) {
+		options.setUint("turbocache_shards", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--max-config-profiles")) {
+		options.setUint("max_config_profiles", atoi(argv[i + 1]));
+		i += 2;
 	} else if (p.isFlag(argv[i], '\0', "--no-abort-websockets-on-process-shutdown")) {
 		options.setBool("abort_websockets_on_process_shutdown", false);
 		i++;
@@ -375,6 +435,12 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 	} else if (p.isFlag(argv[i], '\0', "--rolling-restarts")) {
 		options.setBool("rolling_restarts", true);
 		i++;
+	} else if (p.isFlag(argv[i], '\0', "--blue-green-restarts")) {
+		options.setBool("blue_green_restarts", true);
+		i++;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--restart-warmup-path")) {
+		options.set("restart_warmup_path", argv[i + 1]);
+		i += 2;
 	} else if (p.isFlag(argv[i], '\0', "--resist-deployment-errors")) {
 		options.setBool("resist_deployment_errors", true);
 		i++;
@@ -402,6 +468,15 @@ parseCoreOption(int argc, const char *argv[], int &i, VariantMap &options) {
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--data-buffer-dir")) {
 		options.setInt("data_buffer_dir", atoi(argv[i + 1]));
 		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--buffer-file-pool-size")) {
+		options.setUint("file_buffer_pool_size", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isFlag(argv[i], '\0', "--no-io-uring")) {
+		options.setBool("file_buffer_io_uring", false);
+		i++;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--response-splicing-threshold")) {
+		options.setUint("response_splicing_threshold", atoi(argv[i + 1]));
+		i += 2;
 	} else if (p.isFlag(argv[i], '\0', "--no-graceful-exit")) {
 		options.setBool("core_graceful_exit", false);
 		i++;
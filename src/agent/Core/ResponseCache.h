@@ -27,12 +27,14 @@
 #define _PASSENGER_RESPONSE_CACHE_H_
 
 #include <boost/cstdint.hpp>
+#include <boost/make_shared.hpp>
 #include <time.h>
 #include <cassert>
 #include <cstring>
 #include <DataStructures/HashedStaticString.h>
 #include <ServerKit/http_parser.h>
 #include <ServerKit/CookieUtils.h>
+#include <Core/ResponseCacheStore.h>
 #include <StaticString.h>
 #include <Utils/DateParsing.h>
 #include <Utils/StrIntUtils.h>
@@ -40,6 +42,11 @@
 namespace Passenger {
 
 /**
+ * Implements the HTTP caching semantics of the turbocache. Storage is delegated
+ * to a ResponseCacheStore, which may be shared between multiple ResponseCaches
+ * (one per Core controller thread). Statistics kept by this class are local to
+ * this ResponseCache and are used by TurboCaching for its auto-disable heuristics.
+ *
  * Relevant RFCs:
  * https://tools.ietf.org/html/rfc7234    HTTP 1.1 Caching
  * https://tools.ietf.org/html/rfc2109    HTTP State Management Mechanism
@@ -47,69 +54,35 @@ namespace Passenger {
 template<typename Request>
 class ResponseCache {
 public:
-	static const unsigned int MAX_ENTRIES     = 8; // Fits in exactly 2 cache lines
 	static const unsigned int MAX_KEY_LENGTH  = 256;
 	static const unsigned int MAX_HEADER_SIZE = 4096;
 	static const unsigned int MAX_BODY_SIZE   = 1024 * 32;
 	static const unsigned int DEFAULT_HEURISTIC_FRESHNESS = 10;
 	static const unsigned int MIN_HEURISTIC_FRESHNESS = 1;
 
-	struct Header {
-		bool valid;
-		unsigned short keySize;
-		boost::uint32_t hash;
-		time_t date;
-
-		Header()
-			: valid(false),
-			  keySize(0),
-			  hash(0),
-			  date(0)
-			{ }
-	};
+	static const unsigned int MAX_ENTRY_SIZE  = MAX_KEY_LENGTH + MAX_HEADER_SIZE + MAX_BODY_SIZE;
 
-	struct Body {
-		unsigned short httpHeaderSize;
-		unsigned short httpBodySize;
-		time_t expiryDate;
-		char key[MAX_KEY_LENGTH];
-		char httpHeaderData[MAX_HEADER_SIZE];
-		// This data is dechunked.
-		char httpBodyData[MAX_BODY_SIZE];
-
-		Body()
-			: httpHeaderSize(0),
-			  httpBodySize(0),
-			  expiryDate(0)
-		{
-			key[0] = httpHeaderData[0] = httpBodyData[0] = '\0';
-		}
-	};
+	typedef ResponseCacheStore::Body Body;
 
 	struct Entry {
-		unsigned int index;
-		Header *header;
-		Body *body;
+		ResponseCacheStore::BodyPtr body;
 		enum {
 			NOT_FOUND,
 			NOT_FRESH
 		} cacheMissReason;
 
 		Entry()
-			: index(0),
-			  header(NULL),
-			  body(NULL)
+			: cacheMissReason(NOT_FOUND)
 			{ }
 
-		Entry(unsigned int i, Header *h, Body *b)
-			: index(i),
-			  header(h),
-			  body(b)
+		Entry(const ResponseCacheStore::BodyPtr &b)
+			: body(b),
+			  cacheMissReason(NOT_FOUND)
 			{ }
 
 		OXT_FORCE_INLINE
 		bool valid() const {
-			return header != NULL;
+			return body != NULL;
 		}
 
 		const char *getCacheMissReasonString() const {
@@ -126,24 +99,13 @@ public:
 
 private:
 	HashedStaticString HOST;
-	HashedStaticString CACHE_CONTROL;
-	HashedStaticString PRAGMA_CONST;
-	HashedStaticString AUTHORIZATION;
-	HashedStaticString VARY;
-	HashedStaticString WWW_AUTHENTICATE;
-	HashedStaticString X_SENDFILE;
-	HashedStaticString X_ACCEL_REDIRECT;
-	HashedStaticString EXPIRES;
-	HashedStaticString LAST_MODIFIED;
 	HashedStaticString LOCATION;
 	HashedStaticString CONTENT_LOCATION;
-	HashedStaticString COOKIE;
 	HashedStaticString PASSENGER_VARY_TURBOCACHE_BY_COOKIE;
 
 	unsigned int fetches, hits, stores, storeSuccesses;
 
-	Header headers[MAX_ENTRIES];
-	Body bodies[MAX_ENTRIES];
+	ResponseCacheStorePtr store_;
 
 	unsigned int calculateKeyLength(const LString * restrict host,
 		const LString * restrict varyCookie,
@@ -216,37 +178,6 @@ private:
 		}
 	}
 
-	Entry lookup(const HashedStaticString &cacheKey) {
-		for (unsigned int i = 0; i < MAX_ENTRIES; i++) {
-			if (headers[i].valid
-			 && headers[i].hash == cacheKey.hash()
-			 && cacheKey == StaticString(bodies[i].key, headers[i].keySize))
-			{
-				return Entry(i, &headers[i], &bodies[i]);
-			}
-		}
-		return Entry();
-	}
-
-	Entry lookupInvalidOrOldest() {
-		int oldest = -1;
-
-		for (unsigned int i = 0; i < MAX_ENTRIES; i++) {
-			if (!headers[i].valid) {
-				return Entry(i, &headers[i], &bodies[i]);
-			} else if (oldest == -1 || headers[i].date < headers[oldest].date) {
-				oldest = i;
-			}
-		}
-
-		return Entry(oldest, &headers[oldest], &bodies[oldest]);
-	}
-
-	OXT_FORCE_INLINE
-	void erase(unsigned int index) {
-		headers[index].valid = false;
-	}
-
 	time_t parseDate(psg_pool_t *pool, const LString *date, ev_tstamp now) const {
 		if (date == NULL || date->size == 0) {
 			return (time_t) now;
@@ -313,10 +244,6 @@ private:
 		return now + DEFAULT_HEURISTIC_FRESHNESS;
 	}
 
-	bool isFresh(const Entry &entry, ev_tstamp now) const {
-		return entry.body->expiryDate > now;
-	}
-
 	StaticString extractHostNameWithPortFromParsedUrl(struct http_parser_url &url,
 		const LString *value) const
 	{
@@ -402,33 +329,34 @@ private:
 		char *key = (char *) psg_pnalloc(req->pool, keySize);
 		generateKey(https, path, req->host, req->varyCookie, key, keySize);
 
-		Entry entry(lookup(StaticString(key, keySize)));
-		if (entry.valid()) {
-			entry.header->valid = false;
-		}
+		store_->erase(HashedStaticString(key, keySize));
 	}
 
 public:
 	ResponseCache()
-		: CACHE_CONTROL("cache-control"),
-		  PRAGMA_CONST("pragma"),
-		  AUTHORIZATION("authorization"),
-		  VARY("vary"),
-		  WWW_AUTHENTICATE("www-authenticate"),
-		  X_SENDFILE("x-sendfile"),
-		  X_ACCEL_REDIRECT("x-accel-redirect"),
-		  EXPIRES("expires"),
-		  LAST_MODIFIED("last-modified"),
-		  LOCATION("location"),
+		: LOCATION("location"),
 		  CONTENT_LOCATION("content-location"),
-		  COOKIE("cookie"),
 		  PASSENGER_VARY_TURBOCACHE_BY_COOKIE("!~PASSENGER_VARY_TURBOCACHE_COOKIE"),
 		  fetches(0),
 		  hits(0),
 		  stores(0),
-		  storeSuccesses(0)
+		  storeSuccesses(0),
+		  store_(boost::make_shared<ResponseCacheStore>(
+			  DEFAULT_TURBOCACHE_MAX_SIZE, 1, MAX_ENTRY_SIZE))
 		{ }
 
+	/**
+	 * Replaces the storage backend, e.g. with one that is shared
+	 * with other ResponseCaches. Existing entries are not migrated.
+	 */
+	void setStore(const ResponseCacheStorePtr &store) {
+		store_ = store;
+	}
+
+	const ResponseCacheStorePtr &getStore() const {
+		return store_;
+	}
+
 	OXT_FORCE_INLINE
 	unsigned int getFetches() const {
 		return fetches;
@@ -446,7 +374,7 @@ public:
 
 	OXT_FORCE_INLINE
 	unsigned int getStores() const {
-		return fetches;
+		return stores;
 	}
 
 	OXT_FORCE_INLINE
@@ -473,9 +401,7 @@ public:
 	}
 
 	void clear() {
-		for (unsigned int i = 0; i < MAX_ENTRIES; i++) {
-			headers[i].valid = false;
-		}
+		store_->clear();
 	}
 
 
@@ -500,7 +426,7 @@ public:
 				req->configCache->defaultVaryTurbocacheByCookie.size());
 		}
 		if (varyCookieName != NULL) {
-			LString *cookieHeader = req->headers.lookup(COOKIE);
+			LString *cookieHeader = req->headers.lookup(ServerKit::WKH_COOKIE);
 			if (cookieHeader != NULL) {
 				req->varyCookie = ServerKit::findCookie(req->pool, cookieHeader, varyCookieName);
 			}
@@ -514,12 +440,12 @@ public:
 			return false;
 		}
 
-		req->cacheControl = req->headers.lookup(CACHE_CONTROL);
+		req->cacheControl = req->headers.lookup(ServerKit::WKH_CACHE_CONTROL);
 		if (req->cacheControl == NULL) {
 			// hasPragmaHeader is only used by requestAllowsFetching(),
 			// so if there is no Cache-Control header then it's not
 			// necessary to check for the Pragma header.
-			req->hasPragmaHeader = req->headers.lookup(PRAGMA_CONST) != NULL;
+			req->hasPragmaHeader = req->headers.lookup(ServerKit::WKH_PRAGMA) != NULL;
 		}
 
 		char *key = (char *) psg_pnalloc(req->pool, size);
@@ -546,21 +472,17 @@ public:
 			hits = 0;
 		}
 
-		Entry entry(lookup(req->cacheKey));
+		bool expired;
+		Entry entry(store_->lookup(req->cacheKey, (time_t) now, expired));
 		if (entry.valid()) {
 			hits++;
-			if (isFresh(entry, now)) {
-				return entry;
-			} else {
-				erase(entry.index);
-				Entry result;
-				result.cacheMissReason = Entry::NOT_FRESH;
-				return result;
-			}
+		} else if (expired) {
+			hits++;
+			entry.cacheMissReason = Entry::NOT_FRESH;
 		} else {
 			entry.cacheMissReason = Entry::NOT_FOUND;
-			return entry;
 		}
+		return entry;
 	}
 
 
@@ -578,7 +500,7 @@ public:
 
 		ServerKit::HeaderTable &respHeaders = req->appResponse.headers;
 
-		req->appResponse.cacheControl = respHeaders.lookup(CACHE_CONTROL);
+		req->appResponse.cacheControl = respHeaders.lookup(ServerKit::WKH_CACHE_CONTROL);
 		if (req->appResponse.cacheControl != NULL && req->appResponse.cacheControl->size > 0) {
 			req->appResponse.cacheControl = psg_lstr_make_contiguous(
 				req->appResponse.cacheControl,
@@ -594,22 +516,22 @@ public:
 			}
 		}
 
-		if (req->headers.lookup(AUTHORIZATION) != NULL
-		 || respHeaders.lookup(VARY) != NULL
-		 || respHeaders.lookup(WWW_AUTHENTICATE) != NULL
-		 || respHeaders.lookup(X_SENDFILE) != NULL
-		 || respHeaders.lookup(X_ACCEL_REDIRECT) != NULL)
+		if (req->headers.lookup(ServerKit::WKH_AUTHORIZATION) != NULL
+		 || respHeaders.lookup(ServerKit::WKH_VARY) != NULL
+		 || respHeaders.lookup(ServerKit::WKH_WWW_AUTHENTICATE) != NULL
+		 || respHeaders.lookup(ServerKit::WKH_X_SENDFILE) != NULL
+		 || respHeaders.lookup(ServerKit::WKH_X_ACCEL_REDIRECT) != NULL)
 		{
 			return false;
 		}
 
-		req->appResponse.expiresHeader = respHeaders.lookup(EXPIRES);
+		req->appResponse.expiresHeader = respHeaders.lookup(ServerKit::WKH_EXPIRES);
 		if (req->appResponse.expiresHeader == NULL) {
 			// lastModifiedHeader is only used in determineExpiryDate(),
 			// and only if expiresHeader is not present, and Cache-Control
 			// does not contain max-age.
 			req->appResponse.lastModifiedHeader =
-				respHeaders.lookup(LAST_MODIFIED);
+				respHeaders.lookup(ServerKit::WKH_LAST_MODIFIED);
 			if (req->appResponse.lastModifiedHeader != NULL) {
 				req->appResponse.lastModifiedHeader =
 					psg_lstr_make_contiguous(req->appResponse.lastModifiedHeader,
@@ -625,8 +547,14 @@ public:
 			|| req->appResponse.expiresHeader != NULL;
 	}
 
-	// @pre requestAllowsStoring()
-	// @pre prepareRequestForStoring()
+	/**
+	 * Allocates an entry for the response. The entry is not visible to
+	 * fetch() until the caller has filled in the header and body data
+	 * and has called publish().
+	 *
+	 * @pre requestAllowsStoring()
+	 * @pre prepareRequestForStoring()
+	 */
 	Entry store(Request *req, ev_tstamp now, unsigned int headerSize, unsigned int bodySize) {
 		stores++;
 
@@ -644,23 +572,20 @@ public:
 			return Entry();
 		}
 
-		const HashedStaticString &cacheKey = req->cacheKey;
-		Entry entry(lookup(cacheKey));
-		if (!entry.valid()) {
-			entry = lookupInvalidOrOldest();
-			entry.header->valid   = true;
-			entry.header->hash    = cacheKey.hash();
-			entry.header->keySize = cacheKey.size();
-			memcpy(entry.body->key, cacheKey.data(), cacheKey.size());
+		Entry entry(store_->allocate(req->cacheKey, headerSize, bodySize, (time_t) now));
+		if (entry.valid()) {
+			entry.body->date       = responseDate;
+			entry.body->expiryDate = expiryDate;
+			storeSuccesses++;
 		}
-		entry.header->date     = responseDate;
-		entry.body->expiryDate = expiryDate;
-		entry.body->httpHeaderSize = headerSize;
-		entry.body->httpBodySize   = bodySize;
-		storeSuccesses++;
 		return entry;
 	}
 
+	// @pre store() returned a valid entry
+	void publish(const Entry &entry) {
+		store_->publish(entry.body);
+	}
+
 
 	// @pre prepareRequest() returned true
 	// @pre !requestAllowsStoring() || !prepareRequestForStoring()
@@ -670,10 +595,7 @@ public:
 
 	// @pre requestAllowsInvalidating()
 	void invalidate(Request *req) {
-		Entry entry(lookup(req->cacheKey));
-		if (entry.valid()) {
-			entry.header->valid = false;
-		}
+		store_->erase(req->cacheKey);
 
 		invalidateLocation(req, LOCATION);
 		invalidateLocation(req, CONTENT_LOCATION);
@@ -681,19 +603,13 @@ public:
 
 
 	string inspect() const {
-		stringstream stream;
-		for (unsigned int i = 0; i < MAX_ENTRIES; i++) {
-			time_t expiryDate = bodies[i].expiryDate;
-			stream << " #" << i << ": valid=" << headers[i].valid
-				<< ", hash=" << headers[i].hash
-				<< ", expiryDate=" << expiryDate
-				<< ", keySize=" << headers[i].keySize << ", key=\""
-				<< cEscapeString(StaticString(bodies[i].key, headers[i].keySize)) << "\"\n";
-		}
-		return stream.str();
+		return store_->inspect();
 	}
 };
 
+template<typename Request>
+const unsigned int ResponseCache<Request>::MAX_ENTRY_SIZE;
+
 
 } // namespace Passenger
 
@@ -0,0 +1,631 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_RESPONSE_CACHE_STORE_H_
+#define _PASSENGER_RESPONSE_CACHE_STORE_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <oxt/macros.hpp>
+#include <vector>
+#include <sstream>
+#include <new>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <jsoncpp/json.h>
+#include <DataStructures/HashedStaticString.h>
+#include <StaticString.h>
+#include <Constants.h>
+#include <Utils/JsonUtils.h>
+
+namespace Passenger {
+
+using namespace std;
+
+
+/**
+ * Storage backend for the turbocache. A single ResponseCacheStore is shared by
+ * the ResponseCaches of all Core controller threads.
+ *
+ * The store is bounded by bytes rather than by number of entries. It is split
+ * into a number of shards, each with its own lock, its own byte budget and its
+ * own hash table, so that controller threads rarely contend with each other.
+ *
+ * Entry memory comes from per-shard size-class freelists ("slab classes"): a
+ * body is rounded up to the nearest class size, and memory of evicted entries
+ * is recycled for new entries of the same class without going through malloc().
+ * When a shard runs out of budget, entries are evicted with the CLOCK
+ * algorithm (a cheap approximation of LRU). Expired entries are evicted first,
+ * and are also removed lazily upon lookup, so that there is no need to
+ * periodically clear the cache.
+ *
+ * Entries are reference counted. A fetched entry stays valid (and its memory is
+ * not recycled) until the last reference is dropped, even if the entry has been
+ * evicted or replaced in the meantime. Entries are immutable once published.
+ *
+ * This class is thread-safe.
+ */
+class ResponseCacheStore {
+public:
+	static const unsigned int MIN_SLAB_CLASS_SIZE = 256;
+	static const unsigned int SLAB_CLASS_ALIGNMENT = 8;
+	static const unsigned int MIN_SHARD_BUCKETS = 64;
+	/** Assumed average entry size, used for sizing the hash tables. */
+	static const unsigned int AVERAGE_ENTRY_SIZE = 1024;
+
+	struct Shard;
+
+	struct Body {
+		mutable boost::atomic<int> refcount;
+		Shard *shard;
+		/** Next entry in the same hash bucket. */
+		Body *nextInBucket;
+		/** Neighbors in the shard's CLOCK ring. */
+		Body *clockPrev, *clockNext;
+		boost::uint32_t hash;
+		boost::uint32_t blockSize;
+		unsigned short slabClass;
+		unsigned short keySize;
+		bool resident;
+		bool referenced;
+
+		boost::uint32_t httpHeaderSize;
+		boost::uint32_t httpBodySize;
+		time_t date;
+		time_t expiryDate;
+		char *key;
+		char *httpHeaderData;
+		// This data is dechunked.
+		char *httpBodyData;
+
+		StaticString getKey() const {
+			return StaticString(key, keySize);
+		}
+	};
+
+	struct ShardStats {
+		boost::uint64_t hits;
+		boost::uint64_t misses;
+		boost::uint64_t stores;
+		boost::uint64_t evictions;
+		boost::uint64_t expirations;
+		boost::uint64_t invalidations;
+		boost::uint64_t allocationFailures;
+		boost::uint64_t slabReuses;
+
+		ShardStats()
+			: hits(0),
+			  misses(0),
+			  stores(0),
+			  evictions(0),
+			  expirations(0),
+			  invalidations(0),
+			  allocationFailures(0),
+			  slabReuses(0)
+			{ }
+	};
+
+	struct Shard {
+		boost::mutex syncher;
+		const vector<unsigned int> *slabClassSizes;
+		vector<Body *> buckets;
+		vector<Body *> freelists;
+		Body *clockHand;
+		unsigned int count;
+		size_t capacity;
+		/** Bytes of all blocks allocated by this shard, including freelists. */
+		size_t bytesAllocated;
+		/** Bytes of blocks sitting in the freelists. */
+		size_t bytesFree;
+		ShardStats stats;
+
+		Shard()
+			: slabClassSizes(NULL),
+			  clockHand(NULL),
+			  count(0),
+			  capacity(0),
+			  bytesAllocated(0),
+			  bytesFree(0)
+			{ }
+
+		~Shard() {
+			for (unsigned int i = 0; i < buckets.size(); i++) {
+				Body *body = buckets[i];
+				while (body != NULL) {
+					Body *next = body->nextInBucket;
+					destroyBlock(body);
+					body = next;
+				}
+			}
+			for (unsigned int i = 0; i < freelists.size(); i++) {
+				Body *body = freelists[i];
+				while (body != NULL) {
+					Body *next = body->nextInBucket;
+					destroyBlock(body);
+					body = next;
+				}
+			}
+		}
+
+		static void destroyBlock(Body *body) {
+			body->~Body();
+			free(body);
+		}
+
+		OXT_FORCE_INLINE
+		Body **bucketFor(boost::uint32_t hash) {
+			return &buckets[hash & (buckets.size() - 1)];
+		}
+
+		Body *lookup(const HashedStaticString &key) {
+			Body *body = *bucketFor(key.hash());
+			while (body != NULL) {
+				if (body->hash == key.hash() && key == body->getKey()) {
+					return body;
+				}
+				body = body->nextInBucket;
+			}
+			return NULL;
+		}
+
+		/**
+		 * Removes the entry from the hash table and the CLOCK ring, and drops
+		 * the reference that the shard holds on it.
+		 */
+		void unlink(Body *body) {
+			assert(body->resident);
+			Body **prev = bucketFor(body->hash);
+			while (*prev != body) {
+				prev = &(*prev)->nextInBucket;
+			}
+			*prev = body->nextInBucket;
+			body->nextInBucket = NULL;
+
+			if (body->clockNext == body) {
+				clockHand = NULL;
+			} else {
+				body->clockPrev->clockNext = body->clockNext;
+				body->clockNext->clockPrev = body->clockPrev;
+				if (clockHand == body) {
+					clockHand = body->clockNext;
+				}
+			}
+			body->clockPrev = body->clockNext = NULL;
+			body->resident = false;
+			count--;
+
+			if (body->refcount.fetch_sub(1, boost::memory_order_release) == 1) {
+				boost::atomic_thread_fence(boost::memory_order_acquire);
+				recycleBlock(body);
+			}
+		}
+
+		void link(Body *body) {
+			assert(!body->resident);
+			Body **bucket = bucketFor(body->hash);
+			body->nextInBucket = *bucket;
+			*bucket = body;
+
+			if (clockHand == NULL) {
+				body->clockPrev = body->clockNext = body;
+				clockHand = body;
+			} else {
+				// Insert right behind the hand so that the new entry is
+				// the last one to be considered in the current sweep.
+				body->clockNext = clockHand;
+				body->clockPrev = clockHand->clockPrev;
+				clockHand->clockPrev->clockNext = body;
+				clockHand->clockPrev = body;
+			}
+			body->resident = true;
+			body->referenced = false;
+			body->refcount.fetch_add(1, boost::memory_order_relaxed);
+			count++;
+		}
+
+		/**
+		 * Evicts a single entry using the CLOCK algorithm. Expired entries
+		 * are evicted regardless of their reference bit.
+		 */
+		bool evictOne(time_t now) {
+			if (clockHand == NULL) {
+				return false;
+			}
+			while (clockHand->referenced && clockHand->expiryDate > now) {
+				clockHand->referenced = false;
+				clockHand = clockHand->clockNext;
+			}
+			if (clockHand->expiryDate > now) {
+				stats.evictions++;
+			} else {
+				stats.expirations++;
+			}
+			unlink(clockHand);
+			return true;
+		}
+
+		void recycleBlock(Body *body) {
+			assert(!body->resident);
+			body->nextInBucket = freelists[body->slabClass];
+			freelists[body->slabClass] = body;
+			bytesFree += body->blockSize;
+		}
+
+		bool releaseSomeFreeBlocks(unsigned int exceptClass) {
+			for (unsigned int i = 0; i < freelists.size(); i++) {
+				if (i != exceptClass && freelists[i] != NULL) {
+					Body *body = freelists[i];
+					freelists[i] = body->nextInBucket;
+					bytesFree -= body->blockSize;
+					bytesAllocated -= body->blockSize;
+					destroyBlock(body);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		Body *allocateBlock(unsigned int slabClass, time_t now) {
+			unsigned int blockSize = (*slabClassSizes)[slabClass];
+
+			while (freelists[slabClass] == NULL
+				&& bytesAllocated + blockSize > capacity)
+			{
+				if (!releaseSomeFreeBlocks(slabClass) && !evictOne(now)) {
+					// Everything left is still referenced by readers.
+					stats.allocationFailures++;
+					return NULL;
+				}
+			}
+
+			Body *body = freelists[slabClass];
+			if (body != NULL) {
+				freelists[slabClass] = body->nextInBucket;
+				bytesFree -= body->blockSize;
+				stats.slabReuses++;
+			} else {
+				void *mem = malloc(blockSize);
+				if (OXT_UNLIKELY(mem == NULL)) {
+					stats.allocationFailures++;
+					return NULL;
+				}
+				body = new (mem) Body();
+				body->shard = this;
+				body->slabClass = slabClass;
+				body->blockSize = blockSize;
+				bytesAllocated += blockSize;
+			}
+
+			body->refcount.store(1, boost::memory_order_relaxed);
+			body->nextInBucket = NULL;
+			body->clockPrev = body->clockNext = NULL;
+			body->resident = false;
+			body->referenced = false;
+			return body;
+		}
+
+		void releaseBody(Body *body) {
+			boost::lock_guard<boost::mutex> l(syncher);
+			recycleBlock(body);
+		}
+
+		Json::Value inspectStateAsJson() {
+			boost::lock_guard<boost::mutex> l(syncher);
+			Json::Value doc;
+			doc["entries"] = count;
+			doc["capacity"] = byteSizeToJson(capacity);
+			doc["bytes_allocated"] = byteSizeToJson(bytesAllocated);
+			doc["bytes_free"] = byteSizeToJson(bytesFree);
+			doc["hits"] = (Json::UInt64) stats.hits;
+			doc["misses"] = (Json::UInt64) stats.misses;
+			doc["stores"] = (Json::UInt64) stats.stores;
+			doc["evictions"] = (Json::UInt64) stats.evictions;
+			doc["expirations"] = (Json::UInt64) stats.expirations;
+			doc["invalidations"] = (Json::UInt64) stats.invalidations;
+			doc["allocation_failures"] = (Json::UInt64) stats.allocationFailures;
+			doc["slab_reuses"] = (Json::UInt64) stats.slabReuses;
+			return doc;
+		}
+	};
+
+	typedef boost::intrusive_ptr<Body> BodyPtr;
+
+private:
+	vector<unsigned int> slabClassSizes;
+	Shard *shards;
+	unsigned int nshards;
+	size_t capacity;
+
+	static boost::uint32_t upperPowerOfTwo(boost::uint32_t v) {
+		v--;
+		v |= v >> 1;
+		v |= v >> 2;
+		v |= v >> 4;
+		v |= v >> 8;
+		v |= v >> 16;
+		v++;
+		return v;
+	}
+
+	void initializeSlabClasses(unsigned int maxBlockSize) {
+		unsigned int size = MIN_SLAB_CLASS_SIZE;
+		while (size < maxBlockSize) {
+			slabClassSizes.push_back(size);
+			// Grow by a factor 1.25, like memcached.
+			size = size + size / 4;
+			size = (size + SLAB_CLASS_ALIGNMENT - 1) & ~(SLAB_CLASS_ALIGNMENT - 1);
+		}
+		slabClassSizes.push_back(maxBlockSize);
+	}
+
+	int findSlabClass(unsigned int blockSize) const {
+		unsigned int low = 0, high = slabClassSizes.size();
+		while (low < high) {
+			unsigned int mid = (low + high) / 2;
+			if (slabClassSizes[mid] < blockSize) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+		if (low == slabClassSizes.size()) {
+			return -1;
+		} else {
+			return low;
+		}
+	}
+
+	OXT_FORCE_INLINE
+	Shard &shardFor(boost::uint32_t hash) const {
+		// Use the high bits for shard selection; the low bits
+		// select the hash bucket within the shard.
+		return shards[(hash >> 16) % nshards];
+	}
+
+public:
+	/**
+	 * @param capacity The maximum number of bytes that all entries together
+	 *                 may occupy, including bookkeeping overhead.
+	 * @param nshards The number of independently locked shards.
+	 * @param maxEntrySize The largest key + header + body size that an entry
+	 *                     may have.
+	 */
+	ResponseCacheStore(size_t _capacity, unsigned int _nshards, unsigned int maxEntrySize)
+		: nshards(std::max(_nshards, 1u)),
+		  capacity(_capacity)
+	{
+		initializeSlabClasses(sizeof(Body) + maxEntrySize);
+
+		unsigned int nbuckets = upperPowerOfTwo(std::max<size_t>(MIN_SHARD_BUCKETS,
+			capacity / nshards / AVERAGE_ENTRY_SIZE));
+		shards = new Shard[nshards];
+		for (unsigned int i = 0; i < nshards; i++) {
+			shards[i].slabClassSizes = &slabClassSizes;
+			shards[i].buckets.resize(nbuckets, NULL);
+			shards[i].freelists.resize(slabClassSizes.size(), NULL);
+			shards[i].capacity = capacity / nshards;
+		}
+	}
+
+	~ResponseCacheStore() {
+		delete[] shards;
+	}
+
+	/**
+	 * Allocates a new, unpublished entry for the given key. The caller must
+	 * fill in the entry's metadata and header/body data and then call `publish()`.
+	 * Returns NULL if the entry is too large or if there is no memory available.
+	 */
+	BodyPtr allocate(const HashedStaticString &key, unsigned int headerSize,
+		unsigned int bodySize, time_t now)
+	{
+		unsigned int blockSize = sizeof(Body) + key.size() + headerSize + bodySize;
+		int slabClass = findSlabClass(blockSize);
+		Shard &shard = shardFor(key.hash());
+
+		if (slabClass == -1 || slabClassSizes[slabClass] > shard.capacity) {
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			shard.stats.allocationFailures++;
+			return BodyPtr();
+		}
+
+		Body *body;
+		{
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			body = shard.allocateBlock(slabClass, now);
+		}
+		if (body == NULL) {
+			return BodyPtr();
+		}
+
+		char *data = reinterpret_cast<char *>(body + 1);
+		body->hash = key.hash();
+		body->keySize = key.size();
+		body->key = data;
+		body->httpHeaderData = data + key.size();
+		body->httpBodyData = body->httpHeaderData + headerSize;
+		body->httpHeaderSize = headerSize;
+		body->httpBodySize = bodySize;
+		body->date = 0;
+		body->expiryDate = 0;
+		memcpy(body->key, key.data(), key.size());
+
+		// The Shard owns the initial reference; hand it over to the BodyPtr.
+		return BodyPtr(body, false);
+	}
+
+	/**
+	 * Makes a previously allocated entry visible to lookups, replacing any
+	 * existing entry with the same key.
+	 */
+	void publish(const BodyPtr &body) {
+		Shard &shard = *body->shard;
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		Body *existing = shard.lookup(HashedStaticString(body->key,
+			body->keySize, body->hash));
+		if (existing != NULL) {
+			shard.unlink(existing);
+		}
+		shard.link(body.get());
+		shard.stats.stores++;
+	}
+
+	/**
+	 * Looks up a fresh entry with the given key. Entries that are no longer
+	 * fresh are removed. `expired` is set to whether a non-fresh entry was found.
+	 */
+	BodyPtr lookup(const HashedStaticString &key, time_t now, bool &expired) {
+		Shard &shard = shardFor(key.hash());
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		Body *body = shard.lookup(key);
+		expired = false;
+		if (body == NULL) {
+			shard.stats.misses++;
+			return BodyPtr();
+		} else if (body->expiryDate <= now) {
+			expired = true;
+			shard.stats.misses++;
+			shard.stats.expirations++;
+			shard.unlink(body);
+			return BodyPtr();
+		} else {
+			shard.stats.hits++;
+			body->referenced = true;
+			return BodyPtr(body);
+		}
+	}
+
+	bool erase(const HashedStaticString &key) {
+		Shard &shard = shardFor(key.hash());
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		Body *body = shard.lookup(key);
+		if (body != NULL) {
+			shard.stats.invalidations++;
+			shard.unlink(body);
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	void clear() {
+		for (unsigned int i = 0; i < nshards; i++) {
+			Shard &shard = shards[i];
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			while (shard.clockHand != NULL) {
+				shard.unlink(shard.clockHand);
+			}
+		}
+	}
+
+	size_t getCapacity() const {
+		return capacity;
+	}
+
+	unsigned int getShardCount() const {
+		return nshards;
+	}
+
+	const vector<unsigned int> &getSlabClassSizes() const {
+		return slabClassSizes;
+	}
+
+	unsigned int getEntryCount() const {
+		unsigned int result = 0;
+		for (unsigned int i = 0; i < nshards; i++) {
+			boost::lock_guard<boost::mutex> l(shards[i].syncher);
+			result += shards[i].count;
+		}
+		return result;
+	}
+
+	ShardStats getTotalStats() const {
+		ShardStats result;
+		for (unsigned int i = 0; i < nshards; i++) {
+			boost::lock_guard<boost::mutex> l(shards[i].syncher);
+			const ShardStats &stats = shards[i].stats;
+			result.hits += stats.hits;
+			result.misses += stats.misses;
+			result.stores += stats.stores;
+			result.evictions += stats.evictions;
+			result.expirations += stats.expirations;
+			result.invalidations += stats.invalidations;
+			result.allocationFailures += stats.allocationFailures;
+			result.slabReuses += stats.slabReuses;
+		}
+		return result;
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		Json::Value shardsDoc(Json::arrayValue);
+		doc["capacity"] = byteSizeToJson(capacity);
+		doc["slab_classes"] = (Json::UInt) slabClassSizes.size();
+		for (unsigned int i = 0; i < nshards; i++) {
+			shardsDoc.append(shards[i].inspectStateAsJson());
+		}
+		doc["shards"] = shardsDoc;
+		return doc;
+	}
+
+	string inspect() const {
+		stringstream stream;
+		for (unsigned int i = 0; i < nshards; i++) {
+			boost::lock_guard<boost::mutex> l(shards[i].syncher);
+			stream << " shard #" << i << ": entries=" << shards[i].count
+				<< ", bytesAllocated=" << shards[i].bytesAllocated
+				<< ", bytesFree=" << shards[i].bytesFree
+				<< ", capacity=" << shards[i].capacity << "\n";
+		}
+		return stream.str();
+	}
+};
+
+typedef boost::shared_ptr<ResponseCacheStore> ResponseCacheStorePtr;
+
+
+inline void
+intrusive_ptr_add_ref(const ResponseCacheStore::Body *body) {
+	body->refcount.fetch_add(1, boost::memory_order_relaxed);
+}
+
+inline void
+intrusive_ptr_release(const ResponseCacheStore::Body *body) {
+	if (body->refcount.fetch_sub(1, boost::memory_order_release) == 1) {
+		boost::atomic_thread_fence(boost::memory_order_acquire);
+		ResponseCacheStore::Body *b = const_cast<ResponseCacheStore::Body *>(body);
+		b->shard->releaseBody(b);
+	}
+}
+
+
+} // namespace Passenger
+
+#endif /* _PASSENGER_RESPONSE_CACHE_STORE_H_ */
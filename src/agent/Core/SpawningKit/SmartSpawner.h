@@ -66,13 +66,33 @@ private:
 		}
 	};
 
+	/**
+	 * A copy of the preloader information, taken while holding `syncher`.
+	 * Spawn commands are sent using such a copy, without holding the lock,
+	 * so that multiple processes can be spawned from the same preloader at
+	 * the same time.
+	 */
+	struct PreloaderInfo {
+		pid_t pid;
+		string socketAddress;
+		SpawnPreparationInfo preparation;
+		/** The value of `SmartSpawner::preloaderGeneration` at the time. */
+		unsigned int generation;
+
+		PreloaderInfo()
+			: pid(-1),
+			  generation(0)
+			{ }
+	};
+
 	const vector<string> preloaderCommand;
 	map<string, string> preloaderAnnotations;
 	Options options;
 
-	// Protects m_lastUsed and pid.
+	// Protects m_lastUsed, pid and preloaderAnnotations.
 	mutable boost::mutex simpleFieldSyncher;
-	// Protects everything else.
+	// Protects everything else. It is only held while starting or
+	// stopping the preloader, not while spawning processes from it.
 	mutable boost::mutex syncher;
 
 	// Preloader information.
@@ -83,6 +103,9 @@ private:
 	// Upon starting the preloader, its preparation info is stored here
 	// for future reference.
 	SpawnPreparationInfo preparation;
+	// Incremented every time the preloader is started. Used to detect
+	// whether another thread has already restarted a crashed preloader.
+	unsigned int preloaderGeneration;
 
 	string getPreloaderCommandString() const {
 		string result;
@@ -319,7 +342,12 @@ private:
 			watcher->initialize();
 			watcher->start();
 
-			preloaderAnnotations = debugDir->readAll();
+			{
+				map<string, string> annotations = debugDir->readAll();
+				boost::lock_guard<boost::mutex> l(simpleFieldSyncher);
+				preloaderAnnotations = annotations;
+			}
+			preloaderGeneration++;
 			P_INFO("Preloader for " << options.appRoot <<
 				" started on PID " << pid <<
 				", listening on " << socketAddress);
@@ -638,33 +666,61 @@ private:
 		return "";
 	}
 
-	NegotiationDetails sendSpawnCommandAndGetNegotiationDetails(const Options &options) {
+	/**
+	 * Starts the preloader if necessary, and returns a copy of its information.
+	 * `syncher` must be held.
+	 */
+	PreloaderInfo getPreloaderInfo() {
+		TRACE_POINT();
+		if (!preloaderStarted()) {
+			UPDATE_TRACE_POINT();
+			startPreloader();
+		}
+
+		PreloaderInfo info;
+		info.pid = pid;
+		info.socketAddress = socketAddress;
+		info.preparation = preparation;
+		info.generation = preloaderGeneration;
+		return info;
+	}
+
+	void stopPreloaderIfGeneration(unsigned int generation) {
+		boost::lock_guard<boost::mutex> l(syncher);
+		if (preloaderGeneration == generation) {
+			stopPreloader();
+		}
+	}
+
+	NegotiationDetails sendSpawnCommandAndGetNegotiationDetails(const Options &options,
+		PreloaderInfo &preloader)
+	{
 		TRACE_POINT();
 		NegotiationDetails details;
 
-		details.preparation = &preparation;
+		details.preparation = &preloader.preparation;
 		details.options = &options;
 
 		try {
-			sendSpawnCommand(details);
+			sendSpawnCommand(details, preloader);
 		} catch (const SystemException &e) {
-			sendSpawnCommandAgain(e, details);
+			sendSpawnCommandAgain(e, details, preloader);
 		} catch (const IOException &e) {
-			sendSpawnCommandAgain(e, details);
+			sendSpawnCommandAgain(e, details, preloader);
 		} catch (const SpawnException &e) {
-			sendSpawnCommandAgain(e, details);
+			sendSpawnCommandAgain(e, details, preloader);
 		}
 
 		return details;
 	}
 
-	void sendSpawnCommand(NegotiationDetails &details) {
+	void sendSpawnCommand(NegotiationDetails &details, const PreloaderInfo &preloader) {
 		TRACE_POINT();
 		const Options &options = *details.options;
 		FileDescriptor fd;
 
 		try {
-			fd.assign(connectToServer(socketAddress, __FILE__, __LINE__), NULL, 0);
+			fd.assign(connectToServer(preloader.socketAddress, __FILE__, __LINE__), NULL, 0);
 		} catch (const SystemException &e) {
 			BackgroundIOCapturerPtr stderrCapturer;
 			throwPreloaderSpawnException("An error occurred while starting "
@@ -675,7 +731,7 @@ private:
 				options,
 				DebugDirPtr());
 		}
-		P_LOG_FILE_DESCRIPTOR_PURPOSE(fd, "Preloader " << pid
+		P_LOG_FILE_DESCRIPTOR_PURPOSE(fd, "Preloader " << preloader.pid
 			<< " (" << options.appRoot << ") connection");
 
 		UPDATE_TRACE_POINT();
@@ -714,7 +770,7 @@ private:
 			}
 			// TODO: we really should be checking UID.
 			// FIXME: for Passenger 4 we *must* check the UID otherwise this is a gaping security hole.
-			if (getsid(spawnedPid) != getsid(pid)) {
+			if (getsid(spawnedPid) != getsid(preloader.pid)) {
 				BackgroundIOCapturerPtr stderrCapturer;
 				throwPreloaderSpawnException("An error occurred while starting "
 					"the web application. Its preloader responded to the "
@@ -745,21 +801,36 @@ private:
 	}
 
 	template<typename Exception>
-	void sendSpawnCommandAgain(const Exception &e, NegotiationDetails &details) {
+	void sendSpawnCommandAgain(const Exception &e, NegotiationDetails &details,
+		PreloaderInfo &preloader)
+	{
 		TRACE_POINT();
 		P_WARN("An error occurred while spawning a process: " << e.what());
-		P_WARN("The application preloader seems to have crashed, restarting it and trying again...");
-		stopPreloader();
-		startPreloader();
-		ScopeGuard guard(boost::bind(&SmartSpawner::stopPreloader, this));
-		sendSpawnCommand(details);
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			// Other threads that were spawning from the same preloader may
+			// have noticed the crash first, and restarted it already.
+			if (preloaderGeneration == preloader.generation) {
+				P_WARN("The application preloader seems to have crashed, restarting it and trying again...");
+				stopPreloader();
+			}
+			preloader = getPreloaderInfo();
+		}
+		ScopeGuard guard(boost::bind(&SmartSpawner::stopPreloaderIfGeneration, this,
+			preloader.generation));
+		sendSpawnCommand(details, preloader);
 		guard.clear();
 	}
 
 protected:
 	virtual void annotateAppSpawnException(SpawnException &e, NegotiationDetails &details) {
 		Spawner::annotateAppSpawnException(e, details);
-		e.addAnnotations(preloaderAnnotations);
+		map<string, string> annotations;
+		{
+			boost::lock_guard<boost::mutex> l(simpleFieldSyncher);
+			annotations = preloaderAnnotations;
+		}
+		e.addAnnotations(annotations);
 	}
 
 public:
@@ -776,6 +847,7 @@ public:
 		options    = _options.copyAndPersist().detachFromUnionStationTransaction();
 		pid        = -1;
 		m_lastUsed = SystemTime::getUsec();
+		preloaderGeneration = 0;
 	}
 
 	virtual ~SmartSpawner() {
@@ -796,14 +868,18 @@ public:
 			m_lastUsed = SystemTime::getUsec();
 		}
 		UPDATE_TRACE_POINT();
-		boost::lock_guard<boost::mutex> l(syncher);
-		if (!preloaderStarted()) {
-			UPDATE_TRACE_POINT();
-			startPreloader();
+		PreloaderInfo preloader;
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			preloader = getPreloaderInfo();
 		}
 
+		// The preloader forks a new process for every connection, and the
+		// negotiation happens with that process, so other threads may spawn
+		// from the same preloader in the mean time.
 		UPDATE_TRACE_POINT();
-		NegotiationDetails details = sendSpawnCommandAndGetNegotiationDetails(options);
+		NegotiationDetails details = sendSpawnCommandAndGetNegotiationDetails(options,
+			preloader);
 		Result result = negotiateSpawn(details);
 		P_DEBUG("Process spawning done: appRoot=" << options.appRoot <<
 			", pid=" << result["pid"].asInt());
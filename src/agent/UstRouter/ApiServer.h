@@ -51,6 +51,8 @@ class Request: public ServerKit::BaseHttpRequest {
 public:
 	string body;
 	Json::Value jsonBody;
+	unsigned int controllerStatesGathered;
+	vector<Json::Value> controllerStates;
 
 	DEFINE_SERVER_KIT_BASE_HTTP_REQUEST_FOOTER(Request);
 };
@@ -171,26 +173,43 @@ private:
 		}
 	}
 
-	void gatherControllerState(Client *client, Request *req, Controller *controller) {
+	void gatherControllerState(Client *client, Request *req, Controller *controller,
+		unsigned int i)
+	{
 		Json::Value state = controller->inspectStateAsJson();
 		getContext()->libev->runLater(boost::bind(&ApiServer::controllerStateGathered,
-			this, client, req, state));
+			this, client, req, i, state));
 	}
 
-	void controllerStateGathered(Client *client, Request *req, Json::Value state) {
+	void controllerStateGathered(Client *client, Request *req,
+		unsigned int i, Json::Value state)
+	{
 		if (req->ended()) {
 			unrefRequest(req, __FILE__, __LINE__);
 			return;
 		}
 
-		HeaderTable headers;
-		headers.insert(req->pool, "Content-Type", "application/json");
+		req->controllerStatesGathered++;
+		req->controllerStates[i] = state;
 
-		writeSimpleResponse(client, 200, &headers,
-			psg_pstrdup(req->pool, state.toStyledString()));
-		if (!req->ended()) {
-			Request *req2 = req;
-			endRequest(&client, &req2);
+		if (req->controllerStatesGathered == controllers.size()) {
+			HeaderTable headers;
+			headers.insert(req->pool, "Content-Type", "application/json");
+
+			Json::Value response;
+			response["threads"] = (Json::UInt) controllers.size();
+
+			for (unsigned int i = 0; i < controllers.size(); i++) {
+				string key = "thread" + toString(i + 1);
+				response[key] = req->controllerStates[i];
+			}
+
+			writeSimpleResponse(client, 200, &headers,
+				psg_pstrdup(req->pool, response.toStyledString()));
+			if (!req->ended()) {
+				Request *req2 = req;
+				endRequest(&client, &req2);
+			}
 		}
 
 		unrefRequest(req, __FILE__, __LINE__);
@@ -200,10 +219,13 @@ private:
 		if (req->method != HTTP_GET) {
 			apiServerRespondWith405(this, client, req);
 		} else if (authorizeStateInspectionOperation(this, client, req)) {
-			refRequest(req, __FILE__, __LINE__);
-			controller->getContext()->libev->runLater(boost::bind(
-				&ApiServer::gatherControllerState, this,
-				client, req, controller));
+			req->controllerStates.resize(controllers.size());
+			for (unsigned int i = 0; i < controllers.size(); i++) {
+				refRequest(req, __FILE__, __LINE__);
+				controllers[i]->getContext()->libev->runLater(boost::bind(
+					&ApiServer::gatherControllerState, this,
+					client, req, controllers[i], i));
+			}
 		} else {
 			apiServerRespondWith401(this, client, req);
 		}
@@ -256,16 +278,22 @@ protected:
 		return ServerKit::Channel::Result(buffer.size(), false);
 	}
 
+	virtual void reinitializeRequest(Client *client, Request *req) {
+		ParentClass::reinitializeRequest(client, req);
+		req->controllerStatesGathered = 0;
+	}
+
 	virtual void deinitializeRequest(Client *client, Request *req) {
 		req->body.clear();
 		if (!req->jsonBody.isNull()) {
 			req->jsonBody = Json::Value();
 		}
+		req->controllerStates.clear();
 		ParentClass::deinitializeRequest(client, req);
 	}
 
 public:
-	Controller *controller;
+	vector<Controller *> controllers;
 	ApiAccountDatabase *apiAccountDatabase;
 	string instanceDir;
 	string fdPassingPassword;
@@ -274,7 +302,6 @@ public:
 	ApiServer(ServerKit::Context *context, const ServerKit::HttpServerSchema &schema,
 		const Json::Value &initialConfig = Json::Value())
 		: ParentClass(context, schema, initialConfig),
-		  controller(NULL),
 		  apiAccountDatabase(NULL),
 		  exitEvent(NULL)
 		{ }
@@ -32,6 +32,7 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/foreach.hpp>
+#include <boost/thread.hpp>
 #include <oxt/backtrace.hpp>
 #include <ev++.h>
 #include <SmallVector.h>
@@ -44,6 +45,7 @@
 #include <UstRouter/Client.h>
 #include <UstRouter/FileSink.h>
 #include <UstRouter/RemoteSink.h>
+#include <UstRouter/Shard.h>
 #include <UnionStationFilterSupport.h>
 #include <MessageReadersWriters.h>
 #include <Utils.h>
@@ -69,24 +71,20 @@ private:
 		11 +                          // space for a random identifier
 		1;                            // null terminator
 
-	friend inline struct ::ev_loop *UstRouter::Controller_getLoop(Controller *controller);
-	friend inline RemoteSender &UstRouter::Controller_getRemoteSender(Controller *controller);
-
 	typedef ServerKit::BaseServer<Controller, Client> ParentClass;
 	typedef ServerKit::Channel Channel;
-	typedef StringMap<TransactionPtr> TransactionMap;
-	typedef StringMap<LogSinkPtr> LogSinkCache;
+	typedef Shard::TransactionMap TransactionMap;
+	typedef Shard::LogSinkCache LogSinkCache;
 
 	RandomGenerator randomGenerator;
-	TransactionMap transactions;
-	LogSinkCache logSinkCache;
-	RemoteSender remoteSender;
-	StringMap<FilterSupport::FilterPtr> filters;
+	unsigned int threadNumber;
 
 	ev::timer gcTimer;
 	ev::timer flushTimer;
+	ev::prepare fileSinkFlusher;
 	bool devMode;
 	int sinkFlushInterval;
+	FileSinkPolicy fileSinkPolicy;
 
 
 	/****** Handshake and authentication ******/
@@ -274,7 +272,7 @@ private:
 		timestamp = args[2];
 		ack       = getBool(args, 3, false);
 
-		transaction = transactions.get(txnId);
+		transaction = findTransaction(txnId);
 		if (OXT_UNLIKELY(transaction == NULL)) {
 			SKC_ERROR(client, "Cannot log data: transaction does not exist");
 			if (ack) {
@@ -370,6 +368,7 @@ private:
 		StaticString filters         = getStaticString(args, 9);
 
 		TransactionPtr transaction;
+		string error;
 		char autogeneratedTxnIdBuf[TXN_ID_MAX_SIZE];
 		char *autogeneratedTxnIdBufEnd;
 		bool autogenTxnId = txnId.empty();
@@ -417,85 +416,24 @@ private:
 			nodeName = client->nodeName;
 		}
 
-		transaction = transactions.get(txnId);
-		if (transaction == NULL) {
-			if (OXT_UNLIKELY(!supportedCategory(category))) {
-				SKC_ERROR(client, "Unsupported category '" << category << "'");
-				if (ack) {
-					sendErrorToClient(client, "Unsupported category");
-					if (client->connected()) {
-						disconnect(&client);
-					}
-				}
-				goto done;
-			}
-
-			transaction = boost::make_shared<Transaction>(
-				txnId, groupName, nodeName, category,
-				unionStationKey, ev_now(getLoop()), filters
-			);
-			transaction->enableCrashProtect(crashProtect);
-			transactions.set(txnId, transaction);
-		} else {
-			if (OXT_UNLIKELY(client->openTransactions.find(transaction->getTxnId()) !=
-				client->openTransactions.end()))
-			{
-				SKC_ERROR(client, "Cannot open transaction: transaction already opened in this connection");
-				if (ack) {
-					sendErrorToClient(client, "Cannot open transaction: transaction already opened in this connection");
-					if (client->connected()) {
-						disconnect(&client);
-					}
-				}
-				goto done;
-			}
-			if (OXT_UNLIKELY(transaction->getCategory() != category)) {
-				SKC_ERROR(client, "Cannot open transaction: transaction already opened with a different category name (" <<
-						transaction->getCategory() << " vs " << category << ")");
-				if (ack) {
-					sendErrorToClient(client,
-							"Cannot open transaction: transaction already opened with a different category name (" +
-							transaction->getCategory() + " vs " + category + ")");
-					if (client->connected()) {
-						disconnect(&client);
-					}
-				}
-				goto done;
-			}
-			if (OXT_UNLIKELY(transaction->getNodeName() != nodeName)) {
-				SKC_ERROR(client, "Cannot open transaction: transaction "
-					"already opened with a different node name (" <<
-					transaction->getNodeName() << " vs " << nodeName << ")");
-				if (ack) {
-					sendErrorToClient(client, "Cannot open transaction: transaction "
-							"already opened with a different node name (" +
-							transaction->getNodeName() + " vs " + nodeName + ")");
-					if (client->connected()) {
-						disconnect(&client);
-					}
-				}
-				goto done;
-			}
-			if (OXT_UNLIKELY(transaction->getUnionStationKey() != unionStationKey)) {
-				SKC_ERROR(client,
-					"Cannot open transaction: transaction already opened with a "
-					"different key ('" << transaction->getUnionStationKey() <<
-					"' vs '" << unionStationKey << "')");
-				if (ack) {
-					sendErrorToClient(client,
-						"Cannot open transaction: transaction already opened with a "
-						"different key ('" + transaction->getUnionStationKey() +
-						"' vs '" + unionStationKey + "')");
-					if (client->connected()) {
-						disconnect(&client);
-					}
+		{
+			Shard &shard = shardSet->forTxnId(txnId);
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			transaction = openTransaction(client, shard, txnId, groupName,
+				nodeName, category, unionStationKey, crashProtect, filters,
+				error);
+		}
+		if (OXT_UNLIKELY(transaction == NULL)) {
+			SKC_ERROR(client, error);
+			if (ack) {
+				sendErrorToClient(client, error);
+				if (client->connected()) {
+					disconnect(&client);
 				}
-				goto done;
 			}
+			goto done;
 		}
 
-		client->openTransactions.insert(transaction->getTxnId());
-		transaction->ref();
 		writeLogEntry(client, transaction, timestamp, P_STATIC_STRING("ATTACH"), ack);
 
 		if (client->connected() && ack) {
@@ -533,7 +471,7 @@ private:
 		timestamp = args[2];
 		ack       = getBool(args, 3, false);
 
-		transaction = transactions.get(txnId);
+		transaction = findTransaction(txnId);
 		if (OXT_UNLIKELY(transaction == NULL)) {
 			SKC_ERROR(client, "Cannot close transaction " << txnId <<
 				": transaction does not exist");
@@ -564,11 +502,7 @@ private:
 
 			client->openTransactions.erase(s_it);
 			writeDetachEntry(client, transaction, timestamp, ack);
-			transaction->unref();
-			if (transaction->getRefCount() == 0) {
-				transactions.remove(txnId);
-				closeTransaction(client, transaction);
-			}
+			releaseTransaction(client, transaction);
 		}
 
 		if (ack) {
@@ -651,6 +585,9 @@ private:
 	void garbageCollect(ev::timer &timer, int revents) {
 		P_DEBUG("Running UstRouter garbage collector");
 
+		Shard &shard = getOwnShard();
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		LogSinkCache &logSinkCache = shard.logSinkCache;
 		LogSinkCache::iterator it, end = logSinkCache.end();
 		ev_tstamp threshold = ev_now(getLoop()) - LOG_SINK_MAX_IDLE_TIME;
 		SmallVector<string, 8> toRemove;
@@ -685,21 +622,72 @@ private:
 	void flushSomeSinks(ev::timer &timer, int revents) {
 		P_DEBUG("Flushing sinks that need flushing");
 
-		LogSinkCache::iterator it;
-		LogSinkCache::iterator end = logSinkCache.end();
-		ev_tstamp threshold = ev_now(getLoop()) - sinkFlushInterval;
-
-		for (it = logSinkCache.begin(); it != end; it++) {
-			const LogSinkPtr &sink = it->second;
-			if (sink->lastFlushed < threshold) {
-				// flush() method is responsible for logging
-				sink->flush();
+		Shard &shard = getOwnShard();
+		SmallVector<FileSinkPtr, 8> fileSinks;
+		{
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			LogSinkCache &logSinkCache = shard.logSinkCache;
+			LogSinkCache::iterator it;
+			LogSinkCache::iterator end = logSinkCache.end();
+			ev_tstamp threshold = ev_now(getLoop()) - sinkFlushInterval;
+
+			for (it = logSinkCache.begin(); it != end; it++) {
+				const LogSinkPtr &sink = it->second;
+				if (sink->lastFlushed < threshold) {
+					// flush() method is responsible for logging
+					if (sink->flush() && !sink->isRemote()) {
+						fileSinks.push_back(boost::static_pointer_cast<FileSink>(sink));
+					}
+				}
 			}
 		}
+		writeFileSinks(fileSinks);
 
 		P_DEBUG("Done flushing sinks that need flushing");
 	}
 
+	/**
+	 * Called right before the event loop blocks for I/O. Writes out the
+	 * buffers of file sinks, so that all transactions closed during one
+	 * event loop iteration are written with a single system call per dump
+	 * file, while still being visible immediately afterwards.
+	 */
+	void flushFileSinks(ev::prepare &watcher, int revents) {
+		SmallVector<FileSinkPtr, 8> fileSinks;
+
+		fileSinkFlusher.stop();
+		for (unsigned int i = 0; i < shardSet->size(); i++) {
+			Shard &shard = (*shardSet)[i];
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			if (!shard.fileSinksDirty) {
+				continue;
+			}
+
+			LogSinkCache::iterator it;
+			LogSinkCache::iterator end = shard.logSinkCache.end();
+			for (it = shard.logSinkCache.begin(); it != end; it++) {
+				const LogSinkPtr &sink = it->second;
+				if (!sink->isRemote() && sink->flush()) {
+					fileSinks.push_back(boost::static_pointer_cast<FileSink>(sink));
+				}
+			}
+			shard.fileSinksDirty = false;
+		}
+		writeFileSinks(fileSinks);
+	}
+
+	/**
+	 * Writes out the data that the given file sinks have queued while
+	 * their shard was locked.
+	 *
+	 * @pre No shard is locked
+	 */
+	void writeFileSinks(const SmallVector<FileSinkPtr, 8> &fileSinks) {
+		for (unsigned int i = 0; i < fileSinks.size(); i++) {
+			fileSinks[i]->writePendingData();
+		}
+	}
+
 
 	/****** Utility functions ******/
 
@@ -884,7 +872,10 @@ private:
 		return replaceAll(key, P_STATIC_STRING("\0"), P_STATIC_STRING("__"));
 	}
 
-	LogSinkPtr openLogFile(Client *client, const StaticString &category) {
+	/**
+	 * @pre shard.syncher is locked
+	 */
+	LogSinkPtr openLogFile(Client *client, Shard &shard, const StaticString &category) {
 		size_t cacheKeySize =
 			(sizeof("file:") - 1) +
 			category.size();
@@ -895,21 +886,24 @@ private:
 		pos = appendData(pos, end, P_STATIC_STRING("file:"));
 		pos = appendData(pos, end, category);
 
-		LogSinkPtr sink = logSinkCache.get(StaticString(cacheKey, cacheKeySize));
+		LogSinkPtr sink = shard.logSinkCache.get(StaticString(cacheKey, cacheKeySize));
 		if (sink == NULL) {
 			string dumpFile = config["ust_router_dump_dir"].asString() + "/" + category;
 			SKC_DEBUG(client, "Creating dump file: " << dumpFile);
-			sink = boost::make_shared<FileSink>(this, dumpFile);
+			sink = boost::make_shared<FileSink>(dumpFile, fileSinkPolicy);
 			sink->opened = 1;
-			logSinkCache.set(StaticString(cacheKey, cacheKeySize), sink);
+			shard.logSinkCache.set(StaticString(cacheKey, cacheKeySize), sink);
 		} else {
 			sink->opened++;
 		}
 		return sink;
 	}
 
-	LogSinkPtr openRemoteSink(const StaticString &unionStationKey, const string &nodeName,
-		const string &category)
+	/**
+	 * @pre shard.syncher is locked
+	 */
+	LogSinkPtr openRemoteSink(Shard &shard, const StaticString &unionStationKey,
+		const string &nodeName, const string &category)
 	{
 		size_t cacheKeySize =
 			(sizeof("remote:") - 1) +
@@ -929,36 +923,141 @@ private:
 		pos = appendData(pos, end, "\0", 1);
 		pos = appendData(pos, end, category);
 
-		LogSinkPtr sink(logSinkCache.get(StaticString(cacheKey, cacheKeySize)));
+		LogSinkPtr sink(shard.logSinkCache.get(StaticString(cacheKey, cacheKeySize)));
 		if (sink == NULL) {
-			sink = boost::make_shared<RemoteSink>(this, unionStationKey,
-				nodeName, category);
+			sink = boost::make_shared<RemoteSink>(&shardSet->remoteSender,
+				unionStationKey, nodeName, category);
 			sink->opened = 1;
-			logSinkCache.set(StaticString(cacheKey, cacheKeySize), sink);
+			shard.logSinkCache.set(StaticString(cacheKey, cacheKeySize), sink);
 		} else {
 			sink->opened++;
 		}
 		return sink;
 	}
 
+	Shard &getOwnShard() {
+		return (*shardSet)[threadNumber - 1];
+	}
+
+	TransactionPtr findTransaction(const StaticString &txnId) {
+		Shard &shard = shardSet->forTxnId(txnId);
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		return shard.transactions.get(txnId);
+	}
+
+	/**
+	 * Looks up or creates the transaction that an 'openTransaction' message
+	 * refers to, and references it on behalf of the given client.
+	 * Returns NULL and sets `error` if the transaction cannot be opened.
+	 *
+	 * @pre shard.syncher is locked
+	 */
+	TransactionPtr openTransaction(Client *client, Shard &shard,
+		const StaticString &txnId, const StaticString &groupName,
+		const StaticString &nodeName, const StaticString &category,
+		const StaticString &unionStationKey, bool crashProtect,
+		const StaticString &filters, string &error)
+	{
+		TransactionPtr transaction = shard.transactions.get(txnId);
+		if (transaction == NULL) {
+			if (OXT_UNLIKELY(!supportedCategory(category))) {
+				error = "Unsupported category '" + category + "'";
+				return TransactionPtr();
+			}
+
+			transaction = boost::make_shared<Transaction>(
+				txnId, groupName, nodeName, category,
+				unionStationKey, ev_now(getLoop()), filters
+			);
+			transaction->enableCrashProtect(crashProtect);
+			shard.transactions.set(txnId, transaction);
+		} else {
+			if (OXT_UNLIKELY(client->openTransactions.find(transaction->getTxnId()) !=
+				client->openTransactions.end()))
+			{
+				error = "Cannot open transaction: transaction already opened in this connection";
+				return TransactionPtr();
+			}
+			if (OXT_UNLIKELY(transaction->getCategory() != category)) {
+				error = "Cannot open transaction: transaction already opened with a different category name (" +
+					transaction->getCategory() + " vs " + category + ")";
+				return TransactionPtr();
+			}
+			if (OXT_UNLIKELY(transaction->getNodeName() != nodeName)) {
+				error = "Cannot open transaction: transaction "
+					"already opened with a different node name (" +
+					transaction->getNodeName() + " vs " + nodeName + ")";
+				return TransactionPtr();
+			}
+			if (OXT_UNLIKELY(transaction->getUnionStationKey() != unionStationKey)) {
+				error = "Cannot open transaction: transaction already opened with a "
+					"different key ('" + transaction->getUnionStationKey() +
+					"' vs '" + unionStationKey + "')";
+				return TransactionPtr();
+			}
+		}
+
+		client->openTransactions.insert(transaction->getTxnId());
+		transaction->ref();
+		return transaction;
+	}
+
+	/**
+	 * Drops the given client's reference to the transaction, closing
+	 * the transaction if that was the last reference.
+	 */
+	void releaseTransaction(Client *client, const TransactionPtr &transaction) {
+		Shard &shard = shardSet->forTxnId(transaction->getTxnId());
+		FileSinkPtr fileSink;
+		{
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			transaction->unref();
+			if (transaction->getRefCount() == 0) {
+				shard.transactions.remove(transaction->getTxnId());
+				fileSink = closeTransaction(client, shard, transaction);
+			}
+		}
+		if (fileSink != NULL) {
+			fileSink->writePendingData();
+		}
+	}
+
 	/**
 	 * Close the given transaction, potentially flushing its data to a sink.
+	 * If the data was appended to a file sink that now has data to write,
+	 * returns that sink. The caller must then call `writePendingData()` on
+	 * it after unlocking shard.syncher.
+	 *
+	 * @pre shard.syncher is locked
 	 */
-	void closeTransaction(Client *client, const TransactionPtr &transaction) {
-		if (!transaction->isDiscarded() && passesFilter(transaction)) {
+	FileSinkPtr closeTransaction(Client *client, Shard &shard, const TransactionPtr &transaction) {
+		FileSinkPtr fileSink;
+
+		if (!transaction->isDiscarded() && passesFilter(shard, transaction)) {
 			LogSinkPtr logSink;
 			if (devMode) {
-				logSink = openLogFile(client, transaction->getCategory());
+				logSink = openLogFile(client, shard, transaction->getCategory());
 			} else {
-				logSink = openRemoteSink(transaction->getUnionStationKey(),
+				logSink = openRemoteSink(shard, transaction->getUnionStationKey(),
 					transaction->getNodeName(), transaction->getCategory());
 			}
 			P_DEBUG("Closing transaction " << transaction->getTxnId() <<
-				": appending " << transaction->getBody().size() << " bytes "
+				": appending " << transaction->getBodySize() << " bytes "
 				"to sink " << logSink->inspect());
 			logSink->append(transaction);
+			if (devMode) {
+				if (fileSinkPolicy != FSP_WRITE_THROUGH) {
+					shard.fileSinksDirty = true;
+					fileSinkFlusher.start();
+				}
+				fileSink = boost::static_pointer_cast<FileSink>(logSink);
+				if (!fileSink->hasPendingData()) {
+					fileSink.reset();
+				}
+			}
 			closeLogSink(logSink);
 		}
+		return fileSink;
 	}
 
 	/**
@@ -976,9 +1075,8 @@ private:
 	void writeLogEntry(Client *client, const TransactionPtr &transaction,
 		const StaticString &timestamp, const StaticString &data, bool ack)
 	{
-		if (transaction->isDiscarded()) {
-			return;
-		}
+		// Validate outside the shard lock, so that controller threads
+		// only contend for the lock while actually appending.
 		if (OXT_UNLIKELY(!validLogContent(data))) {
 			SKC_ERROR(client, "Log entry data contains an invalid character");
 			if (ack && client != NULL) {
@@ -996,7 +1094,11 @@ private:
 			return;
 		}
 
-		transaction->append(timestamp, data);
+		Shard &shard = shardSet->forTxnId(transaction->getTxnId());
+		boost::lock_guard<boost::mutex> l(shard.syncher);
+		if (!transaction->isDiscarded()) {
+			transaction->append(timestamp, data);
+		}
 	}
 
 	void writeDetachEntry(Client *client, const TransactionPtr &transaction, bool ack) {
@@ -1014,13 +1116,16 @@ private:
 		writeLogEntry(client, transaction, timestamp, P_STATIC_STRING("DETACH"), ack);
 	}
 
-	bool passesFilter(const TransactionPtr &transaction) {
+	/**
+	 * @pre shard.syncher is locked
+	 */
+	bool passesFilter(Shard &shard, const TransactionPtr &transaction) {
 		StaticString filters(transaction->getFilters());
 		if (filters.empty()) {
 			return true;
 		}
 
-		StaticString body   = transaction->getBody();
+		string body         = transaction->getBody();
 		const char *current = filters.data();
 		const char *end     = filters.data() + filters.size();
 		bool result         = true;
@@ -1036,7 +1141,7 @@ private:
 			}
 
 			StaticString source(current, pos);
-			FilterSupport::Filter &filter = compileFilter(source);
+			FilterSupport::Filter &filter = compileFilter(shard, source);
 			result = filter.run(ctx);
 
 			current = tmp.data() + pos + 1;
@@ -1044,12 +1149,12 @@ private:
 		return result;
 	}
 
-	FilterSupport::Filter &compileFilter(const StaticString &source) {
+	FilterSupport::Filter &compileFilter(Shard &shard, const StaticString &source) {
 		// TODO: garbage collect filters based on time
-		FilterSupport::FilterPtr filter = filters.get(source);
+		FilterSupport::FilterPtr filter = shard.filters.get(source);
 		if (filter == NULL) {
 			filter = boost::make_shared<FilterSupport::Filter>(source);
-			filters.set(source, filter);
+			shard.filters.set(source, filter);
 		}
 		return *filter;
 	}
@@ -1084,21 +1189,19 @@ protected:
 		// Close any transactions that this client had opened.
 		for (s_it = client->openTransactions.begin(); s_it != s_end; s_it++) {
 			const string &txnId = *s_it;
-			TransactionPtr transaction = transactions.get(txnId);
+			TransactionPtr transaction = findTransaction(txnId);
 			if (OXT_UNLIKELY(transaction == NULL)) {
-				P_BUG("client->openTransactions is not a subset of this->transactions!");
+				P_BUG("client->openTransactions is not a subset of the open transactions!");
 			}
 
 			if (transaction->crashProtectEnabled()) {
 				writeDetachEntry(client, transaction, false);
 			} else {
+				Shard &shard = shardSet->forTxnId(txnId);
+				boost::lock_guard<boost::mutex> l(shard.syncher);
 				transaction->discard();
 			}
-			transaction->unref();
-			if (transaction->getRefCount() == 0) {
-				transactions.remove(transaction->getTxnId());
-				closeTransaction(client, transaction);
-			}
+			releaseTransaction(client, transaction);
 		}
 		client->openTransactions.clear();
 
@@ -1143,6 +1246,7 @@ protected:
 	virtual void onShutdown(bool forceDisconnect) {
 		gcTimer.stop();
 		flushTimer.stop();
+		fileSinkFlusher.stop();
 		ParentClass::onShutdown(forceDisconnect);
 	}
 
@@ -1153,6 +1257,17 @@ public:
 			return getHostName();
 		}
 
+		static void validate(const ConfigKit::Store &config,
+			vector<ConfigKit::Error> &errors)
+		{
+			using namespace ConfigKit;
+
+			if (parseFileSinkPolicy(config["ust_router_dump_file_policy"].asString()) == FSP_UNKNOWN) {
+				errors.push_back(Error("'{{ust_router_dump_file_policy}}' must be"
+					" 'buffered', 'write_through' or 'fdatasync'"));
+			}
+		}
+
 	public:
 		Schema()
 			: ServerKit::BaseServerSchema(false)
@@ -1166,39 +1281,66 @@ public:
 				"ust_router_default_node_name",
 				STRING_TYPE, OPTIONAL | CACHE_DEFAULT_VALUE,
 				getDefaultValueForDefaultNodeName);
+			add("thread_number", UINT_TYPE, OPTIONAL | READ_ONLY, 1);
 			add("ust_router_dev_mode", BOOL_TYPE, OPTIONAL, false);
+			add("ust_router_dump_file_policy", STRING_TYPE, OPTIONAL | READ_ONLY, "buffered");
 			add("union_station_gateway_address", STRING_TYPE, OPTIONAL | READ_ONLY, DEFAULT_UNION_STATION_GATEWAY_ADDRESS);
 			add("union_station_gateway_port", UINT_TYPE, OPTIONAL | READ_ONLY, DEFAULT_UNION_STATION_GATEWAY_PORT);
 			add("union_station_gateway_cert", STRING_TYPE, OPTIONAL | READ_ONLY);
 			add("union_station_proxy_address", STRING_TYPE, OPTIONAL | READ_ONLY);
+			add("union_station_spool_file", STRING_TYPE, OPTIONAL | READ_ONLY);
+			add("union_station_spool_size", UINT_TYPE, OPTIONAL | READ_ONLY,
+				DEFAULT_UST_ROUTER_SPOOL_SIZE);
+			add("union_station_max_concurrent_uploads", UINT_TYPE, OPTIONAL | READ_ONLY,
+				DEFAULT_UST_ROUTER_MAX_CONCURRENT_UPLOADS);
 			add("analytics_sink_flush_timer_interval", UINT_TYPE, OPTIONAL, 5);
 			add("analytics_sink_flush_interval", UINT_TYPE, OPTIONAL, 0);
 
+			addValidator(validate);
+
 			finalize();
 		}
 	};
 
+	/**
+	 * The transaction shards and RemoteSender, shared by all controller
+	 * threads. If not set before `initialize()` is called, the controller
+	 * creates a ShardSet with a single shard for itself.
+	 */
+	ShardSetPtr shardSet;
+
 	Controller(ServerKit::Context *context, const Schema &schema,
 		const Json::Value &initialConfig)
 		: ServerKit::BaseServer<Controller, Client>(context, schema, initialConfig),
-		  remoteSender(
-		      config["union_station_gateway_address"].asString(),
-		      config["union_station_gateway_port"].asUInt(),
-		      config["union_station_gateway_cert"].asString(),
-		      config["union_station_proxy_address"].asString()),
+		  threadNumber(config["thread_number"].asUInt()),
 		  gcTimer(getLoop()),
 		  flushTimer(getLoop()),
+		  fileSinkFlusher(getLoop()),
 		  devMode(false),
-		  sinkFlushInterval(0)
+		  sinkFlushInterval(0),
+		  fileSinkPolicy(parseFileSinkPolicy(
+		      config["ust_router_dump_file_policy"].asString()))
 	{
 		gcTimer.set<Controller, &Controller::garbageCollect>(this);
 		gcTimer.start(GARBAGE_COLLECTION_TIMEOUT, GARBAGE_COLLECTION_TIMEOUT);
 
 		flushTimer.set<Controller, &Controller::flushSomeSinks>(this);
+		fileSinkFlusher.set<Controller, &Controller::flushFileSinks>(this);
 
 		applyConfigUpdates();
 	}
 
+	virtual void initialize() {
+		if (shardSet == NULL) {
+			shardSet = boost::make_shared<ShardSet>(1, config);
+		}
+		if (threadNumber < 1 || threadNumber > shardSet->size()) {
+			throw ArgumentException("thread_number must be between 1 and "
+				"the number of shards");
+		}
+		ParentClass::initialize();
+	}
+
 	virtual StaticString getServerName() const {
 		return P_STATIC_STRING("UstRouter");
 	}
@@ -1215,12 +1357,18 @@ public:
 	virtual Json::Value inspectStateAsJson() const {
 		Json::Value doc = ParentClass::inspectStateAsJson();
 		doc["dev_mode"] = devMode;
-		doc["log_sink_cache"] = inspectLogSinkCacheStateAsJson();
-		doc["transactions"] = inspectTransactionsStateAsJson();
+		if (shardSet != NULL) {
+			// Only this thread's own shard, so that the states of all
+			// threads together describe every shard exactly once.
+			Shard &shard = (*shardSet)[threadNumber - 1];
+			boost::lock_guard<boost::mutex> l(shard.syncher);
+			doc["log_sink_cache"] = inspectLogSinkCacheStateAsJson(shard);
+			doc["transactions"] = inspectTransactionsStateAsJson(shard);
+		}
 		if (devMode) {
 			doc["dump_dir"] = config["ust_router_dump_dir"];
-		} else {
-			doc["remote_sender"] = remoteSender.inspectStateAsJson();
+		} else if (shardSet != NULL) {
+			doc["remote_sender"] = shardSet->remoteSender.inspectStateAsJson();
 		}
 		doc["default_node_name"] = config["ust_router_default_node_name"];
 		return doc;
@@ -1242,22 +1390,28 @@ public:
 		return doc;
 	}
 
-	Json::Value inspectLogSinkCacheStateAsJson() const {
+	/**
+	 * @pre shard.syncher is locked
+	 */
+	Json::Value inspectLogSinkCacheStateAsJson(const Shard &shard) const {
 		Json::Value doc(Json::objectValue);
 		LogSinkCache::const_iterator it;
-		LogSinkCache::const_iterator end = logSinkCache.end();
-		for (it = logSinkCache.begin(); it != end; it++) {
+		LogSinkCache::const_iterator end = shard.logSinkCache.end();
+		for (it = shard.logSinkCache.begin(); it != end; it++) {
 			const LogSinkPtr &logSink = it->second;
 			doc[createJsonKey(it->first)] = logSink->inspectStateAsJson();
 		}
 		return doc;
 	}
 
-	Json::Value inspectTransactionsStateAsJson() const {
+	/**
+	 * @pre shard.syncher is locked
+	 */
+	Json::Value inspectTransactionsStateAsJson(const Shard &shard) const {
 		Json::Value doc(Json::objectValue);
 		TransactionMap::const_iterator it;
-		TransactionMap::const_iterator end = transactions.end();
-		for (it = transactions.begin(); it != end; it++) {
+		TransactionMap::const_iterator end = shard.transactions.end();
+		for (it = shard.transactions.begin(); it != end; it++) {
 			const TransactionPtr &transaction = it->second;
 			doc[it->first.toString()] = transaction->inspectStateAsJson();
 		}
@@ -1266,17 +1420,6 @@ public:
 };
 
 
-inline struct ev_loop *
-Controller_getLoop(Controller *controller) {
-	return controller->getLoop();
-}
-
-inline RemoteSender &
-Controller_getRemoteSender(Controller *controller) {
-	return controller->remoteSender;
-}
-
-
 } // namespace UstRouter
 } // namespace Passenger
 
@@ -26,12 +26,23 @@
 #ifndef _PASSENGER_UST_ROUTER_FILE_SINK_H_
 #define _PASSENGER_UST_ROUTER_FILE_SINK_H_
 
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
+#include <deque>
+#include <cstring>
 #include <ctime>
+#include <cerrno>
+#include <unistd.h>
 #include <oxt/system_calls.hpp>
 #include <Exceptions.h>
 #include <FileDescriptor.h>
+#include <Logging.h>
+#include <SmallVector.h>
+#include <StaticString.h>
+#include <UstRouter/Transaction.h>
 #include <UstRouter/LogSink.h>
+#include <Utils/IOUtils.h>
 #include <Utils/StrIntUtils.h>
 
 namespace Passenger {
@@ -41,14 +52,139 @@ using namespace std;
 using namespace oxt;
 
 
+/**
+ * Controls how a FileSink trades throughput for durability.
+ *
+ *  - FSP_WRITE_THROUGH: every transaction is written with its own write()
+ *    call, as soon as it is closed.
+ *  - FSP_BUFFERED: transactions are collected in a write-behind buffer,
+ *    which is written out when it's full, at the end of the current event
+ *    loop iteration, or when the sink is flushed by the flush timer.
+ *  - FSP_FDATASYNC: like FSP_BUFFERED, but every write is followed by
+ *    fdatasync() so that the data survives a system crash.
+ */
+enum FileSinkPolicy {
+	FSP_WRITE_THROUGH,
+	FSP_BUFFERED,
+	FSP_FDATASYNC,
+	FSP_UNKNOWN
+};
+
+inline FileSinkPolicy
+parseFileSinkPolicy(const StaticString &policy) {
+	if (policy == "buffered") {
+		return FSP_BUFFERED;
+	} else if (policy == "write_through") {
+		return FSP_WRITE_THROUGH;
+	} else if (policy == "fdatasync") {
+		return FSP_FDATASYNC;
+	} else {
+		return FSP_UNKNOWN;
+	}
+}
+
+inline const char *
+fileSinkPolicyToString(FileSinkPolicy policy) {
+	switch (policy) {
+	case FSP_WRITE_THROUGH:
+		return "write_through";
+	case FSP_BUFFERED:
+		return "buffered";
+	case FSP_FDATASYNC:
+		return "fdatasync";
+	default:
+		return "unknown";
+	}
+}
+
+
+/**
+ * Appends the data of closed transactions to a dump file.
+ *
+ * Like all log sinks, a FileSink is protected by the lock of the Shard
+ * that it lives in. Waiting for the disk while holding that lock would
+ * stall every controller thread that touches the shard, so `append()`
+ * and `flush()` only queue the data to be written. The caller writes it
+ * out with `writePendingData()` after releasing the shard lock.
+ */
 class FileSink: public LogSink {
+private:
+	/**
+	 * Data to be written with a single writev(): the contents of the
+	 * buffer, possibly followed by a transaction that was not buffered.
+	 */
+	struct PendingWrite {
+		string buffered;
+		TransactionPtr transaction;
+	};
+
+	/** Protects `pending`. */
+	boost::mutex pendingSyncher;
+	deque<PendingWrite> pending;
+	/**
+	 * Serializes `writePendingData()` calls, so that pending writes are
+	 * written in the order in which they were queued.
+	 */
+	boost::mutex writeSyncher;
+
+	void queueWrite(const TransactionPtr &transaction) {
+		boost::lock_guard<boost::mutex> l(pendingSyncher);
+		pending.push_back(PendingWrite());
+		pending.back().buffered.assign(buffer, bufferSize);
+		pending.back().transaction = transaction;
+		bufferSize = 0;
+	}
+
+	bool realFlush() {
+		if (bufferSize > 0) {
+			P_DEBUG("Flushing " << inspect() << ": " << bufferSize << " bytes");
+			lastFlushed = ev_time();
+			queueWrite(TransactionPtr());
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	bool writeOut(const PendingWrite &write) {
+		SmallVector<StaticString, 16> data;
+		unsigned int chunkCount = 0;
+
+		if (write.transaction != NULL) {
+			chunkCount = write.transaction->getBodyChunkCount();
+		}
+		data.resize(chunkCount + 1);
+		data[0] = write.buffered;
+		if (write.transaction != NULL) {
+			write.transaction->getBodyChunks(&data[1]);
+		}
+
+		try {
+			gatheredWrite(fd, &data[0], chunkCount + 1);
+			return true;
+		} catch (const SystemException &e) {
+			P_ERROR("Cannot write to " << inspect() << ": " << e.what());
+			return false;
+		}
+	}
+
 public:
+	/* Large enough to hold a few dozen typical request transactions,
+	 * so that a busy dump file is written with one writev() per
+	 * event loop iteration instead of one write() per transaction.
+	 */
+	static const unsigned int BUFFER_CAPACITY = 64 * 1024;
+
 	string filename;
 	FileDescriptor fd;
+	FileSinkPolicy policy;
+	char buffer[BUFFER_CAPACITY];
+	unsigned int bufferSize;
 
-	FileSink(Controller *controller, const string &_filename)
-		: LogSink(controller),
-		  filename(_filename)
+	FileSink(const string &_filename, FileSinkPolicy _policy = FSP_BUFFERED)
+		: filename(_filename),
+		  policy(_policy),
+		  bufferSize(0)
 	{
 		fd.assign(syscalls::open(_filename.c_str(),
 			O_CREAT | O_WRONLY | O_APPEND,
@@ -60,16 +196,88 @@ public:
 		}
 	}
 
+	~FileSink() {
+		// Calling non-virtual flush method
+		realFlush();
+		writePendingData();
+	}
+
+	/**
+	 * Buffers the transaction, or queues it to be written by the next
+	 * `writePendingData()` call if the policy is FSP_WRITE_THROUGH or if
+	 * the transaction doesn't fit in the buffer.
+	 */
 	virtual void append(const TransactionPtr &transaction) {
-		StaticString data = transaction->getBody();
+		unsigned int chunkCount = transaction->getBodyChunkCount();
+
 		LogSink::append(transaction);
-		syscalls::write(fd, data.data(), data.size());
+
+		if (policy == FSP_WRITE_THROUGH
+		 || bufferSize + transaction->getBodySize() > BUFFER_CAPACITY)
+		{
+			lastFlushed = ev_time();
+			queueWrite(transaction);
+		} else {
+			SmallVector<StaticString, 16> data;
+			data.resize(chunkCount);
+			transaction->getBodyChunks(&data[0]);
+			for (unsigned int i = 0; i < chunkCount; i++) {
+				memcpy(buffer + bufferSize, data[i].data(), data[i].size());
+				bufferSize += data[i].size();
+			}
+		}
+	}
+
+	/** Queues the buffer to be written by the next `writePendingData()` call. */
+	virtual bool flush() {
+		return realFlush();
+	}
+
+	bool hasBufferedData() const {
+		return bufferSize > 0;
+	}
+
+	bool hasPendingData() {
+		boost::lock_guard<boost::mutex> l(pendingSyncher);
+		return !pending.empty();
+	}
+
+	/**
+	 * Writes the data that has been queued by `append()` and `flush()` to
+	 * the file, followed by fdatasync() if the policy is FSP_FDATASYNC.
+	 * Must not be called while holding the shard lock.
+	 */
+	void writePendingData() {
+		boost::lock_guard<boost::mutex> l(writeSyncher);
+		bool written = false;
+
+		while (true) {
+			PendingWrite write;
+			{
+				boost::lock_guard<boost::mutex> l2(pendingSyncher);
+				if (pending.empty()) {
+					break;
+				}
+				pending.front().buffered.swap(write.buffered);
+				write.transaction = pending.front().transaction;
+				pending.pop_front();
+			}
+			written = writeOut(write) || written;
+		}
+
+		if (written && policy == FSP_FDATASYNC && fdatasync(fd) == -1) {
+			int e = errno;
+			P_ERROR("Cannot fdatasync() " << inspect() << ": " <<
+				strerror(e) << " (errno=" << e << ")");
+		}
 	}
 
 	virtual Json::Value inspectStateAsJson() const {
 		Json::Value doc = LogSink::inspectStateAsJson();
 		doc["type"] = "file";
 		doc["filename"] = filename;
+		doc["policy"] = fileSinkPolicyToString(policy);
+		doc["buffer_size"] = byteSizeToJson(bufferSize);
 		return doc;
 	}
 
@@ -78,6 +286,8 @@ public:
 	}
 };
 
+typedef boost::shared_ptr<FileSink> FileSinkPtr;
+
 
 } // namespace UstRouter
 } // namespace Passenger
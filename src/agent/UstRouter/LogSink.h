@@ -40,14 +40,14 @@ using namespace std;
 using namespace boost;
 
 
-class Controller;
-inline struct ev_loop *Controller_getLoop(Controller *controller);
-
-
+/**
+ * A destination for the data of closed transactions. Log sinks live in a
+ * Shard and may be used by multiple controller threads (one at a time),
+ * so they obtain timestamps with ev_time() instead of from a particular
+ * event loop.
+ */
 class LogSink {
 public:
-	Controller *controller;
-
 	/**
 	 * Marks how many times this LogSink is currently opened, i.e. the
 	 * number of Transaction objects currently referencing this LogSink.
@@ -81,9 +81,8 @@ public:
 	 */
 	size_t totalBytesWritten;
 
-	LogSink(Controller *_controller)
-		: controller(_controller),
-		  opened(0),
+	LogSink()
+		: opened(0),
 		  lastWrittenTo(0),
 		  lastClosed(0),
 		  lastFlushed(0),
@@ -102,12 +101,12 @@ public:
 
 	virtual void append(const TransactionPtr &transaction) {
 		assert(!transaction->isDiscarded());
-		lastWrittenTo = ev_now(Controller_getLoop(controller));
-		totalBytesWritten += transaction->getBody().size();
+		lastWrittenTo = ev_time();
+		totalBytesWritten += transaction->getBodySize();
 	}
 
 	virtual bool flush() {
-		lastFlushed = ev_now(Controller_getLoop(controller));
+		lastFlushed = ev_time();
 		return true;
 	}
 
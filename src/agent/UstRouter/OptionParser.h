@@ -69,6 +69,21 @@ ustRouterUsage() {
 	printf("      --dev-mode              Enable development mode: dump data to a directory\n");
 	printf("                              instead of sending them to the Union Station gateway\n");
 	printf("      --dump-dir  PATH        Directory to dump to\n");
+	printf("      --dump-file-policy POLICY\n");
+	printf("                              How to write to dump files: 'buffered',\n");
+	printf("                              'write_through' or 'fdatasync'.\n");
+	printf("                              Default: buffered\n");
+	printf("      --spool-file PATH       Keep data that hasn't been sent to the Union\n");
+	printf("                              Station gateway yet in this file, so that it\n");
+	printf("                              survives restarts. Default: keep it in memory\n");
+	printf("      --spool-size BYTES      Size of the spool. Default: %u\n",
+		(unsigned int) DEFAULT_UST_ROUTER_SPOOL_SIZE);
+	printf("      --max-concurrent-uploads NUMBER\n");
+	printf("                              Number of uploads to the Union Station gateway\n");
+	printf("                              to keep in flight. Default: %u\n",
+		(unsigned int) DEFAULT_UST_ROUTER_MAX_CONCURRENT_UPLOADS);
+	printf("      --threads NUMBER        Number of threads to use for receiving data.\n");
+	printf("                              Default: 1\n");
 	printf("\n");
 	printf("Other options (optional):\n");
 	printf("      --user USERNAME         Lower privilege to the given user. Only has\n");
@@ -149,6 +164,21 @@ parseUstRouterOption(int argc, const char *argv[], int &i, VariantMap &options)
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--dump-dir")) {
 		options.set("ust_router_dump_dir", argv[i + 1]);
 		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--dump-file-policy")) {
+		options.set("ust_router_dump_file_policy", argv[i + 1]);
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--threads")) {
+		options.setInt("ust_router_threads", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--spool-file")) {
+		options.set("union_station_spool_file", argv[i + 1]);
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--spool-size")) {
+		options.setUint("union_station_spool_size", atoi(argv[i + 1]));
+		i += 2;
+	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--max-concurrent-uploads")) {
+		options.setUint("union_station_max_concurrent_uploads", atoi(argv[i + 1]));
+		i += 2;
 	} else if (p.isValueFlag(argc, i, argv[i], '\0', "--user")) {
 		options.set("analytics_log_user", argv[i + 1]);
 		i += 2;
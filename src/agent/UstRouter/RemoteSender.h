@@ -33,22 +33,30 @@
 #include <zlib.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <oxt/thread.hpp>
+#include <algorithm>
 #include <string>
 #include <list>
+#include <vector>
+#include <cstring>
 #include <jsoncpp/json.h>
 #include <modp_b64.h>
 
 #include <Logging.h>
+#include <Constants.h>
 #include <StaticString.h>
 #include <Utils.h>
-#include <Utils/BlockingQueue.h>
+#include <Utils/StrIntUtils.h>
 #include <Utils/SystemTime.h>
 #include <Utils/ScopeGuard.h>
 #include <Utils/JsonUtils.h>
 #include <Utils/Curl.h>
+#include <UstRouter/Spool.h>
 
 namespace Passenger {
 
@@ -64,19 +72,23 @@ using namespace oxt;
 
 
 class RemoteSender {
-private:
-	struct Item {
-		bool exit;
-		bool compressed;
-		string unionStationKey;
-		string nodeName;
-		string category;
-		string data;
+public:
+	/**
+	 * Packets with the same key, node name and category are combined into
+	 * a single upload, up to this many bytes of uncompressed data per upload.
+	 * A single packet larger than this is uploaded on its own.
+	 */
+	static const unsigned int MAX_BATCH_SIZE = 1024 * 1024;
 
-		Item() {
-			exit = false;
-			compressed = false;
-		}
+private:
+	/**
+	 * Every spooled packet starts with this header, followed by the key,
+	 * node name, category and the uncompressed data.
+	 */
+	struct RecordHeader {
+		boost::uint32_t keySize;
+		boost::uint32_t nodeNameSize;
+		boost::uint32_t categorySize;
 	};
 
 	class Server {
@@ -147,25 +159,29 @@ private:
 					throw IOException("Unable to create a CURL handle");
 				}
 			}
-			curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
-			curl_easy_setopt(curl, CURLOPT_TIMEOUT, 180);
-			curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, lastCurlErrorMessage);
-			curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-			curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curlDataReceived);
-			curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+			configureHandle(curl, lastCurlErrorMessage, &responseBody);
+			responseBody.clear();
+		}
+
+		void configureHandle(CURL *handle, char *errorBuffer, string *body) {
+			curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1);
+			curl_easy_setopt(handle, CURLOPT_TIMEOUT, 180);
+			curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, errorBuffer);
+			curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+			curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, curlDataReceived);
+			curl_easy_setopt(handle, CURLOPT_WRITEDATA, body);
 			if (certificate.empty()) {
-				curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
+				curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0);
 			} else {
-				curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1);
-				curl_easy_setopt(curl, CURLOPT_CAINFO, certificate.c_str());
+				curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 1);
+				curl_easy_setopt(handle, CURLOPT_CAINFO, certificate.c_str());
 			}
 			/* No host name verification because Curl thinks the
 			 * host name is the IP address. But if we have the
 			 * certificate then it doesn't matter.
 			 */
-			curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);
-			setCurlProxy(curl, *proxyInfo);
-			responseBody.clear();
+			curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0);
+			setCurlProxy(handle, *proxyInfo);
 		}
 
 		void prepareRequest(const string &url) {
@@ -188,18 +204,20 @@ private:
 			}
 		}
 
-		SendResult handleSendResponse(const Item &item) {
+		SendResult handleSendResponse(CURL *handle, const string &responseBody,
+			const string &unionStationKey)
+		{
 			Json::Reader reader;
 			Json::Value response;
 			long httpCode = -1;
 
-			curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
+			curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &httpCode);
 
 			if (!reader.parse(responseBody, response, false) || !validateResponse(response)) {
 				setRequestError(
 					"The Union Station gateway server " + ip +
 					" encountered an error while processing sent analytics data. "
-					"It sent an invalid response. Key: " + item.unionStationKey
+					"It sent an invalid response. Key: " + unionStationKey
 					+ ". Parse error: " + reader.getFormattedErrorMessages()
 					+ "; HTTP code: " + toString(httpCode)
 					+ "; data: \"" + cEscapeString(responseBody) + "\"");
@@ -209,14 +227,14 @@ private:
 					handleResponseSuccess();
 					P_DEBUG("The Union Station gateway server " << ip
 						<< " accepted the packet. Key: "
-						<< item.unionStationKey);
+						<< unionStationKey);
 					return SR_OK;
 				} else {
 					setRequestError(
 						"The Union Station gateway server " + ip
 						+ " encountered an error while processing sent "
 						"analytics data. It sent an invalid response. Key: "
-						+ item.unionStationKey + ". HTTP code: "
+						+ unionStationKey + ". HTTP code: "
 						+ toString(httpCode) + ". Data: \""
 						+ cEscapeString(responseBody) + "\"");
 					return SR_MALFUNCTION;
@@ -226,17 +244,17 @@ private:
 				setPacketRejectedError(
 					"The Union Station gateway server "
 					+ ip + " did not accept the sent analytics data. "
-					"Key: " + item.unionStationKey + ". "
+					"Key: " + unionStationKey + ". "
 					"Error: " + response["message"].asString());
 				return SR_REJECTED;
 			}
 		}
 
-		void handleSendError(const Item &item) {
+		void handleSendError(const string &unionStationKey, const char *errorMessage) {
 			setRequestError(
 				"Could not send data to Union Station gateway server " +
-				ip + ". It might be down. Key: " + item.unionStationKey +
-				". Error: " + lastCurlErrorMessage);
+				ip + ". It might be down. Key: " + unionStationKey +
+				". Error: " + errorMessage);
 		}
 
 		void setPingError(const string &message) {
@@ -281,14 +299,14 @@ private:
 		}
 
 		static size_t curlDataReceived(void *buffer, size_t size, size_t nmemb, void *userData) {
-			Server *self = (Server *) userData;
-			self->responseBody.append((const char *) buffer, size * nmemb);
+			string *body = (string *) userData;
+			body->append((const char *) buffer, size * nmemb);
 			return size * nmemb;
 		}
 
 	public:
-		Server(const string &ip, const string &hostName, unsigned short port,
-			const string &cert, const CurlProxyInfo *proxyInfo)
+		Server(const string &scheme, const string &ip, const string &hostName,
+			unsigned short port, const string &cert, const CurlProxyInfo *proxyInfo)
 		{
 			this->ip = ip;
 			this->port = port;
@@ -304,9 +322,9 @@ private:
 
 			// Older libcurl versions didn't strdup() any option
 			// strings so we need to keep these in memory.
-			pingURL = string("https://") + ip + ":" + toString(port) +
+			pingURL = scheme + "://" + ip + ":" + toString(port) +
 				"/ping";
-			sinkURL = string("https://") + ip + ":" + toString(port) +
+			sinkURL = scheme + "://" + ip + ":" + toString(port) +
 				"/sink";
 
 			curl = NULL;
@@ -354,66 +372,26 @@ private:
 			}
 		}
 
-		SendResult send(const Item &item) {
-			ScopeGuard guard(boost::bind(&Server::resetConnection, this));
-			prepareRequest(sinkURL);
-
-			struct curl_httppost *post = NULL;
-			struct curl_httppost *last = NULL;
-			string base64_data;
-
-			curl_formadd(&post, &last,
-				CURLFORM_PTRNAME, "key",
-				CURLFORM_PTRCONTENTS, item.unionStationKey.c_str(),
-				CURLFORM_CONTENTSLENGTH, (long) item.unionStationKey.size(),
-				CURLFORM_END);
-			curl_formadd(&post, &last,
-				CURLFORM_PTRNAME, "node_name",
-				CURLFORM_PTRCONTENTS, item.nodeName.c_str(),
-				CURLFORM_CONTENTSLENGTH, (long) item.nodeName.size(),
-				CURLFORM_END);
-			curl_formadd(&post, &last,
-				CURLFORM_PTRNAME, "category",
-				CURLFORM_PTRCONTENTS, item.category.c_str(),
-				CURLFORM_CONTENTSLENGTH, (long) item.category.size(),
-				CURLFORM_END);
-			curl_formadd(&post, &last,
-				CURLFORM_PTRNAME, "client_description",
-				CURLFORM_PTRCONTENTS, UST_ROUTER_CLIENT_DESCRIPTION,
-				CURLFORM_CONTENTSLENGTH, (long) sizeof(UST_ROUTER_CLIENT_DESCRIPTION),
-				CURLFORM_END);
-			if (item.compressed) {
-				base64_data = modp::b64_encode(item.data);
-				curl_formadd(&post, &last,
-					CURLFORM_PTRNAME, "data",
-					CURLFORM_PTRCONTENTS, base64_data.data(),
-					CURLFORM_CONTENTSLENGTH, (long) base64_data.size(),
-					CURLFORM_END);
-				curl_formadd(&post, &last,
-					CURLFORM_PTRNAME, "compressed",
-					CURLFORM_PTRCONTENTS, "1",
-					CURLFORM_END);
-			} else {
-				curl_formadd(&post, &last,
-					CURLFORM_PTRNAME, "data",
-					CURLFORM_PTRCONTENTS, item.data.c_str(),
-					CURLFORM_CONTENTSLENGTH, (long) item.data.size(),
-					CURLFORM_END);
-			}
-
-			curl_easy_setopt(curl, CURLOPT_HTTPGET, 0);
-			curl_easy_setopt(curl, CURLOPT_HTTPPOST, post);
-			P_DEBUG("Sending Union Station packet: key=" << item.unionStationKey <<
-				", node=" << item.nodeName << ", category=" << item.category <<
-				", compressedDataSize=" << item.data.size());
-			CURLcode code = curl_easy_perform(curl);
-			curl_formfree(post);
+		/**
+		 * Configures `handle` for posting `post` to this server. The response
+		 * body is written to `body`. The transfer itself is performed by the
+		 * caller, after which it must call `finishUpload()`.
+		 */
+		void prepareUpload(CURL *handle, char *errorBuffer, string *body,
+			struct curl_httppost *post)
+		{
+			configureHandle(handle, errorBuffer, body);
+			curl_easy_setopt(handle, CURLOPT_URL, sinkURL.c_str());
+			curl_easy_setopt(handle, CURLOPT_HTTPPOST, post);
+		}
 
+		SendResult finishUpload(CURL *handle, CURLcode code, const string &body,
+			const char *errorMessage, const string &unionStationKey)
+		{
 			if (code == CURLE_OK) {
-				guard.clear();
-				return handleSendResponse(item);
+				return handleSendResponse(handle, body, unionStationKey);
 			} else {
-				handleSendError(item);
+				handleSendError(unionStationKey, errorMessage);
 				return SR_DOWN;
 			}
 		}
@@ -452,46 +430,132 @@ private:
 
 	typedef boost::shared_ptr<Server> ServerPtr;
 
+	/**
+	 * A POST to a gateway server that is in progress. It combines one or
+	 * more spooled packets with the same key, node name and category.
+	 */
+	struct Upload {
+		ServerPtr server;
+		CURL *curl;
+		struct curl_httppost *post;
+		string unionStationKey;
+		string nodeName;
+		string category;
+		/**
+		 * The spool records that make up this upload. They stay claimed in
+		 * the spool until the gateway has responded, so that they are not
+		 * lost if the upload fails or if we crash before it finishes.
+		 */
+		vector<UstRouter::Spool::RecordId> recordIds;
+		/**
+		 * Copies of the records, because the spool may move them around
+		 * while this upload is being prepared outside the lock.
+		 */
+		vector<string> records;
+		/** The total size of the uncompressed data in `records`. */
+		size_t dataSize;
+		string data;
+		bool compressed;
+		string responseBody;
+		char errorMessage[CURL_ERROR_SIZE];
+
+		Upload()
+			: curl(NULL),
+			  post(NULL),
+			  dataSize(0),
+			  compressed(false)
+		{
+			errorMessage[0] = '\0';
+		}
+
+		~Upload() {
+			if (curl != NULL) {
+				curl_easy_cleanup(curl);
+			}
+			if (post != NULL) {
+				curl_formfree(post);
+			}
+		}
+	};
+
+	typedef boost::shared_ptr<Upload> UploadPtr;
+
+	string gatewayScheme;
 	string gatewayAddress;
 	unsigned short gatewayPort;
 	string certificate;
 	CurlProxyInfo proxyInfo;
-	BlockingQueue<Item> queue;
+	unsigned int maxConcurrentUploads;
 	oxt::thread *thr;
 
 	mutable boost::mutex syncher;
+	boost::condition_variable cond;
+	boost::scoped_ptr<UstRouter::Spool> spool;
+	bool exitRequested;
 	list<ServerPtr> upServers;
 	vector<ServerPtr> downServers;
 	time_t lastCheckupTime, nextCheckupTime;
 	string lastDnsErrorMessage;
 	unsigned int packetsAccepted, packetsRejected, packetsDropped;
+	unsigned int uploadsSent, uploadsInFlight;
+
+	// Only accessed by the sender thread.
+	CURLM *multi;
+	list<UploadPtr> uploads;
+	MonotonicTimeUsec lastSpoolSyncTime;
+	MonotonicTimeUsec spoolCompactionRetryTime;
 
 	void threadMain() {
 		ScopeGuard guard(boost::bind(&RemoteSender::freeThreadData, this));
 
 		while (true) {
-			Item item;
-			bool hasItem;
+			bool exiting;
 
-			if (firstStarted()) {
-				item = queue.get();
-				hasItem = true;
-			} else {
-				hasItem = queue.timedGet(item, msecUntilNextCheckup());
+			waitForWork();
+			{
+				boost::lock_guard<boost::mutex> l(syncher);
+				exiting = exitRequested;
 			}
 
-			if (hasItem) {
-				if (item.exit) {
-					return;
-				} else {
-					if (timeForCheckup()) {
-						recheckServers();
-					}
-					sendOut(item);
-				}
-			} else if (timeForCheckup()) {
+			if (timeForCheckup() && (!firstStarted() || !spoolEmpty())) {
 				recheckServers();
 			}
+			startUploads();
+
+			if (!uploads.empty()) {
+				performUploads();
+			} else if (exiting) {
+				// Nothing more can be sent, either because the spool is
+				// empty or because no servers are available.
+				syncSpool(true);
+				return;
+			}
+			syncSpool(false);
+			compactSpool();
+		}
+	}
+
+	/**
+	 * Blocks until there is something to do: spooled packets that can be
+	 * sent, a checkup, or an exit request. Returns immediately while
+	 * uploads are in progress.
+	 */
+	void waitForWork() {
+		boost::unique_lock<boost::mutex> l(syncher);
+
+		while (uploads.empty() && !exitRequested) {
+			bool haveSendableData = !spool->empty()
+				&& (!upServers.empty() || nextCheckupTime == 0);
+			if (haveSendableData || shouldCompactSpoolUnlocked()) {
+				return;
+			} else if (nextCheckupTime == 0) {
+				cond.wait(l);
+			} else if (SystemTime::get() >= nextCheckupTime) {
+				return;
+			} else {
+				cond.timed_wait(l, boost::posix_time::milliseconds(
+					msecUntilNextCheckupUnlocked()));
+			}
 		}
 	}
 
@@ -500,6 +564,11 @@ private:
 		return nextCheckupTime == 0;
 	}
 
+	bool spoolEmpty() const {
+		boost::lock_guard<boost::mutex> l(syncher);
+		return spool->empty();
+	}
+
 	void recheckServers() {
 		P_INFO("Rechecking Union Station gateway servers (" << gatewayAddress << ")...");
 
@@ -514,11 +583,11 @@ private:
 			P_ERROR(e.what());
 			// DNS errors tend to be temporary, so retry
 			// after a short timeout.
+			boost::lock_guard<boost::mutex> l(syncher);
 			scheduleNextCheckup(1 * 60);
 			// Take note of the error, but do not change the server
 			// list so that the RemoteSender can keep working with
 			// the last known server list.
-			boost::lock_guard<boost::mutex> l(syncher);
 			this->lastCheckupTime = SystemTime::get();
 			this->lastDnsErrorMessage = e.what();
 			return;
@@ -529,8 +598,8 @@ private:
 
 		for (it = ips.begin(); it != ips.end(); it++) {
 			ServerPtr server = boost::make_shared<Server>(
-				*it, gatewayAddress, gatewayPort, certificate,
-				&proxyInfo);
+				gatewayScheme, *it, gatewayAddress, gatewayPort,
+				certificate, &proxyInfo);
 			if (server->ping()) {
 				upServers.push_back(server);
 			} else {
@@ -539,6 +608,7 @@ private:
 		}
 		P_INFO(upServers.size() << " Union Station gateway servers are up");
 
+		boost::lock_guard<boost::mutex> l(syncher);
 		if (downServers.empty()) {
 			if (upServers.empty()) {
 				// The DNS lookup was successful, but returned no results.
@@ -560,7 +630,6 @@ private:
 			scheduleNextCheckup(1 * 60);
 		}
 
-		boost::lock_guard<boost::mutex> l(syncher);
 		this->lastCheckupTime = SystemTime::get();
 		this->upServers = upServers;
 		this->downServers = downServers;
@@ -568,16 +637,28 @@ private:
 	}
 
 	void freeThreadData() {
+		foreach (const UploadPtr &upload, uploads) {
+			curl_multi_remove_handle(multi, upload->curl);
+		}
+		uploads.clear();
+		if (multi != NULL) {
+			curl_multi_cleanup(multi);
+			multi = NULL;
+		}
+
 		boost::lock_guard<boost::mutex> l(syncher);
 		// Invoke destructors inside this thread.
 		upServers.clear();
 		downServers.clear();
+		uploadsInFlight = 0;
 	}
 
 	/**
 	 * Schedules the next checkup to be run after the given number
 	 * of seconds, unless there's already a checkup scheduled for
 	 * earlier.
+	 *
+	 * @pre syncher is locked
 	 */
 	void scheduleNextCheckup(unsigned int seconds) {
 		time_t now = SystemTime::get();
@@ -587,8 +668,7 @@ private:
 		}
 	}
 
-	unsigned int msecUntilNextCheckup() const {
-		boost::lock_guard<boost::mutex> l(syncher);
+	unsigned int msecUntilNextCheckupUnlocked() const {
 		time_t now = SystemTime::get();
 		if (now >= nextCheckupTime) {
 			return 0;
@@ -602,73 +682,346 @@ private:
 		return SystemTime::get() >= nextCheckupTime;
 	}
 
-	void sendOut(const Item &item) {
-		boost::unique_lock<boost::mutex> l(syncher);
-		bool done = false;
-		bool accepted = false;
-		bool rejected = false;
-		bool upServersEmpty;
-
-		while (!done && !upServers.empty()) {
-			// Pick first available server and put it on the back of the list
-			// for round-robin load balancing.
-			ServerPtr server = upServers.front();
-
-			l.unlock();
-			Server::SendResult result = server->send(item);
-			l.lock();
-
-			if (result == Server::SR_OK) {
-				upServers.pop_front();
-				upServers.push_back(server);
-				accepted = true;
-				done = true;
-			} else if (result == Server::SR_REJECTED) {
-				upServers.pop_front();
-				upServers.push_back(server);
-				rejected = true;
-				done = true;
-			} else {
-				upServers.pop_front();
-				downServers.push_back(server);
+	static bool parseRecord(const StaticString &record, StaticString &unionStationKey,
+		StaticString &nodeName, StaticString &category, StaticString &data)
+	{
+		RecordHeader header;
+
+		if (record.size() < sizeof(header)) {
+			return false;
+		}
+		memcpy(&header, record.data(), sizeof(header));
+		size_t headerSize = sizeof(header) + header.keySize + header.nodeNameSize
+			+ header.categorySize;
+		if (record.size() < headerSize) {
+			return false;
+		}
+
+		const char *pos = record.data() + sizeof(header);
+		unionStationKey = StaticString(pos, header.keySize);
+		pos += header.keySize;
+		nodeName = StaticString(pos, header.nodeNameSize);
+		pos += header.nodeNameSize;
+		category = StaticString(pos, header.categorySize);
+		pos += header.categorySize;
+		data = StaticString(pos, record.size() - headerSize);
+		return true;
+	}
+
+	/**
+	 * Claims packets from the spool and starts uploading them, as long as
+	 * there are servers available and fewer than `maxConcurrentUploads`
+	 * uploads in progress. Packets with the same key, node name and
+	 * category are combined into a single upload of at most
+	 * MAX_BATCH_SIZE bytes.
+	 */
+	void startUploads() {
+		vector<UploadPtr> newUploads;
+
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			UstRouter::Spool::RecordId id, next;
+			unsigned int slots;
+
+			if (upServers.empty() || uploads.size() >= maxConcurrentUploads) {
+				return;
+			}
+			slots = maxConcurrentUploads - uploads.size();
+
+			for (id = spool->firstAvailable(); id != 0; id = next) {
+				StaticString record = spool->get(id);
+				StaticString unionStationKey, nodeName, category, data;
+				UploadPtr upload;
+
+				next = spool->nextAvailable(id);
+				if (!parseRecord(record, unionStationKey, nodeName, category, data)) {
+					P_WARN("Dropping corrupt Union Station packet from the spool");
+					spool->acknowledge(id);
+					packetsDropped++;
+					continue;
+				}
+
+				foreach (const UploadPtr &candidate, newUploads) {
+					if (candidate->unionStationKey == unionStationKey
+					 && candidate->nodeName == nodeName
+					 && candidate->category == category
+					 && candidate->dataSize + data.size() <= MAX_BATCH_SIZE)
+					{
+						upload = candidate;
+						break;
+					}
+				}
+				if (upload == NULL) {
+					if (newUploads.size() == slots) {
+						break;
+					}
+					upload = boost::make_shared<Upload>();
+					upload->unionStationKey = unionStationKey;
+					upload->nodeName = nodeName;
+					upload->category = category;
+					// Pick the first available server and put it on the back
+					// of the list for round-robin load balancing.
+					upload->server = upServers.front();
+					upServers.pop_front();
+					upServers.push_back(upload->server);
+					newUploads.push_back(upload);
+				}
+
+				upload->recordIds.push_back(id);
+				upload->records.push_back(record);
+				upload->dataSize += data.size();
+				spool->claim(id);
+			}
+
+			uploadsInFlight += newUploads.size();
+		}
+
+		foreach (const UploadPtr &upload, newUploads) {
+			startUpload(upload);
+		}
+	}
+
+	void startUpload(const UploadPtr &upload) {
+		vector<StaticString> parts;
+		struct curl_httppost *last = NULL;
+
+		parts.reserve(upload->records.size());
+		foreach (const string &record, upload->records) {
+			StaticString unionStationKey, nodeName, category, data;
+			parseRecord(record, unionStationKey, nodeName, category, data);
+			parts.push_back(data);
+		}
+
+		if (compress(&parts[0], parts.size(), upload->data)) {
+			upload->data = modp::b64_encode(upload->data);
+			upload->compressed = true;
+		} else {
+			upload->data.clear();
+			foreach (const StaticString &part, parts) {
+				upload->data.append(part.data(), part.size());
+			}
+		}
+
+		curl_formadd(&upload->post, &last,
+			CURLFORM_PTRNAME, "key",
+			CURLFORM_PTRCONTENTS, upload->unionStationKey.c_str(),
+			CURLFORM_CONTENTSLENGTH, (long) upload->unionStationKey.size(),
+			CURLFORM_END);
+		curl_formadd(&upload->post, &last,
+			CURLFORM_PTRNAME, "node_name",
+			CURLFORM_PTRCONTENTS, upload->nodeName.c_str(),
+			CURLFORM_CONTENTSLENGTH, (long) upload->nodeName.size(),
+			CURLFORM_END);
+		curl_formadd(&upload->post, &last,
+			CURLFORM_PTRNAME, "category",
+			CURLFORM_PTRCONTENTS, upload->category.c_str(),
+			CURLFORM_CONTENTSLENGTH, (long) upload->category.size(),
+			CURLFORM_END);
+		curl_formadd(&upload->post, &last,
+			CURLFORM_PTRNAME, "client_description",
+			CURLFORM_PTRCONTENTS, UST_ROUTER_CLIENT_DESCRIPTION,
+			CURLFORM_CONTENTSLENGTH, (long) sizeof(UST_ROUTER_CLIENT_DESCRIPTION),
+			CURLFORM_END);
+		curl_formadd(&upload->post, &last,
+			CURLFORM_PTRNAME, "data",
+			CURLFORM_PTRCONTENTS, upload->data.data(),
+			CURLFORM_CONTENTSLENGTH, (long) upload->data.size(),
+			CURLFORM_END);
+		if (upload->compressed) {
+			curl_formadd(&upload->post, &last,
+				CURLFORM_PTRNAME, "compressed",
+				CURLFORM_PTRCONTENTS, "1",
+				CURLFORM_END);
+		}
+
+		P_DEBUG("Sending Union Station packets: key=" << upload->unionStationKey <<
+			", node=" << upload->nodeName << ", category=" << upload->category <<
+			", packets=" << upload->records.size() <<
+			", compressedDataSize=" << upload->data.size());
+
+		upload->curl = curl_easy_init();
+		if (upload->curl == NULL) {
+			finishUpload(upload, CURLE_FAILED_INIT);
+			return;
+		}
+		upload->server->prepareUpload(upload->curl, upload->errorMessage,
+			&upload->responseBody, upload->post);
+		curl_easy_setopt(upload->curl, CURLOPT_PRIVATE, upload.get());
+		if (curl_multi_add_handle(multi, upload->curl) != CURLM_OK) {
+			finishUpload(upload, CURLE_FAILED_INIT);
+			return;
+		}
+		uploads.push_back(upload);
+	}
+
+	/**
+	 * Makes progress on the uploads in progress, waiting at most a short
+	 * while for network activity, and processes the finished ones.
+	 */
+	void performUploads() {
+		int running;
+		int remaining;
+		CURLMsg *msg;
+
+		curl_multi_perform(multi, &running);
+		while ((msg = curl_multi_info_read(multi, &remaining)) != NULL) {
+			if (msg->msg == CURLMSG_DONE) {
+				CURL *handle = msg->easy_handle;
+				CURLcode code = msg->data.result;
+				list<UploadPtr>::iterator it;
+
+				for (it = uploads.begin(); it != uploads.end(); it++) {
+					if ((*it)->curl == handle) {
+						UploadPtr upload = *it;
+						uploads.erase(it);
+						curl_multi_remove_handle(multi, handle);
+						finishUpload(upload, code);
+						break;
+					}
+				}
 			}
 		}
 
-		if (!downServers.empty()) {
+		if (!uploads.empty()) {
+			waitForUploadActivity();
+		}
+	}
+
+	void waitForUploadActivity() {
+		#if LIBCURL_VERSION_NUM >= 0x071c00
+			int numfds;
+			curl_multi_wait(multi, NULL, 0, 100, &numfds);
+		#else
+			fd_set readfds, writefds, exceptfds;
+			int maxfd = -1;
+			long timeout = -1;
+			struct timeval tv;
+
+			FD_ZERO(&readfds);
+			FD_ZERO(&writefds);
+			FD_ZERO(&exceptfds);
+			curl_multi_timeout(multi, &timeout);
+			if (timeout < 0 || timeout > 100) {
+				timeout = 100;
+			}
+			tv.tv_sec = 0;
+			tv.tv_usec = timeout * 1000;
+			curl_multi_fdset(multi, &readfds, &writefds, &exceptfds, &maxfd);
+			if (maxfd == -1) {
+				syscalls::usleep(timeout * 1000);
+			} else {
+				syscalls::select(maxfd + 1, &readfds, &writefds, &exceptfds, &tv);
+			}
+		#endif
+	}
+
+	void finishUpload(const UploadPtr &upload, CURLcode code) {
+		Server::SendResult result = upload->server->finishUpload(upload->curl,
+			code, upload->responseBody, upload->errorMessage,
+			upload->unionStationKey);
+		boost::lock_guard<boost::mutex> l(syncher);
+		unsigned int packets = upload->records.size();
+
+		uploadsInFlight--;
+		if (result == Server::SR_OK) {
+			packetsAccepted += packets;
+			uploadsSent++;
+			acknowledgeRecords(upload);
+		} else if (result == Server::SR_REJECTED) {
+			// Sending the same packets again won't help.
+			packetsRejected += packets;
+			uploadsSent++;
+			acknowledgeRecords(upload);
+		} else {
+			list<ServerPtr>::iterator it;
+			bool wasUp = false;
+
+			for (it = upServers.begin(); it != upServers.end(); it++) {
+				if (*it == upload->server) {
+					upServers.erase(it);
+					wasUp = true;
+					break;
+				}
+			}
+			if (wasUp) {
+				downServers.push_back(upload->server);
+			}
 			// If some gateways are down then the infrastructure team
 			// is likely already working on the problem, so we check
 			// back in 1 minute.
 			scheduleNextCheckup(1 * 60);
+
+			// Make the packets available again so that they can be sent to
+			// another server, or to this one after it has recovered.
+			foreach (UstRouter::Spool::RecordId id, upload->recordIds) {
+				spool->release(id);
+			}
+
+			if (upServers.empty()) {
+				P_WARN("No Union Station gateway servers are available; keeping "
+					<< spool->size() << " packets spooled until the next checkup."
+					" Run `passenger-status --show=union_station` to view server status.");
+			}
 		}
+	}
 
-		if (accepted) {
-			packetsAccepted++;
-		} else if (rejected) {
-			packetsRejected++;
-		} else {
-			packetsDropped++;
+	/**
+	 * @pre syncher is locked
+	 */
+	void acknowledgeRecords(const UploadPtr &upload) {
+		foreach (UstRouter::Spool::RecordId id, upload->recordIds) {
+			spool->acknowledge(id);
 		}
+	}
 
-		upServersEmpty = upServers.empty();
+	void syncSpool(bool force) {
+		MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+		if (force || now - lastSpoolSyncTime >= 1000000) {
+			boost::lock_guard<boost::mutex> l(syncher);
+			spool->sync();
+			lastSpoolSyncTime = now;
+		}
+	}
 
-		l.unlock();
+	/**
+	 * @pre syncher is locked
+	 */
+	bool shouldCompactSpoolUnlocked() const {
+		return spool->needsCompaction()
+			&& SystemTime::getMonotonicUsec() >= spoolCompactionRetryTime;
+	}
 
-		if (!accepted && !rejected) {
-			assert(upServersEmpty);
-			(void) upServersEmpty; // Avoid compiler warning
+	/**
+	 * Compacting a spool file waits for the disk, so producers may only be
+	 * blocked by the steps that access the spool. This is safe because
+	 * records are only claimed and acknowledged by this thread.
+	 */
+	void compactSpool() {
+		UstRouter::Spool::Compaction compaction;
 
-			/* If all servers went down then all items in the queue will be
-			 * effectively dropped until after the next checkup has detected
-			 * servers that are up.
-			 */
-			P_WARN("Dropping Union Station packet because no servers are"
-				" available. Run `passenger-status --show=union_station` to"
-				" view server status. Details of dropped packet:"
-				" key=" << item.unionStationKey <<
-				", node=" << item.nodeName <<
-				", category=" << item.category <<
-				", compressedDataSize=" << item.data.size());
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			if (!shouldCompactSpoolUnlocked()) {
+				return;
+			}
+		}
+		if (!spool->beginCompaction(compaction)) {
+			spoolCompactionRetryTime = SystemTime::getMonotonicUsec() + 60000000;
+			return;
 		}
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			spool->copyForCompaction(compaction);
+		}
+		if (!spool->syncCompaction(compaction)) {
+			spoolCompactionRetryTime = SystemTime::getMonotonicUsec() + 60000000;
+			return;
+		}
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			spool->finishCompaction(compaction);
+		}
+		P_DEBUG("Compacted Union Station spool file");
 	}
 
 	bool compress(const StaticString data[], unsigned int count, string &output) {
@@ -727,26 +1080,73 @@ private:
 		return doc;
 	}
 
+	void initializeSpool(const string &spoolPath, size_t spoolSize) {
+		if (!spoolPath.empty()) {
+			try {
+				spool.reset(new UstRouter::Spool(spoolPath, spoolSize));
+				if (!spool->empty()) {
+					P_NOTICE("Resuming sending of " << spool->size()
+						<< " Union Station packets from " << spoolPath);
+				}
+				return;
+			} catch (const SystemException &e) {
+				P_ERROR("Cannot use Union Station spool file " << spoolPath
+					<< ", spooling in memory instead: " << e.what());
+			}
+		}
+		spool.reset(new UstRouter::Spool(string(), spoolSize));
+	}
+
 public:
+	/**
+	 * `gatewayAddress` is a host name, optionally prefixed with "http://"
+	 * or "https://" (the default). Plain HTTP is meant for testing against
+	 * a local gateway.
+	 *
+	 * Packets are spooled in `spoolPath` until they are sent, so that they
+	 * survive restarts. If `spoolPath` is empty, they're spooled in memory.
+	 */
 	RemoteSender(const string &gatewayAddress, unsigned short gatewayPort,
-		const string &certificate, const string &proxyAddress)
-		: queue(1024)
+		const string &certificate, const string &proxyAddress,
+		const string &spoolPath = string(),
+		size_t spoolSize = DEFAULT_UST_ROUTER_SPOOL_SIZE,
+		unsigned int maxConcurrentUploads = DEFAULT_UST_ROUTER_MAX_CONCURRENT_UPLOADS)
 	{
 		TRACE_POINT();
-		this->gatewayAddress = gatewayAddress;
+		if (startsWith(gatewayAddress, "http://")) {
+			this->gatewayScheme = "http";
+			this->gatewayAddress = gatewayAddress.substr(sizeof("http://") - 1);
+		} else if (startsWith(gatewayAddress, "https://")) {
+			this->gatewayScheme = "https";
+			this->gatewayAddress = gatewayAddress.substr(sizeof("https://") - 1);
+		} else {
+			this->gatewayScheme = "https";
+			this->gatewayAddress = gatewayAddress;
+		}
 		this->gatewayPort = gatewayPort;
 		this->certificate = certificate;
+		this->maxConcurrentUploads = std::max(maxConcurrentUploads, 1u);
 		try {
 			this->proxyInfo = prepareCurlProxy(proxyAddress);
 		} catch (const ArgumentException &e) {
 			throw RuntimeException("Invalid Union Station proxy address \"" +
 				proxyAddress + "\": " + e.what());
 		}
+		initializeSpool(spoolPath, spoolSize);
+		multi = curl_multi_init();
+		if (multi == NULL) {
+			throw IOException("Unable to create a CURL multi handle");
+		}
+		exitRequested = false;
 		lastCheckupTime = 0;
 		nextCheckupTime = 0;
 		packetsAccepted = 0;
 		packetsRejected = 0;
 		packetsDropped = 0;
+		uploadsSent = 0;
+		uploadsInFlight = 0;
+		lastSpoolSyncTime = 0;
+		spoolCompactionRetryTime = 0;
 		thr = new oxt::thread(
 			boost::bind(&RemoteSender::threadMain, this),
 			"RemoteSender thread",
@@ -755,13 +1155,16 @@ public:
 	}
 
 	~RemoteSender() {
-		Item item;
-		item.exit = true;
-		queue.add(item);
-		/* Wait until the thread sends out all queued items.
+		{
+			boost::lock_guard<boost::mutex> l(syncher);
+			exitRequested = true;
+			cond.notify_one();
+		}
+		/* Wait until the thread sends out all spooled packets.
 		 * If this cannot be done within a short amount of time,
-		 * e.g. because all servers are down, then we'll get killed
-		 * by the watchdog anyway.
+		 * e.g. because the gateway is slow, then we'll get killed
+		 * by the watchdog anyway. If all servers are down then
+		 * the packets stay in the spool.
 		 */
 		thr->join();
 		delete thr;
@@ -771,40 +1174,44 @@ public:
 		const StaticString &category, const StaticString data[],
 		unsigned int count)
 	{
-		Item item;
-
-		item.unionStationKey = unionStationKey;
-		item.nodeName = nodeName;
-		item.category = category;
-
-		if (compress(data, count, item.data)) {
-			item.compressed = true;
-		} else {
-			size_t size = 0;
-			unsigned int i;
-
-			for (i = 0; i < count; i++) {
-				size += data[i].size();
-			}
-			item.data.reserve(size);
-			for (i = 0; i < count; i++) {
-				item.data.append(data[i].c_str(), data[i].size());
-			}
+		RecordHeader header;
+		vector<StaticString> parts;
+		bool added;
+
+		header.keySize = unionStationKey.size();
+		header.nodeNameSize = nodeName.size();
+		header.categorySize = category.size();
+		parts.reserve(count + 4);
+		parts.push_back(StaticString((const char *) &header, sizeof(header)));
+		parts.push_back(unionStationKey);
+		parts.push_back(nodeName);
+		parts.push_back(category);
+		for (unsigned int i = 0; i < count; i++) {
+			parts.push_back(data[i]);
 		}
 
 		P_DEBUG("Scheduling Union Station packet: key=" << unionStationKey <<
-			", node=" << nodeName << ", category=" << category <<
-			", compressedDataSize=" << item.data.size());
+			", node=" << nodeName << ", category=" << category);
 
-		if (!queue.tryAdd(item)) {
-			P_WARN("The Union Station gateway isn't responding quickly enough; dropping packet.");
+		{
 			boost::lock_guard<boost::mutex> l(syncher);
-			packetsDropped++;
+			added = spool->append(&parts[0], parts.size());
+			if (!added) {
+				packetsDropped++;
+			}
+			// Also wakes up the sender thread when a spool file needs
+			// to be compacted.
+			cond.notify_one();
+		}
+		if (!added) {
+			P_WARN("The Union Station gateway isn't responding quickly enough "
+				"and the spool is full; dropping packet.");
 		}
 	}
 
 	unsigned int queued() const {
-		return queue.size();
+		boost::lock_guard<boost::mutex> l(syncher);
+		return spool->size();
 	}
 
 	Json::Value inspectStateAsJson() const {
@@ -812,7 +1219,11 @@ public:
 		boost::lock_guard<boost::mutex> l(syncher);
 		doc["up_servers"] = inspectUpServersStateAsJson();
 		doc["down_servers"] = inspectDownServersStateAsJson();
-		doc["queue_size"] = queue.size();
+		doc["queue_size"] = (Json::UInt64) spool->size();
+		doc["spool"] = spool->inspectStateAsJson();
+		doc["uploads_in_flight"] = uploadsInFlight;
+		doc["max_concurrent_uploads"] = maxConcurrentUploads;
+		doc["uploads_sent"] = uploadsSent;
 		doc["packets_accepted"] = packetsAccepted;
 		doc["packets_rejected"] = packetsRejected;
 		doc["packets_dropped"] = packetsDropped;
@@ -31,6 +31,7 @@
 #include <ctime>
 #include <ev++.h>
 #include <Logging.h>
+#include <SmallVector.h>
 #include <UstRouter/LogSink.h>
 #include <UstRouter/RemoteSender.h>
 
@@ -40,17 +41,14 @@ namespace UstRouter {
 using namespace std;
 using namespace boost;
 
-inline RemoteSender &Controller_getRemoteSender(Controller *controller);
-
-
 class RemoteSink: public LogSink {
 private:
 	bool realFlush() {
 		if (bufferSize > 0) {
 			P_DEBUG("Flushing " << inspect() << ": " << bufferSize << " bytes");
-			lastFlushed = ev_now(Controller_getLoop(controller));
+			lastFlushed = ev_time();
 			StaticString data(buffer, bufferSize);
-			Controller_getRemoteSender(controller).schedule(unionStationKey,
+			remoteSender->schedule(unionStationKey,
 				nodeName, category, &data, 1);
 			bufferSize = 0;
 			return true;
@@ -77,15 +75,16 @@ public:
 		4 * 64 * 1024 -
 		16 * 1024;
 
+	RemoteSender *remoteSender;
 	string unionStationKey;
 	string nodeName;
 	string category;
 	char buffer[BUFFER_CAPACITY];
 	unsigned int bufferSize;
 
-	RemoteSink(Controller *controller, const string &_unionStationKey,
+	RemoteSink(RemoteSender *_remoteSender, const string &_unionStationKey,
 		const string &_nodeName, const string &_category)
-		: LogSink(controller),
+		: remoteSender(_remoteSender),
 		  unionStationKey(_unionStationKey),
 		  nodeName(_nodeName),
 		  category(_category),
@@ -102,20 +101,24 @@ public:
 	}
 
 	virtual void append(const TransactionPtr &transaction) {
-		StaticString data = transaction->getBody();
+		unsigned int chunkCount = transaction->getBodyChunkCount();
+		SmallVector<StaticString, 16> data;
+
 		LogSink::append(transaction);
-		if (bufferSize + data.size() > BUFFER_CAPACITY) {
-			StaticString data2[] = {
-				StaticString(buffer, bufferSize),
-				data
-			};
-			Controller_getRemoteSender(controller).schedule(unionStationKey,
-				nodeName, category, data2, 2);
-			lastFlushed = ev_now(Controller_getLoop(controller));
+		data.resize(chunkCount + 1);
+		data[0] = StaticString(buffer, bufferSize);
+		transaction->getBodyChunks(&data[1]);
+
+		if (bufferSize + transaction->getBodySize() > BUFFER_CAPACITY) {
+			remoteSender->schedule(unionStationKey,
+				nodeName, category, &data[0], chunkCount + 1);
+			lastFlushed = ev_time();
 			bufferSize = 0;
 		} else {
-			memcpy(buffer + bufferSize, data.data(), data.size());
-			bufferSize += data.size();
+			for (unsigned int i = 1; i <= chunkCount; i++) {
+				memcpy(buffer + bufferSize, data[i].data(), data[i].size());
+				bufferSize += data[i].size();
+			}
 		}
 	}
 
@@ -0,0 +1,143 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_UST_ROUTER_SHARD_H_
+#define _PASSENGER_UST_ROUTER_SHARD_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <string>
+#include <vector>
+#include <ConfigKit/ConfigKit.h>
+#include <StaticString.h>
+#include <UnionStationFilterSupport.h>
+#include <UstRouter/Transaction.h>
+#include <UstRouter/LogSink.h>
+#include <UstRouter/RemoteSender.h>
+#include <Utils/Hasher.h>
+#include <Utils/StringMap.h>
+
+namespace Passenger {
+namespace UstRouter {
+
+using namespace std;
+
+
+/**
+ * A partition of the UstRouter's transactions, together with the log sinks
+ * that those transactions are written to.
+ *
+ * Every field is protected by `syncher`. Controller threads must not call
+ * back into ServerKit (e.g. disconnect a client) while holding it, because
+ * that may reenter the controller and lock a shard again.
+ */
+struct Shard {
+	typedef StringMap<TransactionPtr> TransactionMap;
+	typedef StringMap<LogSinkPtr> LogSinkCache;
+
+	boost::mutex syncher;
+	TransactionMap transactions;
+	LogSinkCache logSinkCache;
+	StringMap<FilterSupport::FilterPtr> filters;
+	/** Whether a FileSink in this shard may have buffered data. */
+	bool fileSinksDirty;
+
+	Shard()
+		: fileSinksDirty(false)
+		{ }
+};
+
+/**
+ * The state that is shared by all UstRouter controller threads: the
+ * transaction shards, and the RemoteSender that all remote sinks
+ * hand their data to.
+ *
+ * Transactions are assigned to shards by the hash of their transaction ID.
+ * Because all operations on a transaction happen under its shard's lock,
+ * log entries stay ordered within each transaction no matter which
+ * controller thread the logging clients are connected to, while
+ * operations on transactions in different shards run in parallel.
+ * Periodic maintenance of shard `i` (garbage collection, flushing) is
+ * done by controller thread `i + 1`.
+ */
+class ShardSet {
+private:
+	vector<Shard *> shards;
+
+public:
+	RemoteSender remoteSender;
+
+	/**
+	 * @param config The configuration of a UstRouter::Controller, from which
+	 *               the Union Station gateway settings are taken.
+	 */
+	ShardSet(unsigned int count, const ConfigKit::Store &config)
+		: remoteSender(
+		      config["union_station_gateway_address"].asString(),
+		      config["union_station_gateway_port"].asUInt(),
+		      config["union_station_gateway_cert"].asString(),
+		      config["union_station_proxy_address"].asString(),
+		      config["union_station_spool_file"].asString(),
+		      config["union_station_spool_size"].asUInt(),
+		      config["union_station_max_concurrent_uploads"].asUInt())
+	{
+		shards.reserve(count);
+		for (unsigned int i = 0; i < count; i++) {
+			shards.push_back(new Shard());
+		}
+	}
+
+	~ShardSet() {
+		for (unsigned int i = 0; i < shards.size(); i++) {
+			delete shards[i];
+		}
+	}
+
+	unsigned int size() const {
+		return shards.size();
+	}
+
+	Shard &operator[](unsigned int index) {
+		return *shards[index];
+	}
+
+	Shard &forTxnId(const StaticString &txnId) {
+		if (shards.size() == 1) {
+			return *shards[0];
+		} else {
+			Hasher hasher;
+			hasher.update(txnId.data(), txnId.size());
+			return *shards[hasher.finalize() % shards.size()];
+		}
+	}
+};
+
+typedef boost::shared_ptr<ShardSet> ShardSetPtr;
+
+
+} // namespace UstRouter
+} // namespace Passenger
+
+#endif /* _PASSENGER_UST_ROUTER_SHARD_H_ */
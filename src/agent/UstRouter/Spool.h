@@ -0,0 +1,672 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_UST_ROUTER_SPOOL_H_
+#define _PASSENGER_UST_ROUTER_SPOOL_H_
+
+#include <boost/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <oxt/system_calls.hpp>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <jsoncpp/json.h>
+
+#include <Logging.h>
+#include <Exceptions.h>
+#include <StaticString.h>
+#include <FileDescriptor.h>
+#include <Utils/JsonUtils.h>
+
+namespace Passenger {
+namespace UstRouter {
+
+using namespace std;
+
+
+/**
+ * A FIFO queue of opaque records, stored in a fixed-size memory-mapped
+ * region. Records are appended at the end and consumed from the front.
+ *
+ * Consuming a record takes two steps. A consumer first claims a record,
+ * which hides it from other consumers. When the consumer is done with it,
+ * it acknowledges the record, which removes it from the spool. If the
+ * consumer fails, it releases the record so that it can be claimed again.
+ * Records may be acknowledged in any order; the space they occupy is
+ * reclaimed once all records before them have been acknowledged too.
+ *
+ * If a filename is given, the region is a shared mapping of that file,
+ * so that the records survive a restart of the process. Records are
+ * checksummed; upon opening an existing spool file, any records that
+ * were not completely written (e.g. because of a crash) are discarded.
+ * Records that were claimed but not acknowledged become available again.
+ * Without a filename, the region is anonymous memory.
+ *
+ * When there is no space at the end of the region, `append()` moves the
+ * unacknowledged records of an in-memory spool to the front. If there is
+ * still not enough space, it fails.
+ *
+ * A spool file is compacted by writing a new file and renaming it over the
+ * old one, so that a crash during the move doesn't lose records. That
+ * involves waiting for the disk, so `append()` never does it. Instead, the
+ * consumer checks `needsCompaction()` and performs the compaction in steps
+ * (see `beginCompaction()`), most of which don't access the spool itself.
+ *
+ * This class is not thread-safe.
+ */
+class Spool: public boost::noncopyable {
+public:
+	static const boost::uint32_t MAGIC = 0x4c4f4f50; // "POOL"
+	static const boost::uint32_t RECORD_MAGIC = 0x44434552; // "RECD"
+	static const boost::uint32_t VERSION = 1;
+
+	/**
+	 * Identifies a record for as long as it is in the spool, even if the
+	 * spool is compacted in the mean time. 0 means "no record".
+	 */
+	typedef boost::uint64_t RecordId;
+
+	/**
+	 * A spool file compaction in progress. Removes the new file
+	 * if the compaction is abandoned.
+	 */
+	class Compaction: public boost::noncopyable {
+	private:
+		friend class Spool;
+
+		string tmpPath;
+		FileDescriptor fd;
+		char *region;
+		size_t capacity;
+		/** The part of the old region that has been copied. */
+		boost::uint64_t readOffset, writeOffset;
+
+	public:
+		Compaction()
+			: region(NULL),
+			  capacity(0),
+			  readOffset(0),
+			  writeOffset(0)
+			{ }
+
+		~Compaction() {
+			if (region != NULL) {
+				munmap(region, capacity);
+			}
+			if (!tmpPath.empty()) {
+				unlink(tmpPath.c_str());
+			}
+		}
+	};
+
+private:
+	enum RecordState {
+		RS_AVAILABLE,
+		RS_CLAIMED,
+		RS_ACKNOWLEDGED
+	};
+
+	struct Header {
+		boost::uint32_t magic;
+		boost::uint32_t version;
+		boost::uint64_t capacity;
+		boost::uint64_t readOffset;
+		boost::uint64_t writeOffset;
+		boost::uint64_t count;
+	};
+
+	struct RecordHeader {
+		boost::uint32_t magic;
+		boost::uint32_t size;
+		boost::uint32_t checksum;
+		/** A RecordState. Not covered by the checksum. */
+		boost::uint32_t state;
+	};
+
+	static const size_t DATA_OFFSET = 64;
+
+	string path;
+	FileDescriptor fd;
+	char *region;
+	size_t capacity;
+	/**
+	 * The RecordId of the start of the data area. Compaction moves records
+	 * to lower offsets, so it increases this by the same amount.
+	 */
+	boost::uint64_t idBase;
+	boost::uint64_t claimed;
+	boost::uint64_t acknowledged;
+	boost::uint64_t recordsDiscarded;
+
+	Header *header() const {
+		return (Header *) region;
+	}
+
+	RecordHeader *recordHeader(RecordId id) const {
+		assert(id >= idBase + DATA_OFFSET);
+		assert(id - idBase < header()->writeOffset);
+		return (RecordHeader *) (region + (id - idBase));
+	}
+
+	RecordId idForOffset(boost::uint64_t offset) const {
+		return idBase + offset;
+	}
+
+	RecordId findAvailable(boost::uint64_t offset) const {
+		const Header *h = header();
+		while (offset < h->writeOffset) {
+			const RecordHeader *rh = (const RecordHeader *) (region + offset);
+			if (rh->state == RS_AVAILABLE) {
+				return idForOffset(offset);
+			}
+			offset += recordSize(rh->size);
+		}
+		return 0;
+	}
+
+	static size_t recordSize(size_t payloadSize) {
+		return (sizeof(RecordHeader) + payloadSize + 7) & ~((size_t) 7);
+	}
+
+	void mapRegion() {
+		if (path.empty()) {
+			region = (char *) mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		} else {
+			region = (char *) mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+				MAP_SHARED, fd, 0);
+		}
+		if (region == MAP_FAILED) {
+			int e = errno;
+			region = NULL;
+			throw SystemException("Cannot map spool " + inspectName(), e);
+		}
+	}
+
+	void openFile(size_t desiredCapacity) {
+		struct stat buf;
+
+		fd.assign(syscalls::open(path.c_str(), O_RDWR | O_CREAT, 0600),
+			__FILE__, __LINE__);
+		if (fd == -1) {
+			int e = errno;
+			throw FileSystemException("Cannot open spool file " + path, e, path);
+		}
+		if (fstat(fd, &buf) == -1) {
+			int e = errno;
+			throw FileSystemException("Cannot stat spool file " + path, e, path);
+		}
+
+		if ((size_t) buf.st_size >= DATA_OFFSET && isValidFile(buf.st_size)) {
+			capacity = buf.st_size;
+			if (capacity != desiredCapacity) {
+				P_NOTICE("Spool file " << path << " has a size of " << capacity
+					<< " bytes; keeping that size instead of " << desiredCapacity
+					<< " bytes so that no data is lost");
+			}
+			mapRegion();
+			recover();
+		} else {
+			capacity = desiredCapacity;
+			if (ftruncate(fd, 0) == -1
+			 || ftruncate(fd, capacity) == -1)
+			{
+				int e = errno;
+				throw FileSystemException("Cannot resize spool file " + path, e, path);
+			}
+			mapRegion();
+			initializeHeader();
+		}
+	}
+
+	bool isValidFile(off_t size) const {
+		Header h;
+		ssize_t ret;
+
+		do {
+			ret = pread(fd, &h, sizeof(h), 0);
+		} while (ret == -1 && errno == EINTR);
+		return ret == (ssize_t) sizeof(h)
+			&& h.magic == MAGIC
+			&& h.version == VERSION
+			&& h.capacity == (boost::uint64_t) size
+			&& h.readOffset >= DATA_OFFSET
+			&& h.readOffset <= h.writeOffset
+			&& h.writeOffset <= h.capacity;
+	}
+
+	void initializeHeader() {
+		Header *h = header();
+		h->magic = MAGIC;
+		h->version = VERSION;
+		h->capacity = capacity;
+		h->readOffset = DATA_OFFSET;
+		h->writeOffset = DATA_OFFSET;
+		h->count = 0;
+	}
+
+	/**
+	 * Verifies the records of a spool file that was just opened. Everything
+	 * starting from the first invalid record is discarded. Claimed records
+	 * belonged to consumers in the previous process, so they are made
+	 * available again.
+	 */
+	void recover() {
+		Header *h = header();
+		boost::uint64_t offset = h->readOffset;
+		boost::uint64_t count = 0;
+
+		while (offset < h->writeOffset) {
+			RecordHeader *rh = (RecordHeader *) (region + offset);
+			if (h->writeOffset - offset < sizeof(RecordHeader)
+			 || rh->magic != RECORD_MAGIC
+			 || rh->state > RS_ACKNOWLEDGED
+			 || recordSize(rh->size) > h->writeOffset - offset
+			 || rh->checksum != checksum(region + offset + sizeof(RecordHeader), rh->size))
+			{
+				break;
+			}
+			if (rh->state == RS_CLAIMED) {
+				rh->state = RS_AVAILABLE;
+			} else if (rh->state == RS_ACKNOWLEDGED) {
+				acknowledged++;
+			}
+			offset += recordSize(rh->size);
+			count++;
+		}
+
+		if (offset != h->writeOffset || count != h->count) {
+			P_WARN("Spool file " << path << " contains incomplete or corrupt records; "
+				"recovered " << count << " records");
+			if (count < h->count) {
+				recordsDiscarded += h->count - count;
+			}
+			h->writeOffset = offset;
+			h->count = count;
+		}
+		removeAcknowledgedRecords();
+	}
+
+	/**
+	 * Advances the read offset past the acknowledged records at the front.
+	 */
+	void removeAcknowledgedRecords() {
+		Header *h = header();
+
+		while (h->count > 0) {
+			const RecordHeader *rh = (const RecordHeader *) (region + h->readOffset);
+			if (rh->state != RS_ACKNOWLEDGED) {
+				break;
+			}
+			h->readOffset += recordSize(rh->size);
+			h->count--;
+			acknowledged--;
+		}
+		if (h->count == 0) {
+			idBase += h->readOffset - DATA_OFFSET;
+			h->readOffset = h->writeOffset = DATA_OFFSET;
+		}
+	}
+
+	static boost::uint32_t checksum(const char *data, size_t size) {
+		return crc32(crc32(0, Z_NULL, 0), (const Bytef *) data, size);
+	}
+
+	/**
+	 * Moves the unacknowledged records of an in-memory spool to the start
+	 * of the data area.
+	 */
+	void compact() {
+		Header *h = header();
+		size_t used = h->writeOffset - h->readOffset;
+
+		assert(path.empty());
+		idBase += h->readOffset - DATA_OFFSET;
+		memmove(region + DATA_OFFSET, region + h->readOffset, used);
+		h->readOffset = DATA_OFFSET;
+		h->writeOffset = DATA_OFFSET + used;
+	}
+
+	void compactionFailed(const Compaction &compaction, const char *action) const {
+		int e = errno;
+		P_WARN("Cannot " << action << " " << compaction.tmpPath
+			<< " for compacting spool file " << path << ": "
+			<< strerror(e) << " (errno=" << e << ")");
+	}
+
+	string inspectName() const {
+		if (path.empty()) {
+			return "(in memory)";
+		} else {
+			return path;
+		}
+	}
+
+public:
+	/**
+	 * Opens or creates a spool. If `path` is empty, the spool is kept in
+	 * memory only. `capacity` is the size of the region in bytes; an
+	 * existing valid spool file keeps its own size.
+	 *
+	 * @throws SystemException
+	 * @throws FileSystemException
+	 */
+	Spool(const string &_path, size_t _capacity)
+		: path(_path),
+		  region(NULL),
+		  capacity(0),
+		  idBase(0),
+		  claimed(0),
+		  acknowledged(0),
+		  recordsDiscarded(0)
+	{
+		assert(_capacity > DATA_OFFSET);
+		if (path.empty()) {
+			capacity = _capacity;
+			mapRegion();
+			initializeHeader();
+		} else {
+			openFile(_capacity);
+		}
+	}
+
+	~Spool() {
+		if (region != NULL) {
+			munmap(region, capacity);
+		}
+	}
+
+	/**
+	 * Appends a record consisting of the concatenation of the given parts.
+	 * Returns false if the spool doesn't have enough space.
+	 */
+	bool append(const StaticString parts[], unsigned int count) {
+		Header *h = header();
+		size_t payloadSize = 0;
+		unsigned int i;
+
+		for (i = 0; i < count; i++) {
+			payloadSize += parts[i].size();
+		}
+		if (payloadSize > 0xFFFFFFFFu) {
+			return false;
+		}
+
+		size_t size = recordSize(payloadSize);
+		if (h->writeOffset + size > capacity && path.empty()) {
+			compact();
+		}
+		if (h->writeOffset + size > capacity) {
+			return false;
+		}
+
+		RecordHeader *rh = (RecordHeader *) (region + h->writeOffset);
+		char *pos = region + h->writeOffset + sizeof(RecordHeader);
+		uLong crc = crc32(0, Z_NULL, 0);
+
+		for (i = 0; i < count; i++) {
+			memcpy(pos, parts[i].data(), parts[i].size());
+			crc = crc32(crc, (const Bytef *) parts[i].data(), parts[i].size());
+			pos += parts[i].size();
+		}
+		rh->magic = RECORD_MAGIC;
+		rh->size = payloadSize;
+		rh->checksum = crc;
+		rh->state = RS_AVAILABLE;
+
+		// Publish the record only after it has been completely written.
+		h->writeOffset += size;
+		h->count++;
+		return true;
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	/** The number of records that haven't been acknowledged yet. */
+	boost::uint64_t size() const {
+		return header()->count - acknowledged;
+	}
+
+	/** The number of records that are claimed but not yet acknowledged. */
+	boost::uint64_t claimedSize() const {
+		return claimed;
+	}
+
+	/** The number of bytes in use by records. */
+	size_t bytesUsed() const {
+		return header()->writeOffset - header()->readOffset;
+	}
+
+	size_t getCapacity() const {
+		return capacity - DATA_OFFSET;
+	}
+
+	/**
+	 * Returns the first record that is neither claimed nor acknowledged,
+	 * or 0 if there is none.
+	 */
+	RecordId firstAvailable() const {
+		return findAvailable(header()->readOffset);
+	}
+
+	/**
+	 * Returns the first record after `id` that is neither claimed nor
+	 * acknowledged, or 0 if there is none.
+	 */
+	RecordId nextAvailable(RecordId id) const {
+		return findAvailable(id - idBase + recordSize(recordHeader(id)->size));
+	}
+
+	/**
+	 * Returns the contents of the given record. The result is only valid
+	 * until the next call to `append()`.
+	 */
+	StaticString get(RecordId id) const {
+		const RecordHeader *rh = recordHeader(id);
+		return StaticString((const char *) rh + sizeof(RecordHeader), rh->size);
+	}
+
+	/**
+	 * Hides the given record from `firstAvailable()` and `nextAvailable()`
+	 * until it is released or acknowledged.
+	 */
+	void claim(RecordId id) {
+		RecordHeader *rh = recordHeader(id);
+		assert(rh->state == RS_AVAILABLE);
+		rh->state = RS_CLAIMED;
+		claimed++;
+	}
+
+	/** Makes a claimed record available again. */
+	void release(RecordId id) {
+		RecordHeader *rh = recordHeader(id);
+		assert(rh->state == RS_CLAIMED);
+		rh->state = RS_AVAILABLE;
+		claimed--;
+	}
+
+	/**
+	 * Removes the given record, which may or may not be claimed. Once
+	 * acknowledged, a record is not recovered after a restart.
+	 */
+	void acknowledge(RecordId id) {
+		RecordHeader *rh = recordHeader(id);
+		assert(rh->state != RS_ACKNOWLEDGED);
+		if (rh->state == RS_CLAIMED) {
+			claimed--;
+		}
+		rh->state = RS_ACKNOWLEDGED;
+		acknowledged++;
+		removeAcknowledgedRecords();
+	}
+
+	/**
+	 * Whether this is a spool file that is running out of space at the
+	 * end, and compacting it would free a significant amount of space.
+	 */
+	bool needsCompaction() const {
+		const Header *h = header();
+		size_t reclaimable = h->readOffset - DATA_OFFSET;
+		size_t free = capacity - h->writeOffset;
+
+		return !path.empty()
+			&& free < getCapacity() / 4
+			&& reclaimable > free
+			&& reclaimable >= getCapacity() / 16;
+	}
+
+	/**
+	 * Compacting a spool file takes four steps. Only `copyForCompaction()`
+	 * and `finishCompaction()` access the records, so a caller that
+	 * protects the spool with a lock only needs to hold it during those
+	 * steps. In between, `append()` may be called, but the records must
+	 * not be claimed, released or acknowledged.
+	 *
+	 *  1. `beginCompaction()` creates the new file.
+	 *  2. `copyForCompaction()` copies the records to it.
+	 *  3. `syncCompaction()` writes the new file to disk and renames it
+	 *     over the old one.
+	 *  4. `finishCompaction()` copies the records that have been appended
+	 *     since step 2, and switches to the new file.
+	 *
+	 * Steps 1 and 3 return false if they fail, in which case the
+	 * compaction is abandoned and the spool is left untouched.
+	 */
+	bool beginCompaction(Compaction &compaction) const {
+		assert(!path.empty());
+		compaction.tmpPath = path + ".tmp";
+		compaction.fd.assign(syscalls::open(compaction.tmpPath.c_str(),
+			O_RDWR | O_CREAT | O_TRUNC, 0600), __FILE__, __LINE__);
+		if (compaction.fd == -1) {
+			compactionFailed(compaction, "create");
+			compaction.tmpPath.clear();
+			return false;
+		}
+		if (ftruncate(compaction.fd, capacity) == -1) {
+			compactionFailed(compaction, "resize");
+			return false;
+		}
+		compaction.region = (char *) mmap(NULL, capacity, PROT_READ | PROT_WRITE,
+			MAP_SHARED, compaction.fd, 0);
+		if (compaction.region == MAP_FAILED) {
+			compactionFailed(compaction, "map");
+			compaction.region = NULL;
+			return false;
+		}
+		compaction.capacity = capacity;
+		return true;
+	}
+
+	void copyForCompaction(Compaction &compaction) const {
+		const Header *h = header();
+		Header *newHeader = (Header *) compaction.region;
+		size_t used = h->writeOffset - h->readOffset;
+
+		memcpy(newHeader, h, sizeof(Header));
+		memcpy(compaction.region + DATA_OFFSET, region + h->readOffset, used);
+		newHeader->readOffset = DATA_OFFSET;
+		newHeader->writeOffset = DATA_OFFSET + used;
+		compaction.readOffset = h->readOffset;
+		compaction.writeOffset = h->writeOffset;
+	}
+
+	/**
+	 * The new file must be complete on disk before it replaces the old one.
+	 * Records that are appended after `copyForCompaction()` are only in
+	 * memory at this point, just like records that have been appended since
+	 * the last `sync()`.
+	 */
+	bool syncCompaction(Compaction &compaction) const {
+		if (msync(compaction.region, capacity, MS_SYNC) == -1) {
+			compactionFailed(compaction, "write");
+			return false;
+		}
+		if (rename(compaction.tmpPath.c_str(), path.c_str()) == -1) {
+			compactionFailed(compaction, "rename");
+			return false;
+		}
+		compaction.tmpPath.clear();
+		return true;
+	}
+
+	void finishCompaction(Compaction &compaction) {
+		Header *h = header();
+		Header *newHeader = (Header *) compaction.region;
+		size_t shift = compaction.readOffset - DATA_OFFSET;
+		size_t appended = h->writeOffset - compaction.writeOffset;
+
+		assert(h->readOffset == compaction.readOffset);
+		memcpy(compaction.region + newHeader->writeOffset,
+			region + compaction.writeOffset, appended);
+		newHeader->writeOffset += appended;
+		newHeader->count = h->count;
+
+		munmap(region, capacity);
+		region = compaction.region;
+		fd = compaction.fd;
+		idBase += shift;
+		compaction.region = NULL;
+	}
+
+	/** Asynchronously writes modified pages of a spool file back to disk. */
+	void sync() {
+		if (!path.empty()) {
+			msync(region, capacity, MS_ASYNC);
+		}
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		if (path.empty()) {
+			doc["path"] = Json::Value(Json::nullValue);
+		} else {
+			doc["path"] = path;
+		}
+		doc["records"] = (Json::UInt64) size();
+		doc["records_in_flight"] = (Json::UInt64) claimedSize();
+		doc["used"] = byteSizeToJson(bytesUsed());
+		doc["capacity"] = byteSizeToJson(getCapacity());
+		if (recordsDiscarded > 0) {
+			doc["records_discarded_during_recovery"] = (Json::UInt64) recordsDiscarded;
+		}
+		return doc;
+	}
+};
+
+
+} // namespace UstRouter
+} // namespace Passenger
+
+#endif /* _PASSENGER_UST_ROUTER_SPOOL_H_ */
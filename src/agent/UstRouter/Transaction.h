@@ -28,15 +28,17 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/move/move.hpp>
-#include <boost/container/string.hpp>
 #include <boost/cstdint.hpp>
+#include <algorithm>
+#include <string>
 #include <cstdlib>
 #include <cstring>
+#include <cassert>
 
 #include <ev++.h>
 #include <StaticString.h>
 #include <MemoryKit/palloc.h>
-#include <DataStructures/LString.h>
+#include <Utils/StrIntUtils.h>
 #include <Utils/JsonUtils.h>
 
 namespace Passenger {
@@ -45,166 +47,245 @@ namespace UstRouter {
 using namespace std;
 
 
+/**
+ * An open Union Station transaction. All of its data -- the identifying
+ * strings as well as the body -- lives in a per-transaction `psg_pool_t`
+ * arena, which is freed in one go when the transaction is destroyed. The
+ * body is built as a linked list of fixed-size chunks carved out of that
+ * arena, so appending to a transaction never reallocates or copies
+ * previously written data.
+ *
+ * Log sinks consume the body as a list of chunks with `getBodyChunks()`,
+ * which allows them to copy it into their buffers or pass it to writev()
+ * without first flattening it.
+ */
 class Transaction {
 private:
 	BOOST_MOVABLE_BUT_NOT_COPYABLE(Transaction);
 
-	unsigned int groupNameOffset;
-	unsigned int nodeNameOffset;
-	unsigned int categoryOffset;
-	unsigned int unionStationKeyOffset;
-	unsigned int filtersOffset;
+	/* Four chunks fit in a page-sized arena block. Most transactions
+	 * are a few KB in size, so this keeps the memory overhead of
+	 * thousands of concurrently open transactions low.
+	 */
+	static const unsigned int BODY_CHUNK_SIZE = 1000;
 
-	unsigned short groupNameSize, nodeNameSize, filtersSize;
-	boost::uint8_t txnIdSize, unionStationKeySize, categorySize;
+	struct BodyChunk {
+		BodyChunk *next;
+		unsigned int size;
+		unsigned int capacity;
+
+		char *data() {
+			return (char *) (this + 1);
+		}
+
+		const char *data() const {
+			return (const char *) (this + 1);
+		}
+	};
+
+	psg_pool_t *pool;
+	BodyChunk *firstChunk, *lastChunk;
+
+	StaticString txnId;
+	StaticString groupName;
+	StaticString nodeName;
+	StaticString category;
+	StaticString unionStationKey;
+	StaticString filters;
 
 	ev_tstamp createdAt;
 	unsigned int writeCount;
 	unsigned int refCount;
-	unsigned int bodyOffset;
+	unsigned int bodySize;
+	unsigned int bodyChunkCount;
 	bool crashProtect, discarded;
 
-	boost::container::string storage;
+	StaticString internString(const StaticString &str) {
+		char *data = (char *) psg_pnalloc(pool, str.size() + 1);
+		memcpy(data, str.data(), str.size());
+		data[str.size()] = '\0';
+		return StaticString(data, str.size());
+	}
+
+	BodyChunk *newChunk() {
+		size_t allocSize = std::min<size_t>(pool->max, BODY_CHUNK_SIZE);
+		BodyChunk *chunk = (BodyChunk *) psg_palloc(pool, allocSize);
+		chunk->next = NULL;
+		chunk->size = 0;
+		chunk->capacity = allocSize - sizeof(BodyChunk);
+		if (lastChunk == NULL) {
+			firstChunk = chunk;
+		} else {
+			lastChunk->next = chunk;
+		}
+		lastChunk = chunk;
+		bodyChunkCount++;
+		return chunk;
+	}
 
-	template<typename IntegerType1, typename IntegerType2>
-	void internString(const StaticString &str, IntegerType1 *offset, IntegerType2 *size) {
-		if (offset != NULL) {
-			*offset = bodyOffset;
+	void appendToBody(const char *data, size_t size) {
+		bodySize += size;
+		while (size > 0) {
+			BodyChunk *chunk = lastChunk;
+			if (chunk == NULL || chunk->size == chunk->capacity) {
+				chunk = newChunk();
+			}
+
+			size_t n = std::min<size_t>(size, chunk->capacity - chunk->size);
+			memcpy(chunk->data() + chunk->size, data, n);
+			chunk->size += n;
+			data += n;
+			size -= n;
 		}
-		storage.append(str.data(), str.size());
-		storage.append(1, '\0');
-		*size = str.size();
-		bodyOffset += str.size() + 1;
+	}
+
+	void moveFrom(Transaction &other) {
+		pool = other.pool;
+		firstChunk = other.firstChunk;
+		lastChunk = other.lastChunk;
+		txnId = other.txnId;
+		groupName = other.groupName;
+		nodeName = other.nodeName;
+		category = other.category;
+		unionStationKey = other.unionStationKey;
+		filters = other.filters;
+		createdAt = other.createdAt;
+		writeCount = other.writeCount;
+		refCount = other.refCount;
+		bodySize = other.bodySize;
+		bodyChunkCount = other.bodyChunkCount;
+		crashProtect = other.crashProtect;
+		discarded = other.discarded;
+
+		other.pool = NULL;
+		other.firstChunk = NULL;
+		other.lastChunk = NULL;
+		other.txnId = StaticString();
+		other.groupName = StaticString();
+		other.nodeName = StaticString();
+		other.category = StaticString();
+		other.unionStationKey = StaticString();
+		other.filters = StaticString();
+		other.createdAt = 0;
+		other.writeCount = 0;
+		other.refCount = 0;
+		other.bodySize = 0;
+		other.bodyChunkCount = 0;
+		other.crashProtect = false;
+		other.discarded = true;
 	}
 
 public:
-	Transaction(const StaticString &txnId, const StaticString &groupName,
-		const StaticString &nodeName, const StaticString &category,
-		const StaticString &unionStationKey, ev_tstamp _createdAt,
-		const StaticString &filters = StaticString(),
-		unsigned int initialCapacity = 1024 * 8)
-		: createdAt(_createdAt),
+	/**
+	 * @param initialCapacity Size of the blocks that the transaction's
+	 *                        arena allocates.
+	 */
+	Transaction(const StaticString &_txnId, const StaticString &_groupName,
+		const StaticString &_nodeName, const StaticString &_category,
+		const StaticString &_unionStationKey, ev_tstamp _createdAt,
+		const StaticString &_filters = StaticString(),
+		unsigned int initialCapacity = psg_pagesize)
+		: pool(psg_create_pool(std::max(initialCapacity, 1024u))),
+		  firstChunk(NULL),
+		  lastChunk(NULL),
+		  createdAt(_createdAt),
 		  writeCount(0),
 		  refCount(0),
-		  bodyOffset(0),
+		  bodySize(0),
+		  bodyChunkCount(0),
 		  crashProtect(false),
 		  discarded(false)
 	{
-		internString(txnId, (boost::uint8_t *) NULL, &txnIdSize);
-		internString(groupName, &groupNameOffset, &groupNameSize);
-		internString(nodeName, &nodeNameOffset, &nodeNameSize);
-		internString(category, &categoryOffset, &categorySize);
-		internString(unionStationKey, &unionStationKeyOffset, &unionStationKeySize);
-		internString(filters, &filtersOffset, &filtersSize);
+		txnId = internString(_txnId);
+		groupName = internString(_groupName);
+		nodeName = internString(_nodeName);
+		category = internString(_category);
+		unionStationKey = internString(_unionStationKey);
+		filters = internString(_filters);
 	}
 
-	Transaction(BOOST_RV_REF(Transaction) other)
-		: groupNameOffset(other.groupNameOffset),
-		  nodeNameOffset(other.nodeNameOffset),
-		  categoryOffset(other.categoryOffset),
-		  unionStationKeyOffset(other.unionStationKeyOffset),
-		  filtersOffset(other.filtersOffset),
-		  groupNameSize(other.groupNameSize),
-		  nodeNameSize(other.nodeNameSize),
-		  filtersSize(other.filtersSize),
-		  txnIdSize(other.txnIdSize),
-		  unionStationKeySize(other.unionStationKeySize),
-		  categorySize(other.categorySize),
-		  createdAt(other.createdAt),
-		  writeCount(other.writeCount),
-		  refCount(other.refCount),
-		  bodyOffset(other.bodyOffset),
-		  crashProtect(other.crashProtect),
-		  discarded(other.discarded),
-		  storage(boost::move(other.storage))
-	{
-		other.groupNameOffset = 0;
-		other.nodeNameOffset = 0;
-		other.categoryOffset = 0;
-		other.unionStationKeyOffset = 0;
-		other.filtersOffset = 0;
-		other.groupNameSize = 0;
-		other.nodeNameSize = 0;
-		other.filtersSize = 0;
-		other.txnIdSize = 0;
-		other.unionStationKeySize = 0;
-		other.categorySize = 0;
-		other.createdAt = 0;
-		other.writeCount = 0;
-		other.refCount = 0;
-		other.bodyOffset = 0;
-		other.crashProtect = false;
-		other.discarded = true;
+	Transaction(BOOST_RV_REF(Transaction) other) {
+		moveFrom(other);
+	}
+
+	~Transaction() {
+		if (pool != NULL) {
+			psg_destroy_pool(pool);
+		}
 	}
 
 	Transaction &operator=(BOOST_RV_REF(Transaction) other) {
 		if (this != &other) {
-			groupNameOffset = other.groupNameOffset;
-			nodeNameOffset = other.nodeNameOffset;
-			categoryOffset = other.categoryOffset;
-			unionStationKeyOffset = other.unionStationKeyOffset;
-			filtersOffset = other.filtersOffset;
-			groupNameSize = other.groupNameSize;
-			nodeNameSize = other.nodeNameSize;
-			filtersSize = other.filtersSize;
-			txnIdSize = other.txnIdSize;
-			unionStationKeySize = other.unionStationKeySize;
-			categorySize = other.categorySize;
-			createdAt = other.createdAt;
-			writeCount = other.writeCount;
-			refCount = other.refCount;
-			bodyOffset = other.bodyOffset;
-			crashProtect = other.crashProtect;
-			discarded = other.discarded;
-			storage = boost::move(other.storage);
-
-			other.groupNameOffset = 0;
-			other.nodeNameOffset = 0;
-			other.categoryOffset = 0;
-			other.unionStationKeyOffset = 0;
-			other.filtersOffset = 0;
-			other.groupNameSize = 0;
-			other.nodeNameSize = 0;
-			other.filtersSize = 0;
-			other.txnIdSize = 0;
-			other.unionStationKeySize = 0;
-			other.categorySize = 0;
-			other.createdAt = 0;
-			other.writeCount = 0;
-			other.refCount = 0;
-			other.bodyOffset = 0;
-			other.crashProtect = false;
-			other.discarded = true;
+			if (pool != NULL) {
+				psg_destroy_pool(pool);
+			}
+			moveFrom(other);
 		}
 		return *this;
 	}
 
 	StaticString getTxnId() const {
-		return StaticString(storage.data(), txnIdSize);
+		return txnId;
 	}
 
 	StaticString getGroupName() const {
-		return StaticString(storage.data() + groupNameOffset, groupNameSize);
+		return groupName;
 	}
 
 	StaticString getNodeName() const {
-		return StaticString(storage.data() + nodeNameOffset, nodeNameSize);
+		return nodeName;
 	}
 
 	StaticString getCategory() const {
-		return StaticString(storage.data() + categoryOffset, categorySize);
+		return category;
 	}
 
 	StaticString getUnionStationKey() const {
-		return StaticString(storage.data() + unionStationKeyOffset, unionStationKeySize);
+		return unionStationKey;
 	}
 
 	StaticString getFilters() const {
-		return StaticString(storage.data() + filtersOffset, filtersSize);
+		return filters;
+	}
+
+	unsigned int getBodySize() const {
+		return bodySize;
+	}
+
+	unsigned int getBodyChunkCount() const {
+		return bodyChunkCount;
 	}
 
-	StaticString getBody() const {
-		return StaticString(storage.data() + bodyOffset, storage.size() - bodyOffset);
+	/**
+	 * Stores the body's chunks into `result`, which must have room
+	 * for `getBodyChunkCount()` elements. The returned strings point
+	 * into this transaction's arena and remain valid until the next
+	 * `append()` or until the transaction is destroyed.
+	 */
+	void getBodyChunks(StaticString *result) const {
+		const BodyChunk *chunk = firstChunk;
+		while (chunk != NULL) {
+			*result = StaticString(chunk->data(), chunk->size);
+			result++;
+			chunk = chunk->next;
+		}
+	}
+
+	/**
+	 * Returns a contiguous copy of the body. Meant for code paths that
+	 * need to parse the body, such as filters. Log sinks should use
+	 * `getBodyChunks()` instead.
+	 */
+	string getBody() const {
+		string result;
+		const BodyChunk *chunk = firstChunk;
+
+		result.reserve(bodySize);
+		while (chunk != NULL) {
+			result.append(chunk->data(), chunk->size);
+			chunk = chunk->next;
+		}
+		return result;
 	}
 
 	bool crashProtectEnabled() const {
@@ -237,22 +318,20 @@ public:
 	}
 
 	void append(const StaticString &timestamp, const StaticString &data) {
-		char txnIdCopy[txnIdSize];
 		char writeCountStr[sizeof(unsigned int) * 2 + 1];
 		unsigned int writeCountStrSize = integerToHexatri(
 			writeCount, writeCountStr);
 
-		memcpy(txnIdCopy, getTxnId().data(), getTxnId().size());
 		writeCount++;
 
-		storage.append(txnIdCopy, getTxnId().size());
-		storage.append(1, ' ');
-		storage.append(timestamp.data(), timestamp.size());
-		storage.append(1, ' ');
-		storage.append(writeCountStr, writeCountStrSize);
-		storage.append(1, ' ');
-		storage.append(data.data(), data.size());
-		storage.append(1, '\n');
+		appendToBody(txnId.data(), txnId.size());
+		appendToBody(" ", 1);
+		appendToBody(timestamp.data(), timestamp.size());
+		appendToBody(" ", 1);
+		appendToBody(writeCountStr, writeCountStrSize);
+		appendToBody(" ", 1);
+		appendToBody(data.data(), data.size());
+		appendToBody("\n", 1);
 	}
 
 	Json::Value inspectStateAsJson() const {
@@ -264,7 +343,8 @@ public:
 		doc["category"] = getCategory().toString();
 		doc["key"] = getUnionStationKey().toString();
 		doc["refcount"] = refCount;
-		doc["body_size"] = byteSizeToJson(getBody().size());
+		doc["body_size"] = byteSizeToJson(bodySize);
+		doc["body_chunks"] = bodyChunkCount;
 		return doc;
 	}
 };
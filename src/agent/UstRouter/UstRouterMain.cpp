@@ -53,6 +53,7 @@
 #include <Exceptions.h>
 #include <FileDescriptor.h>
 #include <BackgroundEventLoop.h>
+#include <ServerKit/AcceptLoadBalancer.h>
 #include <ResourceLocator.h>
 #include <Constants.h>
 #include <ConfigKit/VariantMapUtils.h>
@@ -70,16 +71,28 @@ using namespace Passenger;
 
 namespace Passenger {
 namespace UstRouter {
+	struct ThreadWorkingObjects {
+		BackgroundEventLoop *bgloop;
+		ServerKit::Context *serverKitContext;
+		Controller *controller;
+
+		ThreadWorkingObjects()
+			: bgloop(NULL),
+			  serverKitContext(NULL),
+			  controller(NULL)
+			{ }
+	};
+
 	struct WorkingObjects {
 		FileDescriptor serverSocketFd;
 		vector<int> apiSockets;
 		ResourceLocator *resourceLocator;
 		ApiAccountDatabase apiAccountDatabase;
 
-		BackgroundEventLoop *bgloop;
-		ServerKit::Context *serverKitContext;
+		ServerKit::AcceptLoadBalancer<Controller> loadBalancer;
 		Controller::Schema controllerSchema;
-		Controller *controller;
+		vector<ThreadWorkingObjects> threadWorkingObjects;
+		ShardSetPtr shardSet;
 
 		BackgroundEventLoop *apiBgloop;
 		ServerKit::Context *apiServerKitContext;
@@ -95,9 +108,6 @@ namespace UstRouter {
 
 		WorkingObjects()
 			: resourceLocator(NULL),
-			  bgloop(NULL),
-			  serverKitContext(NULL),
-			  controller(NULL),
 			  apiBgloop(NULL),
 			  apiServerKitContext(NULL),
 			  apiServer(NULL),
@@ -306,14 +316,42 @@ initializeUnprivilegedWorkingObjects() {
 		*wo->resourceLocator, options.get("union_station_gateway_cert", false)));
 
 	UPDATE_TRACE_POINT();
-	wo->bgloop = new BackgroundEventLoop(true, true);
-	wo->serverKitContext = new ServerKit::Context(wo->bgloop->safe,
-		wo->bgloop->libuv_loop);
-	wo->controller = new Controller(wo->serverKitContext,
-		wo->controllerSchema,
-		ConfigKit::variantMapToJson(wo->controllerSchema, options));
-	wo->controller->initialize();
-	wo->controller->listen(wo->serverSocketFd);
+	unsigned int nthreads = options.getUint("ust_router_threads");
+	wo->threadWorkingObjects.reserve(nthreads);
+	for (unsigned int i = 0; i < nthreads; i++) {
+		UPDATE_TRACE_POINT();
+		ThreadWorkingObjects two;
+
+		Json::Value config = ConfigKit::variantMapToJson(wo->controllerSchema,
+			options);
+		config["thread_number"] = i + 1;
+
+		two.bgloop = new BackgroundEventLoop(true, true);
+		two.serverKitContext = new ServerKit::Context(two.bgloop->safe,
+			two.bgloop->libuv_loop);
+		two.controller = new Controller(two.serverKitContext,
+			wo->controllerSchema, config);
+		if (i == 0) {
+			wo->shardSet = boost::make_shared<ShardSet>(nthreads,
+				two.controller->config);
+		}
+		two.controller->shardSet = wo->shardSet;
+		two.controller->initialize();
+
+		wo->threadWorkingObjects.push_back(two);
+	}
+
+	UPDATE_TRACE_POINT();
+	if (nthreads == 1) {
+		wo->threadWorkingObjects[0].controller->listen(wo->serverSocketFd);
+	} else {
+		wo->loadBalancer.listen(wo->serverSocketFd);
+		wo->loadBalancer.servers.reserve(nthreads);
+		for (unsigned int i = 0; i < nthreads; i++) {
+			wo->loadBalancer.servers.push_back(
+				wo->threadWorkingObjects[i].controller);
+		}
+	}
 
 	UPDATE_TRACE_POINT();
 	if (!wo->apiSockets.empty()) {
@@ -322,7 +360,11 @@ initializeUnprivilegedWorkingObjects() {
 			wo->apiBgloop->libuv_loop);
 		wo->apiServer = new UstRouter::ApiServer(wo->apiServerKitContext,
 			wo->apiServerSchema);
-		wo->apiServer->controller = wo->controller;
+		wo->apiServer->controllers.reserve(nthreads);
+		for (unsigned int i = 0; i < nthreads; i++) {
+			wo->apiServer->controllers.push_back(
+				wo->threadWorkingObjects[i].controller);
+		}
 		wo->apiServer->apiAccountDatabase = &wo->apiAccountDatabase;
 		wo->apiServer->instanceDir = options.get("instance_dir", false);
 		wo->apiServer->fdPassingPassword = options.get("watchdog_fd_passing_password", false);
@@ -335,12 +377,13 @@ initializeUnprivilegedWorkingObjects() {
 	}
 
 	UPDATE_TRACE_POINT();
+	BackgroundEventLoop *firstLoop = wo->threadWorkingObjects[0].bgloop;
 	ev_signal_init(&wo->sigquitWatcher, printInfo, SIGQUIT);
-	ev_signal_start(wo->bgloop->libev_loop, &wo->sigquitWatcher);
+	ev_signal_start(firstLoop->libev_loop, &wo->sigquitWatcher);
 	ev_signal_init(&wo->sigintWatcher, onTerminationSignal, SIGINT);
-	ev_signal_start(wo->bgloop->libev_loop, &wo->sigintWatcher);
+	ev_signal_start(firstLoop->libev_loop, &wo->sigintWatcher);
 	ev_signal_init(&wo->sigtermWatcher, onTerminationSignal, SIGTERM);
-	ev_signal_start(wo->bgloop->libev_loop, &wo->sigtermWatcher);
+	ev_signal_start(firstLoop->libev_loop, &wo->sigtermWatcher);
 }
 
 static void
@@ -397,18 +440,22 @@ printInfoInThread() {
 	cerr << "\n";
 	cerr.flush();
 
-	string json;
-	cerr << "### Controller state\n";
-	wo->bgloop->safe->runSync(boost::bind(inspectControllerStateAsJson,
-		wo->controller, &json));
-	cerr << json;
-	cerr << "\n";
-	cerr.flush();
+	for (unsigned int i = 0; i < wo->threadWorkingObjects.size(); i++) {
+		ThreadWorkingObjects *two = &wo->threadWorkingObjects[i];
+		string json;
+
+		cerr << "### Controller state (thread " << (i + 1) << ")\n";
+		two->bgloop->safe->runSync(boost::bind(inspectControllerStateAsJson,
+			two->controller, &json));
+		cerr << json;
+		cerr << "\n";
+		cerr.flush();
+	}
 
 	struct MemoryKit::mbuf_pool stats;
 	cerr << "### mbuf stats\n\n";
-	wo->bgloop->safe->runSync(boost::bind(getMbufStats,
-		&wo->serverKitContext->mbuf_pool,
+	wo->threadWorkingObjects[0].bgloop->safe->runSync(boost::bind(getMbufStats,
+		&wo->threadWorkingObjects[0].serverKitContext->mbuf_pool,
 		&stats));
 	cerr << "nfree_mbuf_blockq    : " << stats.nfree_mbuf_blockq << "\n";
 	cerr << "nactive_mbuf_blockq  : " << stats.nactive_mbuf_blockq << "\n";
@@ -437,16 +484,28 @@ onTerminationSignal(EV_P_ struct ev_signal *watcher, int revents) {
 
 static void
 mainLoop() {
-	workingObjects->bgloop->start("Main event loop", 0);
-	if (workingObjects->apiBgloop != NULL) {
-		workingObjects->apiBgloop->start("API event loop", 0);
+	WorkingObjects *wo = workingObjects;
+
+	for (unsigned int i = 0; i < wo->threadWorkingObjects.size(); i++) {
+		ThreadWorkingObjects *two = &wo->threadWorkingObjects[i];
+		if (i == 0) {
+			two->bgloop->start("Main event loop", 0);
+		} else {
+			two->bgloop->start("Main event loop: thread " + toString(i + 1), 0);
+		}
+	}
+	if (wo->apiBgloop != NULL) {
+		wo->apiBgloop->start("API event loop", 0);
+	}
+	if (wo->threadWorkingObjects.size() > 1) {
+		wo->loadBalancer.start();
 	}
 	waitForExitEvent();
 }
 
 static void
-shutdownController() {
-	workingObjects->controller->shutdown();
+shutdownController(ThreadWorkingObjects *two) {
+	two->controller->shutdown();
 }
 
 static void
@@ -498,7 +557,13 @@ waitForExitEvent() {
 		/* We received an exit command. */
 		P_NOTICE("Received command to shutdown gracefully. "
 			"Waiting until all clients have disconnected...");
-		wo->bgloop->safe->runLater(shutdownController);
+		for (unsigned int i = 0; i < wo->threadWorkingObjects.size(); i++) {
+			ThreadWorkingObjects *two = &wo->threadWorkingObjects[i];
+			two->bgloop->safe->runLater(boost::bind(shutdownController, two));
+		}
+		if (wo->threadWorkingObjects.size() > 1) {
+			wo->loadBalancer.shutdown();
+		}
 		if (wo->apiBgloop != NULL) {
 			wo->apiBgloop->safe->runLater(shutdownApiServer);
 		}
@@ -523,7 +588,9 @@ cleanup() {
 	WorkingObjects *wo = workingObjects;
 
 	P_DEBUG("Shutting down " SHORT_PROGRAM_NAME " UstRouter...");
-	wo->bgloop->stop();
+	for (unsigned int i = 0; i < wo->threadWorkingObjects.size(); i++) {
+		wo->threadWorkingObjects[i].bgloop->stop();
+	}
 	if (wo->apiServer != NULL) {
 		wo->apiBgloop->stop();
 		delete wo->apiServer;
@@ -601,6 +668,7 @@ setAgentsOptionsDefaults() {
 
 	options.setDefault("ust_router_address", DEFAULT_UST_ROUTER_LISTEN_ADDRESS);
 	options.setDefault("ust_router_default_node_name", getHostName());
+	options.setDefaultUint("ust_router_threads", 1);
 }
 
 static void
@@ -634,6 +702,11 @@ sanityCheckOptions() {
 		}
 	}
 
+	if (options.getInt("ust_router_threads") < 1) {
+		fprintf(stderr, "ERROR: the number of threads must be at least 1.\n");
+		ok = false;
+	}
+
 	// Sanity check user accounts
 	string user = options.get("analytics_log_user", false);
 	if (!user.empty()) {
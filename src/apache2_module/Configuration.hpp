@@ -179,6 +179,10 @@ struct ServerConfig {
 	 * idle before it gets terminated. */
 	unsigned int poolIdleTime;
 
+	/** The maximum number of processes that may be spawned
+	 * concurrently, across all applications. */
+	unsigned int maxConcurrentSpawns;
+
 	unsigned int responseBufferHighWatermark;
 
 	unsigned int statThrottleRate;
@@ -220,6 +224,7 @@ struct ServerConfig {
 		socketBacklog      = DEFAULT_SOCKET_BACKLOG;
 		maxPoolSize        = DEFAULT_MAX_POOL_SIZE;
 		poolIdleTime       = DEFAULT_POOL_IDLE_TIME;
+		maxConcurrentSpawns = DEFAULT_MAX_CONCURRENT_SPAWNS;
 		responseBufferHighWatermark = DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK;
 		statThrottleRate   = DEFAULT_STAT_THROTTLE_RATE;
 		userSwitching      = true;
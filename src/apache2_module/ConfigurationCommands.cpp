@@ -182,6 +182,26 @@ AP_INIT_TAKE1("PassengerLveMinUid",
 	NULL,
 	RSRC_CONF,
 	"Minimum user id starting from which entering LVE and CageFS is allowed."),
+AP_INIT_TAKE1("PassengerSpawnConcurrency",
+	(Take1Func) cmd_passenger_spawn_concurrency,
+	NULL,
+	OR_OPTIONS | ACCESS_CONF | RSRC_CONF,
+	"The maximum number of processes that may be spawned at the same time for an application."),
+AP_INIT_FLAG("PassengerBlueGreenRestart",
+	(FlagFunc) cmd_passenger_blue_green_restart,
+	NULL,
+	OR_OPTIONS | ACCESS_CONF | RSRC_CONF,
+	"Whether to spawn an application's new processes before shutting down the old ones when restarting it."),
+AP_INIT_TAKE1("PassengerRestartWarmupPath",
+	(Take1Func) cmd_passenger_restart_warmup_path,
+	NULL,
+	OR_OPTIONS | ACCESS_CONF | RSRC_CONF,
+	"The path to request from every new process during a blue/green restart, before it receives traffic."),
+AP_INIT_FLAG("PassengerAutoscale",
+	(FlagFunc) cmd_passenger_autoscale,
+	NULL,
+	OR_OPTIONS | ACCESS_CONF | RSRC_CONF,
+	"Whether to adjust an application's minimum number of processes to the load it receives."),
 AP_INIT_TAKE1("RailsEnv",
 	(Take1Func) cmd_passenger_app_env,
 	NULL,
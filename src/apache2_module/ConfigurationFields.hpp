@@ -40,6 +40,16 @@
 struct GeneratedDirConfigPart {
 	enum Threeway { ENABLED, DISABLED, UNSET };
 
+	/*
+	 * Whether to adjust an application's minimum number of processes to the load it receives.
+	 */
+	Threeway autoscale;
+
+	/*
+	 * Whether to spawn an application's new processes before shutting down the old ones when restarting it.
+	 */
+	Threeway blueGreenRestart;
+
 	/*
 	 * Whether to buffer file uploads.
 	 */
@@ -120,6 +130,11 @@ struct GeneratedDirConfigPart {
 	 */
 	int minInstances;
 
+	/*
+	 * The maximum number of processes that may be spawned at the same time for an application.
+	 */
+	int spawnConcurrency;
+
 	/*
 	 * A timeout for application startup.
 	 */
@@ -165,6 +180,11 @@ struct GeneratedDirConfigPart {
 	 */
 	const char *restartDir;
 
+	/*
+	 * The path to request from every new process during a blue/green restart, before it receives traffic.
+	 */
+	const char *restartWarmupPath;
+
 	/*
 	 * The Ruby interpreter to use.
 	 */
@@ -434,3 +434,61 @@ cmd_passenger_lve_min_uid(cmd_parms *cmd, void *pcfg, const char *arg) {
 	}
 }
 
+static const char *
+cmd_passenger_spawn_concurrency(cmd_parms *cmd, void *pcfg, const char *arg) {
+	DirConfig *config = (DirConfig *) pcfg;
+	char *end;
+	long result;
+
+	result = strtol(arg, &end, 10);
+	if (*end != '\0') {
+		string message = "Invalid number specified for ";
+		message.append(cmd->directive->directive);
+		message.append(".");
+
+		char *messageStr = (char *) apr_palloc(cmd->temp_pool,
+			message.size() + 1);
+		memcpy(messageStr, message.c_str(), message.size() + 1);
+		return messageStr;
+	} else if (result < 1) {
+		string message = "Value for ";
+		message.append(cmd->directive->directive);
+		message.append(" must be greater than or equal to 1.");
+
+		char *messageStr = (char *) apr_palloc(cmd->temp_pool,
+			message.size() + 1);
+		memcpy(messageStr, message.c_str(), message.size() + 1);
+		return messageStr;
+	} else {
+		config->spawnConcurrency = (int) result;
+		return NULL;
+	}
+}
+
+static const char *
+cmd_passenger_blue_green_restart(cmd_parms *cmd, void *pcfg, const char *arg) {
+	DirConfig *config = (DirConfig *) pcfg;
+	config->blueGreenRestart =
+		arg ?
+		DirConfig::ENABLED :
+		DirConfig::DISABLED;
+	return NULL;
+}
+
+static const char *
+cmd_passenger_restart_warmup_path(cmd_parms *cmd, void *pcfg, const char *arg) {
+	DirConfig *config = (DirConfig *) pcfg;
+	config->restartWarmupPath = arg;
+	return NULL;
+}
+
+static const char *
+cmd_passenger_autoscale(cmd_parms *cmd, void *pcfg, const char *arg) {
+	DirConfig *config = (DirConfig *) pcfg;
+	config->autoscale =
+		arg ?
+		DirConfig::ENABLED :
+		DirConfig::DISABLED;
+	return NULL;
+}
+
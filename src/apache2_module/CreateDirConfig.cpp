@@ -66,3 +66,7 @@ config->restartDir = NULL;
 config->appGroupName = NULL;
 config->forceMaxConcurrentRequestsPerProcess = UNSET_INT_VALUE;
 config->lveMinUid = UNSET_INT_VALUE;
+config->spawnConcurrency = UNSET_INT_VALUE;
+config->blueGreenRestart = DirConfig::UNSET;
+config->restartWarmupPath = NULL;
+config->autoscale = DirConfig::UNSET;
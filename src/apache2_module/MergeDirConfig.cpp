@@ -153,3 +153,19 @@ config->lveMinUid =
 	(add->lveMinUid == UNSET_INT_VALUE) ?
 	base->lveMinUid :
 	add->lveMinUid;
+config->spawnConcurrency =
+	(add->spawnConcurrency == UNSET_INT_VALUE) ?
+	base->spawnConcurrency :
+	add->spawnConcurrency;
+config->blueGreenRestart =
+	(add->blueGreenRestart == DirConfig::UNSET) ?
+	base->blueGreenRestart :
+	add->blueGreenRestart;
+config->restartWarmupPath =
+	(add->restartWarmupPath == NULL) ?
+	base->restartWarmupPath :
+	add->restartWarmupPath;
+config->autoscale =
+	(add->autoscale == DirConfig::UNSET) ?
+	base->autoscale :
+	add->autoscale;
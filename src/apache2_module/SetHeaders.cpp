@@ -109,3 +109,15 @@ addHeader(r, result, StaticString("!~PASSENGER_FORCE_MAX_CONCURRENT_REQUESTS_PER
 addHeader(r, result, StaticString("!~PASSENGER_LVE_MIN_UID",
 		sizeof("!~PASSENGER_LVE_MIN_UID") - 1),
 	config->lveMinUid);
+addHeader(r, result, StaticString("!~PASSENGER_SPAWN_CONCURRENCY",
+		sizeof("!~PASSENGER_SPAWN_CONCURRENCY") - 1),
+	config->spawnConcurrency);
+addHeader(result, StaticString("!~PASSENGER_BLUE_GREEN_RESTART",
+		sizeof("!~PASSENGER_BLUE_GREEN_RESTART") - 1),
+	config->blueGreenRestart);
+addHeader(result, StaticString("!~PASSENGER_RESTART_WARMUP_PATH",
+		sizeof("!~PASSENGER_RESTART_WARMUP_PATH") - 1),
+	config->restartWarmupPath);
+addHeader(result, StaticString("!~PASSENGER_AUTOSCALE",
+		sizeof("!~PASSENGER_AUTOSCALE") - 1),
+	config->autoscale);
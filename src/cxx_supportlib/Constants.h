@@ -37,6 +37,7 @@
  */
 
 #define AGENT_EXE "PassengerAgent"
+#define APP_CONNECTION_IDLE_TIMEOUT 30
 #define DEB_APACHE_MODULE_PACKAGE "libapache2-mod-passenger"
 #define DEB_DEV_PACKAGE "passenger-dev"
 #define DEB_MAIN_PACKAGE "passenger"
@@ -46,12 +47,15 @@
 #define DEFAULT_ANALYTICS_LOG_USER "nobody"
 #define DEFAULT_APP_ENV "production"
 #define DEFAULT_APP_THREAD_COUNT 1
+#define DEFAULT_BUFFER_FILE_POOL_SIZE 16
 #define DEFAULT_CONCURRENCY_MODEL "process"
 #define DEFAULT_FILE_BUFFERED_CHANNEL_THRESHOLD 131072
 #define DEFAULT_HTTP_SERVER_LISTEN_ADDRESS "tcp://127.0.0.1:3000"
 #define DEFAULT_INTEGRATION_MODE "standalone"
 #define DEFAULT_LOG_LEVEL 3
 #define DEFAULT_LVE_MIN_UID 500
+#define DEFAULT_MAX_CONFIG_PROFILES 1024
+#define DEFAULT_MAX_CONCURRENT_SPAWNS 4
 #define DEFAULT_MAX_POOL_SIZE 6
 #define DEFAULT_MAX_PRELOADER_IDLE_TIME 300
 #define DEFAULT_MAX_REQUEST_QUEUE_SIZE 100
@@ -60,15 +64,20 @@
 #define DEFAULT_POOL_IDLE_TIME 300
 #define DEFAULT_PYTHON "python"
 #define DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK 134217728
+#define DEFAULT_RESPONSE_SPLICING_THRESHOLD 131072
 #define DEFAULT_RUBY "ruby"
 #define DEFAULT_SOCKET_BACKLOG 2048
 #define DEFAULT_SPAWN_METHOD "smart"
 #define DEFAULT_START_TIMEOUT 90000
 #define DEFAULT_STAT_THROTTLE_RATE 10
 #define DEFAULT_STICKY_SESSIONS_COOKIE_NAME "_passenger_route"
+#define DEFAULT_TURBOCACHE_MAX_SIZE 33554432
+#define DEFAULT_TURBOCACHE_SHARDS 16
 #define DEFAULT_UNION_STATION_GATEWAY_ADDRESS "gateway.unionstationapp.com"
 #define DEFAULT_UNION_STATION_GATEWAY_PORT 443
 #define DEFAULT_UST_ROUTER_LISTEN_ADDRESS "tcp://127.0.0.1:9344"
+#define DEFAULT_UST_ROUTER_MAX_CONCURRENT_UPLOADS 4
+#define DEFAULT_UST_ROUTER_SPOOL_SIZE 33554432
 #define DEFAULT_WEB_APP_USER "nobody"
 #define ENTERPRISE_URL "https://www.phusionpassenger.com/enterprise"
 #define FEEDBACK_FD 3
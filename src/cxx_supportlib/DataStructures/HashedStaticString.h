@@ -58,6 +58,12 @@ public:
 		  m_hash(b.m_hash)
 		{ }
 
+	HashedStaticString &operator=(const HashedStaticString &b) {
+		StaticString::operator=(b);
+		m_hash = b.m_hash;
+		return *this;
+	}
+
 	HashedStaticString(const string &s)
 		: StaticString(s)
 	{
@@ -45,6 +45,7 @@
 #include <Logging.h>
 #include <Utils.h>
 #include <Utils/IOUtils.h>
+#include <Utils/SystemTime.h>
 
 namespace Passenger {
 namespace ServerKit {
@@ -78,6 +79,14 @@ using namespace boost;
  * Inside the "PassengerAgent core", we activate AcceptLoadBalancer
  * only if `core_threads > 1`, which is often the case because
  * `core_threads` defaults to the number of CPU cores.
+ *
+ * The price of this approach is an extra thread hop per client. On Linux,
+ * the core can instead give each thread its own SO_REUSEPORT server socket
+ * for TCP addresses (see `--reuse-port`), so that the kernel distributes
+ * clients and the AcceptLoadBalancer is only used for the remaining
+ * (e.g. Unix domain socket) addresses. Each Server records how many
+ * clients were handed over, and how long the handover took, so that both
+ * modes can be compared.
  */
 template<typename Server>
 class AcceptLoadBalancer {
@@ -89,6 +98,7 @@ private:
 	int newClients[ACCEPT_BURST_COUNT];
 
 	unsigned int nEndpoints;
+	MonotonicTimeUsec newClientsAcceptedAt;
 	boost::uint8_t newClientCount;
 	boost::uint8_t nextServer;
 	bool accept4Available;
@@ -163,14 +173,17 @@ private:
 			P_TRACE(2, "Feeding client to server thread " << (int) nextServer <<
 				": file descriptor " << newClients[i]);
 			ctx->libev->runLater(boost::bind(feedNewClient, servers[nextServer],
-				newClients[i]));
+				newClients[i], newClientsAcceptedAt));
 			nextServer = (nextServer + 1) % servers.size();
 		}
 
 		newClientCount = 0;
 	}
 
-	static void feedNewClient(Server *server, int fd) {
+	static void feedNewClient(Server *server, int fd, MonotonicTimeUsec acceptedAt) {
+		MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+		server->clientHandoverTimes.record((now > acceptedAt) ? now - acceptedAt : 0);
+		server->totalClientsHandedOver++;
 		server->feedNewClients(&fd, 1);
 	}
 
@@ -238,6 +251,7 @@ private:
 				i++;
 			}
 
+			newClientsAcceptedAt = SystemTime::getMonotonicUsec();
 			distributeNewClients();
 		}
 	}
@@ -247,6 +261,7 @@ public:
 
 	AcceptLoadBalancer()
 		: nEndpoints(0),
+		  newClientsAcceptedAt(0),
 		  newClientCount(0),
 		  nextServer(0),
 		  accept4Available(true),
@@ -300,6 +315,10 @@ public:
 		#undef EXTENSION_EOPNOTSUPP
 	}
 
+	unsigned int getEndpointCount() const {
+		return nEndpoints;
+	}
+
 	void start() {
 		boost::function<void ()> func = boost::bind(&AcceptLoadBalancer<Server>::mainLoop, this);
 		thread = new oxt::thread(boost::bind(runAndPrintExceptions, func, true),
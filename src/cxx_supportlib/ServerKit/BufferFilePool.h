@@ -0,0 +1,298 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_SERVER_KIT_BUFFER_FILE_POOL_H_
+#define _PASSENGER_SERVER_KIT_BUFFER_FILE_POOL_H_
+
+#include <boost/cstdint.hpp>
+#include <oxt/system_calls.hpp>
+#include <string>
+#include <vector>
+#include <list>
+#include <cstdlib>
+#include <cerrno>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <uv.h>
+#include <jsoncpp/json.h>
+#include <Logging.h>
+#include <Utils/StrIntUtils.h>
+#include <Utils/SystemTime.h>
+
+namespace Passenger {
+namespace ServerKit {
+
+using namespace std;
+
+
+/**
+ * A pool of open, already unlinked and empty buffer files that
+ * FileBufferedChannels can use when they switch to the in-file mode, so that
+ * they don't have to create and unlink a new file in the buffer directory
+ * every time. When a channel is done with its file, the file is truncated in
+ * the background and put back in the pool, unless the pool is already full,
+ * in which case the file is closed.
+ *
+ * On Linux, files are created with O_TMPFILE where the filesystem supports it,
+ * so that they never appear in the buffer directory at all.
+ *
+ * The pool also keeps statistics about how many buffer files are created
+ * (whether by the pool itself, or by channels because the pool was empty)
+ * and how often a pooled file is reused.
+ *
+ * Not thread-safe: each event loop thread should have its own pool. The pool
+ * must outlive all FileBufferedChannels that use it, including any of their
+ * I/O operations that are still in progress.
+ */
+class BufferFilePool {
+private:
+	static const MonotonicTimeUsec CREATION_RATE_WINDOW = 60 * 1000000;
+
+	struct TruncateRequest {
+		uv_fs_t req;
+		BufferFilePool *pool;
+		int fd;
+	};
+
+	uv_loop_t *libuv;
+	string dir;
+	unsigned int max;
+	vector<int> fds;
+	list<TruncateRequest *> truncateRequests;
+
+	boost::uint64_t totalCreated;
+	boost::uint64_t totalReused;
+	boost::uint64_t totalMisses;
+	boost::uint64_t totalDiscarded;
+	MonotonicTimeUsec windowStart;
+	unsigned int currentWindowCreated;
+	unsigned int previousWindowCreated;
+
+	static void closeFd(int fd) {
+		P_LOG_FILE_DESCRIPTOR_CLOSE(fd);
+		oxt::syscalls::close(fd);
+	}
+
+	static void fileTruncated(uv_fs_t *req) {
+		TruncateRequest *truncateRequest = static_cast<TruncateRequest *>(req->data);
+		BufferFilePool *self = truncateRequest->pool;
+		int fd = truncateRequest->fd;
+		bool ok = req->result >= 0;
+
+		uv_fs_req_cleanup(req);
+		if (self != NULL) {
+			self->truncateRequests.remove(truncateRequest);
+		}
+		delete truncateRequest;
+
+		if (self != NULL && ok && self->fds.size() < self->max) {
+			self->fds.push_back(fd);
+		} else {
+			if (self != NULL) {
+				self->totalDiscarded++;
+			}
+			closeFd(fd);
+		}
+	}
+
+	void rotateWindow(MonotonicTimeUsec now) {
+		if (now - windowStart >= CREATION_RATE_WINDOW) {
+			if (now - windowStart >= 2 * CREATION_RATE_WINDOW) {
+				previousWindowCreated = 0;
+			} else {
+				previousWindowCreated = currentWindowCreated;
+			}
+			currentWindowCreated = 0;
+			windowStart = now;
+		}
+	}
+
+	unsigned int getCreatedInLastWindow(MonotonicTimeUsec now) const {
+		if (now - windowStart < CREATION_RATE_WINDOW) {
+			return previousWindowCreated;
+		} else if (now - windowStart < 2 * CREATION_RATE_WINDOW) {
+			return currentWindowCreated;
+		} else {
+			return 0;
+		}
+	}
+
+	int createFile() {
+		int fd;
+
+		#ifdef O_TMPFILE
+			do {
+				fd = open(dir.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+			} while (fd == -1 && errno == EINTR);
+			if (fd != -1) {
+				return fd;
+			}
+		#endif
+
+		string path;
+		do {
+			path = dir + "/buffer." + toString(rand());
+			fd = oxt::syscalls::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+		} while (fd == -1 && errno == EEXIST);
+		if (fd != -1) {
+			unlink(path.c_str());
+		}
+		return fd;
+	}
+
+public:
+	BufferFilePool(uv_loop_t *_libuv, const string &_dir, unsigned int _max)
+		: libuv(_libuv),
+		  dir(_dir),
+		  max(_max),
+		  totalCreated(0),
+		  totalReused(0),
+		  totalMisses(0),
+		  totalDiscarded(0),
+		  windowStart(SystemTime::getMonotonicUsec()),
+		  currentWindowCreated(0),
+		  previousWindowCreated(0)
+		{ }
+
+	~BufferFilePool() {
+		list<TruncateRequest *>::iterator it, end = truncateRequests.end();
+		for (it = truncateRequests.begin(); it != end; it++) {
+			// Their callbacks will close the file descriptors.
+			(*it)->pool = NULL;
+		}
+		for (unsigned int i = 0; i < fds.size(); i++) {
+			closeFd(fds[i]);
+		}
+	}
+
+	/**
+	 * Synchronously creates files until the pool is full. Returns the
+	 * number of files created, which is less than requested if file
+	 * creation failed. In that case, `errno` is set.
+	 */
+	unsigned int fill() {
+		unsigned int count = 0;
+		while (fds.size() + truncateRequests.size() < max) {
+			int fd = createFile();
+			if (fd == -1) {
+				break;
+			}
+			P_LOG_FILE_DESCRIPTOR_OPEN4(fd, __FILE__, __LINE__,
+				"FileBufferedChannel pooled buffer file");
+			recordCreation();
+			fds.push_back(fd);
+			count++;
+		}
+		return count;
+	}
+
+	/**
+	 * Returns an empty buffer file from the pool, or -1 if the pool is empty.
+	 * The caller becomes the owner of the file descriptor.
+	 */
+	int acquire() {
+		if (fds.empty()) {
+			totalMisses++;
+			return -1;
+		} else {
+			int fd = fds.back();
+			fds.pop_back();
+			totalReused++;
+			return fd;
+		}
+	}
+
+	/**
+	 * Takes ownership of a buffer file that is no longer in use. It is put
+	 * back into the pool after it has been truncated, or closed if the pool
+	 * is full. There must not be any I/O operations in progress on `fd`.
+	 */
+	void release(int fd) {
+		if (fds.size() + truncateRequests.size() >= max) {
+			totalDiscarded++;
+			closeFd(fd);
+			return;
+		}
+
+		TruncateRequest *truncateRequest = new TruncateRequest();
+		truncateRequest->req.data = truncateRequest;
+		truncateRequest->pool = this;
+		truncateRequest->fd = fd;
+		if (uv_fs_ftruncate(libuv, &truncateRequest->req, fd, 0, fileTruncated) != 0) {
+			delete truncateRequest;
+			totalDiscarded++;
+			closeFd(fd);
+		} else {
+			truncateRequests.push_back(truncateRequest);
+		}
+	}
+
+	/**
+	 * Must be called when a channel had to create a buffer file by itself.
+	 */
+	void recordCreation() {
+		MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+		rotateWindow(now);
+		currentWindowCreated++;
+		totalCreated++;
+	}
+
+	unsigned int size() const {
+		return fds.size();
+	}
+
+	unsigned int capacity() const {
+		return max;
+	}
+
+	boost::uint64_t getTotalCreated() const {
+		return totalCreated;
+	}
+
+	boost::uint64_t getTotalReused() const {
+		return totalReused;
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		doc["size"] = (Json::UInt) fds.size();
+		doc["capacity"] = max;
+		doc["truncating"] = (Json::UInt) truncateRequests.size();
+		doc["files_created"] = (Json::UInt64) totalCreated;
+		doc["files_created_last_minute"] = getCreatedInLastWindow(
+			SystemTime::getMonotonicUsec());
+		doc["reuse_hits"] = (Json::UInt64) totalReused;
+		doc["reuse_misses"] = (Json::UInt64) totalMisses;
+		doc["files_discarded"] = (Json::UInt64) totalDiscarded;
+		return doc;
+	}
+};
+
+
+} // namespace ServerKit
+} // namespace Passenger
+
+#endif /* _PASSENGER_SERVER_KIT_BUFFER_FILE_POOL_H_ */
@@ -27,6 +27,7 @@
 #define _PASSENGER_SERVER_KIT_CONTEXT_H_
 
 #include <boost/make_shared.hpp>
+#include <boost/cstdint.hpp>
 #include <string>
 #include <cstddef>
 #include <jsoncpp/json.h>
@@ -43,6 +44,9 @@ extern "C" {
 namespace Passenger {
 namespace ServerKit {
 
+class FileIoRing;
+class BufferFilePool;
+
 
 struct FileBufferedChannelConfig {
 	string bufferDir;
@@ -67,6 +71,9 @@ private:
 	void initialize() {
 		mbuf_pool.mbuf_block_chunk_size = DEFAULT_MBUF_CHUNK_SIZE;
 		MemoryKit::mbuf_pool_init(&mbuf_pool);
+		fileIoRing = NULL;
+		bufferFilePool = NULL;
+		fileBufferedChannelSpills = 0;
 	}
 
 public:
@@ -75,6 +82,23 @@ public:
 	struct MemoryKit::mbuf_pool mbuf_pool;
 	string secureModePassword;
 	FileBufferedChannelConfig defaultFileBufferedChannelConfig;
+	/**
+	 * If not NULL, FileBufferedChannels perform their file reads and
+	 * writes through this ring instead of through libuv. Not owned
+	 * by the Context; must outlive all channels that use it.
+	 */
+	FileIoRing *fileIoRing;
+	/**
+	 * If not NULL, FileBufferedChannels take their buffer files from this
+	 * pool and give them back when done. Not owned by the Context; must
+	 * outlive all channels that use it.
+	 */
+	BufferFilePool *bufferFilePool;
+	/**
+	 * Number of times a FileBufferedChannel in this context switched to
+	 * in-file mode. Only modified from the event loop thread.
+	 */
+	boost::uint64_t fileBufferedChannelSpills;
 
 	Context(const SafeLibevPtr &_libev, struct uv_loop_s *_libuv)
 		: libev(_libev),
@@ -127,6 +151,7 @@ public:
 		#endif
 
 		doc["mbuf_pool"] = mbufDoc;
+		doc["file_buffered_channel_spills"] = (Json::UInt64) fileBufferedChannelSpills;
 
 		return doc;
 	}
@@ -43,6 +43,8 @@
 #include <deque>
 #include <Logging.h>
 #include <ServerKit/Context.h>
+#include <ServerKit/FileIoRing.h>
+#include <ServerKit/BufferFilePool.h>
 #include <ServerKit/Errors.h>
 #include <ServerKit/Channel.h>
 #include <Utils/JsonUtils.h>
@@ -237,6 +239,11 @@ private:
 		uv_loop_t *libuv;
 		/* req.data always refers back to the FileIOContext object itself. */
 		uv_fs_t req;
+		/**
+		 * Whether `req` was started on the Context's FileIoRing instead
+		 * of on libuv. Such requests need no cleanup and cannot be canceled.
+		 */
+		bool usingFileIoRing;
 
 		/**
 		 * Also a pointer to the FileBufferedChannel, but this is used for
@@ -250,6 +257,7 @@ private:
 			: self(_self),
 			  libev(_self->ctx->libev),
 			  libuv(_self->ctx->libuv),
+			  usingFileIoRing(false),
 			  logbase(_self)
 		{
 			req.type = UV_UNKNOWN_REQ;
@@ -264,11 +272,22 @@ private:
 				// uv_cancel() fails if the work is already in progress
 				// or completed, so we set self to NULL as an extra
 				// indicator that this I/O operation is canceled.
-				uv_cancel((uv_req_t *) &req);
+				if (!usingFileIoRing) {
+					uv_cancel((uv_req_t *) &req);
+				}
 				self = NULL;
 			}
 		}
 
+		/**
+		 * Must be called from the I/O callback before doing anything else.
+		 */
+		void cleanup() {
+			if (!usingFileIoRing) {
+				uv_fs_req_cleanup(&req);
+			}
+		}
+
 		/**
 		 * Checks whether this I/O operation has been canceled.
 		 * Note that the libuv request may not have been canceled
@@ -325,6 +344,12 @@ private:
 		 */
 		uv_loop_t *libuv;
 
+		/**
+		 * The pool that the temp file is given back to when this
+		 * structure is destroyed. May be NULL.
+		 */
+		BufferFilePool *bufferFilePool;
+
 		/**
 		 * The file descriptor of the temp file. It's -1 if the file is being
 		 * created.
@@ -374,8 +399,9 @@ private:
 		 */
 		boost::int64_t written;
 
-		InFileMode(uv_loop_t *_libuv)
+		InFileMode(uv_loop_t *_libuv, BufferFilePool *_bufferFilePool)
 			: libuv(_libuv),
+			  bufferFilePool(_bufferFilePool),
 			  fd(-1),
 			  readRequest(NULL),
 			  writerState(WS_INACTIVE),
@@ -388,7 +414,11 @@ private:
 			P_ASSERT_EQ(readRequest, 0);
 			P_ASSERT_EQ(writerRequest, 0);
 			if (fd != -1) {
-				closeFdInBackground();
+				if (bufferFilePool != NULL) {
+					bufferFilePool->release(fd);
+				} else {
+					closeFdInBackground();
+				}
 			}
 		}
 
@@ -736,15 +766,14 @@ private:
 		readerState = RS_READING_FROM_FILE;
 		inFileMode->readRequest = readContext;
 
-		uv_fs_read(ctx->libuv, &readContext->req, inFileMode->fd,
-			&readContext->uvBuffer, 1, inFileMode->readOffset,
-			_nextChunkDoneReading);
+		startFileRead(readContext, inFileMode->fd, &readContext->uvBuffer,
+			inFileMode->readOffset, _nextChunkDoneReading);
 		verifyInvariants();
 	}
 
 	static void _nextChunkDoneReading(uv_fs_t *req) {
 		ReadContext *readContext = (ReadContext *) req->data;
-		uv_fs_req_cleanup(req);
+		readContext->cleanup();
 		if (readContext->isCanceled()) {
 			delete readContext;
 			return;
@@ -836,7 +865,9 @@ private:
 
 		FBC_DEBUG("Switching to in-file mode");
 		mode = IN_FILE_MODE;
-		inFileMode = boost::make_shared<InFileMode>(ctx->libuv);
+		ctx->fileBufferedChannelSpills++;
+		inFileMode = boost::make_shared<InFileMode>(ctx->libuv,
+			ctx->bufferFilePool);
 		createBufferFile();
 	}
 
@@ -875,6 +906,16 @@ private:
 		P_ASSERT_EQ(inFileMode->writerState, WS_INACTIVE);
 		P_ASSERT_EQ(inFileMode->fd, -1);
 
+		if (ctx->bufferFilePool != NULL && config->delayInFileModeSwitching == 0) {
+			int fd = ctx->bufferFilePool->acquire();
+			if (fd != -1) {
+				FBC_DEBUG("Writer: reusing pooled buffer file (fd " << fd << ")");
+				inFileMode->fd = fd;
+				moveNextBufferToFile();
+				return;
+			}
+		}
+
 		FileCreationContext *fcContext = new FileCreationContext(this);
 		fcContext->path = config->bufferDir;
 		fcContext->path.append("/buffer.");
@@ -955,6 +996,9 @@ private:
 			P_LOG_FILE_DESCRIPTOR_OPEN4(fcContext->req.result, __FILE__, __LINE__,
 				"FileBufferedChannel buffer file");
 			inFileMode->fd = fcContext->req.result;
+			if (ctx->bufferFilePool != NULL) {
+				ctx->bufferFilePool->recordCreation();
+			}
 			// Will take care of deleting fcContext
 			unlinkBufferFileInBackground(fcContext);
 			moveNextBufferToFile();
@@ -1095,8 +1139,8 @@ private:
 
 		inFileMode->writerState = WS_MOVING;
 		inFileMode->writerRequest = moveContext;
-		int result = uv_fs_write(ctx->libuv, &moveContext->req, inFileMode->fd,
-			&moveContext->uvBuffer, 1,
+		int result = startFileWrite(moveContext, inFileMode->fd,
+			&moveContext->uvBuffer,
 			inFileMode->readOffset + inFileMode->written,
 			_bufferWrittenToFile);
 		if (result != 0) {
@@ -1109,7 +1153,7 @@ private:
 
 	static void _bufferWrittenToFile(uv_fs_t *req) {
 		MoveContext *moveContext = static_cast<MoveContext *>(req->data);
-		uv_fs_req_cleanup(req);
+		moveContext->cleanup();
 		if (moveContext->isCanceled()) {
 			delete moveContext;
 			return;
@@ -1154,8 +1198,8 @@ private:
 				moveContext->uvBuffer = uv_buf_init(
 					moveContext->buffer.start + moveContext->written,
 					moveContext->buffer.size() - moveContext->written);
-				int result = uv_fs_write(ctx->libuv, &moveContext->req,
-					inFileMode->fd, &moveContext->uvBuffer, 1,
+				int result = startFileWrite(moveContext,
+					inFileMode->fd, &moveContext->uvBuffer,
 					inFileMode->readOffset + inFileMode->written,
 					_bufferWrittenToFile);
 				if (result != 0) {
@@ -1178,6 +1222,43 @@ private:
 
 	/***** Misc *****/
 
+	/**
+	 * Starts reading from the file, through the Context's FileIoRing if
+	 * there is one and it has room, or through libuv otherwise.
+	 */
+	int startFileRead(FileIOContext *context, int fd, uv_buf_t *buffer,
+		boost::int64_t offset, uv_fs_cb callback)
+	{
+		if (ctx->fileIoRing != NULL && ctx->fileIoRing->read(fd,
+			buffer->base, buffer->len, offset, &context->req, callback))
+		{
+			context->usingFileIoRing = true;
+			return 0;
+		} else {
+			context->usingFileIoRing = false;
+			return uv_fs_read(ctx->libuv, &context->req, fd, buffer, 1,
+				offset, callback);
+		}
+	}
+
+	/**
+	 * Like `startFileRead()`, but writes to the file.
+	 */
+	int startFileWrite(FileIOContext *context, int fd, uv_buf_t *buffer,
+		boost::int64_t offset, uv_fs_cb callback)
+	{
+		if (ctx->fileIoRing != NULL && ctx->fileIoRing->write(fd,
+			buffer->base, buffer->len, offset, &context->req, callback))
+		{
+			context->usingFileIoRing = true;
+			return 0;
+		} else {
+			context->usingFileIoRing = false;
+			return uv_fs_write(ctx->libuv, &context->req, fd, buffer, 1,
+				offset, callback);
+		}
+	}
+
 	void setError(int errcode, const char *file, unsigned int line) {
 		if (mode >= ERROR) {
 			return;
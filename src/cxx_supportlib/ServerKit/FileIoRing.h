@@ -0,0 +1,477 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_SERVER_KIT_FILE_IO_RING_H_
+#define _PASSENGER_SERVER_KIT_FILE_IO_RING_H_
+
+#include <boost/cstdint.hpp>
+#include <oxt/macros.hpp>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ev.h>
+#include <uv.h>
+#include <stdint.h>
+#include <jsoncpp/json.h>
+#include <Logging.h>
+
+#ifdef HAS_IO_URING
+	#include <linux/io_uring.h>
+	#include <sys/syscall.h>
+	#include <sys/mman.h>
+	#include <sys/eventfd.h>
+	#include <unistd.h>
+#endif
+
+namespace Passenger {
+namespace ServerKit {
+
+using namespace std;
+
+
+/**
+ * Performs file reads and writes on behalf of FileBufferedChannel using
+ * Linux's io_uring interface, as an alternative to libuv's thread pool.
+ *
+ * Requests are queued in the submission ring and are submitted to the kernel
+ * in a single `io_uring_enter()` call right before the event loop blocks,
+ * so all channels that start a disk operation during the same event loop
+ * iteration share one system call. Completions are signalled through an
+ * eventfd that is watched by the event loop.
+ *
+ * Requests are described with libuv `uv_fs_t` objects so that callers can
+ * use the same callbacks for both backends: upon completion, `req->result`
+ * is set to the number of bytes transferred or to a negative errno value,
+ * after which the callback is invoked. The caller must not call
+ * `uv_fs_req_cleanup()` or `uv_cancel()` on such requests.
+ *
+ * io_uring support is optional at compile time (HAS_IO_URING) and is detected
+ * at runtime by `initialize()`. When unavailable, `initialize()` returns
+ * false and the caller should keep using libuv.
+ *
+ * Not thread-safe: must only be used from the thread that runs `loop`.
+ */
+class FileIoRing {
+public:
+	static const unsigned int DEFAULT_ENTRIES = 256;
+
+private:
+	struct ev_loop *loop;
+	unsigned int entries;
+	unsigned int inflight;
+	unsigned int queued;
+	boost::uint64_t totalSubmitted;
+	boost::uint64_t totalSubmitCalls;
+	boost::uint64_t totalCompleted;
+	string initializationError;
+	bool initialized;
+
+	#ifdef HAS_IO_URING
+		int ringFd;
+		int eventFd;
+		void *sqRing;
+		void *cqRing;
+		size_t sqRingSize;
+		size_t cqRingSize;
+		struct io_uring_sqe *sqes;
+		size_t sqesSize;
+
+		unsigned int *sqHead;
+		unsigned int *sqTail;
+		unsigned int sqMask;
+		unsigned int sqEntries;
+		unsigned int *sqArray;
+
+		unsigned int *cqHead;
+		unsigned int *cqTail;
+		unsigned int cqMask;
+		unsigned int cqEntries;
+		struct io_uring_cqe *cqes;
+
+		struct ev_io eventFdWatcher;
+		struct ev_prepare prepareWatcher;
+
+		static int sysSetup(unsigned int entries, struct io_uring_params *params) {
+			return (int) syscall(__NR_io_uring_setup, entries, params);
+		}
+
+		static int sysEnter(int fd, unsigned int toSubmit, unsigned int minComplete,
+			unsigned int flags)
+		{
+			return (int) syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+				flags, NULL, 0);
+		}
+
+		static int sysRegister(int fd, unsigned int opcode, void *arg, unsigned int nargs) {
+			return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nargs);
+		}
+
+		bool fail(const char *what, int e) {
+			initializationError = string(what) + ": " + strerror(e);
+			releaseResources();
+			return false;
+		}
+
+		bool opcodesSupported() {
+			size_t size = sizeof(struct io_uring_probe)
+				+ 256 * sizeof(struct io_uring_probe_op);
+			struct io_uring_probe *probe = (struct io_uring_probe *) calloc(1, size);
+			if (probe == NULL) {
+				return false;
+			}
+			bool result = sysRegister(ringFd, IORING_REGISTER_PROBE, probe, 256) == 0
+				&& probe->ops_len > IORING_OP_READ
+				&& probe->ops_len > IORING_OP_WRITE
+				&& (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+				&& (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+			free(probe);
+			return result;
+		}
+
+		void releaseResources() {
+			if (sqes != NULL) {
+				munmap(sqes, sqesSize);
+				sqes = NULL;
+			}
+			if (cqRing != NULL && cqRing != sqRing) {
+				munmap(cqRing, cqRingSize);
+			}
+			cqRing = NULL;
+			if (sqRing != NULL) {
+				munmap(sqRing, sqRingSize);
+				sqRing = NULL;
+			}
+			if (eventFd != -1) {
+				close(eventFd);
+				eventFd = -1;
+			}
+			if (ringFd != -1) {
+				close(ringFd);
+				ringFd = -1;
+			}
+		}
+
+		bool setupRings(const struct io_uring_params &params) {
+			sqEntries = params.sq_entries;
+			cqEntries = params.cq_entries;
+			sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+			cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+			}
+
+			sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+			if (sqRing == MAP_FAILED) {
+				sqRing = NULL;
+				return false;
+			}
+			if (params.features & IORING_FEAT_SINGLE_MMAP) {
+				cqRing = sqRing;
+			} else {
+				cqRing = mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE,
+					MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+				if (cqRing == MAP_FAILED) {
+					cqRing = NULL;
+					return false;
+				}
+			}
+			sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+			sqes = (struct io_uring_sqe *) mmap(NULL, sqesSize,
+				PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				ringFd, IORING_OFF_SQES);
+			if (sqes == MAP_FAILED) {
+				sqes = NULL;
+				return false;
+			}
+
+			char *sq = (char *) sqRing;
+			char *cq = (char *) cqRing;
+			sqHead  = (unsigned int *) (sq + params.sq_off.head);
+			sqTail  = (unsigned int *) (sq + params.sq_off.tail);
+			sqMask  = *(unsigned int *) (sq + params.sq_off.ring_mask);
+			sqArray = (unsigned int *) (sq + params.sq_off.array);
+			cqHead  = (unsigned int *) (cq + params.cq_off.head);
+			cqTail  = (unsigned int *) (cq + params.cq_off.tail);
+			cqMask  = *(unsigned int *) (cq + params.cq_off.ring_mask);
+			cqes    = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+			return true;
+		}
+
+		bool enqueue(unsigned char opcode, int fd, void *buf, unsigned int size,
+			boost::uint64_t offset, uv_fs_t *req, uv_fs_cb cb)
+		{
+			if (!initialized || inflight + queued >= cqEntries) {
+				return false;
+			}
+
+			unsigned int tail = *sqTail;
+			unsigned int head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+			if (tail - head >= sqEntries) {
+				return false;
+			}
+
+			unsigned int index = tail & sqMask;
+			struct io_uring_sqe *sqe = &sqes[index];
+			memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = opcode;
+			sqe->fd = fd;
+			sqe->addr = (boost::uint64_t) (uintptr_t) buf;
+			sqe->len = size;
+			sqe->off = offset;
+			sqe->user_data = (boost::uint64_t) (uintptr_t) req;
+			sqArray[index] = index;
+			__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+			req->cb = cb;
+			req->result = 0;
+			if (queued == 0) {
+				ev_prepare_start(loop, &prepareWatcher);
+			}
+			queued++;
+			return true;
+		}
+
+		void processCompletions() {
+			unsigned int head = *cqHead;
+			unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+			while (head != tail) {
+				struct io_uring_cqe *cqe = &cqes[head & cqMask];
+				uv_fs_t *req = (uv_fs_t *) (uintptr_t) cqe->user_data;
+				req->result = cqe->res;
+				head++;
+				// Release the CQE before running the callback, which may
+				// start new requests.
+				__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+				inflight--;
+				totalCompleted++;
+				req->cb(req);
+				tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+			}
+		}
+
+		static void onPrepare(struct ev_loop *loop, struct ev_prepare *w, int revents) {
+			FileIoRing *self = static_cast<FileIoRing *>(w->data);
+			self->submit();
+		}
+
+		static void onEventFdReadable(struct ev_loop *loop, struct ev_io *w, int revents) {
+			FileIoRing *self = static_cast<FileIoRing *>(w->data);
+			eventfd_t value;
+			eventfd_read(self->eventFd, &value);
+			self->processCompletions();
+		}
+	#endif
+
+public:
+	FileIoRing(struct ev_loop *_loop, unsigned int _entries = DEFAULT_ENTRIES)
+		: loop(_loop),
+		  entries(_entries),
+		  inflight(0),
+		  queued(0),
+		  totalSubmitted(0),
+		  totalSubmitCalls(0),
+		  totalCompleted(0),
+		  initialized(false)
+		#ifdef HAS_IO_URING
+			,
+			ringFd(-1),
+			eventFd(-1),
+			sqRing(NULL),
+			cqRing(NULL),
+			sqes(NULL)
+		#endif
+		{ }
+
+	~FileIoRing() {
+		#ifdef HAS_IO_URING
+			if (initialized) {
+				ev_prepare_stop(loop, &prepareWatcher);
+				ev_io_stop(loop, &eventFdWatcher);
+				// The kernel may still be writing into buffers owned by the
+				// requests' callers, so wait for all of them to complete.
+				submit();
+				while (inflight > 0) {
+					int ret = sysEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+					if (ret < 0 && errno != EINTR) {
+						break;
+					}
+					processCompletions();
+				}
+				releaseResources();
+			}
+		#endif
+	}
+
+	/**
+	 * Sets up the ring. Returns false if io_uring is not supported by this
+	 * build or by the running kernel; `getInitializationError()` then
+	 * describes why.
+	 */
+	bool initialize() {
+		#ifdef HAS_IO_URING
+			struct io_uring_params params;
+
+			memset(&params, 0, sizeof(params));
+			ringFd = sysSetup(entries, &params);
+			if (ringFd == -1) {
+				return fail("io_uring_setup() failed", errno);
+			}
+			if (!setupRings(params)) {
+				return fail("Cannot map the io_uring rings", errno);
+			}
+			if (!opcodesSupported()) {
+				return fail("The kernel does not support io_uring reads and writes",
+					EOPNOTSUPP);
+			}
+
+			eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (eventFd == -1) {
+				return fail("eventfd() failed", errno);
+			}
+			if (sysRegister(ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) != 0) {
+				return fail("Cannot register an eventfd with io_uring", errno);
+			}
+
+			ev_io_init(&eventFdWatcher, onEventFdReadable, eventFd, EV_READ);
+			eventFdWatcher.data = this;
+			ev_io_start(loop, &eventFdWatcher);
+			ev_prepare_init(&prepareWatcher, onPrepare);
+			prepareWatcher.data = this;
+			initialized = true;
+			return true;
+		#else
+			initializationError = "io_uring support was not compiled in";
+			return false;
+		#endif
+	}
+
+	bool isInitialized() const {
+		return initialized;
+	}
+
+	const string &getInitializationError() const {
+		return initializationError;
+	}
+
+	/**
+	 * Queues a read of `size` bytes at `offset`. Returns false if the
+	 * request could not be queued, in which case the caller should fall
+	 * back to libuv.
+	 */
+	bool read(int fd, char *buf, unsigned int size, boost::uint64_t offset,
+		uv_fs_t *req, uv_fs_cb cb)
+	{
+		#ifdef HAS_IO_URING
+			return enqueue(IORING_OP_READ, fd, buf, size, offset, req, cb);
+		#else
+			return false;
+		#endif
+	}
+
+	/**
+	 * Queues a write of `size` bytes at `offset`. Returns false if the
+	 * request could not be queued, in which case the caller should fall
+	 * back to libuv.
+	 */
+	bool write(int fd, const char *buf, unsigned int size, boost::uint64_t offset,
+		uv_fs_t *req, uv_fs_cb cb)
+	{
+		#ifdef HAS_IO_URING
+			return enqueue(IORING_OP_WRITE, fd, const_cast<char *>(buf), size,
+				offset, req, cb);
+		#else
+			return false;
+		#endif
+	}
+
+	/**
+	 * Submits all queued requests to the kernel. Called automatically
+	 * before the event loop blocks.
+	 */
+	void submit() {
+		#ifdef HAS_IO_URING
+			if (queued == 0) {
+				return;
+			}
+			ev_prepare_stop(loop, &prepareWatcher);
+
+			unsigned int toSubmit = queued;
+			while (toSubmit > 0) {
+				int ret = sysEnter(ringFd, toSubmit, 0, 0);
+				if (ret < 0) {
+					if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+						// Try again during the next loop iteration.
+						ev_prepare_start(loop, &prepareWatcher);
+						break;
+					}
+					// Submission failures that aren't transient indicate a
+					// programming error, so there's no way to recover.
+					P_BUG("io_uring_enter() failed: errno=" << errno);
+				} else if (ret == 0) {
+					ev_prepare_start(loop, &prepareWatcher);
+					break;
+				}
+				totalSubmitCalls++;
+				totalSubmitted += ret;
+				inflight += ret;
+				queued -= ret;
+				toSubmit -= ret;
+			}
+		#endif
+	}
+
+	unsigned int getInflight() const {
+		return inflight + queued;
+	}
+
+	boost::uint64_t getTotalSubmitCalls() const {
+		return totalSubmitCalls;
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		doc["initialized"] = initialized;
+		if (!initialized) {
+			doc["initialization_error"] = initializationError;
+			return doc;
+		}
+		doc["queued"] = queued;
+		doc["inflight"] = inflight;
+		doc["total_submitted"] = (Json::UInt64) totalSubmitted;
+		doc["total_submit_calls"] = (Json::UInt64) totalSubmitCalls;
+		doc["total_completed"] = (Json::UInt64) totalCompleted;
+		return doc;
+	}
+};
+
+
+} // namespace ServerKit
+} // namespace Passenger
+
+#endif /* _PASSENGER_SERVER_KIT_FILE_IO_RING_H_ */
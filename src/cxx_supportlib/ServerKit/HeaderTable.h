@@ -33,6 +33,8 @@
 #include <DataStructures/LString.h>
 #include <DataStructures/HashedStaticString.h>
 #include <StaticString.h>
+#include <Utils/Hasher.h>
+#include <ServerKit/WellKnownHeaders.h>
 
 namespace Passenger {
 namespace ServerKit {
@@ -64,6 +66,10 @@ struct Header {
  * The hash table uses open addressing and linear probing for cache friendliness. It
  * supports keys that are non-contigunous in memory, through the use of LString.
  *
+ * Upon insertion, headers are classified as well-known (see WellKnownHeaders.h).
+ * The table keeps a direct pointer to each well-known header, so that looking
+ * one up by WellKnownHeaderId does not need to probe the hash table.
+ *
  * It supports at most 2^16-1 keys.
  *
  * The hash table automatically doubles in size when it becomes 75% full.
@@ -90,6 +96,7 @@ private:
 	Cell *m_cells;
 	boost::uint16_t m_arraySize;
 	boost::uint16_t m_population;
+	Header *m_wellKnown[WKH_COUNT];
 
 	bool shouldRepopulateOnInsert() const {
 		return (m_population + 1) * 4 >= m_arraySize * 3;
@@ -166,6 +173,15 @@ private:
 		m_population = other.m_population;
 		m_cells      = new Cell[other.m_arraySize];
 		memcpy(m_cells, other.m_cells, other.m_arraySize * sizeof(Cell));
+		memcpy(m_wellKnown, other.m_wellKnown, sizeof(m_wellKnown));
+	}
+
+	OXT_FORCE_INLINE
+	void untagWellKnownHeader(const Header *header) {
+		WellKnownHeaderId id = WELL_KNOWN_HEADERS.lookup(&header->key, header->hash);
+		if (id != WKH_UNKNOWN) {
+			m_wellKnown[id] = NULL;
+		}
 	}
 
 public:
@@ -199,6 +215,7 @@ public:
 			memset(m_cells, 0, sizeof(Cell) * m_arraySize);
 		}
 		m_population = 0;
+		memset(m_wellKnown, 0, sizeof(m_wellKnown));
 	}
 
 	const Cell *lookupCell(const HashedStaticString &key) const {
@@ -253,6 +270,26 @@ public:
 		return const_cast<LString *>(static_cast<const HeaderTable *>(this)->lookup(key));
 	}
 
+	OXT_FORCE_INLINE
+	Header *lookupHeader(WellKnownHeaderId id) {
+		return m_wellKnown[id];
+	}
+
+	OXT_FORCE_INLINE
+	const LString *lookup(WellKnownHeaderId id) const {
+		const Header *header = m_wellKnown[id];
+		if (header != NULL) {
+			return &header->val;
+		} else {
+			return NULL;
+		}
+	}
+
+	OXT_FORCE_INLINE
+	LString *lookup(WellKnownHeaderId id) {
+		return const_cast<LString *>(static_cast<const HeaderTable *>(this)->lookup(id));
+	}
+
 	/**
 	 * HeaderTable takes over ownership of `header`. But you must ensure that the pool
 	 * that the header was allocated from is not destroyed before the HeaderTable
@@ -280,6 +317,12 @@ public:
 
 					cell->header = header;
 					*headerPtr = NULL;
+
+					WellKnownHeaderId id = WELL_KNOWN_HEADERS.lookup(
+						&header->key, header->hash);
+					if (id != WKH_UNKNOWN) {
+						m_wellKnown[id] = header;
+					}
 					return;
 				} else if (psg_lstr_cmp(&cell->header->key, &header->key)) {
 					// Cell matches, so merge value into header.
@@ -308,11 +351,16 @@ public:
 	{
 		Header *header = (Header *) psg_palloc(pool, sizeof(Header));
 
-		char *downcasedName = (char *) psg_pnalloc(pool, name.size());
-		convertLowerCase((const unsigned char *) name.data(),
-			(unsigned char *) downcasedName, name.size());
+		Hasher hasher;
 		psg_lstr_init(&header->key);
-		psg_lstr_append(&header->key, pool, downcasedName, name.size());
+		if (hasher.updateLowerCase(name.data(), name.size())) {
+			char *downcasedName = (char *) psg_pnalloc(pool, name.size());
+			convertLowerCase((const unsigned char *) name.data(),
+				(unsigned char *) downcasedName, name.size());
+			psg_lstr_append(&header->key, pool, downcasedName, name.size());
+		} else {
+			psg_lstr_append(&header->key, pool, name.data(), name.size());
+		}
 
 		psg_lstr_init(&header->origKey);
 		psg_lstr_append(&header->origKey, pool, name.data(), name.size());
@@ -320,7 +368,7 @@ public:
 		psg_lstr_init(&header->val);
 		psg_lstr_append(&header->val, pool, value.data(), value.size());
 
-		header->hash = HashedStaticString(downcasedName, name.size()).hash();
+		header->hash = hasher.finalize();
 		insert(&header, pool);
 		return header;
 	}
@@ -329,6 +377,8 @@ public:
 		assert(cell >= m_cells && cell - m_cells < m_arraySize);
 		assert(!cellIsEmpty(cell));
 
+		untagWellKnownHeader(cell->header);
+
 		// Remove this cell by shuffling neighboring cells so there are no gaps in anyone's probe chain
 		Cell *neighbor = PHT_CIRCULAR_NEXT(cell);
 		while (true) {
@@ -376,6 +426,7 @@ public:
 	void clear() {
 		if (m_cells != NULL && m_population != 0) {
 			memset(m_cells, 0, sizeof(Cell) * m_arraySize);
+			memset(m_wellKnown, 0, sizeof(m_wellKnown));
 		}
 		m_population = 0;
 	}
@@ -385,6 +436,7 @@ public:
 		m_cells = NULL;
 		m_arraySize  = 0;
 		m_population = 0;
+		memset(m_wellKnown, 0, sizeof(m_wellKnown));
 	}
 
 	void compact() {
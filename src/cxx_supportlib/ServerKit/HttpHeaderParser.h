@@ -47,8 +47,6 @@ namespace ServerKit {
 
 extern const HashedStaticString HTTP_CONTENT_LENGTH;
 extern const HashedStaticString HTTP_TRANSFER_ENCODING;
-extern const HashedStaticString HTTP_X_SENDFILE;
-extern const HashedStaticString HTTP_X_ACCEL_REDIRECT;
 
 struct HttpParseRequest {};
 struct HttpParseResponse {};
@@ -205,13 +203,16 @@ private:
 			psg_lstr_append(&self->state->currentHeader->key, self->pool,
 				*self->currentBuffer, data, len);
 			self->state->hasher.update(data, len);
-		} else {
+		} else if (self->state->hasher.updateLowerCase(data, len)) {
 			char *downcasedData = (char *) psg_pnalloc(self->pool, len);
 			convertLowerCase((const unsigned char *) data,
 				(unsigned char *) downcasedData, len);
 			psg_lstr_append(&self->state->currentHeader->key, self->pool,
 				downcasedData, len);
-			self->state->hasher.update(downcasedData, len);
+		} else {
+			// Already lowercase, so the key can share the buffer with origKey.
+			psg_lstr_append(&self->state->currentHeader->key, self->pool,
+				*self->currentBuffer, data, len);
 		}
 
 		return 0;
@@ -235,7 +236,6 @@ private:
 
 		psg_lstr_append(&self->state->currentHeader->val, self->pool,
 			*self->currentBuffer, data, len);
-		self->state->hasher.update(data, len);
 
 		return 0;
 	}
@@ -371,8 +371,8 @@ private:
 			message->httpState = Message::UPGRADED;
 			message->bodyType  = Message::RBT_UPGRADE;
 			message->wantKeepAlive = false;
-		} else if (message->headers.lookup(HTTP_X_SENDFILE) != NULL
-		 || message->headers.lookup(HTTP_X_ACCEL_REDIRECT) != NULL)
+		} else if (message->headers.lookup(WKH_X_SENDFILE) != NULL
+		 || message->headers.lookup(WKH_X_ACCEL_REDIRECT) != NULL)
 		{
 			// If X-Sendfile or X-Accel-Redirect is set, pretend like the body
 			// is empty and disallow keep-alive. See:
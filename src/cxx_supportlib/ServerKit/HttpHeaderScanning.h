@@ -0,0 +1,271 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_SERVER_KIT_HTTP_HEADER_SCANNING_H_
+#define _PASSENGER_SERVER_KIT_HTTP_HEADER_SCANNING_H_
+
+/*
+ * Routines that let http_parser skip over the bulk of header names and
+ * header values in one go, instead of running its state machine for
+ * every byte. On x86 they use SSE4.2 or AVX2, selected at runtime
+ * depending on what the CPU supports, with a scalar fallback.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+	&& (defined(__clang__) \
+		|| (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+	#define PSG_HTTP_HEADER_SCANNING_SIMD
+	#include <immintrin.h>
+#endif
+
+namespace Passenger {
+namespace ServerKit {
+
+
+enum HttpHeaderScanningLevel {
+	HHSL_SCALAR,
+	HHSL_SSE42,
+	HHSL_AVX2
+};
+
+/**
+ * Whether each byte is a valid header name character, i.e. a `token`
+ * character as defined by RFC 7230. Must agree with `tokens` in
+ * http_parser.cpp (in strict mode).
+ */
+static const unsigned char httpHeaderTokenChars[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+	0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, // 0x20
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, // 0x30
+	0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 1, // 0x50
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 0, // 0x70
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xa0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xb0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xc0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xd0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xe0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  // 0xf0
+};
+
+
+inline const char *
+scanHttpHeaderTokenScalar(const char *p, const char *end) {
+	while (p < end && httpHeaderTokenChars[(unsigned char) *p]) {
+		p++;
+	}
+	return p;
+}
+
+inline const char *
+scanHttpHeaderValueScalar(const char *p, const char *end) {
+	while (p < end && *p != '\r' && *p != '\n') {
+		p++;
+	}
+	return p;
+}
+
+#ifdef PSG_HTTP_HEADER_SCANNING_SIMD
+	__attribute__((target("sse4.2")))
+	inline const char *
+	scanHttpHeaderTokenSse42(const char *p, const char *end) {
+		// All token characters except '~', as byte ranges. PCMPESTRI
+		// supports at most 8 ranges, so '~' is handled separately.
+		static const char rangesData[16] = {
+			'!', '!', '#', '\'', '*', '+', '-', '.',
+			'0', '9', 'A', 'Z', '^', 'z', '|', '|'
+		};
+		const __m128i ranges = _mm_loadu_si128((const __m128i *) rangesData);
+
+		while (end - p >= 16) {
+			__m128i block = _mm_loadu_si128((const __m128i *) p);
+			int index = _mm_cmpestri(ranges, 16, block, 16,
+				_SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY
+				| _SIDD_LEAST_SIGNIFICANT);
+			if (index == 16) {
+				p += 16;
+			} else if (p[index] == '~') {
+				p += index + 1;
+			} else {
+				return p + index;
+			}
+		}
+		return scanHttpHeaderTokenScalar(p, end);
+	}
+
+	__attribute__((target("sse4.2")))
+	inline const char *
+	scanHttpHeaderValueSse42(const char *p, const char *end) {
+		const __m128i crlf = _mm_setr_epi8('\r', '\n', 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0);
+
+		while (end - p >= 16) {
+			__m128i block = _mm_loadu_si128((const __m128i *) p);
+			int index = _mm_cmpestri(crlf, 2, block, 16,
+				_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+			if (index != 16) {
+				return p + index;
+			}
+			p += 16;
+		}
+		return scanHttpHeaderValueScalar(p, end);
+	}
+
+	__attribute__((target("avx2")))
+	inline const char *
+	scanHttpHeaderTokenAvx2(const char *p, const char *end) {
+		// A byte is a token character if bit (byte >> 4) is set in
+		// lowNibbleMasks[byte & 0xf]. Derived from httpHeaderTokenChars.
+		const __m256i lowNibbleMasks = _mm256_setr_epi8(
+			(char) 0xe8, (char) 0xfc, (char) 0xf8, (char) 0xfc,
+			(char) 0xfc, (char) 0xfc, (char) 0xfc, (char) 0xfc,
+			(char) 0xf8, (char) 0xf8, (char) 0xf4, (char) 0x54,
+			(char) 0xd0, (char) 0x54, (char) 0xf4, (char) 0x70,
+			(char) 0xe8, (char) 0xfc, (char) 0xf8, (char) 0xfc,
+			(char) 0xfc, (char) 0xfc, (char) 0xfc, (char) 0xfc,
+			(char) 0xf8, (char) 0xf8, (char) 0xf4, (char) 0x54,
+			(char) 0xd0, (char) 0x54, (char) 0xf4, (char) 0x70);
+		const __m256i highNibbleBits = _mm256_setr_epi8(
+			1, 2, 4, 8, 16, 32, 64, (char) 128,
+			0, 0, 0, 0, 0, 0, 0, 0,
+			1, 2, 4, 8, 16, 32, 64, (char) 128,
+			0, 0, 0, 0, 0, 0, 0, 0);
+		const __m256i nibbleMask = _mm256_set1_epi8(0x0f);
+		const __m256i zero = _mm256_setzero_si256();
+
+		while (end - p >= 32) {
+			__m256i block = _mm256_loadu_si256((const __m256i *) p);
+			__m256i low = _mm256_and_si256(block, nibbleMask);
+			__m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibbleMask);
+			__m256i bits = _mm256_and_si256(
+				_mm256_shuffle_epi8(lowNibbleMasks, low),
+				_mm256_shuffle_epi8(highNibbleBits, high));
+			unsigned int nonTokens = (unsigned int) _mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(bits, zero));
+			if (nonTokens != 0) {
+				return p + __builtin_ctz(nonTokens);
+			}
+			p += 32;
+		}
+		return scanHttpHeaderTokenScalar(p, end);
+	}
+
+	__attribute__((target("avx2")))
+	inline const char *
+	scanHttpHeaderValueAvx2(const char *p, const char *end) {
+		const __m256i cr = _mm256_set1_epi8('\r');
+		const __m256i lf = _mm256_set1_epi8('\n');
+
+		while (end - p >= 32) {
+			__m256i block = _mm256_loadu_si256((const __m256i *) p);
+			unsigned int matches = (unsigned int) _mm256_movemask_epi8(
+				_mm256_or_si256(
+					_mm256_cmpeq_epi8(block, cr),
+					_mm256_cmpeq_epi8(block, lf)));
+			if (matches != 0) {
+				return p + __builtin_ctz(matches);
+			}
+			p += 32;
+		}
+		return scanHttpHeaderValueSse42(p, end);
+	}
+
+	inline HttpHeaderScanningLevel
+	detectHttpHeaderScanningLevel() {
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2")) {
+			return HHSL_AVX2;
+		} else if (__builtin_cpu_supports("sse4.2")) {
+			return HHSL_SSE42;
+		} else {
+			return HHSL_SCALAR;
+		}
+	}
+#else
+	inline HttpHeaderScanningLevel
+	detectHttpHeaderScanningLevel() {
+		return HHSL_SCALAR;
+	}
+#endif
+
+/**
+ * The implementation that the scanning functions use. Defaults to the
+ * best one that the CPU supports. May be lowered (but not raised above
+ * what `detectHttpHeaderScanningLevel()` returns) for testing and
+ * benchmarking purposes.
+ */
+inline HttpHeaderScanningLevel &
+httpHeaderScanningLevel() {
+	static HttpHeaderScanningLevel level = detectHttpHeaderScanningLevel();
+	return level;
+}
+
+/**
+ * Returns a pointer to the first byte in [p, end) that is not a valid
+ * header name character, or `end` if there is none.
+ */
+inline const char *
+scanHttpHeaderToken(const char *p, const char *end) {
+	#ifdef PSG_HTTP_HEADER_SCANNING_SIMD
+		switch (httpHeaderScanningLevel()) {
+		case HHSL_AVX2:
+			return scanHttpHeaderTokenAvx2(p, end);
+		case HHSL_SSE42:
+			return scanHttpHeaderTokenSse42(p, end);
+		default:
+			break;
+		}
+	#endif
+	return scanHttpHeaderTokenScalar(p, end);
+}
+
+/**
+ * Returns a pointer to the first CR or LF in [p, end), or `end` if
+ * there is none.
+ */
+inline const char *
+scanHttpHeaderValue(const char *p, const char *end) {
+	#ifdef PSG_HTTP_HEADER_SCANNING_SIMD
+		switch (httpHeaderScanningLevel()) {
+		case HHSL_AVX2:
+			return scanHttpHeaderValueAvx2(p, end);
+		case HHSL_SSE42:
+			return scanHttpHeaderValueSse42(p, end);
+		default:
+			break;
+		}
+	#endif
+	return scanHttpHeaderValueScalar(p, end);
+}
+
+
+} // namespace ServerKit
+} // namespace Passenger
+
+#endif /* _PASSENGER_SERVER_KIT_HTTP_HEADER_SCANNING_H_ */
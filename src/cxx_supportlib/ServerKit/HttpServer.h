@@ -1080,7 +1080,7 @@ public:
 			"Status: %s\r\n",
 			(int) req->httpMajor, (int) req->httpMinor, status, status);
 
-		value = (headers != NULL) ? headers->lookup(P_STATIC_STRING("content-type")) : NULL;
+		value = (headers != NULL) ? headers->lookup(WKH_CONTENT_TYPE) : NULL;
 		if (value == NULL) {
 			pos = appendData(pos, end, P_STATIC_STRING("Content-Type: text/html; charset=UTF-8\r\n"));
 		} else {
@@ -1089,7 +1089,7 @@ public:
 			pos = appendData(pos, end, P_STATIC_STRING("\r\n"));
 		}
 
-		value = (headers != NULL) ? headers->lookup(P_STATIC_STRING("date")) : NULL;
+		value = (headers != NULL) ? headers->lookup(WKH_DATE) : NULL;
 		pos = appendData(pos, end, P_STATIC_STRING("Date: "));
 		if (value == NULL) {
 			time_t the_time = time(NULL);
@@ -1101,7 +1101,7 @@ public:
 		}
 		pos = appendData(pos, end, P_STATIC_STRING("\r\n"));
 
-		value = (headers != NULL) ? headers->lookup(P_STATIC_STRING("connection")) : NULL;
+		value = (headers != NULL) ? headers->lookup(WKH_CONNECTION) : NULL;
 		if (value == NULL) {
 			if (canKeepAlive(req)) {
 				pos = appendData(pos, end, P_STATIC_STRING("Connection: keep-alive\r\n"));
@@ -1119,7 +1119,7 @@ public:
 			}
 		}
 
-		value = (headers != NULL) ? headers->lookup(P_STATIC_STRING("content-length")) : NULL;
+		value = (headers != NULL) ? headers->lookup(WKH_CONTENT_LENGTH) : NULL;
 		pos = appendData(pos, end, P_STATIC_STRING("Content-Length: "));
 		if (value == NULL) {
 			pos += snprintf(pos, end - pos, "%u", (unsigned int) body.size());
@@ -1281,7 +1281,7 @@ public:
 			}
 			doc["path"] = str;
 
-			const LString *host = req->headers.lookup("host");
+			const LString *host = req->headers.lookup(WKH_HOST);
 			if (host != NULL) {
 				str.clear();
 				str.reserve(host->size);
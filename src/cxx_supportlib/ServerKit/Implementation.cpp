@@ -24,6 +24,7 @@
  *  THE SOFTWARE.
  */
 #include <DataStructures/HashedStaticString.h>
+#include <ServerKit/WellKnownHeaders.h>
 
 namespace Passenger {
 namespace ServerKit {
@@ -34,10 +35,9 @@ extern const HashedStaticString HTTP_COOKIE;
 extern const HashedStaticString HTTP_SET_COOKIE;
 extern const HashedStaticString HTTP_CONTENT_LENGTH;
 extern const HashedStaticString HTTP_TRANSFER_ENCODING;
-extern const HashedStaticString HTTP_X_SENDFILE;
-extern const HashedStaticString HTTP_X_ACCEL_REDIRECT;
 extern const char DEFAULT_INTERNAL_SERVER_ERROR_RESPONSE[];
 extern const unsigned int DEFAULT_INTERNAL_SERVER_ERROR_RESPONSE_SIZE;
+extern const WellKnownHeaderTable WELL_KNOWN_HEADERS;
 
 const char DEFAULT_INTERNAL_SERVER_ERROR_RESPONSE[] =
 	"Status: 500 Internal Server Error\r\n"
@@ -52,8 +52,7 @@ const HashedStaticString HTTP_COOKIE("cookie");
 const HashedStaticString HTTP_SET_COOKIE("set-cookie");
 const HashedStaticString HTTP_CONTENT_LENGTH("content-length");
 const HashedStaticString HTTP_TRANSFER_ENCODING("transfer-encoding");
-const HashedStaticString HTTP_X_SENDFILE("x-sendfile");
-const HashedStaticString HTTP_X_ACCEL_REDIRECT("x-accel-redirect");
+const WellKnownHeaderTable WELL_KNOWN_HEADERS;
 
 
 } // namespace ServerKit
@@ -52,6 +52,8 @@
 #include <SafeLibev.h>
 #include <Constants.h>
 #include <ServerKit/Context.h>
+#include <ServerKit/FileIoRing.h>
+#include <ServerKit/BufferFilePool.h>
 #include <ServerKit/Errors.h>
 #include <ServerKit/Hooks.h>
 #include <ServerKit/Client.h>
@@ -63,6 +65,7 @@
 #include <Utils/StrIntUtils.h>
 #include <Utils/IOUtils.h>
 #include <Utils/SystemTime.h>
+#include <Utils/LatencyHistogram.h>
 
 namespace Passenger {
 namespace ServerKit {
@@ -242,6 +245,14 @@ public:
 	unsigned int freeClientCount, activeClientCount, disconnectedClientCount;
 	unsigned int peakActiveClientCount;
 	unsigned long totalClientsAccepted, lastTotalClientsAccepted;
+	/** Subset of `totalClientsAccepted` that was accepted by an
+	 * AcceptLoadBalancer and handed over to this server's thread.
+	 */
+	unsigned long totalClientsHandedOver;
+	/** Time between an AcceptLoadBalancer accepting a client and
+	 * this server's thread receiving it.
+	 */
+	LatencyHistogram clientHandoverTimes;
 	unsigned long long totalBytesConsumed;
 	ev_tstamp lastStatisticsUpdateTime;
 	double clientAcceptSpeed1m, clientAcceptSpeed1h;
@@ -683,6 +694,7 @@ public:
 		  peakActiveClientCount(0),
 		  totalClientsAccepted(0),
 		  lastTotalClientsAccepted(0),
+		  totalClientsHandedOver(0),
 		  totalBytesConsumed(0),
 		  lastStatisticsUpdateTime(ev_time()),
 		  clientAcceptSpeed1m(-1),
@@ -1084,6 +1096,13 @@ public:
 		Json::Value doc = ctx->inspectStateAsJson();
 		const Client *client;
 
+		if (ctx->fileIoRing != NULL) {
+			doc["file_io_ring"] = ctx->fileIoRing->inspectStateAsJson();
+		}
+		if (ctx->bufferFilePool != NULL) {
+			doc["buffer_file_pool"] = ctx->bufferFilePool->inspectStateAsJson();
+		}
+
 		doc["pid"] = (unsigned int) getpid();
 		doc["server_state"] = getServerStateString();
 		doc["free_client_count"] = freeClientCount;
@@ -1099,6 +1118,12 @@ public:
 			capFloatPrecision(clientAcceptSpeed1h * 60),
 			"minute", "1 hour", -1);
 		doc["total_clients_accepted"] = (Json::UInt64) totalClientsAccepted;
+		doc["total_clients_accepted_directly"] = (Json::UInt64)
+			(totalClientsAccepted - totalClientsHandedOver);
+		doc["total_clients_handed_over"] = (Json::UInt64) totalClientsHandedOver;
+		if (totalClientsHandedOver > 0) {
+			doc["client_handover_time"] = clientHandoverTimes.inspectStateAsJson();
+		}
 		doc["total_bytes_consumed"] = (Json::UInt64) totalBytesConsumed;
 
 		TAILQ_FOREACH (client, &activeClients, nextClient.activeOrDisconnectedClient) {
@@ -0,0 +1,184 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_SERVER_KIT_WELL_KNOWN_HEADERS_H_
+#define _PASSENGER_SERVER_KIT_WELL_KNOWN_HEADERS_H_
+
+#include <boost/cstdint.hpp>
+#include <oxt/macros.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <DataStructures/LString.h>
+#include <DataStructures/HashedStaticString.h>
+
+namespace Passenger {
+namespace ServerKit {
+
+
+/**
+ * HTTP headers that ServerKit, the Core controller and the turbocache look up
+ * while processing every request. HeaderTable keeps a direct pointer to each
+ * of these, so that looking one up by ID is an array access.
+ */
+enum WellKnownHeaderId {
+	WKH_HOST,
+	WKH_CONNECTION,
+	WKH_CONTENT_LENGTH,
+	WKH_CONTENT_TYPE,
+	WKH_TRANSFER_ENCODING,
+	WKH_EXPECT,
+	WKH_COOKIE,
+	WKH_SET_COOKIE,
+	WKH_DATE,
+	WKH_STATUS,
+	WKH_CACHE_CONTROL,
+	WKH_PRAGMA,
+	WKH_EXPIRES,
+	WKH_LAST_MODIFIED,
+	WKH_VARY,
+	WKH_AUTHORIZATION,
+	WKH_WWW_AUTHENTICATE,
+	WKH_X_SENDFILE,
+	WKH_X_ACCEL_REDIRECT,
+
+	WKH_COUNT,
+	/** Not a well-known header. */
+	WKH_UNKNOWN = WKH_COUNT
+};
+
+
+/**
+ * Classifies header names as WellKnownHeaderIds with a perfect hash over their
+ * HashedStaticString hashes. Because the parser has already hashed every
+ * header name, classifying a header costs a multiplication, a table load and,
+ * for candidate matches only, a name comparison.
+ *
+ * The multiplier that makes the hash perfect is searched for when the table
+ * is constructed, since it depends on the hash function in Utils/Hasher.h.
+ * This takes a few microseconds. Use the global `WELL_KNOWN_HEADERS` instance.
+ */
+class WellKnownHeaderTable {
+public:
+	static const unsigned int SLOT_BITS = 6;
+	static const unsigned int SLOTS = 1 << SLOT_BITS;
+
+private:
+	boost::uint32_t multiplier;
+	boost::uint8_t slots[SLOTS];
+	HashedStaticString names[WKH_COUNT];
+
+	OXT_FORCE_INLINE
+	unsigned int slotFor(boost::uint32_t hash) const {
+		return (boost::uint32_t) (hash * multiplier) >> (32 - SLOT_BITS);
+	}
+
+	bool tryMultiplier(boost::uint32_t m) {
+		multiplier = m;
+		memset(slots, WKH_UNKNOWN, sizeof(slots));
+		for (unsigned int i = 0; i < WKH_COUNT; i++) {
+			unsigned int slot = slotFor(names[i].hash());
+			if (slots[slot] != WKH_UNKNOWN) {
+				return false;
+			}
+			slots[slot] = i;
+		}
+		return true;
+	}
+
+public:
+	WellKnownHeaderTable() {
+		// Names are downcased, like HeaderTable keys.
+		names[WKH_HOST] = "host";
+		names[WKH_CONNECTION] = "connection";
+		names[WKH_CONTENT_LENGTH] = "content-length";
+		names[WKH_CONTENT_TYPE] = "content-type";
+		names[WKH_TRANSFER_ENCODING] = "transfer-encoding";
+		names[WKH_EXPECT] = "expect";
+		names[WKH_COOKIE] = "cookie";
+		names[WKH_SET_COOKIE] = "set-cookie";
+		names[WKH_DATE] = "date";
+		names[WKH_STATUS] = "status";
+		names[WKH_CACHE_CONTROL] = "cache-control";
+		names[WKH_PRAGMA] = "pragma";
+		names[WKH_EXPIRES] = "expires";
+		names[WKH_LAST_MODIFIED] = "last-modified";
+		names[WKH_VARY] = "vary";
+		names[WKH_AUTHORIZATION] = "authorization";
+		names[WKH_WWW_AUTHENTICATE] = "www-authenticate";
+		names[WKH_X_SENDFILE] = "x-sendfile";
+		names[WKH_X_ACCEL_REDIRECT] = "x-accel-redirect";
+
+		// Odd multipliers, starting from the golden ratio. With this many
+		// names in this many slots, about one in fifteen is collision-free.
+		boost::uint32_t m = 0x9E3779B1u;
+		unsigned int tries = 0;
+		while (!tryMultiplier(m)) {
+			m += 2;
+			tries++;
+			if (tries == 1000000) {
+				// Cannot happen with a sane hash function.
+				abort();
+			}
+		}
+	}
+
+	const HashedStaticString &getName(WellKnownHeaderId id) const {
+		return names[id];
+	}
+
+	boost::uint32_t getMultiplier() const {
+		return multiplier;
+	}
+
+	WellKnownHeaderId lookup(const HashedStaticString &name) const {
+		unsigned int id = slots[slotFor(name.hash())];
+		if (id != WKH_UNKNOWN && names[id].hash() == name.hash() && names[id] == name) {
+			return (WellKnownHeaderId) id;
+		} else {
+			return WKH_UNKNOWN;
+		}
+	}
+
+	/**
+	 * `hash` must be the HashedStaticString hash of `name`.
+	 */
+	OXT_FORCE_INLINE
+	WellKnownHeaderId lookup(const LString *name, boost::uint32_t hash) const {
+		unsigned int id = slots[slotFor(hash)];
+		if (id != WKH_UNKNOWN && names[id].hash() == hash && psg_lstr_cmp(name, names[id])) {
+			return (WellKnownHeaderId) id;
+		} else {
+			return WKH_UNKNOWN;
+		}
+	}
+};
+
+extern const WellKnownHeaderTable WELL_KNOWN_HEADERS;
+
+
+} // namespace ServerKit
+} // namespace Passenger
+
+#endif /* _PASSENGER_SERVER_KIT_WELL_KNOWN_HEADERS_H_ */
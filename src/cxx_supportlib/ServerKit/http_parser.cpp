@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <ServerKit/HttpHeaderScanning.h>
 
 #ifndef ULLONG_MAX
 # define ULLONG_MAX ((boost::uint64_t) -1) /* 2^64-1 */
@@ -51,6 +52,19 @@
 # define ELEM_AT(a, i, v) ((unsigned int) (i) < ARRAY_SIZE(a) ? (a)[(i)] : (v))
 #endif
 
+/* Advance p to the last byte before the one that SCAN stops at, so that
+ * the loop continues with that byte. Stays within the header size limit so
+ * that HPE_HEADER_OVERFLOW is still raised at exactly the same byte.
+ */
+#define SCAN_AHEAD(SCAN)                                             \
+do {                                                                 \
+  const char *limit = MIN(data + len,                                \
+    p + 1 + (HTTP_MAX_HEADER_SIZE - parser->nread));                 \
+  const char *q = SCAN(p + 1, limit);                                \
+  parser->nread += q - (p + 1);                                      \
+  p = q - 1;                                                         \
+} while(0)
+
 #define SET_ERRNO(e)                                                 \
 do {                                                                 \
   parser->http_errno = (e);                                          \
@@ -1283,6 +1297,7 @@ size_t http_parser_execute (http_parser *parser,
         if (c) {
           switch (parser->header_state) {
             case h_general:
+              SCAN_AHEAD(Passenger::ServerKit::scanHttpHeaderToken);
               break;
 
             case h_C:
@@ -1492,6 +1507,7 @@ size_t http_parser_execute (http_parser *parser,
 
         switch (parser->header_state) {
           case h_general:
+            SCAN_AHEAD(Passenger::ServerKit::scanHttpHeaderValue);
             break;
 
           case h_connection:
@@ -128,6 +128,12 @@ public:
 		  len(b.len)
 		{ }
 
+	StaticString &operator=(const StaticString &b) {
+		content = b.content;
+		len = b.len;
+		return *this;
+	}
+
 	StaticString(const string &s) {
 		content = s.data();
 		len = s.size();
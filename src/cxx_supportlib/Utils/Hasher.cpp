@@ -30,6 +30,48 @@
 
 namespace Passenger {
 
+static inline boost::uint32_t
+rotl32(boost::uint32_t x, int r) {
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline boost::uint32_t
+fmix32(boost::uint32_t h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h;
+}
+
+static inline bool
+isUpperCase(char ch) {
+	return ch >= 'A' && ch <= 'Z';
+}
+
+/**
+ * Returns a mask with bit 7 set in every byte of `block` that is an ASCII
+ * uppercase letter. Works on all four bytes at once without branches.
+ */
+static inline boost::uint32_t
+upperCaseMask(boost::uint32_t block) {
+	boost::uint32_t heptets = block & 0x7f7f7f7f;
+	boost::uint32_t aboveZ = heptets + 0x25252525;   // 0x7f - 'Z'
+	boost::uint32_t atLeastA = heptets + 0x3f3f3f3f; // 0x80 - 'A'
+	return ~block & (atLeastA ^ aboveZ) & 0x80808080;
+}
+
+static inline boost::uint32_t
+loadBlock(const char *data) {
+	const unsigned char *p = (const unsigned char *) data;
+	return (boost::uint32_t) p[0]
+		| ((boost::uint32_t) p[1] << 8)
+		| ((boost::uint32_t) p[2] << 16)
+		| ((boost::uint32_t) p[3] << 24);
+}
+
+
 void
 JenkinsHash::update(const char *data, unsigned int size) {
 	const char *end = data + size;
@@ -42,6 +84,25 @@ JenkinsHash::update(const char *data, unsigned int size) {
 	}
 }
 
+bool
+JenkinsHash::updateLowerCase(const char *data, unsigned int size) {
+	const char *end = data + size;
+	bool foundUpperCase = false;
+
+	while (data < end) {
+		char ch = *data;
+		if (isUpperCase(ch)) {
+			ch |= 0x20;
+			foundUpperCase = true;
+		}
+		hash += ch;
+		hash += (hash << 10);
+		hash ^= (hash >> 6);
+		data++;
+	}
+	return foundUpperCase;
+}
+
 boost::uint32_t
 JenkinsHash::finalize() {
 	hash += (hash << 3);
@@ -50,4 +111,103 @@ JenkinsHash::finalize() {
 	return hash;
 }
 
+
+static inline boost::uint32_t
+murmurMixBlock(boost::uint32_t h, boost::uint32_t k) {
+	k *= 0xcc9e2d51;
+	k = rotl32(k, 15);
+	k *= 0x1b873593;
+	h ^= k;
+	h = rotl32(h, 13);
+	return h * 5 + 0xe6546b64;
+}
+
+/**
+ * Shared implementation of MurmurHash3::update() and updateLowerCase().
+ * `foldCase` is a compile-time constant in both callers, so the case folding
+ * code is removed from update().
+ */
+static inline bool
+murmurUpdate(MurmurHash3 &state, const char *data, unsigned int size, bool foldCase) {
+	const char *end = data + size;
+	unsigned int tailSize = state.length & 3;
+	boost::uint32_t h = state.hash;
+	boost::uint32_t tail = state.tail;
+	boost::uint32_t upperCase = 0;
+
+	state.length += size;
+
+	// Complete the partial block left over by the previous update.
+	if (tailSize != 0) {
+		while (tailSize < 4 && data < end) {
+			char ch = *data;
+			if (foldCase && isUpperCase(ch)) {
+				ch |= 0x20;
+				upperCase = 1;
+			}
+			tail |= (boost::uint32_t) (unsigned char) ch << (tailSize * 8);
+			tailSize++;
+			data++;
+		}
+		if (tailSize < 4) {
+			state.tail = tail;
+			return upperCase != 0;
+		}
+		h = murmurMixBlock(h, tail);
+		tail = 0;
+	}
+
+	while (end - data >= 4) {
+		boost::uint32_t block = loadBlock(data);
+		if (foldCase) {
+			boost::uint32_t mask = upperCaseMask(block);
+			block |= mask >> 2;
+			upperCase |= mask;
+		}
+		h = murmurMixBlock(h, block);
+		data += 4;
+	}
+
+	// Keep the remaining bytes for the next update or for finalize().
+	tailSize = 0;
+	while (data < end) {
+		char ch = *data;
+		if (foldCase && isUpperCase(ch)) {
+			ch |= 0x20;
+			upperCase = 1;
+		}
+		tail |= (boost::uint32_t) (unsigned char) ch << (tailSize * 8);
+		tailSize++;
+		data++;
+	}
+
+	state.hash = h;
+	state.tail = tail;
+	return upperCase != 0;
+}
+
+void
+MurmurHash3::update(const char *data, unsigned int size) {
+	murmurUpdate(*this, data, size, false);
+}
+
+bool
+MurmurHash3::updateLowerCase(const char *data, unsigned int size) {
+	return murmurUpdate(*this, data, size, true);
+}
+
+boost::uint32_t
+MurmurHash3::finalize() const {
+	boost::uint32_t h = hash;
+
+	if ((length & 3) != 0) {
+		boost::uint32_t k = tail;
+		k *= 0xcc9e2d51;
+		k = rotl32(k, 15);
+		k *= 0x1b873593;
+		h ^= k;
+	}
+	return fmix32(h ^ length);
+}
+
 } // namespace Passenger
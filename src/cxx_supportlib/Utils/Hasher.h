@@ -31,9 +31,24 @@
 namespace Passenger {
 
 
-// TODO: use SpookyHash on x86_64
-// TODO: use streaming murmurhash implementation: https://github.com/c9/murmur3
+/**
+ * Hashers compute 32-bit hashes of strings in a streaming fashion: the string
+ * may be fed in multiple chunks through update(), which yields the same hash
+ * as feeding it in one go. This allows HttpHeaderParser to hash header names
+ * as they arrive, even when they are split over multiple socket reads.
+ *
+ * updateLowerCase() hashes the data as if all ASCII uppercase letters in it had
+ * been converted to lowercase, so that a header name can be hashed in its
+ * case-insensitive form without downcasing it into a separate buffer first. It
+ * returns whether the data contained any uppercase letters.
+ *
+ * Hashes are only used within a single process, so the `Hasher` typedef can
+ * point to any of the implementations below.
+ */
 
+/**
+ * Bob Jenkins's one-at-a-time hash. Processes one byte at a time.
+ */
 struct JenkinsHash {
 	static const boost::uint32_t EMPTY_STRING_HASH = 0;
 
@@ -44,6 +59,7 @@ struct JenkinsHash {
 		{ }
 
 	void update(const char *data, unsigned int size);
+	bool updateLowerCase(const char *data, unsigned int size);
 	boost::uint32_t finalize();
 
 	void reset() {
@@ -51,7 +67,38 @@ struct JenkinsHash {
 	}
 };
 
-typedef JenkinsHash Hasher;
+/**
+ * A streaming implementation of MurmurHash3_x86_32 with seed 0. Processes four
+ * bytes at a time, and also folds case four bytes at a time. Bytes that do not
+ * form a full block yet are kept in `tail` until the next update() or
+ * finalize(). The result is identical to that of the reference implementation
+ * on little-endian machines.
+ */
+struct MurmurHash3 {
+	static const boost::uint32_t EMPTY_STRING_HASH = 0;
+
+	boost::uint32_t hash;
+	boost::uint32_t tail;
+	boost::uint32_t length;
+
+	MurmurHash3()
+		: hash(0),
+		  tail(0),
+		  length(0)
+		{ }
+
+	void update(const char *data, unsigned int size);
+	bool updateLowerCase(const char *data, unsigned int size);
+	boost::uint32_t finalize() const;
+
+	void reset() {
+		hash = 0;
+		tail = 0;
+		length = 0;
+	}
+};
+
+typedef MurmurHash3 Hasher;
 
 
 } // namespace Passenger
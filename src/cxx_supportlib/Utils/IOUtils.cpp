@@ -58,6 +58,11 @@
 	#include <linux/net.h>
 #endif
 
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	// Only Linux load balances connections over sockets that share a port.
+	#define PASSENGER_LOAD_BALANCING_REUSE_PORT
+#endif
+
 #if defined(__APPLE__)
 	#define HAVE_FPURGE
 #elif defined(__GLIBC__)
@@ -368,9 +373,9 @@ createUnixServer(const StaticString &filename, unsigned int backlogSize, bool au
 	return fd;
 }
 
-int
-createTcpServer(const char *address, unsigned short port, unsigned int backlogSize,
-	const char *file, unsigned int line)
+static int
+createTcpServerWithOptions(const char *address, unsigned short port, unsigned int backlogSize,
+	bool reusePort, const char *file, unsigned int line)
 {
 	union {
 		struct sockaddr_in v4;
@@ -423,6 +428,18 @@ createTcpServer(const char *address, unsigned short port, unsigned int backlogSi
 	// Ignore SO_REUSEADDR error, it's not fatal.
 
 	FdGuard guard(fd, file, line, true);
+	if (reusePort) {
+		#ifdef PASSENGER_LOAD_BALANCING_REUSE_PORT
+			if (syscalls::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+				&optval, sizeof(optval)) == -1)
+			{
+				int e = errno;
+				throw SystemException("Cannot set SO_REUSEPORT on a TCP socket", e);
+			}
+		#else
+			throw SystemException("Cannot set SO_REUSEPORT on a TCP socket", ENOPROTOOPT);
+		#endif
+	}
 	if (family == AF_INET) {
 		ret = syscalls::bind(fd, (const struct sockaddr *) &addr.v4, sizeof(struct sockaddr_in));
 	} else {
@@ -454,6 +471,38 @@ createTcpServer(const char *address, unsigned short port, unsigned int backlogSi
 	return fd;
 }
 
+int
+createTcpServer(const char *address, unsigned short port, unsigned int backlogSize,
+	const char *file, unsigned int line)
+{
+	return createTcpServerWithOptions(address, port, backlogSize, false, file, line);
+}
+
+bool
+reusePortLoadBalancingSupported() {
+	#ifdef PASSENGER_LOAD_BALANCING_REUSE_PORT
+		return true;
+	#else
+		return false;
+	#endif
+}
+
+int
+createReusePortServer(const StaticString &address, unsigned int backlogSize,
+	const char *file, unsigned int line)
+{
+	TRACE_POINT();
+	if (getSocketAddressType(address) != SAT_TCP) {
+		throw ArgumentException(string("SO_REUSEPORT is only supported for TCP addresses, but '")
+			+ address + "' is not one");
+	}
+
+	string host;
+	unsigned short port;
+	parseTcpSocketAddress(address, host, port);
+	return createTcpServerWithOptions(host.c_str(), port, backlogSize, true, file, line);
+}
+
 int
 connectToServer(const StaticString &address, const char *file, unsigned int line) {
 	TRACE_POINT();
@@ -208,6 +208,41 @@ int createTcpServer(const char *address = "0.0.0.0",
 	const char *file = __FILE__,
 	unsigned int line = __LINE__);
 
+/**
+ * Returns whether createReusePortServer() is supported on this platform,
+ * i.e. whether the kernel distributes incoming connections over multiple
+ * sockets that are bound to the same address with SO_REUSEPORT. Only Linux
+ * does that; other systems either lack SO_REUSEPORT or deliver all
+ * connections to a single socket.
+ *
+ * @ingroup Support
+ */
+bool reusePortLoadBalancingSupported();
+
+/**
+ * Create a new TCP server socket, like createServer() does, but with
+ * SO_REUSEPORT set. This allows creating multiple server sockets for the
+ * same address (for example one per thread), over which the kernel
+ * distributes incoming connections.
+ *
+ * @param address A TCP address as accepted by getSocketAddressType().
+ * @param backlogSize The size of the socket's backlog. Specify 0 to use the
+ *                    platform's maximum allowed backlog size.
+ * @param file The name of the source file that called this function,
+ *             for file descriptor logging purposes.
+ * @param line The line in the source file that called this function.
+ * @return The file descriptor of the newly created server socket.
+ * @throws ArgumentException The given address is not a TCP address.
+ * @throws SystemException Something went wrong while creating the server socket,
+ *                         for example because SO_REUSEPORT is not supported.
+ * @throws boost::thread_interrupted A system call has been interrupted.
+ * @ingroup Support
+ */
+int createReusePortServer(const StaticString &address,
+	unsigned int backlogSize = 0,
+	const char *file = __FILE__,
+	unsigned int line = __LINE__);
+
 /**
  * Connect to a server at the given address in a blocking manner.
  *
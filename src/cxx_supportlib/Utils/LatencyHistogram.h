@@ -0,0 +1,489 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_LATENCY_HISTOGRAM_H_
+#define _PASSENGER_LATENCY_HISTOGRAM_H_
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <jsoncpp/json.h>
+#include <Utils/JsonUtils.h>
+
+namespace Passenger {
+
+using namespace std;
+
+
+/**
+ * A histogram of durations, in microseconds, with power-of-two buckets.
+ * Bucket 0 counts durations of 0 usec, and bucket `i` (i > 0) counts
+ * durations in the range [2^(i-1), 2^i) usec. The last bucket also counts
+ * everything larger than that.
+ *
+ * Recording a sample is a few relaxed atomic operations and never blocks,
+ * so a LatencyHistogram can be shared between threads and updated from
+ * hot paths. Readers may observe a sample's bucket count before its sum
+ * or maximum, which is fine for the statistical purposes this class is
+ * meant for.
+ */
+class LatencyHistogram {
+public:
+	static const unsigned int BUCKETS = 32;
+
+private:
+	boost::atomic<boost::uint64_t> buckets[BUCKETS];
+	boost::atomic<boost::uint64_t> sum;
+	boost::atomic<boost::uint64_t> max;
+
+public:
+	static unsigned int bucketFor(boost::uint64_t usec) {
+		unsigned int i = 0;
+		while (usec != 0 && i < BUCKETS - 1) {
+			usec >>= 1;
+			i++;
+		}
+		return i;
+	}
+
+	static boost::uint64_t bucketUpperBound(unsigned int i) {
+		if (i == 0) {
+			return 0;
+		} else {
+			return ((boost::uint64_t) 1 << i) - 1;
+		}
+	}
+
+	LatencyHistogram() {
+		reset();
+	}
+
+	void record(boost::uint64_t usec) {
+		buckets[bucketFor(usec)].fetch_add(1, boost::memory_order_relaxed);
+		sum.fetch_add(usec, boost::memory_order_relaxed);
+
+		boost::uint64_t current = max.load(boost::memory_order_relaxed);
+		while (usec > current
+			&& !max.compare_exchange_weak(current, usec, boost::memory_order_relaxed))
+		{
+			// Retry; `current` has been updated.
+		}
+	}
+
+	void reset() {
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			buckets[i].store(0, boost::memory_order_relaxed);
+		}
+		sum.store(0, boost::memory_order_relaxed);
+		max.store(0, boost::memory_order_relaxed);
+	}
+
+	boost::uint64_t getCount() const {
+		boost::uint64_t result = 0;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			result += buckets[i].load(boost::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	boost::uint64_t getBucketCount(unsigned int i) const {
+		return buckets[i].load(boost::memory_order_relaxed);
+	}
+
+	boost::uint64_t getSum() const {
+		return sum.load(boost::memory_order_relaxed);
+	}
+
+	boost::uint64_t getMax() const {
+		return max.load(boost::memory_order_relaxed);
+	}
+
+	double getAverage() const {
+		boost::uint64_t count = getCount();
+		if (count == 0) {
+			return 0;
+		} else {
+			return (double) getSum() / count;
+		}
+	}
+
+	/**
+	 * Returns an upper bound for the given percentile (0..100), accurate
+	 * to within a factor of 2. Returns 0 if there are no samples.
+	 */
+	boost::uint64_t getPercentile(double percentile) const {
+		boost::uint64_t counts[BUCKETS];
+		boost::uint64_t total = 0;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			counts[i] = buckets[i].load(boost::memory_order_relaxed);
+			total += counts[i];
+		}
+		if (total == 0) {
+			return 0;
+		}
+
+		boost::uint64_t threshold = (boost::uint64_t) (total * percentile / 100.0);
+		if (threshold == 0) {
+			threshold = 1;
+		}
+		boost::uint64_t seen = 0;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			seen += counts[i];
+			if (seen >= threshold) {
+				boost::uint64_t bound = bucketUpperBound(i);
+				boost::uint64_t maxValue = getMax();
+				return (bound < maxValue) ? bound : maxValue;
+			}
+		}
+		return getMax();
+	}
+
+	/**
+	 * Returns a one-line summary such as
+	 * "count=10, avg=3.2us, p50<=3us, p99<=7us, max=6us".
+	 */
+	string inspect() const {
+		stringstream stream;
+		stream.setf(ios::fixed, ios::floatfield);
+		stream.precision(1);
+		stream << "count=" << getCount()
+			<< ", avg=" << getAverage() << "us"
+			<< ", p50<=" << getPercentile(50) << "us"
+			<< ", p99<=" << getPercentile(99) << "us"
+			<< ", max=" << getMax() << "us";
+		return stream.str();
+	}
+
+	/**
+	 * Returns the non-empty buckets as lines of the form
+	 * "  < 16us : 123".
+	 */
+	string inspectBuckets(const char *indent = "  ") const {
+		stringstream stream;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			boost::uint64_t count = getBucketCount(i);
+			if (count == 0) {
+				continue;
+			}
+			stream << indent;
+			if (i == BUCKETS - 1) {
+				stream << ">= " << (bucketUpperBound(i - 1) + 1) << "us";
+			} else {
+				stream << "< " << (bucketUpperBound(i) + 1) << "us";
+			}
+			stream << " : " << count << "\n";
+		}
+		return stream.str();
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		Json::Value bucketsDoc(Json::arrayValue);
+
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			boost::uint64_t count = getBucketCount(i);
+			if (count == 0) {
+				continue;
+			}
+			Json::Value bucket;
+			if (i == BUCKETS - 1) {
+				bucket["le_usec"] = Json::Value(Json::nullValue);
+			} else {
+				bucket["le_usec"] = (Json::UInt64) bucketUpperBound(i);
+			}
+			bucket["count"] = (Json::UInt64) count;
+			bucketsDoc.append(bucket);
+		}
+
+		doc["count"] = (Json::UInt64) getCount();
+		doc["sum_usec"] = (Json::UInt64) getSum();
+		doc["max_usec"] = (Json::UInt64) getMax();
+		doc["average_usec"] = getAverage();
+		doc["p50_usec"] = (Json::UInt64) getPercentile(50);
+		doc["p99_usec"] = (Json::UInt64) getPercentile(99);
+		doc["buckets"] = bucketsDoc;
+		return doc;
+	}
+};
+
+/**
+ * A LatencyHistogram without atomic operations, for histograms that are only
+ * updated by a single thread, and for merging and exporting copies of other
+ * histograms. Uses the same buckets as LatencyHistogram.
+ */
+struct LocalLatencyHistogram {
+	boost::uint64_t buckets[LatencyHistogram::BUCKETS];
+	boost::uint64_t sum;
+	boost::uint64_t max;
+
+	LocalLatencyHistogram() {
+		reset();
+	}
+
+	void reset() {
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+			buckets[i] = 0;
+		}
+		sum = 0;
+		max = 0;
+	}
+
+	void record(boost::uint64_t usec) {
+		buckets[LatencyHistogram::bucketFor(usec)]++;
+		sum += usec;
+		if (usec > max) {
+			max = usec;
+		}
+	}
+
+	/** Adds the samples of `other` to this histogram. */
+	void merge(const LocalLatencyHistogram &other) {
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+			buckets[i] += other.buckets[i];
+		}
+		sum += other.sum;
+		if (other.max > max) {
+			max = other.max;
+		}
+	}
+
+	/** Adds the samples of `other` to this histogram. */
+	void merge(const LatencyHistogram &other) {
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+			buckets[i] += other.getBucketCount(i);
+		}
+		sum += other.getSum();
+		if (other.getMax() > max) {
+			max = other.getMax();
+		}
+	}
+
+	boost::uint64_t getCount() const {
+		boost::uint64_t result = 0;
+		for (unsigned int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+			result += buckets[i];
+		}
+		return result;
+	}
+};
+
+/**
+ * A histogram of durations, in microseconds, with log-linear ("HDR-style")
+ * buckets. Each power-of-two range of LatencyHistogram is split into
+ * SUB_BUCKETS equally wide buckets, so percentiles are accurate to within
+ * 1/SUB_BUCKETS of their value instead of a factor of 2. Durations below
+ * 2 * SUB_BUCKETS usec are counted exactly.
+ *
+ * Like LocalLatencyHistogram it uses no atomic operations: every thread
+ * keeps its own histograms, and readers merge copies of them.
+ */
+class HdrLatencyHistogram {
+public:
+	static const unsigned int SUB_BUCKET_BITS = 4;
+	static const unsigned int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	/** Durations of 2^MAX_EXPONENT usec (over an hour) and longer share the last bucket. */
+	static const unsigned int MAX_EXPONENT = 32;
+	static const unsigned int BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+	boost::uint64_t buckets[BUCKETS];
+	boost::uint64_t count;
+	boost::uint64_t sum;
+	boost::uint64_t max;
+
+public:
+	static unsigned int bucketFor(boost::uint64_t usec) {
+		if (usec < SUB_BUCKETS) {
+			return usec;
+		} else if (usec >= ((boost::uint64_t) 1 << MAX_EXPONENT)) {
+			return BUCKETS - 1;
+		}
+
+		unsigned int exponent = SUB_BUCKET_BITS;
+		while ((usec >> (exponent + 1)) != 0) {
+			exponent++;
+		}
+		unsigned int shift = exponent - SUB_BUCKET_BITS;
+		return (shift + 1) * SUB_BUCKETS + (usec >> shift) - SUB_BUCKETS;
+	}
+
+	static boost::uint64_t bucketLowerBound(unsigned int i) {
+		if (i < SUB_BUCKETS) {
+			return i;
+		} else {
+			unsigned int shift = i / SUB_BUCKETS - 1;
+			return (boost::uint64_t) (SUB_BUCKETS + i % SUB_BUCKETS) << shift;
+		}
+	}
+
+	static boost::uint64_t bucketUpperBound(unsigned int i) {
+		if (i < SUB_BUCKETS) {
+			return i;
+		} else {
+			unsigned int shift = i / SUB_BUCKETS - 1;
+			return bucketLowerBound(i) + ((boost::uint64_t) 1 << shift) - 1;
+		}
+	}
+
+	HdrLatencyHistogram() {
+		reset();
+	}
+
+	void reset() {
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			buckets[i] = 0;
+		}
+		count = 0;
+		sum = 0;
+		max = 0;
+	}
+
+	void record(boost::uint64_t usec) {
+		buckets[bucketFor(usec)]++;
+		count++;
+		sum += usec;
+		if (usec > max) {
+			max = usec;
+		}
+	}
+
+	/** Adds the samples of `other` to this histogram. */
+	void merge(const HdrLatencyHistogram &other) {
+		if (other.count == 0) {
+			return;
+		}
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			buckets[i] += other.buckets[i];
+		}
+		count += other.count;
+		sum += other.sum;
+		if (other.max > max) {
+			max = other.max;
+		}
+	}
+
+	/**
+	 * Adds the samples of this histogram to `target`, which has coarser,
+	 * power-of-two buckets. Every bucket of this histogram lies entirely
+	 * within one bucket of `target`, so no precision is lost beyond that
+	 * of `target`.
+	 */
+	void collapseInto(LocalLatencyHistogram &target) const {
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			target.buckets[LatencyHistogram::bucketFor(bucketLowerBound(i))] += buckets[i];
+		}
+		target.sum += sum;
+		if (max > target.max) {
+			target.max = max;
+		}
+	}
+
+	boost::uint64_t getCount() const {
+		return count;
+	}
+
+	boost::uint64_t getBucketCount(unsigned int i) const {
+		return buckets[i];
+	}
+
+	boost::uint64_t getSum() const {
+		return sum;
+	}
+
+	boost::uint64_t getMax() const {
+		return max;
+	}
+
+	double getAverage() const {
+		if (count == 0) {
+			return 0;
+		} else {
+			return (double) sum / count;
+		}
+	}
+
+	/**
+	 * Returns an upper bound for the given percentile (0..100), accurate
+	 * to within 1/SUB_BUCKETS. Uses the nearest-rank definition, so that
+	 * high percentiles of small sample sets aren't underreported.
+	 * Returns 0 if there are no samples.
+	 */
+	boost::uint64_t getPercentile(double percentile) const {
+		if (count == 0) {
+			return 0;
+		}
+
+		boost::uint64_t threshold = (boost::uint64_t) ceil(count * percentile / 100.0);
+		if (threshold == 0) {
+			threshold = 1;
+		}
+		boost::uint64_t seen = 0;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			seen += buckets[i];
+			if (seen >= threshold) {
+				boost::uint64_t bound = bucketUpperBound(i);
+				return (bound < max) ? bound : max;
+			}
+		}
+		return max;
+	}
+
+	Json::Value inspectStateAsJson() const {
+		Json::Value doc;
+		Json::Value bucketsDoc(Json::arrayValue);
+
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			if (buckets[i] == 0) {
+				continue;
+			}
+			Json::Value bucket;
+			if (i == BUCKETS - 1) {
+				bucket["le_usec"] = Json::Value(Json::nullValue);
+			} else {
+				bucket["le_usec"] = (Json::UInt64) bucketUpperBound(i);
+			}
+			bucket["count"] = (Json::UInt64) buckets[i];
+			bucketsDoc.append(bucket);
+		}
+
+		doc["count"] = (Json::UInt64) count;
+		doc["sum_usec"] = (Json::UInt64) sum;
+		doc["max_usec"] = (Json::UInt64) max;
+		doc["average_usec"] = getAverage();
+		doc["p50_usec"] = (Json::UInt64) getPercentile(50);
+		doc["p90_usec"] = (Json::UInt64) getPercentile(90);
+		doc["p99_usec"] = (Json::UInt64) getPercentile(99);
+		doc["p999_usec"] = (Json::UInt64) getPercentile(99.9);
+		doc["buckets"] = bucketsDoc;
+		return doc;
+	}
+};
+
+
+} // namespace Passenger
+
+#endif /* _PASSENGER_LATENCY_HISTOGRAM_H_ */
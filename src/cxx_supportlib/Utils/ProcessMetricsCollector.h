@@ -33,6 +33,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #ifdef __APPLE__
 	#include <mach/mach_traps.h>
@@ -49,11 +50,14 @@
 #endif
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <cstdio>
 #include <cstdlib>
 #include <cerrno>
 #include <cstring>
@@ -193,8 +197,343 @@ public:
 class ProcessMetricsCollector {
 private:
 	bool canMeasureRealMemory;
+	bool canUseProcfs;
 	string psOutput;
 
+	/**
+	 * Reads the entire given file into `buffer` using as few read() calls
+	 * as possible. `buffer` is only ever grown, so that it can be reused
+	 * for many files without reallocating. Returns the number of bytes
+	 * read, or -1 on error.
+	 */
+	static ssize_t readProcFile(const char *path, string &buffer) {
+		int fd = syscalls::open(path, O_RDONLY);
+		if (fd == -1) {
+			return -1;
+		}
+		FdGuard guard(fd, NULL, 0);
+
+		if (buffer.size() < 1024 * 4) {
+			buffer.resize(1024 * 4);
+		}
+		size_t size = 0;
+		while (true) {
+			if (size == buffer.size() - 1) {
+				buffer.resize(buffer.size() * 2);
+			}
+			ssize_t ret = syscalls::read(fd, &buffer[size], buffer.size() - size - 1);
+			if (ret == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return -1;
+			} else if (ret == 0) {
+				break;
+			}
+			size += ret;
+		}
+		buffer[size] = '\0';
+		return size;
+	}
+
+	/**
+	 * Sums up the values of the /proc/<pid>/smaps or smaps_rollup keys we're
+	 * interested in. All values are in KB, or -1 if the key was not found.
+	 */
+	struct SmapsTotals {
+		ssize_t pss;
+		ssize_t privateDirty;
+		ssize_t swap;
+
+		SmapsTotals()
+			: pss(-1),
+			  privateDirty(-1),
+			  swap(-1)
+			{ }
+
+		/**
+		 * Parses a single line of the form "<key>: <number> kB", without
+		 * the trailing newline. Returns false if the line is malformed.
+		 */
+		bool parseLine(const char *line, const char *end) {
+			ssize_t *target;
+			size_t keySize;
+
+			if (matchKey(line, end, "Pss:", sizeof("Pss:") - 1)) {
+				/* Linux supports Proportional Set Size since kernel 2.6.25.
+				 * See kernel commit ec4dd3eb35759f9fbeb5c1abb01403b2fde64cc9.
+				 */
+				target = &pss;
+				keySize = sizeof("Pss:") - 1;
+			} else if (matchKey(line, end, "Private_Dirty:", sizeof("Private_Dirty:") - 1)) {
+				target = &privateDirty;
+				keySize = sizeof("Private_Dirty:") - 1;
+			} else if (matchKey(line, end, "Swap:", sizeof("Swap:") - 1)) {
+				target = &swap;
+				keySize = sizeof("Swap:") - 1;
+			} else {
+				return true;
+			}
+
+			const char *pos = skipSpaces(line + keySize, end);
+			const char *numberStart = pos;
+			ssize_t value = 0;
+			while (pos < end && *pos >= '0' && *pos <= '9') {
+				value = value * 10 + (*pos - '0');
+				pos++;
+			}
+			if (pos == numberStart) {
+				return false;
+			}
+			pos = skipSpaces(pos, end);
+			if (end - pos != 2 || pos[0] != 'k' || pos[1] != 'B') {
+				return false;
+			}
+
+			if (*target == -1) {
+				*target = 0;
+			}
+			*target += value;
+			return true;
+		}
+
+		/**
+		 * Parses all complete lines in the given data. Returns a pointer to
+		 * the start of the trailing incomplete line (`end` if there is
+		 * none), or NULL if the data is malformed.
+		 */
+		const char *parseLines(const char *data, const char *end) {
+			while (data < end) {
+				const char *newline = (const char *) memchr(data, '\n', end - data);
+				if (newline == NULL) {
+					return data;
+				}
+				if (!parseLine(data, newline)) {
+					return NULL;
+				}
+				data = newline + 1;
+			}
+			return end;
+		}
+
+		static bool matchKey(const char *line, const char *end, const char *key,
+			size_t keySize)
+		{
+			return (size_t) (end - line) >= keySize && memcmp(line, key, keySize) == 0;
+		}
+
+		static const char *skipSpaces(const char *pos, const char *end) {
+			while (pos < end && (*pos == ' ' || *pos == '\t')) {
+				pos++;
+			}
+			return pos;
+		}
+	};
+
+	/**
+	 * Streams the given smaps or smaps_rollup file through `totals`, using
+	 * `buffer` as a fixed-size read buffer so that large smaps files are not
+	 * loaded into memory as a whole. Returns false if the file cannot be
+	 * read or is malformed.
+	 */
+	static bool parseSmapsFile(const char *path, string &buffer, SmapsTotals &totals) {
+		int fd = syscalls::open(path, O_RDONLY);
+		if (fd == -1) {
+			return false;
+		}
+		FdGuard guard(fd, NULL, 0);
+
+		if (buffer.size() < 1024 * 16) {
+			buffer.resize(1024 * 16);
+		}
+		// Number of bytes at the start of `buffer` belonging to an incomplete line.
+		size_t carried = 0;
+		while (true) {
+			if (carried == buffer.size()) {
+				// No line is this long in a valid smaps file.
+				return false;
+			}
+			ssize_t ret = syscalls::read(fd, &buffer[carried], buffer.size() - carried);
+			if (ret == -1) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			} else if (ret == 0) {
+				break;
+			}
+
+			const char *start = buffer.data();
+			const char *end = start + carried + ret;
+			const char *rest = totals.parseLines(start, end);
+			if (rest == NULL) {
+				return false;
+			}
+			carried = end - rest;
+			memmove(&buffer[0], rest, carried);
+		}
+
+		if (carried > 0) {
+			return totals.parseLine(buffer.data(), buffer.data() + carried);
+		} else {
+			return true;
+		}
+	}
+
+	/**
+	 * Per-collect() state for the procfs backend, so that buffers and
+	 * system-wide values are only set up once per batch of PIDs.
+	 */
+	struct ProcfsContext {
+		string buffer;
+		char path[64];
+		double uptime;
+		long clockTicks;
+		long pageSize;
+
+		ProcfsContext()
+			: uptime(-1),
+			  clockTicks(sysconf(_SC_CLK_TCK)),
+			  pageSize(sysconf(_SC_PAGESIZE))
+		{
+			if (readProcFile("/proc/uptime", buffer) > 0) {
+				uptime = atof(buffer.c_str());
+			}
+		}
+
+		const char *procPath(pid_t pid, const char *file) {
+			snprintf(path, sizeof(path), "/proc/%d/%s", (int) pid, file);
+			return path;
+		}
+	};
+
+	/**
+	 * Parses /proc/<pid>/stat. Returns false if the process doesn't exist
+	 * (anymore) or if the data is malformed.
+	 *
+	 * The `comm` field is enclosed in parentheses and may itself contain
+	 * spaces and parentheses, so we look for the last ')'.
+	 */
+	static bool readProcStat(pid_t pid, ProcfsContext &context, ProcessMetrics &metrics,
+		string &comm)
+	{
+		if (readProcFile(context.procPath(pid, "stat"), context.buffer) <= 0) {
+			return false;
+		}
+
+		const char *data = context.buffer.c_str();
+		const char *commStart = strchr(data, '(');
+		const char *commEnd = strrchr(data, ')');
+		if (commStart == NULL || commEnd == NULL || commEnd < commStart) {
+			return false;
+		}
+		comm.assign(commStart + 1, commEnd - commStart - 1);
+
+		// Field 3 (state) and onwards.
+		const char *fields[22];
+		const char *pos = commEnd + 1;
+		for (unsigned int i = 0; i < sizeof(fields) / sizeof(const char *); i++) {
+			while (*pos == ' ') {
+				pos++;
+			}
+			if (*pos == '\0' || *pos == '\n') {
+				return false;
+			}
+			fields[i] = pos;
+			while (*pos != ' ' && *pos != '\0' && *pos != '\n') {
+				pos++;
+			}
+		}
+
+		// See proc(5); fields[i] is field number i + 3.
+		unsigned long long utime = strtoull(fields[11], NULL, 10);
+		unsigned long long stime = strtoull(fields[12], NULL, 10);
+		unsigned long long startTime = strtoull(fields[19], NULL, 10);
+
+		metrics.pid = pid;
+		metrics.ppid = (pid_t) strtol(fields[1], NULL, 10);
+		metrics.processGroupId = (pid_t) strtol(fields[2], NULL, 10);
+		metrics.vmsize = (ssize_t) (strtoull(fields[20], NULL, 10) / 1024);
+		metrics.rss = (ssize_t) (strtoll(fields[21], NULL, 10) * (context.pageSize / 1024));
+
+		// Like ps, report the average CPU usage over the process's lifetime.
+		metrics.cpu = 0;
+		if (context.uptime > 0 && context.clockTicks > 0) {
+			double lifetime = context.uptime - (double) startTime / context.clockTicks;
+			if (lifetime > 0) {
+				double cpu = (double) (utime + stime) / context.clockTicks
+					/ lifetime * 100;
+				metrics.cpu = (boost::uint8_t) std::min(cpu, 255.0);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Reads the effective UID from /proc/<pid>/status. We can't stat()
+	 * /proc/<pid> because that reports root for non-dumpable processes,
+	 * e.g. those that changed their UID.
+	 */
+	static void readProcUid(pid_t pid, ProcfsContext &context, ProcessMetrics &metrics) {
+		if (readProcFile(context.procPath(pid, "status"), context.buffer) <= 0) {
+			return;
+		}
+
+		const char *uidLine = strstr(context.buffer.c_str(), "\nUid:");
+		if (uidLine != NULL) {
+			char *end;
+			// Real UID, followed by effective UID.
+			strtoul(uidLine + sizeof("\nUid:") - 1, &end, 10);
+			metrics.uid = (uid_t) strtoul(end, NULL, 10);
+		}
+	}
+
+	/**
+	 * Reads the command line from /proc/<pid>/cmdline, formatted like ps
+	 * does: arguments separated by spaces, or "[comm]" if the process has
+	 * no command line (e.g. it's a zombie).
+	 */
+	static void readProcCommand(pid_t pid, ProcfsContext &context, const string &comm,
+		ProcessMetrics &metrics)
+	{
+		ssize_t size = readProcFile(context.procPath(pid, "cmdline"), context.buffer);
+		while (size > 0 && context.buffer[size - 1] == '\0') {
+			size--;
+		}
+		if (size <= 0) {
+			metrics.command = "[" + comm + "]";
+			return;
+		}
+
+		metrics.command.assign(context.buffer.data(), size);
+		std::replace(metrics.command.begin(), metrics.command.end(), '\0', ' ');
+	}
+
+	template<typename Collection, typename ConstIterator>
+	ProcessMetricMap collectFromProcfs(const Collection &pids) const {
+		ProcessMetricMap result;
+		ProcfsContext context;
+		string comm;
+		ConstIterator it, end = pids.end();
+
+		for (it = pids.begin(); it != end; it++) {
+			ProcessMetrics metrics;
+
+			if (!readProcStat(*it, context, metrics, comm)) {
+				continue;
+			}
+			readProcUid(*it, context, metrics);
+			readProcCommand(*it, context, comm, metrics);
+			if (canMeasureRealMemory) {
+				measureRealMemory(metrics.pid, metrics.pss,
+					metrics.privateDirty, metrics.swap, context.buffer);
+			}
+			result[metrics.pid] = metrics;
+		}
+
+		return result;
+	}
+
 	template<typename Collection, typename ConstIterator>
 	ProcessMetricMap parsePsOutput(const string &output, const Collection &allowedPids) const {
 		ProcessMetricMap result;
@@ -256,19 +595,43 @@ public:
 		#else
 			canMeasureRealMemory = fileExists("/proc/self/smaps");
 		#endif
+		#ifdef __linux__
+			canUseProcfs = fileExists("/proc/self/stat");
+		#else
+			canUseProcfs = false;
+		#endif
 	}
 
-	/** Mock 'ps' output, used by unit tests. */
+	/** Mock 'ps' output, used by unit tests. Implies using 'ps'. */
 	void setPsOutput(const string &data) {
 		this->psOutput = data;
 	}
 
+	/**
+	 * Whether to collect metrics by reading /proc directly (the default on
+	 * Linux) instead of by running 'ps'. Enabling this has no effect on
+	 * systems that don't support it.
+	 */
+	void setProcfsEnabled(bool enabled) {
+		#ifdef __linux__
+			canUseProcfs = enabled && fileExists("/proc/self/stat");
+		#endif
+	}
+
+	bool isProcfsEnabled() const {
+		return canUseProcfs;
+	}
+
 	/**
 	 * Collect metrics for the given process IDs. Nonexistant PIDs are not
 	 * included in the result.
 	 *
 	 * Returns a map which maps a given PID to its collected metrics.
 	 *
+	 * On Linux, the metrics are read from /proc/<pid>/{stat,status,cmdline}
+	 * and /proc/<pid>/smaps_rollup, so that no 'ps' process has to be
+	 * spawned. Elsewhere, or when procfs is unavailable, 'ps' is used.
+	 *
 	 * @throws ParseException The ps output cannot be parsed.
 	 * @throws SystemException Error collecting the ps output or error querying memory usage.
 	 */
@@ -277,6 +640,9 @@ public:
 		if (pids.empty()) {
 			return ProcessMetricMap();
 		}
+		if (canUseProcfs && psOutput.empty()) {
+			return collectFromProcfs<Collection, ConstIterator>(pids);
+		}
 
 		ConstIterator it;
 		// The list of PIDs must follow -p without a space.
@@ -405,83 +771,45 @@ public:
 			pss /= 1024;
 			privateDirty /= 1024;
 		#else
-			string smapsFilename = "/proc/";
-			smapsFilename.append(toString(pid));
-			smapsFilename.append("/smaps");
-
-			FILE *f = syscalls::fopen(smapsFilename.c_str(), "r");
-			if (f == NULL) {
-				error:
-				pss = -1;
-				privateDirty = -1;
-				swap = -1;
-				return;
-			}
-
-			StdioGuard guard(f, NULL, 0);
-			bool hasPss = false;
-			bool hasPrivateDirty = false;
-			bool hasSwap = false;
-
-			// In KB.
-			pss = 0;
-			privateDirty = 0;
-			swap = 0;
-
-			while (!feof(f)) {
-				char line[1024 * 4];
-				const char *buf;
+			string buffer;
+			measureRealMemory(pid, pss, privateDirty, swap, buffer);
+		#endif
+	}
 
-				buf = fgets(line, sizeof(line), f);
-				if (buf == NULL) {
-					if (ferror(f)) {
-						goto error;
-					} else {
-						break;
-					}
-				}
-				try {
-					if (startsWith(line, "Pss:")) {
-						/* Linux supports Proportional Set Size since kernel 2.6.25.
-						 * See kernel commit ec4dd3eb35759f9fbeb5c1abb01403b2fde64cc9.
-						 */
-						hasPss = true;
-						readNextWord(&buf);
-						pss += readNextWordAsLongLong(&buf);
-						if (readNextWord(&buf) != "kB") {
-							goto error;
-						}
-					} else if (startsWith(line, "Private_Dirty:")) {
-						hasPrivateDirty = true;
-						readNextWord(&buf);
-						privateDirty += readNextWordAsLongLong(&buf);
-						if (readNextWord(&buf) != "kB") {
-							goto error;
-						}
-					} else if (startsWith(line, "Swap:")) {
-						hasSwap = true;
-						readNextWord(&buf);
-						swap += readNextWordAsLongLong(&buf);
-						if (readNextWord(&buf) != "kB") {
-							goto error;
-						}
-					}
-				} catch (const ParseException &) {
-					goto error;
-				}
+	#ifndef __APPLE__
+		/**
+		 * Like measureRealMemory(pid, pss, privateDirty, swap), but uses the
+		 * given buffer for reading, so that it can be reused between calls.
+		 *
+		 * /proc/<pid>/smaps_rollup (Linux >= 4.14) is preferred over
+		 * /proc/<pid>/smaps because the kernel already sums up all mappings,
+		 * which is much cheaper for processes with many mappings.
+		 */
+		static void measureRealMemory(pid_t pid, ssize_t &pss, ssize_t &privateDirty,
+			ssize_t &swap, string &buffer)
+		{
+			char path[64];
+			SmapsTotals totals;
+			bool ok;
+
+			snprintf(path, sizeof(path), "/proc/%d/smaps_rollup", (int) pid);
+			ok = parseSmapsFile(path, buffer, totals);
+			if (!ok) {
+				snprintf(path, sizeof(path), "/proc/%d/smaps", (int) pid);
+				totals = SmapsTotals();
+				ok = parseSmapsFile(path, buffer, totals);
 			}
-
-			if (!hasPss) {
+			if (ok) {
+				pss = totals.pss;
+				privateDirty = totals.privateDirty;
+				swap = totals.swap;
+			} else {
 				pss = -1;
-			}
-			if (!hasPrivateDirty) {
 				privateDirty = -1;
-			}
-			if (!hasSwap) {
 				swap = -1;
 			}
-		#endif
-	}
+		}
+	#endif
 };
 
 } // namespace Passenger
@@ -309,6 +309,36 @@ generated_cache_location_part(ngx_conf_t *cf, passenger_loc_conf_t *conf) {
         len += sizeof("\r\n") - 1;
     }
 
+    if (conf->spawn_concurrency != NGX_CONF_UNSET) {
+        end = ngx_snprintf(int_buf,
+            sizeof(int_buf) - 1,
+            "%d",
+            conf->spawn_concurrency);
+        len += sizeof("!~PASSENGER_SPAWN_CONCURRENCY: ") - 1;
+        len += end - int_buf;
+        len += sizeof("\r\n") - 1;
+    }
+
+    if (conf->blue_green_restart != NGX_CONF_UNSET) {
+        len += sizeof("!~PASSENGER_BLUE_GREEN_RESTART: ") - 1;
+        len += conf->blue_green_restart
+            ? sizeof("t\r\n") - 1
+            : sizeof("f\r\n") - 1;
+    }
+
+    if (conf->restart_warmup_path.data != NULL) {
+        len += sizeof("!~PASSENGER_RESTART_WARMUP_PATH: ") - 1;
+        len += conf->restart_warmup_path.len;
+        len += sizeof("\r\n") - 1;
+    }
+
+    if (conf->autoscale != NGX_CONF_UNSET) {
+        len += sizeof("!~PASSENGER_AUTOSCALE: ") - 1;
+        len += conf->autoscale
+            ? sizeof("t\r\n") - 1
+            : sizeof("f\r\n") - 1;
+    }
+
 
     /* Create string */
     buf = pos = ngx_pnalloc(cf->pool, len);
@@ -667,6 +697,48 @@ generated_cache_location_part(ngx_conf_t *cf, passenger_loc_conf_t *conf) {
         pos = ngx_copy(pos, int_buf, end - int_buf);
         pos = ngx_copy(pos, (const u_char *) "\r\n", sizeof("\r\n") - 1);
     }
+    if (conf->spawn_concurrency != NGX_CONF_UNSET) {
+        pos = ngx_copy(pos,
+            "!~PASSENGER_SPAWN_CONCURRENCY: ",
+            sizeof("!~PASSENGER_SPAWN_CONCURRENCY: ") - 1);
+        end = ngx_snprintf(int_buf,
+            sizeof(int_buf) - 1,
+            "%d",
+            conf->spawn_concurrency);
+        pos = ngx_copy(pos, int_buf, end - int_buf);
+        pos = ngx_copy(pos, (const u_char *) "\r\n", sizeof("\r\n") - 1);
+    }
+    if (conf->blue_green_restart != NGX_CONF_UNSET) {
+        pos = ngx_copy(pos,
+            "!~PASSENGER_BLUE_GREEN_RESTART: ",
+            sizeof("!~PASSENGER_BLUE_GREEN_RESTART: ") - 1);
+        if (conf->blue_green_restart) {
+            pos = ngx_copy(pos, "t\r\n", sizeof("t\r\n") - 1);
+        } else {
+            pos = ngx_copy(pos, "f\r\n", sizeof("f\r\n") - 1);
+        }
+    }
+
+    if (conf->restart_warmup_path.data != NULL) {
+        pos = ngx_copy(pos,
+            "!~PASSENGER_RESTART_WARMUP_PATH: ",
+            sizeof("!~PASSENGER_RESTART_WARMUP_PATH: ") - 1);
+        pos = ngx_copy(pos,
+            conf->restart_warmup_path.data,
+            conf->restart_warmup_path.len);
+        pos = ngx_copy(pos, (const u_char *) "\r\n", sizeof("\r\n") - 1);
+    }
+    if (conf->autoscale != NGX_CONF_UNSET) {
+        pos = ngx_copy(pos,
+            "!~PASSENGER_AUTOSCALE: ",
+            sizeof("!~PASSENGER_AUTOSCALE: ") - 1);
+        if (conf->autoscale) {
+            pos = ngx_copy(pos, "t\r\n", sizeof("t\r\n") - 1);
+        } else {
+            pos = ngx_copy(pos, "f\r\n", sizeof("f\r\n") - 1);
+        }
+    }
+
 
     conf->options_cache.data = buf;
     conf->options_cache.len = pos - buf;
@@ -28,6 +28,7 @@
 #include <ngx_config.h>
 #include <ngx_core.h>
 #include <ngx_http.h>
+#include <ngx_md5.h>
 
 #include <sys/types.h>
 #include <pwd.h>
@@ -120,6 +121,7 @@ passenger_create_main_conf(ngx_conf_t *cf)
     conf->abort_on_startup_error = NGX_CONF_UNSET;
     conf->max_pool_size = NGX_CONF_UNSET_UINT;
     conf->pool_idle_time = NGX_CONF_UNSET_UINT;
+    conf->max_concurrent_spawns = NGX_CONF_UNSET_UINT;
     conf->response_buffer_high_watermark = NGX_CONF_UNSET_UINT;
     conf->stat_throttle_rate = NGX_CONF_UNSET_UINT;
     conf->core_file_descriptor_ulimit = NGX_CONF_UNSET_UINT;
@@ -211,6 +213,10 @@ passenger_init_main_conf(ngx_conf_t *cf, void *conf_pointer)
         conf->pool_idle_time = DEFAULT_POOL_IDLE_TIME;
     }
 
+    if (conf->max_concurrent_spawns == NGX_CONF_UNSET_UINT) {
+        conf->max_concurrent_spawns = DEFAULT_MAX_CONCURRENT_SPAWNS;
+    }
+
     if (conf->response_buffer_high_watermark == NGX_CONF_UNSET_UINT) {
         conf->response_buffer_high_watermark = DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK;
     }
@@ -386,12 +392,43 @@ passenger_create_loc_conf(ngx_conf_t *cf)
     conf->options_cache.len   = 0;
     conf->env_vars_cache.data = NULL;
     conf->env_vars_cache.len  = 0;
+    conf->config_profile_id.data = NULL;
+    conf->config_profile_id.len  = 0;
+    conf->config_profile_registered = 0;
 
     return conf;
 }
 
 #include "CacheLocationConfig.c"
 
+/**
+ * Derives this location's Passenger core config profile ID from the cached
+ * options. Once the core has acknowledged the profile, requests refer to it by
+ * ID instead of sending the cached options. See ConfigProfileStore.h in the core.
+ */
+static ngx_int_t
+cache_loc_conf_profile_id(ngx_conf_t *cf, passenger_loc_conf_t *conf)
+{
+    ngx_md5_t  md5;
+    u_char     digest[16];
+
+    ngx_md5_init(&md5);
+    ngx_md5_update(&md5, conf->options_cache.data, conf->options_cache.len);
+    ngx_md5_update(&md5, "\0", 1);
+    ngx_md5_update(&md5, conf->env_vars_cache.data, conf->env_vars_cache.len);
+    ngx_md5_final(digest, &md5);
+
+    conf->config_profile_id.data = ngx_pnalloc(cf->pool, 2 * sizeof(digest));
+    if (conf->config_profile_id.data == NULL) {
+        return NGX_ERROR;
+    }
+    conf->config_profile_id.len = ngx_hex_dump(conf->config_profile_id.data,
+        digest, sizeof(digest)) - conf->config_profile_id.data;
+    conf->config_profile_registered = 0;
+
+    return NGX_OK;
+}
+
 static ngx_int_t
 cache_loc_conf_options(ngx_conf_t *cf, passenger_loc_conf_t *conf)
 {
@@ -464,7 +501,7 @@ cache_loc_conf_options(ngx_conf_t *cf, passenger_loc_conf_t *conf)
         free(unencoded_buf);
     }
 
-    return NGX_OK;
+    return cache_loc_conf_profile_id(cf, conf);
 }
 
 #include "MergeLocationConfig.c"
@@ -1539,6 +1576,13 @@ const ngx_command_t passenger_commands[] = {
       offsetof(passenger_main_conf_t, pool_idle_time),
       NULL },
 
+    { ngx_string("passenger_max_concurrent_spawns"),
+      NGX_HTTP_MAIN_CONF | NGX_CONF_TAKE1,
+      ngx_conf_set_num_slot,
+      NGX_HTTP_MAIN_CONF_OFFSET,
+      offsetof(passenger_main_conf_t, max_concurrent_spawns),
+      NULL },
+
     { ngx_string("passenger_response_buffer_high_watermark"),
       NGX_HTTP_MAIN_CONF | NGX_CONF_TAKE1,
       ngx_conf_set_num_slot,
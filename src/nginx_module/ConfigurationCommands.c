@@ -453,6 +453,38 @@
     offsetof(passenger_loc_conf_t, force_max_concurrent_requests_per_process),
     NULL
 },
+{
+    ngx_string("passenger_spawn_concurrency"),
+    NGX_HTTP_MAIN_CONF | NGX_HTTP_SRV_CONF | NGX_HTTP_LOC_CONF | NGX_HTTP_LIF_CONF | NGX_CONF_TAKE1,
+    ngx_conf_set_num_slot,
+    NGX_HTTP_LOC_CONF_OFFSET,
+    offsetof(passenger_loc_conf_t, spawn_concurrency),
+    NULL
+},
+{
+    ngx_string("passenger_blue_green_restart"),
+    NGX_HTTP_MAIN_CONF | NGX_HTTP_SRV_CONF | NGX_HTTP_LOC_CONF | NGX_HTTP_LIF_CONF | NGX_CONF_FLAG,
+    ngx_conf_set_flag_slot,
+    NGX_HTTP_LOC_CONF_OFFSET,
+    offsetof(passenger_loc_conf_t, blue_green_restart),
+    NULL
+},
+{
+    ngx_string("passenger_restart_warmup_path"),
+    NGX_HTTP_MAIN_CONF | NGX_HTTP_SRV_CONF | NGX_HTTP_LOC_CONF | NGX_HTTP_LIF_CONF | NGX_CONF_TAKE1,
+    ngx_conf_set_str_slot,
+    NGX_HTTP_LOC_CONF_OFFSET,
+    offsetof(passenger_loc_conf_t, restart_warmup_path),
+    NULL
+},
+{
+    ngx_string("passenger_autoscale"),
+    NGX_HTTP_MAIN_CONF | NGX_HTTP_SRV_CONF | NGX_HTTP_LOC_CONF | NGX_HTTP_LIF_CONF | NGX_CONF_FLAG,
+    ngx_conf_set_flag_slot,
+    NGX_HTTP_LOC_CONF_OFFSET,
+    offsetof(passenger_loc_conf_t, autoscale),
+    NULL
+},
 {
     ngx_string("passenger_fly_with"),
     NGX_HTTP_MAIN_CONF | NGX_CONF_TAKE1,
@@ -695,6 +695,19 @@ construct_request_buffer(ngx_http_request_t *r, passenger_loc_conf_t *slcf,
             total_size += (sizeof(" (") - 1) + slcf->environment.len + (sizeof(")") - 1);
         }
         PUSH_STATIC_STR("\r\n");
+    } else if (slcf->config_profile_registered) {
+        /* The core leaves the app group name out of config profiles because
+         * it usually depends on the request, so a configured one isn't part
+         * of the profile either and must be sent with every request. When
+         * registering, it is part of the cached options below.
+         */
+        PUSH_STATIC_STR("!~PASSENGER_APP_GROUP_NAME: ");
+        if (b != NULL) {
+            b->last = ngx_copy(b->last, slcf->app_group_name.data,
+                slcf->app_group_name.len);
+        }
+        total_size += slcf->app_group_name.len;
+        PUSH_STATIC_STR("\r\n");
     }
 
     PUSH_STATIC_STR("!~PASSENGER_APP_TYPE: ");
@@ -720,18 +733,35 @@ construct_request_buffer(ngx_http_request_t *r, passenger_loc_conf_t *slcf,
         }
     }
 
+    /* Once the core has acknowledged this location's config profile, refer
+     * to it by ID instead of sending the cached options with every request.
+     */
+    if (slcf->config_profile_registered) {
+        PUSH_STATIC_STR("!~PASSENGER_CONFIG_PROFILE: ");
+    } else {
+        PUSH_STATIC_STR("!~PASSENGER_REGISTER_CONFIG_PROFILE: ");
+    }
     if (b != NULL) {
-        b->last = ngx_copy(b->last, slcf->options_cache.data, slcf->options_cache.len);
+        b->last = ngx_copy(b->last, slcf->config_profile_id.data,
+            slcf->config_profile_id.len);
     }
-    total_size += slcf->options_cache.len;
+    total_size += slcf->config_profile_id.len;
+    PUSH_STATIC_STR("\r\n");
 
-    if (slcf->env_vars_cache.data != NULL) {
-        PUSH_STATIC_STR("!~PASSENGER_ENV_VARS: ");
+    if (!slcf->config_profile_registered) {
         if (b != NULL) {
-            b->last = ngx_copy(b->last, slcf->env_vars_cache.data, slcf->env_vars_cache.len);
+            b->last = ngx_copy(b->last, slcf->options_cache.data, slcf->options_cache.len);
+        }
+        total_size += slcf->options_cache.len;
+
+        if (slcf->env_vars_cache.data != NULL) {
+            PUSH_STATIC_STR("!~PASSENGER_ENV_VARS: ");
+            if (b != NULL) {
+                b->last = ngx_copy(b->last, slcf->env_vars_cache.data, slcf->env_vars_cache.len);
+            }
+            total_size += slcf->env_vars_cache.len;
+            PUSH_STATIC_STR("\r\n");
         }
-        total_size += slcf->env_vars_cache.len;
-        PUSH_STATIC_STR("\r\n");
     }
 
     /* D = Dechunk response
@@ -1109,6 +1139,44 @@ done:
 }
 
 
+/**
+ * The core acknowledges a registered config profile, or reports a reference to
+ * a profile that it doesn't know (e.g. because it was restarted), with an
+ * X-Passenger-Config-Profile response header. Returns whether the header that
+ * was just parsed is that header, in which case it must not be passed on.
+ */
+static int
+process_config_profile_header(ngx_http_request_t *r)
+{
+    passenger_loc_conf_t *slcf;
+    size_t                name_len, value_len;
+    u_char               *value;
+
+    name_len = r->header_name_end - r->header_name_start;
+    if (name_len != sizeof("X-Passenger-Config-Profile") - 1
+     || ngx_strncasecmp(r->header_name_start, (u_char *) "X-Passenger-Config-Profile",
+                        name_len) != 0)
+    {
+        return 0;
+    }
+
+    slcf = ngx_http_get_module_loc_conf(r, ngx_http_passenger_module);
+    value = r->header_start;
+    value_len = r->header_end - r->header_start;
+
+    if (value_len == slcf->config_profile_id.len
+     && ngx_strncmp(value, slcf->config_profile_id.data, value_len) == 0)
+    {
+        slcf->config_profile_registered = 1;
+    } else if (value_len == sizeof("unknown") - 1
+            && ngx_strncmp(value, (u_char *) "unknown", value_len) == 0)
+    {
+        slcf->config_profile_registered = 0;
+    }
+
+    return 1;
+}
+
 static ngx_int_t
 process_header(ngx_http_request_t *r)
 {
@@ -1131,6 +1199,10 @@ process_header(ngx_http_request_t *r)
 
             /* a header line has been parsed successfully */
 
+            if (process_config_profile_header(r)) {
+                continue;
+            }
+
             h = ngx_list_push(&r->upstream->headers_in.headers);
             if (h == NULL) {
                 return NGX_ERROR;
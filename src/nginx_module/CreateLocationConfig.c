@@ -101,5 +101,10 @@ generated_set_conf_part(passenger_loc_conf_t  *conf) {
     conf->vary_turbocache_by_cookie.len  = 0;
     conf->abort_websockets_on_process_shutdown = NGX_CONF_UNSET;
     conf->force_max_concurrent_requests_per_process = NGX_CONF_UNSET;
+    conf->spawn_concurrency = NGX_CONF_UNSET;
+    conf->blue_green_restart = NGX_CONF_UNSET;
+    conf->restart_warmup_path.data = NULL;
+    conf->restart_warmup_path.len  = 0;
+    conf->autoscale = NGX_CONF_UNSET;
 }
 
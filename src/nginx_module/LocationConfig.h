@@ -48,9 +48,16 @@ typedef struct {
     ngx_str_t    options_cache;
     ngx_str_t    env_vars_cache;
 
+    /** Content hash of the above, used as the Passenger core config profile ID. */
+    ngx_str_t    config_profile_id;
+    /** Whether the core has acknowledged the profile. Per worker process. */
+    ngx_uint_t   config_profile_registered;
+
     ngx_int_t abort_websockets_on_process_shutdown;
     ngx_uint_t app_file_descriptor_ulimit;
+    ngx_int_t autoscale;
     ngx_array_t *base_uris;
+    ngx_int_t blue_green_restart;
     ngx_uint_t core_file_descriptor_ulimit;
     ngx_int_t debugger;
     ngx_int_t disable_security_update_check;
@@ -69,6 +76,7 @@ typedef struct {
     ngx_int_t min_instances;
     ngx_int_t request_queue_overflow_status_code;
     ngx_int_t socket_backlog;
+    ngx_int_t spawn_concurrency;
     ngx_int_t start_timeout;
     ngx_int_t sticky_sessions;
     ngx_array_t *union_station_filters;
@@ -84,6 +92,7 @@ typedef struct {
     ngx_str_t nodejs;
     ngx_str_t python;
     ngx_str_t restart_dir;
+    ngx_str_t restart_warmup_path;
     ngx_str_t ruby;
     ngx_str_t security_update_check_proxy;
     ngx_str_t spawn_method;
@@ -177,6 +177,18 @@ generated_merge_part(passenger_loc_conf_t *conf, passenger_loc_conf_t *prev, ngx
     ngx_conf_merge_value(conf->force_max_concurrent_requests_per_process,
         prev->force_max_concurrent_requests_per_process,
         NGX_CONF_UNSET);
+    ngx_conf_merge_value(conf->spawn_concurrency,
+        prev->spawn_concurrency,
+        NGX_CONF_UNSET);
+    ngx_conf_merge_value(conf->blue_green_restart,
+        prev->blue_green_restart,
+        NGX_CONF_UNSET);
+    ngx_conf_merge_str_value(conf->restart_warmup_path,
+        prev->restart_warmup_path,
+        NULL);
+    ngx_conf_merge_value(conf->autoscale,
+        prev->autoscale,
+        NGX_CONF_UNSET);
 
     return 1;
 }
@@ -235,6 +235,27 @@
     :context   => ["RSRC_CONF"],
     :desc      => "Minimum user id starting from which entering LVE and CageFS is allowed."
   },
+  {
+    :name      => "PassengerSpawnConcurrency",
+    :type      => :integer,
+    :min_value => 1,
+    :desc      => "The maximum number of processes that may be spawned at the same time for an application."
+  },
+  {
+    :name => "PassengerBlueGreenRestart",
+    :type => :flag,
+    :desc => "Whether to spawn an application's new processes before shutting down the old ones when restarting it."
+  },
+  {
+    :name => "PassengerRestartWarmupPath",
+    :type => :string,
+    :desc => "The path to request from every new process during a blue/green restart, before it receives traffic."
+  },
+  {
+    :name => "PassengerAutoscale",
+    :type => :flag,
+    :desc => "Whether to adjust an application's minimum number of processes to the load it receives."
+  },
 
 
   ##### Aliases #####
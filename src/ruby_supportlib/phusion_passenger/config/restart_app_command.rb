@@ -92,6 +92,11 @@ def self.create_option_parser(options)
               abort "--rolling-restart is only available in #{PROGRAM_NAME} Enterprise: #{ENTERPRISE_URL}"
             end
           end
+          opts.on("--blue-green-restart", "Spawn the new processes before shutting#{nl}" +
+            "down the old ones, so that the app keeps#{nl}" +
+            "its capacity during the restart") do |value|
+            options[:blue_green_restart] = true
+          end
           opts.on("--ignore-app-not-running", "Exit successfully if the specified#{nl}" +
             "application is not currently running. The#{nl}" +
             "default is to exit with an error") do
@@ -216,7 +221,13 @@ def select_app_group_name_by_app_root_regex(app_root)
       end
 
       def perform_restart
-        restart_method = @options[:rolling_restart] ? "rolling" : "blocking"
+        if @options[:rolling_restart]
+          restart_method = "rolling"
+        elsif @options[:blue_green_restart]
+          restart_method = "blue_green"
+        else
+          restart_method = "blocking"
+        end
         @groups.each do |group|
           group_name = group.elements["name"].text
           puts "Restarting #{group_name}"
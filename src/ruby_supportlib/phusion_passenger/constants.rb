@@ -51,6 +51,8 @@ module SharedConstants
     DEFAULT_MAX_POOL_SIZE = 6
     DEFAULT_POOL_IDLE_TIME = 300
     DEFAULT_MAX_PRELOADER_IDLE_TIME = 5 * 60
+    DEFAULT_MAX_CONCURRENT_SPAWNS = 4
+    DEFAULT_MAX_CONFIG_PROFILES = 1024
     DEFAULT_START_TIMEOUT = 90_000
     DEFAULT_WEB_APP_USER = "nobody"
     DEFAULT_APP_ENV = "production"
@@ -61,6 +63,9 @@ module SharedConstants
     DEFAULT_STICKY_SESSIONS_COOKIE_NAME = "_passenger_route"
     DEFAULT_APP_THREAD_COUNT = 1
     DEFAULT_RESPONSE_BUFFER_HIGH_WATERMARK = 1024 * 1024 * 128
+    DEFAULT_RESPONSE_SPLICING_THRESHOLD = 1024 * 128
+    DEFAULT_TURBOCACHE_MAX_SIZE = 1024 * 1024 * 32
+    DEFAULT_TURBOCACHE_SHARDS = 16
     DEFAULT_MAX_REQUEST_QUEUE_SIZE = 100
     DEFAULT_STAT_THROTTLE_RATE = 10
     DEFAULT_ANALYTICS_LOG_USER = DEFAULT_WEB_APP_USER
@@ -70,6 +75,8 @@ module SharedConstants
     DEFAULT_UNION_STATION_GATEWAY_PORT = 443
     DEFAULT_HTTP_SERVER_LISTEN_ADDRESS = "tcp://127.0.0.1:3000"
     DEFAULT_UST_ROUTER_LISTEN_ADDRESS = "tcp://127.0.0.1:9344"
+    DEFAULT_UST_ROUTER_SPOOL_SIZE = 1024 * 1024 * 32
+    DEFAULT_UST_ROUTER_MAX_CONCURRENT_UPLOADS = 4
     DEFAULT_LVE_MIN_UID = 500
 
     # Size limits
@@ -85,11 +92,13 @@ module SharedConstants
     # high concurrency with low mem overhead. On the upload side there is a penalty 
     # but there's no real average upload size anyway so we choose mem safety instead. 
     DEFAULT_FILE_BUFFERED_CHANNEL_THRESHOLD = 1024 * 128
+    DEFAULT_BUFFER_FILE_POOL_SIZE = 16
     SERVER_KIT_MAX_SERVER_ENDPOINTS = 4
 
     # Time limits
     PROCESS_SHUTDOWN_TIMEOUT = 60 # In seconds
     PROCESS_SHUTDOWN_TIMEOUT_DISPLAY = "1 minute"
+    APP_CONNECTION_IDLE_TIMEOUT = 30 # In seconds
 
     # Versions
     PASSENGER_VERSION = PhusionPassenger::VERSION_STRING
@@ -342,6 +342,22 @@
     :name   => 'passenger_force_max_concurrent_requests_per_process',
     :type   => :integer
   },
+  {
+    :name   => 'passenger_spawn_concurrency',
+    :type   => :integer
+  },
+  {
+    :name   => 'passenger_blue_green_restart',
+    :type   => :flag
+  },
+  {
+    :name   => 'passenger_restart_warmup_path',
+    :type   => :string
+  },
+  {
+    :name   => 'passenger_autoscale',
+    :type   => :flag
+  },
 
   ###### Enterprise features ######
   {
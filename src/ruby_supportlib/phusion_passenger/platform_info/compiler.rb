@@ -505,6 +505,17 @@ def self.has_accept4?
     end
     memoize :has_accept4?, true
 
+    def self.has_io_uring?
+      return try_compile("Checking for io_uring", :c, %Q{
+        #include <linux/io_uring.h>
+        #include <sys/syscall.h>
+        static int foo = __NR_io_uring_setup + __NR_io_uring_enter +
+          __NR_io_uring_register + IORING_OP_READ + IORING_OP_WRITE +
+          IORING_REGISTER_PROBE + IORING_REGISTER_EVENTFD;
+      })
+    end
+    memoize :has_io_uring?, true
+
     # C compiler flags that should be passed in order to enable debugging information.
     def self.debugging_cflags
       # According to OpenBSD's pthreads man page, pthreads do not work
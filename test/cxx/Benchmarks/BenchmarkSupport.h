@@ -0,0 +1,82 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+#ifndef _PASSENGER_BENCHMARK_SUPPORT_H_
+#define _PASSENGER_BENCHMARK_SUPPORT_H_
+
+#include <boost/cstdint.hpp>
+#include <cstdio>
+#include <Utils/SystemTime.h>
+
+namespace Passenger {
+namespace BenchmarkSupport {
+
+
+/**
+ * Prevents the compiler from optimizing away a computed value.
+ */
+template<typename T>
+inline void
+doNotOptimize(const T &value) {
+	__asm__ __volatile__("" : : "g"(value) : "memory");
+}
+
+/**
+ * Measures wall clock time between construction and `stop()`, and prints
+ * the result as a line of the form
+ * "<name>: <n> iterations, <usec> usec total, <ns> ns/op".
+ */
+class Stopwatch {
+private:
+	const char *name;
+	MonotonicTimeUsec startTime;
+
+public:
+	Stopwatch(const char *_name)
+		: name(_name),
+		  startTime(SystemTime::getMonotonicUsec())
+		{ }
+
+	/**
+	 * Returns the average number of nanoseconds per iteration.
+	 */
+	double stop(boost::uint64_t iterations) {
+		MonotonicTimeUsec elapsed = SystemTime::getMonotonicUsec() - startTime;
+		double nsPerOp = (iterations == 0) ? 0 : elapsed * 1000.0 / iterations;
+		printf("%-48s: %10llu iterations, %9llu usec total, %10.1f ns/op\n",
+			name,
+			(unsigned long long) iterations,
+			(unsigned long long) elapsed,
+			nsPerOp);
+		fflush(stdout);
+		return nsPerOp;
+	}
+};
+
+
+} // namespace BenchmarkSupport
+} // namespace Passenger
+
+#endif /* _PASSENGER_BENCHMARK_SUPPORT_H_ */
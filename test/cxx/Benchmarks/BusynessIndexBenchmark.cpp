@@ -0,0 +1,169 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Compares the cost of routing a request to the least busy process using
+ * a linear scan over all busyness levels (the old Group implementation)
+ * versus using BusynessIndex.
+ *
+ * The simulated workload keeps, on average, 2 sessions open per process.
+ * Every iteration routes one new session to the least busy process and
+ * closes one randomly chosen open session.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <Core/ApplicationPool/BusynessIndex.h>
+#include <boost/container/vector.hpp>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Passenger;
+using namespace Passenger::ApplicationPool2;
+using namespace Passenger::BenchmarkSupport;
+
+static const unsigned int PROCESS_COUNTS[] = { 8, 64, 512, 4096 };
+static const unsigned int SESSIONS_PER_PROCESS = 2;
+static const boost::uint64_t ITERATIONS = 2000000;
+
+
+class LinearScanIndex {
+private:
+	boost::container::vector<int> levels;
+
+public:
+	void push_back(int busyness) {
+		levels.push_back(busyness);
+	}
+
+	void update(unsigned int index, int busyness) {
+		levels[index] = busyness;
+	}
+
+	int operator[](unsigned int index) const {
+		return levels[index];
+	}
+
+	unsigned int lowest() const {
+		int lowestBusyness = levels[0];
+		unsigned int result = 0;
+		for (unsigned int i = 1; i < levels.size(); i++) {
+			if (levels[i] < lowestBusyness) {
+				lowestBusyness = levels[i];
+				result = i;
+			}
+		}
+		return result;
+	}
+};
+
+/** A simple, deterministic xorshift random number generator. */
+class Random {
+private:
+	boost::uint32_t state;
+
+public:
+	Random()
+		: state(2463534242u)
+		{ }
+
+	boost::uint32_t next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+};
+
+template<typename Index>
+static boost::uint64_t
+simulate(Index &index, unsigned int nprocesses, boost::uint64_t iterations) {
+	boost::container::vector<unsigned int> openSessions;
+	Random random;
+	boost::uint64_t checksum = 0;
+
+	for (unsigned int i = 0; i < nprocesses; i++) {
+		index.push_back(0);
+	}
+	for (unsigned int i = 0; i < nprocesses * SESSIONS_PER_PROCESS; i++) {
+		unsigned int process = index.lowest();
+		index.update(process, index[process] + 1);
+		openSessions.push_back(process);
+	}
+
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		unsigned int process = index.lowest();
+		index.update(process, index[process] + 1);
+		openSessions.push_back(process);
+		checksum += process;
+
+		unsigned int victim = random.next() % openSessions.size();
+		process = openSessions[victim];
+		openSessions[victim] = openSessions.back();
+		openSessions.pop_back();
+		index.update(process, index[process] - 1);
+	}
+
+	return checksum;
+}
+
+int
+main() {
+	SystemTime::initialize();
+	printf("Routing to the least busy process (%llu iterations per run)\n\n",
+		(unsigned long long) ITERATIONS);
+
+	for (unsigned int i = 0; i < sizeof(PROCESS_COUNTS) / sizeof(unsigned int); i++) {
+		unsigned int n = PROCESS_COUNTS[i];
+		char name[64];
+		boost::uint64_t linearChecksum, indexedChecksum;
+		double linearNs, indexedNs;
+
+		{
+			LinearScanIndex index;
+			snprintf(name, sizeof(name), "%4u processes, linear scan", n);
+			Stopwatch stopwatch(name);
+			linearChecksum = simulate(index, n, ITERATIONS);
+			linearNs = stopwatch.stop(ITERATIONS);
+			doNotOptimize(linearChecksum);
+		}
+		{
+			BusynessIndex index;
+			snprintf(name, sizeof(name), "%4u processes, BusynessIndex", n);
+			Stopwatch stopwatch(name);
+			indexedChecksum = simulate(index, n, ITERATIONS);
+			indexedNs = stopwatch.stop(ITERATIONS);
+			doNotOptimize(indexedChecksum);
+		}
+
+		if (linearChecksum != indexedChecksum) {
+			fprintf(stderr, "ERROR: both strategies routed sessions differently!\n");
+			return 1;
+		}
+		printf("%4u processes, speedup: %.2fx\n\n", n, linearNs / indexedNs);
+	}
+
+	return 0;
+}
@@ -0,0 +1,389 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * A closed-loop HTTP load generator for `rake benchmark:core`.
+ *
+ * Opens a number of connections to a Passenger core, each driven by its own
+ * thread that sends a request, waits for the complete response and
+ * immediately sends the next one. After a warmup period (during which the
+ * core spawns the app) it measures for a fixed duration, then prints the
+ * throughput and exact latency percentiles as a JSON object on stdout.
+ * It exits with a non-zero status if no request succeeded.
+ *
+ * Only responses with a Content-Length, or that end by closing the
+ * connection, are supported. That is enough for the core's benchmark
+ * responses and for the test/stub/benchmark app.
+ */
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <oxt/system_calls.hpp>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <jsoncpp/json.h>
+#include <Exceptions.h>
+#include <FileDescriptor.h>
+#include <StaticString.h>
+#include <Utils/IOUtils.h>
+#include <Utils/StrIntUtils.h>
+#include <Utils/SystemTime.h>
+
+using namespace std;
+using namespace Passenger;
+
+static const unsigned int SOCKET_TIMEOUT_SEC = 30;
+static const unsigned int READ_BUFFER_SIZE = 16 * 1024;
+
+
+struct Options {
+	string address;
+	string path;
+	unsigned int connections;
+	double warmup;
+	double duration;
+	bool keepAlive;
+
+	Options()
+		: path("/"),
+		  connections(8),
+		  warmup(2),
+		  duration(5),
+		  keepAlive(true)
+		{ }
+};
+
+struct WorkerResult {
+	/** Latencies of the requests completed in the measurement window, in usec. */
+	vector<boost::uint32_t> latencies;
+	boost::uint64_t errors;
+	boost::uint64_t connectionsOpened;
+	string lastError;
+
+	WorkerResult()
+		: errors(0),
+		  connectionsOpened(0)
+		{ }
+};
+
+class ResponseError: public std::runtime_error {
+public:
+	ResponseError(const string &message)
+		: std::runtime_error(message)
+		{ }
+};
+
+
+static Options options;
+static string request;
+static MonotonicTimeUsec measureBeginTime;
+static MonotonicTimeUsec measureEndTime;
+
+
+static void
+usage() {
+	printf("Usage: CoreLoadGenerator --connect ADDRESS [OPTIONS...]\n");
+	printf("Sends HTTP requests to ADDRESS (tcp://HOST:PORT or unix:PATH) and\n");
+	printf("prints the throughput and latency as JSON.\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  --path PATH           Request path. Default: /\n");
+	printf("  --connections NUMBER  Number of concurrent connections. Default: 8\n");
+	printf("  --warmup SECONDS      Time to send requests before measuring. Default: 2\n");
+	printf("  --duration SECONDS    Time to measure. Default: 5\n");
+	printf("  --no-keepalive        Open a new connection for every request\n");
+}
+
+static void
+parseOptions(int argc, char *argv[]) {
+	int i = 1;
+	while (i < argc) {
+		string arg = argv[i];
+		if (arg == "--no-keepalive") {
+			options.keepAlive = false;
+			i++;
+		} else if (i + 1 >= argc) {
+			usage();
+			exit(1);
+		} else if (arg == "--connect") {
+			options.address = argv[i + 1];
+			i += 2;
+		} else if (arg == "--path") {
+			options.path = argv[i + 1];
+			i += 2;
+		} else if (arg == "--connections") {
+			options.connections = std::max(1, atoi(argv[i + 1]));
+			i += 2;
+		} else if (arg == "--warmup") {
+			options.warmup = atof(argv[i + 1]);
+			i += 2;
+		} else if (arg == "--duration") {
+			options.duration = atof(argv[i + 1]);
+			i += 2;
+		} else {
+			usage();
+			exit(1);
+		}
+	}
+	if (options.address.empty() || options.duration <= 0) {
+		usage();
+		exit(1);
+	}
+}
+
+static string
+buildRequest() {
+	return "GET " + options.path + " HTTP/1.1\r\n"
+		"Host: localhost\r\n"
+		"User-Agent: CoreLoadGenerator\r\n"
+		"Accept: */*\r\n"
+		+ (options.keepAlive ? "" : "Connection: close\r\n")
+		+ "\r\n";
+}
+
+static FileDescriptor
+openConnection() {
+	FileDescriptor fd(connectToServer(options.address, __FILE__, __LINE__),
+		__FILE__, __LINE__);
+	struct timeval tv;
+	tv.tv_sec = SOCKET_TIMEOUT_SEC;
+	tv.tv_usec = 0;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+	return fd;
+}
+
+/**
+ * Finds the value of the given header (whose name must be lowercase) in a
+ * response header block. Returns an empty string if there is no such header.
+ */
+static StaticString
+findHeader(const StaticString &headers, const StaticString &name) {
+	const char *pos = headers.data();
+	const char *end = headers.data() + headers.size();
+
+	// Skip the status line.
+	pos = (const char *) memchr(pos, '\n', end - pos);
+	while (pos != NULL && pos + 1 < end) {
+		pos++;
+		const char *lineEnd = (const char *) memchr(pos, '\n', end - pos);
+		if (lineEnd == NULL) {
+			lineEnd = end;
+		}
+		if ((size_t) (lineEnd - pos) > name.size()
+		 && pos[name.size()] == ':'
+		 && strncasecmp(pos, name.data(), name.size()) == 0)
+		{
+			const char *value = pos + name.size() + 1;
+			const char *valueEnd = lineEnd;
+			while (value < valueEnd && *value == ' ') {
+				value++;
+			}
+			while (valueEnd > value && (valueEnd[-1] == '\r' || valueEnd[-1] == ' ')) {
+				valueEnd--;
+			}
+			return StaticString(value, valueEnd - value);
+		}
+		pos = lineEnd;
+	}
+	return StaticString();
+}
+
+/**
+ * Reads one complete response. Returns whether the connection may be
+ * reused for the next request.
+ */
+static bool
+readResponse(int fd, string &buffer) {
+	char tmp[READ_BUFFER_SIZE];
+	string::size_type headerEnd;
+	ssize_t ret;
+
+	buffer.clear();
+	while ((headerEnd = buffer.find("\r\n\r\n")) == string::npos) {
+		ret = syscalls::read(fd, tmp, sizeof(tmp));
+		if (ret == -1) {
+			int e = errno;
+			throw SystemException("Cannot read response", e);
+		} else if (ret == 0) {
+			throw ResponseError("Connection closed before the response headers were complete");
+		}
+		buffer.append(tmp, ret);
+	}
+	headerEnd += 4;
+
+	StaticString headers(buffer.data(), headerEnd);
+	if (!startsWith(headers, "HTTP/1.1 200 ") && !startsWith(headers, "HTTP/1.0 200 ")) {
+		throw ResponseError("Unexpected response: "
+			+ headers.substr(0, headers.find('\r')).toString());
+	}
+
+	StaticString contentLength = findHeader(headers, "content-length");
+	bool closes = options.keepAlive
+		? findHeader(headers, "connection") == "close"
+		: true;
+
+	if (!contentLength.empty()) {
+		string::size_type total = headerEnd + stringToULL(contentLength);
+		while (buffer.size() < total) {
+			ret = syscalls::read(fd, tmp, sizeof(tmp));
+			if (ret == -1) {
+				int e = errno;
+				throw SystemException("Cannot read response body", e);
+			} else if (ret == 0) {
+				throw ResponseError("Connection closed before the response body was complete");
+			}
+			buffer.append(tmp, ret);
+		}
+		return !closes;
+	} else if (closes) {
+		do {
+			ret = syscalls::read(fd, tmp, sizeof(tmp));
+		} while (ret > 0);
+		if (ret == -1) {
+			int e = errno;
+			throw SystemException("Cannot read response body", e);
+		}
+		return false;
+	} else {
+		throw ResponseError("Response has neither a Content-Length nor ends the connection");
+	}
+}
+
+static void
+runWorker(WorkerResult *result) {
+	FileDescriptor fd;
+	string buffer;
+	MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+
+	while (now < measureEndTime) {
+		MonotonicTimeUsec startTime = now;
+		try {
+			if (fd == -1) {
+				fd = openConnection();
+				result->connectionsOpened++;
+			}
+			writeExact(fd, request);
+			if (!readResponse(fd, buffer)) {
+				fd.close();
+			}
+			now = SystemTime::getMonotonicUsec();
+			if (startTime >= measureBeginTime && now <= measureEndTime) {
+				result->latencies.push_back(now - startTime);
+			}
+		} catch (const std::exception &e) {
+			fd.close();
+			now = SystemTime::getMonotonicUsec();
+			if (now >= measureBeginTime && now <= measureEndTime) {
+				result->errors++;
+				result->lastError = e.what();
+			}
+			// Don't spin if the server is not accepting connections.
+			syscalls::usleep(1000);
+			now = SystemTime::getMonotonicUsec();
+		}
+	}
+}
+
+static Json::UInt64
+percentile(const vector<boost::uint32_t> &sorted, double p) {
+	if (sorted.empty()) {
+		return 0;
+	} else {
+		size_t index = (size_t) (p / 100.0 * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+}
+
+int
+main(int argc, char *argv[]) {
+	parseOptions(argc, argv);
+	request = buildRequest();
+
+	MonotonicTimeUsec now = SystemTime::getMonotonicUsec();
+	measureBeginTime = now + (MonotonicTimeUsec) (options.warmup * 1000000);
+	measureEndTime = measureBeginTime + (MonotonicTimeUsec) (options.duration * 1000000);
+
+	vector<WorkerResult> results(options.connections);
+	boost::thread_group threads;
+	for (unsigned int i = 0; i < options.connections; i++) {
+		threads.create_thread(boost::bind(runWorker, &results[i]));
+	}
+	threads.join_all();
+
+	vector<boost::uint32_t> latencies;
+	Json::UInt64 errors = 0, connectionsOpened = 0;
+	string lastError;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		latencies.insert(latencies.end(), results[i].latencies.begin(),
+			results[i].latencies.end());
+		errors += results[i].errors;
+		connectionsOpened += results[i].connectionsOpened;
+		if (!results[i].lastError.empty()) {
+			lastError = results[i].lastError;
+		}
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	boost::uint64_t latencySum = 0;
+	for (size_t i = 0; i < latencies.size(); i++) {
+		latencySum += latencies[i];
+	}
+
+	Json::Value doc;
+	doc["connections"] = options.connections;
+	doc["keepalive"] = options.keepAlive;
+	doc["duration_sec"] = options.duration;
+	doc["requests"] = (Json::UInt64) latencies.size();
+	doc["errors"] = errors;
+	doc["connections_opened"] = connectionsOpened;
+	doc["throughput_rps"] = latencies.size() / options.duration;
+	doc["latency_usec"]["avg"] = latencies.empty()
+		? 0.0
+		: (double) latencySum / latencies.size();
+	doc["latency_usec"]["p50"] = percentile(latencies, 50);
+	doc["latency_usec"]["p99"] = percentile(latencies, 99);
+	doc["latency_usec"]["p999"] = percentile(latencies, 99.9);
+	doc["latency_usec"]["max"] = latencies.empty()
+		? (Json::UInt64) 0
+		: (Json::UInt64) latencies.back();
+	if (!lastError.empty()) {
+		doc["last_error"] = lastError;
+	}
+
+	printf("%s", doc.toStyledString().c_str());
+	return latencies.empty() ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Simulates thousands of slow readers: every FileBufferedChannel receives
+ * more data than its consumer accepts, so that all data is spilled to disk,
+ * after which the consumers catch up and all data is read back from disk.
+ * Compares libuv's thread pool with io_uring as the file I/O backend.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <boost/bind.hpp>
+#include <oxt/initialize.hpp>
+#include <oxt/system_calls.hpp>
+#include <BackgroundEventLoop.cpp>
+#include <ServerKit/Context.h>
+#include <ServerKit/FileBufferedChannel.h>
+#include <ServerKit/FileIoRing.h>
+#include <Logging.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace Passenger;
+using namespace Passenger::ServerKit;
+using namespace Passenger::BenchmarkSupport;
+
+static const unsigned int CHANNEL_COUNT = 2000;
+static const unsigned int CHUNKS_PER_CHANNEL = 8;
+static const unsigned int CHUNK_SIZE = 2048;
+
+
+struct SlowReader: public Hooks {
+	FileBufferedChannel channel;
+	boost::uint64_t received;
+	bool consuming;
+
+	SlowReader(Context *context)
+		: channel(context),
+		  received(0),
+		  consuming(false)
+	{
+		Hooks::impl = NULL;
+		Hooks::userData = NULL;
+		channel.setHooks(this);
+		channel.setDataCallback(onData);
+	}
+
+	static Channel::Result onData(Channel *_channel, const MemoryKit::mbuf &buffer,
+		int errcode)
+	{
+		FileBufferedChannel *channel = reinterpret_cast<FileBufferedChannel *>(_channel);
+		SlowReader *self = static_cast<SlowReader *>(channel->getHooks());
+		if (self->consuming) {
+			self->received += buffer.size();
+			return Channel::Result(buffer.size(), false);
+		} else {
+			// Consume later, forcing subsequent data to be buffered.
+			return Channel::Result(-1, false);
+		}
+	}
+};
+
+struct Run {
+	Context *context;
+	vector<SlowReader *> readers;
+	bool done;
+
+	void feedAll() {
+		for (unsigned int i = 0; i < readers.size(); i++) {
+			for (unsigned int j = 0; j < CHUNKS_PER_CHANNEL; j++) {
+				MemoryKit::mbuf buffer = MemoryKit::mbuf_get(&context->mbuf_pool);
+				memset(buffer.start, 'x', CHUNK_SIZE);
+				readers[i]->channel.feed(MemoryKit::mbuf(buffer, 0, CHUNK_SIZE));
+			}
+		}
+	}
+
+	void checkSpilled() {
+		done = true;
+		for (unsigned int i = 0; i < readers.size() && done; i++) {
+			done = readers[i]->channel.getMode() == FileBufferedChannel::IN_FILE_MODE
+				&& readers[i]->channel.getWriterState() == FileBufferedChannel::WS_INACTIVE
+				&& readers[i]->channel.getBytesBuffered() == 0;
+		}
+	}
+
+	void consumeAll() {
+		for (unsigned int i = 0; i < readers.size(); i++) {
+			readers[i]->consuming = true;
+			readers[i]->received = CHUNK_SIZE;
+			readers[i]->channel.consumed(CHUNK_SIZE, false);
+		}
+	}
+
+	void checkDrained() {
+		done = true;
+		for (unsigned int i = 0; i < readers.size() && done; i++) {
+			done = readers[i]->received == CHUNK_SIZE * CHUNKS_PER_CHANNEL;
+		}
+	}
+
+	void destroyAll() {
+		for (unsigned int i = 0; i < readers.size(); i++) {
+			readers[i]->channel.deinitialize();
+			delete readers[i];
+		}
+		readers.clear();
+	}
+};
+
+static void
+waitUntil(BackgroundEventLoop &bg, Run &run, void (Run::*check)()) {
+	do {
+		usleep(1000);
+		bg.safe->runSync(boost::bind(check, &run));
+	} while (!run.done);
+}
+
+static void
+benchmark(const char *name, bool useRing) {
+	BackgroundEventLoop bg(false, true);
+	Context context(bg.safe, bg.libuv_loop);
+	FileIoRing ring(bg.libev_loop);
+	Run run;
+	char spillName[64], drainName[64];
+
+	if (useRing) {
+		if (!ring.initialize()) {
+			printf("%-48s: not supported: %s\n", name,
+				ring.getInitializationError().c_str());
+			return;
+		}
+		context.fileIoRing = &ring;
+	}
+	context.defaultFileBufferedChannelConfig.threshold = 1;
+	run.context = &context;
+	for (unsigned int i = 0; i < CHANNEL_COUNT; i++) {
+		run.readers.push_back(new SlowReader(&context));
+	}
+	snprintf(spillName, sizeof(spillName), "%s: spill to disk", name);
+	snprintf(drainName, sizeof(drainName), "%s: read back from disk", name);
+
+	bg.start();
+	{
+		Stopwatch stopwatch(spillName);
+		bg.safe->runSync(boost::bind(&Run::feedAll, &run));
+		waitUntil(bg, run, &Run::checkSpilled);
+		stopwatch.stop(CHANNEL_COUNT * CHUNKS_PER_CHANNEL);
+	}
+	{
+		Stopwatch stopwatch(drainName);
+		bg.safe->runSync(boost::bind(&Run::consumeAll, &run));
+		waitUntil(bg, run, &Run::checkDrained);
+		stopwatch.stop(CHANNEL_COUNT * CHUNKS_PER_CHANNEL);
+	}
+	if (useRing) {
+		printf("%-48s: %llu io_uring_enter() calls\n", name,
+			(unsigned long long) ring.getTotalSubmitCalls());
+	}
+	bg.safe->runSync(boost::bind(&Run::destroyAll, &run));
+	bg.stop();
+}
+
+int
+main() {
+	oxt::initialize();
+	oxt::setup_syscall_interruption_support();
+	SystemTime::initialize();
+	setLogLevel(LVL_WARN);
+	printf("%u channels with slow readers, %u chunks of %u bytes each "
+		"(an iteration is one chunk)\n\n",
+		CHANNEL_COUNT, CHUNKS_PER_CHANNEL, CHUNK_SIZE);
+	benchmark("libuv", false);
+	benchmark("io_uring", true);
+	oxt::shutdown();
+	return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Measures how fast each Hasher implementation hashes typical header names,
+ * both as-is and case-insensitively, and a typical turbocache key. The
+ * "downcase, then hash" runs show what HttpHeaderParser used to do before
+ * hashers could fold case themselves.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <Utils/Hasher.h>
+#include <Utils/StrIntUtils.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace Passenger;
+using namespace Passenger::BenchmarkSupport;
+
+static const boost::uint64_t ITERATIONS = 10000000;
+
+static const char * const HEADER_NAMES[] = {
+	"Host", "Connection", "Cache-Control", "Upgrade-Insecure-Requests",
+	"User-Agent", "Accept", "Referer", "Accept-Encoding", "Accept-Language",
+	"Cookie", "If-None-Match", NULL
+};
+
+static const char CACHE_KEY[] =
+	"https://www.example.com/articles/2017/06/how-we-made-our-app-faster";
+
+template<typename Hash>
+static boost::uint64_t
+hashHeaderNames(boost::uint64_t iterations) {
+	unsigned int sizes[sizeof(HEADER_NAMES) / sizeof(HEADER_NAMES[0])];
+	boost::uint64_t result = 0;
+
+	for (unsigned int i = 0; HEADER_NAMES[i] != NULL; i++) {
+		sizes[i] = strlen(HEADER_NAMES[i]);
+	}
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		for (unsigned int j = 0; HEADER_NAMES[j] != NULL; j++) {
+			Hash h;
+			h.update(HEADER_NAMES[j], sizes[j]);
+			result += h.finalize();
+		}
+		doNotOptimize(result);
+	}
+	return result;
+}
+
+template<typename Hash>
+static boost::uint64_t
+downcaseAndHashHeaderNames(boost::uint64_t iterations) {
+	unsigned int sizes[sizeof(HEADER_NAMES) / sizeof(HEADER_NAMES[0])];
+	char buffer[64];
+	boost::uint64_t result = 0;
+
+	for (unsigned int i = 0; HEADER_NAMES[i] != NULL; i++) {
+		sizes[i] = strlen(HEADER_NAMES[i]);
+	}
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		for (unsigned int j = 0; HEADER_NAMES[j] != NULL; j++) {
+			Hash h;
+			convertLowerCase((const unsigned char *) HEADER_NAMES[j],
+				(unsigned char *) buffer, sizes[j]);
+			h.update(buffer, sizes[j]);
+			result += h.finalize();
+		}
+		doNotOptimize(result);
+	}
+	return result;
+}
+
+template<typename Hash>
+static boost::uint64_t
+hashHeaderNamesLowerCase(boost::uint64_t iterations) {
+	unsigned int sizes[sizeof(HEADER_NAMES) / sizeof(HEADER_NAMES[0])];
+	boost::uint64_t result = 0;
+
+	for (unsigned int i = 0; HEADER_NAMES[i] != NULL; i++) {
+		sizes[i] = strlen(HEADER_NAMES[i]);
+	}
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		for (unsigned int j = 0; HEADER_NAMES[j] != NULL; j++) {
+			Hash h;
+			h.updateLowerCase(HEADER_NAMES[j], sizes[j]);
+			result += h.finalize();
+		}
+		doNotOptimize(result);
+	}
+	return result;
+}
+
+template<typename Hash>
+static boost::uint64_t
+hashCacheKey(boost::uint64_t iterations) {
+	boost::uint64_t result = 0;
+
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		Hash h;
+		h.update(CACHE_KEY, sizeof(CACHE_KEY) - 1);
+		result += h.finalize();
+		doNotOptimize(result);
+	}
+	return result;
+}
+
+template<typename Hash>
+static void
+benchmark(const char *name) {
+	char stopwatchName[64];
+	boost::uint64_t downcased, folded;
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, header names", name);
+	Stopwatch s1(stopwatchName);
+	doNotOptimize(hashHeaderNames<Hash>(ITERATIONS));
+	s1.stop(ITERATIONS);
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, downcase, then hash", name);
+	Stopwatch s2(stopwatchName);
+	downcased = downcaseAndHashHeaderNames<Hash>(ITERATIONS);
+	s2.stop(ITERATIONS);
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, updateLowerCase()", name);
+	Stopwatch s3(stopwatchName);
+	folded = hashHeaderNamesLowerCase<Hash>(ITERATIONS);
+	s3.stop(ITERATIONS);
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, cache key", name);
+	Stopwatch s4(stopwatchName);
+	doNotOptimize(hashCacheKey<Hash>(ITERATIONS));
+	s4.stop(ITERATIONS);
+
+	if (downcased != folded) {
+		fprintf(stderr, "ERROR: updateLowerCase() disagrees with convertLowerCase()!\n");
+	}
+	printf("\n");
+}
+
+int
+main() {
+	SystemTime::initialize();
+	printf("Hashing strings (%llu iterations per run, 11 header names per iteration)\n\n",
+		(unsigned long long) ITERATIONS);
+	benchmark<JenkinsHash>("JenkinsHash");
+	benchmark<MurmurHash3>("MurmurHash3");
+	return 0;
+}
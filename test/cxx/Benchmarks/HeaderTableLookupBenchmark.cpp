@@ -0,0 +1,176 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Measures how fast the Core controller's per-request header lookups are,
+ * comparing lookups by name (probing the HeaderTable) against lookups by
+ * WellKnownHeaderId. Uses the header sets of a typical browser request and
+ * a typical Rails response, and the lookups that the controller and the
+ * turbocache perform on them.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <ServerKit/HeaderTable.h>
+#include <ServerKit/WellKnownHeaders.h>
+#include <MemoryKit/palloc.h>
+#include <cstdio>
+
+using namespace Passenger;
+using namespace Passenger::ServerKit;
+using namespace Passenger::BenchmarkSupport;
+
+static const boost::uint64_t ITERATIONS = 10000000;
+
+static const char * const REQUEST_HEADERS[][2] = {
+	{ "Host", "www.example.com" },
+	{ "Connection", "keep-alive" },
+	{ "Upgrade-Insecure-Requests", "1" },
+	{ "User-Agent", "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_12_5)" },
+	{ "Accept", "text/html,application/xhtml+xml,application/xml;q=0.9" },
+	{ "Referer", "https://www.example.com/articles?page=2" },
+	{ "Accept-Encoding", "gzip, deflate, br" },
+	{ "Accept-Language", "en-US,en;q=0.8,nl;q=0.6" },
+	{ "Cookie", "_ga=GA1.2.1234567890.1498123456; _session_id=4f1e2d3c4b5a6978" },
+	{ "If-None-Match", "W/\"5e8a4c1b9d2f7e3a6c0b8d4f2e1a9c7b\"" },
+	{ NULL, NULL }
+};
+
+static const char * const RESPONSE_HEADERS[][2] = {
+	{ "Content-Type", "text/html; charset=utf-8" },
+	{ "ETag", "W/\"5e8a4c1b9d2f7e3a6c0b8d4f2e1a9c7c\"" },
+	{ "Cache-Control", "max-age=0, private, must-revalidate" },
+	{ "Set-Cookie", "_session_id=4f1e2d3c4b5a6978; path=/; HttpOnly" },
+	{ "X-Request-Id", "0f8fad5b-d9cb-469f-a165-70867728950e" },
+	{ "X-Runtime", "0.012345" },
+	{ "X-Frame-Options", "SAMEORIGIN" },
+	{ "X-Content-Type-Options", "nosniff" },
+	{ NULL, NULL }
+};
+
+// Request headers looked up by InitRequest, CheckoutSession, SendRequest
+// and ResponseCache.
+static const WellKnownHeaderId REQUEST_LOOKUPS[] = {
+	WKH_COOKIE, WKH_HOST, WKH_EXPECT, WKH_CONTENT_TYPE, WKH_CONTENT_LENGTH,
+	WKH_CACHE_CONTROL, WKH_PRAGMA, WKH_AUTHORIZATION
+};
+
+// Response headers looked up by HttpHeaderParser, ForwardResponse and
+// ResponseCache.
+static const WellKnownHeaderId RESPONSE_LOOKUPS[] = {
+	WKH_X_SENDFILE, WKH_X_ACCEL_REDIRECT, WKH_DATE, WKH_SET_COOKIE,
+	WKH_CACHE_CONTROL, WKH_VARY, WKH_WWW_AUTHENTICATE, WKH_EXPIRES,
+	WKH_LAST_MODIFIED
+};
+
+static const unsigned int REQUEST_LOOKUP_COUNT =
+	sizeof(REQUEST_LOOKUPS) / sizeof(REQUEST_LOOKUPS[0]);
+static const unsigned int RESPONSE_LOOKUP_COUNT =
+	sizeof(RESPONSE_LOOKUPS) / sizeof(RESPONSE_LOOKUPS[0]);
+
+static void
+populate(HeaderTable &table, psg_pool_t *pool, const char * const headers[][2]) {
+	for (unsigned int i = 0; headers[i][0] != NULL; i++) {
+		table.insert(pool, headers[i][0], headers[i][1]);
+	}
+}
+
+static boost::uint64_t
+lookupByName(const HeaderTable &table, const WellKnownHeaderId *ids,
+	unsigned int count, boost::uint64_t iterations)
+{
+	const HashedStaticString *names[WKH_COUNT];
+	boost::uint64_t found = 0;
+
+	for (unsigned int i = 0; i < count; i++) {
+		names[i] = &WELL_KNOWN_HEADERS.getName(ids[i]);
+	}
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		for (unsigned int j = 0; j < count; j++) {
+			found += table.lookup(*names[j]) != NULL;
+		}
+		doNotOptimize(found);
+	}
+	return found;
+}
+
+static boost::uint64_t
+lookupById(const HeaderTable &table, const WellKnownHeaderId *ids,
+	unsigned int count, boost::uint64_t iterations)
+{
+	boost::uint64_t found = 0;
+
+	for (boost::uint64_t i = 0; i < iterations; i++) {
+		for (unsigned int j = 0; j < count; j++) {
+			found += table.lookup(ids[j]) != NULL;
+		}
+		doNotOptimize(found);
+	}
+	return found;
+}
+
+static void
+benchmark(const char *name, const HeaderTable &table, const WellKnownHeaderId *ids,
+	unsigned int count)
+{
+	char stopwatchName[64];
+	boost::uint64_t byName, byId;
+	double nameNs, idNs;
+
+	printf("%s headers (%u lookups per iteration)\n", name, count);
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, by name", name);
+	Stopwatch nameStopwatch(stopwatchName);
+	byName = lookupByName(table, ids, count, ITERATIONS);
+	nameNs = nameStopwatch.stop(ITERATIONS);
+
+	snprintf(stopwatchName, sizeof(stopwatchName), "%s, by ID", name);
+	Stopwatch idStopwatch(stopwatchName);
+	byId = lookupById(table, ids, count, ITERATIONS);
+	idNs = idStopwatch.stop(ITERATIONS);
+
+	if (byName != byId) {
+		fprintf(stderr, "ERROR: lookups by name and by ID disagree!\n");
+	}
+	printf("%s, by ID speedup: %.2fx\n\n", name, nameNs / idNs);
+}
+
+int
+main() {
+	psg_pool_t *pool = psg_create_pool(PSG_DEFAULT_POOL_SIZE);
+	HeaderTable request, response;
+
+	SystemTime::initialize();
+	populate(request, pool, REQUEST_HEADERS);
+	populate(response, pool, RESPONSE_HEADERS);
+
+	printf("Looking up well-known headers (%llu iterations per run)\n\n",
+		(unsigned long long) ITERATIONS);
+	benchmark("Request", request, REQUEST_LOOKUPS, REQUEST_LOOKUP_COUNT);
+	benchmark("Response", response, RESPONSE_LOOKUPS, RESPONSE_LOOKUP_COUNT);
+
+	psg_destroy_pool(pool);
+	return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Compares the time that ProcessMetricsCollector needs to collect metrics
+ * for 500 processes when using 'ps' versus when reading /proc directly.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <Utils/ProcessMetricsCollector.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using namespace Passenger;
+using namespace Passenger::BenchmarkSupport;
+
+static const unsigned int PROCESS_COUNT = 500;
+static const unsigned int ROUNDS = 10;
+
+
+static void
+killChildren(const vector<pid_t> &pids) {
+	for (unsigned int i = 0; i < pids.size(); i++) {
+		kill(pids[i], SIGKILL);
+	}
+	for (unsigned int i = 0; i < pids.size(); i++) {
+		waitpid(pids[i], NULL, 0);
+	}
+}
+
+static bool
+benchmark(const char *name, bool procfs, const vector<pid_t> &pids) {
+	ProcessMetricsCollector collector;
+	collector.setProcfsEnabled(procfs);
+	if (collector.isProcfsEnabled() != procfs) {
+		printf("%-48s: not supported on this system\n", name);
+		return true;
+	}
+
+	ProcessMetricMap result;
+	Stopwatch stopwatch(name);
+	for (unsigned int i = 0; i < ROUNDS; i++) {
+		result = collector.collect(pids);
+		doNotOptimize(result.size());
+	}
+	stopwatch.stop(ROUNDS);
+
+	if (result.size() != pids.size()) {
+		fprintf(stderr, "ERROR: only collected metrics for %u of %u processes!\n",
+			(unsigned int) result.size(), (unsigned int) pids.size());
+		return false;
+	}
+	return true;
+}
+
+int
+main() {
+	vector<pid_t> pids;
+	bool ok;
+
+	SystemTime::initialize();
+	for (unsigned int i = 0; i < PROCESS_COUNT; i++) {
+		pid_t pid = fork();
+		if (pid == 0) {
+			pause();
+			_exit(0);
+		} else if (pid == -1) {
+			perror("fork()");
+			killChildren(pids);
+			return 1;
+		}
+		pids.push_back(pid);
+	}
+
+	printf("Collecting metrics for %u processes (an iteration collects all of them)\n\n",
+		PROCESS_COUNT);
+	ok = benchmark("ps", false, pids)
+		&& benchmark("/proc", true, pids);
+
+	killChildren(pids);
+	return ok ? 0 : 1;
+}
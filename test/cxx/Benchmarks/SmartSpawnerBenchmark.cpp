@@ -0,0 +1,153 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Measures how many processes per second SmartSpawner can spawn from a
+ * single preloader, with 1, 2, 4 and 8 threads calling spawn() at the
+ * same time. Uses the placebo preloader from test/support, which forks
+ * and executes the stub Rack application from test/stub/rack. The stub
+ * application is also started with a simulated startup delay.
+ *
+ * Must be run from the Passenger source root.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread.hpp>
+#include <oxt/initialize.hpp>
+#include <oxt/system_calls.hpp>
+#include <Core/SpawningKit/SmartSpawner.h>
+#include <ResourceLocator.h>
+#include <Logging.h>
+#include <climits>
+#include <cstdio>
+#include <unistd.h>
+#include <pwd.h>
+#include <grp.h>
+
+using namespace std;
+using namespace Passenger;
+using namespace Passenger::SpawningKit;
+using namespace Passenger::BenchmarkSupport;
+
+static const unsigned int SPAWNS_PER_RUN = 32;
+
+
+static void
+spawnProcesses(SmartSpawner *spawner, const Options *options, unsigned int count,
+	boost::uint64_t *failures)
+{
+	for (unsigned int i = 0; i < count; i++) {
+		try {
+			// Destroying the result closes the admin socket, which
+			// makes the stub application exit.
+			spawner->spawn(*options);
+		} catch (const tracable_exception &e) {
+			P_ERROR("Spawn failed: " << e.what());
+			(*failures)++;
+		}
+	}
+}
+
+static void
+benchmark(const ConfigPtr &config, const string &root, const char *description,
+	const char *startCommand, unsigned int threadCount)
+{
+	// Options only references these strings, so they must outlive it.
+	string appRoot = root + "/test/stub/rack";
+	string user = getpwuid(geteuid())->pw_name;
+	string group = getgrgid(getegid())->gr_name;
+
+	Options options;
+	options.spawnMethod  = "smart";
+	options.loadShellEnvvars = false;
+	options.userSwitching = false;
+	options.defaultUser  = user;
+	options.defaultGroup = group;
+	options.appRoot      = appRoot;
+	options.startCommand = startCommand;
+	options.startupFile  = "start.rb";
+
+	vector<string> command;
+	command.push_back("ruby");
+	command.push_back(root + "/test/support/placebo-preloader.rb");
+	SmartSpawner spawner(command, options, config);
+
+	// Start the preloader outside the measurement.
+	// Start the preloader outside the measurement.
+	spawner.spawn(options);
+
+	vector<boost::uint64_t> failures(threadCount, 0);
+	boost::thread_group threads;
+	char name[64];
+	snprintf(name, sizeof(name), "%s, %u thread(s)", description, threadCount);
+
+	Stopwatch stopwatch(name);
+	for (unsigned int i = 0; i < threadCount; i++) {
+		threads.create_thread(boost::bind(spawnProcesses, &spawner, &options,
+			SPAWNS_PER_RUN / threadCount, &failures[i]));
+	}
+	threads.join_all();
+	double nsPerOp = stopwatch.stop(SPAWNS_PER_RUN);
+
+	boost::uint64_t totalFailures = 0;
+	for (unsigned int i = 0; i < threadCount; i++) {
+		totalFailures += failures[i];
+	}
+	printf("%-48s: %10.1f forks/sec, %llu failures\n", name,
+		1000000000.0 / nsPerOp, (unsigned long long) totalFailures);
+	spawner.cleanup();
+}
+
+int
+main() {
+	oxt::initialize();
+	oxt::setup_syscall_interruption_support();
+	SystemTime::initialize();
+	setLogLevel(LVL_WARN);
+
+	char root[PATH_MAX + 1];
+	getcwd(root, PATH_MAX);
+	ResourceLocator resourceLocator(root);
+	ConfigPtr config = boost::make_shared<Config>();
+	config->resourceLocator = &resourceLocator;
+	config->finalize();
+
+	printf("%u spawns from one preloader per run (an iteration is one spawn)\n\n",
+		SPAWNS_PER_RUN);
+	for (unsigned int threads = 1; threads <= 8; threads *= 2) {
+		benchmark(config, root, "Stub app", "ruby\t" "start.rb", threads);
+	}
+	// Real applications usually spend a good part of their startup time
+	// waiting on I/O, which is what concurrent spawning helps with.
+	for (unsigned int threads = 1; threads <= 8; threads *= 2) {
+		benchmark(config, root, "Stub app, 200 ms startup I/O",
+			"bash\t" "-c\t" "sleep 0.2 && exec ruby start.rb", threads);
+	}
+	oxt::shutdown();
+	return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ *  Phusion Passenger - https://www.phusionpassenger.com/
+ *  Copyright (c) 2017 Phusion Holding B.V.
+ *
+ *  "Passenger", "Phusion Passenger" and "Union Station" are registered
+ *  trademarks of Phusion Holding B.V.
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ */
+
+/*
+ * Simulates a UstRouter with thousands of concurrently open transactions.
+ * Every iteration appends a log entry to a random transaction; every 20th
+ * entry also closes that transaction, copies its body into a sink buffer
+ * (like RemoteSink and FileSink do), and opens a new one in its place.
+ *
+ * Compares the old std::string-backed transaction storage with the
+ * arena-backed Transaction class. Each variant runs in its own child
+ * process so that their peak RSS can be compared.
+ */
+
+#include <Benchmarks/BenchmarkSupport.h>
+#include <UstRouter/Transaction.h>
+#include <boost/container/string.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace Passenger;
+using namespace Passenger::UstRouter;
+using namespace Passenger::BenchmarkSupport;
+
+static const unsigned int OPEN_TRANSACTIONS = 10000;
+static const unsigned int ENTRIES_PER_TRANSACTION = 20;
+static const boost::uint64_t ITERATIONS = 4000000;
+static const unsigned int SINK_BUFFER_SIZE = 256 * 1024;
+
+
+/** The transaction body storage as it was before Transaction became arena-backed. */
+class StringTransaction {
+private:
+	string txnId;
+	unsigned int writeCount;
+	boost::container::string storage;
+
+public:
+	StringTransaction(const StaticString &_txnId)
+		: txnId(_txnId.data(), _txnId.size()),
+		  writeCount(0)
+		{ }
+
+	void append(const StaticString &timestamp, const StaticString &data) {
+		char writeCountStr[sizeof(unsigned int) * 2 + 1];
+		unsigned int writeCountStrSize = integerToHexatri(
+			writeCount, writeCountStr);
+
+		writeCount++;
+		storage.append(txnId.data(), txnId.size());
+		storage.append(1, ' ');
+		storage.append(timestamp.data(), timestamp.size());
+		storage.append(1, ' ');
+		storage.append(writeCountStr, writeCountStrSize);
+		storage.append(1, ' ');
+		storage.append(data.data(), data.size());
+		storage.append(1, '\n');
+	}
+
+	unsigned int copyBody(char *output) const {
+		memcpy(output, storage.data(), storage.size());
+		return storage.size();
+	}
+};
+
+class ArenaTransaction {
+private:
+	Transaction transaction;
+
+public:
+	ArenaTransaction(const StaticString &txnId)
+		: transaction(txnId, "group", "node", "requests", "key", 0)
+		{ }
+
+	void append(const StaticString &timestamp, const StaticString &data) {
+		transaction.append(timestamp, data);
+	}
+
+	unsigned int copyBody(char *output) const {
+		StaticString chunks[transaction.getBodyChunkCount()];
+		unsigned int size = 0;
+
+		transaction.getBodyChunks(chunks);
+		for (unsigned int i = 0; i < transaction.getBodyChunkCount(); i++) {
+			memcpy(output + size, chunks[i].data(), chunks[i].size());
+			size += chunks[i].size();
+		}
+		return size;
+	}
+};
+
+/** A simple, deterministic xorshift random number generator. */
+class Random {
+private:
+	boost::uint32_t state;
+
+public:
+	Random()
+		: state(2463534242u)
+		{ }
+
+	boost::uint32_t next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+};
+
+template<typename T>
+static void
+simulate(const char *name) {
+	vector<T *> transactions;
+	vector<char> sinkBuffer(SINK_BUFFER_SIZE * 2);
+	char data[1024];
+	unsigned int sinkBufferSize = 0;
+	boost::uint64_t closed = 0;
+	Random random;
+
+	memset(data, 'x', sizeof(data));
+	for (unsigned int i = 0; i < OPEN_TRANSACTIONS; i++) {
+		transactions.push_back(new T("1234-abcdefghijk"));
+	}
+
+	Stopwatch stopwatch(name);
+	for (boost::uint64_t i = 0; i < ITERATIONS; i++) {
+		unsigned int index = random.next() % OPEN_TRANSACTIONS;
+		unsigned int size = 50 + random.next() % 400;
+		T *transaction = transactions[index];
+
+		transaction->append("1234567890", StaticString(data, size));
+		if (random.next() % ENTRIES_PER_TRANSACTION == 0) {
+			sinkBufferSize += transaction->copyBody(&sinkBuffer[sinkBufferSize]);
+			if (sinkBufferSize > SINK_BUFFER_SIZE) {
+				doNotOptimize(sinkBuffer[0]);
+				sinkBufferSize = 0;
+			}
+			delete transaction;
+			transactions[index] = new T("1234-abcdefghijk");
+			closed++;
+		}
+	}
+	double nsPerOp = stopwatch.stop(ITERATIONS);
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	printf("%-48s: %10.0f transactions/sec, %6ld MB peak RSS\n",
+		name,
+		closed / (nsPerOp * ITERATIONS / 1000000000.0),
+		(long) usage.ru_maxrss / 1024);
+
+	for (unsigned int i = 0; i < OPEN_TRANSACTIONS; i++) {
+		delete transactions[i];
+	}
+}
+
+template<typename T>
+static void
+simulateInChildProcess(const char *name) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid == 0) {
+		simulate<T>(name);
+		fflush(stdout);
+		_exit(0);
+	} else if (pid == -1) {
+		perror("fork()");
+		exit(1);
+	} else {
+		waitpid(pid, NULL, 0);
+	}
+}
+
+int
+main() {
+	SystemTime::initialize();
+	printf("Appending to %u open transactions (%llu log entries per run)\n\n",
+		OPEN_TRANSACTIONS, (unsigned long long) ITERATIONS);
+	simulateInChildProcess<StringTransaction>("std::string storage");
+	simulateInChildProcess<ArenaTransaction>("psg_pool_t arena");
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <TestSupport.h>
+#include <Core/ApplicationPool/Autoscaler.h>
+
+using namespace Passenger;
+using namespace Passenger::ApplicationPool2;
+using namespace std;
+
+namespace tut {
+	struct Core_ApplicationPool_AutoscalerTest {
+		Autoscaler autoscaler;
+		unsigned long long now;
+
+		Core_ApplicationPool_AutoscalerTest()
+			: now(1000000000)
+		{
+			autoscaler.sample(now, 0, 1, 1);
+		}
+
+		/**
+		 * Simulates `seconds` seconds of traffic, sampling once per second,
+		 * where `rate(second)` requests arrive per second and every request
+		 * keeps a process busy for `serviceTime` seconds.
+		 */
+		void run(unsigned int seconds, double startRate, double endRate,
+			double serviceTime, unsigned int processCount,
+			unsigned long long queueTime = 0)
+		{
+			for (unsigned int i = 0; i < seconds; i++) {
+				double rate = startRate + (endRate - startRate) * i / seconds;
+				for (unsigned int j = 0; j < (unsigned int) rate; j++) {
+					autoscaler.recordArrival();
+					autoscaler.recordQueueTime(queueTime);
+				}
+				now += Autoscaler::SAMPLE_INTERVAL;
+				autoscaler.sample(now, (unsigned int) (rate * serviceTime),
+					processCount, 1);
+			}
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_ApplicationPool_AutoscalerTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Under steady traffic, it asks for enough processes "
+			"to handle the load at the target utilization");
+		run(600, 20, 20, 0.3, 8);
+		ensure("(1)", autoscaler.getRequestRate() > 19.5);
+		ensure("(2)", autoscaler.getRequestRate() < 20.5);
+		// 6 concurrent requests at 75% utilization.
+		ensure_equals("(3)", autoscaler.getDesiredProcesses(), 8u);
+		ensure("(4)", !autoscaler.shouldRetireProcess());
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("When traffic ramps up, it asks for processes ahead of the load");
+		run(600, 10, 10, 0.3, 4);
+		unsigned int steadyState = autoscaler.getDesiredProcesses();
+		run(120, 10, 40, 0.3, 4);
+		ensure("(1)", autoscaler.getPredictedRequestRate() > autoscaler.getRequestRate());
+		// The load at this point is about 12 concurrent requests,
+		// for which 16 processes suffice.
+		ensure("(2)", autoscaler.getDesiredProcesses() > 16);
+		ensure("(3)", autoscaler.getDesiredProcesses() > steadyState);
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("When traffic declines, it doesn't extrapolate downwards");
+		run(600, 40, 40, 0.3, 16);
+		run(60, 40, 10, 0.3, 16);
+		ensure("(1)", autoscaler.getPredictedRequestRate() >= autoscaler.getRequestRate());
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("When requests spend too long in the queue, it asks "
+			"for another process regardless of the load");
+		run(30, 10, 10, 0.1, 4, Autoscaler::MAX_QUEUE_TIME * 3);
+		ensure_equals(autoscaler.getDesiredProcesses(), 5u);
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("Processes are only retired after the load has been low "
+			"for RETIRE_DELAY");
+		run(600, 20, 20, 0.3, 8);
+		run(30, 2, 2, 0.5, 8);
+		ensure("(1)", !autoscaler.shouldRetireProcess());
+		run(300, 2, 2, 0.5, 8);
+		ensure("(2)", autoscaler.shouldRetireProcess());
+		// 1 concurrent request at 75% utilization.
+		ensure_equals("(3)", autoscaler.getDesiredProcesses(), 2u);
+
+		// Once the remaining processes are needed, retiring stops.
+		run(10, 2, 2, 0.5, 2);
+		ensure("(4)", !autoscaler.shouldRetireProcess());
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("A short dip in traffic doesn't retire processes");
+		run(600, 20, 20, 0.3, 8);
+		for (unsigned int i = 0; i < 5; i++) {
+			run(30, 2, 2, 0.3, 8);
+			ensure(!autoscaler.shouldRetireProcess());
+			run(90, 20, 20, 0.3, 8);
+			ensure(!autoscaler.shouldRetireProcess());
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include <TestSupport.h>
+#include <Core/ApplicationPool/BusynessIndex.h>
+#include <cstdlib>
+
+using namespace Passenger;
+using namespace Passenger::ApplicationPool2;
+using namespace std;
+
+namespace tut {
+	struct Core_ApplicationPool_BusynessIndexTest {
+		BusynessIndex index;
+
+		unsigned int linearScan(const vector<int> &levels) {
+			unsigned int result = 0;
+			for (unsigned int i = 1; i < levels.size(); i++) {
+				if (levels[i] < levels[result]) {
+					result = i;
+				}
+			}
+			return result;
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_ApplicationPool_BusynessIndexTest);
+
+	TEST_METHOD(1) {
+		set_test_name("lowest() returns the index with the lowest busyness");
+		index.push_back(5);
+		index.push_back(3);
+		index.push_back(7);
+		ensure_equals("(1)", index.size(), 3u);
+		ensure_equals("(2)", index.lowest(), 1u);
+		ensure_equals("(3)", index[0], 5);
+		ensure_equals("(4)", index[1], 3);
+		ensure_equals("(5)", index[2], 7);
+		ensure("(6)", index.verify());
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Ties are broken in favor of the lowest index");
+		index.push_back(2);
+		index.push_back(1);
+		index.push_back(1);
+		index.push_back(1);
+		ensure_equals("(1)", index.lowest(), 1u);
+		index.update(1, 2);
+		ensure_equals("(2)", index.lowest(), 2u);
+		index.update(3, 0);
+		ensure_equals("(3)", index.lowest(), 3u);
+		index.update(3, 1);
+		ensure_equals("(4)", index.lowest(), 2u);
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("update() moves processes both ways");
+		for (int i = 0; i < 10; i++) {
+			index.push_back(i);
+		}
+		ensure_equals("(1)", index.lowest(), 0u);
+		index.update(0, 100);
+		ensure_equals("(2)", index.lowest(), 1u);
+		index.update(9, -1);
+		ensure_equals("(3)", index.lowest(), 9u);
+		ensure_equals("(4)", index[0], 100);
+		ensure("(5)", index.verify());
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("clear()");
+		index.push_back(1);
+		index.push_back(2);
+		index.clear();
+		ensure("(1)", index.empty());
+		index.push_back(3);
+		ensure_equals("(2)", index.lowest(), 0u);
+		ensure("(3)", index.verify());
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("It always agrees with a linear scan");
+		vector<int> levels;
+		unsigned int seed = 1234;
+
+		for (unsigned int i = 0; i < 100; i++) {
+			index.push_back(0);
+			levels.push_back(0);
+		}
+		for (unsigned int i = 0; i < 10000; i++) {
+			unsigned int process = rand_r(&seed) % levels.size();
+			int busyness = rand_r(&seed) % 10;
+			index.update(process, busyness);
+			levels[process] = busyness;
+			ensure_equals("(1)", index.lowest(), linearScan(levels));
+		}
+		ensure("(2)", index.verify());
+	}
+}
@@ -0,0 +1,122 @@
+#include <TestSupport.h>
+#include <Core/ApplicationPool/IdleConnectionStack.h>
+#include <boost/bind.hpp>
+
+using namespace Passenger;
+using namespace Passenger::ApplicationPool2;
+using namespace std;
+
+namespace tut {
+	struct Core_ApplicationPool_IdleConnectionStackTest {
+		typedef IdleConnectionStack<int> Stack;
+
+		static void pushAndPop(Stack *stack, int base, AtomicInt *errors) {
+			for (int i = 0; i < 100000; i++) {
+				int item = base + (i % 4);
+				int popped;
+				MonotonicTimeUsec idleSince;
+
+				if (!stack->push(item, i)) {
+					continue;
+				}
+				if (!stack->pop(popped, idleSince)) {
+					(*errors)++;
+				} else if (popped < 0 || popped >= 4 * 8) {
+					(*errors)++;
+				}
+			}
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_ApplicationPool_IdleConnectionStackTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Items are popped in LIFO order, together with their idle time");
+		Stack stack(3);
+		int item;
+		MonotonicTimeUsec idleSince;
+
+		ensure("(1)", stack.empty());
+		ensure("(2)", stack.push(1, 10));
+		ensure("(3)", stack.push(2, 20));
+		ensure("(4)", !stack.empty());
+
+		ensure("(5)", stack.pop(item, idleSince));
+		ensure_equals("(6)", item, 2);
+		ensure_equals("(7)", idleSince, (MonotonicTimeUsec) 20);
+		ensure("(8)", stack.pop(item, idleSince));
+		ensure_equals("(9)", item, 1);
+		ensure_equals("(10)", idleSince, (MonotonicTimeUsec) 10);
+		ensure("(11)", !stack.pop(item, idleSince));
+		ensure("(12)", stack.empty());
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Pushing fails when the stack is full");
+		Stack stack(2);
+		int item;
+		MonotonicTimeUsec idleSince;
+
+		ensure("(1)", stack.push(1, 0));
+		ensure("(2)", stack.push(2, 0));
+		ensure("(3)", !stack.push(3, 0));
+		ensure("(4)", stack.pop(item, idleSince));
+		ensure("(5)", stack.push(3, 0));
+		ensure("(6)", stack.pop(item, idleSince));
+		ensure_equals("(7)", item, 3);
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("A stack with zero capacity never accepts items");
+		Stack stack(0);
+		int item;
+		MonotonicTimeUsec idleSince;
+
+		ensure("(1)", !stack.push(1, 0));
+		ensure("(2)", !stack.pop(item, idleSince));
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Copying preserves the items and their order");
+		Stack stack(4);
+		stack.push(1, 10);
+		stack.push(2, 20);
+		Stack copy(stack);
+		int item;
+		MonotonicTimeUsec idleSince;
+
+		ensure_equals("(1)", copy.getCapacity(), 4u);
+		ensure("(2)", copy.pop(item, idleSince));
+		ensure_equals("(3)", item, 2);
+		ensure("(4)", copy.pop(item, idleSince));
+		ensure_equals("(5)", item, 1);
+		ensure_equals("(6)", idleSince, (MonotonicTimeUsec) 10);
+		ensure("(7)", !copy.pop(item, idleSince));
+		// The original is unaffected.
+		ensure("(8)", stack.pop(item, idleSince));
+		ensure_equals("(9)", item, 2);
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("It is safe to use concurrently from multiple threads");
+		Stack stack(4);
+		AtomicInt errors;
+		vector<TempThread *> threads;
+
+		for (int i = 0; i < 8; i++) {
+			threads.push_back(new TempThread(boost::bind(pushAndPop,
+				&stack, i * 4, &errors)));
+		}
+		for (unsigned int i = 0; i < threads.size(); i++) {
+			threads[i]->join();
+			delete threads[i];
+		}
+
+		ensure_equals("(1)", errors.get(), 0);
+		// All nodes must have been returned to the free list.
+		for (int i = 0; i < 4; i++) {
+			ensure("(2)", stack.push(i, 0));
+		}
+		ensure("(3)", !stack.push(4, 0));
+	}
+}
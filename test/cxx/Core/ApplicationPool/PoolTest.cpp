@@ -5,6 +5,7 @@
 #include <Utils/StrIntUtils.h>
 #include <MessageReadersWriters.h>
 #include <map>
+#include <set>
 #include <vector>
 #include <cerrno>
 #include <signal.h>
@@ -183,6 +184,21 @@ namespace tut {
 			return options;
 		}
 
+		set<string> getEnabledGupids(const GroupPtr &group) {
+			LockGuard l(pool->syncher);
+			set<string> result;
+			ProcessList::const_iterator it;
+			for (it = group->enabledProcesses.begin(); it != group->enabledProcesses.end(); it++) {
+				result.insert((*it)->getGupid().toString());
+			}
+			return result;
+		}
+
+		void closeAllSessions(AtomicInt *done) {
+			clearAllSessions();
+			*done = 1;
+		}
+
 		void disableProcess(ProcessPtr process, AtomicInt *result) {
 			*result = (int) pool->disableProcess(process->getGupid());
 		}
@@ -2001,6 +2017,362 @@ namespace tut {
 		currentSession.reset();
 	}
 
+	TEST_METHOD(80) {
+		// Session closes that happen while the pool lock is held on behalf
+		// of a request don't wait for the lock. Instead, they are processed
+		// by the lock holder right before it releases the lock.
+		Options options = createOptions();
+		pool->asyncGet(options, callback);
+		EVENTUALLY(5,
+			result = number == 1;
+		);
+		ProcessPtr process = currentSession->getProcess()->shared_from_this();
+		ensure_equals("(1)", process->sessions, 1);
+
+		AtomicInt closed;
+		boost::scoped_ptr<TempThread> thr;
+		boost::container::vector<Callback> actions;
+		Pool::RequestPathLock lock(pool.get());
+		thr.reset(new TempThread(boost::bind(
+			&Core_ApplicationPool_PoolTest::closeAllSessions, this, &closed)));
+		EVENTUALLY(5,
+			result = closed == 1;
+		);
+		ensure_equals("(2)", process->sessions, 1);
+
+		lock.unlock(actions);
+		ensure("(3)", actions.empty());
+		ensure_equals("(4)", process->sessions, 0);
+		ensure_equals("(5)", process->processed, 1u);
+		ensure_equals("(6)", pool->totalDeferredSessionCloses, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(81) {
+		// Pool::inspect() reports the pool lock wait and hold times.
+		Options options = createOptions();
+		pool->asyncGet(options, callback);
+		EVENTUALLY(5,
+			result = number == 1;
+		);
+		currentSession.reset();
+
+		ensure("(1)", pool->syncherWaitTimes.getCount() >= 2);
+		ensure("(2)", pool->syncherHoldTimes.getCount() >= 2);
+		string inspection = pool->inspect();
+		ensure("(3)", inspection.find("Lock wait time : count=") != string::npos);
+		ensure("(4)", inspection.find("Lock hold time : count=") != string::npos);
+	}
+
+	TEST_METHOD(82) {
+		// A group spawns up to `spawnConcurrency` processes at the same time.
+		spawningKitConfig->spawnTime = 300000;
+		Options options = createOptions();
+		options.appGroupName = "test";
+		options.minProcesses = 4;
+		options.spawnConcurrency = 3;
+		pool->asyncGet(options, callback);
+		{
+			LockGuard l(pool->syncher);
+			ensure_equals("(1)", pool->groups.lookupCopy("test")->processesBeingSpawned, 3);
+		}
+		EVENTUALLY(5,
+			result = pool->getProcessCount() == 4;
+		);
+		EVENTUALLY(5,
+			result = !pool->isSpawning();
+		);
+		ensure_equals("(2)", number, 1);
+	}
+
+	TEST_METHOD(83) {
+		// The pool-wide concurrent spawn limit applies to concurrent spawns.
+		spawningKitConfig->spawnTime = 300000;
+		pool->setMaxConcurrentSpawns(2);
+		Options options = createOptions();
+		options.appGroupName = "test";
+		options.minProcesses = 4;
+		options.spawnConcurrency = 4;
+		pool->asyncGet(options, callback);
+		{
+			LockGuard l(pool->syncher);
+			ensure_equals("(1)", pool->groups.lookupCopy("test")->processesBeingSpawned, 2);
+		}
+		EVENTUALLY(5,
+			result = pool->getProcessCount() == 4;
+		);
+	}
+
+	TEST_METHOD(84) {
+		// Pool::inspect() reports spawn throughput and queue drain time.
+		spawningKitConfig->spawnTime = 100000;
+		Options options = createOptions();
+		options.appGroupName = "test";
+		options.minProcesses = 2;
+		options.spawnConcurrency = 2;
+		pool->asyncGet(options, callback);
+		EVENTUALLY(5,
+			result = pool->getProcessCount() == 2 && !pool->isSpawning();
+		);
+		currentSession.reset();
+
+		GroupPtr group = pool->groups.lookupCopy("test");
+		ensure_equals("(1)", group->totalProcessesSpawned, 2u);
+		ensure_equals("(2)", group->lastSpawnBurstProcessesSpawned, 2u);
+		ensure("(3)", group->lastSpawnBurstDuration >= 100000);
+		ensure("(4)", group->lastGetWaitlistDrainTime >= 100000);
+		string inspection = pool->inspect();
+		ensure("(5)", inspection.find("Last spawn burst: 2 processes in ") != string::npos);
+		ensure("(6)", inspection.find("Last queue drain time: ") != string::npos);
+	}
+
+	TEST_METHOD(86) {
+		// A blue/green restart replaces all processes without ever
+		// reducing the number of enabled processes.
+		ensureMinProcesses(2);
+		spawningKitConfig->spawnTime = 50000;
+		GroupPtr group = pool->groups.lookupCopy("stub/rack");
+		set<string> oldGupids = getEnabledGupids(group);
+
+		Pool::RestartOptions restartOptions = Pool::RestartOptions::makeAuthorized();
+		restartOptions.method = RM_BLUE_GREEN;
+		ensure("(1)", pool->restartGroupByName("stub/rack", restartOptions));
+		EVENTUALLY2(5000, 1,
+			LockGuard l(pool->syncher);
+			ensure_equals("(2)", group->enabledCount, 2);
+			ensure("(3)", !group->restarting());
+			result = !group->blueGreenRestarting();
+		);
+
+		set<string> newGupids = getEnabledGupids(group);
+		ensure_equals("(4)", newGupids.size(), 2u);
+		set<string>::const_iterator it;
+		for (it = newGupids.begin(); it != newGupids.end(); it++) {
+			ensure("(5)", oldGupids.find(*it) == oldGupids.end());
+		}
+		LockGuard l(pool->syncher);
+		ensure("(6)", group->lastRestartStats.blueGreen);
+		ensure("(7)", group->lastRestartStats.completed);
+		ensure_equals("(8)", group->lastRestartStats.processesReplaced, 2u);
+		ensure("(9)", group->lastRestartStats.duration >= 100000);
+	}
+
+	TEST_METHOD(87) {
+		// If the new processes cannot be spawned, a blue/green restart is
+		// aborted and the old processes keep serving requests.
+		ensureMinProcesses(2);
+		GroupPtr group = pool->groups.lookupCopy("stub/rack");
+		set<string> oldGupids = getEnabledGupids(group);
+
+		Options options = createOptions();
+		options.raiseInternalError = true;
+		{
+			LockGuard l(pool->syncher);
+			group->restart(options, RM_BLUE_GREEN);
+			ensure("(1)", group->blueGreenRestarting());
+		}
+		EVENTUALLY(5,
+			LockGuard l(pool->syncher);
+			result = !group->blueGreenRestarting();
+		);
+		ensure("(2)", getEnabledGupids(group) == oldGupids);
+		LockGuard l(pool->syncher);
+		ensure("(3)", group->lastRestartStats.blueGreen);
+		ensure("(4)", !group->lastRestartStats.completed);
+		ensure("(5)", !group->options.raiseInternalError);
+	}
+
+	TEST_METHOD(88) {
+		// Pool::inspect() and Pool::toXml() report the impact of the last restart.
+		ensureMinProcesses(1);
+		ensure("(1)", pool->restartGroupByName("stub/rack"));
+		EVENTUALLY(5,
+			result = pool->getProcessCount() == 1 && !pool->isSpawning();
+		);
+		string inspection = pool->inspect();
+		ensure("(2)", inspection.find("Last restart: blocking, 1 process replaced in ")
+			!= string::npos);
+
+		Pool::RestartOptions restartOptions = Pool::RestartOptions::makeAuthorized();
+		restartOptions.method = RM_BLUE_GREEN;
+		ensure("(3)", pool->restartGroupByName("stub/rack", restartOptions));
+		EVENTUALLY(5,
+			result = !pool->isSpawning();
+		);
+		inspection = pool->inspect();
+		ensure("(4)", inspection.find("Last restart: blue/green, 1 process replaced in ")
+			!= string::npos);
+		ensure("(5)", inspection.find("max 0 requests in queue") != string::npos);
+		string xml = pool->toXml();
+		ensure("(6)", xml.find("<last_restart><method>blue_green</method>"
+			"<completed>true</completed>") != string::npos);
+	}
+
+	TEST_METHOD(89) {
+		// A failing warm-up request doesn't prevent a blue/green restart
+		// from completing.
+		ensureMinProcesses(1);
+		GroupPtr group = pool->groups.lookupCopy("stub/rack");
+		Options options = createOptions();
+		options.blueGreenRestart = true;
+		options.restartWarmupPath = "/warmup?foo=bar";
+		{
+			LockGuard l(pool->syncher);
+			group->restart(options);
+			ensure("(1)", group->blueGreenRestarting());
+		}
+		EVENTUALLY(5,
+			LockGuard l(pool->syncher);
+			result = !group->blueGreenRestarting();
+		);
+		LockGuard l(pool->syncher);
+		ensure_equals("(2)", group->enabledCount, 1);
+		ensure("(3)", group->lastRestartStats.completed);
+		ensure_equals("(4)", group->options.restartWarmupPath, "/warmup?foo=bar");
+	}
+
+	TEST_METHOD(90) {
+		// With autoscaling enabled, the garbage collector spawns
+		// processes for the load that the autoscaler expects.
+		Options options = createOptions();
+		options.autoscale = true;
+		SessionPtr session1 = pool->get(options, &ticket);
+		SessionPtr session2 = pool->get(options, &ticket);
+		SessionPtr session3 = pool->get(options, &ticket);
+		ensure_equals("(1)", pool->getProcessCount(), 3u);
+		GroupPtr group = pool->groups.lookupCopy("stub/rack");
+
+		pool->realGarbageCollect();
+		usleep(Autoscaler::SAMPLE_INTERVAL / 2 + 100000);
+		pool->realGarbageCollect();
+		EVENTUALLY(5,
+			result = pool->getProcessCount() == 4;
+		);
+		LockGuard l(pool->syncher);
+		// 3 concurrent requests at 75% utilization.
+		ensure_equals("(2)", group->autoscalerMinProcesses, 4u);
+	}
+
+	TEST_METHOD(91) {
+		// Autoscaled groups are not subject to the idle timer.
+		Options options = createOptions();
+		options.autoscale = true;
+		pool->setMaxIdleTime(50000);
+		SessionPtr session1 = pool->get(options, &ticket);
+		SessionPtr session2 = pool->get(options, &ticket);
+		ensure_equals(pool->getProcessCount(), 2u);
+		session1.reset();
+		session2.reset();
+		SHOULD_NEVER_HAPPEN(300,
+			result = pool->getProcessCount() < 2;
+		);
+	}
+
+	/*********** Test state inspection ***********/
+
+	TEST_METHOD(92) {
+		// The published snapshot is reused until the pool state changes.
+		Options options = createOptions();
+		SessionPtr session = pool->get(options, &ticket);
+		PoolSnapshotPtr snapshot1 = pool->getSnapshot();
+		PoolSnapshotPtr snapshot2 = pool->getSnapshot();
+		ensure_equals("(1)", snapshot1.get(), snapshot2.get());
+		ensure_equals("(2)", snapshot1->groups.size(), 1u);
+		ensure_equals("(3)", snapshot1->groups[0].processes.size(), 1u);
+		ensure_equals("(4)", snapshot1->groups[0].processes[0].sessions, 1);
+
+		session.reset();
+		PoolSnapshotPtr snapshot3 = pool->getSnapshot();
+		ensure("(5)", snapshot3->version > snapshot1->version);
+		ensure_equals("(6)", snapshot3->groups[0].processes[0].sessions, 0);
+		ensure_equals("(7)", snapshot1->groups[0].processes[0].sessions, 1);
+		ensure_equals("(8)", pool->getSnapshot().get(), snapshot3.get());
+	}
+
+	TEST_METHOD(93) {
+		// toJson() can be limited to a single group.
+		Options options = createOptions();
+		pool->get(options, &ticket).reset();
+		options.appGroupName = "other";
+		pool->get(options, &ticket).reset();
+
+		Json::Value doc;
+		Json::Reader reader;
+		ensure("(1)", reader.parse(pool->toJson(), doc));
+		ensure_equals("(2)", doc["group_count"].asUInt(), 2u);
+		ensure("(3)", doc["groups"].isMember("stub/rack"));
+		ensure("(4)", doc["groups"].isMember("other"));
+		ensure_equals("(5)", doc["groups"]["other"]["processes"].size(), 1u);
+
+		Pool::ToJsonOptions jsonOptions = Pool::ToJsonOptions::makeAuthorized();
+		jsonOptions.groupName = "other";
+		ensure("(6)", reader.parse(pool->toJson(jsonOptions), doc));
+		ensure_equals("(7)", doc["groups"].size(), 1u);
+		ensure("(8)", doc["groups"].isMember("other"));
+	}
+
+	TEST_METHOD(94) {
+		// Groups that the client is not authorized for are left out.
+		Options options = createOptions();
+		pool->get(options, &ticket).reset();
+		options.appGroupName = "other";
+		pool->get(options, &ticket).reset();
+
+		Pool::ToJsonOptions jsonOptions;
+		jsonOptions.apiKey = pool->groups.lookupCopy("other")->getApiKey();
+		Json::Value doc;
+		Json::Reader reader;
+		ensure("(1)", reader.parse(pool->toJson(jsonOptions), doc));
+		ensure_equals("(2)", doc["groups"].size(), 1u);
+		ensure("(3)", doc["groups"].isMember("other"));
+
+		jsonOptions.apiKey = ApiKey();
+		try {
+			pool->toJson(jsonOptions);
+			fail("SecurityException expected");
+		} catch (const SecurityException &) {
+			// Pass.
+		}
+	}
+
+	TEST_METHOD(95) {
+		// A group that needs more processes during a blue/green restart
+		// grows with processes of the new generation.
+		Options options = ensureMinProcesses(1);
+		GroupPtr group = pool->groups.lookupCopy("stub/rack");
+		set<string> oldGupids = getEnabledGupids(group);
+		SessionPtr session = pool->get(options, &ticket);
+
+		spawningKitConfig->spawnTime = 300000;
+		{
+			LockGuard l(pool->syncher);
+			group->restart(options, RM_BLUE_GREEN);
+			ensure("(1)", group->blueGreenRestarting());
+		}
+		pool->asyncGet(options, callback);
+		{
+			LockGuard l(pool->syncher);
+			ensure("(2)", group->blueGreenRestarting());
+			ensure_equals("(3)", group->processesBeingSpawned, 2);
+		}
+
+		EVENTUALLY(5,
+			result = number == 2;
+		);
+		EVENTUALLY(5,
+			LockGuard l(pool->syncher);
+			result = !group->blueGreenRestarting() && !group->spawning();
+		);
+		set<string> newGupids = getEnabledGupids(group);
+		ensure_equals("(4)", newGupids.size(), 2u);
+		set<string>::const_iterator it;
+		for (it = newGupids.begin(); it != newGupids.end(); it++) {
+			ensure("(5)", oldGupids.find(*it) == oldGupids.end());
+		}
+		LockGuard l(pool->syncher);
+		ensure("(6)", group->lastRestartStats.completed);
+		ensure_equals("(7)", group->lastRestartStats.processesReplaced, 1u);
+	}
+
 	// TODO: Persistent connections.
 	// TODO: If one closes the session before it has reached EOF, and process's maximum concurrency
 	//       has already been reached, then the pool should ping the process so that it can detect
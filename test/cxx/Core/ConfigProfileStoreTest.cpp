@@ -0,0 +1,177 @@
+#include <TestSupport.h>
+#include <Core/ConfigProfileStore.h>
+
+using namespace Passenger;
+using namespace std;
+
+namespace tut {
+	struct Core_ConfigProfileStoreTest {
+		typedef ConfigProfileStore::ProfilePtr ProfilePtr;
+
+		boost::mutex syncher;
+		ProfilePtr loadedProfile;
+		unsigned int loadCount;
+		boost::shared_ptr<ConfigProfileStore> store;
+		vector< pair<StaticString, StaticString> > headers;
+
+		Core_ConfigProfileStoreTest() {
+			store = boost::make_shared<ConfigProfileStore>(2);
+			headers.push_back(make_pair(P_STATIC_STRING("!~PASSENGER_APP_ROOT"),
+				P_STATIC_STRING("/webapps/foo")));
+			headers.push_back(make_pair(P_STATIC_STRING("!~PASSENGER_STICKY_SESSIONS"),
+				P_STATIC_STRING("t")));
+			loadCount = 0;
+		}
+
+		void onLoaded(const ProfilePtr &profile) {
+			boost::lock_guard<boost::mutex> l(syncher);
+			loadedProfile = profile;
+			loadCount++;
+		}
+
+		ProfilePtr waitForLoad(const StaticString &id) {
+			{
+				boost::lock_guard<boost::mutex> l(syncher);
+				loadedProfile.reset();
+				loadCount = 0;
+			}
+			ensure("loadAsync() accepts the ID", store->loadAsync(id,
+				boost::bind(&Core_ConfigProfileStoreTest::onLoaded, this, _1)));
+			EVENTUALLY(5,
+				boost::lock_guard<boost::mutex> l(syncher);
+				result = loadCount > 0;
+			);
+			boost::lock_guard<boost::mutex> l(syncher);
+			return loadedProfile;
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_ConfigProfileStoreTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Registered profiles can be looked up and own a copy of their headers");
+		string appRoot = "/webapps/foo";
+		headers[0].second = appRoot;
+		store->registerProfile("p1", headers);
+		appRoot[1] = 'x';
+
+		ProfilePtr profile = store->lookup("p1");
+		ensure("(1)", profile != NULL);
+		ensure_equals("(2)", profile->getId(), string("p1"));
+		ensure_equals("(3)", profile->getHeaders().size(), 2u);
+		ensure_equals("(4)", profile->getHeaders()[0].key,
+			HashedStaticString("!~PASSENGER_APP_ROOT"));
+		ensure_equals("(5)", profile->getHeaders()[0].key.hash(),
+			HashedStaticString("!~PASSENGER_APP_ROOT").hash());
+		ensure_equals("(6)", profile->getHeaders()[0].val, StaticString("/webapps/foo"));
+		ensure_equals("(7)", profile->getHeaders()[1].val, StaticString("t"));
+		ensure("(8)", store->lookup("p2") == NULL);
+		// Without a profile directory there is nothing to load.
+		ensure("(9)", !store->loadAsync("p2",
+			boost::bind(&Core_ConfigProfileStoreTest::onLoaded, this, _1)));
+
+		Json::Value doc = store->inspectStateAsJson();
+		ensure_equals("(10)", doc["count"].asUInt(), 1u);
+		ensure_equals("(11)", doc["registrations"].asUInt(), 1u);
+		ensure_equals("(12)", doc["misses"].asUInt(), 1u);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Registering an existing ID replaces the profile");
+		ProfilePtr old = store->registerProfile("p1", headers);
+		headers.pop_back();
+		store->registerProfile("p1", headers);
+
+		ensure_equals("(1)", store->getProfileCount(), 1u);
+		ensure_equals("(2)", store->lookup("p1")->getHeaders().size(), 1u);
+		// The old profile stays usable while it is referenced.
+		ensure_equals("(3)", old->getHeaders().size(), 2u);
+		ensure_equals("(4)", old->getHeaders()[1].val, StaticString("t"));
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("The least recently used profile is forgotten when the store is full");
+		store->registerProfile("p1", headers);
+		store->registerProfile("p2", headers);
+		store->registerProfile("p3", headers);
+		ensure("(1)", store->lookup("p1") == NULL);
+
+		ensure("(2)", store->lookup("p2") != NULL);
+		store->registerProfile("p4", headers);
+		ensure_equals("(3)", store->getProfileCount(), 2u);
+		ensure("(4)", store->lookup("p3") == NULL);
+		ensure("(5)", store->lookup("p2") != NULL);
+		ensure("(6)", store->lookup("p4") != NULL);
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Request-specific headers are recognized");
+		ensure("(1)", ConfigProfileStore::isRequestSpecificHeader("!~"));
+		ensure("(2)", ConfigProfileStore::isRequestSpecificHeader("!~REMOTE_ADDR"));
+		ensure("(3)", ConfigProfileStore::isRequestSpecificHeader("!~PASSENGER_CONFIG_PROFILE"));
+		ensure("(4)", !ConfigProfileStore::isRequestSpecificHeader("!~PASSENGER_APP_ROOT"));
+		ensure("(5)", !ConfigProfileStore::isRequestSpecificHeader("!~REMOTE_ADDRESS"));
+		ensure("(6)", ConfigProfileStore::isRequestSpecificHeader("!~PASSENGER_APP_GROUP_NAME"));
+		ensure("(7)", ConfigProfileStore::isRequestSpecificHeader("!~DOCUMENT_ROOT"));
+		ensure("(8)", ConfigProfileStore::isRequestSpecificHeader("!~UNION_STATION_FILTERS"));
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("Profiles are saved to the profile directory, so that they survive "
+			"restarts");
+		TempDir tmpdir("tmp.config_profiles");
+		string dir = tmpdir.getPath() + "/profiles";
+		store = boost::make_shared<ConfigProfileStore>(1, dir);
+		store->registerProfile("p1", headers);
+		// Waits until the profile is saved.
+		store.reset();
+
+		store = boost::make_shared<ConfigProfileStore>(1, dir);
+		ensure("(1)", store->lookup("p1") == NULL);
+		ProfilePtr profile = waitForLoad("p1");
+		ensure("(2)", profile != NULL);
+		ensure_equals("(3)", profile->getHeaders().size(), 2u);
+		ensure_equals("(4)", profile->getHeaders()[0].key,
+			HashedStaticString("!~PASSENGER_APP_ROOT"));
+		ensure_equals("(5)", profile->getHeaders()[0].val, StaticString("/webapps/foo"));
+		ensure_equals("(6)", profile->getHeaders()[1].val, StaticString("t"));
+		ensure("(7)", store->lookup("p1") != NULL);
+		ensure("(8)", waitForLoad("p2") == NULL);
+
+		Json::Value doc = store->inspectStateAsJson();
+		ensure_equals("(9)", doc["loads"].asUInt(), 1u);
+		ensure_equals("(10)", doc["misses"].asUInt(), 1u);
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("IDs that aren't safe to use as filenames are not saved");
+		TempDir tmpdir("tmp.config_profiles");
+		string dir = tmpdir.getPath() + "/profiles";
+		store = boost::make_shared<ConfigProfileStore>(1, dir);
+		store->registerProfile("../p1", headers);
+		store->registerProfile("p2", headers);
+
+		ensure("(1)", store->lookup("../p1") == NULL);
+		ensure("(2)", !store->loadAsync("../p1",
+			boost::bind(&Core_ConfigProfileStoreTest::onLoaded, this, _1)));
+		store.reset();
+		ensure_equals("(3)", getFileType(tmpdir.getPath() + "/p1"), FT_NONEXISTANT);
+	}
+
+	TEST_METHOD(7) {
+		set_test_name("A profile that has been forgotten is loaded from the profile directory");
+		TempDir tmpdir("tmp.config_profiles");
+		store = boost::make_shared<ConfigProfileStore>(1, tmpdir.getPath() + "/profiles");
+		store->registerProfile("p1", headers);
+		store->registerProfile("p2", headers);
+		ensure("(1)", store->lookup("p1") == NULL);
+
+		ProfilePtr profile = waitForLoad("p1");
+		ensure("(2)", profile != NULL);
+		ensure_equals("(3)", profile->getId(), string("p1"));
+		ensure_equals("(4)", profile->getHeaders().size(), 2u);
+		ensure("(5)", store->lookup("p1") == profile);
+		// The store is still limited to one profile.
+		ensure("(6)", store->lookup("p2") == NULL);
+	}
+}
@@ -40,6 +40,7 @@ namespace tut {
 		SpawningKit::ConfigPtr spawningKitConfig;
 		SpawningKit::FactoryPtr spawningKitFactory;
 		PoolPtr appPool;
+		ConfigProfileStorePtr configProfileStore;
 		Json::Value config;
 		int serverSocket;
 		TestSession testSession;
@@ -104,6 +105,7 @@ namespace tut {
 			controller = new MyController(&context, schema, config);
 			controller->resourceLocator = resourceLocator;
 			controller->appPool = appPool;
+			controller->configProfileStore = configProfileStore;
 			controller->initialize();
 			controller->listen(serverSocket);
 			startLoop();
@@ -247,9 +249,38 @@ namespace tut {
 		string readResponseBody() {
 			return clientConnectionIO.readAll();
 		}
+
+		Json::Value inspectResponseSplicing() {
+			Json::Value result;
+			bg.safe->runSync(boost::bind(&Core_ControllerTest::_inspectResponseSplicing,
+				this, &result));
+			return result;
+		}
+
+		void _inspectResponseSplicing(Json::Value *result) {
+			*result = controller->inspectStateAsJson()["response_splicing"];
+		}
+
+		void registerConfigProfile(const StaticString &id, const StaticString &key,
+			const StaticString &value)
+		{
+			vector< pair<StaticString, StaticString> > headers;
+			headers.push_back(make_pair(key, value));
+			controller->configProfileStore->registerProfile(id, headers);
+		}
+
+		string createLargeBody() {
+			string body;
+			body.reserve(1024 * 1024);
+			while (body.size() < 1024 * 1024) {
+				body.append(toString(body.size()));
+				body.append(1, '\n');
+			}
+			return body;
+		}
 	};
 
-	DEFINE_TEST_GROUP(Core_ControllerTest);
+	DEFINE_TEST_GROUP_WITH_LIMIT(Core_ControllerTest, 60);
 
 
 	/***** Passing request information to the app *****/
@@ -854,4 +885,263 @@ namespace tut {
 		string header = readResponseHeader();
 		ensure(containsSubstring(header, "HTTP/1.1 502"));
 	}
+
+
+	/***** Forwarding response bodies with splice() *****/
+
+	#ifdef CC_HAVE_RESPONSE_SPLICING
+		TEST_METHOD(45) {
+			set_test_name("Large fixed response bodies are forwarded with splice()"
+				" while the client keeps up");
+
+			config["response_splicing_threshold"] = 1024;
+			init();
+			useTestSessionObject();
+
+			connectToServer();
+			sendRequest(
+				"GET /hello HTTP/1.1\r\n"
+				"Host: localhost\r\n"
+				"Connection: close\r\n"
+				"\r\n");
+			waitUntilSessionInitiated();
+			readPeerRequestHeader();
+
+			string body = createLargeBody();
+			string response = "HTTP/1.1 200 OK\r\n"
+				"Connection: close\r\n"
+				"Content-Length: " + toString(body.size()) + "\r\n\r\n"
+				+ body;
+			TempThread thr(boost::bind(&Core_ControllerTest::sendPeerResponse,
+				this, StaticString(response)));
+
+			string header = readResponseHeader();
+			ensure("(1)", containsSubstring(header, "HTTP/1.1 200 OK\r\n"));
+			ensure("(2)", readResponseBody() == body);
+
+			Json::Value doc = inspectResponseSplicing();
+			ensure("(3)", doc["responses_spliced"].asUInt() >= 1);
+			ensure("(4)", doc["bytes_spliced"]["bytes"].asUInt() > 0);
+			waitUntilSessionClosed();
+			ensure("(5)", testSession.isSuccessful());
+		}
+
+		TEST_METHOD(46) {
+			set_test_name("Splicing falls back to buffering when the client is slow");
+
+			config["response_splicing_threshold"] = 1024;
+			init();
+			useTestSessionObject();
+
+			connectToServer();
+			sendRequest(
+				"GET /hello HTTP/1.1\r\n"
+				"Host: localhost\r\n"
+				"Connection: close\r\n"
+				"\r\n");
+			waitUntilSessionInitiated();
+			readPeerRequestHeader();
+
+			string body = createLargeBody();
+			string response = "HTTP/1.1 200 OK\r\n"
+				"Connection: close\r\n"
+				"Content-Length: " + toString(body.size()) + "\r\n\r\n"
+				+ body;
+			TempThread thr(boost::bind(&Core_ControllerTest::sendPeerResponse,
+				this, StaticString(response)));
+
+			// Don't read anything until the application socket has been
+			// drained, which is only possible by buffering the response.
+			waitUntilSessionClosed();
+			Json::Value doc = inspectResponseSplicing();
+			ensure("(1)", doc["responses_spliced"].asUInt() >= 1);
+			ensure("(2)", doc["fallbacks"].asUInt() >= 1);
+
+			string header = readResponseHeader();
+			ensure("(3)", containsSubstring(header, "HTTP/1.1 200 OK\r\n"));
+			ensure("(4)", readResponseBody() == body);
+		}
+
+		TEST_METHOD(47) {
+			set_test_name("Large response bodies until EOF are forwarded with splice()");
+
+			config["response_splicing_threshold"] = 1024;
+			init();
+			useTestSessionObject();
+
+			connectToServer();
+			sendRequest(
+				"GET /hello HTTP/1.1\r\n"
+				"Host: localhost\r\n"
+				"Connection: close\r\n"
+				"\r\n");
+			waitUntilSessionInitiated();
+			readPeerRequestHeader();
+
+			string body = createLargeBody();
+			string response = "HTTP/1.1 200 OK\r\n"
+				"Connection: close\r\n\r\n"
+				+ body;
+			TempThread thr(boost::bind(&Core_ControllerTest::sendPeerResponse,
+				this, StaticString(response)));
+
+			string header = readResponseHeader();
+			ensure("(1)", containsSubstring(header, "HTTP/1.1 200 OK\r\n"));
+			ensure("(2)", readResponseBody() == body);
+			ensure("(3)", inspectResponseSplicing()["responses_spliced"].asUInt() >= 1);
+		}
+	#endif
+
+
+	/***** Web server config profiles *****/
+
+	TEST_METHOD(50) {
+		set_test_name("A request can register a config profile, which the response acknowledges");
+
+		init();
+		useTestSessionObject();
+
+		connectToServer();
+		sendRequest(
+			"GET /hello HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Connection: close\r\n"
+			"!~: \r\n"
+			"!~PASSENGER_REGISTER_CONFIG_PROFILE: p1\r\n"
+			"!~PASSENGER_SHOW_VERSION_IN_HEADER: f\r\n"
+			"!~REMOTE_ADDR: 127.0.0.1\r\n"
+			"\r\n");
+		waitUntilSessionInitiated();
+
+		readPeerRequestHeader();
+		sendPeerResponse(
+			"HTTP/1.1 200 OK\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 2\r\n\r\n"
+			"ok");
+
+		string header = readResponseHeader();
+		ensure("(1)", containsSubstring(header, "X-Passenger-Config-Profile: p1\r\n"));
+
+		// Request-specific headers are not part of the profile.
+		ConfigProfileStore::ProfilePtr profile = controller->configProfileStore->lookup("p1");
+		ensure("(2)", profile != NULL);
+		ensure_equals("(3)", profile->getHeaders().size(), 1u);
+		ensure_equals("(4)", profile->getHeaders()[0].key,
+			HashedStaticString("!~PASSENGER_SHOW_VERSION_IN_HEADER"));
+		ensure_equals("(5)", profile->getHeaders()[0].val, StaticString("f"));
+	}
+
+	TEST_METHOD(51) {
+		set_test_name("A request that refers to a config profile gets the profile's secure headers");
+
+		init();
+		useTestSessionObject();
+		registerConfigProfile("p1", "!~PASSENGER_SHOW_VERSION_IN_HEADER", "f");
+
+		connectToServer();
+		sendRequest(
+			"GET /hello HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Connection: close\r\n"
+			"!~: \r\n"
+			"!~PASSENGER_CONFIG_PROFILE: p1\r\n"
+			"\r\n");
+		waitUntilSessionInitiated();
+
+		readPeerRequestHeader();
+		sendPeerResponse(
+			"HTTP/1.1 200 OK\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 2\r\n\r\n"
+			"ok");
+
+		string header = readResponseHeader();
+		ensure("(1)", containsSubstring(header, "HTTP/1.1 200 OK\r\n"));
+		ensure("(2)", containsSubstring(header, "X-Powered-By: " PROGRAM_NAME));
+		ensure("(3)", !containsSubstring(header, PASSENGER_VERSION));
+		ensure("(4)", !containsSubstring(header, "X-Passenger-Config-Profile"));
+	}
+
+	TEST_METHOD(52) {
+		set_test_name("Secure headers sent along with a config profile reference take precedence");
+
+		init();
+		useTestSessionObject();
+		registerConfigProfile("p1", "!~PASSENGER_SHOW_VERSION_IN_HEADER", "f");
+
+		connectToServer();
+		sendRequest(
+			"GET /hello HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Connection: close\r\n"
+			"!~: \r\n"
+			"!~PASSENGER_CONFIG_PROFILE: p1\r\n"
+			"!~PASSENGER_SHOW_VERSION_IN_HEADER: t\r\n"
+			"\r\n");
+		waitUntilSessionInitiated();
+
+		readPeerRequestHeader();
+		sendPeerResponse(
+			"HTTP/1.1 200 OK\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 2\r\n\r\n"
+			"ok");
+
+		string header = readResponseHeader();
+		ensure(containsSubstring(header, "X-Powered-By: " PROGRAM_NAME " " PASSENGER_VERSION));
+	}
+
+	TEST_METHOD(53) {
+		set_test_name("A request that refers to an unknown config profile is rejected with a 503");
+
+		init();
+		connectToServer();
+		sendRequest(
+			"GET /hello HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Connection: close\r\n"
+			"!~: \r\n"
+			"!~PASSENGER_CONFIG_PROFILE: p1\r\n"
+			"\r\n");
+
+		string header = readResponseHeader();
+		ensure("(1)", containsSubstring(header, "HTTP/1.1 503 Service Unavailable\r\n"));
+		ensure("(2)", containsSubstring(header, "X-Passenger-Config-Profile: unknown\r\n"));
+	}
+
+	TEST_METHOD(54) {
+		set_test_name("A config profile that has been evicted from memory is loaded from disk");
+
+		TempDir tmpdir("tmp.config_profiles");
+		configProfileStore = boost::make_shared<ConfigProfileStore>(1,
+			tmpdir.getPath() + "/profiles");
+		init();
+		useTestSessionObject();
+		registerConfigProfile("p1", "!~PASSENGER_SHOW_VERSION_IN_HEADER", "f");
+		registerConfigProfile("p2", "!~PASSENGER_SHOW_VERSION_IN_HEADER", "t");
+		ensure("(1)", configProfileStore->lookup("p1") == NULL);
+
+		connectToServer();
+		sendRequest(
+			"GET /hello HTTP/1.1\r\n"
+			"Host: localhost\r\n"
+			"Connection: close\r\n"
+			"!~: \r\n"
+			"!~PASSENGER_CONFIG_PROFILE: p1\r\n"
+			"\r\n");
+		waitUntilSessionInitiated();
+
+		readPeerRequestHeader();
+		sendPeerResponse(
+			"HTTP/1.1 200 OK\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 2\r\n\r\n"
+			"ok");
+
+		string header = readResponseHeader();
+		ensure("(2)", containsSubstring(header, "HTTP/1.1 200 OK\r\n"));
+		ensure("(3)", !containsSubstring(header, PASSENGER_VERSION));
+		ensure("(4)", configProfileStore->lookup("p1") != NULL);
+	}
 }
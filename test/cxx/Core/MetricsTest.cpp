@@ -0,0 +1,99 @@
+#include <TestSupport.h>
+#include <Core/Controller/Metrics.h>
+
+using namespace Passenger;
+using namespace Passenger::Core;
+using namespace std;
+
+namespace tut {
+	struct Core_MetricsTest {
+		ControllerMetrics metrics;
+
+		bool contains(const string &str, const string &substr) {
+			return str.find(substr) != string::npos;
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_MetricsTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Group metrics from several controllers are merged");
+		ControllerMetrics metrics2;
+		MetricsSnapshot snapshot;
+
+		metrics.lookupGroup("foo")->requests = 2;
+		metrics.lookupGroup("bar")->requests = 1;
+		metrics2.lookupGroup("foo")->requests = 3;
+		metrics2.lookupGroup("foo")->queueTime.record(10);
+		metrics.turboCacheFetches = 4;
+		metrics2.turboCacheHits = 1;
+		metrics.collect(snapshot);
+		metrics2.collect(snapshot);
+
+		ensure_equals("(1)", snapshot.groups.size(), 2u);
+		ensure_equals("(2)", snapshot.groups["foo"].requests, (boost::uint64_t) 5);
+		ensure_equals("(3)", snapshot.groups["foo"].queueTime.getCount(), (boost::uint64_t) 1);
+		ensure_equals("(4)", snapshot.groups["bar"].requests, (boost::uint64_t) 1);
+		ensure_equals("(5)", snapshot.turboCacheFetches, (boost::uint64_t) 4);
+		ensure_equals("(6)", snapshot.turboCacheHits, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Prometheus text format");
+		MetricsSnapshot snapshot;
+		GroupRequestMetrics *group = metrics.lookupGroup("/app \"x\"");
+
+		group->requests = 2;
+		group->responseTime.record(3);
+		group->responseTime.record(1500000);
+		metrics.turboCacheFetches = 4;
+		metrics.turboCacheHits = 1;
+		metrics.collect(snapshot);
+		string text = snapshot.toPrometheusText(NULL);
+
+		ensure("(1)", contains(text, "# TYPE passenger_requests_total counter\n"));
+		ensure("(2)", contains(text,
+			"passenger_requests_total{group=\"/app \\\"x\\\"\"} 2\n"));
+		ensure("(3)", contains(text,
+			"passenger_app_response_seconds_bucket{group=\"/app \\\"x\\\"\",le=\"0.000003\"} 1\n"));
+		ensure("(4)", contains(text,
+			"passenger_app_response_seconds_bucket{group=\"/app \\\"x\\\"\",le=\"+Inf\"} 2\n"));
+		ensure("(5)", contains(text,
+			"passenger_app_response_seconds_sum{group=\"/app \\\"x\\\"\"} 1.500003\n"));
+		ensure("(6)", contains(text,
+			"passenger_app_response_seconds_count{group=\"/app \\\"x\\\"\"} 2\n"));
+		ensure("(7)", contains(text, "passenger_turbocache_hit_ratio 0.250000\n"));
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("Request latency breakdown");
+		ControllerMetrics metrics2;
+		MetricsSnapshot snapshot;
+		GroupRequestMetrics *group = metrics.lookupGroup("foo");
+
+		group->requests = 1;
+		group->preCheckoutTime.record(10);
+		group->queueTime.record(20);
+		group->responseTime.record(3000);
+		group->bodyTransferTime.record(400);
+		metrics2.lookupGroup("foo")->bodyTransferTime.record(500);
+		metrics.collect(snapshot);
+		metrics2.collect(snapshot);
+
+		Json::Value doc = snapshot.inspectRequestLatencyAsJson()["groups"]["foo"];
+		ensure_equals("(1)", doc["requests"].asUInt(), 1u);
+		ensure_equals("(2)", doc["pre_checkout"]["count"].asUInt(), 1u);
+		ensure_equals("(3)", doc["queue"]["max_usec"].asUInt(), 20u);
+		ensure_equals("(4)", doc["app_time_to_first_byte"]["max_usec"].asUInt(), 3000u);
+		ensure_equals("(5)", doc["body_transfer"]["count"].asUInt(), 2u);
+		ensure_equals("(6)", doc["body_transfer"]["sum_usec"].asUInt(), 900u);
+
+		string text = snapshot.toPrometheusText(NULL);
+		ensure("(7)", contains(text,
+			"passenger_request_pre_checkout_seconds_count{group=\"foo\"} 1\n"));
+		ensure("(8)", contains(text,
+			"passenger_app_response_body_seconds_count{group=\"foo\"} 2\n"));
+		ensure("(9)", contains(text,
+			"passenger_app_response_body_seconds_bucket{group=\"foo\",le=\"0.000511\"} 2\n"));
+	}
+}
@@ -0,0 +1,151 @@
+#include <TestSupport.h>
+#include <Core/ResponseCacheStore.h>
+
+using namespace Passenger;
+using namespace std;
+
+namespace tut {
+	struct Core_ResponseCacheStoreTest {
+		typedef ResponseCacheStore::BodyPtr BodyPtr;
+
+		boost::shared_ptr<ResponseCacheStore> store;
+		time_t now;
+
+		Core_ResponseCacheStoreTest() {
+			now = 1000;
+			init(1024 * 64, 1);
+		}
+
+		void init(size_t capacity, unsigned int nshards) {
+			store = boost::make_shared<ResponseCacheStore>(capacity, nshards, 1024 * 8);
+		}
+
+		BodyPtr put(const string &key, unsigned int bodySize, time_t expiryDate = 2000) {
+			BodyPtr body = store->allocate(key, 0, bodySize, now);
+			if (body != NULL) {
+				body->date = now;
+				body->expiryDate = expiryDate;
+				memset(body->httpBodyData, 'x', bodySize);
+				store->publish(body);
+			}
+			return body;
+		}
+
+		BodyPtr get(const string &key) {
+			bool expired;
+			return store->lookup(key, now, expired);
+		}
+	};
+
+	DEFINE_TEST_GROUP(Core_ResponseCacheStoreTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Published entries can be looked up");
+		ensure("(1)", put("foo", 100) != NULL);
+		BodyPtr body = get("foo");
+		ensure("(2)", body != NULL);
+		ensure_equals("(3)", body->getKey(), StaticString("foo"));
+		ensure_equals("(4)", body->httpBodySize, 100u);
+		ensure("(5)", get("bar") == NULL);
+		ensure_equals("(6)", store->getTotalStats().hits, (boost::uint64_t) 1);
+		ensure_equals("(7)", store->getTotalStats().misses, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Publishing an entry with an existing key replaces the old entry");
+		BodyPtr old = put("foo", 100);
+		put("foo", 200);
+		ensure_equals("(1)", store->getEntryCount(), 1u);
+		ensure_equals("(2)", get("foo")->httpBodySize, 200u);
+		// The old entry stays usable while it is referenced.
+		ensure_equals("(3)", old->httpBodySize, 100u);
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("Total memory usage is bounded by the capacity");
+		for (unsigned int i = 0; i < 200; i++) {
+			put("key" + toString(i), 1000);
+		}
+		ensure("(1)", store->getEntryCount() < 200u);
+		ensure("(2)", store->getTotalStats().evictions > 0);
+		Json::Value doc = store->inspectStateAsJson();
+		ensure("(3)", doc["shards"][0]["bytes_allocated"]["bytes"].asUInt64() <= 1024 * 64);
+		// The most recently stored entry is still there.
+		ensure("(4)", get("key199") != NULL);
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Recently accessed entries survive eviction");
+		for (unsigned int i = 0; i < 40; i++) {
+			put("key" + toString(i), 1000);
+		}
+		ensure("(1)", get("key0") != NULL);
+		for (unsigned int i = 40; i < 60; i++) {
+			put("key" + toString(i), 1000);
+			get("key0");
+		}
+		ensure("(2)", get("key0") != NULL);
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("Expired entries are removed upon lookup");
+		put("foo", 100, now + 10);
+		now += 10;
+		bool expired;
+		ensure("(1)", store->lookup("foo", now, expired) == NULL);
+		ensure("(2)", expired);
+		ensure_equals("(3)", store->getEntryCount(), 0u);
+		ensure_equals("(4)", store->getTotalStats().expirations, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("Expired entries are evicted even if they were recently accessed");
+		for (unsigned int i = 0; i < 40; i++) {
+			put("key" + toString(i), 1000, (i == 0) ? now + 1 : now + 1000);
+		}
+		for (unsigned int i = 0; i < 40; i++) {
+			get("key" + toString(i));
+		}
+		now += 5;
+		for (unsigned int i = 40; i < 60; i++) {
+			put("key" + toString(i), 1000, now + 1000);
+		}
+		ensure("(1)", store->getTotalStats().expirations >= 1);
+	}
+
+	TEST_METHOD(7) {
+		set_test_name("Memory of evicted entries is reused for new entries of the same size class");
+		for (unsigned int i = 0; i < 100; i++) {
+			put("key" + toString(i), 1000);
+		}
+		ensure("(1)", store->getTotalStats().slabReuses > 0);
+	}
+
+	TEST_METHOD(8) {
+		set_test_name("Entries that are too large are rejected");
+		ensure("(1)", put("foo", 1024 * 16) == NULL);
+		ensure_equals("(2)", store->getTotalStats().allocationFailures, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(9) {
+		set_test_name("Erasing");
+		put("foo", 100);
+		ensure("(1)", store->erase("foo"));
+		ensure("(2)", !store->erase("foo"));
+		ensure("(3)", get("foo") == NULL);
+		ensure_equals("(4)", store->getTotalStats().invalidations, (boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(10) {
+		set_test_name("Entries are distributed over shards");
+		init(1024 * 1024, 4);
+		for (unsigned int i = 0; i < 100; i++) {
+			put("key" + toString(i), 100);
+		}
+		ensure_equals("(1)", store->getEntryCount(), 100u);
+		Json::Value doc = store->inspectStateAsJson();
+		for (unsigned int i = 0; i < 4; i++) {
+			ensure("(2)", doc["shards"][i]["entries"].asUInt() > 0);
+		}
+	}
+}
@@ -216,7 +216,7 @@ namespace tut {
 		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL),
 			responseHeadersStr.size(), responseBodyStr.size()));
 		ensure("(5)", entry.valid());
-		ensure_equals("(6)", entry.index, 0u);
+		responseCache.publish(entry);
 
 
 		reset();
@@ -224,7 +224,7 @@ namespace tut {
 		ensure("(11)", responseCache.requestAllowsFetching(&req));
 		ResponseCacheType::Entry entry2(responseCache.fetch(&req, time(NULL)));
 		ensure("(12)", entry2.valid());
-		ensure_equals("(13)", entry2.index, 0u);
+		ensure("(13)", entry2.body == entry.body);
 		ensure_equals<int>("(14)", entry2.body->httpHeaderSize, responseHeadersStr.size());
 		ensure_equals<int>("(15)", entry2.body->httpBodySize, responseBodyStr.size());
 	}
@@ -237,6 +237,60 @@ namespace tut {
 		ensure("(3)", !entry2.valid());
 	}
 
+	TEST_METHOD(12) {
+		set_test_name("Stored entries are not visible until published");
+		initCacheableResponse();
+		initResponseBody("hello");
+		ensure("(1)", responseCache.prepareRequest(this, &req));
+		ensure("(2)", responseCache.prepareRequestForStoring(&req));
+		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL), 10, 5));
+		ensure("(3)", entry.valid());
+
+		reset();
+		ensure("(10)", responseCache.prepareRequest(this, &req));
+		ResponseCacheType::Entry entry2(responseCache.fetch(&req, time(NULL)));
+		ensure("(11)", !entry2.valid());
+	}
+
+	TEST_METHOD(13) {
+		set_test_name("Entries are shared between ResponseCaches that share a store");
+		ResponseCacheType responseCache2;
+		responseCache2.setStore(responseCache.getStore());
+
+		initCacheableResponse();
+		initResponseBody("hello");
+		ensure("(1)", responseCache.prepareRequest(this, &req));
+		ensure("(2)", responseCache.prepareRequestForStoring(&req));
+		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL), 10, 5));
+		ensure("(3)", entry.valid());
+		responseCache.publish(entry);
+
+		reset();
+		ensure("(10)", responseCache2.prepareRequest(this, &req));
+		ResponseCacheType::Entry entry2(responseCache2.fetch(&req, time(NULL)));
+		ensure("(11)", entry2.valid());
+		ensure_equals("(12)", responseCache2.getHits(), 1u);
+		ensure_equals("(13)", responseCache.getHits(), 0u);
+	}
+
+	TEST_METHOD(14) {
+		set_test_name("Fetching an expired entry removes it");
+		initCacheableResponse();
+		initResponseBody("hello");
+		ensure("(1)", responseCache.prepareRequest(this, &req));
+		ensure("(2)", responseCache.prepareRequestForStoring(&req));
+		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL), 10, 5));
+		ensure("(3)", entry.valid());
+		responseCache.publish(entry);
+
+		reset();
+		ensure("(10)", responseCache.prepareRequest(this, &req));
+		ResponseCacheType::Entry entry2(responseCache.fetch(&req, entry.body->expiryDate));
+		ensure("(11)", !entry2.valid());
+		ensure("(12)", entry2.cacheMissReason == ResponseCacheType::Entry::NOT_FRESH);
+		ensure_equals("(13)", responseCache.getStore()->getEntryCount(), 0u);
+	}
+
 
 	/***** Checking whether request should be fetched from cache *****/
 
@@ -478,7 +532,7 @@ namespace tut {
 		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL),
 			responseHeadersStr.size(), responseBodyStr.size()));
 		ensure("(5)", entry.valid());
-		ensure_equals("(6)", entry.index, 0u);
+		responseCache.publish(entry);
 
 
 		reset();
@@ -511,7 +565,7 @@ namespace tut {
 		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL),
 			responseHeadersStr.size(), responseBodyStr.size()));
 		ensure("(5)", entry.valid());
-		ensure_equals("(6)", entry.index, 0u);
+		responseCache.publish(entry);
 
 
 		reset();
@@ -549,7 +603,7 @@ namespace tut {
 		ResponseCacheType::Entry entry(responseCache.store(&req, time(NULL),
 			responseHeadersStr.size(), responseBodyStr.size()));
 		ensure("(5)", entry.valid());
-		ensure_equals("(6)", entry.index, 0u);
+		responseCache.publish(entry);
 
 
 		reset();
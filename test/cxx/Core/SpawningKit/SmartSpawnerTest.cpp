@@ -4,6 +4,8 @@
 #include <Logging.h>
 #include <FileDescriptor.h>
 #include <Utils/IOUtils.h>
+#include <boost/thread.hpp>
+#include <set>
 #include <unistd.h>
 #include <climits>
 #include <signal.h>
@@ -59,6 +61,17 @@ namespace tut {
 			return options;
 		}
 
+		static void spawnInThread(const boost::shared_ptr<SmartSpawner> &spawner,
+			const Options &options, SpawningKit::Result *result, bool *failed)
+		{
+			try {
+				*result = spawner->spawn(options);
+			} catch (const tracable_exception &e) {
+				P_ERROR("Spawn failed: " << e.what());
+				*failed = true;
+			}
+		}
+
 		void _gatherOutput(const char *data, unsigned int size) {
 			boost::lock_guard<boost::mutex> l(gatheredOutputSyncher);
 			gatheredOutput.append(data, size);
@@ -236,4 +249,33 @@ namespace tut {
 			result = gatheredOutput.find("hello world!\n") != string::npos;
 		);
 	}
+
+	TEST_METHOD(86) {
+		set_test_name("Multiple processes can be spawned from the same preloader "
+			"concurrently");
+		Options options = createOptions();
+		options.appRoot      = "stub/rack";
+		options.startCommand = "ruby\t" "start.rb";
+		options.startupFile  = "start.rb";
+		boost::shared_ptr<SmartSpawner> spawner = createSpawner(options);
+
+		const unsigned int count = 4;
+		SpawningKit::Result results[count];
+		bool failed[count];
+		boost::thread_group threads;
+		for (unsigned int i = 0; i < count; i++) {
+			failed[i] = false;
+			threads.create_thread(boost::bind(spawnInThread, spawner,
+				options, &results[i], &failed[i]));
+		}
+		threads.join_all();
+
+		set<int> pids;
+		for (unsigned int i = 0; i < count; i++) {
+			ensure("(" + toString(i) + ") Spawning succeeded", !failed[i]);
+			pids.insert(results[i]["pid"].asInt());
+		}
+		ensure_equals("Every spawn resulted in a different process",
+			pids.size(), (size_t) count);
+	}
 }
@@ -35,6 +35,14 @@ namespace tut {
 		boost::shared_ptr<UstRouter::Controller> controller;
 		ContextPtr context, context2, context3, context4;
 
+		// Second controller thread, only set up by initTwoThreads().
+		boost::shared_ptr<BackgroundEventLoop> bg2;
+		boost::shared_ptr<ServerKit::Context> skContext2;
+		string socketFilename2;
+		FileDescriptor serverFd2;
+		boost::shared_ptr<UstRouter::Controller> controller2;
+		ContextPtr context5;
+
 		Core_UnionStationTest()
 			: tmpdir("tmp.union_station")
 		{
@@ -55,6 +63,10 @@ namespace tut {
 				"localhost");
 			context4 = boost::make_shared<Context>(socketAddress, "test", "1234",
 				"localhost");
+
+			socketFilename2 = tmpdir.getPath() + "/socket2";
+			context5 = boost::make_shared<Context>("unix:" + socketFilename2,
+				"test", "1234", "localhost");
 		}
 
 		~Core_UnionStationTest() {
@@ -76,7 +88,52 @@ namespace tut {
 			bg->start();
 		}
 
+		/**
+		 * Sets up two controllers, each on its own event loop and listening on
+		 * its own socket, that share a single set of transaction shards. This
+		 * mirrors what the UstRouter does when started with `--threads 2`.
+		 */
+		void initTwoThreads() {
+			Json::Value config2 = config;
+			config["thread_number"] = 1;
+			config2["thread_number"] = 2;
+
+			bg = boost::make_shared<BackgroundEventLoop>(false, true);
+			skContext = boost::make_shared<ServerKit::Context>(bg->safe, bg->libuv_loop);
+			serverFd.assign(createUnixServer(socketFilename.c_str(), 0, true, __FILE__, __LINE__), NULL, 0);
+			controller = boost::make_shared<UstRouter::Controller>(
+				skContext.get(), schema, config);
+
+			bg2 = boost::make_shared<BackgroundEventLoop>(false, true);
+			skContext2 = boost::make_shared<ServerKit::Context>(bg2->safe, bg2->libuv_loop);
+			serverFd2.assign(createUnixServer(socketFilename2.c_str(), 0, true, __FILE__, __LINE__), NULL, 0);
+			controller2 = boost::make_shared<UstRouter::Controller>(
+				skContext2.get(), schema, config2);
+
+			controller->shardSet = boost::make_shared<UstRouter::ShardSet>(2,
+				controller->config);
+			controller2->shardSet = controller->shardSet;
+			controller->initialize();
+			controller->listen(serverFd);
+			controller2->initialize();
+			controller2->listen(serverFd2);
+			bg->start();
+			bg2->start();
+		}
+
 		void shutdown() {
+			if (bg2 != NULL) {
+				bg2->safe->runSync(boost::bind(&UstRouter::Controller::shutdown, controller2.get(), true));
+				while (getController2State() != UstRouter::Controller::FINISHED_SHUTDOWN) {
+					syscalls::usleep(1000000);
+				}
+				bg2->safe->runSync(boost::bind(&Core_UnionStationTest::destroyController2,
+					this));
+				bg2->stop();
+				bg2.reset();
+				skContext2.reset();
+				serverFd2.close();
+			}
 			if (bg != NULL) {
 				bg->safe->runSync(boost::bind(&UstRouter::Controller::shutdown, controller.get(), true));
 				while (getControllerState() != UstRouter::Controller::FINISHED_SHUTDOWN) {
@@ -95,6 +152,21 @@ namespace tut {
 			controller.reset();
 		}
 
+		void destroyController2() {
+			controller2.reset();
+		}
+
+		UstRouter::Controller::State getController2State() {
+			UstRouter::Controller::State result;
+			bg2->safe->runSync(boost::bind(&Core_UnionStationTest::_getController2State,
+				this, &result));
+			return result;
+		}
+
+		void _getController2State(UstRouter::Controller::State *state) {
+			*state = controller2->serverState;
+		}
+
 		UstRouter::Controller::State getControllerState() {
 			UstRouter::Controller::State result;
 			bg->safe->runSync(boost::bind(&Core_UnionStationTest::_getControllerState,
@@ -567,5 +639,28 @@ namespace tut {
 		ensureSubstringNotInDumpFile("transaction 2\n");
 	}
 
+
+	/***** Multithreading *****/
+
+	TEST_METHOD(30) {
+		set_test_name("A transaction can be continued through a different controller thread");
+		initTwoThreads();
+		SystemTime::forceAll(YESTERDAY);
+
+		TransactionPtr log = context->newTransaction("foobar");
+		log->message("message 1");
+
+		TransactionPtr log2 = context5->continueTransaction(log->getTxnId(),
+			log->getGroupName(), log->getCategory());
+		log2->message("message 2");
+
+		log.reset();
+		ensureSubstringNotInDumpFile("message 1\n");
+		log2.reset();
+
+		ensureSubstringInDumpFile("message 1\n");
+		ensureSubstringInDumpFile("message 2\n");
+	}
+
 	/************************************/
 }
@@ -4,6 +4,8 @@
 #include <oxt/system_calls.hpp>
 #include <boost/bind.hpp>
 #include <sys/types.h>
+#include <netinet/in.h>
+#include <poll.h>
 #include <cerrno>
 #include <string>
 
@@ -893,4 +895,54 @@ namespace tut {
 			ensure(timeout <= 2000);
 		}
 	}
+
+	/***** Test createReusePortServer() *****/
+
+	TEST_METHOD(82) {
+		// It allows multiple server sockets to listen on the same TCP port.
+		if (!reusePortLoadBalancingSupported()) {
+			return;
+		}
+
+		// Find a free port.
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+		{
+			FileDescriptor server(createTcpServer("127.0.0.1", 0, 0,
+				__FILE__, __LINE__), NULL, 0);
+			ensure_equals("(1)", getsockname(server, (struct sockaddr *) &addr, &len), 0);
+		}
+		string address = "tcp://127.0.0.1:" + toString(ntohs(addr.sin_port));
+
+		FileDescriptor server1(createReusePortServer(address, 0,
+			__FILE__, __LINE__), NULL, 0);
+		FileDescriptor server2(createReusePortServer(address, 0,
+			__FILE__, __LINE__), NULL, 0);
+		FileDescriptor client(connectToServer(address, __FILE__, __LINE__), NULL, 0);
+		struct pollfd fds[2];
+		fds[0].fd = server1;
+		fds[0].events = POLLIN;
+		fds[1].fd = server2;
+		fds[1].events = POLLIN;
+		ensure_equals("(2)", poll(fds, 2, 1000), 1);
+
+		// A socket without SO_REUSEPORT cannot join them.
+		try {
+			FileDescriptor server3(createTcpServer("127.0.0.1", ntohs(addr.sin_port), 0,
+				__FILE__, __LINE__), NULL, 0);
+			fail("SystemException expected");
+		} catch (const SystemException &e) {
+			ensure_equals("(3)", e.code(), EADDRINUSE);
+		}
+	}
+
+	TEST_METHOD(83) {
+		// It only supports TCP addresses.
+		try {
+			createReusePortServer("unix:/tmp/foo.sock", 0, __FILE__, __LINE__);
+			fail("ArgumentException expected");
+		} catch (const ArgumentException &) {
+			// Pass.
+		}
+	}
 }
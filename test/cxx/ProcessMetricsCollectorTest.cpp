@@ -120,4 +120,74 @@ namespace tut {
 			ensure(swap < 10000 || swap == -1);
 		#endif
 	}
+
+	#ifdef __linux__
+		TEST_METHOD(4) {
+			// On Linux, it collects metrics from /proc without spawning 'ps'.
+			child = spawnChild(10);
+			usleep(200000);
+			ensure("(1)", collector.isProcfsEnabled());
+
+			vector<pid_t> pids;
+			pids.push_back(getpid());
+			pids.push_back(child);
+			ProcessMetricMap result = collector.collect(pids);
+			ensure_equals("(2)", result.size(), 2u);
+
+			ProcessMetrics &self = result[getpid()];
+			ensure_equals("(3)", self.pid, getpid());
+			ensure_equals("(4)", self.ppid, getppid());
+			ensure_equals("(5)", self.processGroupId, getpgrp());
+			ensure_equals("(6)", self.uid, geteuid());
+			ensure("(7)", self.rss > 0);
+			ensure("(8)", self.vmsize >= self.rss);
+			ensure("(9)", self.command.find("main") != string::npos);
+
+			ProcessMetrics &childMetrics = result[child];
+			ensure_equals("(10)", childMetrics.ppid, getpid());
+			ensure("(11)", startsWith(childMetrics.command,
+				"../buildout/test/allocate_memory 10"));
+			ensure("(12)", childMetrics.privateDirty > 10000);
+		}
+
+		TEST_METHOD(5) {
+			// The /proc backend does not collect the metrics for PIDs that don't exist.
+			pid_t pid = fork();
+			if (pid == 0) {
+				_exit(0);
+			}
+			waitpid(pid, NULL, 0);
+
+			vector<pid_t> pids;
+			pids.push_back(getpid());
+			pids.push_back(pid);
+			ProcessMetricMap result = collector.collect(pids);
+			ensure_equals("(1)", result.size(), 1u);
+			ensure("(2)", result.find(pid) == result.end());
+		}
+
+		TEST_METHOD(6) {
+			// The /proc backend agrees with the 'ps' backend.
+			child = spawnChild(10);
+			usleep(200000);
+			vector<pid_t> pids;
+			pids.push_back(child);
+
+			ProcessMetricMap procfs = collector.collect(pids);
+			collector.setProcfsEnabled(false);
+			ProcessMetricMap ps = collector.collect(pids);
+
+			ensure_equals("(1)", procfs.size(), 1u);
+			ensure_equals("(2)", ps.size(), 1u);
+			ensure_equals("(3)", procfs[child].ppid, ps[child].ppid);
+			ensure_equals("(4)", procfs[child].processGroupId, ps[child].processGroupId);
+			ensure_equals("(5)", procfs[child].uid, ps[child].uid);
+			ensure_equals("(6)", procfs[child].command, ps[child].command);
+			ensure_equals("(7)", procfs[child].vmsize, ps[child].vmsize);
+			ensure("(8)", procfs[child].rss > ps[child].rss * 9 / 10
+				&& procfs[child].rss < ps[child].rss * 11 / 10);
+			ensure("(9)", procfs[child].privateDirty > ps[child].privateDirty * 9 / 10
+				&& procfs[child].privateDirty < ps[child].privateDirty * 11 / 10);
+		}
+	#endif
 }
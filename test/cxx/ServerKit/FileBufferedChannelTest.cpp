@@ -1,11 +1,14 @@
 #include <TestSupport.h>
 #include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <string>
 #include <BackgroundEventLoop.h>
 #include <Constants.h>
 #include <Logging.h>
 #include <StaticString.h>
 #include <ServerKit/FileBufferedChannel.h>
+#include <ServerKit/FileIoRing.h>
+#include <ServerKit/BufferFilePool.h>
 #include <Utils/StrIntUtils.h>
 
 using namespace Passenger;
@@ -26,6 +29,8 @@ namespace tut {
 		unsigned int counter;
 		unsigned int buffersFlushed;
 		string log;
+		boost::scoped_ptr<FileIoRing> fileIoRing;
+		boost::scoped_ptr<BufferFilePool> bufferFilePool;
 
 		ServerKit_FileBufferedChannelTest()
 			: bg(false, true),
@@ -55,6 +60,15 @@ namespace tut {
 			channel.deinitialize(); // Cancel any event loop next tick callbacks.
 		}
 
+		void feedAndDeinitialize(const char *data) {
+			_feedChannel(data);
+			if (channel.getWriterState() == FileBufferedChannel::WS_MOVING) {
+				boost::lock_guard<boost::mutex> l(syncher);
+				log.append("Moving\n");
+			}
+			channel.deinitialize();
+		}
+
 		void startLoop() {
 			if (!bg.isStarted()) {
 				bg.start();
@@ -204,6 +218,44 @@ namespace tut {
 		void _setChannelDataCallback(FileBufferedChannel::DataCallback callback) {
 			channel.setDataCallback(callback);
 		}
+
+		bool enableFileIoRing() {
+			fileIoRing.reset(new FileIoRing(bg.libev_loop));
+			if (!fileIoRing->initialize()) {
+				fileIoRing.reset();
+				return false;
+			}
+			context.fileIoRing = fileIoRing.get();
+			return true;
+		}
+
+		Json::Value inspectFileIoRing() {
+			Json::Value result;
+			bg.safe->runSync(boost::bind(&ServerKit_FileBufferedChannelTest::_inspectFileIoRing,
+				this, &result));
+			return result;
+		}
+
+		void _inspectFileIoRing(Json::Value *result) {
+			*result = fileIoRing->inspectStateAsJson();
+		}
+
+		void enableBufferFilePool(unsigned int max) {
+			bufferFilePool.reset(new BufferFilePool(bg.libuv_loop,
+				context.defaultFileBufferedChannelConfig.bufferDir, max));
+			context.bufferFilePool = bufferFilePool.get();
+		}
+
+		Json::Value inspectBufferFilePool() {
+			Json::Value result;
+			bg.safe->runSync(boost::bind(&ServerKit_FileBufferedChannelTest::_inspectBufferFilePool,
+				this, &result));
+			return result;
+		}
+
+		void _inspectBufferFilePool(Json::Value *result) {
+			*result = bufferFilePool->inspectStateAsJson();
+		}
 	};
 
 	DEFINE_TEST_GROUP_WITH_LIMIT(ServerKit_FileBufferedChannelTest, 100);
@@ -995,4 +1047,198 @@ namespace tut {
 			ensure_equals(counter, 2u);
 		}
 	}
+
+
+	/***** When using io_uring for file I/O *****/
+
+	TEST_METHOD(50) {
+		set_test_name("It moves memory buffers to disk and reads them back through io_uring");
+
+		if (!enableFileIoRing()) {
+			return;
+		}
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+
+		feedChannel("hello");
+		feedChannel("world!");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+		ensure_equals(getChannelBytesBuffered(), 0u);
+
+		channelConsumed(sizeof("hello") - 1, false);
+		EVENTUALLY(5,
+			LOCK();
+			result = log ==
+				"Data: hello\n"
+				"Data: world!\n";
+		);
+
+		Json::Value doc = inspectFileIoRing();
+		ensure("Writes went through the ring", doc["total_completed"].asUInt64() >= 2);
+		ensure_equals(doc["total_completed"].asUInt64(), doc["total_submitted"].asUInt64());
+		ensure_equals(doc["inflight"].asUInt(), 0u);
+	}
+
+	TEST_METHOD(51) {
+		set_test_name("It reads data from disk in multiple chunks through io_uring");
+
+		if (!enableFileIoRing()) {
+			return;
+		}
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+		feedChannel("hello");
+		feedChannel("world!");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+
+		context.defaultFileBufferedChannelConfig.maxDiskChunkReadSize = sizeof("world") - 1;
+		toConsume = CONSUME_FULLY;
+		channelConsumed(sizeof("hello") - 1, false);
+		EVENTUALLY(5,
+			LOCK();
+			result = log ==
+				"Data: hello\n"
+				"Data: world\n"
+				"Data: !\n";
+		);
+	}
+
+	TEST_METHOD(52) {
+		set_test_name("Deinitializing the channel while io_uring requests are "
+			"in flight is safe");
+
+		if (!enableFileIoRing()) {
+			return;
+		}
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+		feedChannel("hello");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+
+		bg.safe->runSync(boost::bind(&ServerKit_FileBufferedChannelTest::feedAndDeinitialize,
+			this, "world"));
+		{
+			LOCK();
+			ensure("A write was in flight", log.find("Moving\n") != string::npos);
+		}
+		EVENTUALLY(5,
+			result = inspectFileIoRing()["inflight"].asUInt() == 0;
+		);
+	}
+
+	/***** When using a buffer file pool *****/
+
+	TEST_METHOD(55) {
+		set_test_name("It takes its buffer file from the pool, and puts it "
+			"back when switching back to the in-memory mode");
+
+		enableBufferFilePool(1);
+		ensure_equals(bufferFilePool->fill(), 1u);
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+
+		feedChannel("hello");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+		Json::Value doc = inspectBufferFilePool();
+		ensure_equals("The pooled file is in use", doc["size"].asUInt(), 0u);
+		ensure_equals(doc["reuse_hits"].asUInt64(), 1u);
+
+		channelConsumed(sizeof("hello") - 1, false);
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_MEMORY_MODE;
+		);
+		EVENTUALLY(5,
+			result = inspectBufferFilePool()["size"].asUInt() == 1;
+		);
+		doc = inspectBufferFilePool();
+		ensure_equals("No files were created after filling", doc["files_created"].asUInt64(), 1u);
+		ensure_equals(doc["files_discarded"].asUInt64(), 0u);
+
+		// The recycled file is usable again.
+		feedChannel("world");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE
+				&& getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+		channelConsumed(sizeof("world") - 1, false);
+		EVENTUALLY(5,
+			LOCK();
+			result = log ==
+				"Data: hello\n"
+				"Data: world\n";
+		);
+		ensure_equals(inspectBufferFilePool()["reuse_hits"].asUInt64(), 2u);
+	}
+
+	TEST_METHOD(56) {
+		set_test_name("If the pool is empty, it creates a buffer file by itself "
+			"and records the creation");
+
+		enableBufferFilePool(1);
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+
+		feedChannel("hello");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+		Json::Value doc = inspectBufferFilePool();
+		ensure_equals(doc["files_created"].asUInt64(), 1u);
+		ensure_equals(doc["reuse_misses"].asUInt64(), 1u);
+
+		channelConsumed(sizeof("hello") - 1, false);
+		EVENTUALLY(5,
+			result = inspectBufferFilePool()["size"].asUInt() == 1;
+		);
+	}
+
+	TEST_METHOD(57) {
+		set_test_name("If the pool is full, buffer files are closed instead of pooled");
+
+		enableBufferFilePool(0);
+		toConsume = -1;
+		context.defaultFileBufferedChannelConfig.threshold = 1;
+		startLoop();
+
+		feedChannel("hello");
+		EVENTUALLY(5,
+			result = getChannelMode() == FileBufferedChannel::IN_FILE_MODE;
+		);
+		EVENTUALLY(5,
+			result = getChannelWriterState() == FileBufferedChannel::WS_INACTIVE;
+		);
+		channelConsumed(sizeof("hello") - 1, false);
+		EVENTUALLY(5,
+			result = inspectBufferFilePool()["files_discarded"].asUInt64() == 1;
+		);
+		ensure_equals(inspectBufferFilePool()["size"].asUInt(), 0u);
+	}
 }
@@ -191,4 +191,63 @@ namespace tut {
 
 		ensure_equals<void *>("(3)", table.lookup("Content-Length"), NULL);
 	}
+
+	TEST_METHOD(11) {
+		set_test_name("Every well-known header name is classified as itself");
+		for (unsigned int i = 0; i < WKH_COUNT; i++) {
+			const HashedStaticString &name = WELL_KNOWN_HEADERS.getName((WellKnownHeaderId) i);
+			ensure_equals("(1)", WELL_KNOWN_HEADERS.lookup(name), (WellKnownHeaderId) i);
+		}
+		ensure_equals("(2)", WELL_KNOWN_HEADERS.lookup("x-forwarded-for"), WKH_UNKNOWN);
+		ensure_equals("(3)", WELL_KNOWN_HEADERS.lookup("Host"), WKH_UNKNOWN);
+		ensure_equals("(4)", WELL_KNOWN_HEADERS.lookup(""), WKH_UNKNOWN);
+	}
+
+	TEST_METHOD(12) {
+		set_test_name("Well-known headers can be looked up by ID");
+		ensure_equals<void *>("(1)", table.lookup(WKH_HOST), NULL);
+
+		table.insert(pool, "Host", "foo.com");
+		table.insert(pool, "X-Forwarded-For", "bar.com");
+		table.insert(pool, "Content-Length", "5");
+		ensure("(2)", psg_lstr_cmp(table.lookup(WKH_HOST), "foo.com"));
+		ensure("(3)", psg_lstr_cmp(table.lookup(WKH_CONTENT_LENGTH), "5"));
+		ensure_equals<void *>("(4)", table.lookup(WKH_CONTENT_TYPE), NULL);
+		ensure("(5)", table.lookupHeader(WKH_HOST) == table.lookupHeader("host"));
+
+		insertHeader(createHeader("cookie", "a"), pool);
+		insertHeader(createHeader("cookie", "b"), pool);
+		ensure("(6)", psg_lstr_cmp(table.lookup(WKH_COOKIE), "a;b"));
+	}
+
+	TEST_METHOD(13) {
+		set_test_name("ID lookups stay consistent across growing, erasing, clearing and copying");
+		table.insert(pool, "Host", "foo.com");
+		table.insert(pool, "Date", "today");
+		vector<string> names;
+		for (unsigned int i = 0; i < 100; i++) {
+			names.push_back("X-Header-" + toString(i));
+		}
+		for (unsigned int i = 0; i < names.size(); i++) {
+			table.insert(pool, names[i], "value");
+		}
+		ensure("(1)", table.arraySize() > (unsigned int) HeaderTable::DEFAULT_SIZE);
+		ensure("(2)", psg_lstr_cmp(table.lookup(WKH_HOST), "foo.com"));
+		ensure("(3)", psg_lstr_cmp(table.lookup(WKH_DATE), "today"));
+
+		table.erase("host");
+		ensure_equals<void *>("(4)", table.lookup(WKH_HOST), NULL);
+		ensure("(5)", psg_lstr_cmp(table.lookup(WKH_DATE), "today"));
+
+		HeaderTable copy(table);
+		ensure("(6)", psg_lstr_cmp(copy.lookup(WKH_DATE), "today"));
+		ensure_equals<void *>("(7)", copy.lookup(WKH_HOST), NULL);
+
+		table.clear();
+		ensure_equals<void *>("(8)", table.lookup(WKH_DATE), NULL);
+		table.insert(pool, "Host", "bar.com");
+		ensure("(9)", psg_lstr_cmp(table.lookup(WKH_HOST), "bar.com"));
+		ensure_equals<void *>("(10)", table.lookup(WKH_DATE), NULL);
+		ensure("(11)", psg_lstr_cmp(copy.lookup(WKH_DATE), "today"));
+	}
 }
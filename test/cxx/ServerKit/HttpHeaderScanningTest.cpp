@@ -0,0 +1,172 @@
+#include <TestSupport.h>
+#include <ServerKit/HttpHeaderScanning.h>
+#include <ServerKit/http_parser.h>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Passenger;
+using namespace Passenger::ServerKit;
+using namespace std;
+
+namespace tut {
+	struct ServerKit_HttpHeaderScanningTest {
+		HttpHeaderScanningLevel originalLevel;
+		HttpHeaderScanningLevel supportedLevel;
+		vector<HttpHeaderScanningLevel> levels;
+
+		ServerKit_HttpHeaderScanningTest() {
+			originalLevel = httpHeaderScanningLevel();
+			supportedLevel = detectHttpHeaderScanningLevel();
+			levels.push_back(HHSL_SCALAR);
+			if (supportedLevel >= HHSL_SSE42) {
+				levels.push_back(HHSL_SSE42);
+			}
+			if (supportedLevel >= HHSL_AVX2) {
+				levels.push_back(HHSL_AVX2);
+			}
+		}
+
+		~ServerKit_HttpHeaderScanningTest() {
+			httpHeaderScanningLevel() = originalLevel;
+		}
+
+		/**
+		 * Checks that every scanning level stops at the same byte as the
+		 * scalar implementation, for every start offset within `str`.
+		 */
+		void checkAllLevels(const string &str) {
+			const char *end = str.data() + str.size();
+			for (unsigned int i = 0; i < levels.size(); i++) {
+				httpHeaderScanningLevel() = levels[i];
+				for (unsigned int offset = 0; offset <= str.size(); offset++) {
+					const char *start = str.data() + offset;
+					ensure_equals(("Token scan at level " + toString(levels[i])
+							+ ", offset " + toString(offset)).c_str(),
+						scanHttpHeaderToken(start, end) - str.data(),
+						scanHttpHeaderTokenScalar(start, end) - str.data());
+					ensure_equals(("Value scan at level " + toString(levels[i])
+							+ ", offset " + toString(offset)).c_str(),
+						scanHttpHeaderValue(start, end) - str.data(),
+						scanHttpHeaderValueScalar(start, end) - str.data());
+				}
+			}
+		}
+	};
+
+	DEFINE_TEST_GROUP(ServerKit_HttpHeaderScanningTest);
+
+	TEST_METHOD(1) {
+		set_test_name("The token table agrees with RFC 7230");
+		const char *extra = "!#$%&'*+-.^_`|~";
+		for (unsigned int c = 0; c < 256; c++) {
+			bool expected = (c >= '0' && c <= '9')
+				|| (c >= 'A' && c <= 'Z')
+				|| (c >= 'a' && c <= 'z')
+				|| (c != 0 && strchr(extra, (int) c) != NULL);
+			ensure_equals(("Byte " + toString(c)).c_str(),
+				(bool) httpHeaderTokenChars[c], expected);
+		}
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("All levels stop at the same byte for every possible byte value");
+		for (unsigned int c = 0; c < 256; c++) {
+			string str(70, 'a');
+			// Place the byte in a 32-byte block, a 16-byte block and the tail.
+			str[5] = (char) c;
+			str[40] = (char) c;
+			str[68] = (char) c;
+			checkAllLevels(str);
+		}
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("All levels stop at the same byte for random strings");
+		const char alphabet[] = "abcXYZ019-_.~!:; \t\r\n\x7f\x80\xff";
+		srand(1234);
+		for (unsigned int i = 0; i < 500; i++) {
+			string str;
+			unsigned int len = rand() % 100;
+			for (unsigned int j = 0; j < len; j++) {
+				// Mostly token characters, so that scans run for a while.
+				if (rand() % 20 == 0) {
+					str.append(1, alphabet[rand() % (sizeof(alphabet) - 1)]);
+				} else {
+					str.append(1, 'a' + rand() % 26);
+				}
+			}
+			checkAllLevels(str);
+		}
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Scans do not read past the end");
+		for (unsigned int i = 0; i < levels.size(); i++) {
+			httpHeaderScanningLevel() = levels[i];
+			string str(64, 'a');
+			ensure_equals(scanHttpHeaderToken(str.data(), str.data() + 33)
+				- str.data(), 33);
+			ensure_equals(scanHttpHeaderValue(str.data(), str.data() + 17)
+				- str.data(), 17);
+			ensure_equals(scanHttpHeaderToken(str.data(), str.data())
+				- str.data(), 0);
+		}
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("http_parser reports the same header boundaries at all levels");
+		string request = "GET / HTTP/1.1\r\n"
+			"Host: www.example.com\r\n"
+			"User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+				"(KHTML, like Gecko) Chrome/58.0.3029.110 Safari/537.36\r\n"
+			"X-Some-Very-Long-Header-Name-That-Spans-Multiple-Blocks: 1\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n";
+		for (unsigned int i = 0; i < levels.size(); i++) {
+			httpHeaderScanningLevel() = levels[i];
+			// Feed byte-sized and whole chunks.
+			for (unsigned int chunkSize = 1; chunkSize <= request.size();
+				chunkSize = (chunkSize == 1) ? request.size() : chunkSize + 1)
+			{
+				http_parser parser;
+				http_parser_settings settings;
+				size_t offset = 0;
+
+				memset(&settings, 0, sizeof(settings));
+				http_parser_init(&parser, HTTP_REQUEST);
+				while (offset < request.size()) {
+					size_t size = std::min<size_t>(chunkSize, request.size() - offset);
+					size_t parsed = http_parser_execute(&parser, &settings,
+						request.data() + offset, size);
+					ensure_equals("No parse error", parsed, size);
+					offset += size;
+				}
+				ensure_equals(HTTP_PARSER_ERRNO(&parser), HPE_OK);
+				ensure_equals(parser.content_length, 0u);
+			}
+		}
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("http_parser still enforces the maximum header size");
+		string request = "GET / HTTP/1.1\r\n"
+			"X-Big: " + string(HTTP_MAX_HEADER_SIZE, 'x') + "\r\n\r\n";
+		size_t expected = 0;
+		for (unsigned int i = 0; i < levels.size(); i++) {
+			httpHeaderScanningLevel() = levels[i];
+			http_parser parser;
+			http_parser_settings settings;
+
+			memset(&settings, 0, sizeof(settings));
+			http_parser_init(&parser, HTTP_REQUEST);
+			size_t parsed = http_parser_execute(&parser, &settings,
+				request.data(), request.size());
+			ensure_equals(HTTP_PARSER_ERRNO(&parser), HPE_HEADER_OVERFLOW);
+			if (i == 0) {
+				expected = parsed;
+			} else {
+				ensure_equals("Error raised at the same byte", parsed, expected);
+			}
+		}
+	}
+}
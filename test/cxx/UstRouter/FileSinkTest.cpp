@@ -0,0 +1,204 @@
+#include "TestSupport.h"
+#include <Core/UnionStation/Context.h>
+#include <Core/UnionStation/Transaction.h>
+#include <UstRouter/FileSink.h>
+#include <UstRouter/Controller.h>
+
+using namespace Passenger;
+using namespace Passenger::UstRouter;
+using namespace std;
+
+namespace tut {
+	struct UstRouter_FileSinkTest {
+		TempDir tmpdir;
+		string path;
+
+		boost::shared_ptr<BackgroundEventLoop> bg;
+		boost::shared_ptr<ServerKit::Context> skContext;
+		FileDescriptor serverFd;
+		Controller::Schema schema;
+		boost::shared_ptr<Controller> controller;
+
+		UstRouter_FileSinkTest()
+			: tmpdir("tmp.file_sink")
+		{
+			path = tmpdir.getPath() + "/requests";
+		}
+
+		~UstRouter_FileSinkTest() {
+			if (controller != NULL) {
+				setLogLevel(LVL_CRIT);
+				bg->safe->runSync(boost::bind(&Controller::shutdown,
+					controller.get(), true));
+				while (getControllerState() != Controller::FINISHED_SHUTDOWN) {
+					syscalls::usleep(10000);
+				}
+				bg->safe->runSync(boost::bind(&UstRouter_FileSinkTest::destroyController,
+					this));
+				bg->stop();
+				setLogLevel(DEFAULT_LOG_LEVEL);
+			}
+		}
+
+		void initController(const Json::Value &config) {
+			string socketFilename = tmpdir.getPath() + "/socket";
+			bg = boost::make_shared<BackgroundEventLoop>(false, true);
+			skContext = boost::make_shared<ServerKit::Context>(bg->safe, bg->libuv_loop);
+			serverFd.assign(createUnixServer(socketFilename.c_str(), 0, true,
+				__FILE__, __LINE__), NULL, 0);
+			controller = boost::make_shared<Controller>(skContext.get(), schema, config);
+			controller->initialize();
+			controller->listen(serverFd);
+			bg->start();
+		}
+
+		void destroyController() {
+			controller.reset();
+		}
+
+		Controller::State getControllerState() {
+			Controller::State result;
+			bg->safe->runSync(boost::bind(&UstRouter_FileSinkTest::_getControllerState,
+				this, &result));
+			return result;
+		}
+
+		void _getControllerState(Controller::State *state) {
+			*state = controller->serverState;
+		}
+
+		TransactionPtr createTransaction(const StaticString &message) {
+			TransactionPtr transaction = boost::make_shared<Transaction>("txnId",
+				"groupName", "nodeName", "requests", "unionStationKey", 1234,
+				"filters");
+			transaction->append("timestamp", message);
+			return transaction;
+		}
+
+		string readFile() {
+			return readAll(path);
+		}
+	};
+
+	DEFINE_TEST_GROUP(UstRouter_FileSinkTest);
+
+	TEST_METHOD(1) {
+		set_test_name("With the buffered policy, transactions are only written "
+			"after the sink is flushed");
+		FileSink sink(path, FSP_BUFFERED);
+
+		sink.append(createTransaction("hello"));
+		sink.append(createTransaction("world"));
+		ensure("(1)", sink.hasBufferedData());
+		ensure("(2)", !sink.hasPendingData());
+		sink.writePendingData();
+		ensure_equals("(3)", readFile(), "");
+
+		ensure("(4)", sink.flush());
+		ensure("(5)", !sink.hasBufferedData());
+		ensure("(6)", sink.hasPendingData());
+		// Flushing only queues the data; the file is written outside
+		// the shard lock.
+		ensure_equals("(7)", readFile(), "");
+
+		sink.writePendingData();
+		ensure("(8)", !sink.hasPendingData());
+		ensure_equals("(9)", readFile(),
+			"txnId timestamp 0 hello\n"
+			"txnId timestamp 0 world\n");
+		ensure("(10)", !sink.flush());
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("With the write_through policy, every transaction is "
+			"queued for writing immediately");
+		FileSink sink(path, FSP_WRITE_THROUGH);
+
+		sink.append(createTransaction("hello"));
+		ensure("(1)", !sink.hasBufferedData());
+		ensure("(2)", sink.hasPendingData());
+		sink.writePendingData();
+		ensure_equals("(3)", readFile(), "txnId timestamp 0 hello\n");
+
+		sink.append(createTransaction("world"));
+		sink.writePendingData();
+		ensure_equals("(4)", readFile(),
+			"txnId timestamp 0 hello\n"
+			"txnId timestamp 0 world\n");
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("The fdatasync policy buffers transactions like the buffered policy");
+		FileSink sink(path, FSP_FDATASYNC);
+
+		sink.append(createTransaction("hello"));
+		ensure("(1)", sink.hasBufferedData());
+		sink.writePendingData();
+		ensure_equals("(2)", readFile(), "");
+
+		ensure("(3)", sink.flush());
+		sink.writePendingData();
+		ensure_equals("(4)", readFile(), "txnId timestamp 0 hello\n");
+		ensure_equals("(5)", sink.inspectStateAsJson()["policy"].asString(),
+			"fdatasync");
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("A transaction that doesn't fit in the buffer is written "
+			"together with the buffer, without being copied into it");
+		FileSink sink(path, FSP_BUFFERED);
+		string large(FileSink::BUFFER_CAPACITY, 'x');
+
+		sink.append(createTransaction("hello"));
+		sink.append(createTransaction(large));
+		ensure("(1)", !sink.hasBufferedData());
+		ensure("(2)", sink.hasPendingData());
+		ensure_equals("(3)", readFile(), "");
+
+		sink.writePendingData();
+		ensure_equals("(4)", readFile(),
+			"txnId timestamp 0 hello\n"
+			"txnId timestamp 0 " + large + "\n");
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("The controller writes buffered dump files before its "
+			"event loop blocks");
+		Json::Value config;
+		config["ust_router_username"] = "test";
+		config["ust_router_password"] = "1234";
+		config["ust_router_dev_mode"] = true;
+		config["ust_router_dump_dir"] = tmpdir.getPath();
+		// Make sure that the flush timer doesn't write the dump file.
+		config["analytics_sink_flush_timer_interval"] = 3600;
+		setLogLevel(LVL_ERROR);
+		initController(config);
+
+		UnionStation::ContextPtr context = boost::make_shared<UnionStation::Context>(
+			"unix:" + tmpdir.getPath() + "/socket", "test", "1234", "localhost");
+		UnionStation::TransactionPtr log = context->newTransaction("foobar");
+		log->message("hello");
+		log.reset();
+
+		EVENTUALLY(5,
+			result = fileExists(path) && readFile().find("hello\n") != string::npos;
+		);
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("The schema rejects unknown dump file policies");
+		ConfigKit::Store config(schema);
+		Json::Value updates;
+		vector<ConfigKit::Error> errors;
+
+		updates["ust_router_dump_file_policy"] = "fdatasync";
+		config.previewUpdate(updates, errors);
+		ensure("(1)", errors.empty());
+
+		updates["ust_router_dump_file_policy"] = "sometimes";
+		config.previewUpdate(updates, errors);
+		ensure_equals("(2)", errors.size(), 1u);
+		ensure("(3)", containsSubstring(errors[0].getMessage(),
+			"'ust_router_dump_file_policy' must be 'buffered', 'write_through' or 'fdatasync'"));
+	}
+}
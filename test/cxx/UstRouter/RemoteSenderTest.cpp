@@ -0,0 +1,239 @@
+#include "TestSupport.h"
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <zlib.h>
+#include <modp_b64.h>
+#include <UstRouter/RemoteSender.h>
+#include <Utils/IOUtils.h>
+
+using namespace Passenger;
+using namespace std;
+
+namespace tut {
+	/**
+	 * A minimal stand-in for the Union Station gateway. It serves one
+	 * request per connection, and records the uncompressed data of
+	 * every sink request.
+	 */
+	class TestGateway {
+	private:
+		FileDescriptor serverFd;
+		boost::scoped_ptr<TempThread> thr;
+		mutable boost::mutex syncher;
+		vector<string> packets;
+
+		void threadMain() {
+			while (!boost::this_thread::interruption_requested()) {
+				FileDescriptor fd(syscalls::accept(serverFd, NULL, NULL),
+					__FILE__, __LINE__);
+				if (fd == -1) {
+					int e = errno;
+					throw SystemException("accept() failed", e);
+				}
+				handleConnection(fd);
+			}
+		}
+
+		void handleConnection(const FileDescriptor &fd) {
+			string request;
+			string::size_type headerEnd;
+			char buf[1024 * 16];
+			ssize_t ret;
+
+			while ((headerEnd = request.find("\r\n\r\n")) == string::npos) {
+				ret = syscalls::read(fd, buf, sizeof(buf));
+				if (ret <= 0) {
+					return;
+				}
+				request.append(buf, ret);
+			}
+
+			string header = request.substr(0, headerEnd);
+			string body = request.substr(headerEnd + 4);
+			size_t contentLength = 0;
+			string::size_type pos = header.find("Content-Length: ");
+			if (pos != string::npos) {
+				contentLength = atoi(header.c_str() + pos + sizeof("Content-Length: ") - 1);
+			}
+			if (header.find("Expect: 100-continue") != string::npos) {
+				writeExact(fd, P_STATIC_STRING("HTTP/1.1 100 Continue\r\n\r\n"));
+			}
+			while (body.size() < contentLength) {
+				ret = syscalls::read(fd, buf, sizeof(buf));
+				if (ret <= 0) {
+					return;
+				}
+				body.append(buf, ret);
+			}
+
+			string response;
+			if (startsWith(header, "GET /ping ")) {
+				response = "pong";
+			} else if (startsWith(header, "POST /sink ")) {
+				boost::lock_guard<boost::mutex> l(syncher);
+				packets.push_back(extractData(body));
+				response = "{\"status\": \"ok\"}";
+			}
+			writeExact(fd, "HTTP/1.1 200 OK\r\n"
+				"Connection: close\r\n"
+				"Content-Length: " + toString(response.size()) + "\r\n\r\n"
+				+ response);
+		}
+
+		static string extractData(const string &body) {
+			const string marker = "name=\"data\"\r\n\r\n";
+			string::size_type begin = body.find(marker);
+			if (begin == string::npos) {
+				return string();
+			}
+			begin += marker.size();
+			string::size_type end = body.find("\r\n--", begin);
+			string data = modp::b64_decode(body.substr(begin, end - begin));
+			return decompress(data);
+		}
+
+		static string decompress(const string &data) {
+			z_stream strm;
+			char out[1024 * 16];
+			string result;
+			int ret;
+
+			memset(&strm, 0, sizeof(strm));
+			inflateInit(&strm);
+			strm.avail_in = data.size();
+			strm.next_in = (Bytef *) data.data();
+			do {
+				strm.avail_out = sizeof(out);
+				strm.next_out = (Bytef *) out;
+				ret = inflate(&strm, Z_NO_FLUSH);
+				result.append(out, sizeof(out) - strm.avail_out);
+			} while (ret == Z_OK);
+			inflateEnd(&strm);
+			return result;
+		}
+
+	public:
+		unsigned short port;
+
+		TestGateway() {
+			serverFd.assign(createTcpServer("127.0.0.1", 0), NULL, 0);
+			port = getPort(serverFd);
+		}
+
+		static unsigned short getPort(int fd) {
+			struct sockaddr_in addr;
+			socklen_t len = sizeof(addr);
+			getsockname(fd, (struct sockaddr *) &addr, &len);
+			return ntohs(addr.sin_port);
+		}
+
+		void start() {
+			thr.reset(new TempThread(boost::bind(&TestGateway::threadMain, this)));
+		}
+
+		vector<string> getPackets() const {
+			boost::lock_guard<boost::mutex> l(syncher);
+			return packets;
+		}
+	};
+
+	struct UstRouter_RemoteSenderTest {
+		TempDir tmpdir;
+		TestGateway gateway;
+		boost::scoped_ptr<RemoteSender> sender;
+
+		UstRouter_RemoteSenderTest()
+			: tmpdir("tmp.remote_sender")
+			{ }
+
+		~UstRouter_RemoteSenderTest() {
+			sender.reset();
+		}
+
+		void init(unsigned short port, const string &spoolPath = string()) {
+			sender.reset(new RemoteSender("http://127.0.0.1", port, "", "",
+				spoolPath));
+		}
+
+		void schedule(const string &key, const string &category, const string &data) {
+			StaticString part(data);
+			sender->schedule(key, "node", category, &part, 1);
+		}
+
+		unsigned int packetsAccepted() {
+			return sender->inspectStateAsJson()["packets_accepted"].asUInt();
+		}
+	};
+
+	DEFINE_TEST_GROUP(UstRouter_RemoteSenderTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Packets with the same key and category are sent in a single upload");
+		init(gateway.port);
+		for (unsigned int i = 0; i < 5; i++) {
+			schedule("key", "requests", "request" + toString(i) + "\n");
+		}
+		schedule("key", "processes", "process\n");
+		gateway.start();
+
+		EVENTUALLY(5,
+			result = packetsAccepted() == 6;
+		);
+		vector<string> packets = gateway.getPackets();
+		sort(packets.begin(), packets.end());
+		ensure_equals("(1)", packets.size(), 2u);
+		ensure_equals("(2)", packets[0], "process\n");
+		ensure_equals("(3)", packets[1],
+			"request0\nrequest1\nrequest2\nrequest3\nrequest4\n");
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Packets that could not be sent are kept in the spool file, "
+			"and sent after a restart");
+		string spoolPath = tmpdir.getPath() + "/spool";
+		unsigned short closedPort;
+		{
+			FileDescriptor fd(createTcpServer("127.0.0.1", 0), NULL, 0);
+			closedPort = TestGateway::getPort(fd);
+		}
+
+		init(closedPort, spoolPath);
+		schedule("key", "requests", "foo\n");
+		schedule("key", "requests", "bar\n");
+		EVENTUALLY(5,
+			result = !sender->inspectStateAsJson()["last_server_checkup_time"].isNull();
+		);
+		sender.reset();
+
+		gateway.start();
+		init(gateway.port, spoolPath);
+		EVENTUALLY(5,
+			result = packetsAccepted() == 2;
+		);
+		ensure_equals("(1)", sender->queued(), 0u);
+		vector<string> packets = gateway.getPackets();
+		ensure_equals("(2)", packets.size(), 1u);
+		ensure_equals("(3)", packets[0], "foo\nbar\n");
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("Each upload contains at most MAX_BATCH_SIZE bytes of data");
+		string data(RemoteSender::MAX_BATCH_SIZE * 2 / 5, 'x');
+		init(gateway.port);
+		for (unsigned int i = 0; i < 3; i++) {
+			schedule("key", "requests", data);
+		}
+		gateway.start();
+
+		EVENTUALLY(10,
+			result = packetsAccepted() == 3;
+		);
+		vector<string> packets = gateway.getPackets();
+		ensure_equals("(1)", packets.size(), 2u);
+		ensure("(2)", packets[0].size() <= RemoteSender::MAX_BATCH_SIZE);
+		ensure("(3)", packets[1].size() <= RemoteSender::MAX_BATCH_SIZE);
+		ensure_equals("(4)", packets[0].size() + packets[1].size(), data.size() * 3);
+	}
+}
@@ -0,0 +1,227 @@
+#include "TestSupport.h"
+#include <UstRouter/Spool.h>
+
+using namespace Passenger;
+using namespace Passenger::UstRouter;
+using namespace std;
+
+namespace tut {
+	struct UstRouter_SpoolTest {
+		TempDir tmpdir;
+		string path;
+
+		UstRouter_SpoolTest()
+			: tmpdir("tmp.spool")
+		{
+			path = tmpdir.getPath() + "/spool";
+		}
+
+		bool append(Spool &spool, const StaticString &data) {
+			return spool.append(&data, 1);
+		}
+
+		string pop(Spool &spool) {
+			Spool::RecordId id = spool.firstAvailable();
+			string result = spool.get(id);
+			spool.acknowledge(id);
+			return result;
+		}
+	};
+
+	DEFINE_TEST_GROUP(UstRouter_SpoolTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Records are consumed in the order in which they were appended");
+		Spool spool("", 4096);
+		StaticString parts[] = { "hello ", "world" };
+
+		ensure("(1)", spool.empty());
+		ensure("(2)", spool.append(parts, 2));
+		ensure("(3)", append(spool, "foo"));
+		ensure_equals("(4)", spool.size(), (boost::uint64_t) 2);
+		ensure_equals("(5)", pop(spool), "hello world");
+		ensure_equals("(6)", pop(spool), "foo");
+		ensure("(7)", spool.empty());
+		ensure_equals("(8)", spool.bytesUsed(), 0u);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Appending fails when the spool is full, and consumed space is reused");
+		Spool spool("", 1024);
+		string data(200, 'x');
+		unsigned int count = 0;
+
+		while (append(spool, data)) {
+			count++;
+		}
+		ensure("(1)", count > 1);
+		ensure_equals("(2)", spool.size(), (boost::uint64_t) count);
+
+		pop(spool);
+		ensure("(3)", append(spool, data));
+		ensure_equals("(4)", spool.size(), (boost::uint64_t) count);
+		while (!spool.empty()) {
+			ensure_equals("(5)", pop(spool), data);
+		}
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("Records in a spool file survive reopening it");
+		{
+			Spool spool(path, 4096);
+			append(spool, "foo");
+			append(spool, "bar");
+			append(spool, "baz");
+			pop(spool);
+		}
+
+		Spool spool(path, 4096);
+		ensure_equals("(1)", spool.size(), (boost::uint64_t) 2);
+		ensure_equals("(2)", pop(spool), "bar");
+		ensure_equals("(3)", pop(spool), "baz");
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Corrupt records are discarded upon reopening a spool file");
+		size_t used;
+		{
+			Spool spool(path, 4096);
+			append(spool, "foo");
+			append(spool, "bar");
+			used = spool.bytesUsed();
+		}
+
+		// Damage the payload of the last record.
+		FileDescriptor fd(open(path.c_str(), O_RDWR), __FILE__, __LINE__);
+		char *data = (char *) mmap(NULL, 4096, PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+		ensure("(1)", data != MAP_FAILED);
+		char *bar = (char *) memmem(data, 64 + used, "bar", 3);
+		ensure("(2)", bar != NULL);
+		bar[0] = 'c';
+		munmap(data, 4096);
+
+		Spool spool(path, 4096);
+		ensure_equals("(3)", spool.size(), (boost::uint64_t) 1);
+		ensure_equals("(4)", pop(spool), "foo");
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("A file that isn't a spool is reinitialized");
+		createFile(path, "garbage");
+		Spool spool(path, 4096);
+		ensure("(1)", spool.empty());
+		ensure("(2)", append(spool, "foo"));
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("Claimed records are skipped until they are released, "
+			"and records may be acknowledged in any order");
+		Spool spool("", 4096);
+		append(spool, "foo");
+		append(spool, "bar");
+		append(spool, "baz");
+
+		Spool::RecordId foo = spool.firstAvailable();
+		Spool::RecordId bar = spool.nextAvailable(foo);
+		spool.claim(foo);
+		spool.claim(bar);
+		ensure_equals("(1)", spool.get(spool.firstAvailable()), "baz");
+		ensure_equals("(2)", spool.claimedSize(), (boost::uint64_t) 2);
+
+		spool.acknowledge(bar);
+		ensure_equals("(3)", spool.size(), (boost::uint64_t) 2);
+		spool.release(foo);
+		ensure_equals("(4)", spool.claimedSize(), (boost::uint64_t) 0);
+		ensure_equals("(5)", pop(spool), "foo");
+		ensure_equals("(6)", pop(spool), "baz");
+		ensure("(7)", spool.empty());
+		ensure_equals("(8)", spool.bytesUsed(), 0u);
+	}
+
+	TEST_METHOD(7) {
+		set_test_name("Records that were claimed but not acknowledged are "
+			"available again after reopening a spool file");
+		{
+			Spool spool(path, 4096);
+			append(spool, "foo");
+			append(spool, "bar");
+			append(spool, "baz");
+			Spool::RecordId foo = spool.firstAvailable();
+			Spool::RecordId bar = spool.nextAvailable(foo);
+			spool.claim(foo);
+			spool.claim(bar);
+			spool.acknowledge(bar);
+		}
+
+		Spool spool(path, 4096);
+		ensure_equals("(1)", spool.size(), (boost::uint64_t) 2);
+		ensure_equals("(2)", spool.claimedSize(), (boost::uint64_t) 0);
+		ensure_equals("(3)", pop(spool), "foo");
+		ensure_equals("(4)", pop(spool), "baz");
+		ensure("(5)", spool.empty());
+	}
+
+	TEST_METHOD(8) {
+		set_test_name("Compacting a spool file replaces the file and keeps "
+			"claimed records valid");
+		string data(200, 'x');
+		Spool::RecordId first, second;
+		unsigned int count = 0;
+		{
+			Spool spool(path, 1024);
+			while (append(spool, data)) {
+				count++;
+			}
+			ensure("(1)", !spool.needsCompaction());
+			first = spool.firstAvailable();
+			second = spool.nextAvailable(first);
+			spool.claim(first);
+			spool.claim(second);
+			spool.acknowledge(first);
+			ensure("(2)", spool.needsCompaction());
+			// append() doesn't compact spool files.
+			ensure("(3)", !append(spool, data));
+
+			Spool::Compaction compaction;
+			ensure("(4)", spool.beginCompaction(compaction));
+			spool.copyForCompaction(compaction);
+			ensure("(5)", append(spool, "foo"));
+			ensure("(6)", spool.syncCompaction(compaction));
+			spool.finishCompaction(compaction);
+
+			ensure("(7)", !spool.needsCompaction());
+			ensure_equals("(8)", getFileType(path + ".tmp"), FT_NONEXISTANT);
+			ensure_equals("(9)", spool.get(second), data);
+			spool.release(second);
+			ensure_equals("(10)", spool.firstAvailable(), second);
+			ensure("(11)", append(spool, data));
+		}
+
+		Spool spool(path, 1024);
+		ensure_equals("(12)", spool.size(), (boost::uint64_t) count + 1);
+		for (unsigned int i = 0; i < count - 1; i++) {
+			ensure_equals("(13)", pop(spool), data);
+		}
+		ensure_equals("(14)", pop(spool), "foo");
+		ensure_equals("(15)", pop(spool), data);
+	}
+
+	TEST_METHOD(9) {
+		set_test_name("An abandoned compaction leaves the spool file untouched");
+		string data(200, 'x');
+		{
+			Spool spool(path, 1024);
+			while (append(spool, data)) { }
+			spool.acknowledge(spool.firstAvailable());
+
+			Spool::Compaction compaction;
+			ensure("(1)", spool.beginCompaction(compaction));
+			spool.copyForCompaction(compaction);
+		}
+		ensure_equals("(2)", getFileType(path + ".tmp"), FT_NONEXISTANT);
+
+		Spool spool(path, 1024);
+		ensure_equals("(3)", pop(spool), data);
+	}
+}
@@ -116,4 +116,30 @@ namespace tut {
 			"txnId timestamp1 0 " + body1 + "\n"
 			"txnId timestamp2 1 " + body2 + "\n");
 	}
+
+	TEST_METHOD(6) {
+		set_test_name("The body is exposed as a list of chunks that together form the entire body");
+		Transaction t("txnId", "groupName", "nodeName", "category",
+			"unionStationKey", 1234, "filters");
+		string expected;
+
+		for (unsigned int i = 0; i < 100; i++) {
+			string data(100 + i, 'a' + i % 26);
+			t.append("timestamp", data);
+			expected.append("txnId timestamp " + integerToHexatri(i) + " " + data + "\n");
+		}
+
+		ensure_equals("(1)", t.getBodySize(), (unsigned int) expected.size());
+		ensure("(2)", t.getBodyChunkCount() > 1);
+
+		vector<StaticString> chunks(t.getBodyChunkCount());
+		string concatenated;
+		t.getBodyChunks(&chunks[0]);
+		for (unsigned int i = 0; i < chunks.size(); i++) {
+			ensure("(3)", !chunks[i].empty());
+			concatenated.append(chunks[i].data(), chunks[i].size());
+		}
+		ensure("(4)", concatenated == expected);
+		ensure("(5)", t.getBody() == expected);
+	}
 }
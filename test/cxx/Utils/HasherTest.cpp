@@ -0,0 +1,111 @@
+#include <TestSupport.h>
+#include <Utils/Hasher.h>
+#include <Utils/StrIntUtils.h>
+
+using namespace Passenger;
+using namespace std;
+
+namespace tut {
+	struct HasherTest {
+		template<typename Hash>
+		boost::uint32_t hash(const StaticString &data) {
+			Hash h;
+			h.update(data.data(), data.size());
+			return h.finalize();
+		}
+
+		template<typename Hash>
+		boost::uint32_t hashInChunks(const StaticString &data, unsigned int chunkSize) {
+			Hash h;
+			for (unsigned int i = 0; i < data.size(); i += chunkSize) {
+				h.update(data.data() + i, std::min<unsigned int>(chunkSize, data.size() - i));
+			}
+			return h.finalize();
+		}
+
+		template<typename Hash>
+		boost::uint32_t hashLowerCase(const StaticString &data, unsigned int chunkSize,
+			bool &foundUpperCase)
+		{
+			Hash h;
+			foundUpperCase = false;
+			for (unsigned int i = 0; i < data.size(); i += chunkSize) {
+				foundUpperCase |= h.updateLowerCase(data.data() + i,
+					std::min<unsigned int>(chunkSize, data.size() - i));
+			}
+			return h.finalize();
+		}
+
+		template<typename Hash>
+		void testStreaming() {
+			const StaticString data("The quick brown fox jumps over the lazy dog");
+			boost::uint32_t expected = hash<Hash>(data);
+			for (unsigned int chunkSize = 1; chunkSize <= data.size(); chunkSize++) {
+				ensure_equals(("Chunk size " + toString(chunkSize)).c_str(),
+					hashInChunks<Hash>(data, chunkSize), expected);
+			}
+		}
+
+		template<typename Hash>
+		void testLowerCase() {
+			const char *names[] = {
+				"Host", "Content-Length", "X-FORWARDED-FOR", "x-request-id",
+				"@[Z`a{z", "A", "", NULL
+			};
+			for (unsigned int i = 0; names[i] != NULL; i++) {
+				string name = names[i];
+				string downcased = name;
+				convertLowerCase((const unsigned char *) name.data(),
+					(unsigned char *) &downcased[0], name.size());
+				boost::uint32_t expected = hash<Hash>(downcased);
+
+				for (unsigned int chunkSize = 1; chunkSize <= 5; chunkSize++) {
+					bool foundUpperCase;
+					ensure_equals(("Hash of " + name).c_str(),
+						hashLowerCase<Hash>(name, chunkSize, foundUpperCase), expected);
+					ensure_equals(("Uppercase detection for " + name).c_str(),
+						foundUpperCase, name != downcased);
+				}
+			}
+		}
+	};
+
+	DEFINE_TEST_GROUP(HasherTest);
+
+	TEST_METHOD(1) {
+		set_test_name("MurmurHash3 matches the reference implementation");
+		ensure_equals(hash<MurmurHash3>(""), (boost::uint32_t) MurmurHash3::EMPTY_STRING_HASH);
+		ensure_equals(hash<MurmurHash3>(""), 0u);
+		ensure_equals(hash<MurmurHash3>("a"), 0x3c2569b2u);
+		ensure_equals(hash<MurmurHash3>("abc"), 0xb3dd93fau);
+		ensure_equals(hash<MurmurHash3>("Hello, world!"), 0xc0363e43u);
+		ensure_equals(hash<MurmurHash3>("The quick brown fox jumps over the lazy dog"),
+			0x2e4ff723u);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("MurmurHash3 yields the same hash regardless of how the data is split up");
+		testStreaming<MurmurHash3>();
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("MurmurHash3::updateLowerCase() hashes the ASCII-downcased data");
+		testLowerCase<MurmurHash3>();
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("MurmurHash3::updateLowerCase() leaves non-ASCII bytes alone");
+		const StaticString data("\xc1\xda\xe1\xfa\xc1\xda\xe1\xfa\xc1");
+		bool foundUpperCase;
+		ensure_equals(hashLowerCase<MurmurHash3>(data, 4, foundUpperCase),
+			hash<MurmurHash3>(data));
+		ensure(!foundUpperCase);
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("JenkinsHash supports streaming and case folding");
+		ensure_equals(hash<JenkinsHash>(""), (boost::uint32_t) JenkinsHash::EMPTY_STRING_HASH);
+		testStreaming<JenkinsHash>();
+		testLowerCase<JenkinsHash>();
+	}
+}
@@ -0,0 +1,174 @@
+#include <TestSupport.h>
+#include <Utils/LatencyHistogram.h>
+
+using namespace Passenger;
+using namespace std;
+
+namespace tut {
+	struct LatencyHistogramTest {
+		LatencyHistogram histogram;
+	};
+
+	DEFINE_TEST_GROUP(LatencyHistogramTest);
+
+	TEST_METHOD(1) {
+		set_test_name("Initial state");
+		ensure_equals(histogram.getCount(), (boost::uint64_t) 0);
+		ensure_equals(histogram.getMax(), (boost::uint64_t) 0);
+		ensure_equals(histogram.getPercentile(99), (boost::uint64_t) 0);
+		ensure_equals(histogram.getAverage(), 0.0);
+	}
+
+	TEST_METHOD(2) {
+		set_test_name("Samples are counted in power-of-two buckets");
+		histogram.record(0);
+		histogram.record(1);
+		histogram.record(2);
+		histogram.record(3);
+		histogram.record(4);
+		histogram.record(1000);
+		ensure_equals("(1)", histogram.getBucketCount(0), (boost::uint64_t) 1);
+		ensure_equals("(2)", histogram.getBucketCount(1), (boost::uint64_t) 1);
+		ensure_equals("(3)", histogram.getBucketCount(2), (boost::uint64_t) 2);
+		ensure_equals("(4)", histogram.getBucketCount(3), (boost::uint64_t) 1);
+		ensure_equals("(5)", histogram.getBucketCount(10), (boost::uint64_t) 1);
+		ensure_equals("(6)", histogram.getCount(), (boost::uint64_t) 6);
+		ensure_equals("(7)", histogram.getSum(), (boost::uint64_t) 1010);
+		ensure_equals("(8)", histogram.getMax(), (boost::uint64_t) 1000);
+	}
+
+	TEST_METHOD(3) {
+		set_test_name("Huge samples end up in the last bucket");
+		histogram.record((boost::uint64_t) 1 << 40);
+		ensure_equals(histogram.getBucketCount(LatencyHistogram::BUCKETS - 1),
+			(boost::uint64_t) 1);
+	}
+
+	TEST_METHOD(4) {
+		set_test_name("Percentiles are bucket upper bounds, capped by the maximum");
+		for (unsigned int i = 0; i < 99; i++) {
+			histogram.record(5);
+		}
+		histogram.record(100);
+		ensure_equals("(1)", histogram.getPercentile(50), (boost::uint64_t) 7);
+		ensure_equals("(2)", histogram.getPercentile(99), (boost::uint64_t) 7);
+		ensure_equals("(3)", histogram.getPercentile(100), (boost::uint64_t) 100);
+	}
+
+	TEST_METHOD(5) {
+		set_test_name("reset()");
+		histogram.record(10);
+		histogram.reset();
+		ensure_equals(histogram.getCount(), (boost::uint64_t) 0);
+		ensure_equals(histogram.getSum(), (boost::uint64_t) 0);
+		ensure_equals(histogram.getMax(), (boost::uint64_t) 0);
+	}
+
+	TEST_METHOD(6) {
+		set_test_name("JSON representation");
+		histogram.record(3);
+		histogram.record(3);
+		Json::Value doc = histogram.inspectStateAsJson();
+		ensure_equals("(1)", doc["count"].asUInt(), 2u);
+		ensure_equals("(2)", doc["max_usec"].asUInt(), 3u);
+		ensure_equals("(3)", doc["buckets"].size(), 1u);
+		ensure_equals("(4)", doc["buckets"][0u]["le_usec"].asUInt(), 3u);
+		ensure_equals("(5)", doc["buckets"][0u]["count"].asUInt(), 2u);
+	}
+
+	TEST_METHOD(7) {
+		set_test_name("LocalLatencyHistogram uses the same buckets and merges with others");
+		LocalLatencyHistogram local, other;
+
+		histogram.record(5);
+		histogram.record(100);
+		local.record(5);
+		other.record(1000);
+		local.merge(other);
+		local.merge(histogram);
+
+		ensure_equals("(1)", local.getCount(), (boost::uint64_t) 4);
+		ensure_equals("(2)", local.buckets[LatencyHistogram::bucketFor(5)], (boost::uint64_t) 2);
+		ensure_equals("(3)", local.buckets[LatencyHistogram::bucketFor(1000)], (boost::uint64_t) 1);
+		ensure_equals("(4)", local.sum, (boost::uint64_t) 1110);
+		ensure_equals("(5)", local.max, (boost::uint64_t) 1000);
+	}
+
+
+	/***** HdrLatencyHistogram *****/
+
+	TEST_METHOD(10) {
+		set_test_name("HdrLatencyHistogram buckets tile the value range without gaps");
+		ensure_equals("(1)", HdrLatencyHistogram::bucketFor(0), 0u);
+		ensure_equals("(2)", HdrLatencyHistogram::bucketFor(31), 31u);
+		for (unsigned int i = 0; i < HdrLatencyHistogram::BUCKETS; i++) {
+			boost::uint64_t lower = HdrLatencyHistogram::bucketLowerBound(i);
+			boost::uint64_t upper = HdrLatencyHistogram::bucketUpperBound(i);
+			ensure_equals("(3)", HdrLatencyHistogram::bucketFor(lower), i);
+			ensure_equals("(4)", HdrLatencyHistogram::bucketFor(upper), i);
+			if (i > 0) {
+				ensure_equals("(5)", lower,
+					HdrLatencyHistogram::bucketUpperBound(i - 1) + 1);
+			}
+			// Bucket width is at most 1/SUB_BUCKETS of its lower bound.
+			ensure("(6)", (upper - lower) * HdrLatencyHistogram::SUB_BUCKETS <= lower);
+		}
+		ensure_equals("(7)", HdrLatencyHistogram::bucketFor((boost::uint64_t) 1 << 40),
+			HdrLatencyHistogram::BUCKETS - 1);
+	}
+
+	TEST_METHOD(11) {
+		set_test_name("HdrLatencyHistogram percentiles are accurate to within 1/SUB_BUCKETS");
+		HdrLatencyHistogram hdr;
+
+		for (unsigned int i = 1; i <= 1000; i++) {
+			hdr.record(i * 100);
+		}
+		ensure_equals("(1)", hdr.getCount(), (boost::uint64_t) 1000);
+		ensure_equals("(2)", hdr.getMax(), (boost::uint64_t) 100000);
+
+		boost::uint64_t p50 = hdr.getPercentile(50);
+		boost::uint64_t p99 = hdr.getPercentile(99);
+		ensure("(3)", p50 >= 50000 && p50 <= 50000 + 50000 / HdrLatencyHistogram::SUB_BUCKETS);
+		ensure("(4)", p99 >= 99000 && p99 <= 99000 + 99000 / HdrLatencyHistogram::SUB_BUCKETS);
+		ensure_equals("(5)", hdr.getPercentile(100), (boost::uint64_t) 100000);
+	}
+
+	TEST_METHOD(12) {
+		set_test_name("HdrLatencyHistogram merges, and collapses into power-of-two buckets");
+		HdrLatencyHistogram hdr, other;
+		LocalLatencyHistogram local;
+
+		hdr.record(5);
+		hdr.record(1000);
+		other.record(1001);
+		hdr.merge(other);
+		ensure_equals("(1)", hdr.getCount(), (boost::uint64_t) 3);
+		ensure_equals("(2)", hdr.getSum(), (boost::uint64_t) 2006);
+		ensure_equals("(3)", hdr.getMax(), (boost::uint64_t) 1001);
+
+		hdr.collapseInto(local);
+		ensure_equals("(4)", local.getCount(), (boost::uint64_t) 3);
+		ensure_equals("(5)", local.buckets[LatencyHistogram::bucketFor(5)], (boost::uint64_t) 1);
+		ensure_equals("(6)", local.buckets[LatencyHistogram::bucketFor(1000)], (boost::uint64_t) 2);
+		ensure_equals("(7)", local.sum, (boost::uint64_t) 2006);
+		ensure_equals("(8)", local.max, (boost::uint64_t) 1001);
+	}
+
+	TEST_METHOD(13) {
+		set_test_name("HdrLatencyHistogram JSON representation");
+		HdrLatencyHistogram hdr;
+
+		hdr.record(3);
+		hdr.record(3);
+		hdr.record(1000);
+		Json::Value doc = hdr.inspectStateAsJson();
+		ensure_equals("(1)", doc["count"].asUInt(), 3u);
+		ensure_equals("(2)", doc["max_usec"].asUInt(), 1000u);
+		ensure_equals("(3)", doc["p50_usec"].asUInt(), 3u);
+		ensure_equals("(4)", doc["p999_usec"].asUInt(), 1000u);
+		ensure_equals("(5)", doc["buckets"].size(), 2u);
+		ensure_equals("(6)", doc["buckets"][0u]["le_usec"].asUInt(), 3u);
+		ensure_equals("(7)", doc["buckets"][0u]["count"].asUInt(), 2u);
+	}
+}